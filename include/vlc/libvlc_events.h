@@ -130,6 +130,12 @@ enum libvlc_event_e {
      */
     libvlc_MediaPlayerTitleSelectionChanged,
     libvlc_MediaPlayerChapterChanged,
+    /**
+     * The first frames of the current media are being rendered, cf
+     * media_player_first_frame_latency in \ref libvlc_event_t.u for the
+     * delay since the corresponding play or media switch request.
+     */
+    libvlc_MediaPlayerFirstFrameLatency,
 
     /**
      * A \link #libvlc_media_t media item\endlink was added to a
@@ -158,6 +164,15 @@ enum libvlc_event_e {
      * case of a \ref libvlc_media_discoverer_t) or parsed (preparser).
      */
     libvlc_MediaListEndReached,
+    /**
+     * A contiguous range of \link #libvlc_media_t media items\endlink was
+     * added to a \link #libvlc_media_list_t media list\endlink by
+     * libvlc_media_list_add_media_array().
+     * It is sent once per batch, in place of the per-item
+     * \ref libvlc_MediaListWillAddItem and \ref libvlc_MediaListItemAdded
+     * events.
+     */
+    libvlc_MediaListItemsAdded,
 
     /**
      * \deprecated No longer used.
@@ -317,6 +332,11 @@ typedef struct libvlc_event_t
             libvlc_media_t * item;
             int index;
         } media_list_will_delete_item;
+        struct
+        {
+            int index;
+            int count;
+        } media_list_items_added;
 
         /* media list player */
         struct
@@ -336,6 +356,12 @@ typedef struct libvlc_event_t
             libvlc_time_t   new_length;
         } media_player_length_changed;
 
+        /* First frame latency */
+        struct
+        {
+            libvlc_time_t   new_latency; /**< in milliseconds */
+        } media_player_first_frame_latency;
+
         /* Extra MediaPlayer */
         struct
         {
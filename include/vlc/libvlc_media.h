@@ -880,6 +880,46 @@ libvlc_media_thumbnail_request_by_pos( libvlc_media_t *md,
                                        bool crop, libvlc_picture_type_t picture_type,
                                        libvlc_time_t timeout );
 
+/**
+ * \brief libvlc_media_thumbnail_request_by_times Start an asynchronous batch
+ * thumbnail generation
+ *
+ * If the request is successfuly queued, the libvlc_MediaThumbnailGenerated
+ * event is guaranteed to be emited once per requested time, in order.
+ * The media is opened only once and the requested times are reached by
+ * seeking sequentially, reusing the demuxer and decoder, which is
+ * significantly cheaper than one request per time (e.g. for scrub-bar
+ * filmstrips).
+ *
+ * \param md media descriptor object
+ * \param times The times at which the thumbnails should be generated,
+ * preferably in ascending order
+ * \param count The number of entries in times, must be greater than 0
+ * \param speed The seeking speed \sa{libvlc_thumbnailer_seek_speed_t}
+ * \param width The thumbnail width
+ * \param height the thumbnail height
+ * \param picture_type The thumbnail picture type \sa{libvlc_picture_type_t}
+ * \param timeout A timeout value in ms for the whole batch, or 0 to disable
+ * timeout
+ *
+ * \return A valid opaque request object, or NULL in case of failure.
+ * It may be cancelled by libvlc_media_thumbnail_request_cancel().
+ * It must be released by libvlc_media_thumbnail_request_destroy().
+ *
+ * \version libvlc 4.0 or later
+ *
+ * \see libvlc_picture_t
+ * \see libvlc_picture_type_t
+ */
+LIBVLC_API libvlc_media_thumbnail_request_t*
+libvlc_media_thumbnail_request_by_times( libvlc_media_t *md,
+                                         const libvlc_time_t *times,
+                                         size_t count,
+                                         libvlc_thumbnailer_seek_speed_t speed,
+                                         unsigned int width, unsigned int height,
+                                         bool crop, libvlc_picture_type_t picture_type,
+                                         libvlc_time_t timeout );
+
 /**
  * @brief libvlc_media_thumbnail_cancel cancels a thumbnailing request
  * @param p_req An opaque thumbnail request object.
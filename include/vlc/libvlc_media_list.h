@@ -95,6 +95,26 @@ LIBVLC_API libvlc_media_t *
 LIBVLC_API int
 libvlc_media_list_add_media( libvlc_media_list_t *p_ml, libvlc_media_t *p_md );
 
+/**
+ * Append an array of media instances to the media list
+ * The libvlc_media_list_lock should be held upon entering this function.
+ *
+ * The items are appended in one pass, and a single
+ * \ref libvlc_MediaListItemsAdded event covering the whole range is sent
+ * instead of one event pair per item. Use this rather than calling
+ * libvlc_media_list_add_media() in a loop when loading large lists.
+ *
+ * \param p_ml a media list instance
+ * \param pp_mds array of media instances
+ * \param i_count number of media instances in the array
+ * \return 0 on success, -1 if the media list is read-only
+ * \version LibVLC 4.0.0 and later.
+ */
+LIBVLC_API int
+libvlc_media_list_add_media_array( libvlc_media_list_t *p_ml,
+                                   libvlc_media_t *const *pp_mds,
+                                   size_t i_count );
+
 /**
  * Insert media instance in media list on a position
  * The libvlc_media_list_lock should be held upon entering this function.
@@ -141,6 +161,37 @@ LIBVLC_API int
  */
 LIBVLC_API libvlc_media_t *
     libvlc_media_list_item_at_index( libvlc_media_list_t *p_ml, int i_pos );
+
+/**
+ * Get an immutable snapshot of the media list items
+ * The libvlc_media_list_lock should NOT be held upon entering this function.
+ *
+ * The returned array holds a reference on every media. It is not affected
+ * by later changes to the list, so it can be iterated at leisure without
+ * holding the list lock. It must be released with
+ * libvlc_media_list_snapshot_release().
+ *
+ * \param p_ml a media list instance
+ * \param ppp_mds address to store an allocated array of media instances
+ * (must be released with libvlc_media_list_snapshot_release()) [OUT]
+ * \return the number of media instances in the array, 0 on error
+ * \version LibVLC 4.0.0 and later.
+ */
+LIBVLC_API size_t
+    libvlc_media_list_snapshot_get( libvlc_media_list_t *p_ml,
+                                    libvlc_media_t ***ppp_mds );
+
+/**
+ * Release a snapshot obtained with libvlc_media_list_snapshot_get()
+ *
+ * \param pp_mds the array returned by libvlc_media_list_snapshot_get()
+ * \param i_count the number of media instances returned along the array
+ * \version LibVLC 4.0.0 and later.
+ */
+LIBVLC_API void
+    libvlc_media_list_snapshot_release( libvlc_media_t **pp_mds,
+                                        size_t i_count );
+
 /**
  * Find index position of List media instance in media list.
  * Warning: the function will return the first matched position.
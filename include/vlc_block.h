@@ -480,6 +480,80 @@ VLC_API block_t *block_FifoGet(block_fifo_t *) VLC_USED;
  */
 VLC_API block_t *block_FifoShow(block_fifo_t *);
 
+/**
+ * Lock-free multiple-producer, single-consumer block FIFO.
+ *
+ * Unlike block_fifo_t, this queue does not take a mutex on either path:
+ * producers publish with a single atomic operation per call (even for whole
+ * block chains) and the consumer drains without synchronisation except when
+ * it has to sleep on an empty queue. Use it on contended paths such as
+ * demuxer-to-decoder hand-off; fall back to block_fifo_t whenever more than
+ * one thread dequeues.
+ */
+typedef struct vlc_fifo_mpsc vlc_fifo_mpsc_t;
+
+/**
+ * Creates a lock-free MPSC block FIFO.
+ *
+ * The returned queue must be released with vlc_fifo_mpsc_Release().
+ *
+ * @return the FIFO or NULL on memory error
+ */
+VLC_API vlc_fifo_mpsc_t *vlc_fifo_mpsc_New(void) VLC_USED VLC_MALLOC;
+
+/**
+ * Destroys a FIFO created by vlc_fifo_mpsc_New().
+ *
+ * @note Any queued blocks are also destroyed.
+ * @warning No other threads may be using the FIFO when this function is
+ * called. Otherwise, undefined behaviour will occur.
+ */
+VLC_API void vlc_fifo_mpsc_Release(vlc_fifo_mpsc_t *);
+
+/**
+ * Enqueues a block, or a whole chain of blocks, with a single
+ * synchronisation point.
+ *
+ * This function may be called from any number of threads concurrently.
+ * It never blocks.
+ */
+VLC_API void vlc_fifo_mpsc_Put(vlc_fifo_mpsc_t *, block_t *block);
+
+/**
+ * Dequeues the first block from the FIFO, waiting if necessary until one is
+ * available.
+ *
+ * @warning Only one thread may ever dequeue from a given FIFO.
+ * Unlike block_FifoGet(), this function is not a cancellation point.
+ *
+ * @return a valid block
+ */
+VLC_API block_t *vlc_fifo_mpsc_Get(vlc_fifo_mpsc_t *) VLC_USED;
+
+/**
+ * Dequeues all currently queued blocks at once without waiting.
+ *
+ * @warning Only one thread may ever dequeue from a given FIFO.
+ *
+ * @return a chain of blocks in queue order, or NULL if the FIFO was empty
+ */
+VLC_API block_t *vlc_fifo_mpsc_GetAll(vlc_fifo_mpsc_t *) VLC_USED;
+
+/**
+ * Approximate number of blocks in the FIFO.
+ *
+ * @note The value is inherently stale by the time it is returned; it is only
+ * meant for statistics and buffering heuristics.
+ */
+VLC_API size_t vlc_fifo_mpsc_GetCount(const vlc_fifo_mpsc_t *) VLC_USED;
+
+/**
+ * Approximate number of payload bytes in the FIFO.
+ *
+ * @note See the staleness caveat on vlc_fifo_mpsc_GetCount().
+ */
+VLC_API size_t vlc_fifo_mpsc_GetBytes(const vlc_fifo_mpsc_t *) VLC_USED;
+
 typedef struct block_fifo_t vlc_fifo_t;
 
 static inline vlc_queue_t *vlc_fifo_queue(const vlc_fifo_t *fifo)
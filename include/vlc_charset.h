@@ -64,12 +64,23 @@ VLC_USED static inline const char *IsUTF8(const char *str)
     size_t n;
     uint32_t cp;
 
-    while ((n = vlc_towc(str, &cp)) != 0)
-        if (likely(n != (size_t)-1))
-            str += n;
-        else
+    for (;;)
+    {
+        unsigned char c = *str;
+
+        if (likely(c < 0x80))
+        {   /* ASCII fast path */
+            if (c == '\0')
+                return str;
+            str++;
+            continue;
+        }
+
+        n = vlc_towc(str, &cp);
+        if (n == (size_t)-1)
             return NULL;
-    return str;
+        str += n;
+    }
 }
 
 /**
@@ -117,15 +128,27 @@ static inline char *EnsureUTF8(char *str)
     size_t n;
     uint32_t cp;
 
-    while ((n = vlc_towc(str, &cp)) != 0)
-        if (likely(n != (size_t)-1))
+    for (;;)
+    {
+        unsigned char c = *str;
+
+        if (likely(c < 0x80))
+        {   /* ASCII fast path */
+            if (c == '\0')
+                return ret;
+            str++;
+            continue;
+        }
+
+        n = vlc_towc(str, &cp);
+        if (n != (size_t)-1)
             str += n;
         else
         {
             *str++ = '?';
             ret = NULL;
         }
-    return ret;
+    }
 }
 
 /**
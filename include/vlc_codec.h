@@ -122,6 +122,13 @@ struct decoder_t
      */
     int                 i_extra_picture_buffers;
 
+    /**
+     * Plane pitch alignment, in bytes, that the decoder requires from the
+     * picture buffers allocated by the owner (e.g. to render into them
+     * directly). 0 means the default guaranteed by picture_NewFromFormat().
+     */
+    unsigned            i_picture_pitch_align;
+
     union
     {
 #       define VLCDEC_SUCCESS   VLC_SUCCESS
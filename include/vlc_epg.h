@@ -54,6 +54,7 @@ typedef struct
     uint16_t         i_source_id;/* Channel / Program reference id this epg relates to */
     size_t            i_event;
     vlc_epg_event_t **pp_event;
+    size_t           i_event_capacity; /* Allocated size of pp_event, private */
     bool             b_present;  /* Contains present/following or similar, and sets below */
     const vlc_epg_event_t *p_current; /* NULL, or equal to one of the entries in pp_event */
 } vlc_epg_t;
@@ -109,6 +110,15 @@ VLC_API bool vlc_epg_AddEvent(vlc_epg_t *p_epg, vlc_epg_event_t *p_evt);
  */
 VLC_API void vlc_epg_SetCurrent(vlc_epg_t *p_epg, int64_t i_start);
 
+/**
+ * It updates \p p_dst so it holds exactly the events of \p p_src.
+ *
+ * Events of \p p_dst carried unchanged by \p p_src are kept instead of
+ * being reallocated, so a periodic full refresh (DVB EIT) of a mostly
+ * unchanged table is cheap.
+ */
+VLC_API void vlc_epg_Merge(vlc_epg_t *p_dst, const vlc_epg_t *p_src);
+
 /**
  * Returns a duplicated \p p_src and its associated events.
  *
@@ -114,6 +114,8 @@ typedef struct vlc_event_manager_t
 {
     void * p_obj;
     vlc_mutex_t lock;
+    vlc_cond_t wait;
+    struct vlc_event_walker *walkers;
     vlc_event_listeners_group_t events[vlc_InputItemErrorWhenReadingChanged + 1];
 } vlc_event_manager_t;
 
@@ -317,6 +317,56 @@ VLC_API int filter_Blend( vlc_blender_t *, picture_t *p_dst, int i_dst_x, int i_
  */
 VLC_API void filter_DeleteBlend( vlc_blender_t * );
 
+/**
+ * Video filter slicer
+ *
+ * A small worker pool splitting one filtering pass into independent
+ * bands. The submitting thread takes part in the work, so with a single
+ * CPU (or when the pool could not be created) a run degrades to a plain
+ * sequential loop.
+ */
+typedef struct filter_slicer_t filter_slicer_t;
+
+/**
+ * Callback processing one band of a run.
+ *
+ * It is called concurrently for different bands and must only touch
+ * per-band state (or state of its own).
+ *
+ * \param opaque opaque pointer passed to filter_SlicerRun()
+ * \param band band index, within [0, bands)
+ * \param bands total number of bands of the run
+ */
+typedef void (*filter_slice_cb)( void *opaque, unsigned band, unsigned bands );
+
+/**
+ * It creates a slicer for the given filter.
+ *
+ * \return a slicer, or NULL on allocation failure (in which case the
+ * other slicer functions can still be called and run sequentially)
+ */
+VLC_API filter_slicer_t *filter_NewSlicer( filter_t * ) VLC_USED;
+
+/**
+ * It returns the number of bands worth dispatching on a run, i.e. the
+ * number of threads that will process them (including the caller).
+ */
+VLC_API unsigned filter_SlicerBands( const filter_slicer_t * );
+
+/**
+ * It runs the callback over all bands and waits for their completion.
+ *
+ * The caller processes bands too, so this cannot deadlock even with no
+ * worker thread.
+ */
+VLC_API void filter_SlicerRun( filter_slicer_t *, filter_slice_cb,
+                               void *opaque, unsigned bands );
+
+/**
+ * It destroys a slicer created by filter_NewSlicer.
+ */
+VLC_API void filter_DeleteSlicer( filter_slicer_t * );
+
 /**
  * Create a picture_t *(*)( filter_t *, picture_t * ) compatible wrapper
  * using a void (*)( filter_t *, picture_t *, picture_t * ) function
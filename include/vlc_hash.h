@@ -35,6 +35,7 @@
  *
  * Supported hash algorithms:
  *   - \ref vlc_hash_md5 "MD5"
+ *   - \ref vlc_hash_md5_tree "MD5 tree hash"
  *
  * @{
  */
@@ -60,9 +61,11 @@
 #define vlc_hash_FinishHex(ctx, output)                             \
     do {                                                            \
         char out_tmp[_Generic((ctx),                                \
-            vlc_hash_md5_t *: VLC_HASH_MD5_DIGEST_SIZE)];           \
+            vlc_hash_md5_t *: VLC_HASH_MD5_DIGEST_SIZE,             \
+            vlc_hash_md5_tree_t *: VLC_HASH_MD5_DIGEST_SIZE)];      \
         _Generic((ctx),                                             \
-            vlc_hash_md5_t *: vlc_hash_md5_Finish)                  \
+            vlc_hash_md5_t *: vlc_hash_md5_Finish,                  \
+            vlc_hash_md5_tree_t *: vlc_hash_md5_tree_Finish)        \
         (ctx, out_tmp, sizeof(out_tmp));                            \
         vlc_hex_encode_binary(out_tmp, sizeof(out_tmp), output);    \
     } while (0)
@@ -138,6 +141,98 @@ VLC_API void vlc_hash_md5_Update(vlc_hash_md5_t *ctx, const void *data, size_t s
  */
 VLC_API void vlc_hash_md5_Finish(vlc_hash_md5_t *ctx, void *output, size_t size);
 
+/**
+ * @}
+ */
+
+/**
+ * \defgroup vlc_hash_md5_tree  MD5 tree hashing
+ * Chunked tree variant of \ref vlc_hash_md5 for large inputs
+ *
+ * The input is split into fixed-size chunks, each chunk is hashed
+ * independently, and the final digest is the MD5 of the concatenated chunk
+ * digests. Independent chunks can therefore be hashed on several cores:
+ * vlc_hash_md5_tree_Compute() does so automatically, while the streaming
+ * context computes the very same digest incrementally on a single thread.
+ *
+ * This is a framing convention around MD5, not a new primitive: the tree
+ * digest of a given input differs from its plain MD5 digest.
+ * @{
+ */
+
+/**
+ * MD5 tree hash chunk size, in bytes
+ */
+#define VLC_HASH_MD5_TREE_CHUNK_SIZE (1u << 20)
+
+/**
+ * MD5 tree hash context
+ */
+typedef struct vlc_hash_md5_tree_ctx
+{
+    struct {
+        vlc_hash_md5_t root; /**< Hash of the chunk digests */
+        vlc_hash_md5_t leaf; /**< Hash of the current chunk */
+        size_t leaf_fill; /**< Bytes fed to the current chunk */
+    } priv; /**< \internal Private */
+} vlc_hash_md5_tree_t;
+
+/**
+ * Initialize MD5 tree hash context
+ *
+ * Initializes the given MD5 tree hash function context, if the context is
+ * already initialized, it is reset.
+ *
+ * \param[out] ctx  MD5 tree hash context to init
+ */
+VLC_API void vlc_hash_md5_tree_Init(vlc_hash_md5_tree_t *ctx);
+
+/**
+ * Update MD5 tree hash computation with new data
+ *
+ * Updates the context with provided data which is used for the hash
+ * calculation. Can be called repeatedly with new data. The final
+ * hash represents the hash for the concatenation of all data.
+ *
+ * \param[in,out] ctx    MD5 tree hash context to update
+ * \param         data   Data to add
+ * \param         size   Size of the data to add
+ */
+VLC_API void vlc_hash_md5_tree_Update(vlc_hash_md5_tree_t *ctx,
+                                      const void *data, size_t size);
+
+/**
+ * Finish MD5 tree hash computation
+ *
+ * Finishes the MD5 tree hash computation and provides the hash for the
+ * concatenation of all provided data by previous calls to
+ * \ref vlc_hash_md5_tree_Update. The result is written to the buffer
+ * pointed to by output, which must be at least
+ * \ref VLC_HASH_MD5_DIGEST_SIZE big.
+ *
+ * \param[in,out] ctx    MD5 tree hash context to finish
+ * \param[out]    output Output buffer to write to
+ * \param         size   Output buffer size
+ */
+VLC_API void vlc_hash_md5_tree_Finish(vlc_hash_md5_tree_t *ctx,
+                                      void *output, size_t size);
+
+/**
+ * Compute the MD5 tree hash of a memory buffer in one shot
+ *
+ * Computes the same digest as the streaming context over the whole buffer,
+ * hashing chunks on several threads when the input is large enough to
+ * amortize them. The result is written to the buffer pointed to by output,
+ * which must be at least \ref VLC_HASH_MD5_DIGEST_SIZE big.
+ *
+ * \param[out] output    Output buffer to write to
+ * \param      size      Output buffer size
+ * \param      data      Data to hash
+ * \param      data_size Size of the data to hash
+ */
+VLC_API void vlc_hash_md5_tree_Compute(void *output, size_t size,
+                                       const void *data, size_t data_size);
+
 /**
  * @}
  */
@@ -466,6 +466,13 @@ typedef enum input_item_meta_request_option_t
     META_REQUEST_OPTION_FETCH_NETWORK = 0x08,
     META_REQUEST_OPTION_FETCH_ANY     = 0x0C,
     META_REQUEST_OPTION_DO_INTERACT   = 0x10,
+    /** Process the request before already queued normal-priority requests,
+     * for user-visible items */
+    META_REQUEST_OPTION_PRIORITY      = 0x20,
+    /** Make the timeout count from the submission of the request rather than
+     * from the start of its processing, so that requests stuck in a long
+     * queue eventually get cancelled */
+    META_REQUEST_OPTION_DEADLINE      = 0x40,
 } input_item_meta_request_option_t;
 
 /* status of the on_preparse_ended() callback */
@@ -517,6 +524,13 @@ struct input_stats_t
     /* Decoders */
     int64_t i_decoded_audio;
     int64_t i_decoded_video;
+    vlc_tick_t i_decode_latency; /**< moving average of block decode time */
+/** Number of buckets of the decode latency histogram */
+#define INPUT_STATS_LATENCY_BUCKETS 16
+    /** Histogram of the per-block decode times: bucket N counts the blocks
+     * decoded in [2^N, 2^(N+1)) microseconds, the last bucket counting
+     * everything above the range */
+    uint64_t pi_decode_latency_histogram[INPUT_STATS_LATENCY_BUCKETS];
 
     /* Vout */
     int64_t i_displayed_pictures;
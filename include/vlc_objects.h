@@ -178,9 +178,6 @@ static inline struct vlc_logger *vlc_object_logger(vlc_object_t *obj)
 
 #define vlc_object_create(a,b) vlc_object_create( VLC_OBJECT(a), b )
 
-#define vlc_object_find_name(a,b) \
-    vlc_object_find_name( VLC_OBJECT(a),b)
-
 VLC_USED
 static inline libvlc_int_t *vlc_object_instance(vlc_object_t *obj)
 {
@@ -484,6 +484,18 @@ vlc_player_Resume(vlc_player_t *player);
 VLC_API void
 vlc_player_NextVideoFrame(vlc_player_t *player);
 
+/**
+ * Pause and display the previous video frame
+ *
+ * Decoders cannot run backward, so this pauses and seeks precisely to the
+ * frame before the current time: the demuxer lands on the previous keyframe
+ * and the decoders roll forward up to the target without displaying.
+ *
+ * @param player locked player instance
+ */
+VLC_API void
+vlc_player_PreviousVideoFrame(vlc_player_t *player);
+
 /**
  * Get the state of the player
  *
@@ -679,6 +691,25 @@ vlc_player_GetTime(vlc_player_t *player);
 VLC_API float
 vlc_player_GetPosition(vlc_player_t *player);
 
+/**
+ * Get an interpolated time and position of the current media
+ *
+ * Unlike vlc_player_GetTime() and vlc_player_GetPosition(), this function
+ * doesn't require the player to be locked: the last timer point is read
+ * atomically and interpolated to the given date. It is therefore suitable
+ * for UIs polling the playback position at a high rate.
+ *
+ * @param player unlocked player instance
+ * @param system_now current system date, likely vlc_tick_now()
+ * @param out_ts pointer where to set the interpolated ts, can be NULL
+ * @param out_pos pointer where to set the interpolated position, can be NULL
+ * @return VLC_SUCCESS in case of success, an error if no timer point is
+ * available (no media playing or playback not yet started)
+ */
+VLC_API int
+vlc_player_GetTimerPoint(vlc_player_t *player, vlc_tick_t system_now,
+                         vlc_tick_t *out_ts, float *out_pos);
+
 /**
  * Seek the current media by position
  *
@@ -3077,6 +3108,20 @@ struct vlc_player_cbs
      * @param data opaque pointer set by vlc_player_AddListener()
      */
     void (*on_playback_restore_queried)(vlc_player_t *player, void *data);
+
+    /**
+     * Called when the first frames of a media start being rendered
+     *
+     * The latency is the delay between the corresponding play or media
+     * switch request and the player reaching the playing state. It is the
+     * figure of merit of fast media switching ("zapping").
+     *
+     * @param player locked player instance
+     * @param latency delay between the start request and the first frames
+     * @param data opaque pointer set by vlc_player_AddListener()
+     */
+    void (*on_playback_latency_changed)(vlc_player_t *player,
+        vlc_tick_t latency, void *data);
 };
 
 /**
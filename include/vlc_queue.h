@@ -186,6 +186,12 @@ VLC_USED static inline bool vlc_queue_IsEmpty(const vlc_queue_t *q)
  * This function enqueues an entry, or rather a linked-list of entries, in a
  * thread-safe queue.
  *
+ * @note Unlike vlc_queue_EnqueueUnlocked(), this function only wakes a
+ * consumer up when the queue switches from empty to non-empty, as the
+ * high-level dequeuing functions only ever wait on an empty queue. Mixing it
+ * with custom waiting predicates leads to missed wake-ups; use the low-level
+ * functions then.
+ *
  * @param entry list of entries (if NULL, this function has no effects)
  */
 VLC_API void vlc_queue_Enqueue(vlc_queue_t *, void *entry);
@@ -248,6 +254,11 @@ static inline void *vlc_queue_DequeueKillable(vlc_queue_t *q,
         vlc_queue_Wait(q);
 
     entry = vlc_queue_DequeueUnlocked(q);
+
+    /* Producers only signal the empty to non-empty transition. Relay the
+     * wake-up to any other consumer if entries remain. */
+    if (!vlc_queue_IsEmpty(q))
+        vlc_queue_Signal(q);
     vlc_queue_Unlock(q);
     return entry;
 }
@@ -33,4 +33,15 @@ VLC_API void vlc_qsort(void *base, size_t nmemb, size_t size,
                        int (*compar)(const void *, const void *, void *),
                        void *arg);
 
+/**
+ * Sort an array with a stable merge sort
+ *
+ * Equal elements keep their relative order. Large arrays are sorted with
+ * several threads. If the O(n) scratch buffer cannot be allocated, this
+ * degrades to vlc_qsort() (thus losing stability).
+ */
+VLC_API void vlc_mergesort(void *base, size_t nmemb, size_t size,
+                           int (*compar)(const void *, const void *, void *),
+                           void *arg);
+
 #endif
@@ -148,6 +148,7 @@ enum sout_mux_query_e
 {
     /* capabilities */
     MUX_CAN_ADD_STREAM_WHILE_MUXING,    /* arg1= bool *,      res=cannot fail */
+    MUX_CAN_PASSTHROUGH,                /* arg1= const es_format_t *, arg2= bool *, res=can fail (assume false) */
     /* properties */
     MUX_GET_MIME,                       /* arg1= char **            res=can fail    */
 };
@@ -185,6 +186,7 @@ static inline int sout_MuxControl( sout_mux_t *p_mux, int i_query, ... )
 enum sout_stream_query_e {
     SOUT_STREAM_EMPTY,    /* arg1=bool *,       res=can fail (assume true) */
     SOUT_STREAM_WANTS_SUBSTREAMS,  /* arg1=bool *, res=can fail (assume false) */
+    SOUT_STREAM_CAN_PASSTHROUGH,   /* arg1=const es_format_t *, arg2=bool *, res=can fail (assume false) */
     SOUT_STREAM_ID_SPU_HIGHLIGHT,  /* arg1=void *, arg2=const vlc_spu_highlight_t *, res=can fail */
 };
 
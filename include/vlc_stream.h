@@ -120,6 +120,16 @@ struct stream_t
      */
     int         (*pf_readdir)(stream_t *, input_item_node_t *);
 
+    /**
+     * Incremental directory reading.
+     *
+     * True if \ref stream_t.pf_readdir delivers the entries in batches: the
+     * callback can then be called repeatedly, each call appending the next
+     * batch to the node, until one call appends no entry. False (the
+     * default) if a single call returns the whole listing.
+     */
+    bool        b_readdir_incremental;
+
     int         (*pf_demux)(stream_t *);
 
     /**
@@ -249,6 +259,26 @@ VLC_API ssize_t vlc_stream_Peek(stream_t *, const uint8_t **, size_t) VLC_USED;
  */
 VLC_API block_t *vlc_stream_ReadBlock(stream_t *) VLC_USED;
 
+/**
+ * Reads a chain of data blocks without copying.
+ *
+ * This function reads data like vlc_stream_ReadBlock(), but gathers as much
+ * already buffered data as possible into a chain of blocks, up to
+ * approximately \p max bytes. Blocks produced by the underlying stream (or
+ * access) are handed over whole, so data is never copied: the chain may
+ * therefore slightly exceed \p max, as the last block is not split.
+ *
+ * At most one potentially waiting call is made to the underlying stream, so
+ * this function blocks no longer than a single vlc_stream_ReadBlock() call.
+ * It is a superior alternative to looping over vlc_stream_Read() for callers,
+ * such as demultiplexers, that can consume scattered buffers.
+ *
+ * \param max approximate maximum total bytes to dequeue
+ * \return a chain of one or more data blocks, or NULL on end-of-stream or
+ * (spurious) error
+ */
+VLC_API block_t *vlc_stream_GetBlocks(stream_t *, size_t max) VLC_USED;
+
 /**
  * Tells the current stream position.
  *
@@ -324,6 +354,21 @@ VLC_API char *vlc_stream_ReadLine(stream_t *);
  */
 VLC_API int vlc_stream_ReadDir(stream_t *s, input_item_node_t *node);
 
+/**
+ * Reads the next batch of a directory.
+ *
+ * This function fills an input item node with the next batch of items within
+ * a directory. If the directory is not incremental
+ * (\ref stream_t.b_readdir_incremental), this is equivalent to
+ * vlc_stream_ReadDir() and must not be called again. Otherwise the listing
+ * is over once a call appends no entry to the node.
+ *
+ * \param s directory object to read from
+ * \param node node to store the items into
+ * \return VLC_SUCCESS on success
+ */
+VLC_API int vlc_stream_ReadDirPartial(stream_t *s, input_item_node_t *node);
+
 /**
  * Closes a byte stream.
  * \param s byte stream to close
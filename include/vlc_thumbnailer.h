@@ -43,6 +43,27 @@ typedef struct vlc_thumbnailer_request_t vlc_thumbnailer_request_t;
  */
 typedef void(*vlc_thumbnailer_cb)( void* data, picture_t* thumbnail );
 
+/**
+ * \brief vlc_thumbnailer_seq_cb defines a callback invoked for each thumbnail
+ * of a batch request
+ *
+ * This callback will be called once per requested timestamp, in order,
+ * provided vlc_thumbnailer_RequestByTimes returned a non NULL request, and
+ * provided the request is not cancelled before its completion.
+ * In case of failure or timeout, it is invoked with a NULL thumbnail for each
+ * timestamp left to generate.
+ * The picture, if any, is owned by the thumbnailer, and must be acquired by
+ * using \link picture_Hold \endlink to use it pass the callback's scope.
+ *
+ * \param data Is the opaque pointer passed as vlc_thumbnailer_RequestByTimes
+ * last parameter
+ * \param index The index of the timestamp this thumbnail was generated for
+ * \param thumbnail The generated thumbnail, or NULL in case of failure or
+ * timeout
+ */
+typedef void(*vlc_thumbnailer_seq_cb)( void* data, size_t index,
+                                       picture_t* thumbnail );
+
 
 /**
  * \brief vlc_thumbnailer_Create Creates a thumbnailer object
@@ -112,6 +133,39 @@ vlc_thumbnailer_RequestByPos( vlc_thumbnailer_t *thumbnailer,
                               input_item_t *input_item, vlc_tick_t timeout,
                               vlc_thumbnailer_cb cb, void* user_data );
 
+/**
+ * \brief vlc_thumbnailer_RequestByTimes Requests thumbnails at several times
+ * \param thumbnailer A thumbnailer object
+ * \param times The times at which the thumbnails should be taken, preferably
+ * in ascending order
+ * \param count The number of entries in times, must be greater than 0
+ * \param speed The seeking speed \sa{enum vlc_thumbnailer_seek_speed}
+ * \param input_item The input item to generate the thumbnails for
+ * \param timeout A timeout value for the whole batch, or VLC_TICK_INVALID to
+ * disable timeout
+ * \param cb A user callback to be called once per timestamp (success & error)
+ * \param user_data An opaque value, provided as pf_cb's first parameter
+ * \return An opaque request object, or NULL in case of failure
+ *
+ * Unlike multiple calls to vlc_thumbnailer_RequestByTime, the input item is
+ * opened only once and the timestamps are reached by seeking sequentially,
+ * reusing the demuxer and decoder for the whole batch.
+ * If this function returns a valid request object, the callback is guaranteed
+ * to be called for every timestamp, even in case of later failure.
+ * The returned request object must not be used after the last callback has
+ * been invoked. That request object is owned by the thumbnailer, and must not
+ * be released.
+ * The provided input_item will be held by the thumbnailer and can safely be
+ * released after calling this function. The times array is copied and does not
+ * need to outlive this call.
+ */
+VLC_API vlc_thumbnailer_request_t*
+vlc_thumbnailer_RequestByTimes( vlc_thumbnailer_t *thumbnailer,
+                                const vlc_tick_t *times, size_t count,
+                                enum vlc_thumbnailer_seek_speed speed,
+                                input_item_t *input_item, vlc_tick_t timeout,
+                                vlc_thumbnailer_seq_cb cb, void* user_data );
+
 /**
  * \brief vlc_thumbnailer_Cancel Cancel a thumbnail request
  * \param thumbnailer A thumbnailer object
@@ -228,6 +228,12 @@ struct date_t
     uint32_t i_divider_num;
     uint32_t i_divider_den;
     uint32_t i_remainder;
+    /* Cached conversion of the last sample count: audio and demux paths
+     * step by the same number of samples for every block, so the division
+     * only needs to be redone when the count or the scale changes. */
+    uint32_t i_inc_count;
+    uint32_t i_inc_rem;
+    vlc_tick_t i_inc_quot;
 };
 
 /**
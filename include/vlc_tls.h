@@ -419,6 +419,15 @@ static inline void vlc_tls_Close(vlc_tls_t *session)
  */
 VLC_API vlc_tls_t *vlc_tls_SocketOpen(int fd);
 
+/**
+ * Checks whether a stream is a raw socket.
+ *
+ * Returns true if the transport-layer stream writes to its socket directly,
+ * without any intermediate protocol layer. A TLS backend can then hand the
+ * file descriptor over to kernel offload facilities safely.
+ */
+VLC_API bool vlc_tls_SocketIsRaw(vlc_tls_t *tls) VLC_USED;
+
 /**
  * Creates a connected pair of transport-layer sockets.
  */
@@ -0,0 +1,183 @@
+/*****************************************************************************
+ * vlc_tracer.h: tracing interface
+ *****************************************************************************
+ * Copyright (C) 2021 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_TRACER_H
+#define VLC_TRACER_H
+
+#include <vlc_common.h>
+#include <stdarg.h>
+
+/**
+ * \defgroup tracer Tracer
+ * \ingroup os
+ *
+ * Event tracing.
+ *
+ * A tracer records timestamped, structured events from the playback hot
+ * paths (demux, decoder, clock, outputs) so that timing issues can be
+ * correlated across threads after the fact. Unlike the message log, trace
+ * events carry typed key/value pairs and are only emitted when a tracer
+ * module is loaded: when tracing is disabled, a trace point is a single
+ * pointer check.
+ *
+ * @{
+ * \file
+ * Tracing interface.
+ */
+
+enum vlc_tracer_value_type
+{
+    VLC_TRACER_INT,
+    VLC_TRACER_TICK,
+    VLC_TRACER_STRING,
+};
+
+union vlc_tracer_value
+{
+    int64_t integer;
+    vlc_tick_t tick;
+    const char *string;
+};
+
+/**
+ * One trace event field, as passed to vlc_tracer_Trace().
+ *
+ * An entry with a NULL key terminates the list.
+ */
+struct vlc_tracer_entry
+{
+    const char *key;
+    union vlc_tracer_value value;
+    enum vlc_tracer_value_type type;
+};
+
+struct vlc_tracer;
+
+/**
+ * Operations returned by a module with the "tracer" capability.
+ */
+struct vlc_tracer_operations
+{
+    /**
+     * Called with the date of the event and the entry list; the list is
+     * terminated by an entry with a NULL key. Can be called concurrently
+     * from any thread.
+     */
+    void (*trace)(void *sys, vlc_tick_t ts, va_list entries);
+
+    /**
+     * Called to release the private data, or NULL if unneeded.
+     */
+    void (*destroy)(void *sys);
+};
+
+static inline struct vlc_tracer_entry vlc_tracer_entry_FromInt(const char *key,
+                                                               int64_t value)
+{
+    struct vlc_tracer_entry entry = { key, { .integer = value },
+                                      VLC_TRACER_INT };
+    return entry;
+}
+
+static inline struct vlc_tracer_entry vlc_tracer_entry_FromTick(const char *key,
+                                                                vlc_tick_t value)
+{
+    struct vlc_tracer_entry entry = { key, { .tick = value },
+                                      VLC_TRACER_TICK };
+    return entry;
+}
+
+static inline struct vlc_tracer_entry vlc_tracer_entry_FromString(const char *key,
+                                                                  const char *value)
+{
+    struct vlc_tracer_entry entry = { key, { .string = value },
+                                      VLC_TRACER_STRING };
+    return entry;
+}
+
+#ifndef __cplusplus
+#define VLC_TRACE(key, value) \
+    _Generic((value), \
+        vlc_tick_t: vlc_tracer_entry_FromTick, \
+        char *: vlc_tracer_entry_FromString, \
+        const char *: vlc_tracer_entry_FromString, \
+        default: vlc_tracer_entry_FromInt) (key, value)
+#else
+static inline struct vlc_tracer_entry VLC_TRACE(const char *key, int64_t value)
+{
+    return vlc_tracer_entry_FromInt(key, value);
+}
+
+static inline struct vlc_tracer_entry VLC_TRACE(const char *key,
+                                                const char *value)
+{
+    return vlc_tracer_entry_FromString(key, value);
+}
+#endif
+
+/** Timestamps are in microseconds, like vlc_tick_t */
+#define VLC_TRACE_TICK(key, tick) vlc_tracer_entry_FromTick(key, tick)
+
+#define VLC_TRACE_END vlc_tracer_entry_FromString(NULL, NULL)
+
+/**
+ * Emit a trace event, stamped with the current date.
+ *
+ * The variable argument list is a sequence of struct vlc_tracer_entry,
+ * normally built with VLC_TRACE(), terminated by VLC_TRACE_END. Use the
+ * vlc_tracer_Trace() macro rather than calling the function directly so
+ * that a disabled tracer costs a single NULL check.
+ */
+VLC_API void (vlc_tracer_Trace)(struct vlc_tracer *tracer, ...);
+
+#define vlc_tracer_Trace(tracer, ...) \
+    do \
+    { \
+        struct vlc_tracer *tracer_ = (tracer); \
+        if (tracer_ != NULL) \
+            (vlc_tracer_Trace)(tracer_, __VA_ARGS__, VLC_TRACE_END); \
+    } while (0)
+
+/**
+ * Create a tracer from the module matching the given name.
+ *
+ * \param parent object used for module probing and configuration
+ * \param name "tracer" module name, or NULL for the default
+ * \return a tracer, or NULL if no module could be loaded
+ */
+VLC_API struct vlc_tracer *vlc_tracer_Create(vlc_object_t *parent,
+                                             const char *name);
+
+/**
+ * Destroy a tracer created with vlc_tracer_Create().
+ */
+VLC_API void vlc_tracer_Destroy(struct vlc_tracer *tracer);
+
+/**
+ * Get the tracer of the libvlc instance owning the object.
+ *
+ * \return the instance tracer, or NULL if tracing is disabled
+ */
+VLC_API struct vlc_tracer *vlc_object_get_tracer(vlc_object_t *obj);
+
+/**
+ * @}
+ */
+#endif
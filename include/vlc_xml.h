@@ -81,11 +81,30 @@ VLC_API xml_reader_t * xml_ReaderCreate(vlc_object_t *, stream_t *) VLC_USED;
 #define xml_ReaderCreate( a, s ) xml_ReaderCreate(VLC_OBJECT(a), s)
 VLC_API void xml_ReaderDelete(xml_reader_t *);
 
+/**
+ * Pulls the next node of the document.
+ *
+ * \param pval storage for the element name or text content [OUT]
+ * The returned string is borrowed from the reader: it remains valid until
+ * the next call to xml_ReaderNextNode(), without any allocation. Callers
+ * keeping it longer must copy it.
+ *
+ * \return the node type, or XML_READER_NONE at the end of the document
+ */
 static inline int xml_ReaderNextNode( xml_reader_t *reader, const char **pval )
 {
     return reader->pf_next_node( reader, pval );
 }
 
+/**
+ * Pulls the next attribute of the current element.
+ *
+ * \param pval storage for the attribute value [OUT]
+ *
+ * \return the attribute name, or NULL when all attributes were read. Both
+ * strings are borrowed from the reader and remain valid until the next call
+ * to xml_ReaderNextAttr() or xml_ReaderNextNode().
+ */
 static inline const char *xml_ReaderNextAttr( xml_reader_t *reader,
                                               const char **pval )
 {
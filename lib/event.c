@@ -75,8 +75,20 @@ typedef struct libvlc_event_listener_t
     libvlc_event_type_t event_type;
     void *              p_user_data;
     libvlc_callback_t   pf_callback;
+    bool                b_detached; /* reclamation deferred while walked */
 } libvlc_event_listener_t;
 
+/* Stack-allocated record of one thread currently dispatching callbacks.
+ * The listener array is never shrunk while at least one walker is active;
+ * detached listeners are only marked, and reclaimed by the last walker
+ * leaving (or synchronously when there is none). This way the lock needs
+ * not be held while an application callback runs. */
+struct libvlc_event_walker
+{
+    unsigned long thread;
+    struct libvlc_event_walker *next;
+};
+
 /*
  * Internal libvlc functions
  */
@@ -85,17 +97,46 @@ void libvlc_event_manager_init(libvlc_event_manager_t *em, void *obj)
 {
     em->p_obj = obj;
     vlc_array_init(&em->listeners);
-    vlc_mutex_init_recursive(&em->lock);
+    vlc_mutex_init(&em->lock);
+    vlc_cond_init(&em->wait);
+    em->walkers = NULL;
 }
 
 void libvlc_event_manager_destroy(libvlc_event_manager_t *em)
 {
+    assert(em->walkers == NULL);
+
     for (size_t i = 0; i < vlc_array_count(&em->listeners); i++)
         free(vlc_array_item_at_index(&em->listeners, i));
 
     vlc_array_clear(&em->listeners);
 }
 
+static bool libvlc_event_walking(libvlc_event_manager_t *em)
+{
+    unsigned long self = vlc_thread_id();
+
+    for (struct libvlc_event_walker *w = em->walkers; w != NULL; w = w->next)
+        if (w->thread == self)
+            return true;
+    return false;
+}
+
+static void libvlc_event_reclaim(libvlc_event_manager_t *em)
+{
+    for (size_t i = vlc_array_count(&em->listeners); i-- > 0;)
+    {
+        libvlc_event_listener_t *listener;
+
+        listener = vlc_array_item_at_index(&em->listeners, i);
+        if (listener->b_detached)
+        {
+            vlc_array_remove(&em->listeners, i);
+            free(listener);
+        }
+    }
+}
+
 /**************************************************************************
  *       libvlc_event_send (internal) :
  *
@@ -104,17 +145,40 @@ void libvlc_event_manager_destroy(libvlc_event_manager_t *em)
 void libvlc_event_send( libvlc_event_manager_t * p_em,
                         libvlc_event_t * p_event )
 {
+    struct libvlc_event_walker walker = { .thread = vlc_thread_id(), };
+
     /* Fill event with the sending object now */
     p_event->p_obj = p_em->p_obj;
 
     vlc_mutex_lock(&p_em->lock);
+    walker.next = p_em->walkers;
+    p_em->walkers = &walker;
+
     for (size_t i = 0; i < vlc_array_count(&p_em->listeners); i++)
     {
         libvlc_event_listener_t *listener;
 
         listener = vlc_array_item_at_index(&p_em->listeners, i);
-        if (listener->event_type == p_event->type)
-            listener->pf_callback(p_event, listener->p_user_data);
+        if (listener->b_detached || listener->event_type != p_event->type)
+            continue;
+
+        /* The lock is released while the application callback runs, so a
+         * slow listener no longer stalls other producers, nor attaching
+         * and detaching from other threads. */
+        vlc_mutex_unlock(&p_em->lock);
+        listener->pf_callback(p_event, listener->p_user_data);
+        vlc_mutex_lock(&p_em->lock);
+    }
+
+    struct libvlc_event_walker **pp = &p_em->walkers;
+    while (*pp != &walker)
+        pp = &(*pp)->next;
+    *pp = walker.next;
+
+    if (p_em->walkers == NULL)
+    {   /* Last walker out: the grace period is over */
+        libvlc_event_reclaim(p_em);
+        vlc_cond_broadcast(&p_em->wait);
     }
     vlc_mutex_unlock(&p_em->lock);
 }
@@ -138,6 +202,7 @@ int libvlc_event_attach(libvlc_event_manager_t *em, libvlc_event_type_t type,
     listener->event_type = type;
     listener->p_user_data = opaque;
     listener->pf_callback = callback;
+    listener->b_detached = false;
 
     int i_ret;
     vlc_mutex_lock(&em->lock);
@@ -167,13 +232,31 @@ void libvlc_event_detach(libvlc_event_manager_t *em, libvlc_event_type_t type,
 
          listener = vlc_array_item_at_index(&em->listeners, i);
 
-         if (listener->event_type == type
+         if (!listener->b_detached
+          && listener->event_type == type
           && listener->pf_callback == callback
           && listener->p_user_data == opaque)
          {   /* that's our listener */
-             vlc_array_remove(&em->listeners, i);
-             vlc_mutex_unlock(&em->lock);
-             free(listener);
+             listener->b_detached = true;
+
+             if (em->walkers == NULL)
+             {
+                 vlc_array_remove(&em->listeners, i);
+                 vlc_mutex_unlock(&em->lock);
+                 free(listener);
+             }
+             else if (libvlc_event_walking(em))
+                 /* Called back from a dispatch on this very thread: waiting
+                  * would deadlock. The last walker reclaims the listener. */
+                 vlc_mutex_unlock(&em->lock);
+             else
+             {
+                 /* Wait out the dispatches which may still be running the
+                  * callback, so the caller can release its resources. */
+                 while (em->walkers != NULL)
+                     vlc_cond_wait(&em->wait, &em->lock);
+                 vlc_mutex_unlock(&em->lock);
+             }
              return;
          }
     }
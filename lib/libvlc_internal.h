@@ -80,6 +80,8 @@ struct libvlc_event_manager_t
     void * p_obj;
     vlc_array_t listeners;
     vlc_mutex_t lock;
+    vlc_cond_t wait;
+    struct libvlc_event_walker *walkers;
 };
 
 /***************************************************************************
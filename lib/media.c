@@ -754,7 +754,10 @@ static int media_parse(libvlc_media_t *media, bool b_async,
     {
         libvlc_int_t *libvlc = media->p_libvlc_instance->p_libvlc_int;
         input_item_t *item = media->p_input_item;
-        input_item_meta_request_option_t parse_scope = META_REQUEST_OPTION_SCOPE_LOCAL;
+        /* Explicit parse requests are initiated by the application, process
+         * them before queued background preparsing */
+        input_item_meta_request_option_t parse_scope =
+            META_REQUEST_OPTION_SCOPE_LOCAL | META_REQUEST_OPTION_PRIORITY;
         int ret;
 
         if (parse_flag & libvlc_media_parse_network)
@@ -1097,6 +1100,65 @@ libvlc_media_thumbnail_request_by_time( libvlc_media_t *md, libvlc_time_t time,
     return req;
 }
 
+static void media_on_thumbnail_batch_ready( void* data, size_t index,
+                                            picture_t* thumbnail )
+{
+    VLC_UNUSED(index);
+    /* One libvlc_MediaThumbnailGenerated event is sent per timestamp, in
+     * request order */
+    media_on_thumbnail_ready( data, thumbnail );
+}
+
+// Start an asynchronous batch thumbnail generation
+libvlc_media_thumbnail_request_t*
+libvlc_media_thumbnail_request_by_times( libvlc_media_t *md,
+                                         const libvlc_time_t *times,
+                                         size_t count,
+                                         libvlc_thumbnailer_seek_speed_t speed,
+                                         unsigned int width, unsigned int height,
+                                         bool crop, libvlc_picture_type_t picture_type,
+                                         libvlc_time_t timeout )
+{
+    assert( md );
+    assert( count > 0 );
+    libvlc_priv_t *p_priv = libvlc_priv(md->p_libvlc_instance->p_libvlc_int);
+    if( unlikely( p_priv->p_thumbnailer == NULL ) )
+        return NULL;
+    vlc_tick_t *ticks = vlc_alloc( count, sizeof( *ticks ) );
+    if ( unlikely( ticks == NULL ) )
+        return NULL;
+    for ( size_t i = 0; i < count; i++ )
+        ticks[i] = VLC_TICK_FROM_MS( times[i] );
+    libvlc_media_thumbnail_request_t *req = malloc( sizeof( *req ) );
+    if ( unlikely( req == NULL ) )
+    {
+        free( ticks );
+        return NULL;
+    }
+
+    req->md = md;
+    req->width = width;
+    req->height = height;
+    req->type = picture_type;
+    req->crop = crop;
+    libvlc_media_retain( md );
+    req->req = vlc_thumbnailer_RequestByTimes( p_priv->p_thumbnailer,
+        ticks, count,
+        speed == libvlc_media_thumbnail_seek_fast ?
+            VLC_THUMBNAILER_SEEK_FAST : VLC_THUMBNAILER_SEEK_PRECISE,
+        md->p_input_item,
+        timeout > 0 ? VLC_TICK_FROM_MS( timeout ) : VLC_TICK_INVALID,
+        media_on_thumbnail_batch_ready, req );
+    free( ticks );
+    if ( req->req == NULL )
+    {
+        free( req );
+        libvlc_media_release( md );
+        return NULL;
+    }
+    return req;
+}
+
 // Start an asynchronous thumbnail generation
 libvlc_media_thumbnail_request_t*
 libvlc_media_thumbnail_request_by_pos( libvlc_media_t *md, float pos,
@@ -299,6 +299,39 @@ void libvlc_media_list_internal_add_media( libvlc_media_list_t * p_mlist,
                           EventDidHappen );
 }
 
+/**************************************************************************
+ *       libvlc_media_list_add_media_array (Public)
+ *
+ * Lock should be held when entering.
+ **************************************************************************/
+int libvlc_media_list_add_media_array( libvlc_media_list_t * p_mlist,
+                                       libvlc_media_t * const * pp_mds,
+                                       size_t i_count )
+{
+    libvlc_event_t event;
+    int index;
+
+    if( !mlist_is_writable(p_mlist) )
+        return -1;
+    if( i_count == 0 )
+        return 0;
+
+    index = vlc_array_count( &p_mlist->items );
+    for( size_t i = 0; i < i_count; i++ )
+    {
+        libvlc_media_retain( pp_mds[i] );
+        vlc_array_append_or_abort( &p_mlist->items, pp_mds[i] );
+    }
+
+    /* One event for the whole batch, instead of a
+     * WillAddItem/ItemAdded pair per item */
+    event.type = libvlc_MediaListItemsAdded;
+    event.u.media_list_items_added.index = index;
+    event.u.media_list_items_added.count = i_count;
+    libvlc_event_send( &p_mlist->event_manager, &event );
+    return 0;
+}
+
 /**************************************************************************
  *       libvlc_media_list_insert_media (Public)
  *
@@ -383,6 +416,50 @@ libvlc_media_list_item_at_index( libvlc_media_list_t * p_mlist,
     return p_md;
 }
 
+/**************************************************************************
+ *       libvlc_media_list_snapshot_get (Public)
+ *
+ * Lock should NOT be held when entering.
+ **************************************************************************/
+size_t libvlc_media_list_snapshot_get( libvlc_media_list_t * p_mlist,
+                                       libvlc_media_t *** ppp_mds )
+{
+    libvlc_media_t ** pp_mds;
+    size_t i_count;
+
+    vlc_mutex_lock( &p_mlist->object_lock );
+    i_count = vlc_array_count( &p_mlist->items );
+    pp_mds = vlc_alloc( i_count, sizeof(*pp_mds) );
+    if( unlikely(pp_mds == NULL) )
+    {
+        vlc_mutex_unlock( &p_mlist->object_lock );
+        libvlc_printerr( "Not enough memory" );
+        *ppp_mds = NULL;
+        return 0;
+    }
+
+    for( size_t i = 0; i < i_count; i++ )
+    {
+        pp_mds[i] = vlc_array_item_at_index( &p_mlist->items, i );
+        libvlc_media_retain( pp_mds[i] );
+    }
+    vlc_mutex_unlock( &p_mlist->object_lock );
+
+    *ppp_mds = pp_mds;
+    return i_count;
+}
+
+/**************************************************************************
+ *       libvlc_media_list_snapshot_release (Public)
+ **************************************************************************/
+void libvlc_media_list_snapshot_release( libvlc_media_t ** pp_mds,
+                                         size_t i_count )
+{
+    for( size_t i = 0; i < i_count; i++ )
+        libvlc_media_release( pp_mds[i] );
+    free( pp_mds );
+}
+
 /**************************************************************************
  *       libvlc_media_list_index_of_item (Public)
  *
@@ -493,6 +493,22 @@ on_audio_device_changed(audio_output_t *aout, const char *device, void *data)
     libvlc_event_send(&mp->event_manager, &event);
 }
 
+static void
+on_playback_latency_changed(vlc_player_t *player, vlc_tick_t latency,
+                            void *data)
+{
+    (void) player;
+
+    libvlc_media_player_t *mp = data;
+
+    libvlc_event_t event;
+    event.type = libvlc_MediaPlayerFirstFrameLatency;
+    event.u.media_player_first_frame_latency.new_latency =
+        MS_FROM_VLC_TICK(latency);
+
+    libvlc_event_send(&mp->event_manager, &event);
+}
+
 static const struct vlc_player_cbs vlc_player_cbs = {
     .on_current_media_changed = on_current_media_changed,
     .on_state_changed = on_state_changed,
@@ -511,6 +527,7 @@ static const struct vlc_player_cbs vlc_player_cbs = {
     .on_media_subitems_changed = on_media_subitems_changed,
     .on_cork_changed = on_cork_changed,
     .on_vout_changed = on_vout_changed,
+    .on_playback_latency_changed = on_playback_latency_changed,
 };
 
 static const struct vlc_player_aout_cbs vlc_player_aout_cbs = {
@@ -1291,9 +1308,17 @@ libvlc_time_t libvlc_media_player_get_length(
 libvlc_time_t libvlc_media_player_get_time( libvlc_media_player_t *p_mi )
 {
     vlc_player_t *player = p_mi->player;
+    vlc_tick_t tick;
+
+    /* Fast path: interpolate from the last timer point without locking the
+     * player, it can be polled at a high rate without disturbing playback */
+    if (vlc_player_GetTimerPoint(player, vlc_tick_now(), &tick, NULL)
+            == VLC_SUCCESS)
+        return from_mtime(tick);
+
     vlc_player_Lock(player);
 
-    vlc_tick_t tick = vlc_player_GetTime(player);
+    tick = vlc_player_GetTime(player);
     libvlc_time_t i_time = from_mtime(tick);
 
     vlc_player_Unlock(player);
@@ -1337,9 +1362,17 @@ int libvlc_media_player_set_position( libvlc_media_player_t *p_mi,
 float libvlc_media_player_get_position( libvlc_media_player_t *p_mi )
 {
     vlc_player_t *player = p_mi->player;
+    float f_position;
+
+    /* Fast path: interpolate from the last timer point without locking the
+     * player, it can be polled at a high rate without disturbing playback */
+    if (vlc_player_GetTimerPoint(player, vlc_tick_now(), NULL, &f_position)
+            == VLC_SUCCESS)
+        return f_position;
+
     vlc_player_Lock(player);
 
-    float f_position = vlc_player_GetPosition(player);
+    f_position = vlc_player_GetPosition(player);
 
     vlc_player_Unlock(player);
     return f_position;
@@ -68,6 +68,9 @@ typedef struct
 {
     AVIOContext *context;
     int64_t size;
+    /* Throughput measurement, to help tuning the caching/buffer sizes */
+    uint64_t received;
+    vlc_tick_t first_read;
 } access_sys_t;
 
 typedef struct
@@ -130,6 +133,28 @@ int OpenAvio(vlc_object_t *object)
     free(url);
 
     sys->size = avio_size(sys->context);
+    sys->received = 0;
+    sys->first_read = VLC_TICK_INVALID;
+
+    /* The avio buffer is all that decouples our reads from the network;
+     * scale it with the configured caching depth.  This must happen before
+     * the first read, while the buffer is still empty. */
+    int64_t caching = var_InheritInteger(access, "network-caching");
+    size_t bufsize = sys->context->buffer_size;
+    while (caching > 1000 && bufsize < (1 << 20)) {
+        caching /= 2;
+        bufsize *= 2;
+    }
+    if (bufsize > (size_t)sys->context->buffer_size) {
+        unsigned char *buf = av_malloc(bufsize);
+        if (buf != NULL) {
+            av_free(sys->context->buffer);
+            sys->context->buffer = buf;
+            sys->context->buf_ptr = sys->context->buf_end = buf;
+            sys->context->buffer_size = bufsize;
+            msg_Dbg(access, "avio buffer enlarged to %zu bytes", bufsize);
+        }
+    }
 
     bool seekable;
     seekable = sys->context->seekable;
@@ -202,6 +227,13 @@ void CloseAvio(vlc_object_t *object)
     stream_t *access = (stream_t*)object;
     access_sys_t *sys = access->p_sys;
 
+    if (sys->first_read != VLC_TICK_INVALID) {
+        vlc_tick_t interval = vlc_tick_now() - sys->first_read;
+        if (interval > 0)
+            msg_Dbg(access, "received %"PRIu64" bytes, "
+                    "average %"PRIu64" kb/s", sys->received,
+                    (sys->received * 8 * CLOCK_FREQ) / (1000 * interval));
+    }
     avio_close(sys->context);
 }
 
@@ -217,9 +249,13 @@ static ssize_t Read(stream_t *access, void *data, size_t size)
 {
     access_sys_t *sys = access->p_sys;
 
+    if (sys->first_read == VLC_TICK_INVALID)
+        sys->first_read = vlc_tick_now();
+
     int r = avio_read(sys->context, data, size);
     if (r < 0)
         r = 0;
+    sys->received += r;
     return r;
 }
 
@@ -360,6 +360,17 @@ typedef struct
     /* stream input */
     vlc_mutex_t         read_block_lock;
 
+    /* Sequential read-ahead over the stream input, protected by
+     * read_block_lock. Serves libbluray block reads from one large
+     * burst per clip run instead of one seek + read per request. */
+    struct
+    {
+        uint8_t        *p_buffer;
+        int             i_lba;      /* first buffered block, -1 if empty */
+        int             i_blocks;   /* buffered block count */
+        int             i_next_lba; /* next lba of a sequential pattern */
+    } readahead;
+
     /* Used to store bluray disc path */
     char                *psz_bd_path;
 } demux_sys_t;
@@ -713,6 +724,9 @@ static int probeStream(demux_t *p_demux)
 }
 
 #ifdef BLURAY_DEMUX
+/* 512 KiB of 2 KiB blocks read ahead during sequential clip playback */
+#define BLURAY_READAHEAD_BLOCKS 256
+
 static int blurayReadBlock(void *object, void *buf, int lba, int num_blocks)
 {
     demux_t *p_demux = (demux_t*)object;
@@ -723,20 +737,59 @@ static int blurayReadBlock(void *object, void *buf, int lba, int num_blocks)
 
     vlc_mutex_lock(&p_sys->read_block_lock);
 
+    /* Serve sequential playback from the read-ahead buffer */
+    if (p_sys->readahead.i_lba >= 0 && lba >= p_sys->readahead.i_lba &&
+        lba + num_blocks <= p_sys->readahead.i_lba + p_sys->readahead.i_blocks) {
+        size_t offset = (size_t)2048 * (lba - p_sys->readahead.i_lba);
+        memcpy(buf, &p_sys->readahead.p_buffer[offset],
+               (size_t)2048 * num_blocks);
+        p_sys->readahead.i_next_lba = lba + num_blocks;
+        vlc_mutex_unlock(&p_sys->read_block_lock);
+        return num_blocks;
+    }
+
+    /* Only read ahead once the request pattern is sequential: metadata
+     * parsing and menu jumps keep issuing direct reads */
+    bool b_sequential = lba == p_sys->readahead.i_next_lba
+                     && num_blocks <= BLURAY_READAHEAD_BLOCKS;
+    if (b_sequential && p_sys->readahead.p_buffer == NULL) {
+        p_sys->readahead.p_buffer =
+            malloc((size_t)2048 * BLURAY_READAHEAD_BLOCKS);
+        if (p_sys->readahead.p_buffer == NULL)
+            b_sequential = false;
+    }
+
     if (vlc_stream_Seek( p_demux->s, lba * INT64_C(2048) ) == VLC_SUCCESS) {
-        size_t  req = (size_t)2048 * num_blocks;
         ssize_t got;
 
-        got = vlc_stream_Read( p_demux->s, buf, req);
-        if (got < 0) {
-            msg_Err(p_demux, "read from lba %d failed", lba);
+        if (b_sequential) {
+            got = vlc_stream_Read( p_demux->s, p_sys->readahead.p_buffer,
+                                   (size_t)2048 * BLURAY_READAHEAD_BLOCKS );
+            p_sys->readahead.i_lba = -1;
+            p_sys->readahead.i_blocks = 0;
+            if (got < 0) {
+                msg_Err(p_demux, "read from lba %d failed", lba);
+            } else {
+                p_sys->readahead.i_lba = lba;
+                p_sys->readahead.i_blocks = got / 2048;
+                result = __MIN(num_blocks, p_sys->readahead.i_blocks);
+                memcpy(buf, p_sys->readahead.p_buffer, (size_t)2048 * result);
+            }
         } else {
-            result = got / 2048;
+            got = vlc_stream_Read( p_demux->s, buf,
+                                   (size_t)2048 * num_blocks );
+            if (got < 0) {
+                msg_Err(p_demux, "read from lba %d failed", lba);
+            } else {
+                result = got / 2048;
+            }
         }
     } else {
        msg_Err(p_demux, "seek to lba %d failed", lba);
     }
 
+    p_sys->readahead.i_next_lba = result > 0 ? lba + result : -1;
+
     vlc_mutex_unlock(&p_sys->read_block_lock);
 
     return result;
@@ -872,6 +925,10 @@ static int blurayOpen(vlc_object_t *object)
     vlc_mutex_init(&p_sys->pl_info_lock);
     vlc_mutex_init(&p_sys->bdj.lock);
     vlc_mutex_init(&p_sys->read_block_lock); /* used during bd_open_stream() */
+    p_sys->readahead.p_buffer = NULL;
+    p_sys->readahead.i_lba = -1;
+    p_sys->readahead.i_blocks = 0;
+    p_sys->readahead.i_next_lba = -1;
 
     /* request sub demuxers to skip continuity check as some split
        file concatenation are just resetting counters... */
@@ -1133,6 +1190,7 @@ static void blurayClose(vlc_object_t *object)
 
     ARRAY_RESET(p_sys->events_delayed);
 
+    free(p_sys->readahead.p_buffer);
     free(p_sys->psz_bd_path);
 }
 
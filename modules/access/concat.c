@@ -23,6 +23,7 @@
 #endif
 
 #include <assert.h>
+#include <stdatomic.h>
 #include <stdint.h>
 
 #include <vlc_common.h>
@@ -32,6 +33,7 @@
 struct access_entry
 {
     struct access_entry *next;
+    uint64_t size; /**< probed at open, UINT64_MAX if unknown */
     char mrl[1];
 };
 
@@ -40,14 +42,145 @@ typedef struct
     stream_t *access;
     struct access_entry *next;
     struct access_entry *first;
+    block_t *peek; /**< leftover prefetched head of the current access */
     bool can_seek;
     bool can_seek_fast;
     bool can_pause;
     bool can_control_pace;
     uint64_t size;
     vlc_tick_t caching;
+
+    /* Next-segment prefetch: a worker pre-opens the upcoming entry and
+     * reads its head while the current segment still plays, so segment
+     * boundaries do not stall on a cold open. */
+    vlc_thread_t thread;
+    vlc_mutex_t lock;
+    vlc_cond_t wait;
+    struct access_entry *want; /**< entry to pre-open (NULL: idle) */
+    struct access_entry *ready_entry;
+    stream_t *ready; /**< pre-opened access for ready_entry */
+    block_t *head; /**< prefetched head bytes of ready */
+    bool have_thread;
+    bool quit;
 } access_sys_t;
 
+static void *PrefetchThread(void *data)
+{
+    stream_t *access = data;
+    access_sys_t *sys = access->p_sys;
+
+    vlc_mutex_lock(&sys->lock);
+    while (!sys->quit)
+    {
+        struct access_entry *entry = sys->want;
+        if (entry == NULL || entry == sys->ready_entry)
+        {
+            vlc_cond_wait(&sys->wait, &sys->lock);
+            continue;
+        }
+        vlc_mutex_unlock(&sys->lock);
+
+        stream_t *a = vlc_access_NewMRL(VLC_OBJECT(access), entry->mrl);
+        block_t *head = (a != NULL) ? vlc_stream_ReadBlock(a) : NULL;
+
+        vlc_mutex_lock(&sys->lock);
+        if (sys->quit || sys->want != entry)
+        {   /* the request changed (seek) while opening: discard */
+            vlc_mutex_unlock(&sys->lock);
+            if (head != NULL)
+                block_Release(head);
+            if (a != NULL)
+                vlc_stream_Delete(a);
+            vlc_mutex_lock(&sys->lock);
+            continue;
+        }
+
+        assert(sys->ready == NULL);
+        if (a != NULL)
+        {
+            sys->ready = a;
+            sys->ready_entry = entry;
+            sys->head = head;
+        }
+        /* on open failure, leave it to the synchronous fall-back */
+        sys->want = NULL;
+    }
+    vlc_mutex_unlock(&sys->lock);
+    return NULL;
+}
+
+static void PrefetchRequest(stream_t *access, struct access_entry *entry)
+{
+    access_sys_t *sys = access->p_sys;
+    stream_t *stale = NULL;
+    block_t *stale_head = NULL;
+
+    if (!sys->have_thread)
+        return;
+
+    vlc_mutex_lock(&sys->lock);
+    if (sys->ready != NULL && sys->ready_entry != entry)
+    {   /* an unconsumed result for another entry is stale (seek) */
+        stale = sys->ready;
+        stale_head = sys->head;
+        sys->ready = NULL;
+        sys->ready_entry = NULL;
+        sys->head = NULL;
+    }
+    sys->want = entry;
+    vlc_cond_signal(&sys->wait);
+    vlc_mutex_unlock(&sys->lock);
+
+    if (stale_head != NULL)
+        block_Release(stale_head);
+    if (stale != NULL)
+        vlc_stream_Delete(stale);
+}
+
+/**
+ * Takes the pre-opened access for \p entry if the prefetcher has it ready,
+ * stashing its prefetched head bytes in sys->peek. A pre-opened access for
+ * any other entry is stale and gets discarded.
+ */
+static stream_t *PrefetchTake(stream_t *access, struct access_entry *entry)
+{
+    access_sys_t *sys = access->p_sys;
+    stream_t *a = NULL, *stale = NULL;
+    block_t *head = NULL;
+
+    if (!sys->have_thread)
+        return NULL;
+
+    vlc_mutex_lock(&sys->lock);
+    if (sys->ready != NULL)
+    {
+        if (sys->ready_entry == entry)
+            a = sys->ready;
+        else
+            stale = sys->ready;
+        head = sys->head;
+        sys->ready = NULL;
+        sys->ready_entry = NULL;
+        sys->head = NULL;
+    }
+    vlc_mutex_unlock(&sys->lock);
+
+    if (stale != NULL)
+    {
+        if (head != NULL)
+            block_Release(head);
+        vlc_stream_Delete(stale);
+        return NULL;
+    }
+
+    if (a != NULL)
+    {
+        assert(sys->peek == NULL);
+        sys->peek = head;
+    }
+    return a;
+}
+
 static stream_t *GetAccess(stream_t *access)
 {
     access_sys_t *sys = access->p_sys;
@@ -65,17 +198,39 @@ static stream_t *GetAccess(stream_t *access)
     if (sys->next == NULL)
         return NULL;
 
-    a = vlc_access_NewMRL(VLC_OBJECT(access), sys->next->mrl);
+    a = PrefetchTake(access, sys->next);
+    if (a == NULL)
+        a = vlc_access_NewMRL(VLC_OBJECT(access), sys->next->mrl);
     if (a == NULL)
         return NULL;
 
     sys->access = a;
     sys->next = sys->next->next;
+    if (sys->next != NULL)
+        PrefetchRequest(access, sys->next);
     return a;
 }
 
 static ssize_t Read(stream_t *access, void *buf, size_t len)
 {
+    access_sys_t *sys = access->p_sys;
+    block_t *peek = sys->peek;
+
+    if (peek != NULL)
+    {   /* drain the prefetched head before reading further */
+        if (len > peek->i_buffer)
+            len = peek->i_buffer;
+        memcpy(buf, peek->p_buffer, len);
+        peek->p_buffer += len;
+        peek->i_buffer -= len;
+        if (peek->i_buffer == 0)
+        {
+            block_Release(peek);
+            sys->peek = NULL;
+        }
+        return len;
+    }
+
     stream_t *a = GetAccess(access);
     if (a == NULL)
         return 0;
@@ -91,6 +246,15 @@ static ssize_t Read(stream_t *access, void *buf, size_t len)
 
 static block_t *Block(stream_t *access, bool *restrict eof)
 {
+    access_sys_t *sys = access->p_sys;
+    block_t *peek = sys->peek;
+
+    if (peek != NULL)
+    {   /* drain the prefetched head before reading further */
+        sys->peek = NULL;
+        return peek;
+    }
+
     stream_t *a = GetAccess(access);
     if (a == NULL)
     {
@@ -104,40 +268,69 @@ static block_t *Block(stream_t *access, bool *restrict eof)
 static int Seek(stream_t *access, uint64_t position)
 {
     access_sys_t *sys = access->p_sys;
+    uint64_t offset = 0;
 
     if (sys->access != NULL)
     {
         vlc_stream_Delete(sys->access);
         sys->access = NULL;
     }
-
-    sys->next = sys->first;
-
-    for (uint64_t offset = 0;;)
+    if (sys->peek != NULL)
     {
-        stream_t *a = GetAccess(access);
-        if (a == NULL)
-            break;
-
-        bool can_seek;
-        vlc_stream_Control(a, STREAM_CAN_SEEK, &can_seek);
-        if (!can_seek)
-            break;
+        block_Release(sys->peek);
+        sys->peek = NULL;
+    }
 
-        uint64_t size;
+    for (struct access_entry *e = sys->first; e != NULL; e = e->next)
+    {
+        uint64_t size = e->size;
+        stream_t *a = NULL;
+
+        if (size == UINT64_MAX)
+        {   /* size unknown at open time: probe it now */
+            a = PrefetchTake(access, e);
+            if (a == NULL)
+                a = vlc_access_NewMRL(VLC_OBJECT(access), e->mrl);
+            if (a == NULL)
+                break;
+            if (vlc_stream_GetSize(a, &size))
+            {
+                vlc_stream_Delete(a);
+                break;
+            }
+        }
 
-        if (vlc_stream_GetSize(a, &size))
-            break;
         if (position - offset < size)
         {
+            if (a == NULL)
+            {
+                a = PrefetchTake(access, e);
+                if (a == NULL)
+                    a = vlc_access_NewMRL(VLC_OBJECT(access), e->mrl);
+                if (a == NULL)
+                    break;
+            }
+            if (sys->peek != NULL)
+            {   /* the prefetched head only matches a read from offset 0 */
+                block_Release(sys->peek);
+                sys->peek = NULL;
+            }
             if (vlc_stream_Seek(a, position - offset))
+            {
+                vlc_stream_Delete(a);
                 break;
+            }
+
+            sys->access = a;
+            sys->next = e->next;
+            if (sys->next != NULL)
+                PrefetchRequest(access, sys->next);
             return VLC_SUCCESS;
         }
 
+        if (a != NULL)
+            vlc_stream_Delete(a);
         offset += size;
-        vlc_stream_Delete(a);
-        sys->access = NULL;
     }
 
     return VLC_EGENERIC;
@@ -180,6 +373,71 @@ static int Control(stream_t *access, int query, va_list args)
     return VLC_SUCCESS;
 }
 
+struct probe_result
+{
+    struct access_entry *entry;
+    bool ok;
+    bool is_dir;
+    bool block_only;
+    bool can_seek;
+    bool can_seek_fast;
+    bool can_pause;
+    bool can_control_pace;
+    bool size_known;
+    uint64_t size;
+    vlc_tick_t caching;
+};
+
+struct probe_job
+{
+    vlc_object_t *obj;
+    struct probe_result *results;
+    size_t count;
+    atomic_size_t next;
+};
+
+static void ProbeEntry(vlc_object_t *obj, struct probe_result *r)
+{
+    stream_t *a = vlc_access_NewMRL(obj, r->entry->mrl);
+    if (a == NULL)
+        return;
+
+    if (a->pf_read == NULL)
+    {
+        if (a->pf_block == NULL)
+        {
+            r->is_dir = true;
+            vlc_stream_Delete(a);
+            return;
+        }
+        r->block_only = true;
+    }
+
+    vlc_stream_Control(a, STREAM_CAN_SEEK, &r->can_seek);
+    vlc_stream_Control(a, STREAM_CAN_FASTSEEK, &r->can_seek_fast);
+    vlc_stream_Control(a, STREAM_CAN_PAUSE, &r->can_pause);
+    vlc_stream_Control(a, STREAM_CAN_CONTROL_PACE, &r->can_control_pace);
+    r->size_known = vlc_stream_GetSize(a, &r->size) == 0;
+    vlc_stream_Control(a, STREAM_GET_PTS_DELAY, &r->caching);
+    vlc_stream_Delete(a);
+    r->ok = true;
+}
+
+static void *ProbeThread(void *data)
+{
+    struct probe_job *job = data;
+
+    for (;;)
+    {
+        size_t i = atomic_fetch_add_explicit(&job->next, 1,
+                                             memory_order_relaxed);
+        if (i >= job->count)
+            break;
+        ProbeEntry(job->obj, &job->results[i]);
+    }
+    return NULL;
+}
+
 static int Open(vlc_object_t *obj)
 {
     stream_t *access = (stream_t *)obj;
@@ -200,14 +458,26 @@ static int Open(vlc_object_t *obj)
     bool read_cb = true;
 
     sys->access = NULL;
+    sys->peek = NULL;
     sys->can_seek = true;
     sys->can_seek_fast = true;
     sys->can_pause = true;
     sys->can_control_pace = true;
     sys->size = 0;
     sys->caching = 0;
-
+    sys->want = NULL;
+    sys->ready_entry = NULL;
+    sys->ready = NULL;
+    sys->head = NULL;
+    sys->have_thread = false;
+    sys->quit = false;
+    vlc_mutex_init(&sys->lock);
+    vlc_cond_init(&sys->wait);
+
+    /* Parse the list first; the entries are probed afterwards, in parallel,
+     * since each probe may incur an open round-trip. */
     struct access_entry **pp = &sys->first;
+    size_t count = 0;
 
     for (char *buf, *mrl = strtok_r(list, ",", &buf);
          mrl != NULL;
@@ -218,60 +488,99 @@ static int Open(vlc_object_t *obj)
         if (unlikely(e == NULL))
             break;
 
-        stream_t *a = vlc_access_NewMRL(obj, mrl);
-        if (a == NULL)
+        *pp = e;
+        e->next = NULL;
+        e->size = UINT64_MAX;
+        memcpy(e->mrl, mrl, mlen + 1);
+        pp = &e->next;
+        count++;
+    }
+
+    free(list);
+    *pp = NULL;
+
+    struct probe_result *results = vlc_alloc(count, sizeof (*results));
+    if (count > 0 && unlikely(results == NULL))
+    {
+        for (struct access_entry *e = sys->first, *next; e != NULL; e = next)
         {
-            msg_Err(access, "cannot concatenate location %s", mrl);
+            next = e->next;
             free(e);
-            continue;
         }
+        var_Destroy(access, "concat-list");
+        return VLC_ENOMEM;
+    }
 
-        if (a->pf_read == NULL)
+    size_t i = 0;
+    for (struct access_entry *e = sys->first; e != NULL; e = e->next, i++)
+        results[i] = (struct probe_result) {
+            .entry = e,
+            .can_seek = true, .can_seek_fast = true,
+            .can_pause = true, .can_control_pace = true,
+        };
+
+    struct probe_job job = { obj, results, count, 0 };
+    vlc_thread_t probers[8];
+    size_t spawned = 0;
+    size_t workers = vlc_GetCPUCount();
+
+    if (workers > count)
+        workers = count;
+    if (workers > ARRAY_SIZE(probers) + 1)
+        workers = ARRAY_SIZE(probers) + 1;
+    for (size_t w = 1; w < workers; w++)
+        if (vlc_clone(probers + spawned, ProbeThread, &job,
+                      VLC_THREAD_PRIORITY_INPUT) == 0)
+            spawned++;
+
+    ProbeThread(&job);
+
+    while (spawned > 0)
+        vlc_join(probers[--spawned], NULL);
+
+    /* Aggregate in list order, dropping the entries that failed to open */
+    pp = &sys->first;
+
+    for (i = 0; i < count; i++)
+    {
+        struct probe_result *r = &results[i];
+        struct access_entry *e = r->entry;
+
+        if (!r->ok)
         {
-            if (a->pf_block == NULL)
-            {
-                msg_Err(access, "cannot concatenate directory %s", mrl);
-                vlc_stream_Delete(a);
-                free(e);
-                continue;
-            }
-            read_cb = false;
+            msg_Err(access, r->is_dir ? "cannot concatenate directory %s"
+                                      : "cannot concatenate location %s",
+                    e->mrl);
+            free(e);
+            continue;
         }
 
         *pp = e;
-        e->next = NULL;
-        memcpy(e->mrl, mrl, mlen + 1);
+        pp = &e->next;
 
-        if (sys->can_seek)
-            vlc_stream_Control(a, STREAM_CAN_SEEK, &sys->can_seek);
-        if (sys->can_seek_fast)
-            vlc_stream_Control(a, STREAM_CAN_FASTSEEK, &sys->can_seek_fast);
-        if (sys->can_pause)
-            vlc_stream_Control(a, STREAM_CAN_PAUSE, &sys->can_pause);
-        if (sys->can_control_pace)
-            vlc_stream_Control(a, STREAM_CAN_CONTROL_PACE,
-                               &sys->can_control_pace);
-        if (sys->size != UINT64_MAX)
-        {
-            uint64_t size;
+        if (r->block_only)
+            read_cb = false;
 
-            if (vlc_stream_GetSize(a, &size))
-                sys->size = UINT64_MAX;
-            else
-                sys->size += size;
-        }
+        sys->can_seek = sys->can_seek && r->can_seek;
+        sys->can_seek_fast = sys->can_seek_fast && r->can_seek_fast;
+        sys->can_pause = sys->can_pause && r->can_pause;
+        sys->can_control_pace = sys->can_control_pace && r->can_control_pace;
 
-        vlc_tick_t caching;
-        vlc_stream_Control(a, STREAM_GET_PTS_DELAY, &caching);
-        if (caching > sys->caching)
-            sys->caching = caching;
+        if (r->size_known)
+        {
+            e->size = r->size;
+            if (sys->size != UINT64_MAX)
+                sys->size += r->size;
+        }
+        else
+            sys->size = UINT64_MAX;
 
-        vlc_stream_Delete(a);
-        pp = &e->next;
+        if (r->caching > sys->caching)
+            sys->caching = r->caching;
     }
 
-    free(list);
     *pp = NULL;
+    free(results);
     sys->next = sys->first;
 
     access->pf_read = read_cb ? Read : NULL;
@@ -280,6 +589,11 @@ static int Open(vlc_object_t *obj)
     access->pf_control = Control;
     access->p_sys = sys;
 
+    if (sys->first != NULL && sys->first->next != NULL
+     && vlc_clone(&sys->thread, PrefetchThread, access,
+                  VLC_THREAD_PRIORITY_LOW) == 0)
+        sys->have_thread = true;
+
     return VLC_SUCCESS;
 }
 
@@ -288,6 +602,22 @@ static void Close(vlc_object_t *obj)
     stream_t *access = (stream_t *)obj;
     access_sys_t *sys = access->p_sys;
 
+    if (sys->have_thread)
+    {
+        vlc_mutex_lock(&sys->lock);
+        sys->quit = true;
+        vlc_cond_signal(&sys->wait);
+        vlc_mutex_unlock(&sys->lock);
+        vlc_join(sys->thread, NULL);
+
+        if (sys->head != NULL)
+            block_Release(sys->head);
+        if (sys->ready != NULL)
+            vlc_stream_Delete(sys->ready);
+    }
+
+    if (sys->peek != NULL)
+        block_Release(sys->peek);
     if (sys->access != NULL)
         vlc_stream_Delete(sys->access);
 
@@ -58,6 +58,7 @@
 /* ASDCP headers */
 #include <AS_DCP.h>
 
+#include <climits>
 #include <vector>
 
 #include "dcpparser.h"
@@ -110,6 +111,19 @@ struct audioReader_t
     PCM::MXFReader *p_AudioMXFReader;
 };
 
+/* Number of frames read and decrypted ahead of the demux thread */
+#define PREFETCH_DEPTH 2
+
+/* One read+decrypted frame, produced by the fetch thread */
+struct fetched_frame_t
+{
+    block_t *p_video;
+    block_t *p_audio;
+    uint32_t frame_no;
+    bool b_eof;
+    bool b_error;
+};
+
 /* ASDCP library (version 1.10.48) can handle files having one of the following Essence Types, as defined in AS_DCP.h:
     ESS_UNKNOWN,     // the file is not a supported AS-DCP essence container
     ESS_MPEG2_VES,   // the file contains an MPEG video elementary stream
@@ -166,6 +180,18 @@ class demux_sys_t
 
     vlc_tick_t i_pts;
 
+    /* Prefetch pipeline: a worker thread reads and decrypts frames ahead,
+     * so the demux thread only forwards completed frames */
+    vlc_thread_t fetch_thread;
+    bool b_thread;
+    vlc_mutex_t lock;
+    vlc_cond_t wait;
+    fetched_frame_t queue[PREFETCH_DEPTH];
+    unsigned i_queue;
+    bool b_quit;
+    bool b_seek;
+    uint32_t i_seek_frame;
+
     demux_sys_t():
         PictureEssType ( ESS_UNKNOWN ),
         v_videoReader(),
@@ -177,8 +203,16 @@ class demux_sys_t
         frames_total( 0 ),
         i_video_reel( 0 ),
         i_audio_reel( 0 ),
-        i_pts( 0 )
-    {}
+        i_pts( 0 ),
+        b_thread( false ),
+        i_queue( 0 ),
+        b_quit( false ),
+        b_seek( false ),
+        i_seek_frame( 0 )
+    {
+        vlc_mutex_init( &lock );
+        vlc_cond_init( &wait );
+    }
 
     ~demux_sys_t()
     {
@@ -290,6 +324,7 @@ static const unsigned i_channel_mask[] =
 
 static int Demux( demux_t * );
 static int Control( demux_t *, int, va_list );
+static void *FetchThread( void * );
 
 int dcpInit ( demux_t *p_demux );
 int parseXML ( demux_t * p_demux );
@@ -584,6 +619,15 @@ static int Open( vlc_object_t *obj )
     p_demux->pf_control = Control;
     p_sys->frame_no = p_sys->p_dcp->video_reels[0].i_entrypoint;
 
+    if( vlc_clone( &p_sys->fetch_thread, FetchThread, p_demux,
+                   VLC_THREAD_PRIORITY_INPUT ) )
+    {
+        msg_Err( p_demux, "Failed to spawn the DCP fetch thread" );
+        retval = VLC_EGENERIC;
+        goto error;
+    }
+    p_sys->b_thread = true;
+
     return VLC_SUCCESS;
 error:
     CloseDcpAndMxf( p_demux );
@@ -603,61 +647,26 @@ static inline void Close( vlc_object_t *obj )
 
 
 /*****************************************************************************
- * Demux: DCP Demuxing function
+ * FetchFrame: read and decrypt one frame (fetch thread)
  *****************************************************************************/
-static int Demux( demux_t *p_demux )
+static int FetchFrame( demux_t *p_demux, uint32_t frame_no,
+                       unsigned i_video_reel, unsigned i_audio_reel,
+                       AESDecContext *p_video_aes_ctx,
+                       AESDecContext *p_audio_aes_ctx,
+                       block_t **pp_video_frame, block_t **pp_audio_frame )
 {
     demux_sys_t *p_sys = (demux_sys_t *)p_demux->p_sys;
     block_t *p_video_frame = NULL, *p_audio_frame = NULL;
 
     PCM::FrameBuffer   AudioFrameBuff( p_sys->i_audio_buffer);
-    AESDecContext video_aes_ctx, audio_aes_ctx;
-
-    /* swaping video reels */
-    if  ( p_sys->frame_no == p_sys->p_dcp->video_reels[p_sys->i_video_reel].i_absolute_end )
-    {
-        if ( p_sys->i_video_reel + 1 == p_sys->v_videoReader.size() )
-        {
-            return 0;
-        }
-        else
-        {
-            p_sys->i_video_reel++;
-        }
-    }
-
-    /* swaping audio reels */
-    if  ( !p_sys->p_dcp->audio_reels.empty() && p_sys->frame_no == p_sys->p_dcp->audio_reels[p_sys->i_audio_reel].i_absolute_end )
-     {
-         if ( p_sys->i_audio_reel + 1 == p_sys->v_audioReader.size() )
-         {
-             return 0;//should never go there
-         }
-         else
-         {
-             p_sys->i_audio_reel++;
-         }
-     }
 
     /* video frame */
-
-    /* initialize AES context, if reel is encrypted */
-    if( p_sys->p_dcp->video_reels.size() > p_sys->i_video_reel &&
-        p_sys->p_dcp->video_reels[p_sys->i_video_reel].p_key )
-    {
-        if( ! ASDCP_SUCCESS( video_aes_ctx.InitKey( p_sys->p_dcp->video_reels[p_sys->i_video_reel].p_key->getKey() ) ) )
-        {
-            msg_Err( p_demux, "ASDCP failed to initialize AES key" );
-            goto error;
-        }
-    }
-
     switch( p_sys->PictureEssType )
     {
         case ESS_JPEG_2000:
         case ESS_JPEG_2000_S:{
             JP2K::FrameBuffer  PicFrameBuff(FRAME_BUFFER_SIZE);
-            int nextFrame = p_sys->frame_no + p_sys->p_dcp->video_reels[p_sys->i_video_reel].i_correction;
+            int nextFrame = frame_no + p_sys->p_dcp->video_reels[i_video_reel].i_correction;
             if ( ( p_video_frame = block_Alloc( FRAME_BUFFER_SIZE )) == NULL )
                 goto error;
 
@@ -666,13 +675,13 @@ static int Demux( demux_t *p_demux )
                 goto error_asdcp;
             if ( p_sys->PictureEssType == ESS_JPEG_2000_S ) {
                 if ( ! ASDCP_SUCCESS(
-                        p_sys->v_videoReader[p_sys->i_video_reel].p_PicMXFSReader->ReadFrame(nextFrame, JP2K::SP_LEFT, PicFrameBuff, &video_aes_ctx, 0)) ) {
+                        p_sys->v_videoReader[i_video_reel].p_PicMXFSReader->ReadFrame(nextFrame, JP2K::SP_LEFT, PicFrameBuff, p_video_aes_ctx, 0)) ) {
                     PicFrameBuff.SetData(0,0);
                     goto error_asdcp;
                 }
              } else {
                 if ( ! ASDCP_SUCCESS(
-                        p_sys->v_videoReader[p_sys->i_video_reel].p_PicMXFReader->ReadFrame(nextFrame, PicFrameBuff, &video_aes_ctx, 0)) ) {
+                        p_sys->v_videoReader[i_video_reel].p_PicMXFReader->ReadFrame(nextFrame, PicFrameBuff, p_video_aes_ctx, 0)) ) {
                     PicFrameBuff.SetData(0,0);
                     goto error_asdcp;
                 }
@@ -690,7 +699,7 @@ static int Demux( demux_t *p_demux )
                 goto error_asdcp;
 
             if ( ! ASDCP_SUCCESS(
-                    p_sys->v_videoReader[p_sys->i_video_reel].p_VideoMXFReader->ReadFrame(p_sys->frame_no + p_sys->p_dcp->video_reels[p_sys->i_video_reel].i_correction, VideoFrameBuff, &video_aes_ctx, 0)) ) {
+                    p_sys->v_videoReader[i_video_reel].p_VideoMXFReader->ReadFrame(frame_no + p_sys->p_dcp->video_reels[i_video_reel].i_correction, VideoFrameBuff, p_video_aes_ctx, 0)) ) {
                 VideoFrameBuff.SetData(0,0);
                 goto error_asdcp;
             }
@@ -704,7 +713,7 @@ static int Demux( demux_t *p_demux )
     }
 
     p_video_frame->i_length = vlc_tick_from_samples(p_sys->frame_rate_denom, p_sys->frame_rate_num);
-    p_video_frame->i_pts = vlc_tick_from_samples(p_sys->frame_no * p_sys->frame_rate_denom, p_sys->frame_rate_num);
+    p_video_frame->i_pts = vlc_tick_from_samples(frame_no * p_sys->frame_rate_denom, p_sys->frame_rate_num);
 
     if( !p_sys->p_dcp->audio_reels.empty() )
     {
@@ -713,24 +722,13 @@ static int Demux( demux_t *p_demux )
             goto error;
         }
 
-        /* initialize AES context, if reel is encrypted */
-        if( p_sys->p_dcp->audio_reels.size() > p_sys->i_audio_reel &&
-            p_sys->p_dcp->audio_reels[p_sys->i_audio_reel].p_key )
-        {
-            if( ! ASDCP_SUCCESS( audio_aes_ctx.InitKey( p_sys->p_dcp->audio_reels[p_sys->i_audio_reel].p_key->getKey() ) ) )
-            {
-                msg_Err( p_demux, "ASDCP failed to initialize AES key" );
-                goto error;
-            }
-        }
-
         if ( ! ASDCP_SUCCESS(
                 AudioFrameBuff.SetData(p_audio_frame->p_buffer, p_sys->i_audio_buffer)) ) {
             goto error_asdcp;
         }
 
         if ( ! ASDCP_SUCCESS(
-                p_sys->v_audioReader[p_sys->i_audio_reel].p_AudioMXFReader->ReadFrame(p_sys->frame_no + p_sys->p_dcp->audio_reels[p_sys->i_audio_reel].i_correction, AudioFrameBuff, &audio_aes_ctx, 0)) ) {
+                p_sys->v_audioReader[i_audio_reel].p_AudioMXFReader->ReadFrame(frame_no + p_sys->p_dcp->audio_reels[i_audio_reel].i_correction, AudioFrameBuff, p_audio_aes_ctx, 0)) ) {
             AudioFrameBuff.SetData(0,0);
             goto error_asdcp;
         }
@@ -742,23 +740,16 @@ static int Demux( demux_t *p_demux )
 
         p_audio_frame->i_buffer = AudioFrameBuff.Size();
         p_audio_frame->i_length = vlc_tick_from_samples(p_sys->frame_rate_denom, p_sys->frame_rate_num);
-        p_audio_frame->i_pts = vlc_tick_from_samples(p_sys->frame_no * p_sys->frame_rate_denom, p_sys->frame_rate_num);
+        p_audio_frame->i_pts = vlc_tick_from_samples(frame_no * p_sys->frame_rate_denom, p_sys->frame_rate_num);
         /* Video is the main pts */
         if ( p_audio_frame->i_pts != p_video_frame->i_pts ) {
             msg_Err( p_demux, "Audio and video frame pts are not in sync" );
         }
     }
 
-    p_sys->i_pts = p_video_frame->i_pts;
-    es_out_SetPCR( p_demux->out, p_sys->i_pts );
-    if(p_video_frame)
-        es_out_Send( p_demux->out, p_sys->p_video_es, p_video_frame );
-    if(p_audio_frame)
-        es_out_Send( p_demux->out, p_sys->p_audio_es, p_audio_frame );
-
-    p_sys->frame_no++;
-
-    return 1;
+    *pp_video_frame = p_video_frame;
+    *pp_audio_frame = p_audio_frame;
+    return VLC_SUCCESS;
 
 error_asdcp:
     msg_Err( p_demux, "Couldn't read frame with ASDCP");
@@ -767,7 +758,175 @@ error:
         block_Release(p_video_frame);
     if (p_audio_frame)
         block_Release(p_audio_frame);
-    return -1;
+    return VLC_EGENERIC;
+}
+
+/*****************************************************************************
+ * FetchThread: read-ahead and decryption worker
+ *****************************************************************************/
+static void *FetchThread( void *opaque )
+{
+    demux_t *p_demux = (demux_t *)opaque;
+    demux_sys_t *p_sys = (demux_sys_t *)p_demux->p_sys;
+
+    /* AES contexts are (re)keyed once per reel, not once per frame */
+    AESDecContext video_aes_ctx, audio_aes_ctx;
+    unsigned i_video_ctx_reel = UINT_MAX, i_audio_ctx_reel = UINT_MAX;
+
+    uint32_t frame_no = p_sys->frame_no;
+    unsigned i_video_reel = p_sys->i_video_reel;
+    unsigned i_audio_reel = p_sys->i_audio_reel;
+    bool b_parked = false;
+
+    vlc_mutex_lock( &p_sys->lock );
+    for( ;; )
+    {
+        while( !p_sys->b_quit && !p_sys->b_seek &&
+               ( p_sys->i_queue == PREFETCH_DEPTH || b_parked ) )
+            vlc_cond_wait( &p_sys->wait, &p_sys->lock );
+
+        if( p_sys->b_quit )
+            break;
+
+        if( p_sys->b_seek )
+        {
+            for( unsigned i = 0; i < p_sys->i_queue; i++ )
+            {
+                if( p_sys->queue[i].p_video )
+                    block_Release( p_sys->queue[i].p_video );
+                if( p_sys->queue[i].p_audio )
+                    block_Release( p_sys->queue[i].p_audio );
+            }
+            p_sys->i_queue = 0;
+            frame_no = p_sys->i_seek_frame;
+            p_sys->b_seek = false;
+            b_parked = false;
+
+            /* locate the reels containing the target frame */
+            i_video_reel = 0;
+            while( i_video_reel + 1 < p_sys->v_videoReader.size() &&
+                   frame_no >= p_sys->p_dcp->video_reels[i_video_reel].i_absolute_end )
+                i_video_reel++;
+            i_audio_reel = 0;
+            while( i_audio_reel + 1 < p_sys->v_audioReader.size() &&
+                   frame_no >= p_sys->p_dcp->audio_reels[i_audio_reel].i_absolute_end )
+                i_audio_reel++;
+        }
+        vlc_mutex_unlock( &p_sys->lock );
+
+        fetched_frame_t frame;
+        frame.p_video = frame.p_audio = NULL;
+        frame.frame_no = frame_no;
+        frame.b_eof = frame.b_error = false;
+
+        /* swaping video reels: done ahead of the demux thread, so the next
+         * reel is already open and keyed when the boundary frame is due */
+        if  ( frame_no == p_sys->p_dcp->video_reels[i_video_reel].i_absolute_end )
+        {
+            if ( i_video_reel + 1 == p_sys->v_videoReader.size() )
+                frame.b_eof = true;
+            else
+                i_video_reel++;
+        }
+
+        /* swaping audio reels */
+        if  ( !frame.b_eof && !p_sys->p_dcp->audio_reels.empty() &&
+              frame_no == p_sys->p_dcp->audio_reels[i_audio_reel].i_absolute_end )
+        {
+            if ( i_audio_reel + 1 == p_sys->v_audioReader.size() )
+                frame.b_eof = true; //should never go there
+            else
+                i_audio_reel++;
+        }
+
+        if( !frame.b_eof )
+        {
+            /* initialize AES context, if reel is encrypted */
+            if( i_video_ctx_reel != i_video_reel )
+            {
+                if( p_sys->p_dcp->video_reels.size() > i_video_reel &&
+                    p_sys->p_dcp->video_reels[i_video_reel].p_key &&
+                    ! ASDCP_SUCCESS( video_aes_ctx.InitKey( p_sys->p_dcp->video_reels[i_video_reel].p_key->getKey() ) ) )
+                {
+                    msg_Err( p_demux, "ASDCP failed to initialize AES key" );
+                    frame.b_error = true;
+                }
+                i_video_ctx_reel = i_video_reel;
+            }
+            if( !frame.b_error && i_audio_ctx_reel != i_audio_reel )
+            {
+                if( p_sys->p_dcp->audio_reels.size() > i_audio_reel &&
+                    p_sys->p_dcp->audio_reels[i_audio_reel].p_key &&
+                    ! ASDCP_SUCCESS( audio_aes_ctx.InitKey( p_sys->p_dcp->audio_reels[i_audio_reel].p_key->getKey() ) ) )
+                {
+                    msg_Err( p_demux, "ASDCP failed to initialize AES key" );
+                    frame.b_error = true;
+                }
+                i_audio_ctx_reel = i_audio_reel;
+            }
+
+            if( !frame.b_error &&
+                FetchFrame( p_demux, frame_no, i_video_reel, i_audio_reel,
+                            &video_aes_ctx, &audio_aes_ctx,
+                            &frame.p_video, &frame.p_audio ) != VLC_SUCCESS )
+                frame.b_error = true;
+        }
+
+        vlc_mutex_lock( &p_sys->lock );
+        if( p_sys->b_seek )
+        {   /* raced with a seek: this frame is stale */
+            if( frame.p_video )
+                block_Release( frame.p_video );
+            if( frame.p_audio )
+                block_Release( frame.p_audio );
+            continue;
+        }
+
+        p_sys->queue[p_sys->i_queue++] = frame;
+        vlc_cond_broadcast( &p_sys->wait );
+
+        if( frame.b_eof || frame.b_error )
+            b_parked = true; /* wait for a seek (or termination) */
+        else
+            frame_no++;
+    }
+    vlc_mutex_unlock( &p_sys->lock );
+    return NULL;
+}
+
+/*****************************************************************************
+ * Demux: DCP Demuxing function
+ *****************************************************************************/
+static int Demux( demux_t *p_demux )
+{
+    demux_sys_t *p_sys = (demux_sys_t *)p_demux->p_sys;
+    fetched_frame_t frame;
+
+    vlc_mutex_lock( &p_sys->lock );
+    while( p_sys->i_queue == 0 )
+        vlc_cond_wait( &p_sys->wait, &p_sys->lock );
+
+    frame = p_sys->queue[0];
+    p_sys->i_queue--;
+    for( unsigned i = 0; i < p_sys->i_queue; i++ )
+        p_sys->queue[i] = p_sys->queue[i + 1];
+    vlc_cond_broadcast( &p_sys->wait );
+    vlc_mutex_unlock( &p_sys->lock );
+
+    if( frame.b_error )
+        return -1;
+    if( frame.b_eof )
+        return 0;
+
+    p_sys->frame_no = frame.frame_no + 1;
+    p_sys->i_pts = frame.p_video->i_pts;
+    es_out_SetPCR( p_demux->out, p_sys->i_pts );
+    if( frame.p_video )
+        es_out_Send( p_demux->out, p_sys->p_video_es, frame.p_video );
+    if( frame.p_audio )
+        es_out_Send( p_demux->out, p_sys->p_audio_es, frame.p_audio );
+
+    return 1;
 }
 
 /*****************************************************************************
@@ -810,7 +969,12 @@ static int Control( demux_t *p_demux, int query, va_list args )
 
         case DEMUX_SET_POSITION:
             f = va_arg( args, double );
+            vlc_mutex_lock( &p_sys->lock );
             p_sys->frame_no = (int) ( f * p_sys->frames_total );
+            p_sys->i_seek_frame = p_sys->frame_no;
+            p_sys->b_seek = true;
+            vlc_cond_broadcast( &p_sys->wait );
+            vlc_mutex_unlock( &p_sys->lock );
             break;
 
         case DEMUX_GET_LENGTH:
@@ -825,7 +989,12 @@ static int Control( demux_t *p_demux, int query, va_list args )
         case DEMUX_SET_TIME:
             p_sys->i_pts = va_arg( args, vlc_tick_t );
             msg_Warn( p_demux, "DEMUX_SET_TIME"  );
+            vlc_mutex_lock( &p_sys->lock );
             p_sys->frame_no = p_sys->i_pts * p_sys->frame_rate_num / ( CLOCK_FREQ * p_sys->frame_rate_denom );
+            p_sys->i_seek_frame = p_sys->frame_no;
+            p_sys->b_seek = true;
+            vlc_cond_broadcast( &p_sys->wait );
+            vlc_mutex_unlock( &p_sys->lock );
             es_out_SetPCR(p_demux->out, p_sys->i_pts);
             es_out_Control( p_demux->out, ES_OUT_SET_NEXT_DISPLAY_TIME, p_sys->i_pts );
             break;
@@ -874,6 +1043,26 @@ static inline void fillVideoFmt( video_format_t * fmt, unsigned int width, unsig
 void CloseDcpAndMxf( demux_t *p_demux )
 {
     demux_sys_t *p_sys = (demux_sys_t *)p_demux->p_sys;
+
+    /* stop the fetch thread before tearing the readers down */
+    if( p_sys->b_thread )
+    {
+        vlc_mutex_lock( &p_sys->lock );
+        p_sys->b_quit = true;
+        vlc_cond_broadcast( &p_sys->wait );
+        vlc_mutex_unlock( &p_sys->lock );
+        vlc_join( p_sys->fetch_thread, NULL );
+
+        for( unsigned i = 0; i < p_sys->i_queue; i++ )
+        {
+            if( p_sys->queue[i].p_video )
+                block_Release( p_sys->queue[i].p_video );
+            if( p_sys->queue[i].p_audio )
+                block_Release( p_sys->queue[i].p_audio );
+        }
+        p_sys->i_queue = 0;
+    }
+
     /* close the files */
     switch( p_sys->PictureEssType )
     {
@@ -28,6 +28,7 @@
 #include <vlc_access.h>
 #include <vlc_plugin.h>
 #include <vlc_dialog.h>
+#include <vlc_queue.h>
 #ifdef HAVE_SEARCH_H
 #include <search.h>
 #endif
@@ -425,11 +426,58 @@ vlc_module_begin ()
 #endif
 vlc_module_end ()
 
-typedef struct
+/*** Shared tuner ***
+ *
+ * A transponder carries many services, but there is only one physical tuner
+ * per adapter. Rather than failing when several inputs want the same adapter,
+ * the device is opened once and shared: the first open tunes it and starts a
+ * reader thread, further opens for the same multiplex attach to it. The
+ * thread demultiplexes the transport stream per PID to each attached reader,
+ * and the hardware PID filter holds the reference-counted union of all
+ * readers' selections.
+ */
+
+#define DTV_BUFSIZE (20 * 188)
+
+typedef struct dtv_tuner dtv_tuner_t;
+
+typedef struct dtv_reader
+{
+    dtv_tuner_t  *tuner;
+    vlc_queue_t   queue; /**< TS blocks demultiplexed for this reader */
+    bool          woken;
+    bool          pids[0x2000]; /**< PIDs selected by this reader */
+    struct dtv_reader *next;
+} dtv_reader_t;
+
+struct dtv_tuner
 {
+    struct vlc_object_t obj;
+
     dvb_device_t *dev;
+    uint64_t      freq; /**< Currently tuned frequency */
+    unsigned      adapter;
+    unsigned      device;
+    bool          budget; /**< Device delivers the whole transport stream */
+
+    unsigned      refs; /**< Attached accesses, under dtv_tuners_lock */
+    dtv_tuner_t  *next; /**< Next in the global tuner list */
+
+    vlc_mutex_t   lock; /**< Protects the device, PID map and reader list */
+    bool          dead; /**< Device reached end of stream */
+    bool          exiting;
+    uint16_t      pid_refs[0x2000]; /**< Hardware PID filter use counts */
+    dtv_reader_t *readers;
+    vlc_thread_t  thread;
+};
+
+static vlc_mutex_t dtv_tuners_lock = VLC_STATIC_MUTEX;
+static dtv_tuner_t *dtv_tuners = NULL;
+
+typedef struct
+{
+    dtv_reader_t *reader;
     uint8_t signal_poll;
-    tuner_setup_t pf_setup;
 } access_sys_t;
 
 static block_t *Read (stream_t *, bool *);
@@ -441,35 +489,179 @@ static uint64_t var_InheritFrequency (vlc_object_t *);
 
 tuner_setup_t dtv_get_delivery_tuner_setup( dtv_delivery_t d );
 
-static int Open (vlc_object_t *obj)
+/* Marks a PID wanted by a reader (tuner->lock held) */
+static int TunerAddPID (dtv_tuner_t *tuner, dtv_reader_t *reader,
+                        uint16_t pid)
 {
-    stream_t *access = (stream_t *)obj;
-    access_sys_t *sys = malloc (sizeof (*sys));
-    if (unlikely(sys == NULL))
-        return VLC_ENOMEM;
+    if (reader->pids[pid])
+        return 0;
+    if (tuner->pid_refs[pid]++ == 0 && dvb_add_pid (tuner->dev, pid))
+    {
+        tuner->pid_refs[pid] = 0;
+        return -1;
+    }
+    reader->pids[pid] = true;
+    return 0;
+}
 
-    var_LocationParse (obj, access->psz_location, "dvb-");
+/* Unmarks a PID wanted by a reader (tuner->lock held) */
+static void TunerRemovePID (dtv_tuner_t *tuner, dtv_reader_t *reader,
+                            uint16_t pid)
+{
+    if (!reader->pids[pid])
+        return;
+    reader->pids[pid] = false;
+    if (--tuner->pid_refs[pid] == 0)
+        dvb_remove_pid (tuner->dev, pid);
+}
 
-    dvb_device_t *dev = dvb_open (obj);
-    if (dev == NULL)
+/**
+ * Copies the TS packets matching a PID set into a new block.
+ * @return a block, or NULL if no packet matched (or on allocation error)
+ */
+static block_t *ExtractPIDs (const block_t *block, const bool pids[0x2000])
+{
+    block_t *out = block_Alloc (block->i_buffer);
+    if (unlikely(out == NULL))
+        return NULL;
+
+    const uint8_t *p = block->p_buffer;
+    size_t left = block->i_buffer, len = 0;
+
+    while (left > 0)
     {
-        free (sys);
-        return VLC_EGENERIC;
+        size_t size = (left < 188) ? left : 188;
+
+        /* Packets out of sync go to every reader; the demux resynchronizes */
+        if (size < 188 || p[0] != 0x47
+         || pids[((p[1] & 0x1f) << 8) | p[2]])
+        {
+            memcpy (out->p_buffer + len, p, size);
+            len += size;
+        }
+        p += size;
+        left -= size;
     }
 
-    sys->dev = dev;
-    sys->signal_poll = 0;
-    sys->pf_setup = NULL;
-    access->p_sys = sys;
+    if (len == 0)
+    {
+        block_Release (out);
+        return NULL;
+    }
+    out->i_buffer = len;
+    return out;
+}
+
+/** Reads from the device and fans the transport stream out to the readers */
+static void *TunerThread (void *data)
+{
+    dtv_tuner_t *tuner = data;
+    block_t *block = NULL;
+
+    vlc_mutex_lock (&tuner->lock);
+    while (!tuner->exiting)
+    {
+        if (block == NULL)
+        {
+            block = block_Alloc (DTV_BUFSIZE);
+            if (unlikely(block == NULL))
+                break;
+        }
+
+        /* The lock is held while reading to serialize device access with
+         * control requests; the timeout bounds how long those may wait. */
+        ssize_t val = dvb_read (tuner->dev, block->p_buffer, DTV_BUFSIZE,
+                                100 /* ms */);
+        if (val == 0)
+            break;
+        if (val < 0)
+            continue;
+        block->i_buffer = val;
+
+        dtv_reader_t *reader = tuner->readers;
+        if (reader == NULL)
+            continue; /* keep the block for the next read */
+
+        if (reader->next == NULL)
+        {   /* Single reader: the PID filter already matches its selection */
+            vlc_queue_Enqueue (&reader->queue, block);
+            block = NULL;
+            continue;
+        }
+
+        for (; reader != NULL; reader = reader->next)
+        {
+            block_t *out = tuner->budget ? block_Duplicate (block)
+                                         : ExtractPIDs (block, reader->pids);
+            if (out != NULL)
+                vlc_queue_Enqueue (&reader->queue, out);
+        }
+        block_Release (block);
+        block = NULL;
+    }
+
+    tuner->dead = true;
+    for (dtv_reader_t *reader = tuner->readers; reader != NULL;
+         reader = reader->next)
+        vlc_queue_Kill (&reader->queue, &reader->woken);
+    vlc_mutex_unlock (&tuner->lock);
+
+    if (block != NULL)
+        block_Release (block);
+    return NULL;
+}
+
+/** Opens, tunes and starts a tuner (dtv_tuners_lock held) */
+static dtv_tuner_t *TunerCreate (stream_t *access, uint64_t freq,
+                                 unsigned adapter, unsigned device)
+{
+    vlc_object_t *obj = VLC_OBJECT(access);
+    dtv_tuner_t *tuner = vlc_custom_create (vlc_object_instance (obj),
+                                            sizeof (*tuner), "dtv tuner");
+    if (unlikely(tuner == NULL))
+        return NULL;
+
+    /* The tuner may outlive the access creating it, so it carries its own
+     * object, with the device selection replicated from the location. */
+    var_LocationParse (VLC_OBJECT(tuner), access->psz_location, "dvb-");
+    var_Create (tuner, "dvb-adapter", VLC_VAR_INTEGER);
+    var_SetInteger (tuner, "dvb-adapter", adapter);
+    var_Create (tuner, "dvb-device", VLC_VAR_INTEGER);
+    var_SetInteger (tuner, "dvb-device", device);
+#ifdef HAVE_LINUX_DVB
+    tuner->budget = var_InheritBool (obj, "dvb-budget-mode");
+    var_Create (tuner, "dvb-budget-mode", VLC_VAR_BOOL);
+    var_SetBool (tuner, "dvb-budget-mode", tuner->budget);
+#else
+    tuner->budget = true; /* BDA always delivers the whole stream */
+#endif
+
+    tuner->dev = dvb_open (VLC_OBJECT(tuner));
+    if (tuner->dev == NULL)
+    {
+        vlc_object_delete (tuner);
+        return NULL;
+    }
+
+    tuner->freq = freq;
+    tuner->adapter = adapter;
+    tuner->device = device;
+    tuner->refs = 1;
+    tuner->dead = false;
+    tuner->exiting = false;
+    tuner->readers = NULL;
+    memset (tuner->pid_refs, 0, sizeof (tuner->pid_refs));
+    vlc_mutex_init (&tuner->lock);
 
-    uint64_t freq = var_InheritFrequency (obj);
     if (freq != 0)
     {
-        dtv_delivery_t d = GuessSystem (access->psz_name, dev);
-        if(d != DTV_DELIVERY_NONE)
-            sys->pf_setup = dtv_get_delivery_tuner_setup(d);
+        dtv_delivery_t d = GuessSystem (access->psz_name, tuner->dev);
+        tuner_setup_t pf_setup = NULL;
+        if (d != DTV_DELIVERY_NONE)
+            pf_setup = dtv_get_delivery_tuner_setup (d);
 
-        if (sys->pf_setup == NULL || Tune (obj, dev, sys->pf_setup, freq))
+        /* Tuning parameters are inherited through the access object */
+        if (pf_setup == NULL || Tune (obj, tuner->dev, pf_setup, freq))
         {
             msg_Err (obj, "tuning to %"PRIu64" Hz failed", freq);
             vlc_dialog_display_error (obj, N_("Digital broadcasting"),
@@ -479,16 +671,146 @@ static int Open (vlc_object_t *obj)
             goto error;
         }
     }
-    dvb_add_pid (dev, 0);
+
+    if (vlc_clone (&tuner->thread, TunerThread, tuner,
+                   VLC_THREAD_PRIORITY_INPUT))
+        goto error;
+    return tuner;
+
+error:
+    dvb_close (tuner->dev);
+    vlc_object_delete (tuner);
+    return NULL;
+}
+
+/** Detaches a reader, stopping the tuner when it was the last one */
+static void ReaderDetach (dtv_reader_t *reader)
+{
+    dtv_tuner_t *tuner = reader->tuner;
+    bool last;
+
+    vlc_mutex_lock (&dtv_tuners_lock);
+    vlc_mutex_lock (&tuner->lock);
+    for (uint_fast16_t pid = 0; pid < 0x2000; pid++)
+        TunerRemovePID (tuner, reader, pid);
+
+    dtv_reader_t **pp = &tuner->readers;
+    while (*pp != reader)
+        pp = &(*pp)->next;
+    *pp = reader->next;
+
+    last = --tuner->refs == 0;
+    if (last)
+    {
+        tuner->exiting = true;
+
+        dtv_tuner_t **tp = &dtv_tuners;
+        while (*tp != tuner)
+            tp = &(*tp)->next;
+        *tp = tuner->next;
+    }
+    vlc_mutex_unlock (&tuner->lock);
+    vlc_mutex_unlock (&dtv_tuners_lock);
+
+    if (last)
+    {
+        vlc_join (tuner->thread, NULL);
+        dvb_close (tuner->dev);
+        vlc_object_delete (tuner);
+    }
+    block_ChainRelease (vlc_queue_DequeueAll (&reader->queue));
+    free (reader);
+}
+
+static int Open (vlc_object_t *obj)
+{
+    stream_t *access = (stream_t *)obj;
+    access_sys_t *sys = malloc (sizeof (*sys));
+    if (unlikely(sys == NULL))
+        return VLC_ENOMEM;
+
+    var_LocationParse (obj, access->psz_location, "dvb-");
+
+    uint64_t freq = var_InheritFrequency (obj);
+    unsigned adapter = var_InheritInteger (obj, "dvb-adapter");
+#ifdef HAVE_LINUX_DVB
+    unsigned device = var_InheritInteger (obj, "dvb-device");
+#else
+    unsigned device = 0;
+#endif
+
+    dtv_reader_t *reader = malloc (sizeof (*reader));
+    if (unlikely(reader == NULL))
+    {
+        free (sys);
+        return VLC_ENOMEM;
+    }
+    reader->woken = false;
+    reader->next = NULL;
+    memset (reader->pids, 0, sizeof (reader->pids));
+    vlc_queue_Init (&reader->queue, offsetof (block_t, p_next));
+
+    vlc_mutex_lock (&dtv_tuners_lock);
+    dtv_tuner_t *tuner;
+    for (tuner = dtv_tuners; tuner != NULL; tuner = tuner->next)
+        if (tuner->adapter == adapter && tuner->device == device)
+            break;
+
+    if (tuner != NULL)
+    {   /* Attach to the already running tuner (same multiplex only) */
+        bool ok;
+
+        vlc_mutex_lock (&tuner->lock);
+        ok = !tuner->dead && freq != 0 && tuner->freq == freq;
+        if (ok)
+        {
+            tuner->refs++;
+            reader->tuner = tuner;
+            reader->next = tuner->readers;
+            tuner->readers = reader;
+            TunerAddPID (tuner, reader, 0); /* The PAT is always wanted */
+        }
+        vlc_mutex_unlock (&tuner->lock);
+        vlc_mutex_unlock (&dtv_tuners_lock);
+
+        if (!ok)
+        {
+            msg_Err (obj, "tuner already in use on another multiplex");
+            free (reader);
+            free (sys);
+            return VLC_EGENERIC;
+        }
+        msg_Dbg (obj, "sharing tuner on adapter %u", adapter);
+    }
+    else
+    {
+        tuner = TunerCreate (access, freq, adapter, device);
+        if (tuner == NULL)
+        {
+            vlc_mutex_unlock (&dtv_tuners_lock);
+            free (reader);
+            free (sys);
+            return VLC_EGENERIC;
+        }
+
+        reader->tuner = tuner;
+        vlc_mutex_lock (&tuner->lock);
+        tuner->readers = reader;
+        TunerAddPID (tuner, reader, 0);
+        vlc_mutex_unlock (&tuner->lock);
+
+        tuner->next = dtv_tuners;
+        dtv_tuners = tuner;
+        vlc_mutex_unlock (&dtv_tuners_lock);
+    }
+
+    sys->reader = reader;
+    sys->signal_poll = 0;
+    access->p_sys = sys;
 
     access->pf_block = Read;
     access->pf_control = Control;
     return VLC_SUCCESS;
-
-error:
-    Close (obj);
-    access->p_sys = NULL;
-    return VLC_EGENERIC;
 }
 
 static void Close (vlc_object_t *obj)
@@ -496,29 +818,19 @@ static void Close (vlc_object_t *obj)
     stream_t *access = (stream_t *)obj;
     access_sys_t *sys = access->p_sys;
 
-    dvb_close (sys->dev);
+    ReaderDetach (sys->reader);
     free (sys);
 }
 
 static block_t *Read (stream_t *access, bool *restrict eof)
 {
-#define BUFSIZE (20*188)
-    block_t *block = block_Alloc (BUFSIZE);
-    if (unlikely(block == NULL))
-        return NULL;
-
     access_sys_t *sys = access->p_sys;
-    ssize_t val = dvb_read (sys->dev, block->p_buffer, BUFSIZE, -1);
-
-    if (val <= 0)
-    {
-        if (val == 0)
-            *eof = true;
-        block_Release (block);
-        return NULL;
-    }
+    dtv_reader_t *reader = sys->reader;
+    block_t *block = vlc_queue_DequeueKillable (&reader->queue,
+                                                &reader->woken);
 
-    block->i_buffer = val;
+    if (block == NULL)
+        *eof = true;
 
     return block;
 }
@@ -526,7 +838,8 @@ static block_t *Read (stream_t *access, bool *restrict eof)
 static int Control (stream_t *access, int query, va_list args)
 {
     access_sys_t *sys = access->p_sys;
-    dvb_device_t *dev = sys->dev;
+    dtv_reader_t *reader = sys->reader;
+    dtv_tuner_t *tuner = reader->tuner;
 
     switch (query)
     {
@@ -554,8 +867,10 @@ static int Control (stream_t *access, int query, va_list args)
             if ((sys->signal_poll++))
                 return VLC_EGENERIC;
 
-            *va_arg (args, double *) = dvb_get_snr (dev);
-            *va_arg (args, double *) = dvb_get_signal_strength (dev);
+            vlc_mutex_lock (&tuner->lock);
+            *va_arg (args, double *) = dvb_get_snr (tuner->dev);
+            *va_arg (args, double *) = dvb_get_signal_strength (tuner->dev);
+            vlc_mutex_unlock (&tuner->lock);
             return VLC_SUCCESS;
 
         case STREAM_SET_PRIVATE_ID_STATE:
@@ -565,21 +880,30 @@ static int Control (stream_t *access, int query, va_list args)
 
             if (unlikely(pid > 0x1FFF))
                 return VLC_EGENERIC;
+            vlc_mutex_lock (&tuner->lock);
             if (add)
             {
-                if (dvb_add_pid (dev, pid))
+                if (TunerAddPID (tuner, reader, pid))
+                {
+                    vlc_mutex_unlock (&tuner->lock);
                     return VLC_EGENERIC;
+                }
             }
             else
-                dvb_remove_pid (dev, pid);
+                TunerRemovePID (tuner, reader, pid);
+            vlc_mutex_unlock (&tuner->lock);
             break;
         }
 
         case STREAM_SET_PRIVATE_ID_CA:
         {
             en50221_capmt_info_t *pmt = va_arg(args, void *);
+            bool ok;
 
-            if( !dvb_set_ca_pmt (dev, pmt) )
+            vlc_mutex_lock (&tuner->lock);
+            ok = dvb_set_ca_pmt (tuner->dev, pmt);
+            vlc_mutex_unlock (&tuner->lock);
+            if( !ok )
                 return VLC_EGENERIC;
             break;
         }
@@ -589,7 +913,8 @@ static int Control (stream_t *access, int query, va_list args)
             unsigned pid = va_arg (args, int);
             bool *on = va_arg (args, bool *);
 
-            *on = likely(pid <= 0x1FFF) ? dvb_get_pid_state(dev, pid) : false;
+            *on = likely(pid <= 0x1FFF)
+                ? (tuner->budget || reader->pids[pid]) : false;
             return VLC_SUCCESS;
         }
 
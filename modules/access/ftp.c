@@ -154,6 +154,55 @@ struct access_sys_t
 #define GET_OUT_SYS( p_this ) \
     ((access_sys_t *)(((sout_access_out_t *)(p_this))->p_sys))
 
+/* Pool of idle control connections kept alive across items, so that
+ * batch retrieval (e.g. the preparser walking a directory) does not pay
+ * for a TCP connect, feature check and login on every file. Only
+ * plaintext connections are pooled: a TLS session is bound to the
+ * credentials object of the access that created it. */
+#define FTP_POOL_SIZE 4
+#define FTP_POOL_TTL  VLC_TICK_FROM_SEC(30)
+
+struct ftp_pooled_t
+{
+    char            *psz_host;
+    unsigned         i_port;
+    char            *psz_user;
+    vlc_tls_t       *cmd;
+    ftp_features_t   features;
+    char             sz_epsv_ip[NI_MAXNUMERICHOST];
+    vlc_tick_t       deadline;
+};
+
+static vlc_mutex_t pool_lock = VLC_STATIC_MUTEX;
+static struct ftp_pooled_t pool[FTP_POOL_SIZE];
+
+/* Expires stale pool entries. Called with pool_lock held. */
+static void ftp_PoolExpire( vlc_tick_t now )
+{
+    for( size_t i = 0; i < FTP_POOL_SIZE; i++ )
+    {
+        struct ftp_pooled_t *p = &pool[i];
+
+        if( p->cmd != NULL && p->deadline < now )
+        {
+            vlc_tls_Close( p->cmd );
+            p->cmd = NULL;
+            FREENULL( p->psz_host );
+            FREENULL( p->psz_user );
+        }
+    }
+}
+
+/* The pool key uses the user name as it will be resolved by Login() */
+static char *ftp_PoolUser( vlc_object_t *obj, const vlc_url_t *url )
+{
+    if( url->psz_username != NULL )
+        return strdup( url->psz_username );
+
+    char *psz_user = var_InheritString( obj, "ftp-user" );
+    return ( psz_user != NULL ) ? psz_user : strdup( "anonymous" );
+}
+
 VLC_FORMAT(3, 4)
 static int ftp_SendCommand( vlc_object_t *obj, access_sys_t *sys,
                             const char *fmt, ... )
@@ -629,6 +678,114 @@ error:
     return -1;
 }
 
+/**
+ * Takes a matching idle control connection from the pool, if any, and
+ * checks that the server has not dropped it in the meantime.
+ *
+ * \return 0 on success, -1 if the caller must connect from scratch
+ */
+static int ftp_GetConnection( vlc_object_t *p_access, access_sys_t *p_sys )
+{
+    vlc_tls_t *cmd = NULL;
+
+    vlc_mutex_lock( &pool_lock );
+    ftp_PoolExpire( vlc_tick_now() );
+
+    char *psz_user = ftp_PoolUser( p_access, &p_sys->url );
+    if( psz_user != NULL )
+        for( size_t i = 0; i < FTP_POOL_SIZE; i++ )
+        {
+            struct ftp_pooled_t *p = &pool[i];
+
+            if( p->cmd != NULL
+             && p->i_port == (unsigned)p_sys->url.i_port
+             && !strcmp( p->psz_host, p_sys->url.psz_host )
+             && !strcmp( p->psz_user, psz_user ) )
+            {
+                cmd = p->cmd;
+                p->cmd = NULL;
+                p_sys->features = p->features;
+                memcpy( p_sys->sz_epsv_ip, p->sz_epsv_ip,
+                        sizeof (p_sys->sz_epsv_ip) );
+                FREENULL( p->psz_host );
+                FREENULL( p->psz_user );
+                break;
+            }
+        }
+    free( psz_user );
+    vlc_mutex_unlock( &pool_lock );
+
+    if( cmd == NULL )
+        return -1;
+
+    p_sys->cmd = cmd;
+
+    /* The server may have timed the connection out on its side */
+    if( ftp_SendCommand( p_access, p_sys, "NOOP" ) < 0
+     || ftp_RecvCommand( p_access, p_sys, NULL, NULL ) != 2 )
+    {
+        msg_Dbg( p_access, "pooled connection is stale" );
+        clearCmd( p_sys );
+        return -1;
+    }
+
+    if( p_sys->url.psz_path &&
+        (p_sys->features.b_unicode ? IsUTF8 : IsASCII)(p_sys->url.psz_path) == NULL )
+    {
+        msg_Err( p_access, "unsupported path: \"%s\"", p_sys->url.psz_path );
+        clearCmd( p_sys );
+        return -1;
+    }
+
+    msg_Dbg( p_access, "reusing control connection to %s:%d",
+             p_sys->url.psz_host, p_sys->url.i_port );
+    return 0;
+}
+
+/**
+ * Hands a logged-in control connection over to the pool instead of
+ * closing it. The connection must be idle (no transfer in progress).
+ */
+static void ftp_PutConnection( vlc_object_t *p_access, access_sys_t *p_sys )
+{
+    char *psz_user = ftp_PoolUser( p_access, &p_sys->url );
+    char *psz_host = ( p_sys->url.psz_host != NULL )
+                   ? strdup( p_sys->url.psz_host ) : NULL;
+    if( psz_user == NULL || psz_host == NULL )
+    {
+        free( psz_user );
+        free( psz_host );
+        return;
+    }
+
+    vlc_mutex_lock( &pool_lock );
+    vlc_tick_t now = vlc_tick_now();
+    ftp_PoolExpire( now );
+
+    for( size_t i = 0; i < FTP_POOL_SIZE; i++ )
+    {
+        struct ftp_pooled_t *p = &pool[i];
+
+        if( p->cmd != NULL )
+            continue;
+
+        p->psz_host = psz_host;
+        p->i_port = p_sys->url.i_port;
+        p->psz_user = psz_user;
+        p->cmd = p_sys->cmd;
+        p->features = p_sys->features;
+        memcpy( p->sz_epsv_ip, p_sys->sz_epsv_ip, sizeof (p->sz_epsv_ip) );
+        p->deadline = now + FTP_POOL_TTL;
+        p_sys->cmd = NULL; /* now owned by the pool */
+        vlc_mutex_unlock( &pool_lock );
+        return;
+    }
+    vlc_mutex_unlock( &pool_lock );
+
+    /* Pool full: let the caller close the connection normally */
+    free( psz_user );
+    free( psz_host );
+}
 
 static int parseURL( vlc_url_t *url, const char *path, enum tls_mode_e mode )
 {
@@ -700,7 +857,8 @@ static int InOpen( vlc_object_t *p_this )
     if( parseURL( &p_sys->url, p_access->psz_url, p_sys->tlsmode ) )
         goto exit_error;
 
-    if( Connect( p_this, p_sys, p_access->psz_url ) )
+    if( ( p_sys->tlsmode != NONE || ftp_GetConnection( p_this, p_sys ) )
+     && Connect( p_this, p_sys, p_access->psz_url ) )
         goto exit_error;
 
     do {
@@ -821,15 +979,23 @@ exit_error:
 static void Close( vlc_object_t *p_access, access_sys_t *p_sys )
 {
     msg_Dbg( p_access, "stopping stream" );
-    ftp_StopStream( p_access, p_sys );
+    int ret = ftp_StopStream( p_access, p_sys );
 
-    if( ftp_SendCommand( p_access, p_sys, "QUIT" ) < 0 )
-    {
-        msg_Warn( p_access, "cannot quit" );
-    }
-    else
+    /* Keep clean plaintext connections alive for the next item */
+    if( ret == VLC_SUCCESS && !p_sys->out && p_sys->tlsmode == NONE
+     && p_sys->cmd != NULL )
+        ftp_PutConnection( p_access, p_sys );
+
+    if( p_sys->cmd != NULL )
     {
-        ftp_RecvCommand( p_access, p_sys, NULL, NULL );
+        if( ftp_SendCommand( p_access, p_sys, "QUIT" ) < 0 )
+        {
+            msg_Warn( p_access, "cannot quit" );
+        }
+        else
+        {
+            ftp_RecvCommand( p_access, p_sys, NULL, NULL );
+        }
     }
 
     clearCmd( p_sys );
@@ -1064,8 +1230,17 @@ static int ftp_StartStream( vlc_object_t *p_access, access_sys_t *p_sys,
 
     assert( p_sys->data == NULL );
 
-    if( ( ftp_SendCommand( p_access, p_sys, *psz_ip ? "EPSV" : "PASV" ) < 0 )
-     || ( ftp_RecvCommand( p_access, p_sys, &i_answer, &psz_arg ) != 2 ) )
+    /* Pipeline the transfer setup: none of these commands depends on the
+     * reply to an earlier one, so send them all before collecting the
+     * replies (which arrive in order). This keeps a seek down to a single
+     * control round trip before the data connection is opened. */
+    if( ftp_SendCommand( p_access, p_sys, *psz_ip ? "EPSV" : "PASV" ) < 0
+     || ftp_SendCommand( p_access, p_sys, "TYPE I" ) < 0
+     || ( i_start > 0
+       && ftp_SendCommand( p_access, p_sys, "REST %"PRIu64, i_start ) < 0 ) )
+        return VLC_EGENERIC;
+
+    if( ftp_RecvCommand( p_access, p_sys, &i_answer, &psz_arg ) != 2 )
     {
         msg_Err( p_access, "cannot set passive mode" );
         return VLC_EGENERIC;
@@ -1109,8 +1284,7 @@ static int ftp_StartStream( vlc_object_t *p_access, access_sys_t *p_sys,
 
     msg_Dbg( p_access, "ip:%s port:%d", psz_ip, i_port );
 
-    if( ftp_SendCommand( p_access, p_sys, "TYPE I" ) < 0 ||
-        ftp_RecvCommand( p_access, p_sys, &i_answer, NULL ) != 2 )
+    if( ftp_RecvCommand( p_access, p_sys, &i_answer, NULL ) != 2 )
     {
         msg_Err( p_access, "cannot set binary transfer mode" );
         return VLC_EGENERIC;
@@ -1118,8 +1292,7 @@ static int ftp_StartStream( vlc_object_t *p_access, access_sys_t *p_sys,
 
     if( i_start > 0 )
     {
-        if( ftp_SendCommand( p_access, p_sys, "REST %"PRIu64, i_start ) < 0 ||
-            ftp_RecvCommand( p_access, p_sys, &i_answer, NULL ) > 3 )
+        if( ftp_RecvCommand( p_access, p_sys, &i_answer, NULL ) > 3 )
         {
             msg_Err( p_access, "cannot set restart offset" );
             return VLC_EGENERIC;
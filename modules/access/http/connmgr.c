@@ -25,6 +25,7 @@
 #include <assert.h>
 #include <vlc_common.h>
 #include <vlc_network.h>
+#include <vlc_strings.h>
 #include <vlc_tls.h>
 #include <vlc_url.h>
 #include "transport.h"
@@ -96,31 +97,94 @@ static char *vlc_http_proxy_find(const char *hostname, unsigned port,
 }
 
 
+struct vlc_http_mgr_conn
+{
+    struct vlc_http_mgr_conn *next;
+    struct vlc_http_conn *conn;
+    char *host;
+    unsigned port;
+};
+
+/* Maximum number of connections kept alive per manager. Redirects across
+ * origins (e.g. CDN edges) typically bounce between very few hosts. */
+#define VLC_HTTP_MGR_MAX_CONNS 4
+
 struct vlc_http_mgr
 {
     struct vlc_logger *logger;
     vlc_object_t *obj;
     vlc_tls_client_t *creds;
     struct vlc_http_cookie_jar_t *jar;
-    struct vlc_http_conn *conn;
+    struct vlc_http_mgr_conn *conns;
 };
 
 static struct vlc_http_conn *vlc_http_mgr_find(struct vlc_http_mgr *mgr,
                                                const char *host, unsigned port)
 {
-    (void) host; (void) port;
-    return mgr->conn;
+    for (struct vlc_http_mgr_conn **pp = &mgr->conns; *pp != NULL;
+         pp = &((*pp)->next))
+    {
+        struct vlc_http_mgr_conn *e = *pp;
+
+        if (e->port == port && !vlc_ascii_strcasecmp(e->host, host))
+        {   /* Most recently used connection first */
+            *pp = e->next;
+            e->next = mgr->conns;
+            mgr->conns = e;
+            return e->conn;
+        }
+    }
+    return NULL;
 }
 
 static void vlc_http_mgr_release(struct vlc_http_mgr *mgr,
                                  struct vlc_http_conn *conn)
 {
-    assert(mgr->conn == conn);
-    mgr->conn = NULL;
+    struct vlc_http_mgr_conn **pp = &mgr->conns;
+
+    while ((*pp)->conn != conn)
+        pp = &((*pp)->next);
+
+    struct vlc_http_mgr_conn *e = *pp;
+
+    *pp = e->next;
+    free(e->host);
+    free(e);
 
     vlc_http_conn_release(conn);
 }
 
+static int vlc_http_mgr_store(struct vlc_http_mgr *mgr,
+                              struct vlc_http_conn *conn,
+                              const char *host, unsigned port)
+{
+    struct vlc_http_mgr_conn *e = malloc(sizeof (*e));
+    if (unlikely(e == NULL))
+        return -1;
+
+    e->host = strdup(host);
+    if (unlikely(e->host == NULL))
+    {
+        free(e);
+        return -1;
+    }
+    e->conn = conn;
+    e->port = port;
+    e->next = mgr->conns;
+    mgr->conns = e;
+
+    /* Evict the least recently used connection past the limit
+     * (at most one after a single insertion) */
+    struct vlc_http_mgr_conn **pp = &mgr->conns;
+
+    for (unsigned n = 0; *pp != NULL && n < VLC_HTTP_MGR_MAX_CONNS; n++)
+        pp = &((*pp)->next);
+
+    if (*pp != NULL)
+        vlc_http_mgr_release(mgr, (*pp)->conn);
+    return 0;
+}
+
 static
 struct vlc_http_msg *vlc_http_mgr_reuse(struct vlc_http_mgr *mgr,
                                         const char *host, unsigned port,
@@ -154,7 +218,7 @@ static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
     vlc_tls_t *tls;
     bool http2 = true;
 
-    if (mgr->creds == NULL && mgr->conn != NULL)
+    if (mgr->creds == NULL && mgr->conns != NULL)
         return NULL; /* switch from HTTP to HTTPS not implemented */
 
     if (mgr->creds == NULL)
@@ -202,7 +266,11 @@ static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
         return NULL;
     }
 
-    mgr->conn = conn;
+    if (unlikely(vlc_http_mgr_store(mgr, conn, host, port)))
+    {
+        vlc_http_conn_release(conn);
+        return NULL;
+    }
 
     return vlc_http_mgr_reuse(mgr, host, port, req);
 }
@@ -211,7 +279,7 @@ static struct vlc_http_msg *vlc_http_request(struct vlc_http_mgr *mgr,
                                              const char *host, unsigned port,
                                              const struct vlc_http_msg *req)
 {
-    if (mgr->creds != NULL && mgr->conn != NULL)
+    if (mgr->creds != NULL && mgr->conns != NULL)
         return NULL; /* switch from HTTPS to HTTP not implemented */
 
     struct vlc_http_msg *resp = vlc_http_mgr_reuse(mgr, host, port, req);
@@ -252,7 +320,12 @@ static struct vlc_http_msg *vlc_http_request(struct vlc_http_mgr *mgr,
         return NULL;
     }
 
-    mgr->conn = conn;
+    if (unlikely(vlc_http_mgr_store(mgr, conn, host, port)))
+    {
+        vlc_http_msg_destroy(resp);
+        vlc_http_conn_release(conn);
+        return NULL;
+    }
     return resp;
 }
 
@@ -282,14 +355,14 @@ struct vlc_http_mgr *vlc_http_mgr_create(vlc_object_t *obj,
     mgr->obj = obj;
     mgr->creds = NULL;
     mgr->jar = jar;
-    mgr->conn = NULL;
+    mgr->conns = NULL;
     return mgr;
 }
 
 void vlc_http_mgr_destroy(struct vlc_http_mgr *mgr)
 {
-    if (mgr->conn != NULL)
-        vlc_http_mgr_release(mgr, mgr->conn);
+    while (mgr->conns != NULL)
+        vlc_http_mgr_release(mgr, mgr->conns->conn);
     if (mgr->creds != NULL)
         vlc_tls_ClientDelete(mgr->creds);
     free(mgr);
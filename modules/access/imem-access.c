@@ -27,6 +27,9 @@
 #include <vlc_common.h>
 #include <vlc_access.h>
 #include <vlc_plugin.h>
+#include <vlc_interrupt.h>
+
+#include "imem.h"
 
 typedef struct
 {
@@ -34,6 +37,8 @@ typedef struct
     ssize_t (*read_cb)(void *, unsigned char *, size_t);
     int (*seek_cb)(void *, uint64_t);
     void (*close_cb)(void *);
+    imem_attach_t attach_cb; /**< push mode when non-NULL */
+    imem_queue_t queue; /**< only used in push mode */
     uint64_t size;
 } access_sys_t;
 
@@ -51,6 +56,32 @@ static ssize_t Read(stream_t *access, void *buf, size_t len)
     return val;
 }
 
+static block_t *Block(stream_t *access, bool *restrict eof)
+{
+    access_sys_t *sys = access->p_sys;
+    imem_buffer_t buf;
+
+    while (!imem_queue_Pop(&sys->queue, &buf)) {
+        if (imem_queue_IsEof(&sys->queue)) {
+            *eof = true;
+            return NULL;
+        }
+        if (vlc_sem_wait_i11e(&sys->queue.filled))
+            return NULL; /* interrupted */
+    }
+
+    if (buf.size == 0) {
+        if (buf.release != NULL)
+            buf.release(buf.opaque, buf.size, buf.buffer);
+        return NULL;
+    }
+
+    block_t *block = imem_block_Wrap(&buf);
+    if (unlikely(block == NULL) && buf.release != NULL)
+        buf.release(buf.opaque, buf.size, buf.buffer);
+    return block;
+}
+
 static int Seek(stream_t *access, uint64_t offset)
 {
     access_sys_t *sys = access->p_sys;
@@ -69,7 +100,8 @@ static int Control(stream_t *access, int query, va_list args)
     switch (query)
     {
         case STREAM_CAN_SEEK:
-            *va_arg(args, bool *) = sys->seek_cb != NULL;
+            *va_arg(args, bool *) = sys->seek_cb != NULL
+                                 && sys->attach_cb == NULL;
             break;
 
         case STREAM_CAN_FASTSEEK:
@@ -78,7 +110,9 @@ static int Control(stream_t *access, int query, va_list args)
 
         case STREAM_CAN_PAUSE:
         case STREAM_CAN_CONTROL_PACE:
-            *va_arg(args, bool *) = sys->seek_cb != NULL;
+            /* push mode is live: the producer sets the pace */
+            *va_arg(args, bool *) = sys->seek_cb != NULL
+                                 && sys->attach_cb == NULL;
             break;
 
         case STREAM_GET_SIZE:
@@ -125,11 +159,12 @@ static int Open(vlc_object_t *object)
     sys->read_cb = var_InheritAddress(access, "imem-read");
     sys->seek_cb = var_InheritAddress(access, "imem-seek");
     sys->close_cb = var_InheritAddress(access, "imem-close");
+    sys->attach_cb = var_InheritAddress(access, "imem-attach");
     sys->size = UINT64_MAX;
 
     if (open_cb == NULL)
         open_cb = open_cb_default;
-    if (sys->read_cb == NULL)
+    if (sys->read_cb == NULL && sys->attach_cb == NULL)
         return VLC_EGENERIC;
 
     if (open_cb(opaque, &sys->opaque, &sys->size)) {
@@ -137,9 +172,21 @@ static int Open(vlc_object_t *object)
         return VLC_EGENERIC;
     }
 
-    access->pf_read = Read;
-    access->pf_block = NULL;
-    access->pf_seek = (sys->seek_cb != NULL) ? Seek : NULL;
+    if (sys->attach_cb != NULL) {
+        /* Push mode: the application enqueues borrowed buffers from its
+         * own thread; the handoff to the input thread is lock-free. */
+        imem_queue_Init(&sys->queue);
+        sys->attach_cb(sys->opaque, NULL, &sys->queue,
+                       imem_queue_Push, imem_queue_Eof);
+
+        access->pf_read = NULL;
+        access->pf_block = Block;
+        access->pf_seek = NULL;
+    } else {
+        access->pf_read = Read;
+        access->pf_block = NULL;
+        access->pf_seek = (sys->seek_cb != NULL) ? Seek : NULL;
+    }
     access->pf_control = Control;
 
     access->p_sys = sys;
@@ -151,6 +198,12 @@ static void Close(vlc_object_t *object)
     stream_t *access = (stream_t *)object;
     access_sys_t *sys = access->p_sys;
 
+    if (sys->attach_cb != NULL) {
+        /* revoke the queue, then give the leftover buffers back */
+        sys->attach_cb(sys->opaque, NULL, NULL, NULL, NULL);
+        imem_queue_Flush(&sys->queue);
+    }
+
     if (sys->close_cb != NULL)
         sys->close_cb(sys->opaque);
 }
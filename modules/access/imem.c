@@ -35,6 +35,9 @@
 #include <vlc_access.h>
 #include <vlc_demux.h>
 #include <vlc_charset.h>
+#include <vlc_interrupt.h>
+
+#include "imem.h"
 
 /*****************************************************************************
  * Module descriptior
@@ -109,6 +112,10 @@ static const char *cat_texts[] = {
 #define RELEASE_LONGTEXT N_(\
     "Address of the release callback function")
 
+#define ATTACH_TEXT N_("Attach function")
+#define ATTACH_LONGTEXT N_(\
+    "Address of the push queue attach callback function")
+
 #define SIZE_TEXT N_("Size")
 #define SIZE_LONGTEXT N_(\
     "Size of stream in bytes")
@@ -123,6 +130,8 @@ vlc_module_begin()
         change_volatile()
     add_string ("imem-release", "0", RELEASE_TEXT, RELEASE_LONGTEXT, true)
         change_volatile()
+    add_string ("imem-attach", "0", ATTACH_TEXT, ATTACH_LONGTEXT, true)
+        change_volatile()
     add_string ("imem-cookie", NULL, COOKIE_TEXT, COOKIE_LONGTEXT, true)
         change_volatile()
         change_safe()
@@ -200,9 +209,11 @@ typedef void (*imem_release_t)(void *data, const char *cookie, size_t, void *);
 
 /* */
 static block_t *Block(stream_t *, bool *);
+static block_t *BlockPush(stream_t *, bool *);
 static int ControlAccess(stream_t *, int, va_list);
 
 static int Demux(demux_t *);
+static int DemuxPush(demux_t *);
 static int ControlDemux(demux_t *, int, va_list);
 
 /* */
@@ -210,10 +221,13 @@ typedef struct {
     struct {
         imem_get_t      get;
         imem_release_t  release;
+        imem_attach_t   attach; /**< push mode when non-NULL */
         void           *data;
         char           *cookie;
     } source;
 
+    imem_queue_t queue; /**< only used in push mode */
+
     es_out_id_t  *es;
 
     vlc_tick_t   dts;
@@ -228,6 +242,12 @@ static void ParseMRL(vlc_object_t *, const char *);
  */
 static void CloseCommon(imem_sys_t *sys)
 {
+    if (sys->source.attach != NULL) {
+        /* revoke the queue, then give the leftover buffers back */
+        sys->source.attach(sys->source.data, sys->source.cookie,
+                           NULL, NULL, NULL);
+        imem_queue_Flush(&sys->queue);
+    }
     free(sys->source.cookie);
 }
 
@@ -254,7 +274,12 @@ static int OpenCommon(vlc_object_t *object, imem_sys_t **sys_ptr, const char *ps
         sys->source.release = (imem_release_t)(intptr_t)strtoll(tmp, NULL, 0);
     free(tmp);
 
-    if (!sys->source.get || !sys->source.release) {
+    tmp = var_InheritString(object, "imem-attach");
+    if (tmp)
+        sys->source.attach = (imem_attach_t)(intptr_t)strtoll(tmp, NULL, 0);
+    free(tmp);
+
+    if (!sys->source.attach && (!sys->source.get || !sys->source.release)) {
         msg_Err(object, "Invalid get/release function pointers");
         return VLC_EGENERIC;
     }
@@ -271,15 +296,21 @@ static int OpenCommon(vlc_object_t *object, imem_sys_t **sys_ptr, const char *ps
 
     sys->source.cookie = var_InheritString(object, "imem-cookie");
 
-    msg_Dbg(object, "Using get(%p), release(%p), data(%p), cookie(%s)",
+    msg_Dbg(object, "Using get(%p), release(%p), attach(%p), data(%p), cookie(%s)",
             (void *)sys->source.get, (void *)sys->source.release,
-            sys->source.data,
+            (void *)sys->source.attach, sys->source.data,
             sys->source.cookie ? sys->source.cookie : "(null)");
 
     /* */
     sys->dts       = 0;
     sys->deadline  = VLC_TICK_INVALID;
 
+    if (sys->source.attach != NULL) {
+        imem_queue_Init(&sys->queue);
+        sys->source.attach(sys->source.data, sys->source.cookie,
+                           &sys->queue, imem_queue_Push, imem_queue_Eof);
+    }
+
     *sys_ptr = sys;
     return VLC_SUCCESS;
 }
@@ -303,7 +334,7 @@ static int OpenAccess(vlc_object_t *object)
     /* */
     access->pf_control = ControlAccess;
     access->pf_read    = NULL;
-    access->pf_block   = Block;
+    access->pf_block   = sys->source.attach != NULL ? BlockPush : Block;
     access->pf_seek    = NULL;
     access->p_sys      = sys;
 
@@ -387,6 +418,36 @@ static block_t *Block(stream_t *access, bool *restrict eof)
     return block;
 }
 
+/**
+ * It dequeues an application-pushed buffer and wraps it, without copying,
+ * into a block released through the buffer callback.
+ */
+static block_t *BlockPush(stream_t *access, bool *restrict eof)
+{
+    imem_sys_t *sys = (imem_sys_t*)access->p_sys;
+    imem_buffer_t buf;
+
+    while (!imem_queue_Pop(&sys->queue, &buf)) {
+        if (imem_queue_IsEof(&sys->queue)) {
+            *eof = true;
+            return NULL;
+        }
+        if (vlc_sem_wait_i11e(&sys->queue.filled))
+            return NULL; /* interrupted */
+    }
+
+    if (buf.size == 0) {
+        if (buf.release != NULL)
+            buf.release(buf.opaque, buf.size, buf.buffer);
+        return NULL;
+    }
+
+    block_t *block = imem_block_Wrap(&buf);
+    if (unlikely(block == NULL) && buf.release != NULL)
+        buf.release(buf.opaque, buf.size, buf.buffer);
+    return block;
+}
+
 static inline int GetCategory(vlc_object_t *object)
 {
     const int cat = var_InheritInteger(object, "imem-cat");
@@ -492,7 +553,7 @@ static int OpenDemux(vlc_object_t *object)
 
     /* */
     demux->pf_control = ControlDemux;
-    demux->pf_demux   = Demux;
+    demux->pf_demux   = sys->source.attach != NULL ? DemuxPush : Demux;
     demux->p_sys      = sys;
 
     return VLC_SUCCESS;
@@ -607,6 +668,56 @@ static int Demux(demux_t *demux)
     return 1;
 }
 
+/**
+ * It dequeues application-pushed buffers, wraps them without copying and
+ * sends them to es_out; each buffer is released through its own callback
+ * once the block is consumed downstream.
+ */
+static int DemuxPush(demux_t *demux)
+{
+    imem_sys_t *sys = (imem_sys_t*)demux->p_sys;
+
+    if (sys->deadline == VLC_TICK_INVALID)
+        sys->deadline = sys->dts + 1;
+
+    for (;;) {
+        if (sys->deadline <= sys->dts)
+            break;
+
+        imem_buffer_t buf;
+        if (!imem_queue_Pop(&sys->queue, &buf)) {
+            if (imem_queue_IsEof(&sys->queue))
+                return 0;
+            /* wait for the producer, but do not stall the input loop */
+            if (vlc_sem_timedwait(&sys->queue.filled,
+                                  vlc_tick_now() + VLC_TICK_FROM_MS(10)))
+                break;
+            continue;
+        }
+
+        int64_t dts = buf.dts;
+        if (dts < 0)
+            dts = buf.pts;
+
+        if (buf.size > 0) {
+            block_t *block = imem_block_Wrap(&buf);
+            if (block != NULL) {
+                block->i_dts = dts >= 0 ? (1 + dts) : VLC_TICK_INVALID;
+                block->i_pts = buf.pts >= 0 ? (1 + buf.pts) : VLC_TICK_INVALID;
+
+                es_out_SetPCR(demux->out, block->i_dts);
+                es_out_Send(demux->out, sys->es, block);
+            } else if (buf.release != NULL)
+                buf.release(buf.opaque, buf.size, buf.buffer);
+        } else if (buf.release != NULL)
+            buf.release(buf.opaque, buf.size, buf.buffer);
+
+        sys->dts = dts;
+    }
+    sys->deadline = VLC_TICK_INVALID;
+    return 1;
+}
+
 /**
  * Parse the MRL and extract configuration from it.
  *
@@ -0,0 +1,182 @@
+/*****************************************************************************
+ * imem.h : push queue shared by the memory inputs
+ *****************************************************************************
+ * Copyright (C) 2009-2010 Laurent Aimar
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_IMEM_H
+#define VLC_IMEM_H 1
+
+/* Requires <vlc_common.h> and <vlc_block.h> */
+#include <stdatomic.h>
+
+/**
+ * Push mode for the memory inputs.
+ *
+ * Instead of having VLC pull (and copy) data through a get/read callback,
+ * the application may register an attach callback. The input hands it an
+ * \ref imem_queue_t plus push/EOF functions; the application then enqueues
+ * borrowed buffers from its own (single) producer thread. The handoff to
+ * the input thread is a lock-free single-producer/single-consumer ring, and
+ * the buffers are wrapped - not copied - into blocks; each buffer is
+ * returned through its release callback once the block is consumed.
+ */
+
+/** Ring capacity; must be a power of two */
+#define IMEM_RING_SIZE 256
+
+typedef struct imem_buffer
+{
+    void *buffer;
+    size_t size;
+    int64_t dts; /**< negative if unknown */
+    int64_t pts; /**< negative if unknown */
+    void (*release)(void *opaque, size_t size, void *buffer); /**< or NULL */
+    void *opaque;
+} imem_buffer_t;
+
+typedef struct imem_queue
+{
+    imem_buffer_t slots[IMEM_RING_SIZE];
+    atomic_uint tail; /**< producer index */
+    atomic_uint head; /**< consumer index */
+    atomic_bool eof;
+    vlc_sem_t filled; /**< wakes the input thread on empty-to-filled edge */
+} imem_queue_t;
+
+typedef int (*imem_push_t)(imem_queue_t *, void *buffer, size_t size,
+                           int64_t dts, int64_t pts,
+                           void (*release)(void *, size_t, void *),
+                           void *opaque);
+typedef void (*imem_eof_t)(imem_queue_t *);
+
+/**
+ * Application callback registering the push queue.
+ *
+ * Called once at open with a valid queue and function pointers, and once at
+ * close with all of them NULL; the application must not push past that
+ * point. \p cookie is NULL for the imem-access variant.
+ */
+typedef void (*imem_attach_t)(void *data, const char *cookie,
+                              imem_queue_t *queue,
+                              imem_push_t push, imem_eof_t eof);
+
+static inline void imem_queue_Init(imem_queue_t *q)
+{
+    atomic_init(&q->tail, 0);
+    atomic_init(&q->head, 0);
+    atomic_init(&q->eof, false);
+    vlc_sem_init(&q->filled, 0);
+}
+
+/**
+ * Enqueues a borrowed buffer (producer side, wait-free).
+ *
+ * \return 0 on success, -1 if the ring is full (the producer may retry,
+ * coalesce or drop; the buffer is NOT taken over on failure).
+ */
+static inline int imem_queue_Push(imem_queue_t *q, void *buffer, size_t size,
+                                  int64_t dts, int64_t pts,
+                                  void (*release)(void *, size_t, void *),
+                                  void *opaque)
+{
+    unsigned tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+
+    if (tail - atomic_load_explicit(&q->head, memory_order_acquire)
+            >= IMEM_RING_SIZE)
+        return -1;
+
+    imem_buffer_t *s = &q->slots[tail % IMEM_RING_SIZE];
+    s->buffer = buffer;
+    s->size = size;
+    s->dts = dts;
+    s->pts = pts;
+    s->release = release;
+    s->opaque = opaque;
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    vlc_sem_post(&q->filled);
+    return 0;
+}
+
+/** Marks the end of stream (producer side). */
+static inline void imem_queue_Eof(imem_queue_t *q)
+{
+    atomic_store_explicit(&q->eof, true, memory_order_release);
+    vlc_sem_post(&q->filled);
+}
+
+/** Dequeues one buffer (consumer side). \return false if the ring is empty */
+static inline bool imem_queue_Pop(imem_queue_t *q, imem_buffer_t *out)
+{
+    unsigned head = atomic_load_explicit(&q->head, memory_order_relaxed);
+
+    if (atomic_load_explicit(&q->tail, memory_order_acquire) == head)
+        return false;
+
+    *out = q->slots[head % IMEM_RING_SIZE];
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    return true;
+}
+
+static inline bool imem_queue_IsEof(const imem_queue_t *q)
+{
+    return atomic_load_explicit(&q->eof, memory_order_acquire);
+}
+
+/** Releases every queued buffer back to the application (consumer side). */
+static inline void imem_queue_Flush(imem_queue_t *q)
+{
+    imem_buffer_t buf;
+
+    while (imem_queue_Pop(q, &buf))
+        if (buf.release != NULL)
+            buf.release(buf.opaque, buf.size, buf.buffer);
+}
+
+typedef struct
+{
+    block_t block;
+    imem_buffer_t buf;
+} imem_block_t;
+
+static inline void imem_block_Free(block_t *b)
+{
+    imem_block_t *ib = container_of(b, imem_block_t, block);
+
+    if (ib->buf.release != NULL)
+        ib->buf.release(ib->buf.opaque, ib->buf.size, ib->buf.buffer);
+    free(ib);
+}
+
+/**
+ * Wraps a borrowed buffer into a block without copying it.
+ *
+ * \return NULL on allocation failure; the buffer is NOT released then.
+ */
+static inline block_t *imem_block_Wrap(const imem_buffer_t *buf)
+{
+    static const struct vlc_block_callbacks cbs = { imem_block_Free };
+    imem_block_t *ib = malloc(sizeof (*ib));
+    if (unlikely(ib == NULL))
+        return NULL;
+
+    block_Init(&ib->block, &cbs, buf->buffer, buf->size);
+    ib->buf = *buf;
+    return &ib->block;
+}
+
+#endif
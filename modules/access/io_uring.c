@@ -0,0 +1,295 @@
+/*****************************************************************************
+ * io_uring.c: file input using Linux io_uring
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <liburing.h>
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_access.h>
+#include <vlc_block.h>
+#include <vlc_fs.h>
+#include <vlc_interrupt.h>
+
+/** Number of read requests kept in flight (readahead depth). */
+#define URING_DEPTH   8
+/** Size of each read request. */
+#define URING_CHUNK   (256 * 1024)
+
+struct uring_slot
+{
+    block_t *block; /**< destination buffer, NULL when the slot is idle */
+    uint64_t offset; /**< file offset of the queued read */
+    bool done; /**< completion already reaped out of order */
+    ssize_t value; /**< completion result when done */
+};
+
+typedef struct
+{
+    struct io_uring ring;
+    int fd;
+    uint64_t offset; /**< next offset to queue a read for */
+    uint64_t size; /**< file size when the access was opened */
+    unsigned head; /**< oldest in-flight slot */
+    unsigned queued; /**< number of in-flight slots */
+    struct uring_slot slots[URING_DEPTH];
+} access_sys_t;
+
+static unsigned UringQueue(stream_t *access)
+{
+    access_sys_t *sys = access->p_sys;
+    unsigned pushed = 0;
+
+    while (sys->queued < URING_DEPTH && sys->offset < sys->size)
+    {
+        unsigned idx = (sys->head + sys->queued) % URING_DEPTH;
+        struct uring_slot *slot = &sys->slots[idx];
+        struct io_uring_sqe *sqe = io_uring_get_sqe(&sys->ring);
+
+        if (sqe == NULL)
+            break;
+
+        size_t len = URING_CHUNK;
+        if (sys->size - sys->offset < len)
+            len = sys->size - sys->offset;
+
+        slot->block = block_Alloc(len);
+        if (unlikely(slot->block == NULL))
+            break;
+        slot->offset = sys->offset;
+        slot->done = false;
+
+        io_uring_prep_read(sqe, sys->fd, slot->block->p_buffer, len,
+                           slot->offset);
+        io_uring_sqe_set_data64(sqe, idx);
+
+        sys->offset += len;
+        sys->queued++;
+        pushed++;
+    }
+
+    if (pushed > 0)
+        io_uring_submit(&sys->ring);
+    return pushed;
+}
+
+static void UringDrain(access_sys_t *sys)
+{
+    while (sys->queued > 0)
+    {
+        struct uring_slot *slot = &sys->slots[sys->head];
+
+        if (!slot->done)
+        {
+            struct io_uring_cqe *cqe;
+
+            if (io_uring_wait_cqe(&sys->ring, &cqe) != 0)
+                break;
+
+            struct uring_slot *owner = &sys->slots[io_uring_cqe_get_data64(cqe)];
+            owner->done = true;
+            owner->value = cqe->res;
+            io_uring_cqe_seen(&sys->ring, cqe);
+            continue;
+        }
+
+        block_Release(slot->block);
+        slot->block = NULL;
+        sys->head = (sys->head + 1) % URING_DEPTH;
+        sys->queued--;
+    }
+}
+
+static block_t *UringBlock(stream_t *access, bool *restrict eof)
+{
+    access_sys_t *sys = access->p_sys;
+
+    UringQueue(access);
+
+    if (sys->queued == 0)
+    {   /* Nothing in flight and nothing left to queue */
+        *eof = true;
+        return NULL;
+    }
+
+    struct uring_slot *slot = &sys->slots[sys->head];
+
+    /* Reap completions until the oldest request is done, so that data is
+     * delivered in file order regardless of the completion order. */
+    while (!slot->done)
+    {
+        struct io_uring_cqe *cqe;
+        int val = io_uring_wait_cqe(&sys->ring, &cqe);
+
+        if (val != 0)
+        {
+            if (val == -EINTR)
+            {
+                if (vlc_killed())
+                    return NULL;
+                continue;
+            }
+            msg_Err(access, "completion error: %s", vlc_strerror_c(-val));
+            return NULL;
+        }
+
+        struct uring_slot *owner = &sys->slots[io_uring_cqe_get_data64(cqe)];
+        owner->done = true;
+        owner->value = cqe->res;
+        io_uring_cqe_seen(&sys->ring, cqe);
+    }
+
+    block_t *block = slot->block;
+
+    slot->block = NULL;
+    sys->head = (sys->head + 1) % URING_DEPTH;
+    sys->queued--;
+
+    if (slot->value <= 0)
+    {
+        block_Release(block);
+        if (slot->value < 0)
+        {
+            msg_Err(access, "read error: %s", vlc_strerror_c(-slot->value));
+            return NULL;
+        }
+        *eof = true;
+        return NULL;
+    }
+
+    block->i_buffer = slot->value;
+    /* Top the queue back up while the caller consumes this block. */
+    UringQueue(access);
+    return block;
+}
+
+static int UringSeek(stream_t *access, uint64_t position)
+{
+    access_sys_t *sys = access->p_sys;
+
+    /* In-flight reads target stale offsets: flush them all. */
+    UringDrain(sys);
+    sys->offset = position;
+    return VLC_SUCCESS;
+}
+
+static int UringControl(stream_t *access, int query, va_list args)
+{
+    access_sys_t *sys = access->p_sys;
+
+    switch (query)
+    {
+        case STREAM_CAN_SEEK:
+        case STREAM_CAN_FASTSEEK:
+        case STREAM_CAN_PAUSE:
+        case STREAM_CAN_CONTROL_PACE:
+            *va_arg(args, bool *) = true;
+            break;
+
+        case STREAM_GET_SIZE:
+            *va_arg(args, uint64_t *) = sys->size;
+            break;
+
+        case STREAM_GET_PTS_DELAY:
+            *va_arg(args, vlc_tick_t *) = VLC_TICK_FROM_MS(
+                var_InheritInteger(access, "file-caching"));
+            break;
+
+        case STREAM_SET_PAUSE_STATE:
+            /* Nothing to do */
+            break;
+
+        default:
+            return VLC_EGENERIC;
+    }
+    return VLC_SUCCESS;
+}
+
+static int Open(vlc_object_t *obj)
+{
+    stream_t *access = (stream_t *)obj;
+
+    if (access->psz_filepath == NULL)
+        return VLC_EGENERIC;
+
+    int fd = vlc_open(access->psz_filepath, O_RDONLY);
+    if (fd == -1)
+        return VLC_EGENERIC;
+
+    struct stat st;
+    if (fstat(fd, &st) || !S_ISREG(st.st_mode))
+    {   /* Only regular files benefit from queued readahead. */
+        vlc_close(fd);
+        return VLC_EGENERIC;
+    }
+
+    access_sys_t *sys = vlc_obj_calloc(obj, 1, sizeof (*sys));
+    if (unlikely(sys == NULL))
+    {
+        vlc_close(fd);
+        return VLC_ENOMEM;
+    }
+
+    if (io_uring_queue_init(URING_DEPTH, &sys->ring, 0) != 0)
+    {   /* Kernel too old or io_uring disabled: let file.c take over. */
+        vlc_close(fd);
+        return VLC_EGENERIC;
+    }
+
+    sys->fd = fd;
+    sys->size = st.st_size;
+
+    access->p_sys = sys;
+    access->pf_read = NULL;
+    access->pf_block = UringBlock;
+    access->pf_seek = UringSeek;
+    access->pf_control = UringControl;
+    return VLC_SUCCESS;
+}
+
+static void Close(vlc_object_t *obj)
+{
+    stream_t *access = (stream_t *)obj;
+    access_sys_t *sys = access->p_sys;
+
+    UringDrain(sys);
+    io_uring_queue_exit(&sys->ring);
+    vlc_close(sys->fd);
+}
+
+vlc_module_begin()
+    set_description(N_("io_uring file input"))
+    set_shortname(N_("io_uring"))
+    set_category(CAT_INPUT)
+    set_subcategory(SUBCAT_INPUT_ACCESS)
+    set_capability("access", 52)
+    add_shortcut("file", "iouring")
+    set_callbacks(Open, Close)
+vlc_module_end()
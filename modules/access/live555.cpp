@@ -169,7 +169,10 @@ typedef struct
     bool            b_discard_trunc;
     vlc_demux_chained_t *p_out_muxed;    /* for muxed stream */
 
-    uint8_t         *p_buffer;
+    /* Receive buffer: a refcounted block frames are received straight
+     * into, handed to the es_out without copy for large frames.  The
+     * allocator's size-classed pool recycles the released ones. */
+    block_t         *p_recv;
     unsigned int    i_buffer;
 
     bool            b_rtcp_sync;
@@ -194,6 +197,25 @@ typedef struct
 
 class RTSPClientVlc;
 
+/* Headroom kept in front of the receive buffer for the per-codec prepends
+ * (4-byte startcode, H.261 header, AMR frame header) so handing the buffer
+ * off does not need a copy either. */
+#define RECV_PREPEND    8
+/* Frames smaller than this are copied out instead, so a large pooled
+ * buffer is not held hostage downstream by a tiny audio frame. */
+#define RECV_COPY_MAX   2048
+
+static block_t *RecvAlloc( unsigned i_capacity )
+{
+    block_t *p_block = block_Alloc( i_capacity + RECV_PREPEND );
+    if( p_block )
+    {
+        p_block->p_buffer += RECV_PREPEND;
+        p_block->i_buffer -= RECV_PREPEND;
+    }
+    return p_block;
+}
+
 #define CAP_RATE_CONTROL        (1 << 1)
 #define CAP_SUBSESSION_TEARDOWN (1 << 2)
 #define CAP_SUBSESSION_PAUSE    (1 << 3)
@@ -493,7 +515,8 @@ static void Close( vlc_object_t *p_this )
             vlc_demux_chained_Delete( tk->p_out_muxed );
         es_format_Clean( &tk->fmt );
         dtsgen_Clean( &tk->dtsgen );
-        free( tk->p_buffer );
+        if( tk->p_recv )
+            block_Release( tk->p_recv );
         free( tk );
     }
     TAB_CLEAN( p_sys->i_track, p_sys->track );
@@ -876,9 +899,9 @@ static int SessionsSetup( demux_t *p_demux )
             dtsgen_Init( &tk->dtsgen );
             tk->state       = live_track_t::STATE_SELECTED;
             tk->i_buffer    = i_frame_buffer;
-            tk->p_buffer    = (uint8_t *)malloc( i_frame_buffer );
+            tk->p_recv      = RecvAlloc( i_frame_buffer );
 
-            if( !tk->p_buffer )
+            if( !tk->p_recv )
             {
                 free( tk );
                 delete iter;
@@ -1411,8 +1434,13 @@ static int Demux( demux_t *p_demux )
 
         if( tk->waiting == 0 )
         {
+            if( tk->p_recv == NULL )
+                tk->p_recv = RecvAlloc( tk->i_buffer );
+            if( tk->p_recv == NULL )
+                continue; /* retry next round */
             tk->waiting = 1;
-            tk->sub->readSource()->getNextFrame( tk->p_buffer, tk->i_buffer,
+            tk->sub->readSource()->getNextFrame( tk->p_recv->p_buffer,
+                                          tk->i_buffer,
                                           StreamRead, tk, StreamClose, tk );
         }
     }
@@ -1793,7 +1821,8 @@ static int RollOverTcp( demux_t *p_demux )
         if( tk->p_es ) es_out_Del( p_demux->out, tk->p_es );
         if( tk->p_asf_block ) block_Release( tk->p_asf_block );
         es_format_Clean( &tk->fmt );
-        free( tk->p_buffer );
+        if( tk->p_recv )
+            block_Release( tk->p_recv );
         free( tk );
     }
     TAB_CLEAN( p_sys->i_track, p_sys->track );
@@ -2016,17 +2045,18 @@ static void StreamRead( void *p_private, unsigned int i_size,
     {
         if( tk->i_buffer < 2000000 )
         {
-            void *p_tmp;
             msg_Dbg( p_demux, "lost %d bytes", i_truncated_bytes );
             msg_Dbg( p_demux, "increasing buffer size to %d", tk->i_buffer * 2 );
-            p_tmp = realloc( tk->p_buffer, tk->i_buffer * 2 );
+            block_t *p_tmp = RecvAlloc( tk->i_buffer * 2 );
             if( p_tmp == NULL )
             {
-                msg_Warn( p_demux, "realloc failed" );
+                msg_Warn( p_demux, "buffer reallocation failed" );
             }
             else
             {
-                tk->p_buffer = (uint8_t*)p_tmp;
+                memcpy( p_tmp->p_buffer, tk->p_recv->p_buffer, i_size );
+                block_Release( tk->p_recv );
+                tk->p_recv = p_tmp;
                 tk->i_buffer *= 2;
             }
         }
@@ -2041,56 +2071,95 @@ static void StreamRead( void *p_private, unsigned int i_size,
 
     assert( i_size <= tk->i_buffer );
 
+    uint8_t *p_recv_buf = tk->p_recv->p_buffer;
+    /* Large frames are handed over zero-copy by detaching the receive
+     * block (with the prepend written into its headroom); small ones are
+     * copied out so the pooled buffer is reused for the next frame. */
+    bool b_handoff = i_size >= RECV_COPY_MAX;
+
     if( tk->fmt.i_codec == VLC_CODEC_AMR_NB ||
         tk->fmt.i_codec == VLC_CODEC_AMR_WB )
     {
         AMRAudioSource *amrSource = (AMRAudioSource*)tk->sub->readSource();
 
-        if( (p_block = block_Alloc( i_size + 1 )) )
+        if( b_handoff )
         {
+            p_block = tk->p_recv;
+            tk->p_recv = NULL;
+            p_block->p_buffer -= 1;
+            p_block->i_buffer = i_size + 1;
             p_block->p_buffer[0] = amrSource->lastFrameHeader();
-            memcpy( p_block->p_buffer + 1, tk->p_buffer, i_size );
+        }
+        else if( (p_block = block_Alloc( i_size + 1 )) )
+        {
+            p_block->p_buffer[0] = amrSource->lastFrameHeader();
+            memcpy( p_block->p_buffer + 1, p_recv_buf, i_size );
         }
     }
     else if( tk->fmt.i_codec == VLC_CODEC_H261 )
     {
         H261VideoRTPSource *h261Source = (H261VideoRTPSource*)tk->sub->rtpSource();
         uint32_t header = h261Source->lastSpecialHeader();
-        if( (p_block = block_Alloc( i_size + 4 )) )
+        if( b_handoff )
         {
+            p_block = tk->p_recv;
+            tk->p_recv = NULL;
+            p_block->p_buffer -= 4;
+            p_block->i_buffer = i_size + 4;
             memcpy( p_block->p_buffer, &header, 4 );
-            memcpy( p_block->p_buffer + 4, tk->p_buffer, i_size );
+        }
+        else if( (p_block = block_Alloc( i_size + 4 )) )
+        {
+            memcpy( p_block->p_buffer, &header, 4 );
+            memcpy( p_block->p_buffer + 4, p_recv_buf, i_size );
         }
     }
     else if( tk->fmt.i_codec == VLC_CODEC_H264 || tk->fmt.i_codec == VLC_CODEC_HEVC )
     {
-        if( tk->fmt.i_codec == VLC_CODEC_H264 && (tk->p_buffer[0] & 0x1f) >= 24 )
+        if( tk->fmt.i_codec == VLC_CODEC_H264 && (p_recv_buf[0] & 0x1f) >= 24 )
             msg_Warn( p_demux, "unsupported NAL type for H264" );
-        else if( tk->fmt.i_codec == VLC_CODEC_HEVC && ((tk->p_buffer[0] & 0x7e)>>1) >= 48 )
+        else if( tk->fmt.i_codec == VLC_CODEC_HEVC && ((p_recv_buf[0] & 0x7e)>>1) >= 48 )
             msg_Warn( p_demux, "unsupported NAL type for H265" );
 
         /* Normal NAL type */
-        if( (p_block = block_Alloc( i_size + 4 )) )
+        if( b_handoff )
+        {
+            p_block = tk->p_recv;
+            tk->p_recv = NULL;
+            p_block->p_buffer -= 4;
+            p_block->i_buffer = i_size + 4;
+        }
+        else
+            p_block = block_Alloc( i_size + 4 );
+        if( p_block )
         {
             p_block->p_buffer[0] = 0x00;
             p_block->p_buffer[1] = 0x00;
             p_block->p_buffer[2] = 0x00;
             p_block->p_buffer[3] = 0x01;
-            memcpy( &p_block->p_buffer[4], tk->p_buffer, i_size );
+            if( !b_handoff )
+                memcpy( &p_block->p_buffer[4], p_recv_buf, i_size );
             if( tk->sub->rtpSource()->curPacketMarkerBit() )
                 p_block->i_flags |= BLOCK_FLAG_AU_END;
         }
     }
     else if( tk->format == live_track_t::ASF_STREAM )
     {
+        /* reassembled into packets of its own, no handoff */
         p_block = StreamParseAsf( p_demux, tk,
                                   tk->sub->rtpSource()->curPacketMarkerBit(),
-                                  tk->p_buffer, i_size );
+                                  p_recv_buf, i_size );
     }
     else
     {
-        if( (p_block = block_Alloc( i_size )) )
-            memcpy( p_block->p_buffer, tk->p_buffer, i_size );
+        if( b_handoff )
+        {
+            p_block = tk->p_recv;
+            tk->p_recv = NULL;
+            p_block->i_buffer = i_size;
+        }
+        else if( (p_block = block_Alloc( i_size )) )
+            memcpy( p_block->p_buffer, p_recv_buf, i_size );
     }
 
     /* No data sent. Always in sync then */
@@ -64,6 +64,29 @@ vlc_module_begin()
     set_callbacks(Open, Close)
 vlc_module_end()
 
+/* Number of READ requests kept in flight and size of each. Sequential
+ * synchronous reads pay one RPC round trip per request; keeping several
+ * outstanding fills the pipe instead. */
+#define VLC_NFS_RA_DEPTH 4
+#define VLC_NFS_RA_CHUNK (256 * 1024)
+
+enum vlc_nfs_slot_state
+{
+    VLC_NFS_SLOT_FREE,    /**< No request, buffer reusable */
+    VLC_NFS_SLOT_PENDING, /**< Request in flight */
+    VLC_NFS_SLOT_DONE,    /**< Reply received */
+    VLC_NFS_SLOT_ORPHAN,  /**< Flushed while in flight, free on reply */
+};
+
+struct vlc_nfs_slot
+{
+    stream_t *p_access;
+    enum vlc_nfs_slot_state state;
+    uint64_t i_offset; /**< File offset of the request */
+    ssize_t  i_res;    /**< Bytes read, 0 on EOF, < 0 on error */
+    uint8_t *p_buf;
+};
+
 typedef struct
 {
     struct rpc_context *    p_mount; /* used to to get exports mount point */
@@ -79,21 +102,18 @@ typedef struct
     bool                    b_error;
     bool                    b_auto_guid;
 
+    /* Pipelined reads (files only) */
+    struct vlc_nfs_slot     slots[VLC_NFS_RA_DEPTH];
+    struct vlc_nfs_slot *   p_wait_slot; /**< Slot FileRead() is waiting on */
+    uint64_t                i_read_offset; /**< Position seen by the core */
+    uint64_t                i_ra_offset;   /**< Next offset to request */
+
     union {
         struct
         {
             char **         ppsz_names;
             int             i_count;
         } exports;
-        struct
-        {
-            uint8_t *p_buf;
-            size_t i_len;
-        } read;
-        struct
-        {
-            bool b_done;
-        } seek;
     } res;
 } access_sys_t;
 
@@ -174,75 +194,154 @@ vlc_mount_mainloop(stream_t *p_access, bool (*pf_until_cb)(stream_t *))
 }
 
 static void
-nfs_read_cb(int i_status, struct nfs_context *p_nfs, void *p_data,
-            void *p_private_data)
+nfs_pread_cb(int i_status, struct nfs_context *p_nfs, void *p_data,
+             void *p_private_data)
 {
     VLC_UNUSED(p_nfs);
-    stream_t *p_access = p_private_data;
+    struct vlc_nfs_slot *p_slot = p_private_data;
+    stream_t *p_access = p_slot->p_access;
     access_sys_t *p_sys = p_access->p_sys;
     assert(p_sys->p_nfs == p_nfs);
-    if (NFS_CHECK_STATUS(p_access, i_status, p_data))
-        return;
 
-    if (i_status == 0)
-        p_sys->b_eof = true;
-    else
-    {
-        p_sys->res.read.i_len = i_status;
-        memcpy(p_sys->res.read.p_buf, p_data, i_status);
+    if (p_slot->state == VLC_NFS_SLOT_ORPHAN)
+    {   /* The position was flushed while this request was in flight */
+        p_slot->state = VLC_NFS_SLOT_FREE;
+        return;
     }
+
+    if (!NFS_CHECK_STATUS(p_access, i_status, p_data) && i_status > 0)
+        memcpy(p_slot->p_buf, p_data, i_status);
+    p_slot->i_res = i_status;
+    p_slot->state = VLC_NFS_SLOT_DONE;
 }
 
 static bool
-nfs_read_finished_cb(stream_t *p_access)
+nfs_read_slot_finished_cb(stream_t *p_access)
 {
     access_sys_t *p_sys = p_access->p_sys;
-    return p_sys->res.read.i_len > 0 || p_sys->b_eof;
+    return p_sys->p_wait_slot->state != VLC_NFS_SLOT_PENDING;
 }
 
-static ssize_t
-FileRead(stream_t *p_access, void *p_buf, size_t i_len)
+/** Issues read requests on every free slot until the pipeline is full */
+static void
+FileStartReads(stream_t *p_access)
 {
     access_sys_t *p_sys = p_access->p_sys;
 
-    if (p_sys->b_eof)
-        return 0;
-
-    p_sys->res.read.i_len = 0;
-    p_sys->res.read.p_buf = p_buf;
-    if (nfs_read_async(p_sys->p_nfs, p_sys->p_nfsfh, i_len, nfs_read_cb,
-                       p_access) < 0)
+    for (size_t i = 0; i < VLC_NFS_RA_DEPTH; i++)
     {
-        msg_Err(p_access, "nfs_read_async failed");
-        return -1;
-    }
+        struct vlc_nfs_slot *p_slot = &p_sys->slots[i];
 
-    if (vlc_nfs_mainloop(p_access, nfs_read_finished_cb) < 0)
-        return -1;
+        if (p_slot->state != VLC_NFS_SLOT_FREE)
+            continue;
+        if (p_sys->b_error
+         || p_sys->i_ra_offset >= (uint64_t)p_sys->stat.nfs_size)
+            break;
 
-    return p_sys->res.read.i_len;
+        if (p_slot->p_buf == NULL)
+        {
+            p_slot->p_buf = malloc(VLC_NFS_RA_CHUNK);
+            if (unlikely(p_slot->p_buf == NULL))
+                break;
+        }
+        p_slot->p_access = p_access;
+        p_slot->i_offset = p_sys->i_ra_offset;
+        if (nfs_pread_async(p_sys->p_nfs, p_sys->p_nfsfh, p_slot->i_offset,
+                            VLC_NFS_RA_CHUNK, nfs_pread_cb, p_slot) < 0)
+        {
+            msg_Err(p_access, "nfs_pread_async failed");
+            p_sys->b_error = true;
+            break;
+        }
+        p_slot->state = VLC_NFS_SLOT_PENDING;
+        p_sys->i_ra_offset += VLC_NFS_RA_CHUNK;
+    }
 }
 
+/** Discards the content of the pipeline (i.e. before seeking) */
 static void
-nfs_seek_cb(int i_status, struct nfs_context *p_nfs, void *p_data,
-            void *p_private_data)
+FileFlushReads(stream_t *p_access)
 {
-    VLC_UNUSED(p_nfs);
-    stream_t *p_access = p_private_data;
     access_sys_t *p_sys = p_access->p_sys;
-    assert(p_sys->p_nfs == p_nfs);
-    (void) p_data;
-    if (NFS_CHECK_STATUS(p_access, i_status, p_data))
-        return;
 
-    p_sys->res.seek.b_done = true;
+    for (size_t i = 0; i < VLC_NFS_RA_DEPTH; i++)
+    {
+        struct vlc_nfs_slot *p_slot = &p_sys->slots[i];
+
+        if (p_slot->state == VLC_NFS_SLOT_PENDING)
+            p_slot->state = VLC_NFS_SLOT_ORPHAN; /* freed by its callback */
+        else if (p_slot->state == VLC_NFS_SLOT_DONE)
+            p_slot->state = VLC_NFS_SLOT_FREE;
+    }
 }
 
-static bool
-nfs_seek_finished_cb(stream_t *p_access)
+static ssize_t
+FileRead(stream_t *p_access, void *p_buf, size_t i_len)
 {
     access_sys_t *p_sys = p_access->p_sys;
-    return p_sys->res.seek.b_done;
+
+    if (p_sys->b_error)
+        return -1;
+
+    if (p_sys->b_eof
+     || p_sys->i_read_offset >= (uint64_t)p_sys->stat.nfs_size)
+        return 0;
+
+    FileStartReads(p_access);
+
+    /* Find the slot covering the current position. Requests are issued in
+     * file order, so it always exists unless issuing itself failed. */
+    struct vlc_nfs_slot *p_slot = NULL;
+    for (size_t i = 0; i < VLC_NFS_RA_DEPTH; i++)
+    {
+        struct vlc_nfs_slot *s = &p_sys->slots[i];
+
+        if ((s->state == VLC_NFS_SLOT_PENDING
+          || s->state == VLC_NFS_SLOT_DONE)
+         && p_sys->i_read_offset >= s->i_offset
+         && p_sys->i_read_offset < s->i_offset + VLC_NFS_RA_CHUNK)
+        {
+            p_slot = s;
+            break;
+        }
+    }
+    if (p_slot == NULL)
+        return -1;
+
+    if (p_slot->state == VLC_NFS_SLOT_PENDING)
+    {
+        p_sys->p_wait_slot = p_slot;
+        if (vlc_nfs_mainloop(p_access, nfs_read_slot_finished_cb) < 0)
+            return -1;
+    }
+
+    if (p_sys->b_error || p_slot->i_res < 0)
+        return -1;
+
+    size_t i_pos = p_sys->i_read_offset - p_slot->i_offset;
+    if ((size_t)p_slot->i_res <= i_pos)
+    {   /* Shorter file than advertised */
+        p_sys->b_eof = true;
+        return 0;
+    }
+
+    size_t i_avail = (size_t)p_slot->i_res - i_pos;
+    if (i_len > i_avail)
+        i_len = i_avail;
+    memcpy(p_buf, p_slot->p_buf + i_pos, i_len);
+    p_sys->i_read_offset += i_len;
+
+    if (i_pos + i_len == (size_t)p_slot->i_res)
+    {
+        p_slot->state = VLC_NFS_SLOT_FREE;
+        if ((size_t)p_slot->i_res < VLC_NFS_RA_CHUNK)
+        {   /* Short reply (e.g. server read size limit): the following
+             * slots do not line up anymore, refetch from here. */
+            FileFlushReads(p_access);
+            p_sys->i_ra_offset = p_sys->i_read_offset;
+        }
+    }
+    return i_len;
 }
 
 static int
@@ -250,17 +349,15 @@ FileSeek(stream_t *p_access, uint64_t i_pos)
 {
     access_sys_t *p_sys = p_access->p_sys;
 
-    p_sys->res.seek.b_done = false;
-    if (nfs_lseek_async(p_sys->p_nfs, p_sys->p_nfsfh, i_pos, SEEK_SET,
-                        nfs_seek_cb, p_access) < 0)
-    {
-        msg_Err(p_access, "nfs_seek_async failed");
-        return VLC_EGENERIC;
-    }
-
-    if (vlc_nfs_mainloop(p_access, nfs_seek_finished_cb) < 0)
+    if (p_sys->b_error)
         return VLC_EGENERIC;
 
+    if (i_pos != p_sys->i_read_offset)
+    {   /* Reads carry their own offset; just restart the pipeline */
+        FileFlushReads(p_access);
+        p_sys->i_read_offset = i_pos;
+        p_sys->i_ra_offset = i_pos;
+    }
     p_sys->b_eof = false;
 
     return VLC_SUCCESS;
@@ -758,6 +855,9 @@ Close(vlc_object_t *p_obj)
     if (p_sys->p_nfs != NULL)
         nfs_destroy_context(p_sys->p_nfs);
 
+    for (size_t i = 0; i < VLC_NFS_RA_DEPTH; ++i)
+        free(p_sys->slots[i].p_buf);
+
     if (p_sys->p_mount != NULL)
     {
         for (int i = 0; i < p_sys->res.exports.i_count; ++i)
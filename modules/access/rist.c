@@ -229,6 +229,46 @@ static int is_index_in_range(struct rist_flow *flow, uint16_t idx)
     }
 }
 
+static inline void pkt_index_set(struct rist_flow *flow, uint16_t idx)
+{
+    flow->occupancy[idx >> 6] |= UINT64_C(1) << (idx & 63);
+}
+
+static inline void pkt_index_clear(struct rist_flow *flow, uint16_t idx)
+{
+    flow->occupancy[idx >> 6] &= ~(UINT64_C(1) << (idx & 63));
+}
+
+/* Find the first occupied slot in (from, to], skipping empty runs through
+ * the occupancy bitmap. Returns false when the whole range is empty. */
+static bool pkt_index_next(const struct rist_flow *flow, uint16_t from,
+                           uint16_t to, uint16_t *found)
+{
+    uint16_t idx = (uint16_t)(from + 1);
+    uint16_t remaining = (uint16_t)(to - from);
+
+    while (remaining > 0)
+    {
+        uint64_t word = flow->occupancy[idx >> 6] >> (idx & 63);
+        unsigned avail = 64 - (idx & 63);
+        if (avail > remaining)
+            avail = remaining;
+
+        if (word != 0)
+        {
+            unsigned bit = ctz(word);
+            if (bit < avail)
+            {
+                *found = (uint16_t)(idx + bit);
+                return true;
+            }
+        }
+        idx = (uint16_t)(idx + avail);
+        remaining = (uint16_t)(remaining - avail);
+    }
+    return false;
+}
+
 static void send_rtcp_feedback(stream_t *p_access, struct rist_flow *flow)
 {
     stream_sys_t *p_sys = p_access->p_sys;
@@ -360,6 +400,19 @@ static void send_nacks(stream_t *p_access, struct rist_flow *flow)
     idx = flow->ri;
     while(idx++ != flow->wi)
     {
+        /* Fast-forward over fully populated spans: a healthy window has no
+         * hole to report, so skip it one bitmap word at a time */
+        unsigned shift = idx & 63;
+        unsigned span = 64 - shift;
+        if (span <= (uint16_t)(flow->wi - idx) + 1u &&
+            (flow->occupancy[idx >> 6] >> shift) == (UINT64_MAX >> shift))
+        {
+            idx = (uint16_t)(idx + span - 1);
+            last_ts = flow->buffer[idx].rtp_ts;
+            null_count = 0;
+            continue;
+        }
+
         pkt = &(flow->buffer[idx]);
         if (pkt->buffer == NULL)
         {
@@ -670,11 +723,15 @@ static bool rist_input(stream_t *p_access, struct rist_flow *flow, uint8_t *buf,
     }
     pkt->buffer = block_Alloc(len);
     if (!pkt->buffer)
+    {
+        pkt_index_clear(flow, idx);
         return false;
+    }
 
     pkt->buffer->i_buffer = len;
     memcpy(pkt->buffer->p_buffer, buf, len);
     pkt->rtp_ts = pkt_ts;
+    pkt_index_set(flow, idx);
     p_sys->last_data_rx = vlc_tick_now();
     /* Reset the try counter regardless of wether it was a retransmit or not */
     flow->nacks_retries[idx] = 0;
@@ -720,22 +777,19 @@ static block_t *rist_dequeue(stream_t *p_access, struct rist_flow *flow)
     if (flow->ri == flow->wi || flow->reset > 0)
         return NULL;
 
-    idx = flow->ri;
+    uint16_t prev = flow->ri;
     bool found_data = false;
     uint16_t loss_amount = 0;
-    while(idx++ != flow->wi) {
+    while (pkt_index_next(flow, prev, flow->wi, &idx)) {
+
+        /* The slots skipped by the bitmap scan are holes. None of them are
+         * guaranteed packet loss because we do not really know their
+         * timestamps. They might still arrive on the next loop. We can
+         * confirm the loss only if we deliver a valid packet below. */
+        loss_amount += (uint16_t)(idx - prev - 1);
+        prev = idx;
 
         pkt = &(flow->buffer[idx]);
-        if (!pkt->buffer)
-        {
-            /*msg_Info(p_access, "Possible packet loss on index #%d", idx);*/
-            loss_amount++;
-            /* We move ahead until we find a timestamp but we do not move the cursor.
-             * None of them are guaranteed packet loss because we do not really
-             * know their timestamps. They might still arrive on the next loop.
-             * We can confirm the loss only if we get a valid packet in the loop below. */
-            continue;
-        }
 
         /*printf("IDX=%d, flow->hi_timestamp: %u, (ts + flow->rtp_latency): %u\n", idx,
             flow->hi_timestamp, (ts - 100 * flow->qdelay));*/
@@ -755,6 +809,7 @@ static block_t *rist_dequeue(stream_t *p_access, struct rist_flow *flow)
             }
             block_Release(pkt->buffer);
             pkt->buffer = NULL;
+            pkt_index_clear(flow, idx);
             break;
         }
 
@@ -99,6 +99,10 @@ struct rist_flow {
     int fd_rtcp_m;
     int fd_nack;
     uint8_t nacks_retries[RIST_QUEUE_SIZE];
+    /* One bit per buffer slot, set while the slot holds a packet, so that
+     * the reorder and NACK scans can skip populated or empty runs 64
+     * sequence numbers at a time */
+    uint64_t occupancy[RIST_QUEUE_SIZE / 64];
     uint32_t hi_timestamp;
     uint64_t feedback_time;
     uint32_t latency;
@@ -157,6 +157,18 @@ static void Close (vlc_object_t *obj)
     net_Close (p_sys->fd);
 }
 
+
+/* Round up to a power of two for cheap jitter buffer slot masking */
+static uint16_t rtp_jbuf_depth(vlc_object_t *obj, int64_t value)
+{
+    unsigned depth = 16;
+
+    while (depth < (unsigned)value)
+        depth <<= 1;
+    (void) obj;
+    return depth;
+}
+
 static int OpenSDP(vlc_object_t *obj)
 {
     demux_t *demux = (demux_t *)obj;
@@ -298,6 +310,8 @@ static int OpenSDP(vlc_object_t *obj)
     sys->timeout = vlc_tick_from_sec(var_InheritInteger(obj, "rtp-timeout"));
     sys->max_dropout  = var_InheritInteger(obj, "rtp-max-dropout");
     sys->max_misorder = var_InheritInteger(obj, "rtp-max-misorder");
+    sys->jbuf_depth   = rtp_jbuf_depth(obj,
+                            var_InheritInteger(obj, "rtp-jbuf-depth"));
     sys->autodetect = true;
 
     demux->pf_demux = NULL;
@@ -423,6 +437,8 @@ static int OpenURL(vlc_object_t *obj)
     p_sys->timeout      = vlc_tick_from_sec( var_CreateGetInteger (obj, "rtp-timeout") );
     p_sys->max_dropout  = var_CreateGetInteger (obj, "rtp-max-dropout");
     p_sys->max_misorder = var_CreateGetInteger (obj, "rtp-max-misorder");
+    p_sys->jbuf_depth   = rtp_jbuf_depth(obj,
+                            var_CreateGetInteger (obj, "rtp-jbuf-depth"));
     p_sys->thread_ready = false;
     p_sys->autodetect   = true;
 
@@ -500,6 +516,11 @@ error:
     "RTP packets will be discarded if they are too much ahead (i.e. in the " \
     "future) by this many packets from the last received packet." )
 
+#define RTP_JBUF_DEPTH_TEXT N_("RTP jitter buffer depth (packets)")
+#define RTP_JBUF_DEPTH_LONGTEXT N_( \
+    "How many packets the reordering jitter buffer can hold per source. " \
+    "The value is rounded up to a power of two." )
+
 #define RTP_MAX_MISORDER_TEXT N_("Maximum RTP sequence number misordering")
 #define RTP_MAX_MISORDER_LONGTEXT N_( \
     "RTP packets will be discarded if they are too far behind (i.e. in the " \
@@ -553,6 +574,9 @@ vlc_module_begin()
     add_integer("rtp-max-misorder", 100, RTP_MAX_MISORDER_TEXT,
                 RTP_MAX_MISORDER_LONGTEXT, true)
         change_integer_range (0, 32767)
+    add_integer("rtp-jbuf-depth", 1024, RTP_JBUF_DEPTH_TEXT,
+                RTP_JBUF_DEPTH_LONGTEXT, true)
+        change_integer_range (16, 16384)
     add_string("rtp-dynamic-pt", NULL, RTP_DYNAMIC_PT_TEXT,
                RTP_DYNAMIC_PT_LONGTEXT, true)
         change_string_list(dynamic_pt_list, dynamic_pt_list_text)
@@ -72,6 +72,7 @@ typedef struct
     vlc_thread_t  thread;
 
     vlc_tick_t    timeout;
+    uint16_t      jbuf_depth; /**< Jitter buffer depth (packets, power of 2) */
     uint16_t      max_dropout; /**< Max packet forward misordering */
     uint16_t      max_misorder; /**< Max packet backward misordering */
     uint8_t       max_src; /**< Max simultaneous RTP sources */
@@ -49,7 +49,8 @@ rtp_source_create (demux_t *, const rtp_session_t *, uint32_t, uint16_t);
 static void
 rtp_source_destroy (demux_t *, const rtp_session_t *, rtp_source_t *);
 
-static void rtp_decode (demux_t *, const rtp_session_t *, rtp_source_t *);
+static void rtp_decode (demux_t *, const rtp_session_t *, rtp_source_t *,
+                        block_t *);
 
 /**
  * Creates a new RTP session.
@@ -149,7 +150,19 @@ struct rtp_source_t
     uint16_t max_seq; /* next expected sequence */
 
     uint16_t last_seq; /* sequence of the next dequeued packet */
-    block_t *blocks; /* re-ordered blocks queue */
+
+    /* Sequence-indexed circular jitter buffer: packet with sequence s sits
+     * in window[s % depth], so insertion, duplicate detection and in-order
+     * lookup are all O(1) instead of a list walk per packet. */
+    block_t **window;
+    uint16_t qsize;    /* packets currently buffered */
+
+    /* Receive statistics */
+    uint32_t rx_packets;
+    uint32_t rx_dup;     /* duplicates dropped */
+    uint32_t rx_late;    /* packets behind the dequeue point */
+    uint16_t max_reorder; /* worst observed reorder distance */
+
     void    *opaque[]; /* Per-source private payload data */
 };
 
@@ -172,7 +185,17 @@ rtp_source_create (demux_t *demux, const rtp_session_t *session,
     source->ref_ntp = UINT64_C (1) << 62;
     source->max_seq = source->bad_seq = init_seq;
     source->last_seq = init_seq - 1;
-    source->blocks = NULL;
+    source->qsize = 0;
+    source->rx_packets = source->rx_dup = source->rx_late = 0;
+    source->max_reorder = 0;
+
+    demux_sys_t *p_sys = demux->p_sys;
+    source->window = calloc (p_sys->jbuf_depth, sizeof (*source->window));
+    if (source->window == NULL)
+    {
+        free (source);
+        return NULL;
+    }
 
     /* Initializes all payload */
     for (unsigned i = 0; i < session->ptc; i++)
@@ -186,15 +209,34 @@ rtp_source_create (demux_t *demux, const rtp_session_t *session,
 /**
  * Destroys an RTP source and its associated streams.
  */
+static void rtp_window_flush (rtp_source_t *source, unsigned depth)
+{
+    for (unsigned i = 0; i < depth; i++)
+        if (source->window[i] != NULL)
+        {
+            block_Release (source->window[i]);
+            source->window[i] = NULL;
+        }
+    source->qsize = 0;
+}
+
 static void
 rtp_source_destroy (demux_t *demux, const rtp_session_t *session,
                     rtp_source_t *source)
 {
+    demux_sys_t *p_sys = demux->p_sys;
+
     msg_Dbg (demux, "removing RTP source (%08x)", source->ssrc);
+    msg_Dbg (demux, "source (%08x) stats: %"PRIu32" packets, "
+             "%"PRIu32" duplicate(s), %"PRIu32" late, "
+             "max reorder distance %"PRIu16", jitter %"PRIu32,
+             source->ssrc, source->rx_packets, source->rx_dup,
+             source->rx_late, source->max_reorder, source->jitter);
 
     for (unsigned i = 0; i < session->ptc; i++)
         session->ptv[i].destroy (demux, source->opaque[i]);
-    block_ChainRelease (source->blocks);
+    rtp_window_flush (source, p_sys->jbuf_depth);
+    free (source->window);
     free (source);
 }
 
@@ -337,8 +379,7 @@ rtp_queue (demux_t *demux, rtp_session_t *session, block_t *block)
             src->max_seq = src->bad_seq = seq + 1;
             src->last_seq = seq - 0x7fffe; /* hack for rtp_decode() */
             msg_Warn (demux, "sequence resynchronized");
-            block_ChainRelease (src->blocks);
-            src->blocks = NULL;
+            rtp_window_flush (src, p_sys->jbuf_depth);
         }
         else
         {
@@ -349,26 +390,38 @@ rtp_queue (demux_t *demux, rtp_session_t *session, block_t *block)
     else
     if (delta_seq >= 0)
         src->max_seq = seq + 1;
+    else if ((uint16_t)-delta_seq > src->max_reorder)
+        src->max_reorder = -delta_seq;
+
+    src->rx_packets++;
 
-    /* Queues the block in sequence order,
-     * hence there is a single queue for all payload types. */
-    block_t **pp = &src->blocks;
-    for (block_t *prev = *pp; prev != NULL; prev = *pp)
+    /* Everything up to last_seq was already passed downstream */
+    if ((int16_t)(seq - (uint16_t)(src->last_seq + 1)) < 0)
     {
-        delta_seq = seq - rtp_seq (prev);
-        if (delta_seq < 0)
-            break;
-        if (delta_seq == 0)
+        msg_Dbg (demux, "late packet (sequence: %"PRIu16")", seq);
+        src->rx_late++;
+        goto drop;
+    }
+
+    /* Slot the packet into the sequence-indexed window.
+     * There is a single window for all payload types. */
+    block_t **slot = &src->window[seq & (p_sys->jbuf_depth - 1)];
+    if (*slot != NULL)
+    {
+        if (rtp_seq (*slot) == seq)
         {
             msg_Dbg (demux, "duplicate packet (sequence: %"PRIu16")", seq);
-            goto drop; /* duplicate */
+            src->rx_dup++;
+            goto drop;
         }
-        pp = &prev->p_next;
+        /* The sequence wrapped around a packet older than the buffer
+         * depth; it would be hopelessly late by now anyway. */
+        block_Release (*slot);
+        src->qsize--;
     }
-    block->p_next = *pp;
-    *pp = block;
-
-    /*rtp_decode (demux, session, src);*/
+    block->p_next = NULL;
+    *slot = block;
+    src->qsize++;
     return;
 
 drop:
@@ -376,7 +429,8 @@ drop:
 }
 
 
-static void rtp_decode (demux_t *, const rtp_session_t *, rtp_source_t *);
+static void rtp_decode (demux_t *, const rtp_session_t *, rtp_source_t *,
+                        block_t *);
 
 /**
  * Dequeues RTP packets and pass them to decoder. Not cancellation-safe(?).
@@ -393,6 +447,8 @@ static void rtp_decode (demux_t *, const rtp_session_t *, rtp_source_t *);
 bool rtp_dequeue (demux_t *demux, const rtp_session_t *session,
                   vlc_tick_t *restrict deadlinep)
 {
+    demux_sys_t *p_sys = demux->p_sys;
+    const unsigned depth = p_sys->jbuf_depth;
     vlc_tick_t now = vlc_tick_now ();
     bool pending = false;
 
@@ -419,14 +475,38 @@ bool rtp_dequeue (demux_t *demux, const rtp_session_t *session,
          * LibVLC E/S-out clock synchronization. Here, we need to bother about
          * re-ordering packets, as decoders can't cope with mis-ordered data.
          */
-        while (((block = src->blocks)) != NULL)
+        while (src->qsize > 0)
         {
-            if ((int16_t)(rtp_seq (block) - (src->last_seq + 1)) <= 0)
-            {   /* Next (or earlier) block ready, no need to wait */
-                rtp_decode (demux, session, src);
+            const uint16_t next = src->last_seq + 1;
+
+            block = src->window[next & (depth - 1)];
+            if (block != NULL && rtp_seq (block) == next)
+            {   /* Next block ready, no need to wait */
+                rtp_decode (demux, session, src, block);
                 continue;
             }
 
+            /* Gap: find the earliest buffered packet past it.  This scan
+             * only runs while packets are missing; the in-order fast path
+             * above is O(1). */
+            uint16_t best_delta = UINT16_MAX;
+
+            block = NULL;
+            for (unsigned d = 0; d < depth; d++)
+            {
+                block_t *b = src->window[d];
+                if (b == NULL)
+                    continue;
+
+                uint16_t delta = rtp_seq (b) - next;
+                if (delta < best_delta)
+                {
+                    best_delta = delta;
+                    block = b;
+                }
+            }
+            assert (block != NULL);
+
             /* Wait for 3 times the inter-arrival delay variance (about 99.7%
              * match for random gaussian jitter).
              */
@@ -449,7 +529,7 @@ bool rtp_dequeue (demux_t *demux, const rtp_session_t *session,
             deadline += block->i_pts;
             if (now >= deadline)
             {
-                rtp_decode (demux, session, src);
+                rtp_decode (demux, session, src, block);
                 continue;
             }
             if (*deadlinep > deadline)
@@ -465,13 +545,15 @@ bool rtp_dequeue (demux_t *demux, const rtp_session_t *session,
  * Decodes one RTP packet.
  */
 static void
-rtp_decode (demux_t *demux, const rtp_session_t *session, rtp_source_t *src)
+rtp_decode (demux_t *demux, const rtp_session_t *session, rtp_source_t *src,
+            block_t *block)
 {
-    block_t *block = src->blocks;
+    demux_sys_t *p_sys = demux->p_sys;
 
     assert (block);
-    src->blocks = block->p_next;
-    block->p_next = NULL;
+    assert (src->window[rtp_seq (block) & (p_sys->jbuf_depth - 1)] == block);
+    src->window[rtp_seq (block) & (p_sys->jbuf_depth - 1)] = NULL;
+    src->qsize--;
 
     /* Discontinuity detection */
     uint16_t delta_seq = rtp_seq (block) - (src->last_seq + 1);
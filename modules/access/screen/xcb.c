@@ -28,6 +28,9 @@
 #include <errno.h>
 #include <xcb/xcb.h>
 #include <xcb/composite.h>
+#ifdef HAVE_XCB_DAMAGE
+# include <xcb/damage.h>
+#endif
 #ifdef HAVE_SYS_SHM_H
 # include <sys/shm.h>
 # include <xcb/shm.h>
@@ -118,6 +121,15 @@ typedef struct
     bool              shm; /**< Whether to use MIT-SHM */
     bool              follow_mouse;
     uint16_t          cur_w, cur_h; /**< Actual capture pixel dimensions */
+#ifdef HAVE_XCB_DAMAGE
+    xcb_damage_damage_t damage; /**< Damage tracking object XID */
+    uint8_t           damage_event; /**< DamageNotify event type code */
+    bool              use_damage; /**< Whether XDamage tracking is active */
+    uint8_t          *frame; /**< Persistent frame (NULL: refresh needed) */
+    int16_t           frame_x, frame_y; /**< Captured origin of the frame */
+    int16_t           dmg_x1, dmg_y1; /**< Dirty area bounding box */
+    int16_t           dmg_x2, dmg_y2;
+#endif
     /* Timer does not use this, only input thread: */
     vlc_timer_t       timer;
 } demux_sys_t;
@@ -224,6 +236,35 @@ static int Open (vlc_object_t *obj)
     p_sys->segment = xcb_generate_id (conn);
 #endif
     p_sys->shm = CheckSHM (conn);
+#ifdef HAVE_XCB_DAMAGE
+    /* Track damage so static screen contents need not be fetched again */
+    p_sys->use_damage = false;
+    p_sys->frame = NULL;
+    p_sys->dmg_x1 = p_sys->dmg_y1 = INT16_MAX;
+    p_sys->dmg_x2 = p_sys->dmg_y2 = INT16_MIN;
+
+    const xcb_query_extension_reply_t *ext =
+        xcb_get_extension_data (conn, &xcb_damage_id);
+    if (ext != NULL && ext->present)
+    {
+        xcb_damage_query_version_reply_t *v =
+            xcb_damage_query_version_reply (conn,
+                xcb_damage_query_version (conn, 1, 1), NULL);
+        if (v != NULL)
+        {
+            msg_Dbg (obj, "using Damage extension v%"PRIu32".%"PRIu32,
+                     v->major_version, v->minor_version);
+            free (v);
+            p_sys->damage = xcb_generate_id (conn);
+            xcb_damage_create (conn, p_sys->damage, p_sys->window,
+                               XCB_DAMAGE_REPORT_LEVEL_BOUNDING_BOX);
+            p_sys->damage_event = ext->first_event + XCB_DAMAGE_NOTIFY;
+            p_sys->use_damage = true;
+        }
+    }
+    if (!p_sys->use_damage)
+        msg_Dbg (obj, "Damage extension not available, grabbing every frame");
+#endif
     p_sys->w = var_InheritInteger (obj, "screen-width");
     p_sys->h = var_InheritInteger (obj, "screen-height");
     if (p_sys->w != 0 || p_sys->h != 0)
@@ -275,6 +316,9 @@ static void Close (vlc_object_t *obj)
 
     vlc_timer_destroy (p_sys->timer);
     xcb_disconnect (p_sys->conn);
+#ifdef HAVE_XCB_DAMAGE
+    free (p_sys->frame);
+#endif
     free (p_sys);
 }
 
@@ -327,6 +371,112 @@ static int Control (demux_t *demux, int query, va_list args)
 }
 
 
+#ifdef HAVE_XCB_DAMAGE
+/**
+ * Fetches only the screen area damaged since the previous grab and
+ * composites it into the persistent frame, which is then sent as a whole.
+ * @return the frame to send, or NULL if nothing changed (or on error)
+ */
+static block_t *DamageCapture (demux_t *demux, xcb_drawable_t drawable,
+                               int x, int y, unsigned w, unsigned h)
+{
+    demux_sys_t *sys = demux->p_sys;
+    xcb_connection_t *conn = sys->conn;
+    xcb_generic_event_t *ev;
+
+    /* Accumulate the bounding box of changes reported since the last grab */
+    while ((ev = xcb_poll_for_event (conn)) != NULL)
+    {
+        if ((ev->response_type & 0x7f) == sys->damage_event)
+        {
+            const xcb_damage_notify_event_t *dn =
+                (const xcb_damage_notify_event_t *)ev;
+
+            if (sys->dmg_x1 > dn->area.x)
+                sys->dmg_x1 = dn->area.x;
+            if (sys->dmg_y1 > dn->area.y)
+                sys->dmg_y1 = dn->area.y;
+            if (sys->dmg_x2 < dn->area.x + dn->area.width)
+                sys->dmg_x2 = dn->area.x + dn->area.width;
+            if (sys->dmg_y2 < dn->area.y + dn->area.height)
+                sys->dmg_y2 = dn->area.y + dn->area.height;
+        }
+        free (ev);
+    }
+
+    /* The frame must be fetched wholly if the region moved or resized */
+    bool full = sys->frame == NULL
+             || x != sys->frame_x || y != sys->frame_y;
+    int fx, fy;
+    unsigned fw, fh;
+
+    if (full)
+    {
+        fx = x;
+        fy = y;
+        fw = w;
+        fh = h;
+    }
+    else
+    {
+        /* Clip the dirty bounding box against the capture region */
+        int x2 = __MIN (sys->dmg_x2, x + (int)w);
+        int y2 = __MIN (sys->dmg_y2, y + (int)h);
+
+        fx = __MAX (sys->dmg_x1, x);
+        fy = __MAX (sys->dmg_y1, y);
+        if (fx >= x2 || fy >= y2)
+            return NULL; /* the visible area is unchanged */
+        fw = x2 - fx;
+        fh = y2 - fy;
+    }
+
+    /* Damage occurring from this point on is reported anew */
+    xcb_damage_subtract (conn, sys->damage, XCB_NONE, XCB_NONE);
+    sys->dmg_x1 = sys->dmg_y1 = INT16_MAX;
+    sys->dmg_x2 = sys->dmg_y2 = INT16_MIN;
+
+    xcb_get_image_reply_t *img = xcb_get_image_reply (conn,
+        xcb_get_image (conn, XCB_IMAGE_FORMAT_Z_PIXMAP, drawable,
+                       fx, fy, fw, fh, ~0), NULL);
+    if (img == NULL)
+        return NULL;
+
+    const size_t pitch = w * sys->bpp;
+    if (full)
+    {
+        free (sys->frame);
+        sys->frame = malloc (pitch * h);
+        if (unlikely(sys->frame == NULL))
+        {
+            free (img);
+            return NULL;
+        }
+        sys->frame_x = x;
+        sys->frame_y = y;
+    }
+
+    /* Composite the update into the persistent frame */
+    const uint8_t *in = xcb_get_image_data (img);
+    const size_t in_pitch = xcb_get_image_data_length (img) / fh;
+    uint8_t *out = sys->frame + (fy - y) * pitch + (fx - x) * sys->bpp;
+
+    for (unsigned i = 0; i < fh; i++)
+    {
+        memcpy (out, in, fw * sys->bpp);
+        in += in_pitch;
+        out += pitch;
+    }
+    free (img);
+
+    block_t *block = block_Alloc (pitch * h);
+    if (unlikely(block == NULL))
+        return NULL;
+    memcpy (block->p_buffer, sys->frame, pitch * h);
+    return block;
+}
+#endif
+
 /**
  * Processing callback
  */
@@ -429,6 +579,9 @@ discard:
             sys->cur_h = h;
             sys->bpp /= 8; /* bits -> bytes */
         }
+#ifdef HAVE_XCB_DAMAGE
+        FREENULL(sys->frame); /* force a full grab at the new dimensions */
+#endif
     }
 
     /* Capture screen */
@@ -437,6 +590,15 @@ discard:
     free (geo);
 
     block_t *block = NULL;
+#ifdef HAVE_XCB_DAMAGE
+    if (sys->use_damage)
+    {
+        block = DamageCapture (demux, drawable, x, y, w, h);
+        if (block == NULL)
+            return; /* nothing changed since the last frame (or error) */
+        goto send;
+    }
+#endif
 #ifdef HAVE_SYS_SHM_H
     if (sys->shm)
     {   /* Capture screen through shared memory */
@@ -502,6 +664,9 @@ noshm:
         block->i_buffer = datalen;
     }
 
+#ifdef HAVE_XCB_DAMAGE
+send:
+#endif
     /* Send block - zero copy */
     if (sys->es != NULL)
     {
@@ -75,6 +75,29 @@ vlc_module_begin()
     set_callbacks(Open, Close)
 vlc_module_end()
 
+/* Number of READ requests kept in flight and size of each. Several
+ * outstanding requests are needed to fill the bandwidth-delay product of
+ * high-latency links; the old single-request limit is kept per request. */
+#define VLC_SMB2_RA_DEPTH 4
+#define VLC_SMB2_RA_CHUNK (256 * 1024)
+
+enum vlc_smb2_slot_state
+{
+    VLC_SMB2_SLOT_FREE,    /**< No request, buffer reusable */
+    VLC_SMB2_SLOT_PENDING, /**< Request in flight */
+    VLC_SMB2_SLOT_DONE,    /**< Reply received */
+    VLC_SMB2_SLOT_ORPHAN,  /**< Flushed while in flight, free on reply */
+};
+
+struct vlc_smb2_slot
+{
+    stream_t *access;
+    enum vlc_smb2_slot_state state;
+    uint64_t offset; /**< File offset of the request */
+    ssize_t  res;    /**< Bytes read, 0 on EOF, < 0 on error */
+    uint8_t *buf;
+};
+
 struct access_sys
 {
     struct smb2_context *   smb2;
@@ -88,12 +111,11 @@ struct access_sys
     int                     error_status;
 
     bool res_done;
-    union {
-        struct
-        {
-            size_t len;
-        } read;
-    } res;
+
+    /* Pipelined reads (files only) */
+    struct vlc_smb2_slot    slots[VLC_SMB2_RA_DEPTH];
+    uint64_t                read_offset; /**< Position seen by the core */
+    uint64_t                ra_offset;   /**< Next offset to request */
 };
 
 static int
@@ -218,16 +240,90 @@ smb2_generic_cb(struct smb2_context *smb2, int status, void *data,
 }
 
 static void
-smb2_read_cb(struct smb2_context *smb2, int status, void *data,
-             void *private_data)
+smb2_pread_cb(struct smb2_context *smb2, int status, void *data,
+              void *private_data)
 {
+    VLC_UNUSED(smb2);
     VLC_UNUSED(data);
-    VLC_SMB2_GENERIC_CB();
+    struct vlc_smb2_slot *slot = private_data;
+    stream_t *access = slot->access;
 
-    if (status == 0)
-        sys->eof = true;
-    else
-        sys->res.read.len = status;
+    if (slot->state == VLC_SMB2_SLOT_ORPHAN)
+    {   /* The position was flushed while this request was in flight */
+        struct access_sys *sys = access->p_sys;
+        slot->state = VLC_SMB2_SLOT_FREE;
+        sys->res_done = true;
+        return;
+    }
+
+    smb2_check_status(access, status, "smb2_pread_async");
+    slot->res = status;
+    slot->state = VLC_SMB2_SLOT_DONE;
+}
+
+/** Issues read requests on every free slot until the pipeline is full */
+static void
+FileStartReads(stream_t *access)
+{
+    struct access_sys *sys = access->p_sys;
+
+    for (size_t i = 0; i < VLC_SMB2_RA_DEPTH; i++)
+    {
+        struct vlc_smb2_slot *slot = &sys->slots[i];
+
+        if (slot->state != VLC_SMB2_SLOT_FREE)
+            continue;
+        if (sys->error_status != 0 || sys->ra_offset >= sys->smb2_size)
+            break;
+
+        if (slot->buf == NULL)
+        {
+            slot->buf = malloc(VLC_SMB2_RA_CHUNK);
+            if (unlikely(slot->buf == NULL))
+                break;
+        }
+        slot->access = access;
+        slot->offset = sys->ra_offset;
+        if (smb2_pread_async(sys->smb2, sys->smb2fh, slot->buf,
+                             VLC_SMB2_RA_CHUNK, slot->offset,
+                             smb2_pread_cb, slot) < 0)
+        {
+            VLC_SMB2_SET_ERROR(access, "smb2_pread_async", 1);
+            break;
+        }
+        slot->state = VLC_SMB2_SLOT_PENDING;
+        sys->ra_offset += VLC_SMB2_RA_CHUNK;
+    }
+}
+
+/** Discards the content of the pipeline (i.e. before seeking) */
+static void
+FileFlushReads(stream_t *access)
+{
+    struct access_sys *sys = access->p_sys;
+
+    for (size_t i = 0; i < VLC_SMB2_RA_DEPTH; i++)
+    {
+        struct vlc_smb2_slot *slot = &sys->slots[i];
+
+        if (slot->state == VLC_SMB2_SLOT_PENDING)
+            slot->state = VLC_SMB2_SLOT_ORPHAN; /* freed by its callback */
+        else if (slot->state == VLC_SMB2_SLOT_DONE)
+            slot->state = VLC_SMB2_SLOT_FREE;
+    }
+}
+
+/** Waits for all in-flight requests; needed before closing the handle */
+static void
+FileDrainReads(stream_t *access)
+{
+    struct access_sys *sys = access->p_sys;
+
+    FileFlushReads(access);
+    for (size_t i = 0; i < VLC_SMB2_RA_DEPTH; i++)
+        while (sys->slots[i].state == VLC_SMB2_SLOT_ORPHAN)
+            if (vlc_smb2_mainloop(access, true) < 0)
+                return; /* connection is dead, no reply will come */
 }
 
 static ssize_t
@@ -238,27 +334,58 @@ FileRead(stream_t *access, void *buf, size_t len)
     if (sys->error_status != 0)
         return -1;
 
-    if (sys->eof)
+    if (sys->eof || sys->read_offset >= sys->smb2_size)
         return 0;
 
-    /* Limit the read size since smb2_read_async() will complete only after
-     * reading the whole requested data and not when whatever data is available
-     * (high read size means a faster I/O but a higher latency). */
-    if (len > 262144)
-        len = 262144;
+    FileStartReads(access);
 
-    sys->res.read.len = 0;
-    if (smb2_read_async(sys->smb2, sys->smb2fh, buf, len,
-                        smb2_read_cb, access) < 0)
+    /* Find the slot covering the current position. Requests are issued in
+     * file order, so it always exists unless issuing itself failed. */
+    struct vlc_smb2_slot *slot = NULL;
+    for (size_t i = 0; i < VLC_SMB2_RA_DEPTH; i++)
     {
-        VLC_SMB2_SET_ERROR(access, "smb2_read_async", 1);
-        return -1;
+        struct vlc_smb2_slot *s = &sys->slots[i];
+
+        if ((s->state == VLC_SMB2_SLOT_PENDING
+          || s->state == VLC_SMB2_SLOT_DONE)
+         && sys->read_offset >= s->offset
+         && sys->read_offset < s->offset + VLC_SMB2_RA_CHUNK)
+        {
+            slot = s;
+            break;
+        }
     }
+    if (slot == NULL)
+        return -1;
+
+    while (slot->state == VLC_SMB2_SLOT_PENDING)
+        if (vlc_smb2_mainloop(access, false) < 0)
+            return -1;
 
-    if (vlc_smb2_mainloop(access, false) < 0)
+    if (sys->error_status != 0 || slot->res < 0)
         return -1;
 
-    return sys->res.read.len;
+    size_t pos = sys->read_offset - slot->offset;
+    if ((size_t)slot->res <= pos)
+    {   /* Shorter file than advertised */
+        sys->eof = true;
+        return 0;
+    }
+
+    size_t avail = (size_t)slot->res - pos;
+    if (len > avail)
+        len = avail;
+    memcpy(buf, slot->buf + pos, len);
+    sys->read_offset += len;
+
+    if (pos + len == (size_t)slot->res)
+    {
+        /* A short reply can only happen at the end of the file */
+        if ((size_t)slot->res < VLC_SMB2_RA_CHUNK)
+            sys->eof = true;
+        slot->state = VLC_SMB2_SLOT_FREE;
+    }
+    return len;
 }
 
 static int
@@ -269,10 +396,11 @@ FileSeek(stream_t *access, uint64_t i_pos)
     if (sys->error_status != 0)
         return VLC_EGENERIC;
 
-    if (smb2_lseek(sys->smb2, sys->smb2fh, i_pos, SEEK_SET, NULL) < 0)
+    if (i_pos != sys->read_offset)
     {
-        VLC_SMB2_SET_ERROR(access, "smb2_seek_async", 1);
-        return VLC_EGENERIC;
+        FileFlushReads(access);
+        sys->read_offset = i_pos;
+        sys->ra_offset = i_pos;
     }
     sys->eof = false;
 
@@ -426,6 +554,9 @@ vlc_smb2_close_fh(stream_t *access)
 
     assert(sys->smb2fh);
 
+    /* No in-flight read may outlive the file handle (or its buffers) */
+    FileDrainReads(access);
+
     if (smb2_close_async(sys->smb2, sys->smb2fh, smb2_generic_cb, access) < 0)
     {
         VLC_SMB2_SET_ERROR(access, "smb2_close_async", 1);
@@ -764,5 +895,7 @@ Close(vlc_object_t *p_obj)
     vlc_smb2_disconnect_share(access);
     smb2_destroy_context(sys->smb2);
 
+    for (size_t i = 0; i < VLC_SMB2_RA_DEPTH; i++)
+        free(sys->slots[i].buf);
     vlc_UrlClean(&sys->encoded_url);
 }
@@ -33,6 +33,30 @@
 
 
 
+/* Maximum number of receive buffers kept around for reuse */
+#define SRT_POOL_DEPTH 8
+
+/* Receive buffers are recycled through a free list instead of hitting the
+ * allocator on every read. The pool is reference-counted (the access plus
+ * every block in flight) since blocks may outlive the access. */
+typedef struct
+{
+    vlc_mutex_t lock;
+    block_t    *p_free;  /* free receive buffers, linked via p_next */
+    unsigned    i_depth;
+    unsigned    i_refs;
+    size_t      i_size;  /* current receive buffer size */
+    bool        b_closed;
+} srt_block_pool_t;
+
+typedef struct
+{
+    block_t           block;
+    srt_block_pool_t *p_pool;
+    size_t            i_size; /* allocated payload size */
+    uint8_t           data[];
+} srt_pooled_block_t;
+
 typedef struct
 {
     SRTSOCKET   sock;
@@ -42,9 +66,96 @@ typedef struct
     char       *psz_host;
     int         i_port;
     int         i_chunks; /* Number of chunks to allocate in the next read */
+    size_t      i_chunk_size;
+    int         i_poll_timeout;
+    srt_block_pool_t *p_pool;
 } stream_sys_t;
 
+static void srt_block_pool_Release(srt_block_pool_t *p_pool)
+{
+    bool b_free;
+
+    vlc_mutex_lock( &p_pool->lock );
+    b_free = --p_pool->i_refs == 0;
+    vlc_mutex_unlock( &p_pool->lock );
+    if ( b_free )
+        free( p_pool );
+}
+
+static void srt_pooled_block_Free(block_t *p_block)
+{
+    srt_pooled_block_t *p_pooled =
+        container_of( p_block, srt_pooled_block_t, block );
+    srt_block_pool_t *p_pool = p_pooled->p_pool;
+    bool b_free;
+
+    vlc_mutex_lock( &p_pool->lock );
+    if ( !p_pool->b_closed && p_pooled->i_size == p_pool->i_size
+      && p_pool->i_depth < SRT_POOL_DEPTH )
+    {
+        p_block->p_next = p_pool->p_free;
+        p_pool->p_free = p_block;
+        p_pool->i_depth++;
+        p_pool->i_refs--;
+        vlc_mutex_unlock( &p_pool->lock );
+        return;
+    }
+    b_free = --p_pool->i_refs == 0;
+    vlc_mutex_unlock( &p_pool->lock );
+
+    free( p_pooled );
+    if ( b_free )
+        free( p_pool );
+}
+
+static const struct vlc_block_callbacks srt_pooled_block_cbs =
+{
+    srt_pooled_block_Free,
+};
+
+static block_t *srt_block_pool_Get(srt_block_pool_t *p_pool, size_t i_size)
+{
+    srt_pooled_block_t *p_pooled = NULL;
 
+    vlc_mutex_lock( &p_pool->lock );
+    if ( p_pool->i_size != i_size )
+    {
+        /* The receive buffer size changed: drop the stale free buffers */
+        while ( p_pool->p_free != NULL )
+        {
+            block_t *p_next = p_pool->p_free->p_next;
+            free( container_of( p_pool->p_free, srt_pooled_block_t, block ) );
+            p_pool->p_free = p_next;
+        }
+        p_pool->i_depth = 0;
+        p_pool->i_size = i_size;
+    }
+    else if ( p_pool->p_free != NULL )
+    {
+        p_pooled = container_of( p_pool->p_free, srt_pooled_block_t, block );
+        p_pool->p_free = p_pooled->block.p_next;
+        p_pool->i_depth--;
+    }
+    if ( p_pooled != NULL )
+        p_pool->i_refs++;
+    vlc_mutex_unlock( &p_pool->lock );
+
+    if ( p_pooled == NULL )
+    {
+        p_pooled = malloc( sizeof( *p_pooled ) + i_size );
+        if ( unlikely( p_pooled == NULL ) )
+            return NULL;
+        p_pooled->p_pool = p_pool;
+        p_pooled->i_size = i_size;
+
+        vlc_mutex_lock( &p_pool->lock );
+        p_pool->i_refs++;
+        vlc_mutex_unlock( &p_pool->lock );
+    }
+
+    return block_Init( &p_pooled->block, &srt_pooled_block_cbs,
+                       p_pooled->data, i_size );
+}
 
 static void srt_wait_interrupted(void *p_data)
 {
@@ -220,8 +331,7 @@ out:
 static block_t *BlockSRT(stream_t *p_stream, bool *restrict eof)
 {
     stream_sys_t *p_sys = p_stream->p_sys;
-    int i_chunk_size = var_InheritInteger( p_stream, "chunk-size" );
-    int i_poll_timeout = var_InheritInteger( p_stream, "poll-timeout" );
+    int i_poll_timeout = p_sys->i_poll_timeout;
     /* SRT doesn't have a concept of EOF for live streams. */
     VLC_UNUSED(eof);
 
@@ -234,10 +344,9 @@ static block_t *BlockSRT(stream_t *p_stream, bool *restrict eof)
     if ( p_sys->i_chunks == 0 )
         p_sys->i_chunks = SRT_MIN_CHUNKS_TRYREAD;
 
-    size_t i_chunk_size_actual = ( i_chunk_size > 0 )
-        ? i_chunk_size : SRT_DEFAULT_CHUNK_SIZE;
+    size_t i_chunk_size_actual = p_sys->i_chunk_size;
     size_t bufsize = i_chunk_size_actual * p_sys->i_chunks;
-    block_t *pkt = block_Alloc( bufsize );
+    block_t *pkt = srt_block_pool_Get( p_sys->p_pool, bufsize );
     if ( unlikely( pkt == NULL ) )
     {
         return NULL;
@@ -370,6 +479,20 @@ static int Open(vlc_object_t *p_this)
 
     vlc_UrlClean( &parsed_url );
 
+    /* These do not change while streaming: do not hit the variable
+     * subsystem on every read */
+    int i_chunk_size = var_InheritInteger( p_stream, SRT_PARAM_CHUNK_SIZE );
+    p_sys->i_chunk_size = ( i_chunk_size > 0 )
+        ? (size_t)i_chunk_size : SRT_DEFAULT_CHUNK_SIZE;
+    p_sys->i_poll_timeout = var_InheritInteger( p_stream,
+                                                SRT_PARAM_POLL_TIMEOUT );
+
+    p_sys->p_pool = calloc( 1, sizeof( *p_sys->p_pool ) );
+    if ( unlikely( p_sys->p_pool == NULL ) )
+        return VLC_ENOMEM;
+    vlc_mutex_init( &p_sys->p_pool->lock );
+    p_sys->p_pool->i_refs = 1;
+
     p_sys->i_poll_id = srt_epoll_create();
     if ( p_sys->i_poll_id == -1 )
     {
@@ -392,6 +515,7 @@ static int Open(vlc_object_t *p_this)
 failed:
     if ( p_sys->sock != -1 ) srt_close( p_sys->sock );
     if ( p_sys->i_poll_id != -1 ) srt_epoll_release( p_sys->i_poll_id );
+    if ( p_sys->p_pool != NULL ) srt_block_pool_Release( p_sys->p_pool );
 
     return VLC_EGENERIC;
 }
@@ -405,6 +529,20 @@ static void Close(vlc_object_t *p_this)
     srt_close( p_sys->sock );
     srt_epoll_release( p_sys->i_poll_id );
 
+    /* Blocks still in flight keep the pool alive until they are released */
+    vlc_mutex_lock( &p_sys->p_pool->lock );
+    p_sys->p_pool->b_closed = true;
+    while ( p_sys->p_pool->p_free != NULL )
+    {
+        block_t *p_next = p_sys->p_pool->p_free->p_next;
+        free( container_of( p_sys->p_pool->p_free, srt_pooled_block_t,
+                            block ) );
+        p_sys->p_pool->p_free = p_next;
+    }
+    p_sys->p_pool->i_depth = 0;
+    vlc_mutex_unlock( &p_sys->p_pool->lock );
+    srt_block_pool_Release( p_sys->p_pool );
+
     srt_cleanup();
 }
 
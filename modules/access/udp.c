@@ -53,12 +53,25 @@
  */
 #define MRU 65507u
 
+#ifdef HAVE_RECVMMSG
+/* Maximum number of datagrams per recvmmsg() call */
+# define UDP_BATCH_MAX 32
+#endif
+
 typedef struct {
     int fd;
     int timeout;
 
     size_t length;
     char *offset;
+#ifdef HAVE_RECVMMSG
+    unsigned count; /* datagrams received but not delivered yet */
+    unsigned next;  /* index of the next datagram to deliver */
+    unsigned batch; /* datagrams per recvmmsg() call, 1 to disable */
+    char *bufv;     /* batch receive buffers, batch * MRU bytes */
+    struct mmsghdr msgv[UDP_BATCH_MAX];
+    struct iovec iov[UDP_BATCH_MAX];
+#endif
     char buf[MRU];
 } access_sys_t;
 
@@ -83,6 +96,30 @@ static int Control(stream_t *access, int query, va_list args)
     return VLC_SUCCESS;
 }
 
+#ifdef HAVE_RECVMMSG
+static ssize_t DeliverDatagram(access_sys_t *sys, void *buf, size_t len)
+{
+    char *data = sys->bufv + sys->next * (size_t)MRU;
+    size_t size = sys->msgv[sys->next].msg_len;
+
+    sys->next++;
+    sys->count--;
+
+    if (size == 0) /* empty (0 bytes) payload does *not* mean EOF here */
+        return -1;
+
+    if (size > len) {
+        /* Buffer the tail of the datagram for the next call. The slot is
+         * only reused once both the tail and the whole batch are consumed. */
+        sys->offset = data + len;
+        sys->length = size - len;
+        size = len;
+    }
+    memcpy(buf, data, size);
+    return size;
+}
+#endif
+
 static ssize_t Read(stream_t *access, void *buf, size_t len)
 {
     access_sys_t *sys = access->p_sys;
@@ -97,6 +134,11 @@ static ssize_t Read(stream_t *access, void *buf, size_t len)
         return len;
     }
 
+#ifdef HAVE_RECVMMSG
+    if (sys->count > 0)
+        return DeliverDatagram(sys, buf, len);
+#endif
+
     struct pollfd ufd[1];
 
     ufd[0].fd = sys->fd;
@@ -110,6 +152,21 @@ static ssize_t Read(stream_t *access, void *buf, size_t len)
             return -1;
     }
 
+#ifdef HAVE_RECVMMSG
+    if (sys->batch > 1) {
+        /* Drain several queued datagrams per system call: during multicast
+         * bursts, the per-datagram system call overhead costs packets */
+        int n = recvmmsg(sys->fd, sys->msgv, sys->batch, MSG_WAITFORONE,
+                         NULL);
+        if (n <= 0)
+            return -1;
+
+        sys->count = n;
+        sys->next = 0;
+        return DeliverDatagram(sys, buf, len);
+    }
+#endif
+
     struct iovec iov[] = {
         { .iov_base = buf,      .iov_len = len, },
         { .iov_base = sys->buf, .iov_len = MRU, },
@@ -217,6 +274,40 @@ static int Open( vlc_object_t *p_this )
     if( sys->timeout > 0)
         sys->timeout *= 1000;
 
+#ifdef HAVE_RECVMMSG
+    sys->count = sys->next = 0;
+    sys->batch = 1;
+
+    int64_t i_batch = var_InheritInteger( p_access, "udp-batch" );
+    if( i_batch > UDP_BATCH_MAX )
+        i_batch = UDP_BATCH_MAX;
+    if( i_batch > 1 )
+    {
+        sys->bufv = vlc_obj_malloc( p_this, i_batch * (size_t)MRU );
+        if( sys->bufv != NULL )
+        {
+            sys->batch = i_batch;
+            for( unsigned i = 0; i < sys->batch; i++ )
+            {
+                memset( &sys->msgv[i], 0, sizeof( sys->msgv[i] ) );
+                sys->msgv[i].msg_hdr.msg_iov = &sys->iov[i];
+                sys->msgv[i].msg_hdr.msg_iovlen = 1;
+                sys->iov[i].iov_base = sys->bufv + i * (size_t)MRU;
+                sys->iov[i].iov_len = MRU;
+            }
+        }
+        /* else keep the single datagram receive path */
+    }
+#endif
+
+#ifdef SO_BUSY_POLL
+    int64_t i_busy = var_InheritInteger( p_access, "udp-busy-poll" );
+    if( i_busy > 0
+     && setsockopt( sys->fd, SOL_SOCKET, SO_BUSY_POLL,
+                    &(int){ i_busy }, sizeof (int) ) )
+        msg_Warn( p_access, "cannot enable busy polling" );
+#endif
+
     return VLC_SUCCESS;
 }
 
@@ -233,6 +324,19 @@ static void Close( vlc_object_t *p_this )
 
 #define TIMEOUT_TEXT N_("UDP Source timeout (sec)")
 
+#ifdef HAVE_RECVMMSG
+#define BATCH_TEXT N_("Receive batch size")
+#define BATCH_LONGTEXT N_( \
+    "Number of datagrams received per system call. " \
+    "Batching lowers the system call overhead during reception bursts.")
+#endif
+#ifdef SO_BUSY_POLL
+#define BUSY_POLL_TEXT N_("Busy polling timeout (microseconds)")
+#define BUSY_POLL_LONGTEXT N_( \
+    "Busy-poll the network device queue for this long before sleeping, " \
+    "trading CPU time for lower reception latency. 0 disables it.")
+#endif
+
 vlc_module_begin()
     set_shortname(N_("UDP"))
     set_description(N_("UDP input"))
@@ -242,6 +346,12 @@ vlc_module_begin()
     add_obsolete_integer("server-port") /* since 2.0.0 */
     add_obsolete_integer("udp-buffer") /* since 3.0.0 */
     add_integer("udp-timeout", -1, TIMEOUT_TEXT, NULL, true)
+#ifdef HAVE_RECVMMSG
+    add_integer("udp-batch", 8, BATCH_TEXT, BATCH_LONGTEXT, true)
+#endif
+#ifdef SO_BUSY_POLL
+    add_integer("udp-busy-poll", 0, BUSY_POLL_TEXT, BUSY_POLL_LONGTEXT, true)
+#endif
 
     set_capability("access", 0)
     add_shortcut("udp", "udpstream", "udp4", "udp6")
@@ -577,11 +577,68 @@ vlc_tick_t GetBufferPTS (const struct v4l2_buffer *buf)
     return pts;
 }
 
+struct vlc_v4l2_buffer
+{
+    block_t      block;
+    struct vlc_v4l2_buffers *pool;
+    uint32_t     index;
+    bool         held; /* owned downstream, neither mapped out nor queued */
+    void        *start;
+    size_t       length;
+};
+
+struct vlc_v4l2_buffers
+{
+    vlc_mutex_t  lock;
+    int          fd; /* capture device, -1 once streaming was stopped */
+    uint32_t     count;
+    size_t       inflight; /* buffers currently held downstream */
+    struct vlc_v4l2_buffer *bufs;
+};
+
+static void DestroyPool (struct vlc_v4l2_buffers *pool)
+{
+    free (pool->bufs);
+    free (pool);
+}
+
+static void ReleaseBuffer (block_t *block)
+{
+    struct vlc_v4l2_buffer *b = (struct vlc_v4l2_buffer *)block;
+    struct vlc_v4l2_buffers *pool = b->pool;
+    struct v4l2_buffer buf = {
+        .type = V4L2_BUF_TYPE_VIDEO_CAPTURE,
+        .memory = V4L2_MEMORY_MMAP,
+        .index = b->index,
+    };
+    bool last = false;
+
+    vlc_mutex_lock (&pool->lock);
+    b->held = false;
+    pool->inflight--;
+    if (pool->fd != -1)
+        /* Recycle the buffer: hand it back to the device driver */
+        v4l2_ioctl (pool->fd, VIDIOC_QBUF, &buf);
+    else
+    {   /* Streaming was stopped while this buffer was held downstream */
+        v4l2_munmap (b->start, b->length);
+        last = (pool->inflight == 0);
+    }
+    vlc_mutex_unlock (&pool->lock);
+
+    if (last)
+        DestroyPool (pool);
+}
+
+static const struct vlc_block_callbacks vlc_v4l2_buffer_cbs =
+{
+    ReleaseBuffer,
+};
+
 /*****************************************************************************
  * GrabVideo: Grab a video frame
  *****************************************************************************/
-block_t *GrabVideo (vlc_object_t *demux, int fd,
-                    const struct buffer_t *restrict bufv)
+block_t *GrabVideo (vlc_object_t *demux, struct vlc_v4l2_buffers *pool)
 {
     struct v4l2_buffer buf = {
         .type = V4L2_BUF_TYPE_VIDEO_CAPTURE,
@@ -589,7 +646,7 @@ block_t *GrabVideo (vlc_object_t *demux, int fd,
     };
 
     /* Wait for next frame */
-    if (v4l2_ioctl (fd, VIDIOC_DQBUF, &buf) < 0)
+    if (v4l2_ioctl (pool->fd, VIDIOC_DQBUF, &buf) < 0)
     {
         switch (errno)
         {
@@ -604,20 +661,18 @@ block_t *GrabVideo (vlc_object_t *demux, int fd,
         }
     }
 
-    /* Copy frame */
-    block_t *block = block_Alloc (buf.bytesused);
-    if (unlikely(block == NULL))
-        return NULL;
+    /* Hand the buffer mapping downstream as is. It goes back to the device
+     * queue when the last reference to the block is released. */
+    struct vlc_v4l2_buffer *b = pool->bufs + buf.index;
+    block_t *block = block_Init (&b->block, &vlc_v4l2_buffer_cbs,
+                                 b->start, b->length);
+    block->i_buffer = buf.bytesused;
     block->i_pts = block->i_dts = GetBufferPTS (&buf);
-    memcpy (block->p_buffer, bufv[buf.index].start, buf.bytesused);
 
-    /* Unlock */
-    if (v4l2_ioctl (fd, VIDIOC_QBUF, &buf) < 0)
-    {
-        msg_Err (demux, "queue error: %s", vlc_strerror_c(errno));
-        block_Release (block);
-        return NULL;
-    }
+    vlc_mutex_lock (&pool->lock);
+    b->held = true;
+    pool->inflight++;
+    vlc_mutex_unlock (&pool->lock);
     return block;
 }
 
@@ -648,13 +703,14 @@ int StartUserPtr (vlc_object_t *obj, int fd)
 
 /**
  * Allocates memory-mapped buffers, queues them and start streaming.
- * @param n requested buffers count [IN], allocated buffers count [OUT]
- * @return array of allocated buffers (use free()), or NULL on error.
+ * The buffers count is taken from the \ref CFG_PREFIX "buffers" variable.
+ * @return the buffers pool (release with StopMmap()), or NULL on error.
  */
-struct buffer_t *StartMmap (vlc_object_t *obj, int fd, uint32_t *restrict n)
+struct vlc_v4l2_buffers *StartMmap (vlc_object_t *obj, int fd)
 {
+    int64_t requested = var_InheritInteger (obj, CFG_PREFIX"buffers");
     struct v4l2_requestbuffers req = {
-        .count = *n,
+        .count = VLC_CLIP(requested, 2, 32),
         .type = V4L2_BUF_TYPE_VIDEO_CAPTURE,
         .memory = V4L2_MEMORY_MMAP,
     };
@@ -671,13 +727,25 @@ struct buffer_t *StartMmap (vlc_object_t *obj, int fd, uint32_t *restrict n)
         return NULL;
     }
 
-    struct buffer_t *bufv = vlc_alloc (req.count, sizeof (*bufv));
-    if (unlikely(bufv == NULL))
+    struct vlc_v4l2_buffers *pool = malloc (sizeof (*pool));
+    if (unlikely(pool == NULL))
         return NULL;
 
+    pool->bufs = vlc_alloc (req.count, sizeof (*pool->bufs));
+    if (unlikely(pool->bufs == NULL))
+    {
+        free (pool);
+        return NULL;
+    }
+
+    vlc_mutex_init (&pool->lock);
+    pool->fd = fd;
+    pool->inflight = 0;
+
     uint32_t bufc = 0;
     while (bufc < req.count)
     {
+        struct vlc_v4l2_buffer *b = pool->bufs + bufc;
         struct v4l2_buffer buf = {
             .type = V4L2_BUF_TYPE_VIDEO_CAPTURE,
             .memory = V4L2_MEMORY_MMAP,
@@ -691,15 +759,18 @@ struct buffer_t *StartMmap (vlc_object_t *obj, int fd, uint32_t *restrict n)
             goto error;
         }
 
-        bufv[bufc].start = v4l2_mmap (NULL, buf.length, PROT_READ | PROT_WRITE,
-                                      MAP_SHARED, fd, buf.m.offset);
-        if (bufv[bufc].start == MAP_FAILED)
+        b->start = v4l2_mmap (NULL, buf.length, PROT_READ | PROT_WRITE,
+                              MAP_SHARED, fd, buf.m.offset);
+        if (b->start == MAP_FAILED)
         {
             msg_Err (obj, "cannot map buffer %"PRIu32": %s", bufc,
                      vlc_strerror_c(errno));
             goto error;
         }
-        bufv[bufc].length = buf.length;
+        b->length = buf.length;
+        b->pool = pool;
+        b->index = bufc;
+        b->held = false;
         bufc++;
 
         /* Some drivers refuse to queue buffers before they are mapped. Bug? */
@@ -717,20 +788,33 @@ struct buffer_t *StartMmap (vlc_object_t *obj, int fd, uint32_t *restrict n)
         msg_Err (obj, "cannot start streaming: %s", vlc_strerror_c(errno));
         goto error;
     }
-    *n = bufc;
-    return bufv;
+    pool->count = bufc;
+    msg_Dbg (obj, "streaming with %"PRIu32" memory-mapped buffers", bufc);
+    return pool;
 error:
-    StopMmap (fd, bufv, bufc);
+    for (uint32_t i = 0; i < bufc; i++)
+        v4l2_munmap (pool->bufs[i].start, pool->bufs[i].length);
+    DestroyPool (pool);
     return NULL;
 }
 
-void StopMmap (int fd, struct buffer_t *bufv, uint32_t bufc)
+void StopMmap (struct vlc_v4l2_buffers *pool)
 {
     enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    bool last;
 
+    vlc_mutex_lock (&pool->lock);
     /* STREAMOFF implicitly dequeues all buffers */
-    v4l2_ioctl (fd, VIDIOC_STREAMOFF, &type);
-    for (uint32_t i = 0; i < bufc; i++)
-        v4l2_munmap (bufv[i].start, bufv[i].length);
-    free (bufv);
+    v4l2_ioctl (pool->fd, VIDIOC_STREAMOFF, &type);
+    pool->fd = -1;
+
+    /* Buffers still held downstream are unmapped by their release callback */
+    for (uint32_t i = 0; i < pool->count; i++)
+        if (!pool->bufs[i].held)
+            v4l2_munmap (pool->bufs[i].start, pool->bufs[i].length);
+    last = (pool->inflight == 0);
+    vlc_mutex_unlock (&pool->lock);
+
+    if (last)
+        DestroyPool (pool);
 }
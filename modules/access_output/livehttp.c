@@ -160,6 +160,8 @@ static const char *const ppsz_sout_options[] = {
 };
 
 static ssize_t Write( sout_access_out_t *, block_t * );
+static ssize_t WriteBlocks( sout_access_out_t *, block_t * );
+static void *WriterThread( void * );
 static int Control( sout_access_out_t *, int, va_list );
 
 typedef struct output_segment
@@ -202,6 +204,29 @@ typedef struct
     uint8_t stuffing_bytes[16];
     ssize_t stuffing_size;
     vlc_array_t segments_t;
+
+    /* Asynchronous writer thread. All segment I/O (open/write/close and
+     * index publication) runs there so a slow origin disk backpressures the
+     * queue, not the mux thread. Only the queue and flags below are shared;
+     * everything above is owned by the writer once the thread is running. */
+    vlc_thread_t thread;
+    bool b_thread;
+    vlc_mutex_t lock;
+    vlc_cond_t wait;
+    block_t *queue;
+    block_t **queue_end;
+    bool b_eof;
+    bool b_error;
+
+    /* Segment size bookkeeping for preallocation */
+    uint64_t i_seg_bytes; /**< bytes written to the current segment */
+    uint64_t i_last_seg_bytes; /**< size of the last finished segment */
+    bool b_seg_preallocated;
+
+    /* Write latency statistics (writer thread only) */
+    vlc_tick_t write_time_total;
+    vlc_tick_t write_time_max;
+    uint64_t write_count;
 } sout_access_out_sys_t;
 
 static int LoadCryptFile( sout_access_out_t *p_access);
@@ -296,9 +321,23 @@ static int Open( vlc_object_t *p_this )
     p_sys->i_segment = p_sys->i_initial_segment-1;
     p_sys->psz_cursegPath = NULL;
 
+    vlc_mutex_init( &p_sys->lock );
+    vlc_cond_init( &p_sys->wait );
+    p_sys->queue = NULL;
+    p_sys->queue_end = &p_sys->queue;
+
     p_access->pf_write = Write;
     p_access->pf_control = Control;
 
+    p_sys->b_thread = !vlc_clone( &p_sys->thread, WriterThread, p_access,
+                                  VLC_THREAD_PRIORITY_OUTPUT );
+    if( !p_sys->b_thread )
+    {
+        /* Degrade to synchronous writes on the caller thread */
+        msg_Warn( p_access, "cannot spawn writer thread, writing synchronously" );
+        p_access->pf_write = WriteBlocks;
+    }
+
     return VLC_SUCCESS;
 }
 
@@ -722,10 +761,21 @@ static void closeCurrentSegment( sout_access_out_t *p_access, sout_access_out_sy
             int ret = vlc_write( p_sys->i_handle, p_sys->stuffing_bytes, 16 );
             if( ret != 16 )
                 msg_Err( p_access, "Couldn't write 16 bytes" );
+            else
+                p_sys->i_seg_bytes += 16;
             }
             p_sys->stuffing_size = 0;
         }
 
+        if( p_sys->b_seg_preallocated )
+        {
+            /* Drop the preallocated tail past what was actually written */
+            if( ftruncate( p_sys->i_handle, p_sys->i_seg_bytes ) )
+                msg_Warn( p_access, "cannot truncate segment: %s",
+                          vlc_strerror_c(errno) );
+            p_sys->b_seg_preallocated = false;
+        }
+        p_sys->i_last_seg_bytes = p_sys->i_seg_bytes;
 
         vlc_close( p_sys->i_handle );
         p_sys->i_handle = -1;
@@ -757,6 +807,21 @@ static void Close( vlc_object_t * p_this )
     sout_access_out_t *p_access = (sout_access_out_t*)p_this;
     sout_access_out_sys_t *p_sys = p_access->p_sys;
 
+    if( p_sys->b_thread )
+    {
+        vlc_mutex_lock( &p_sys->lock );
+        p_sys->b_eof = true;
+        vlc_cond_signal( &p_sys->wait );
+        vlc_mutex_unlock( &p_sys->lock );
+        vlc_join( p_sys->thread, NULL );
+    }
+
+    if( p_sys->write_count )
+        msg_Dbg( p_access, "write latency: %"PRIu64" writes, "
+                 "%"PRId64" us mean, %"PRId64" us max", p_sys->write_count,
+                 US_FROM_VLC_TICK( p_sys->write_time_total / p_sys->write_count ),
+                 US_FROM_VLC_TICK( p_sys->write_time_max ) );
+
     if( p_sys->ongoing_segment )
         block_ChainLastAppend( &p_sys->full_segments_end, p_sys->ongoing_segment );
     p_sys->ongoing_segment = NULL;
@@ -771,7 +836,7 @@ static void Close( vlc_object_t * p_this )
         block_t *p_next = output_block->p_next;
         output_block->p_next = NULL;
 
-        Write( p_access, output_block );
+        WriteBlocks( p_access, output_block );
         output_block = p_next;
     }
     if( p_sys->ongoing_segment )
@@ -875,6 +940,15 @@ static ssize_t openNextFile( sout_access_out_t *p_access, sout_access_out_sys_t
         return -1;
     }
 
+#ifdef HAVE_POSIX_FALLOCATE
+    /* Preallocate using the previous segment size as an estimate, to avoid
+       incremental extent allocation while the segment is written. The file
+       is truncated back to its real size when the segment is closed. */
+    p_sys->b_seg_preallocated = p_sys->i_last_seg_bytes > 0 &&
+        posix_fallocate( fd, 0, p_sys->i_last_seg_bytes ) == 0;
+#endif
+    p_sys->i_seg_bytes = 0;
+
     vlc_array_append_or_abort( &p_sys->segments_t, segment );
 
     if( p_sys->psz_keyfile )
@@ -921,7 +995,8 @@ static int CheckSegmentChange( sout_access_out_t *p_access, block_t *p_buffer )
             return -1;
         }
         closeCurrentSegment( p_access, p_sys, false );
-        return writevalue;
+        /* Fall through: pre-open the next segment right away instead of
+           waiting for its first blocks */
     }
 
     if ( unlikely( p_sys->i_handle < 0 ) )
@@ -980,13 +1055,20 @@ static ssize_t writeSegment( sout_access_out_t *p_access )
 
         }
 
+        vlc_tick_t write_time = vlc_tick_now();
         ssize_t val = vlc_write( p_sys->i_handle, output->p_buffer, output->i_buffer );
+        write_time = vlc_tick_now() - write_time;
+        p_sys->write_time_total += write_time;
+        if ( write_time > p_sys->write_time_max )
+            p_sys->write_time_max = write_time;
+        p_sys->write_count++;
         if ( val == -1 )
         {
            if ( errno == EINTR )
               continue;
            return -1;
         }
+        p_sys->i_seg_bytes += val;
 
 
         if ( (size_t)val >= output->i_buffer )
@@ -1007,9 +1089,9 @@ static ssize_t writeSegment( sout_access_out_t *p_access )
 }
 
 /*****************************************************************************
- * Write: standard write on a file descriptor.
+ * WriteBlocks: segment a block chain and write it out (writer thread)
  *****************************************************************************/
-static ssize_t Write( sout_access_out_t *p_access, block_t *p_buffer )
+static ssize_t WriteBlocks( sout_access_out_t *p_access, block_t *p_buffer )
 {
     size_t i_write = 0;
     sout_access_out_sys_t *p_sys = p_access->p_sys;
@@ -1043,3 +1125,79 @@ static ssize_t Write( sout_access_out_t *p_access, block_t *p_buffer )
 
     return i_write;
 }
+
+/*****************************************************************************
+ * WriterThread: drain the queue, so disk latency never stalls the mux
+ *****************************************************************************/
+static void *WriterThread( void *p_data )
+{
+    sout_access_out_t *p_access = p_data;
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
+    int canc = vlc_savecancel();
+
+    vlc_mutex_lock( &p_sys->lock );
+    for( ;; )
+    {
+        while( p_sys->queue == NULL && !p_sys->b_eof )
+            vlc_cond_wait( &p_sys->wait, &p_sys->lock );
+        if( p_sys->queue == NULL )
+            break; /* end of stream */
+
+        block_t *p_chain = p_sys->queue;
+        p_sys->queue = NULL;
+        p_sys->queue_end = &p_sys->queue;
+        vlc_mutex_unlock( &p_sys->lock );
+
+        ssize_t ret = WriteBlocks( p_access, p_chain );
+
+        vlc_mutex_lock( &p_sys->lock );
+        if( unlikely( ret < 0 ) )
+        {
+            p_sys->b_error = true;
+            break;
+        }
+    }
+
+    /* On error, keep releasing whatever the mux still queues until close */
+    while( !p_sys->b_eof || p_sys->queue != NULL )
+    {
+        if( p_sys->queue != NULL )
+        {
+            block_ChainRelease( p_sys->queue );
+            p_sys->queue = NULL;
+            p_sys->queue_end = &p_sys->queue;
+        }
+        else
+            vlc_cond_wait( &p_sys->wait, &p_sys->lock );
+    }
+    vlc_mutex_unlock( &p_sys->lock );
+
+    vlc_restorecancel( canc );
+    return NULL;
+}
+
+/*****************************************************************************
+ * Write: queue the blocks for the writer thread (mux thread)
+ *****************************************************************************/
+static ssize_t Write( sout_access_out_t *p_access, block_t *p_buffer )
+{
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
+    size_t i_size = 0;
+
+    for( block_t *p_block = p_buffer; p_block; p_block = p_block->p_next )
+        i_size += p_block->i_buffer;
+
+    vlc_mutex_lock( &p_sys->lock );
+    if( unlikely( p_sys->b_error ) )
+    {
+        vlc_mutex_unlock( &p_sys->lock );
+        block_ChainRelease( p_buffer );
+        msg_Err( p_access, "Error in write loop");
+        return -1;
+    }
+    block_ChainLastAppend( &p_sys->queue_end, p_buffer );
+    vlc_cond_signal( &p_sys->wait );
+    vlc_mutex_unlock( &p_sys->lock );
+
+    return i_size;
+}
@@ -47,6 +47,10 @@
 #   include <sys/socket.h>
 #endif
 
+#ifdef __linux__
+#   include <linux/net_tstamp.h>
+#endif
+
 #include <vlc_network.h>
 
 #define MAX_EMPTY_BLOCKS 200
@@ -71,6 +75,22 @@ static void Close( vlc_object_t * );
                           "helps reducing the scheduling load on " \
                           "heavily-loaded systems." )
 
+#define PACE_TEXT N_("Smooth out bursts")
+#define PACE_LONGTEXT N_("Spread the packets of each group over the " \
+    "interval until the next group instead of sending them back-to-back. " \
+    "This eliminates microbursts that some receivers drop." )
+
+#define SPACING_TEXT N_("Inter-packet spacing (microseconds)")
+#define SPACING_LONGTEXT N_("Time between two consecutive packets when " \
+    "smoothing is enabled. When set to 0, the spacing is derived from " \
+    "the stream timestamps." )
+
+#define TXTIME_TEXT N_("Kernel transmit time scheduling")
+#define TXTIME_LONGTEXT N_("Attach a transmission time to each packet and " \
+    "let the Linux ETF queueing discipline schedule it, with hardware " \
+    "timestamping where the network interface supports it. Requires an " \
+    "ETF qdisc on the egress interface." )
+
 vlc_module_begin ()
     set_description( N_("UDP stream output") )
     set_shortname( "UDP" )
@@ -79,6 +99,13 @@ vlc_module_begin ()
     add_integer( SOUT_CFG_PREFIX "caching", DEFAULT_PTS_DELAY / 1000, CACHING_TEXT, CACHING_LONGTEXT, true )
     add_integer( SOUT_CFG_PREFIX "group", 1, GROUP_TEXT, GROUP_LONGTEXT,
                                  true )
+    add_bool( SOUT_CFG_PREFIX "pace", false, PACE_TEXT, PACE_LONGTEXT, true )
+    add_integer( SOUT_CFG_PREFIX "spacing", 0, SPACING_TEXT, SPACING_LONGTEXT,
+                                 true )
+#if defined (SO_TXTIME)
+    add_bool( SOUT_CFG_PREFIX "txtime", false, TXTIME_TEXT, TXTIME_LONGTEXT,
+                                 true )
+#endif
 
     set_capability( "sout access", 0 )
     add_shortcut( "udp" )
@@ -92,6 +119,11 @@ vlc_module_end ()
 static const char *const ppsz_sout_options[] = {
     "caching",
     "group",
+    "pace",
+    "spacing",
+#if defined (SO_TXTIME)
+    "txtime",
+#endif
     NULL
 };
 
@@ -113,6 +145,7 @@ typedef struct
     vlc_tick_t    i_caching;
     int           i_handle;
     bool          b_mtu_warning;
+    bool          b_txtime;
     bool          dead;
     size_t        i_mtu;
 
@@ -208,6 +241,22 @@ static int Open( vlc_object_t *p_this )
     p_sys->i_handle = i_handle;
     p_sys->i_mtu = var_CreateGetInteger( p_this, "mtu" );
     p_sys->b_mtu_warning = false;
+    p_sys->b_txtime = false;
+#if defined (SO_TXTIME)
+    if( var_GetBool( p_access, SOUT_CFG_PREFIX "txtime" ) )
+    {
+        struct sock_txtime txtime = {
+            .clockid = CLOCK_MONOTONIC, /* the vlc_tick_t clock on Linux */
+        };
+
+        if( setsockopt( i_handle, SOL_SOCKET, SO_TXTIME,
+                        &txtime, sizeof (txtime) ) == 0 )
+            p_sys->b_txtime = true;
+        else
+            msg_Warn( p_access, "cannot enable SO_TXTIME: %s",
+                      vlc_strerror_c(errno) );
+    }
+#endif
     p_sys->dead = false;
     vlc_queue_Init(&p_sys->queue, offsetof (block_t, p_next));
     p_sys->p_buffer = NULL;
@@ -349,21 +398,68 @@ static ssize_t Write( sout_access_out_t *p_access, block_t *p_buffer )
 /*****************************************************************************
  * ThreadWrite: Write a packet on the network at the good time.
  *****************************************************************************/
+/* Maximum number of packets aggregated in one burst */
+#define UDP_BATCH_MAX 32
+/* Packets due within this window belong to the same burst */
+#define UDP_BATCH_WINDOW VLC_TICK_FROM_MS(2)
+
+#if defined (SO_TXTIME)
+static ssize_t SendTxtime( int fd, const block_t *p_pk, vlc_tick_t i_date )
+{
+    struct iovec iov = {
+        .iov_base = p_pk->p_buffer,
+        .iov_len = p_pk->i_buffer,
+    };
+    char control[CMSG_SPACE(sizeof (uint64_t))];
+    struct msghdr hdr = {
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = control,
+        .msg_controllen = sizeof (control),
+    };
+    uint64_t ns = NS_FROM_VLC_TICK( i_date );
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR( &hdr );
+
+    memset( control, 0, sizeof (control) );
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_TXTIME;
+    cmsg->cmsg_len = CMSG_LEN(sizeof (ns));
+    memcpy( CMSG_DATA( cmsg ), &ns, sizeof (ns) );
+
+    return sendmsg( fd, &hdr, 0 );
+}
+#endif
+
 static void* ThreadWrite( void *data )
 {
     sout_access_out_t *p_access = data;
     sout_access_out_sys_t *p_sys = p_access->p_sys;
     vlc_tick_t i_date_last = -1;
-    const unsigned i_group = var_GetInteger( p_access,
-                                             SOUT_CFG_PREFIX "group" );
-    int i_to_send = i_group;
+    const bool b_pace = var_GetBool( p_access, SOUT_CFG_PREFIX "pace" );
+    const vlc_tick_t i_spacing = VLC_TICK_FROM_US(
+                   var_GetInteger( p_access, SOUT_CFG_PREFIX "spacing" ) );
+    unsigned i_burst = var_GetInteger( p_access, SOUT_CFG_PREFIX "group" );
     unsigned i_dropped_packets = 0;
+    block_t *p_next = NULL;
     block_t *p_pk;
 
-    while ((p_pk = vlc_queue_DequeueKillable(&p_sys->queue,
-                                             &p_sys->dead)) != NULL)
+    if( i_burst < 1 )
+        i_burst = 1;
+    else if( i_burst > UDP_BATCH_MAX )
+        i_burst = UDP_BATCH_MAX;
+
+    for( ;; )
     {
-        vlc_tick_t    i_date;
+        block_t *batch[UDP_BATCH_MAX];
+        unsigned n = 0;
+        vlc_tick_t i_date;
+
+        p_pk = p_next;
+        p_next = NULL;
+        if( p_pk == NULL )
+            p_pk = vlc_queue_DequeueKillable( &p_sys->queue, &p_sys->dead );
+        if( p_pk == NULL )
+            break;
 
         i_date = p_sys->i_caching + p_pk->i_dts;
         if( i_date_last > 0 )
@@ -387,15 +483,100 @@ static void* ThreadWrite( void *data )
                              i_date_last - i_date );
             }
         }
+        batch[n++] = p_pk;
+
+        /* Aggregate the packets due together, so that a group costs a
+         * single system call where sendmmsg() is available and so that
+         * the pacer can spread a whole burst. */
+        while( n < i_burst )
+        {
+            vlc_queue_Lock( &p_sys->queue );
+            p_pk = vlc_queue_IsEmpty( &p_sys->queue ) ? NULL
+                 : vlc_queue_DequeueUnlocked( &p_sys->queue );
+            vlc_queue_Unlock( &p_sys->queue );
+            if( p_pk == NULL )
+                break;
+            if( ( p_pk->i_flags & BLOCK_FLAG_CLOCK )
+             || p_sys->i_caching + p_pk->i_dts > i_date + UDP_BATCH_WINDOW )
+            {
+                p_next = p_pk; /* starts the next burst */
+                break;
+            }
+            batch[n++] = p_pk;
+        }
+
+        /* Token bucket refill interval: configured spacing, or the time
+         * left until the next burst divided by the burst size */
+        vlc_tick_t i_pace = i_spacing;
+        if( b_pace && i_pace == 0 && p_next != NULL )
+        {
+            vlc_tick_t i_date_next = p_sys->i_caching + p_next->i_dts;
+            if( i_date_next > i_date )
+                i_pace = ( i_date_next - i_date ) / n;
+        }
 
-        i_to_send--;
-        if( !i_to_send || (p_pk->i_flags & BLOCK_FLAG_CLOCK) )
+#if defined (SO_TXTIME)
+        if( p_sys->b_txtime )
+        {
+            /* The ETF qdisc schedules each packet at its transmission
+             * time: no need to wait in user space. */
+            for( unsigned i = 0; i < n; i++ )
+                if( SendTxtime( p_sys->i_handle, batch[i],
+                                i_date + i * i_pace ) == -1 )
+                    msg_Warn( p_access, "send error: %s",
+                              vlc_strerror_c(errno) );
+        }
+        else
+#endif
+        if( b_pace && i_pace > 0 )
+        {
+            /* One packet per refill interval instead of a microburst */
+            for( unsigned i = 0; i < n; i++ )
+            {
+                vlc_tick_wait( i_date + i * i_pace );
+                if( send( p_sys->i_handle, batch[i]->p_buffer,
+                          batch[i]->i_buffer, 0 ) == -1 )
+                    msg_Warn( p_access, "send error: %s",
+                              vlc_strerror_c(errno) );
+            }
+        }
+        else
         {
             vlc_tick_wait( i_date );
-            i_to_send = i_group;
+#ifdef HAVE_SENDMMSG
+            struct iovec iov[UDP_BATCH_MAX];
+            struct mmsghdr msgv[UDP_BATCH_MAX];
+            unsigned sent = 0;
+
+            for( unsigned i = 0; i < n; i++ )
+            {
+                iov[i].iov_base = batch[i]->p_buffer;
+                iov[i].iov_len = batch[i]->i_buffer;
+                memset( &msgv[i], 0, sizeof (msgv[i]) );
+                msgv[i].msg_hdr.msg_iov = iov + i;
+                msgv[i].msg_hdr.msg_iovlen = 1;
+            }
+
+            while( sent < n )
+            {
+                int val = sendmmsg( p_sys->i_handle, msgv + sent,
+                                    n - sent, 0 );
+                if( val <= 0 )
+                {
+                    msg_Warn( p_access, "send error: %s",
+                              vlc_strerror_c(errno) );
+                    break;
+                }
+                sent += val;
+            }
+#else
+            for( unsigned i = 0; i < n; i++ )
+                if( send( p_sys->i_handle, batch[i]->p_buffer,
+                          batch[i]->i_buffer, 0 ) == -1 )
+                    msg_Warn( p_access, "send error: %s",
+                              vlc_strerror_c(errno) );
+#endif
         }
-        if ( send( p_sys->i_handle, p_pk->p_buffer, p_pk->i_buffer, 0 ) == -1 )
-            msg_Warn( p_access, "send error: %s", vlc_strerror_c(errno) );
 
         if( i_dropped_packets )
         {
@@ -414,8 +595,8 @@ static void* ThreadWrite( void *data )
         }
 #endif
 
-        block_Release( p_pk );
-
+        for( unsigned i = 0; i < n; i++ )
+            block_Release( batch[i] );
     }
     return NULL;
 }
@@ -37,6 +37,8 @@
 #include <vlc_filter.h>
 #include <vlc_block.h>
 
+#include "../fir_conv.h"
+
 /*****************************************************************************
  * Local prototypes
  *****************************************************************************/
@@ -103,10 +105,12 @@ struct atomic_operation_t
 
 typedef struct
 {
-    size_t i_overflow_buffer_size;/* in bytes */
-    float * p_overflow_buffer;
-    unsigned int i_nb_atomic_operations;
-    struct atomic_operation_t * p_atomic_operations;
+    /* One partitioned-convolution engine per (source channel, ear) pair;
+     * engine [2 * i_source + i_ear] holds the delay/attenuation taps of
+     * that virtual speaker as an impulse response. */
+    unsigned int i_nb_sources;
+    fir_conv_t ** pp_conv;
+    unsigned int i_latency; /* engine delay in samples, reported via pts */
 } filter_sys_t;
 
 /*****************************************************************************
@@ -127,7 +131,7 @@ typedef struct
  *
  *          x-axis
  *  */
-static void ComputeChannelOperations( filter_sys_t * p_data
+static void ComputeChannelOperations( struct atomic_operation_t * p_ops
         , unsigned int i_rate, unsigned int i_next_atomic_operation
         , int i_source_channel_offset, double d_x, double d_z
         , double d_compensation_length, double d_channel_amplitude_factor )
@@ -136,50 +140,50 @@ static void ComputeChannelOperations( filter_sys_t * p_data
     double d_compensation_delay = (d_compensation_length-0.1) / d_c * i_rate;
 
     /* Left ear */
-    p_data->p_atomic_operations[i_next_atomic_operation]
+    p_ops[i_next_atomic_operation]
         .i_source_channel_offset = i_source_channel_offset;
-    p_data->p_atomic_operations[i_next_atomic_operation]
+    p_ops[i_next_atomic_operation]
         .i_dest_channel_offset = 0;/* left */
-    p_data->p_atomic_operations[i_next_atomic_operation]
+    p_ops[i_next_atomic_operation]
         .i_delay = (int)( sqrt( (-0.1-d_x)*(-0.1-d_x) + (0-d_z)*(0-d_z) )
                           / d_c * i_rate - d_compensation_delay );
     if( d_x < 0 )
     {
-        p_data->p_atomic_operations[i_next_atomic_operation]
+        p_ops[i_next_atomic_operation]
             .d_amplitude_factor = d_channel_amplitude_factor * 1.1 / 2;
     }
     else if( d_x > 0 )
     {
-        p_data->p_atomic_operations[i_next_atomic_operation]
+        p_ops[i_next_atomic_operation]
             .d_amplitude_factor = d_channel_amplitude_factor * 0.9 / 2;
     }
     else
     {
-        p_data->p_atomic_operations[i_next_atomic_operation]
+        p_ops[i_next_atomic_operation]
             .d_amplitude_factor = d_channel_amplitude_factor / 2;
     }
 
     /* Right ear */
-    p_data->p_atomic_operations[i_next_atomic_operation + 1]
+    p_ops[i_next_atomic_operation + 1]
         .i_source_channel_offset = i_source_channel_offset;
-    p_data->p_atomic_operations[i_next_atomic_operation + 1]
+    p_ops[i_next_atomic_operation + 1]
         .i_dest_channel_offset = 1;/* right */
-    p_data->p_atomic_operations[i_next_atomic_operation + 1]
+    p_ops[i_next_atomic_operation + 1]
         .i_delay = (int)( sqrt( (0.1-d_x)*(0.1-d_x) + (0-d_z)*(0-d_z) )
                           / d_c * i_rate - d_compensation_delay );
     if( d_x < 0 )
     {
-        p_data->p_atomic_operations[i_next_atomic_operation + 1]
+        p_ops[i_next_atomic_operation + 1]
             .d_amplitude_factor = d_channel_amplitude_factor * 0.9 / 2;
     }
     else if( d_x > 0 )
     {
-        p_data->p_atomic_operations[i_next_atomic_operation + 1]
+        p_ops[i_next_atomic_operation + 1]
             .d_amplitude_factor = d_channel_amplitude_factor * 1.1 / 2;
     }
     else
     {
-        p_data->p_atomic_operations[i_next_atomic_operation + 1]
+        p_ops[i_next_atomic_operation + 1]
             .d_amplitude_factor = d_channel_amplitude_factor / 2;
     }
 }
@@ -192,6 +196,8 @@ static int Init( vlc_object_t *p_this, filter_sys_t * p_data
     double d_z = d_x;
     double d_z_rear = -d_x/3;
     double d_min = 0;
+    unsigned int i_nb_atomic_operations;
+    struct atomic_operation_t *p_ops;
     unsigned int i_next_atomic_operation;
     int i_source_channel_offset;
     unsigned int i;
@@ -210,14 +216,14 @@ static int Init( vlc_object_t *p_this, filter_sys_t * p_data
     }
 
     /* Number of elementary operations */
-    p_data->i_nb_atomic_operations = i_nb_channels * 2;
+    i_nb_atomic_operations = i_nb_channels * 2;
     if( i_physical_channels & AOUT_CHAN_CENTER )
     {
-        p_data->i_nb_atomic_operations += 2;
+        i_nb_atomic_operations += 2;
     }
-    p_data->p_atomic_operations = malloc( sizeof(struct atomic_operation_t)
-            * p_data->i_nb_atomic_operations );
-    if( p_data->p_atomic_operations == NULL )
+    p_ops = malloc( sizeof(struct atomic_operation_t)
+            * i_nb_atomic_operations );
+    if( p_ops == NULL )
         return -1;
 
     /* For each virtual speaker, computes elementary wave propagation time
@@ -226,7 +232,7 @@ static int Init( vlc_object_t *p_this, filter_sys_t * p_data
     i_source_channel_offset = 0;
     if( i_physical_channels & AOUT_CHAN_LEFT )
     {
-        ComputeChannelOperations( p_data , i_rate
+        ComputeChannelOperations( p_ops , i_rate
                 , i_next_atomic_operation , i_source_channel_offset
                 , -d_x , d_z , d_min , 2.0 / i_nb_channels );
         i_next_atomic_operation += 2;
@@ -234,7 +240,7 @@ static int Init( vlc_object_t *p_this, filter_sys_t * p_data
     }
     if( i_physical_channels & AOUT_CHAN_RIGHT )
     {
-        ComputeChannelOperations( p_data , i_rate
+        ComputeChannelOperations( p_ops , i_rate
                 , i_next_atomic_operation , i_source_channel_offset
                 , d_x , d_z , d_min , 2.0 / i_nb_channels );
         i_next_atomic_operation += 2;
@@ -242,7 +248,7 @@ static int Init( vlc_object_t *p_this, filter_sys_t * p_data
     }
     if( i_physical_channels & AOUT_CHAN_MIDDLELEFT )
     {
-        ComputeChannelOperations( p_data , i_rate
+        ComputeChannelOperations( p_ops , i_rate
                 , i_next_atomic_operation , i_source_channel_offset
                 , -d_x , 0 , d_min , 1.5 / i_nb_channels );
         i_next_atomic_operation += 2;
@@ -250,7 +256,7 @@ static int Init( vlc_object_t *p_this, filter_sys_t * p_data
     }
     if( i_physical_channels & AOUT_CHAN_MIDDLERIGHT )
     {
-        ComputeChannelOperations( p_data , i_rate
+        ComputeChannelOperations( p_ops , i_rate
                 , i_next_atomic_operation , i_source_channel_offset
                 , d_x , 0 , d_min , 1.5 / i_nb_channels );
         i_next_atomic_operation += 2;
@@ -258,7 +264,7 @@ static int Init( vlc_object_t *p_this, filter_sys_t * p_data
     }
     if( i_physical_channels & AOUT_CHAN_REARLEFT )
     {
-        ComputeChannelOperations( p_data , i_rate
+        ComputeChannelOperations( p_ops , i_rate
                 , i_next_atomic_operation , i_source_channel_offset
                 , -d_x , d_z_rear , d_min , 1.5 / i_nb_channels );
         i_next_atomic_operation += 2;
@@ -266,7 +272,7 @@ static int Init( vlc_object_t *p_this, filter_sys_t * p_data
     }
     if( i_physical_channels & AOUT_CHAN_REARRIGHT )
     {
-        ComputeChannelOperations( p_data , i_rate
+        ComputeChannelOperations( p_ops , i_rate
                 , i_next_atomic_operation , i_source_channel_offset
                 , d_x , d_z_rear , d_min , 1.5 / i_nb_channels );
         i_next_atomic_operation += 2;
@@ -274,7 +280,7 @@ static int Init( vlc_object_t *p_this, filter_sys_t * p_data
     }
     if( i_physical_channels & AOUT_CHAN_REARCENTER )
     {
-        ComputeChannelOperations( p_data , i_rate
+        ComputeChannelOperations( p_ops , i_rate
                 , i_next_atomic_operation , i_source_channel_offset
                 , 0 , -d_z , d_min , 1.5 / i_nb_channels );
         i_next_atomic_operation += 2;
@@ -283,11 +289,11 @@ static int Init( vlc_object_t *p_this, filter_sys_t * p_data
     if( i_physical_channels & AOUT_CHAN_CENTER )
     {
         /* having two center channels increases the spatialization effect */
-        ComputeChannelOperations( p_data , i_rate
+        ComputeChannelOperations( p_ops , i_rate
                 , i_next_atomic_operation , i_source_channel_offset
                 , d_x / 5.0 , d_z , d_min , 0.75 / i_nb_channels );
         i_next_atomic_operation += 2;
-        ComputeChannelOperations( p_data , i_rate
+        ComputeChannelOperations( p_ops , i_rate
                 , i_next_atomic_operation , i_source_channel_offset
                 , -d_x / 5.0 , d_z , d_min , 0.75 / i_nb_channels );
         i_next_atomic_operation += 2;
@@ -295,33 +301,70 @@ static int Init( vlc_object_t *p_this, filter_sys_t * p_data
     }
     if( i_physical_channels & AOUT_CHAN_LFE )
     {
-        ComputeChannelOperations( p_data , i_rate
+        ComputeChannelOperations( p_ops , i_rate
                 , i_next_atomic_operation , i_source_channel_offset
                 , 0 , d_z_rear , d_min , 5.0 / i_nb_channels );
         i_next_atomic_operation += 2;
         i_source_channel_offset++;
     }
 
-    /* Initialize the overflow buffer
-     * we need it because the process induce a delay in the samples */
-    p_data->i_overflow_buffer_size = 0;
-    for( i = 0 ; i < p_data->i_nb_atomic_operations ; i++ )
+    /* Fold the operations into one impulse response per (source, ear)
+     * pair and hand them to the convolution engines.  A tap of delay d
+     * and amplitude a is simply ir[d] += a; the center channel
+     * contributes two taps per ear on the same source. */
+    size_t i_ir_length = 1;
+    for( i = 0 ; i < i_nb_atomic_operations ; i++ )
     {
-        if( p_data->i_overflow_buffer_size
-                < p_data->p_atomic_operations[i].i_delay * 2 * sizeof (float) )
-        {
-            p_data->i_overflow_buffer_size
-                = p_data->p_atomic_operations[i].i_delay * 2 * sizeof (float);
-        }
+        if( i_ir_length < (size_t)p_ops[i].i_delay + 1 )
+            i_ir_length = (size_t)p_ops[i].i_delay + 1;
     }
-    p_data->p_overflow_buffer = malloc( p_data->i_overflow_buffer_size );
-    if( p_data->p_overflow_buffer == NULL )
+
+    float *p_ir = malloc( i_ir_length * sizeof (float) );
+    if( p_ir == NULL )
     {
-        free( p_data->p_atomic_operations );
+        free( p_ops );
         return -1;
     }
-    memset( p_data->p_overflow_buffer, 0 , p_data->i_overflow_buffer_size );
 
+    p_data->i_nb_sources = i_source_channel_offset;
+    p_data->pp_conv = calloc( 2 * p_data->i_nb_sources,
+                              sizeof (fir_conv_t *) );
+    if( p_data->pp_conv == NULL )
+    {
+        free( p_ir );
+        free( p_ops );
+        return -1;
+    }
+
+    for( unsigned i_source = 0; i_source < p_data->i_nb_sources; i_source++ )
+        for( int i_ear = 0; i_ear < 2; i_ear++ )
+        {
+            memset( p_ir, 0, i_ir_length * sizeof (float) );
+            for( i = 0 ; i < i_nb_atomic_operations ; i++ )
+            {
+                if( p_ops[i].i_source_channel_offset == (int)i_source
+                 && p_ops[i].i_dest_channel_offset == i_ear )
+                    p_ir[p_ops[i].i_delay] += p_ops[i].d_amplitude_factor;
+            }
+
+            fir_conv_t *p_conv = fir_conv_New( p_ir, i_ir_length );
+            if( p_conv == NULL )
+            {
+                for( i = 0; i < 2 * p_data->i_nb_sources; i++ )
+                    if( p_data->pp_conv[i] != NULL )
+                        fir_conv_Delete( p_data->pp_conv[i] );
+                free( p_data->pp_conv );
+                free( p_ir );
+                free( p_ops );
+                return -1;
+            }
+            p_data->pp_conv[2 * i_source + i_ear] = p_conv;
+        }
+
+    p_data->i_latency = fir_conv_GetLatency( p_data->pp_conv[0] );
+
+    free( p_ir );
+    free( p_ops );
     return 0;
 }
 
@@ -336,97 +379,22 @@ static void DoWork( filter_t * p_filter,
     int i_output_nb = aout_FormatNbChannels( &p_filter->fmt_out.audio );
 
     float * p_in = (float*) p_in_buf->p_buffer;
-    float * p_out;
-    uint8_t * p_overflow;
-    uint8_t * p_end_overflow;
-    uint8_t * p_slide;
-
-    size_t i_overflow_size;     /* in bytes */
-    size_t i_out_size;          /* in bytes */
-
-    unsigned int i, j;
-
-    int i_source_channel_offset;
-    int i_dest_channel_offset;
-    unsigned int i_delay;
-    double d_amplitude_factor;
+    float * p_out = (float *)p_out_buf->p_buffer;
 
-    p_out = (float *)p_out_buf->p_buffer;
-    i_out_size = p_out_buf->i_buffer;
+    memset( p_out, 0, p_out_buf->i_buffer );
 
-    /* Slide the overflow buffer */
-    p_overflow = (uint8_t *) p_sys->p_overflow_buffer;
-    i_overflow_size = p_sys->i_overflow_buffer_size;
-    p_end_overflow = p_overflow + i_overflow_size;
-
-    memset( p_out, 0, i_out_size );
-    memcpy( p_out, p_overflow, __MIN( i_out_size, i_overflow_size ) );
-
-    p_slide = (uint8_t *) p_sys->p_overflow_buffer;
-    while( p_slide < p_end_overflow )
-    {
-        size_t i_bytes_copied;
-
-        if( p_slide + i_out_size < p_end_overflow )
-        {
-            memset( p_slide, 0, i_out_size );
-            if( p_slide + 2 * i_out_size < p_end_overflow )
-                i_bytes_copied = i_out_size;
-            else
-                i_bytes_copied = p_end_overflow - ( p_slide + i_out_size );
-            memcpy( p_slide, p_slide + i_out_size, i_bytes_copied );
-        }
-        else
+    /* Each engine gathers one source channel from the interleaved input
+     * and accumulates its contribution into one ear of the interleaved
+     * output; the engines carry the inter-block tails themselves, so no
+     * overflow buffer is needed here anymore. */
+    for( unsigned i_source = 0; i_source < p_sys->i_nb_sources; i_source++ )
+        for( int i_ear = 0; i_ear < 2; i_ear++ )
         {
-            i_bytes_copied = p_end_overflow - p_slide;
-            memset( p_slide, 0, i_bytes_copied );
+            fir_conv_Run( p_sys->pp_conv[2 * i_source + i_ear],
+                          p_in + i_source, i_input_nb,
+                          p_out + i_ear, i_output_nb,
+                          p_out_buf->i_nb_samples );
         }
-        p_slide += i_bytes_copied;
-    }
-
-    /* apply the atomic operations */
-    for( i = 0; i < p_sys->i_nb_atomic_operations; i++ )
-    {
-        /* shorter variable names */
-        i_source_channel_offset
-            = p_sys->p_atomic_operations[i].i_source_channel_offset;
-        i_dest_channel_offset
-            = p_sys->p_atomic_operations[i].i_dest_channel_offset;
-        i_delay = p_sys->p_atomic_operations[i].i_delay;
-        d_amplitude_factor
-            = p_sys->p_atomic_operations[i].d_amplitude_factor;
-
-        if( p_out_buf->i_nb_samples > i_delay )
-        {
-            /* current buffer coefficients */
-            for( j = 0; j < p_out_buf->i_nb_samples - i_delay; j++ )
-            {
-                ((float*)p_out)[ (i_delay+j)*i_output_nb + i_dest_channel_offset ]
-                    += p_in[ j * i_input_nb + i_source_channel_offset ]
-                       * d_amplitude_factor;
-            }
-
-            /* overflow buffer coefficients */
-            for( j = 0; j < i_delay; j++ )
-            {
-                ((float*)p_overflow)[ j*i_output_nb + i_dest_channel_offset ]
-                    += p_in[ (p_out_buf->i_nb_samples - i_delay + j)
-                       * i_input_nb + i_source_channel_offset ]
-                       * d_amplitude_factor;
-            }
-        }
-        else
-        {
-            /* overflow buffer coefficients only */
-            for( j = 0; j < p_out_buf->i_nb_samples; j++ )
-            {
-                ((float*)p_overflow)[ (i_delay - p_out_buf->i_nb_samples + j)
-                                        * i_output_nb + i_dest_channel_offset ]
-                    += p_in[ j * i_input_nb + i_source_channel_offset ]
-                       * d_amplitude_factor;
-            }
-        }
-    }
 }
 
 /*
@@ -452,10 +420,9 @@ static int OpenFilter( vlc_object_t *p_this )
     p_sys = p_filter->p_sys = malloc( sizeof(filter_sys_t) );
     if( p_sys == NULL )
         return VLC_ENOMEM;
-    p_sys->i_overflow_buffer_size = 0;
-    p_sys->p_overflow_buffer = NULL;
-    p_sys->i_nb_atomic_operations = 0;
-    p_sys->p_atomic_operations = NULL;
+    p_sys->i_nb_sources = 0;
+    p_sys->pp_conv = NULL;
+    p_sys->i_latency = 0;
 
     if( Init( VLC_OBJECT(p_filter), p_sys
                 , aout_FormatNbChannels ( &(p_filter->fmt_in.audio) )
@@ -494,8 +461,9 @@ static void CloseFilter( vlc_object_t *p_this )
     filter_t *p_filter = (filter_t *)p_this;
     filter_sys_t *p_sys = p_filter->p_sys;
 
-    free( p_sys->p_overflow_buffer );
-    free( p_sys->p_atomic_operations );
+    for( unsigned i = 0; i < 2 * p_sys->i_nb_sources; i++ )
+        fir_conv_Delete( p_sys->pp_conv[i] );
+    free( p_sys->pp_conv );
     free( p_sys );
 }
 
@@ -520,9 +488,17 @@ static block_t *Convert( filter_t *p_filter, block_t *p_block )
         return NULL;
     }
 
+    /* Report the constant engine delay to the aout by dating the output
+     * back by as much, so lip sync is preserved. */
+    filter_sys_t *p_sys = p_filter->p_sys;
+    vlc_tick_t i_delay = vlc_tick_from_samples( p_sys->i_latency,
+                                        p_filter->fmt_out.audio.i_rate );
+
     p_out->i_nb_samples = p_block->i_nb_samples;
-    p_out->i_dts = p_block->i_dts;
-    p_out->i_pts = p_block->i_pts;
+    if( p_block->i_dts != VLC_TICK_INVALID )
+        p_out->i_dts = p_block->i_dts - i_delay;
+    if( p_block->i_pts != VLC_TICK_INVALID )
+        p_out->i_pts = p_block->i_pts - i_delay;
     p_out->i_length = p_block->i_length;
 
     DoWork( p_filter, p_block, p_out );
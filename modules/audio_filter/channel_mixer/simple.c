@@ -48,18 +48,21 @@ vlc_module_end ()
 
 static block_t *Filter( filter_t *, block_t * );
 
+/* The LFE presence only changes the source stride, so it is hoisted out
+ * of the mixing loops: the bodies become branch-free with a constant
+ * stride, which lets the compiler vectorize them across samples. */
 static void DoWork_7_x_to_2_0( filter_t * p_filter,  block_t * p_in_buf, block_t * p_out_buf ) {
     float *p_dest = (float *)p_out_buf->p_buffer;
     const float *p_src = (const float *)p_in_buf->p_buffer;
+    const int i_step = ( p_filter->fmt_in.audio.i_physical_channels
+                       & AOUT_CHAN_LFE ) ? 8 : 7;
     for( int i = p_in_buf->i_nb_samples; i--; )
     {
         float ctr = p_src[6] * 0.7071f;
         *p_dest++ = ctr + p_src[0] + p_src[2] / 4 + p_src[4] / 4;
         *p_dest++ = ctr + p_src[1] + p_src[3] / 4 + p_src[5] / 4;
 
-        p_src += 7;
-
-        if( p_filter->fmt_in.audio.i_physical_channels & AOUT_CHAN_LFE ) p_src++;
+        p_src += i_step;
     }
 }
 
@@ -85,14 +88,14 @@ static void DoWork_6_1_to_2_0( filter_t *p_filter, block_t *p_in_buf,
 static void DoWork_5_x_to_2_0( filter_t * p_filter,  block_t * p_in_buf, block_t * p_out_buf ) {
     float *p_dest = (float *)p_out_buf->p_buffer;
     const float *p_src = (const float *)p_in_buf->p_buffer;
+    const int i_step = ( p_filter->fmt_in.audio.i_physical_channels
+                       & AOUT_CHAN_LFE ) ? 6 : 5;
     for( int i = p_in_buf->i_nb_samples; i--; )
     {
         *p_dest++ = p_src[0] + 0.7071f * (p_src[4] + p_src[2]);
         *p_dest++ = p_src[1] + 0.7071f * (p_src[4] + p_src[3]);
 
-        p_src += 5;
-
-        if( p_filter->fmt_in.audio.i_physical_channels & AOUT_CHAN_LFE ) p_src++;
+        p_src += i_step;
     }
 }
 
@@ -111,41 +114,41 @@ static void DoWork_4_0_to_2_0( filter_t * p_filter,  block_t * p_in_buf, block_t
 static void DoWork_3_x_to_2_0( filter_t * p_filter,  block_t * p_in_buf, block_t * p_out_buf ) {
     float *p_dest = (float *)p_out_buf->p_buffer;
     const float *p_src = (const float *)p_in_buf->p_buffer;
+    const int i_step = ( p_filter->fmt_in.audio.i_physical_channels
+                       & AOUT_CHAN_LFE ) ? 4 : 3;
     for( int i = p_in_buf->i_nb_samples; i--; )
     {
         *p_dest++ = p_src[2] + 0.5f * p_src[0];
         *p_dest++ = p_src[2] + 0.5f * p_src[1];
 
-        p_src += 3;
-
-        if( p_filter->fmt_in.audio.i_physical_channels & AOUT_CHAN_LFE ) p_src++;
+        p_src += i_step;
     }
 }
 
 static void DoWork_7_x_to_1_0( filter_t * p_filter,  block_t * p_in_buf, block_t * p_out_buf ) {
     float *p_dest = (float *)p_out_buf->p_buffer;
     const float *p_src = (const float *)p_in_buf->p_buffer;
+    const int i_step = ( p_filter->fmt_in.audio.i_physical_channels
+                       & AOUT_CHAN_LFE ) ? 8 : 7;
     for( int i = p_in_buf->i_nb_samples; i--; )
     {
         *p_dest++ = p_src[6] + p_src[0] / 4 + p_src[1] / 4 + p_src[2] / 8 + p_src[3] / 8 + p_src[4] / 8 + p_src[5] / 8;
 
-        p_src += 7;
-
-        if( p_filter->fmt_in.audio.i_physical_channels & AOUT_CHAN_LFE ) p_src++;
+        p_src += i_step;
     }
 }
 
 static void DoWork_5_x_to_1_0( filter_t * p_filter,  block_t * p_in_buf, block_t * p_out_buf ) {
     float *p_dest = (float *)p_out_buf->p_buffer;
     const float *p_src = (const float *)p_in_buf->p_buffer;
+    const int i_step = ( p_filter->fmt_in.audio.i_physical_channels
+                       & AOUT_CHAN_LFE ) ? 6 : 5;
     for( int i = p_in_buf->i_nb_samples; i--; )
     {
         *p_dest++ = 0.7071f * (p_src[0] + p_src[1]) + p_src[4]
                      + 0.5f * (p_src[2] + p_src[3]);
 
-        p_src += 5;
-
-        if( p_filter->fmt_in.audio.i_physical_channels & AOUT_CHAN_LFE ) p_src++;
+        p_src += i_step;
     }
 }
 
@@ -163,13 +166,13 @@ static void DoWork_4_0_to_1_0( filter_t * p_filter,  block_t * p_in_buf, block_t
 static void DoWork_3_x_to_1_0( filter_t * p_filter,  block_t * p_in_buf, block_t * p_out_buf ) {
     float *p_dest = (float *)p_out_buf->p_buffer;
     const float *p_src = (const float *)p_in_buf->p_buffer;
+    const int i_step = ( p_filter->fmt_in.audio.i_physical_channels
+                       & AOUT_CHAN_LFE ) ? 4 : 3;
     for( int i = p_in_buf->i_nb_samples; i--; )
     {
         *p_dest++ = p_src[2] + p_src[0] / 4 + p_src[1] / 4;
 
-        p_src += 3;
-
-        if( p_filter->fmt_in.audio.i_physical_channels & AOUT_CHAN_LFE ) p_src++;
+        p_src += i_step;
     }
 }
 
@@ -188,6 +191,8 @@ static void DoWork_2_x_to_1_0( filter_t * p_filter,  block_t * p_in_buf, block_t
 static void DoWork_7_x_to_4_0( filter_t * p_filter,  block_t * p_in_buf, block_t * p_out_buf ) {
     float *p_dest = (float *)p_out_buf->p_buffer;
     const float *p_src = (const float *)p_in_buf->p_buffer;
+    const int i_step = ( p_filter->fmt_in.audio.i_physical_channels
+                       & AOUT_CHAN_LFE ) ? 8 : 7;
     for( int i = p_in_buf->i_nb_samples; i--; )
     {
         *p_dest++ = p_src[6] + 0.5f * p_src[0] + p_src[2] / 6;
@@ -195,15 +200,15 @@ static void DoWork_7_x_to_4_0( filter_t * p_filter,  block_t * p_in_buf, block_t
         *p_dest++ = p_src[2] / 6 +  p_src[4];
         *p_dest++ = p_src[3] / 6 +  p_src[5];
 
-        p_src += 7;
-
-        if( p_filter->fmt_in.audio.i_physical_channels & AOUT_CHAN_LFE ) p_src++;
+        p_src += i_step;
     }
 }
 
 static void DoWork_5_x_to_4_0( filter_t * p_filter,  block_t * p_in_buf, block_t * p_out_buf ) {
     float *p_dest = (float *)p_out_buf->p_buffer;
     const float *p_src = (const float *)p_in_buf->p_buffer;
+    const int i_step = ( p_filter->fmt_in.audio.i_physical_channels
+                       & AOUT_CHAN_LFE ) ? 6 : 5;
     for( int i = p_in_buf->i_nb_samples; i--; )
     {
         float ctr = p_src[4] * 0.7071f;
@@ -212,15 +217,19 @@ static void DoWork_5_x_to_4_0( filter_t * p_filter,  block_t * p_in_buf, block_t
         *p_dest++ = p_src[2];
         *p_dest++ = p_src[3];
 
-        p_src += 5;
-
-        if( p_filter->fmt_in.audio.i_physical_channels & AOUT_CHAN_LFE ) p_src++;
+        p_src += i_step;
     }
 }
 
 static void DoWork_7_x_to_5_x( filter_t * p_filter,  block_t * p_in_buf, block_t * p_out_buf ) {
     float *p_dest = (float *)p_out_buf->p_buffer;
     const float *p_src = (const float *)p_in_buf->p_buffer;
+    const bool b_lfe_in = p_filter->fmt_in.audio.i_physical_channels
+                        & AOUT_CHAN_LFE;
+    const bool b_lfe_copy = b_lfe_in
+                        && ( p_filter->fmt_out.audio.i_physical_channels
+                           & AOUT_CHAN_LFE );
+    const int i_step = b_lfe_in ? 8 : 7;
     for( int i = p_in_buf->i_nb_samples; i--; )
     {
         *p_dest++ = p_src[0];
@@ -229,12 +238,10 @@ static void DoWork_7_x_to_5_x( filter_t * p_filter,  block_t * p_in_buf, block_t
         *p_dest++ = (p_src[3] + p_src[5]) * 0.5f;
         *p_dest++ = p_src[6];
 
-        p_src += 7;
+        if( b_lfe_copy )
+            *p_dest++ = p_src[7];
 
-        if( p_filter->fmt_in.audio.i_physical_channels & AOUT_CHAN_LFE &&
-            p_filter->fmt_out.audio.i_physical_channels & AOUT_CHAN_LFE )
-            *p_dest++ = *p_src++;
-        else if( p_filter->fmt_in.audio.i_physical_channels & AOUT_CHAN_LFE ) p_src++;
+        p_src += i_step;
     }
 }
 
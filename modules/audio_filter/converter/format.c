@@ -82,72 +82,107 @@ static int Open(vlc_object_t *object)
 }
 
 
+/* Returns a block able to hold i_size bytes of converted output: the source
+ * block itself whenever its buffer has enough capacity (the conversion then
+ * runs in place and spares an allocation), else a freshly allocated block.
+ * Widening conversions must then convert backward, so that every source
+ * sample is read before the output overwrites it. */
+static block_t *ToWider(block_t *b, size_t i_size)
+{
+    if ((size_t)(b->p_start + b->i_size - b->p_buffer) >= i_size)
+    {
+        b->i_buffer = i_size;
+        return b;
+    }
+
+    block_t *bdst = block_Alloc(i_size);
+    if (likely(bdst != NULL))
+        block_CopyProperties(bdst, b);
+    return bdst;
+}
+
 /*** from U8 ***/
 static block_t *U8toS16(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
+    VLC_UNUSED(filter);
+    const size_t n = bsrc->i_buffer;
+    block_t *bdst = ToWider(bsrc, n * 2);
     if (unlikely(bdst == NULL))
-        goto out;
+    {
+        block_Release(bsrc);
+        return NULL;
+    }
 
-    block_CopyProperties(bdst, bsrc);
-    uint8_t *src = (uint8_t *)bsrc->p_buffer;
+    const uint8_t *src = (uint8_t *)bsrc->p_buffer;
     int16_t *dst = (int16_t *)bdst->p_buffer;
-    for (size_t i = bsrc->i_buffer; i--;)
-        *dst++ = ((*src++) << 8) - 0x8000;
-out:
-    block_Release(bsrc);
-    VLC_UNUSED(filter);
+    for (size_t i = n; i--;)
+        dst[i] = (src[i] << 8) - 0x8000;
+
+    if (bdst != bsrc)
+        block_Release(bsrc);
     return bdst;
 }
 
 static block_t *U8toFl32(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 4);
+    VLC_UNUSED(filter);
+    const size_t n = bsrc->i_buffer;
+    block_t *bdst = ToWider(bsrc, n * 4);
     if (unlikely(bdst == NULL))
-        goto out;
+    {
+        block_Release(bsrc);
+        return NULL;
+    }
 
-    block_CopyProperties(bdst, bsrc);
-    uint8_t *src = (uint8_t *)bsrc->p_buffer;
+    const uint8_t *src = (uint8_t *)bsrc->p_buffer;
     float   *dst = (float *)bdst->p_buffer;
-    for (size_t i = bsrc->i_buffer; i--;)
-        *dst++ = ((float)((*src++) - 128)) / 128.f;
-out:
-    block_Release(bsrc);
-    VLC_UNUSED(filter);
+    for (size_t i = n; i--;)
+        dst[i] = ((float)(src[i] - 128)) / 128.f;
+
+    if (bdst != bsrc)
+        block_Release(bsrc);
     return bdst;
 }
 
 static block_t *U8toS32(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 4);
+    VLC_UNUSED(filter);
+    const size_t n = bsrc->i_buffer;
+    block_t *bdst = ToWider(bsrc, n * 4);
     if (unlikely(bdst == NULL))
-        goto out;
+    {
+        block_Release(bsrc);
+        return NULL;
+    }
 
-    block_CopyProperties(bdst, bsrc);
-    uint8_t *src = (uint8_t *)bsrc->p_buffer;
+    const uint8_t *src = (uint8_t *)bsrc->p_buffer;
     int32_t *dst = (int32_t *)bdst->p_buffer;
-    for (size_t i = bsrc->i_buffer; i--;)
-        *dst++ = ((*src++) << 24) - 0x80000000;
-out:
-    block_Release(bsrc);
-    VLC_UNUSED(filter);
+    for (size_t i = n; i--;)
+        dst[i] = (src[i] << 24) - 0x80000000;
+
+    if (bdst != bsrc)
+        block_Release(bsrc);
     return bdst;
 }
 
 static block_t *U8toFl64(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 8);
+    VLC_UNUSED(filter);
+    const size_t n = bsrc->i_buffer;
+    block_t *bdst = ToWider(bsrc, n * 8);
     if (unlikely(bdst == NULL))
-        goto out;
+    {
+        block_Release(bsrc);
+        return NULL;
+    }
 
-    block_CopyProperties(bdst, bsrc);
-    uint8_t *src = (uint8_t *)bsrc->p_buffer;
+    const uint8_t *src = (uint8_t *)bsrc->p_buffer;
     double  *dst = (double *)bdst->p_buffer;
-    for (size_t i = bsrc->i_buffer; i--;)
-        *dst++ = ((double)((*src++) - 128)) / 128.;
-out:
-    block_Release(bsrc);
-    VLC_UNUSED(filter);
+    for (size_t i = n; i--;)
+        dst[i] = ((double)(src[i] - 128)) / 128.;
+
+    if (bdst != bsrc)
+        block_Release(bsrc);
     return bdst;
 }
 
@@ -167,63 +202,75 @@ static block_t *S16toU8(filter_t *filter, block_t *b)
 
 static block_t *S16toFl32(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
+    VLC_UNUSED(filter);
+    const size_t n = bsrc->i_buffer / 2;
+    block_t *bdst = ToWider(bsrc, n * 4);
     if (unlikely(bdst == NULL))
-        goto out;
+    {
+        block_Release(bsrc);
+        return NULL;
+    }
 
-    block_CopyProperties(bdst, bsrc);
-    int16_t *src = (int16_t *)bsrc->p_buffer;
+    const int16_t *src = (int16_t *)bsrc->p_buffer;
     float   *dst = (float *)bdst->p_buffer;
-    for (size_t i = bsrc->i_buffer / 2; i--;)
+    for (size_t i = n; i--;)
 #if 0
         /* Slow version */
-        *dst++ = (float)*src++ / 32768.f;
+        dst[i] = (float)src[i] / 32768.f;
 #else
     {   /* This is Walken's trick based on IEEE float format. On my PIII
          * this takes 16 seconds to perform one billion conversions, instead
          * of 19 seconds for the above division. */
         union { float f; int32_t i; } u;
-        u.i = *src++ + 0x43c00000;
-        *dst++ = u.f - 384.f;
+        u.i = src[i] + 0x43c00000;
+        dst[i] = u.f - 384.f;
     }
 #endif
-out:
-    block_Release(bsrc);
-    VLC_UNUSED(filter);
+
+    if (bdst != bsrc)
+        block_Release(bsrc);
     return bdst;
 }
 
 static block_t *S16toS32(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
+    VLC_UNUSED(filter);
+    const size_t n = bsrc->i_buffer / 2;
+    block_t *bdst = ToWider(bsrc, n * 4);
     if (unlikely(bdst == NULL))
-        goto out;
+    {
+        block_Release(bsrc);
+        return NULL;
+    }
 
-    block_CopyProperties(bdst, bsrc);
-    int16_t *src = (int16_t *)bsrc->p_buffer;
+    const int16_t *src = (int16_t *)bsrc->p_buffer;
     int32_t *dst = (int32_t *)bdst->p_buffer;
-    for (int i = bsrc->i_buffer / 2; i--;)
-        *dst++ = *src++ << 16;
-out:
-    block_Release(bsrc);
-    VLC_UNUSED(filter);
+    for (size_t i = n; i--;)
+        dst[i] = src[i] << 16;
+
+    if (bdst != bsrc)
+        block_Release(bsrc);
     return bdst;
 }
 
 static block_t *S16toFl64(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 4);
+    VLC_UNUSED(filter);
+    const size_t n = bsrc->i_buffer / 2;
+    block_t *bdst = ToWider(bsrc, n * 8);
     if (unlikely(bdst == NULL))
-        goto out;
+    {
+        block_Release(bsrc);
+        return NULL;
+    }
 
-    block_CopyProperties(bdst, bsrc);
-    int16_t *src = (int16_t *)bsrc->p_buffer;
-    float   *dst = (float *)bdst->p_buffer;
-    for (size_t i = bsrc->i_buffer / 2; i--;)
-        *dst++ = (double)*src++ / 32768.;
-out:
-    block_Release(bsrc);
-    VLC_UNUSED(filter);
+    const int16_t *src = (int16_t *)bsrc->p_buffer;
+    double  *dst = (double *)bdst->p_buffer;
+    for (size_t i = n; i--;)
+        dst[i] = (double)src[i] / 32768.;
+
+    if (bdst != bsrc)
+        block_Release(bsrc);
     return bdst;
 }
 
@@ -298,18 +345,22 @@ static block_t *Fl32toS32(filter_t *filter, block_t *b)
 
 static block_t *Fl32toFl64(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
+    VLC_UNUSED(filter);
+    const size_t n = bsrc->i_buffer / 4;
+    block_t *bdst = ToWider(bsrc, n * 8);
     if (unlikely(bdst == NULL))
-        goto out;
+    {
+        block_Release(bsrc);
+        return NULL;
+    }
 
-    block_CopyProperties(bdst, bsrc);
-    float  *src = (float *)bsrc->p_buffer;
+    const float *src = (float *)bsrc->p_buffer;
     double *dst = (double *)bdst->p_buffer;
-    for (size_t i = bsrc->i_buffer / 4; i--;)
-        *(dst++) = *(src++);
-out:
-    block_Release(bsrc);
-    VLC_UNUSED(filter);
+    for (size_t i = n; i--;)
+        dst[i] = src[i];
+
+    if (bdst != bsrc)
+        block_Release(bsrc);
     return bdst;
 }
 
@@ -351,18 +402,22 @@ static block_t *S32toFl32(filter_t *filter, block_t *b)
 
 static block_t *S32toFl64(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
+    VLC_UNUSED(filter);
+    const size_t n = bsrc->i_buffer / 4;
+    block_t *bdst = ToWider(bsrc, n * 8);
     if (unlikely(bdst == NULL))
-        goto out;
+    {
+        block_Release(bsrc);
+        return NULL;
+    }
 
-    block_CopyProperties(bdst, bsrc);
-    int32_t *src = (int32_t*)bsrc->p_buffer;
+    const int32_t *src = (int32_t*)bsrc->p_buffer;
     double  *dst = (double *)bdst->p_buffer;
-    for (size_t i = bsrc->i_buffer / 4; i--;)
-        *dst++ = (double)(*src++) / 2147483648.;
-out:
-    VLC_UNUSED(filter);
-    block_Release(bsrc);
+    for (size_t i = n; i--;)
+        dst[i] = (double)src[i] / 2147483648.;
+
+    if (bdst != bsrc)
+        block_Release(bsrc);
     return bdst;
 }
 
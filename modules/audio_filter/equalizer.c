@@ -113,13 +113,17 @@ typedef struct
     float f_gamp;   /* Global preamp */
     bool b_2eqz;
 
-    /* Filter state */
+    /* Filter state: the delayed band outputs are stored band-contiguous
+     * per channel, so that the band loop in EqzFilter() runs over unit
+     * stride arrays and vectorizes */
     float x[32][2];
-    float y[32][128][2];
+    float y0[32][128];
+    float y1[32][128];
 
     /* Second filter state */
     float x2[32][2];
-    float y2[32][128][2];
+    float y20[32][128];
+    float y21[32][128];
 
     vlc_mutex_t lock;
 } filter_sys_t;
@@ -323,10 +327,10 @@ static int EqzInit( filter_t *p_filter, int i_rate )
 
         for( i = 0; i < p_sys->i_band; i++ )
         {
-            p_sys->y[ch][i][0]  =
-            p_sys->y[ch][i][1]  =
-            p_sys->y2[ch][i][0] =
-            p_sys->y2[ch][i][1] = 0.0f;
+            p_sys->y0[ch][i]  =
+            p_sys->y1[ch][i]  =
+            p_sys->y20[ch][i] =
+            p_sys->y21[ch][i] = 0.0f;
         }
     }
 
@@ -390,23 +394,35 @@ static void EqzFilter( filter_t *p_filter, float *out, float *in,
     int i, ch, j;
 
     vlc_mutex_lock( &p_sys->lock );
+
+    const int i_band = p_sys->i_band;
+    const float *restrict f_alpha = p_sys->f_alpha;
+    const float *restrict f_beta  = p_sys->f_beta;
+    const float *restrict f_gamma = p_sys->f_gamma;
+    const float *restrict f_amp   = p_sys->f_amp;
+
     for( i = 0; i < i_samples; i++ )
     {
         for( ch = 0; ch < i_channels; ch++ )
         {
             const float x = in[ch];
+            const float x1 = p_sys->x[ch][1];
+            float *restrict y0 = p_sys->y0[ch];
+            float *restrict y1 = p_sys->y1[ch];
             float o = 0.0f;
 
-            for( j = 0; j < p_sys->i_band; j++ )
+            /* The bands are independent of each other: with the delayed
+             * outputs in band order, this loop maps onto SIMD lanes */
+            for( j = 0; j < i_band; j++ )
             {
-                float y = p_sys->f_alpha[j] * ( x - p_sys->x[ch][1] ) +
-                          p_sys->f_gamma[j] * p_sys->y[ch][j][0] -
-                          p_sys->f_beta[j]  * p_sys->y[ch][j][1];
+                float y = f_alpha[j] * ( x - x1 ) +
+                          f_gamma[j] * y0[j] -
+                          f_beta[j]  * y1[j];
 
-                p_sys->y[ch][j][1] = p_sys->y[ch][j][0];
-                p_sys->y[ch][j][0] = y;
+                y1[j] = y0[j];
+                y0[j] = y;
 
-                o += y * p_sys->f_amp[j];
+                o += y * f_amp[j];
             }
             p_sys->x[ch][1] = p_sys->x[ch][0];
             p_sys->x[ch][0] = x;
@@ -415,17 +431,20 @@ static void EqzFilter( filter_t *p_filter, float *out, float *in,
             if( p_sys->b_2eqz )
             {
                 const float x2 = EQZ_IN_FACTOR * x + o;
+                const float x21 = p_sys->x2[ch][1];
+                float *restrict y20 = p_sys->y20[ch];
+                float *restrict y21 = p_sys->y21[ch];
                 o = 0.0f;
-                for( j = 0; j < p_sys->i_band; j++ )
+                for( j = 0; j < i_band; j++ )
                 {
-                    float y = p_sys->f_alpha[j] * ( x2 - p_sys->x2[ch][1] ) +
-                              p_sys->f_gamma[j] * p_sys->y2[ch][j][0] -
-                              p_sys->f_beta[j]  * p_sys->y2[ch][j][1];
+                    float y = f_alpha[j] * ( x2 - x21 ) +
+                              f_gamma[j] * y20[j] -
+                              f_beta[j]  * y21[j];
 
-                    p_sys->y2[ch][j][1] = p_sys->y2[ch][j][0];
-                    p_sys->y2[ch][j][0] = y;
+                    y21[j] = y20[j];
+                    y20[j] = y;
 
-                    o += y * p_sys->f_amp[j];
+                    o += y * f_amp[j];
                 }
                 p_sys->x2[ch][1] = p_sys->x2[ch][0];
                 p_sys->x2[ch][0] = x2;
@@ -0,0 +1,259 @@
+/*****************************************************************************
+ * fir_conv.c : uniformly partitioned FFT convolution engine
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vlc_common.h>
+
+#include "fir_conv.h"
+
+/* Partition size in samples; the FFT works on blocks of twice that.
+ * 512 keeps the working set of one block pass inside L1/L2 while still
+ * amortizing the transforms over reasonably many samples. */
+#define FIR_CONV_PART_LOG  9
+#define FIR_CONV_PART      (1u << FIR_CONV_PART_LOG)
+#define FIR_CONV_FFT       (FIR_CONV_PART * 2)
+
+struct fir_conv
+{
+    unsigned i_parts;       /* number of IR partitions */
+    unsigned i_pos;         /* ring position of the newest input spectrum */
+    unsigned i_fill;        /* samples buffered in the current block */
+
+    /* Spectra are kept split (re[], im[]) so the per-partition complex
+     * multiply-accumulate below is a pair of unit-stride FMA loops the
+     * compiler can vectorize. */
+    float *p_ir_re, *p_ir_im;   /* i_parts * FIR_CONV_FFT each */
+    float *p_in_re, *p_in_im;   /* input spectrum ring, same layout */
+
+    float p_prev[FIR_CONV_PART];    /* previous input block (overlap-save) */
+    float p_cur[FIR_CONV_PART];     /* input block being gathered */
+    float p_out[FIR_CONV_PART];     /* output of the last block pass */
+
+    /* FFT tables for size FIR_CONV_FFT */
+    uint16_t p_rev[FIR_CONV_FFT];
+    float p_cos[FIR_CONV_FFT / 2];
+    float p_sin[FIR_CONV_FFT / 2];
+};
+
+/*****************************************************************************
+ * In-place iterative radix-2 FFT on split re/im arrays.
+ *****************************************************************************/
+static void FFT( const fir_conv_t *e, float *re, float *im, bool b_inverse )
+{
+    /* Bit-reversal permutation */
+    for( unsigned i = 0; i < FIR_CONV_FFT; i++ )
+    {
+        unsigned j = e->p_rev[i];
+        if( j > i )
+        {
+            float t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    for( unsigned size = 2; size <= FIR_CONV_FFT; size <<= 1 )
+    {
+        unsigned half = size / 2;
+        unsigned step = FIR_CONV_FFT / size;
+
+        for( unsigned base = 0; base < FIR_CONV_FFT; base += size )
+            for( unsigned k = 0; k < half; k++ )
+            {
+                float wr = e->p_cos[k * step];
+                float wi = e->p_sin[k * step];
+                if( b_inverse )
+                    wi = -wi;
+
+                unsigned a = base + k, b = a + half;
+                float tr = re[b] * wr - im[b] * wi;
+                float ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+    }
+}
+
+/*****************************************************************************
+ * One block pass: FFT the newest input block, multiply-accumulate against
+ * every IR partition, inverse FFT, keep the valid half (overlap-save).
+ *****************************************************************************/
+static void Process( fir_conv_t *e )
+{
+    e->i_pos = (e->i_pos + 1) % e->i_parts;
+
+    float *xr = e->p_in_re + e->i_pos * FIR_CONV_FFT;
+    float *xi = e->p_in_im + e->i_pos * FIR_CONV_FFT;
+
+    memcpy( xr, e->p_prev, sizeof (e->p_prev) );
+    memcpy( xr + FIR_CONV_PART, e->p_cur, sizeof (e->p_cur) );
+    memset( xi, 0, FIR_CONV_FFT * sizeof (float) );
+    FFT( e, xr, xi, false );
+
+    memcpy( e->p_prev, e->p_cur, sizeof (e->p_cur) );
+
+    float yr[FIR_CONV_FFT], yi[FIR_CONV_FFT];
+    memset( yr, 0, sizeof (yr) );
+    memset( yi, 0, sizeof (yi) );
+
+    for( unsigned p = 0; p < e->i_parts; p++ )
+    {
+        const float *hr = e->p_ir_re + p * FIR_CONV_FFT;
+        const float *hi = e->p_ir_im + p * FIR_CONV_FFT;
+        const float *br = e->p_in_re
+                        + ((e->i_pos + e->i_parts - p) % e->i_parts)
+                          * FIR_CONV_FFT;
+        const float *bi = e->p_in_im
+                        + ((e->i_pos + e->i_parts - p) % e->i_parts)
+                          * FIR_CONV_FFT;
+
+        for( unsigned k = 0; k < FIR_CONV_FFT; k++ )
+        {
+            yr[k] += br[k] * hr[k] - bi[k] * hi[k];
+            yi[k] += br[k] * hi[k] + bi[k] * hr[k];
+        }
+    }
+
+    FFT( e, yr, yi, true );
+
+    /* The first half is circular garbage; the second half is the linear
+     * convolution of the newest block.  The inverse FFT is unnormalized. */
+    for( unsigned k = 0; k < FIR_CONV_PART; k++ )
+        e->p_out[k] = yr[FIR_CONV_PART + k] / FIR_CONV_FFT;
+}
+
+/*****************************************************************************
+ * Public interface
+ *****************************************************************************/
+fir_conv_t *fir_conv_New( const float *p_ir, size_t i_ir_length )
+{
+    if( i_ir_length == 0 )
+        return NULL;
+
+    fir_conv_t *e = calloc( 1, sizeof (*e) );
+    if( unlikely(e == NULL) )
+        return NULL;
+
+    e->i_parts = (i_ir_length + FIR_CONV_PART - 1) / FIR_CONV_PART;
+    e->p_ir_re = vlc_alloc( e->i_parts * FIR_CONV_FFT, sizeof (float) );
+    e->p_ir_im = vlc_alloc( e->i_parts * FIR_CONV_FFT, sizeof (float) );
+    e->p_in_re = calloc( e->i_parts * FIR_CONV_FFT, sizeof (float) );
+    e->p_in_im = calloc( e->i_parts * FIR_CONV_FFT, sizeof (float) );
+    if( e->p_ir_re == NULL || e->p_ir_im == NULL
+     || e->p_in_re == NULL || e->p_in_im == NULL )
+    {
+        fir_conv_Delete( e );
+        return NULL;
+    }
+
+    /* FFT tables */
+    for( unsigned i = 0; i < FIR_CONV_FFT; i++ )
+    {
+        unsigned r = 0;
+        for( unsigned b = 0; b < FIR_CONV_PART_LOG + 1; b++ )
+            r |= ((i >> b) & 1) << (FIR_CONV_PART_LOG - b);
+        e->p_rev[i] = r;
+    }
+    for( unsigned i = 0; i < FIR_CONV_FFT / 2; i++ )
+    {
+        double a = -2. * M_PI * i / FIR_CONV_FFT;
+        e->p_cos[i] = cos( a );
+        e->p_sin[i] = sin( a );
+    }
+
+    /* Partition the impulse response and transform each slice, zero-padded
+     * to the FFT size so the products stay linear convolutions. */
+    for( unsigned p = 0; p < e->i_parts; p++ )
+    {
+        float *hr = e->p_ir_re + p * FIR_CONV_FFT;
+        float *hi = e->p_ir_im + p * FIR_CONV_FFT;
+        size_t i_off = (size_t)p * FIR_CONV_PART;
+        size_t i_len = __MIN( i_ir_length - i_off, (size_t)FIR_CONV_PART );
+
+        memset( hr, 0, FIR_CONV_FFT * sizeof (float) );
+        memset( hi, 0, FIR_CONV_FFT * sizeof (float) );
+        memcpy( hr, p_ir + i_off, i_len * sizeof (float) );
+        FFT( e, hr, hi, false );
+    }
+
+    return e;
+}
+
+unsigned fir_conv_GetLatency( const fir_conv_t *e )
+{
+    (void) e;
+    return FIR_CONV_PART;
+}
+
+void fir_conv_Run( fir_conv_t *e, const float *p_in, size_t i_in_stride,
+                   float *p_out, size_t i_out_stride, size_t i_count )
+{
+    while( i_count > 0 )
+    {
+        size_t n = __MIN( i_count, (size_t)(FIR_CONV_PART - e->i_fill) );
+
+        /* Input and output advance in lockstep: the slot an input sample
+         * fills in the pending block is the slot its (one block delayed)
+         * output counterpart is read from. */
+        for( size_t i = 0; i < n; i++ )
+        {
+            e->p_cur[e->i_fill + i] = p_in[i * i_in_stride];
+            p_out[i * i_out_stride] += e->p_out[e->i_fill + i];
+        }
+        e->i_fill += n;
+        p_in += n * i_in_stride;
+        p_out += n * i_out_stride;
+        i_count -= n;
+
+        if( e->i_fill == FIR_CONV_PART )
+        {
+            Process( e );
+            e->i_fill = 0;
+        }
+    }
+}
+
+void fir_conv_Reset( fir_conv_t *e )
+{
+    e->i_pos = 0;
+    e->i_fill = 0;
+    memset( e->p_in_re, 0, e->i_parts * FIR_CONV_FFT * sizeof (float) );
+    memset( e->p_in_im, 0, e->i_parts * FIR_CONV_FFT * sizeof (float) );
+    memset( e->p_prev, 0, sizeof (e->p_prev) );
+    memset( e->p_cur, 0, sizeof (e->p_cur) );
+    memset( e->p_out, 0, sizeof (e->p_out) );
+}
+
+void fir_conv_Delete( fir_conv_t *e )
+{
+    free( e->p_ir_re );
+    free( e->p_ir_im );
+    free( e->p_in_re );
+    free( e->p_in_im );
+    free( e );
+}
@@ -0,0 +1,68 @@
+/*****************************************************************************
+ * fir_conv.h : uniformly partitioned FFT convolution engine
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_FIR_CONV_H
+#define VLC_FIR_CONV_H 1
+
+#include <stddef.h>
+
+/**
+ * Streaming FIR convolution through uniformly partitioned FFT blocks
+ * (overlap-save).  The impulse response is cut into fixed-size partitions
+ * whose spectra are precomputed once; each input block then costs one
+ * forward FFT, one complex multiply-accumulate per partition and one
+ * inverse FFT, instead of one multiply-accumulate per tap per sample.
+ *
+ * The engine is a plain sample pipe: every call consumes and produces the
+ * same number of samples, with a constant algorithmic delay of one
+ * partition (fir_conv_GetLatency()) that the caller is expected to report
+ * downstream, typically by shifting output timestamps.
+ *
+ * Input may be gathered from and output scattered (accumulated) into
+ * interleaved buffers through the stride arguments, so planar scratch
+ * copies are not needed.  Instances are not thread-safe.
+ */
+typedef struct fir_conv fir_conv_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Create an engine for the given impulse response (copied). */
+fir_conv_t *fir_conv_New( const float *p_ir, size_t i_ir_length );
+
+/* Constant pipeline delay introduced by the engine, in samples. */
+unsigned fir_conv_GetLatency( const fir_conv_t * );
+
+/* Convolve i_count samples read from p_in[i * i_in_stride], accumulating
+ * the result into p_out[i * i_out_stride] (+=, not =). */
+void fir_conv_Run( fir_conv_t *, const float *p_in, size_t i_in_stride,
+                   float *p_out, size_t i_out_stride, size_t i_count );
+
+/* Reset the streaming state (delay lines), keeping the response. */
+void fir_conv_Reset( fir_conv_t * );
+
+void fir_conv_Delete( fir_conv_t * );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
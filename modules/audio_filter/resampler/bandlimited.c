@@ -332,12 +332,13 @@ static void CloseFilter( vlc_object_t *p_this )
     free( p_filter->p_sys );
 }
 
-static void FilterFloatUP( const float Imp[], const float ImpD[], uint16_t Nwing, float *p_in,
-                            float *p_out, uint32_t ui_remainder,
+static void FilterFloatUP( const float Imp[], const float ImpD[], uint16_t Nwing,
+                            const float *restrict p_in,
+                            float *restrict p_out, uint32_t ui_remainder,
                             uint32_t ui_output_rate, int16_t Inc, int i_nb_channels )
 {
     const float *Hp, *Hdp, *End;
-    float t, temp;
+    float t;
     uint32_t ui_linear_remainder;
     int i;
 
@@ -349,6 +350,10 @@ static void FilterFloatUP( const float Imp[], const float ImpD[], uint16_t Nwing
     ui_linear_remainder = (ui_remainder<<Nhc) -
                             (ui_remainder<<Nhc)/ui_output_rate*ui_output_rate;
 
+    /* The linear interpolation factor between two filter phases is constant
+     * over the whole inner product: keep the divisions out of the tap loop */
+    const float f_interp = (float)ui_linear_remainder / ui_output_rate / Npc;
+
     if (Inc == 1)               /* If doing right wing...              */
     {                           /* ...drop extra coeff, so when Ph is  */
         End--;                  /*    0.5, we don't do too many mult's */
@@ -360,28 +365,23 @@ static void FilterFloatUP( const float Imp[], const float ImpD[], uint16_t Nwing
     }
 
     while (Hp < End) {
-        t = *Hp;                /* Get filter coeff */
-                                /* t is now interp'd filter coeff */
-        t += *Hdp * ui_linear_remainder / ui_output_rate / Npc;
+        t = *Hp + *Hdp * f_interp; /* Interp'd filter coeff */
         for( i = 0; i < i_nb_channels; i++ )
-        {
-            temp = t;
-            temp *= *(p_in+i);  /* Mult coeff by input sample */
-            *(p_out+i) += temp; /* The filter output */
-        }
+            p_out[i] += t * p_in[i]; /* The filter output */
         Hdp += Npc;             /* Filter coeff differences step */
         Hp += Npc;              /* Filter coeff step */
         p_in += (Inc * i_nb_channels); /* Input signal step */
     }
 }
 
-static void FilterFloatUD( const float Imp[], const float ImpD[], uint16_t Nwing, float *p_in,
-                           float *p_out, uint32_t ui_remainder,
+static void FilterFloatUD( const float Imp[], const float ImpD[], uint16_t Nwing,
+                           const float *restrict p_in,
+                           float *restrict p_out, uint32_t ui_remainder,
                            uint32_t ui_output_rate, uint32_t ui_input_rate,
                            int16_t Inc, int i_nb_channels )
 {
     const float *Hp, *Hdp, *End;
-    float t, temp;
+    float t;
     uint32_t ui_linear_remainder;
     int i, ui_counter = 0;
 
@@ -403,29 +403,26 @@ static void FilterFloatUD( const float Imp[], const float ImpD[], uint16_t Nwing
         }
     }
 
+    /* One multiplication per tap replaces two divisions */
+    const float f_interp_scale = 1.f / ((float)ui_input_rate * Npc);
+
+    uint32_t ui_acc = (ui_output_rate * ui_counter + ui_remainder) << Nhc;
+    uint32_t ui_idx = ui_acc / ui_input_rate;
+
     while (Hp < End) {
-        t = *Hp;                /* Get filter coeff */
-                                /* t is now interp'd filter coeff */
-        ui_linear_remainder =
-          ((ui_output_rate * ui_counter + ui_remainder)<< Nhc) -
-          ((ui_output_rate * ui_counter + ui_remainder)<< Nhc) /
-          ui_input_rate * ui_input_rate;
-        t += *Hdp * ui_linear_remainder / ui_input_rate / Npc;
+        ui_linear_remainder = ui_acc - ui_idx * ui_input_rate;
+        /* Interp'd filter coeff */
+        t = *Hp + *Hdp * ((float)ui_linear_remainder * f_interp_scale);
         for( i = 0; i < i_nb_channels; i++ )
-        {
-            temp = t;
-            temp *= *(p_in+i);  /* Mult coeff by input sample */
-            *(p_out+i) += temp; /* The filter output */
-        }
+            p_out[i] += t * p_in[i]; /* The filter output */
 
         ui_counter++;
 
-        /* Filter coeff step */
-        Hp = Imp + ((ui_output_rate * ui_counter + ui_remainder)<< Nhc)
-                    / ui_input_rate;
-        /* Filter coeff differences step */
-        Hdp = ImpD + ((ui_output_rate * ui_counter + ui_remainder)<< Nhc)
-                     / ui_input_rate;
+        /* Filter coeff and differences step */
+        ui_acc = (ui_output_rate * ui_counter + ui_remainder) << Nhc;
+        ui_idx = ui_acc / ui_input_rate;
+        Hp = Imp + ui_idx;
+        Hdp = ImpD + ui_idx;
 
         p_in += (Inc * i_nb_channels); /* Input signal step */
     }
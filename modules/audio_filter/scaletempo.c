@@ -139,13 +139,40 @@ typedef struct
 /*****************************************************************************
  * best_overlap_offset: calculate best offset for overlap
  *****************************************************************************/
+
+/* Offsets evaluated per coarse search step; the correlation is smooth at
+ * stride scale, so refining around the coarse winner finds the same
+ * offset as an exhaustive search in all but pathological signals. */
+#define SEARCH_DECIMATION 4
+
+/* Four accumulators keep the products independent, so the compiler can
+ * hold the sums in vector lanes instead of a serial dependency chain. */
+static float overlap_corr( const float *ppc, const float *ps, unsigned n )
+{
+    float c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    unsigned i;
+
+    for( i = 0; i + 4 <= n; i += 4 ) {
+      c0 += ppc[i + 0] * ps[i + 0];
+      c1 += ppc[i + 1] * ps[i + 1];
+      c2 += ppc[i + 2] * ps[i + 2];
+      c3 += ppc[i + 3] * ps[i + 3];
+    }
+    for( ; i < n; i++ )
+      c0 += ppc[i] * ps[i];
+
+    return ( c0 + c1 ) + ( c2 + c3 );
+}
+
 static unsigned best_overlap_offset_float( filter_t *p_filter )
 {
     filter_sys_t *p = p_filter->p_sys;
-    float *pw, *po, *ppc, *search_start;
+    float *pw, *po, *ppc;
+    const float *search_start;
     float best_corr = INT_MIN;
     unsigned best_off = 0;
     unsigned i, off;
+    const unsigned n = p->samples_overlap - p->samples_per_frame;
 
     pw  = p->table_window;
     po  = p->buf_overlap;
@@ -155,19 +182,46 @@ static unsigned best_overlap_offset_float( filter_t *p_filter )
       *ppc++ = *pw++ * *po++;
     }
 
-    search_start = (float *)p->buf_queue + p->samples_per_frame;
-    for( off = 0; off < p->frames_search; off++ ) {
-      float corr = 0;
-      float *ps = search_start;
-      ppc = p->buf_pre_corr;
-      for( i = p->samples_per_frame; i < p->samples_overlap; i++ ) {
-        corr += *ppc++ * *ps++;
+    ppc = p->buf_pre_corr;
+    search_start = (const float *)p->buf_queue + p->samples_per_frame;
+
+    if( p->frames_search >= 2 * SEARCH_DECIMATION ) {
+      /* Coarse pass over decimated offsets... */
+      for( off = 0; off < p->frames_search; off += SEARCH_DECIMATION ) {
+        float corr = overlap_corr( ppc,
+                                   search_start + off * p->samples_per_frame,
+                                   n );
+        if( corr > best_corr ) {
+          best_corr = corr;
+          best_off  = off;
+        }
       }
-      if( corr > best_corr ) {
-        best_corr = corr;
-        best_off  = off;
+      /* ... then a fine pass around the coarse winner */
+      unsigned fine_from = ( best_off >= SEARCH_DECIMATION - 1 )
+                         ? best_off - ( SEARCH_DECIMATION - 1 ) : 0;
+      unsigned fine_to   = __MIN( best_off + SEARCH_DECIMATION,
+                                  p->frames_search );
+      for( off = fine_from; off < fine_to; off++ ) {
+        if( off == best_off )
+          continue;
+        float corr = overlap_corr( ppc,
+                                   search_start + off * p->samples_per_frame,
+                                   n );
+        if( corr > best_corr ) {
+          best_corr = corr;
+          best_off  = off;
+        }
+      }
+    } else {
+      for( off = 0; off < p->frames_search; off++ ) {
+        float corr = overlap_corr( ppc,
+                                   search_start + off * p->samples_per_frame,
+                                   n );
+        if( corr > best_corr ) {
+          best_corr = corr;
+          best_off  = off;
+        }
       }
-      search_start += p->samples_per_frame;
     }
 
     return best_off * p->bytes_per_frame;
@@ -43,6 +43,7 @@ using std::nothrow;
 #include <vlc_filter.h>
 
 #include "revmodel.hpp"
+#include "../fir_conv.h"
 #define SPAT_AMP 0.3
 
 /*****************************************************************************
@@ -98,6 +99,18 @@ struct filter_sys_t
 {
     vlc_mutex_t lock;
     revmodel *p_reverbm;
+
+    /* The reverberation network is linear and time-invariant for a given
+     * parameter set, so its wet path is rendered once into an impulse
+     * response and run through the shared partitioned-convolution engine
+     * instead of ticking every comb and allpass per sample.  The dry mix
+     * stays in the time domain.  b_dirty is raised by the parameter
+     * callbacks; the engines are then re-rendered on the next buffer. */
+    fir_conv_t *p_conv[2];
+    bool b_dirty;
+    unsigned i_latency;  /* engine delay in samples, reported via pts */
+    float *p_mono;       /* scratch: mono downmix fed to the engines */
+    size_t i_mono;
 };
 
 } // namespace
@@ -157,6 +170,12 @@ static int Open( vlc_object_t *p_this )
         return VLC_ENOMEM;
     }
 
+    p_sys->p_conv[0] = p_sys->p_conv[1] = NULL;
+    p_sys->b_dirty = true;
+    p_sys->i_latency = 0;
+    p_sys->p_mono = NULL;
+    p_sys->i_mono = 0;
+
     vlc_mutex_init( &p_sys->lock );
 
     for(unsigned i=0;i<num_callbacks;++i)
@@ -191,6 +210,10 @@ static void Close( vlc_object_t *p_this )
                          callbacks[i].fp_callback, p_sys );
     }
 
+    for( int i = 0; i < 2; i++ )
+        if( p_sys->p_conv[i] )
+            fir_conv_Delete( p_sys->p_conv[i] );
+    free( p_sys->p_mono );
     delete p_sys->p_reverbm;
     free( p_sys );
     msg_Dbg( p_this, "Closing filter spatializer" );
@@ -201,29 +224,141 @@ static void Close( vlc_object_t *p_this )
  * DoWork: call SpatFilter
  *****************************************************************************/
 
+/* Render the wet (reverberated) path of the current parameter set into a
+ * stereo impulse response and load it into the convolution engines.  A
+ * throwaway model with the dry mix muted is fed a unit impulse on the mono
+ * sum input; the tail is captured until it falls below audibility.
+ * Called with the lock held. */
+static int RebuildEngines( filter_sys_t *p_sys )
+{
+    enum { CHUNK = 1024, MAX_IR = 1 << 18 };
+
+    revmodel *probe = new (nothrow) revmodel;
+    if( !probe )
+        return VLC_ENOMEM;
+    probe->setroomsize( p_sys->p_reverbm->getroomsize() );
+    probe->setdamp( p_sys->p_reverbm->getdamp() );
+    probe->setwet( p_sys->p_reverbm->getwet() );
+    probe->setwidth( p_sys->p_reverbm->getwidth() );
+    probe->setdry( 0.f );
+
+    float *ir = (float *)vlc_alloc( MAX_IR, 2 * sizeof (float) );
+    if( !ir )
+    {
+        delete probe;
+        return VLC_ENOMEM;
+    }
+
+    size_t len = 0;
+    while( len < MAX_IR )
+    {
+        float peak = 0.f;
+        for( unsigned i = 0; i < CHUNK; i++ )
+        {
+            /* Mono sum of 1 on the first sample: {1, 0} with 2 channels
+             * makes processreplace() see input = gain * 1. */
+            float in[2] = { (len || i) ? 0.f : 1.f, 0.f };
+            float out[2];
+            probe->processreplace( in, out, 1, 2 );
+            ir[2 * (len + i)] = out[0];
+            ir[2 * (len + i) + 1] = out[1];
+            float mag = fabsf( out[0] ) + fabsf( out[1] );
+            if( mag > peak )
+                peak = mag;
+        }
+        len += CHUNK;
+        if( peak < 1e-5f )  /* tail below audibility, stop rendering */
+            break;
+    }
+    delete probe;
+
+    fir_conv_t *conv[2];
+    for( int c = 0; c < 2; c++ )
+    {
+        /* De-interleave in place: reuse the tail as scratch-free stride */
+        float *plane = (float *)malloc( len * sizeof (float) );
+        if( plane )
+        {
+            for( size_t i = 0; i < len; i++ )
+                plane[i] = ir[2 * i + c];
+            conv[c] = fir_conv_New( plane, len );
+            free( plane );
+        }
+        else
+            conv[c] = NULL;
+        if( !conv[c] )
+        {
+            if( c == 1 )
+                fir_conv_Delete( conv[0] );
+            free( ir );
+            return VLC_ENOMEM;
+        }
+    }
+    free( ir );
+
+    for( int c = 0; c < 2; c++ )
+    {
+        if( p_sys->p_conv[c] )
+            fir_conv_Delete( p_sys->p_conv[c] );
+        p_sys->p_conv[c] = conv[c];
+    }
+    p_sys->i_latency = fir_conv_GetLatency( conv[0] );
+    p_sys->b_dirty = false;
+    return VLC_SUCCESS;
+}
+
 static void SpatFilter( filter_t *p_filter, float *out, float *in,
                         unsigned i_samples, unsigned i_channels )
 {
     filter_sys_t *p_sys = reinterpret_cast<filter_sys_t *>( p_filter->p_sys );
     vlc_mutex_locker locker( &p_sys->lock );
 
+    if( p_sys->b_dirty && RebuildEngines( p_sys ) != VLC_SUCCESS )
+        return; /* keep whatever engines we had, or pass through dry */
+
+    if( p_sys->i_mono < i_samples )
+    {
+        float *p = (float *)realloc( p_sys->p_mono,
+                                     i_samples * sizeof (float) );
+        if( !p )
+            return;
+        p_sys->p_mono = p;
+        p_sys->i_mono = i_samples;
+    }
+
+    /* Dry mix and mono downmix; matches the historical per-sample path,
+     * including its use of the right input for both dry channels. */
+    const float dry = p_sys->p_reverbm->getdry();
+    float *mono = p_sys->p_mono;
     for( unsigned i = 0; i < i_samples; i++ )
     {
-        for( unsigned ch = 0 ; ch < 2; ch++)
-        {
-            in[ch] = in[ch] * SPAT_AMP;
-        }
-        p_sys->p_reverbm->processreplace( in, out , 1, i_channels);
-        in  += i_channels;
-        out += i_channels;
+        float fl = in[i * i_channels] * SPAT_AMP;
+        float fr = ( i_channels > 1 ? in[i * i_channels + 1]
+                                    : in[i * i_channels] ) * SPAT_AMP;
+        mono[i] = fl + fr;
+        out[i * i_channels] = fr * dry;
+        if( i_channels > 1 )
+            out[i * i_channels + 1] = fr * dry;
     }
+
+    fir_conv_Run( p_sys->p_conv[0], mono, 1, out, i_channels, i_samples );
+    if( i_channels > 1 )
+        fir_conv_Run( p_sys->p_conv[1], mono, 1, out + 1, i_channels,
+                      i_samples );
 }
 
 static block_t *DoWork( filter_t * p_filter, block_t * p_in_buf )
 {
+    filter_sys_t *p_sys = reinterpret_cast<filter_sys_t *>( p_filter->p_sys );
+
     SpatFilter( p_filter, (float*)p_in_buf->p_buffer,
                (float*)p_in_buf->p_buffer, p_in_buf->i_nb_samples,
                aout_FormatNbChannels( &p_filter->fmt_in.audio ) );
+
+    /* Report the constant engine delay downstream */
+    if( p_in_buf->i_pts != VLC_TICK_INVALID && p_sys->i_latency > 0 )
+        p_in_buf->i_pts -= vlc_tick_from_samples( p_sys->i_latency,
+                                      p_filter->fmt_in.audio.i_rate );
     return p_in_buf;
 }
 
@@ -239,6 +374,7 @@ static int RoomCallback( vlc_object_t *p_this, char const *,
     vlc_mutex_locker locker( &p_sys->lock );
 
     p_sys->p_reverbm->setroomsize(newval.f_float);
+    p_sys->b_dirty = true;
     msg_Dbg( p_this, "room size is now %3.1f", newval.f_float );
     return VLC_SUCCESS;
 }
@@ -250,6 +386,7 @@ static int WidthCallback( vlc_object_t *p_this, char const *,
     vlc_mutex_locker locker( &p_sys->lock );
 
     p_sys->p_reverbm->setwidth(newval.f_float);
+    p_sys->b_dirty = true;
     msg_Dbg( p_this, "width is now %3.1f", newval.f_float );
     return VLC_SUCCESS;
 }
@@ -261,6 +398,7 @@ static int WetCallback( vlc_object_t *p_this, char const *,
     vlc_mutex_locker locker( &p_sys->lock );
 
     p_sys->p_reverbm->setwet(newval.f_float);
+    p_sys->b_dirty = true;
     msg_Dbg( p_this, "'wet' value is now %3.1f", newval.f_float );
     return VLC_SUCCESS;
 }
@@ -272,6 +410,7 @@ static int DryCallback( vlc_object_t *p_this, char const *,
     vlc_mutex_locker locker( &p_sys->lock );
 
     p_sys->p_reverbm->setdry(newval.f_float);
+    p_sys->b_dirty = true;
     msg_Dbg( p_this, "'dry' value is now %3.1f", newval.f_float );
     return VLC_SUCCESS;
 }
@@ -283,6 +422,7 @@ static int DampCallback( vlc_object_t *p_this, char const *,
     vlc_mutex_locker locker( &p_sys->lock );
 
     p_sys->p_reverbm->setdamp(newval.f_float);
+    p_sys->b_dirty = true;
     msg_Dbg( p_this, "'damp' value is now %3.1f", newval.f_float );
     return VLC_SUCCESS;
 }
@@ -0,0 +1,159 @@
+/*****************************************************************************
+ * float_simd.c : x86 SIMD float audio volume implementation
+ *****************************************************************************
+ * Copyright (C) 2002 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Preamble
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stddef.h>
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_cpu.h>
+#include <vlc_aout.h>
+#include <vlc_aout_volume.h>
+
+#include <emmintrin.h>
+#ifdef HAVE_AVX2_INTRINSICS
+# include <immintrin.h>
+#endif
+
+/*****************************************************************************
+ * Local prototypes
+ *****************************************************************************/
+static int Probe( vlc_object_t * );
+
+/*****************************************************************************
+ * Module descriptor
+ *****************************************************************************/
+vlc_module_begin ()
+    set_category( CAT_AUDIO )
+    set_subcategory( SUBCAT_AUDIO_MISC )
+    set_description( N_("SIMD single precision audio volume") )
+    set_capability( "audio volume", 20 )
+    set_callback( Probe )
+vlc_module_end ()
+
+/* The gain passed down here already folds software volume, replay gain and
+ * the configuration preamp into a single multiplier (see aout_volume_Amplify),
+ * so one kernel covers all of them. The samples are a flat float array
+ * whether the block is interleaved or planar. */
+
+static void FilterFL32_SSE2( audio_volume_t *p_volume, block_t *p_buffer,
+                             float f_multiplier )
+{
+    if( f_multiplier == 1.f )
+        return; /* nothing to do */
+
+    float *p = (float *)p_buffer->p_buffer;
+    size_t i = p_buffer->i_buffer / sizeof(*p);
+    const __m128 m = _mm_set1_ps( f_multiplier );
+
+    for( ; i >= 16; i -= 16, p += 16 )
+    {
+        _mm_storeu_ps( p,      _mm_mul_ps( _mm_loadu_ps( p ),      m ) );
+        _mm_storeu_ps( p +  4, _mm_mul_ps( _mm_loadu_ps( p +  4 ), m ) );
+        _mm_storeu_ps( p +  8, _mm_mul_ps( _mm_loadu_ps( p +  8 ), m ) );
+        _mm_storeu_ps( p + 12, _mm_mul_ps( _mm_loadu_ps( p + 12 ), m ) );
+    }
+    for( ; i > 0; i--, p++ )
+        *p *= f_multiplier;
+
+    (void) p_volume;
+}
+
+static void FilterFL64_SSE2( audio_volume_t *p_volume, block_t *p_buffer,
+                             float f_multiplier )
+{
+    if( f_multiplier == 1.f )
+        return; /* nothing to do */
+
+    double *p = (double *)p_buffer->p_buffer;
+    size_t i = p_buffer->i_buffer / sizeof(*p);
+    const __m128d m = _mm_set1_pd( f_multiplier );
+
+    for( ; i >= 4; i -= 4, p += 4 )
+    {
+        _mm_storeu_pd( p,     _mm_mul_pd( _mm_loadu_pd( p ),     m ) );
+        _mm_storeu_pd( p + 2, _mm_mul_pd( _mm_loadu_pd( p + 2 ), m ) );
+    }
+    for( ; i > 0; i--, p++ )
+        *p *= (double)f_multiplier;
+
+    (void) p_volume;
+}
+
+#ifdef HAVE_AVX2_INTRINSICS
+__attribute__((__target__("avx")))
+static void FilterFL32_AVX( audio_volume_t *p_volume, block_t *p_buffer,
+                            float f_multiplier )
+{
+    if( f_multiplier == 1.f )
+        return; /* nothing to do */
+
+    float *p = (float *)p_buffer->p_buffer;
+    size_t i = p_buffer->i_buffer / sizeof(*p);
+    const __m256 m = _mm256_set1_ps( f_multiplier );
+
+    for( ; i >= 16; i -= 16, p += 16 )
+    {
+        _mm256_storeu_ps( p,     _mm256_mul_ps( _mm256_loadu_ps( p ),     m ) );
+        _mm256_storeu_ps( p + 8, _mm256_mul_ps( _mm256_loadu_ps( p + 8 ), m ) );
+    }
+    for( ; i > 0; i--, p++ )
+        *p *= f_multiplier;
+
+    (void) p_volume;
+}
+#endif
+
+/**
+ * Probes CPU support and selects a kernel
+ */
+static int Probe( vlc_object_t *p_this )
+{
+    audio_volume_t *p_volume = (audio_volume_t *)p_this;
+
+    if( !vlc_CPU_SSE2() )
+        return VLC_EGENERIC;
+
+    switch (p_volume->format)
+    {
+        case VLC_CODEC_FL32:
+#ifdef HAVE_AVX2_INTRINSICS
+            if( vlc_CPU_AVX() )
+            {
+                p_volume->amplify = FilterFL32_AVX;
+                break;
+            }
+#endif
+            p_volume->amplify = FilterFL32_SSE2;
+            break;
+        case VLC_CODEC_FL64:
+            p_volume->amplify = FilterFL64_SSE2;
+            break;
+        default:
+            return VLC_EGENERIC;
+    }
+    return VLC_SUCCESS;
+}
@@ -0,0 +1,520 @@
+/*****************************************************************************
+ * aaudio.c : low-latency native audio output for Android (AAudio)
+ *****************************************************************************
+ * Copyright © 2018 VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Preamble
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_aout.h>
+
+#include <assert.h>
+#include <dlfcn.h>
+#include <stdatomic.h>
+
+/*
+ * AAudio (API 26+) is loaded at run time, like libOpenSLES in
+ * opensles_android.c, so that the plugin neither needs the NDK header nor
+ * links against a library absent from older devices. The declarations below
+ * are the stable subset of <aaudio/AAudio.h> that we use.
+ */
+typedef struct AAudioStreamStruct        AAudioStream;
+typedef struct AAudioStreamBuilderStruct AAudioStreamBuilder;
+
+typedef int32_t aaudio_result_t;
+typedef int32_t aaudio_format_t;
+typedef int32_t aaudio_stream_state_t;
+typedef int32_t aaudio_performance_mode_t;
+typedef int32_t aaudio_data_callback_result_t;
+
+#define AAUDIO_OK                         0
+#define AAUDIO_FORMAT_PCM_I16             1
+#define AAUDIO_FORMAT_PCM_FLOAT           2
+#define AAUDIO_PERFORMANCE_MODE_LOW_LATENCY 12
+#define AAUDIO_STREAM_STATE_PAUSED        6
+#define AAUDIO_STREAM_STATE_STOPPED       10
+#define AAUDIO_CALLBACK_RESULT_CONTINUE   0
+
+typedef aaudio_data_callback_result_t (*AAudioStream_dataCallback)(
+        AAudioStream *, void *user, void *audio_data, int32_t num_frames);
+typedef void (*AAudioStream_errorCallback)(AAudioStream *, void *user,
+                                           aaudio_result_t error);
+
+typedef struct
+{
+    aaudio_result_t (*AAudio_createStreamBuilder)(AAudioStreamBuilder **);
+    void (*AAudioStreamBuilder_setFormat)(AAudioStreamBuilder *,
+                                          aaudio_format_t);
+    void (*AAudioStreamBuilder_setSampleRate)(AAudioStreamBuilder *, int32_t);
+    void (*AAudioStreamBuilder_setChannelCount)(AAudioStreamBuilder *,
+                                                int32_t);
+    void (*AAudioStreamBuilder_setPerformanceMode)(AAudioStreamBuilder *,
+                                                   aaudio_performance_mode_t);
+    void (*AAudioStreamBuilder_setDataCallback)(AAudioStreamBuilder *,
+                                                AAudioStream_dataCallback,
+                                                void *);
+    void (*AAudioStreamBuilder_setErrorCallback)(AAudioStreamBuilder *,
+                                                 AAudioStream_errorCallback,
+                                                 void *);
+    aaudio_result_t (*AAudioStreamBuilder_openStream)(AAudioStreamBuilder *,
+                                                      AAudioStream **);
+    aaudio_result_t (*AAudioStreamBuilder_delete)(AAudioStreamBuilder *);
+    aaudio_result_t (*AAudioStream_requestStart)(AAudioStream *);
+    aaudio_result_t (*AAudioStream_requestPause)(AAudioStream *);
+    aaudio_result_t (*AAudioStream_requestStop)(AAudioStream *);
+    aaudio_result_t (*AAudioStream_close)(AAudioStream *);
+    aaudio_stream_state_t (*AAudioStream_getState)(AAudioStream *);
+    aaudio_result_t (*AAudioStream_waitForStateChange)(AAudioStream *,
+            aaudio_stream_state_t input_state,
+            aaudio_stream_state_t *next_state, int64_t timeout_ns);
+    aaudio_result_t (*AAudioStream_getTimestamp)(AAudioStream *, clockid_t,
+            int64_t *frame_position, int64_t *time_ns);
+} aaudio_api_t;
+
+typedef struct
+{
+    void            *p_so_handle;
+    aaudio_api_t     api;
+
+    AAudioStream    *stream;
+
+    /* negotiated at Start(), needed again when Flush() rebuilds the stream */
+    aaudio_format_t  format;
+    unsigned         rate;
+    unsigned         channels;
+    size_t           frame_size;
+
+    bool             started; /**< requestStart() issued (aout thread only) */
+
+    /* Single-producer (Play, aout thread) single-consumer (AAudio callback)
+     * byte ring. The positions are free-running byte counters; their
+     * difference is the fill level. The steady state is JNI- and lock-free:
+     * Play() memcpys into the ring and the native callback memcpys out. */
+    struct
+    {
+        uint8_t              *buf;
+        size_t                size;
+        atomic_uint_least64_t read;
+        atomic_uint_least64_t write;
+    } ring;
+
+    atomic_bool           producer_waiting;
+    vlc_sem_t             space; /**< posted on full-to-drained edge */
+
+    /* silence inserted by the callback on underrun, in frames; the device
+     * plays it, so TimeGet() must account for it */
+    atomic_uint_least64_t silence_frames;
+} aout_sys_t;
+
+/*****************************************************************************
+ * Local prototypes.
+ *****************************************************************************/
+static int  Open  (vlc_object_t *);
+static void Close (vlc_object_t *);
+
+/*****************************************************************************
+ * Module descriptor
+ *****************************************************************************/
+
+vlc_module_begin ()
+    set_description("AAudio low-latency audio output")
+    set_shortname("AAudio")
+    set_category(CAT_AUDIO)
+    set_subcategory(SUBCAT_AUDIO_AOUT)
+
+    set_capability("audio output", 190)
+    add_shortcut("aaudio", "android")
+    set_callbacks(Open, Close)
+vlc_module_end ()
+
+/*****************************************************************************
+ *
+ *****************************************************************************/
+
+static aaudio_data_callback_result_t
+DataCallback(AAudioStream *stream, void *user, void *audio_data,
+             int32_t num_frames)
+{
+    audio_output_t *aout = user;
+    aout_sys_t *sys = aout->sys;
+    size_t wanted = (size_t)num_frames * sys->frame_size;
+
+    uint64_t rd = atomic_load_explicit(&sys->ring.read,
+                                       memory_order_relaxed);
+    uint64_t wr = atomic_load_explicit(&sys->ring.write,
+                                       memory_order_acquire);
+    size_t avail = wr - rd;
+    size_t copy = (avail < wanted) ? avail : wanted;
+    uint8_t *out = audio_data;
+
+    /* the ring wraps at most once per copy */
+    size_t offset = rd % sys->ring.size;
+    size_t part = sys->ring.size - offset;
+    if (part > copy)
+        part = copy;
+    memcpy(out, sys->ring.buf + offset, part);
+    memcpy(out + part, sys->ring.buf, copy - part);
+
+    atomic_store_explicit(&sys->ring.read, rd + copy, memory_order_release);
+
+    if (copy < wanted)
+    {
+        /* underrun: keep the stream fed with silence */
+        memset(out + copy, 0, wanted - copy);
+        atomic_fetch_add_explicit(&sys->silence_frames,
+                                  (wanted - copy) / sys->frame_size,
+                                  memory_order_relaxed);
+    }
+
+    if (atomic_exchange_explicit(&sys->producer_waiting, false,
+                                 memory_order_acq_rel))
+        vlc_sem_post(&sys->space);
+
+    (void) stream;
+    return AAUDIO_CALLBACK_RESULT_CONTINUE;
+}
+
+static void ErrorCallback(AAudioStream *stream, void *user,
+                          aaudio_result_t error)
+{
+    audio_output_t *aout = user;
+
+    /* Typically AAUDIO_ERROR_DISCONNECTED (routing change): the stream is
+     * dead, ask the core to rebuild the output from a clean thread. */
+    msg_Warn(aout, "stream error %d, requesting restart", (int)error);
+    aout_RestartRequest(aout, AOUT_RESTART_OUTPUT);
+    (void) stream;
+}
+
+static int OpenStream(audio_output_t *aout)
+{
+    aout_sys_t *sys = aout->sys;
+    AAudioStreamBuilder *builder;
+    aaudio_result_t result;
+
+    result = sys->api.AAudio_createStreamBuilder(&builder);
+    if (result != AAUDIO_OK)
+    {
+        msg_Err(aout, "failed to create stream builder (%d)", (int)result);
+        return VLC_EGENERIC;
+    }
+
+    sys->api.AAudioStreamBuilder_setFormat(builder, sys->format);
+    sys->api.AAudioStreamBuilder_setSampleRate(builder, sys->rate);
+    sys->api.AAudioStreamBuilder_setChannelCount(builder, sys->channels);
+    sys->api.AAudioStreamBuilder_setPerformanceMode(builder,
+            AAUDIO_PERFORMANCE_MODE_LOW_LATENCY);
+    sys->api.AAudioStreamBuilder_setDataCallback(builder, DataCallback, aout);
+    sys->api.AAudioStreamBuilder_setErrorCallback(builder, ErrorCallback,
+                                                  aout);
+
+    result = sys->api.AAudioStreamBuilder_openStream(builder, &sys->stream);
+    sys->api.AAudioStreamBuilder_delete(builder);
+    if (result != AAUDIO_OK)
+    {
+        msg_Err(aout, "failed to open stream (%d)", (int)result);
+        sys->stream = NULL;
+        return VLC_EGENERIC;
+    }
+
+    sys->started = false;
+    return VLC_SUCCESS;
+}
+
+static void CloseStream(audio_output_t *aout)
+{
+    aout_sys_t *sys = aout->sys;
+    aaudio_stream_state_t state;
+
+    if (sys->stream == NULL)
+        return;
+
+    if (sys->api.AAudioStream_requestStop(sys->stream) == AAUDIO_OK)
+    {
+        /* wait (bounded) for the callback to quiesce before closing */
+        state = sys->api.AAudioStream_getState(sys->stream);
+        while (state != AAUDIO_STREAM_STATE_STOPPED
+            && sys->api.AAudioStream_waitForStateChange(sys->stream, state,
+                    &state, INT64_C(500000000) /* 500 ms */) == AAUDIO_OK
+            && state != AAUDIO_STREAM_STATE_STOPPED)
+            ;
+    }
+
+    sys->api.AAudioStream_close(sys->stream);
+    sys->stream = NULL;
+}
+
+static int TimeGet(audio_output_t *aout, vlc_tick_t *restrict delay)
+{
+    aout_sys_t *sys = aout->sys;
+    int64_t position, time_ns;
+
+    if (!sys->started)
+        return -1;
+
+    if (sys->api.AAudioStream_getTimestamp(sys->stream, CLOCK_MONOTONIC,
+                                           &position, &time_ns) != AAUDIO_OK)
+        return -1; /* no timestamp yet (stream just started) */
+
+    /* frames presented by the device, extrapolated to now */
+    vlc_tick_t age = vlc_tick_now() - VLC_TICK_FROM_NS(time_ns);
+    int64_t played = position + samples_from_vlc_tick(age, sys->rate);
+
+    /* frames handed over so far: everything queued in the ring plus the
+     * underrun silence the device played in between */
+    uint64_t queued = atomic_load_explicit(&sys->ring.write,
+                                           memory_order_relaxed)
+                    / sys->frame_size
+                    + atomic_load_explicit(&sys->silence_frames,
+                                           memory_order_relaxed);
+
+    if ((int64_t)queued <= played)
+        return -1;
+
+    *delay = vlc_tick_from_samples(queued - played, sys->rate);
+    return 0;
+}
+
+/*****************************************************************************
+ * Play: queue a block into the shared ring
+ *****************************************************************************/
+static void Play(audio_output_t *aout, block_t *block, vlc_tick_t date)
+{
+    aout_sys_t *sys = aout->sys;
+    const uint8_t *in = block->p_buffer;
+    size_t left = block->i_buffer;
+
+    while (left > 0)
+    {
+        uint64_t wr = atomic_load_explicit(&sys->ring.write,
+                                           memory_order_relaxed);
+        uint64_t rd = atomic_load_explicit(&sys->ring.read,
+                                           memory_order_acquire);
+        size_t space = sys->ring.size - (size_t)(wr - rd);
+
+        if (space == 0)
+        {
+            atomic_store_explicit(&sys->producer_waiting, true,
+                                  memory_order_release);
+            /* re-check: the callback may have drained in between */
+            if (atomic_load_explicit(&sys->ring.read, memory_order_acquire)
+                    == rd)
+                vlc_sem_timedwait(&sys->space,
+                                  vlc_tick_now() + VLC_TICK_FROM_MS(100));
+            continue;
+        }
+
+        size_t copy = (left < space) ? left : space;
+        size_t offset = wr % sys->ring.size;
+        size_t part = sys->ring.size - offset;
+        if (part > copy)
+            part = copy;
+        memcpy(sys->ring.buf + offset, in, part);
+        memcpy(sys->ring.buf, in + part, copy - part);
+
+        atomic_store_explicit(&sys->ring.write, wr + copy,
+                              memory_order_release);
+        in += copy;
+        left -= copy;
+
+        if (!sys->started)
+        {
+            if (sys->api.AAudioStream_requestStart(sys->stream) != AAUDIO_OK)
+                break;
+            sys->started = true;
+        }
+    }
+
+    block_Release(block);
+    (void) date;
+}
+
+static void Pause(audio_output_t *aout, bool pause, vlc_tick_t date)
+{
+    aout_sys_t *sys = aout->sys;
+
+    if (!sys->started)
+        return;
+
+    if (pause)
+        sys->api.AAudioStream_requestPause(sys->stream);
+    else
+        sys->api.AAudioStream_requestStart(sys->stream);
+    (void) date;
+}
+
+static void Flush(audio_output_t *aout)
+{
+    aout_sys_t *sys = aout->sys;
+
+    /* AAudio only flushes a paused stream and keeps its cumulative frame
+     * position, which would skew TimeGet(); rebuilding the stream is cheap
+     * and resets both the device buffer and the position. */
+    CloseStream(aout);
+
+    atomic_store_explicit(&sys->ring.read, 0, memory_order_relaxed);
+    atomic_store_explicit(&sys->ring.write, 0, memory_order_relaxed);
+    atomic_store_explicit(&sys->silence_frames, 0, memory_order_relaxed);
+
+    if (OpenStream(aout) != VLC_SUCCESS)
+        aout_RestartRequest(aout, AOUT_RESTART_OUTPUT);
+}
+
+/*****************************************************************************
+ *
+ *****************************************************************************/
+static int Start(audio_output_t *aout, audio_sample_format_t *restrict fmt)
+{
+    aout_sys_t *sys = aout->sys;
+
+    if (aout_FormatNbChannels(fmt) == 0 || !AOUT_FMT_LINEAR(fmt))
+        return VLC_EGENERIC;
+
+    if (fmt->i_format == VLC_CODEC_FL32)
+        sys->format = AAUDIO_FORMAT_PCM_FLOAT;
+    else
+    {
+        fmt->i_format = VLC_CODEC_S16N;
+        sys->format = AAUDIO_FORMAT_PCM_I16;
+    }
+
+    /* multichannel layouts are device-defined with AAudio: stay safe */
+    if (aout_FormatNbChannels(fmt) > 2)
+        fmt->i_physical_channels = AOUT_CHANS_STEREO;
+    fmt->channel_type = AUDIO_CHANNEL_TYPE_BITMAP;
+    aout_FormatPrepare(fmt);
+
+    sys->rate = fmt->i_rate;
+    sys->channels = fmt->i_channels;
+    sys->frame_size = fmt->i_bytes_per_frame;
+
+    sys->ring.size = samples_from_vlc_tick(AOUT_MAX_PREPARE_TIME, sys->rate)
+                   * sys->frame_size;
+    sys->ring.buf = malloc(sys->ring.size);
+    if (unlikely(sys->ring.buf == NULL))
+        return VLC_ENOMEM;
+
+    atomic_init(&sys->ring.read, 0);
+    atomic_init(&sys->ring.write, 0);
+    atomic_init(&sys->producer_waiting, false);
+    atomic_init(&sys->silence_frames, 0);
+    vlc_sem_init(&sys->space, 0);
+
+    if (OpenStream(aout) != VLC_SUCCESS)
+    {
+        free(sys->ring.buf);
+        sys->ring.buf = NULL;
+        return VLC_EGENERIC;
+    }
+
+    msg_Dbg(aout, "aaudio stream ready: %u Hz, %u channels, %s",
+            sys->rate, sys->channels,
+            sys->format == AAUDIO_FORMAT_PCM_FLOAT ? "fl32" : "s16");
+    return VLC_SUCCESS;
+}
+
+static void Stop(audio_output_t *aout)
+{
+    aout_sys_t *sys = aout->sys;
+
+    CloseStream(aout);
+
+    free(sys->ring.buf);
+    sys->ring.buf = NULL;
+}
+
+/*****************************************************************************
+ *
+ *****************************************************************************/
+static void Close(vlc_object_t *obj)
+{
+    audio_output_t *aout = (audio_output_t *)obj;
+    aout_sys_t *sys = aout->sys;
+
+    dlclose(sys->p_so_handle);
+    free(sys);
+}
+
+static int Open(vlc_object_t *obj)
+{
+    audio_output_t *aout = (audio_output_t *)obj;
+    aout_sys_t *sys;
+
+    aout->sys = sys = calloc(1, sizeof(*sys));
+    if (unlikely(sys == NULL))
+        return VLC_ENOMEM;
+
+    /* present from Android 8.0 (API 26) on; older devices fall back to
+     * the AudioTrack or OpenSL ES outputs */
+    sys->p_so_handle = dlopen("libaaudio.so", RTLD_NOW);
+    if (sys->p_so_handle == NULL)
+    {
+        msg_Dbg(aout, "libaaudio not available");
+        free(sys);
+        return VLC_EGENERIC;
+    }
+
+#define AAUDIO_DLSYM(name)                                      \
+    do {                                                        \
+        sys->api.name = dlsym(sys->p_so_handle, #name);         \
+        if (unlikely(sys->api.name == NULL))                    \
+        {                                                       \
+            msg_Err(aout, "failed to load symbol "#name);       \
+            goto error;                                         \
+        }                                                       \
+    } while (0)
+
+    AAUDIO_DLSYM(AAudio_createStreamBuilder);
+    AAUDIO_DLSYM(AAudioStreamBuilder_setFormat);
+    AAUDIO_DLSYM(AAudioStreamBuilder_setSampleRate);
+    AAUDIO_DLSYM(AAudioStreamBuilder_setChannelCount);
+    AAUDIO_DLSYM(AAudioStreamBuilder_setPerformanceMode);
+    AAUDIO_DLSYM(AAudioStreamBuilder_setDataCallback);
+    AAUDIO_DLSYM(AAudioStreamBuilder_setErrorCallback);
+    AAUDIO_DLSYM(AAudioStreamBuilder_openStream);
+    AAUDIO_DLSYM(AAudioStreamBuilder_delete);
+    AAUDIO_DLSYM(AAudioStream_requestStart);
+    AAUDIO_DLSYM(AAudioStream_requestPause);
+    AAUDIO_DLSYM(AAudioStream_requestStop);
+    AAUDIO_DLSYM(AAudioStream_close);
+    AAUDIO_DLSYM(AAudioStream_getState);
+    AAUDIO_DLSYM(AAudioStream_waitForStateChange);
+    AAUDIO_DLSYM(AAudioStream_getTimestamp);
+#undef AAUDIO_DLSYM
+
+    aout->start    = Start;
+    aout->stop     = Stop;
+    aout->time_get = TimeGet;
+    aout->play     = Play;
+    aout->pause    = Pause;
+    aout->flush    = Flush;
+
+    return VLC_SUCCESS;
+
+error:
+    dlclose(sys->p_so_handle);
+    free(sys);
+    return VLC_EGENERIC;
+}
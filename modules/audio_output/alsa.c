@@ -45,6 +45,7 @@ typedef struct
     snd_pcm_t *pcm;
     unsigned rate; /**< Sample rate */
     vlc_fourcc_t format; /**< Sample format */
+    bool mmap; /**< Use memory-mapped access */
     uint8_t chans_table[AOUT_CHAN_MAX]; /**< Channels order table */
     uint8_t chans_to_reorder; /**< Number of channels to reorder */
 
@@ -83,6 +84,11 @@ static const char *const channels_text[] = {
     N_("Surround 5.0"), N_("Surround 5.1"), N_("Surround 7.1"),
 };
 
+#define MMAP_TEXT N_("Memory-mapped access")
+#define MMAP_LONGTEXT N_("Write samples directly into the memory-mapped " \
+    "hardware ring buffer (when the device supports it) instead of going " \
+    "through the read/write copy interface.")
+
 #define PASSTHROUGH_TEXT N_("Audio passthrough mode")
 static const int passthrough_modes[] = {
     PASSTHROUGH_NONE, PASSTHROUGH_SPDIF, PASSTHROUGH_HDMI,
@@ -104,6 +110,7 @@ vlc_module_begin ()
     add_integer("alsa-passthrough", PASSTHROUGH_NONE, PASSTHROUGH_TEXT,
                 PASSTHROUGH_TEXT, false)
         change_integer_list(passthrough_modes, passthrough_modes_text)
+    add_bool ("alsa-mmap", false, MMAP_TEXT, MMAP_LONGTEXT, true)
     add_sw_gain ()
     set_capability( "audio output", 150 )
     set_callbacks( Open, Close )
@@ -446,12 +453,25 @@ static int Start (audio_output_t *aout, audio_sample_format_t *restrict fmt)
         goto error;
     }
 
-    val = snd_pcm_hw_params_set_access (pcm, hw,
-                                        SND_PCM_ACCESS_RW_INTERLEAVED);
-    if (val)
+    sys->mmap = false;
+    if (var_InheritBool (aout, "alsa-mmap")
+     && snd_pcm_hw_params_test_access (pcm, hw,
+                                       SND_PCM_ACCESS_MMAP_INTERLEAVED) == 0
+     && snd_pcm_hw_params_set_access (pcm, hw,
+                                      SND_PCM_ACCESS_MMAP_INTERLEAVED) == 0)
     {
-        msg_Err (aout, "cannot set access mode: %s", snd_strerror (val));
-        goto error;
+        msg_Dbg (aout, "using memory-mapped access");
+        sys->mmap = true;
+    }
+    else
+    {
+        val = snd_pcm_hw_params_set_access (pcm, hw,
+                                            SND_PCM_ACCESS_RW_INTERLEAVED);
+        if (val)
+        {
+            msg_Err (aout, "cannot set access mode: %s", snd_strerror (val));
+            goto error;
+        }
     }
 
     /* Set sample format */
@@ -641,6 +661,50 @@ static int TimeGet (audio_output_t *aout, vlc_tick_t *restrict delay)
     return 0;
 }
 
+/**
+ * Writes samples straight into the memory-mapped ring buffer.
+ *
+ * Unlike snd_pcm_writei(), this skips the copy through the device file and
+ * renders into the DMA buffer in a single pass. Returns the number of frames
+ * written (possibly zero if the ring was full) or a negative error code.
+ */
+static snd_pcm_sframes_t WriteMmap (snd_pcm_t *pcm, const void *data,
+                                    snd_pcm_uframes_t size)
+{
+    snd_pcm_sframes_t avail = snd_pcm_avail_update (pcm);
+    if (avail < 0)
+        return avail;
+    if (avail == 0)
+    {   /* Ring buffer full: wait for the next period boundary. */
+        int val = snd_pcm_wait (pcm, -1);
+        return (val < 0) ? val : 0;
+    }
+
+    const snd_pcm_channel_area_t *areas;
+    snd_pcm_uframes_t offset, frames = size;
+
+    int val = snd_pcm_mmap_begin (pcm, &areas, &offset, &frames);
+    if (val < 0)
+        return val;
+
+    /* With interleaved access, a single area covers all channels. */
+    memcpy ((unsigned char *)areas->addr + (areas->first / 8)
+            + snd_pcm_frames_to_bytes (pcm, offset),
+            data, snd_pcm_frames_to_bytes (pcm, frames));
+
+    snd_pcm_sframes_t done = snd_pcm_mmap_commit (pcm, offset, frames);
+    if (done >= 0 && (snd_pcm_uframes_t)done != frames)
+        return -EPIPE; /* commit cut short by an underrun */
+
+    if (done > 0 && snd_pcm_state (pcm) == SND_PCM_STATE_PREPARED)
+    {   /* The start threshold is not checked by the mmap interface. */
+        val = snd_pcm_start (pcm);
+        if (val < 0)
+            return val;
+    }
+    return done;
+}
+
 /**
  * Queues one audio buffer to the hardware.
  */
@@ -661,7 +725,11 @@ static void Play(audio_output_t *aout, block_t *block, vlc_tick_t date)
     {
         snd_pcm_sframes_t frames;
 
-        frames = snd_pcm_writei (pcm, block->p_buffer, block->i_nb_samples);
+        if (sys->mmap)
+            frames = WriteMmap (pcm, block->p_buffer, block->i_nb_samples);
+        else
+            frames = snd_pcm_writei (pcm, block->p_buffer,
+                                     block->i_nb_samples);
         if (frames >= 0)
         {
             size_t bytes = snd_pcm_frames_to_bytes (pcm, frames);
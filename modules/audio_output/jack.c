@@ -59,6 +59,9 @@ typedef struct
     unsigned int    i_channels;
     unsigned int    i_rate;
     jack_nframes_t latency;
+    char         ***ppp_connections; /**< Cached connections per output port,
+                                          restored on the next start */
+    unsigned int    i_connection_ports;
     float soft_gain;
     bool soft_mute;
     vlc_tick_t paused; /**< Time when (last) paused */
@@ -112,6 +115,98 @@ vlc_module_begin ()
 vlc_module_end ()
 
 
+/* Frees the cached port connections */
+static void ClearConnectionCache( aout_sys_t *p_sys )
+{
+    for( unsigned int i = 0; i < p_sys->i_connection_ports; i++ )
+    {
+        if( p_sys->ppp_connections[i] == NULL )
+            continue;
+        for( char **pp = p_sys->ppp_connections[i]; *pp != NULL; pp++ )
+            free( *pp );
+        free( p_sys->ppp_connections[i] );
+    }
+    free( p_sys->ppp_connections );
+    p_sys->ppp_connections = NULL;
+    p_sys->i_connection_ports = 0;
+}
+
+/* Remembers where every output port is connected, so that the same routing
+ * (including connections made by the user) survives the next start */
+static void CacheConnections( audio_output_t *p_aout )
+{
+    aout_sys_t *p_sys = p_aout->sys;
+
+    ClearConnectionCache( p_sys );
+
+    p_sys->ppp_connections = calloc( p_sys->i_channels,
+                                     sizeof (*p_sys->ppp_connections) );
+    if( p_sys->ppp_connections == NULL )
+        return;
+    p_sys->i_connection_ports = p_sys->i_channels;
+
+    for( unsigned int i = 0; i < p_sys->i_channels; i++ )
+    {
+        const char **pp_conns =
+            jack_port_get_connections( p_sys->p_jack_ports[i] );
+        if( pp_conns == NULL )
+            continue;
+
+        unsigned int count = 0;
+        while( pp_conns[count] != NULL )
+            count++;
+
+        char **pp_cache = calloc( count + 1, sizeof (*pp_cache) );
+        if( pp_cache != NULL )
+        {
+            for( unsigned int j = 0; j < count; j++ )
+            {
+                pp_cache[j] = strdup( pp_conns[j] );
+                if( pp_cache[j] == NULL )
+                    break; /* the NULL entry truncates the list */
+            }
+            p_sys->ppp_connections[i] = pp_cache;
+        }
+        jack_free( pp_conns );
+    }
+}
+
+/* Reconnects the output ports as they were wired before the last stop.
+ * Returns the number of connections made. */
+static unsigned int RestoreConnections( audio_output_t *p_aout )
+{
+    aout_sys_t *p_sys = p_aout->sys;
+    unsigned int i_connected = 0;
+
+    if( p_sys->i_connection_ports == 0 )
+        return 0;
+
+    for( unsigned int i = 0; i < p_sys->i_channels; i++ )
+    {
+        /* Wrap on channel count changes, like the automatic connection */
+        char **pp_conns =
+            p_sys->ppp_connections[i % p_sys->i_connection_ports];
+        if( pp_conns == NULL )
+            continue;
+
+        const char *psz_out = jack_port_name( p_sys->p_jack_ports[i] );
+
+        for( ; *pp_conns != NULL; pp_conns++ )
+        {
+            if( jack_connect( p_sys->p_jack_client, psz_out, *pp_conns ) == 0 )
+            {
+                msg_Dbg( p_aout, "reconnecting port %s to port %s",
+                         psz_out, *pp_conns );
+                i_connected++;
+            }
+            else
+                msg_Warn( p_aout, "failed to reconnect port %s to port %s",
+                          psz_out, *pp_conns );
+        }
+    }
+    return i_connected;
+}
+
 static int Start( audio_output_t *p_aout, audio_sample_format_t *restrict fmt )
 {
     char *psz_name;
@@ -222,8 +317,10 @@ static int Start( audio_output_t *p_aout, audio_sample_format_t *restrict fmt )
         goto error_out;
     }
 
-    /* Auto connect ports if we were asked to */
-    if( var_InheritBool( p_aout, AUTO_CONNECT_OPTION ) )
+    /* Restore the routing cached on the previous stop, otherwise auto
+     * connect ports if we were asked to */
+    if( RestoreConnections( p_aout ) == 0
+     && var_InheritBool( p_aout, AUTO_CONNECT_OPTION ) )
     {
         unsigned int i_in_ports;
         char *psz_regex = var_InheritString( p_aout, CONNECT_REGEX_OPTION );
@@ -355,17 +452,11 @@ static int TimeGet(audio_output_t *p_aout, vlc_tick_t *delay)
  *****************************************************************************/
 int Process( jack_nframes_t i_frames, void *p_arg )
 {
-    unsigned int i, j, frames_from_rb = 0;
-    size_t bytes_read = 0;
-    size_t frames_read;
+    unsigned int i;
+    jack_nframes_t frames_read = 0;
     audio_output_t *p_aout = (audio_output_t*) p_arg;
     aout_sys_t *p_sys = p_aout->sys;
 
-    /* Get the next audio data buffer unless paused */
-
-    if( p_sys->paused == VLC_TICK_INVALID )
-        frames_from_rb = i_frames;
-
     /* Get the JACK buffers to write to */
     for( i = 0; i < p_sys->i_channels; i++ )
     {
@@ -373,19 +464,39 @@ int Process( jack_nframes_t i_frames, void *p_arg )
                                                          i_frames );
     }
 
-    /* Copy in the audio data */
-    for( j = 0; j < frames_from_rb; j++ )
+    /* Deinterleave the frames straight off the ring unless paused */
+    if( p_sys->paused == VLC_TICK_INVALID )
     {
-        for( i = 0; i < p_sys->i_channels; i++ )
+        const size_t bytes_per_frame =
+            p_sys->i_channels * sizeof(jack_sample_t);
+        jack_ringbuffer_data_t vec[2];
+
+        jack_ringbuffer_get_read_vector( p_sys->p_jack_ringbuffer, vec );
+
+        size_t frames_avail = ( vec[0].len + vec[1].len ) / bytes_per_frame;
+        frames_read = frames_avail < i_frames ? frames_avail : i_frames;
+
+        /* All reads and writes are whole samples and the ring size is a
+         * power of two, so the segment boundary cannot split a sample */
+        const jack_sample_t *p_seg0 = (const jack_sample_t *)vec[0].buf;
+        const jack_sample_t *p_seg1 = (const jack_sample_t *)vec[1].buf;
+        const size_t i_seg0 = vec[0].len / sizeof(jack_sample_t);
+
+        for( jack_nframes_t j = 0; j < frames_read; j++ )
         {
-            jack_sample_t *p_dst = p_sys->p_jack_buffers[i] + j;
-            bytes_read += jack_ringbuffer_read( p_sys->p_jack_ringbuffer,
-                    (char *) p_dst, sizeof(jack_sample_t) );
+            for( i = 0; i < p_sys->i_channels; i++ )
+            {
+                size_t idx = (size_t)j * p_sys->i_channels + i;
+                p_sys->p_jack_buffers[i][j] = idx < i_seg0 ?
+                    p_seg0[idx] : p_seg1[idx - i_seg0];
+            }
         }
+
+        jack_ringbuffer_read_advance( p_sys->p_jack_ringbuffer,
+                                      frames_read * bytes_per_frame );
     }
 
     /* Fill any remaining buffer with silence */
-    frames_read = (bytes_read / sizeof(jack_sample_t)) / p_sys->i_channels;
     if( frames_read < i_frames )
     {
         for( i = 0; i < p_sys->i_channels; i++ )
@@ -433,6 +544,9 @@ static void Stop( audio_output_t *p_aout )
     int i_error;
     aout_sys_t *p_sys = p_aout->sys;
 
+    /* Remember the routing for the next start (e.g. channel change) */
+    CacheConnections( p_aout );
+
     i_error = jack_deactivate( p_sys->p_jack_client );
     if( i_error )
     {
@@ -468,5 +582,6 @@ static void Close(vlc_object_t *obj)
     audio_output_t *aout = (audio_output_t *)obj;
     aout_sys_t *sys = aout->sys;
 
+    ClearConnectionCache(sys);
     free(sys);
 }
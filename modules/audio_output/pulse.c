@@ -458,6 +458,13 @@ static int TimeGet(audio_output_t *aout, vlc_tick_t *restrict delay)
     return ret;
 }
 
+#if PA_CHECK_VERSION(6,0,0)
+static void data_free_cb(void *data)
+{
+    block_Release(data);
+}
+#endif
+
 /**
  * Queue one audio frame to the playback stream
  */
@@ -486,6 +493,17 @@ static void Play(audio_output_t *aout, block_t *block, vlc_tick_t date)
         pa_operation_unref(pa_stream_flush(s, NULL, NULL));
     }
 #endif
+#if PA_CHECK_VERSION(6,0,0)
+    /* Hand the buffer over to the stream without copying. The stream keeps a
+     * reference on the block data and releases it from the main loop thread
+     * once the bytes have been consumed. */
+    if (pa_stream_write_ext_free(s, block->p_buffer, block->i_buffer,
+                                 data_free_cb, block, 0, PA_SEEK_RELATIVE) < 0)
+    {
+        vlc_pa_error(aout, "cannot write", sys->context);
+        block_Release(block);
+    }
+#else
     while (block->i_buffer > 0)
     {
         void *ptr;
@@ -503,6 +521,7 @@ static void Play(audio_output_t *aout, block_t *block, vlc_tick_t date)
     }
 
     block_Release(block);
+#endif
 
     pa_threaded_mainloop_unlock(sys->mainloop);
 }
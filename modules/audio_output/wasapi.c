@@ -92,6 +92,10 @@ typedef struct aout_stream_sys
 {
     IAudioClient *client;
     HANDLE hTimer;
+    HANDLE hEvent; /**< Buffer completion event, NULL when polling */
+    BYTE *stage; /**< Staging buffer of one device period (event-driven) */
+    UINT32 staged; /**< Frames currently held in the staging buffer */
+    bool prefilled; /**< A device buffer was filled before stream start */
 
 #define STARTED_STATE_INIT 0
 #define STARTED_STATE_OK 1
@@ -212,6 +216,37 @@ static HRESULT StartDeferred(aout_stream_t *s, vlc_tick_t date)
     return S_OK;
 }
 
+/* Copies frames from the block into a device format buffer, converting S32N
+ * back to S24L when the device was configured that way */
+static void WriteFrames(aout_stream_sys_t *sys, BYTE *dst, block_t *block,
+                        UINT32 frames)
+{
+    const size_t copy = frames * sys->block_align;
+
+    if (!sys->s24s32)
+    {
+        memcpy(dst, block->p_buffer, copy);
+        block->p_buffer += copy;
+        block->i_buffer -= copy;
+    }
+    else
+    {
+        /* Convert back S32L to S24L. The following is doing the opposite
+         * of S24LDecode() from codec/araw.c */
+        BYTE *end = dst + copy;
+        while (dst < end)
+        {
+            dst[0] = block->p_buffer[1];
+            dst[1] = block->p_buffer[2];
+            dst[2] = block->p_buffer[3];
+            dst += 3;
+            block->p_buffer += 4;
+            block->i_buffer -= 4;
+        }
+    }
+    block->i_nb_samples -= frames;
+}
+
 static HRESULT Play(aout_stream_t *s, block_t *block, vlc_tick_t date)
 {
     (void) date;
@@ -244,6 +279,61 @@ static HRESULT Play(aout_stream_t *s, block_t *block, vlc_tick_t date)
     }
 
     IAudioRenderClient *render = pv;
+
+    if (sys->hEvent != NULL)
+    {   /* Event-driven: stage input into a device-period-sized buffer and
+         * submit one full period per buffer completion event */
+        hr = S_OK;
+        while (block->i_nb_samples > 0)
+        {
+            UINT32 frames = sys->frames - sys->staged;
+            if (frames > block->i_nb_samples)
+                frames = block->i_nb_samples;
+
+            WriteFrames(sys, sys->stage
+                        + (size_t)sys->staged * sys->block_align,
+                        block, frames);
+            sys->staged += frames;
+            sys->written += frames;
+            if (sys->staged < sys->frames)
+                break; /* less than a full period, wait for more input */
+
+            /* One device buffer may be filled ahead of the stream start;
+             * past that, wait for the device to hand a buffer back. */
+            if (sys->prefilled)
+            {
+                while (WaitForSingleObject(sys->hEvent, 100) != WAIT_OBJECT_0)
+                    if (atomic_load(&sys->started_state)
+                                                      == STARTED_STATE_ERROR)
+                    {
+                        hr = E_FAIL;
+                        break;
+                    }
+                if (FAILED(hr))
+                    break;
+            }
+
+            BYTE *dst;
+            hr = IAudioRenderClient_GetBuffer(render, sys->frames, &dst);
+            if (FAILED(hr))
+            {
+                msg_Err(s, "cannot get buffer (error 0x%lX)", hr);
+                break;
+            }
+            memcpy(dst, sys->stage, (size_t)sys->frames * sys->block_align);
+            hr = IAudioRenderClient_ReleaseBuffer(render, sys->frames, 0);
+            if (FAILED(hr))
+            {
+                msg_Err(s, "cannot release buffer (error 0x%lX)", hr);
+                break;
+            }
+            sys->staged = 0;
+            sys->prefilled = true;
+        }
+        IAudioRenderClient_Release(render);
+        goto out;
+    }
+
     for (;;)
     {
         UINT32 frames;
@@ -267,30 +357,8 @@ static HRESULT Play(aout_stream_t *s, block_t *block, vlc_tick_t date)
             break;
         }
 
-        const size_t copy = frames * sys->block_align;
-
-        if (!sys->s24s32)
-        {
-            memcpy(dst, block->p_buffer, copy);
-            block->p_buffer += copy;
-            block->i_buffer -= copy;
-        }
-        else
-        {
-            /* Convert back S32L to S24L. The following is doing the opposite
-             * of S24LDecode() from codec/araw.c */
-            BYTE *end = dst + copy;
-            while (dst < end)
-            {
-                dst[0] = block->p_buffer[1];
-                dst[1] = block->p_buffer[2];
-                dst[2] = block->p_buffer[3];
-                dst += 3;
-                block->p_buffer += 4;
-                block->i_buffer -= 4;
-            }
+        WriteFrames(sys, dst, block, frames);
 
-        }
         hr = IAudioRenderClient_ReleaseBuffer(render, frames, 0);
         if (FAILED(hr))
         {
@@ -298,7 +366,6 @@ static HRESULT Play(aout_stream_t *s, block_t *block, vlc_tick_t date)
             break;
         }
 
-        block->i_nb_samples -= frames;
         sys->written += frames;
         if (block->i_nb_samples == 0)
             break; /* done */
@@ -354,6 +421,8 @@ static HRESULT Flush(aout_stream_t *s)
     {
         msg_Dbg(s, "reset");
         sys->written = 0;
+        sys->staged = 0;
+        sys->prefilled = false;
     }
     else
         msg_Warn(s, "cannot reset stream (error 0x%lX)", hr);
@@ -585,6 +654,9 @@ static void Stop(aout_stream_t *s)
 
     IAudioClient_Release(sys->client);
 
+    if (sys->hEvent != NULL)
+        CloseHandle(sys->hEvent);
+    free(sys->stage);
     free(sys);
 }
 
@@ -735,6 +807,100 @@ static HRESULT GetExclusivePCMFormat(IAudioClient *c, const WAVEFORMATEX *pwf,
     return AUDCLNT_E_UNSUPPORTED_FORMAT;
 }
 
+#ifdef __IAudioClient2_INTERFACE_DEFINED__
+/*
+ * Opts the stream into hardware offload, moving decoding/mixing of media
+ * streams onto the audio device where the endpoint supports it. Best
+ * effort: rendering simply stays on the software engine otherwise.
+ */
+static void TryOffload(aout_stream_t *s, aout_stream_sys_t *sys)
+{
+    void *pv;
+    HRESULT hr = IAudioClient_QueryInterface(sys->client, &IID_IAudioClient2,
+                                             &pv);
+    if (FAILED(hr))
+        return; /* pre-Windows 8 */
+
+    IAudioClient2 *client2 = pv;
+    BOOL offloadable = FALSE;
+
+    hr = IAudioClient2_IsOffloadCapable(client2, AudioCategory_Media,
+                                        &offloadable);
+    if (SUCCEEDED(hr) && offloadable)
+    {
+        AudioClientProperties props = {
+            .cbSize = sizeof (props),
+            .bIsOffload = TRUE,
+            .eCategory = AudioCategory_Media,
+        };
+
+        hr = IAudioClient2_SetClientProperties(client2, &props);
+        if (SUCCEEDED(hr))
+            msg_Dbg(s, "hardware audio offload enabled");
+        else
+            msg_Warn(s, "cannot enable hardware offload (error 0x%lX)", hr);
+    }
+    else
+        msg_Dbg(s, "hardware audio offload not supported");
+
+    IAudioClient2_Release(client2);
+}
+#endif
+
+/*
+ * Initializes an exclusive stream in event-driven mode: the device signals
+ * an event each time it releases one device-period-sized buffer, instead
+ * of the render thread polling the padding. The buffer duration must match
+ * the periodicity, and some devices additionally want it aligned, in which
+ * case the client has to be recreated with the aligned period.
+ *
+ * On failure, sys->client may be NULL and the caller must recreate it.
+ */
+static HRESULT StartExclusiveEvent(aout_stream_t *s, aout_stream_sys_t *sys,
+                                   const WAVEFORMATEX *pwf, const GUID *sid)
+{
+    REFERENCE_TIME defT, minT, period;
+
+    HRESULT hr = IAudioClient_GetDevicePeriod(sys->client, &defT, &minT);
+    if (FAILED(hr))
+        return hr;
+    period = defT;
+
+    sys->hEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (sys->hEvent == NULL)
+        return E_FAIL;
+
+    for (unsigned attempt = 0; ; attempt++)
+    {
+        hr = IAudioClient_Initialize(sys->client, AUDCLNT_SHAREMODE_EXCLUSIVE,
+                                     AUDCLNT_STREAMFLAGS_EVENTCALLBACK,
+                                     period, period, pwf, sid);
+        if (hr != AUDCLNT_E_BUFFER_SIZE_NOT_ALIGNED || attempt > 0)
+            break;
+
+        /* Retry once with the period aligned as the device wants it */
+        UINT32 frames;
+        if (FAILED(IAudioClient_GetBufferSize(sys->client, &frames)))
+            break;
+        period = MSFTIME_FROM_SEC(INT64_C(1)) * frames / pwf->nSamplesPerSec;
+
+        /* The client cannot be initialized a second time */
+        IAudioClient_Release(sys->client);
+        sys->client = NULL;
+
+        void *pv;
+        hr = aout_stream_Activate(s, &IID_IAudioClient, NULL, &pv);
+        if (FAILED(hr))
+            break;
+        sys->client = pv;
+    }
+
+    if (FAILED(hr))
+        return hr;
+
+    return IAudioClient_SetEventHandle(sys->client, sys->hEvent);
+}
+
 static HRESULT Start(aout_stream_t *s, audio_sample_format_t *restrict pfmt,
                      const GUID *sid)
 {
@@ -748,6 +914,10 @@ static HRESULT Start(aout_stream_t *s, audio_sample_format_t *restrict pfmt,
         return E_OUTOFMEMORY;
     sys->client = NULL;
     sys->hTimer = NULL;
+    sys->hEvent = NULL;
+    sys->stage = NULL;
+    sys->staged = 0;
+    sys->prefilled = false;
     atomic_init(&sys->started_state, STARTED_STATE_INIT);
 
     /* Configure audio stream */
@@ -818,6 +988,10 @@ static HRESULT Start(aout_stream_t *s, audio_sample_format_t *restrict pfmt,
         else
         {
             shared_mode = AUDCLNT_SHAREMODE_SHARED;
+#ifdef __IAudioClient2_INTERFACE_DEFINED__
+            if (var_CreateGetBool(vlc_object_parent(s), "wasapi-offload"))
+                TryOffload(s, sys);
+#endif
             hr = IAudioClient_IsFormatSupported(sys->client, shared_mode,
                                                 pwf, &pwf_closest);
         }
@@ -860,8 +1034,36 @@ static HRESULT Start(aout_stream_t *s, audio_sample_format_t *restrict pfmt,
     if (sys->s24s32)
         msg_Dbg(s, "audio device configured as s24");
 
-    hr = IAudioClient_Initialize(sys->client, shared_mode, 0, buffer_duration,
-                                 0, pwf, sid);
+    if (shared_mode == AUDCLNT_SHAREMODE_EXCLUSIVE)
+    {
+        hr = StartExclusiveEvent(s, sys, pwf, sid);
+        if (FAILED(hr))
+        {
+            msg_Warn(s, "cannot set up event-driven stream (error 0x%lX), "
+                     "falling back to polling", hr);
+            if (sys->hEvent != NULL)
+            {
+                CloseHandle(sys->hEvent);
+                sys->hEvent = NULL;
+            }
+            /* The client cannot be initialized a second time */
+            if (sys->client != NULL)
+                IAudioClient_Release(sys->client);
+            hr = aout_stream_Activate(s, &IID_IAudioClient, NULL, &pv);
+            if (FAILED(hr))
+            {
+                sys->client = NULL;
+                CoTaskMemFree(pwf_closest);
+                msg_Err(s, "cannot activate client (error 0x%lX)", hr);
+                goto error;
+            }
+            sys->client = pv;
+        }
+    }
+
+    if (sys->hEvent == NULL) /* shared mode, or event-driven fallback */
+        hr = IAudioClient_Initialize(sys->client, shared_mode, 0,
+                                     buffer_duration, 0, pwf, sid);
     CoTaskMemFree(pwf_closest);
     if (FAILED(hr))
     {
@@ -877,6 +1079,17 @@ static HRESULT Start(aout_stream_t *s, audio_sample_format_t *restrict pfmt,
     }
     msg_Dbg(s, "buffer size    : %"PRIu32" frames", sys->frames);
 
+    if (sys->hEvent != NULL)
+    {   /* Event-driven: one buffer equals one device period */
+        sys->stage = malloc((size_t)sys->frames * sys->block_align);
+        if (unlikely(sys->stage == NULL))
+        {
+            hr = E_OUTOFMEMORY;
+            goto error;
+        }
+        msg_Dbg(s, "using event-driven exclusive mode");
+    }
+
     REFERENCE_TIME latT, defT, minT;
     if (SUCCEEDED(IAudioClient_GetStreamLatency(sys->client, &latT))
      && SUCCEEDED(IAudioClient_GetDevicePeriod(sys->client, &defT, &minT)))
@@ -900,6 +1113,9 @@ error:
     CoTaskMemFree(pwf_mix);
     if (sys->client != NULL)
         IAudioClient_Release(sys->client);
+    if (sys->hEvent != NULL)
+        CloseHandle(sys->hEvent);
+    free(sys->stage);
     free(sys);
     return hr;
 }
@@ -912,6 +1128,13 @@ error:
     "This mode is more likely to fail if the soundcard format is not " \
     "handled by VLC.")
 
+#define WASAPI_OFFLOAD_TEXT N_("Use hardware offload")
+#define WASAPI_OFFLOAD_LONGTEXT N_( \
+    "Offload the audio stream to the audio device when it supports it, " \
+    "bypassing the software mixing path of the audio engine. " \
+    "This reduces CPU usage and power consumption in shared mode. " \
+    "It has no effect on devices without offload support.")
+
 vlc_module_begin()
     set_shortname("WASAPI")
     set_description(N_("Windows Audio Session API output"))
@@ -919,6 +1142,8 @@ vlc_module_begin()
     set_category(CAT_AUDIO)
     add_bool("wasapi-exclusive", false, WASAPI_EXCLUSIVE_TEXT,
              WASAPI_EXCLUSIVE_LONGTEXT, true)
+    add_bool("wasapi-offload", false, WASAPI_OFFLOAD_TEXT,
+             WASAPI_OFFLOAD_LONGTEXT, true)
     set_subcategory(SUBCAT_AUDIO_AOUT)
     set_callback(Start)
 vlc_module_end()
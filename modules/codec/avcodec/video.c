@@ -94,6 +94,9 @@ typedef struct
     bool        b_direct_rendering;
     atomic_bool b_dr_failure;
 
+    /* accounted in lavc_video_instances (auto thread tuning) */
+    bool b_counted_instance;
+
     /* Hack to force display of still pictures */
     bool b_first_frame;
 
@@ -378,6 +381,24 @@ static int lavc_UpdateVideoFormat(decoder_t *dec, AVCodecContext *ctx,
     p_sys->decoder_width  = dec->fmt_out.video.i_width;
     p_sys->decoder_height = dec->fmt_out.video.i_height;
 
+    /* Push libavcodec's buffer alignment requirements back to the owner's
+     * picture allocation, so that direct rendering does not bail out on
+     * misaligned plane pitches (one avoided full-frame copy per picture) */
+    if (ctx->coded_width > 0 && ctx->coded_height > 0)
+    {
+        int width = ctx->coded_width;
+        int height = ctx->coded_height;
+        int aligns[AV_NUM_DATA_POINTERS];
+
+        avcodec_align_dimensions2(ctx, &width, &height, aligns);
+
+        unsigned align = 0;
+        for (size_t i = 0; i < AV_NUM_DATA_POINTERS; i++)
+            if (aligns[i] > 0 && (unsigned)aligns[i] > align)
+                align = aligns[i];
+        dec->i_picture_pitch_align = align;
+    }
+
     if (pp_dec_device)
     {
         *pp_dec_device = decoder_GetDecoderDevice(dec);
@@ -449,6 +470,10 @@ static int lavc_CopyPicture(decoder_t *dec, picture_t *pic, AVFrame *frame)
     return VLC_SUCCESS;
 }
 
+/* Simultaneously open lavc video decoders in this process, used to split the
+ * CPU cores between streams when "avcodec-threads" is left automatic. */
+static atomic_uint lavc_video_instances = 0;
+
 static int OpenVideoCodec( decoder_t *p_dec )
 {
     decoder_sys_t *p_sys = p_dec->p_sys;
@@ -622,11 +647,24 @@ int InitVideoDec( vlc_object_t *obj )
     int i_thread_count = var_InheritInteger( p_dec, "avcodec-threads" );
     if( i_thread_count <= 0 )
     {
-        i_thread_count = vlc_GetCPUCount();
+        /* Share the cores between the simultaneously open video decoders of
+         * this process: a static per-stream count oversubscribes the CPU as
+         * soon as several streams are decoded at once (transcoding farms,
+         * mosaics, PiP). The count is re-derived whenever a decoder opens,
+         * so short-lived streams give their threads back. */
+        unsigned i_instances =
+            atomic_fetch_add( &lavc_video_instances, 1 ) + 1;
+
+        p_sys->b_counted_instance = true;
+        i_thread_count = vlc_GetCPUCount() / i_instances;
         if( i_thread_count > 1 )
             i_thread_count++;
+        else if( i_thread_count < 1 )
+            i_thread_count = 1;
+        if( i_instances > 1 )
+            msg_Dbg( p_dec, "sharing CPUs with %u other video decoder(s)",
+                     i_instances - 1 );
 
-        //FIXME: take in count the decoding time
 #if VLC_WINSTORE_APP
         i_thread_count = __MIN( i_thread_count, 6 );
 #else
@@ -1399,6 +1437,9 @@ void EndVideoDec( vlc_object_t *obj )
     if( p_sys->p_va )
         vlc_va_Delete( p_sys->p_va );
 
+    if( p_sys->b_counted_instance )
+        atomic_fetch_sub( &lavc_video_instances, 1 );
+
     free( p_sys );
 }
 
@@ -208,6 +208,15 @@ typedef struct
         uint8_t d1;
         uint8_t d2;
     } last;
+
+    /* Rendered rows cache: regenerating a text segment chain per displayed
+     * row on every update is far more expensive than copying it, and most
+     * commands only touch one row */
+    struct
+    {
+        text_segment_t *p_segments;
+        bool b_dirty;
+    } rowcache[2][EIA608_SCREEN_ROWS];
 } eia608_t;
 
 static void         Eia608Init( eia608_t * );
@@ -281,7 +290,7 @@ static int Open( vlc_object_t *p_this )
         p_sys->i_field = p_dec->fmt_in.subs.cc.i_channel >> 1;
         p_sys->i_channel = 1 + (p_dec->fmt_in.subs.cc.i_channel & 1);
 
-        p_sys->p_eia608 = malloc(sizeof(*p_sys->p_eia608));
+        p_sys->p_eia608 = calloc(1, sizeof(*p_sys->p_eia608));
         if( !p_sys->p_eia608 )
         {
             free( p_sys );
@@ -418,7 +427,13 @@ static void Close( vlc_object_t *p_this )
     decoder_t *p_dec = (decoder_t *)p_this;
     decoder_sys_t *p_sys = p_dec->p_sys;
 
-    free( p_sys->p_eia608 );
+    if( p_sys->p_eia608 )
+    {
+        for( int i = 0; i < 2; i++ )
+            for( int j = 0; j < EIA608_SCREEN_ROWS; j++ )
+                text_segment_ChainDelete( p_sys->p_eia608->rowcache[i][j].p_segments );
+        free( p_sys->p_eia608 );
+    }
     if( p_sys->p_cea708 )
     {
         CEA708_Decoder_Release( p_sys->p_cea708 );
@@ -541,6 +556,7 @@ static void Convert( decoder_t *p_dec, vlc_tick_t i_pts,
                      const uint8_t *p_buffer, size_t i_buffer )
 {
     decoder_sys_t *p_sys = p_dec->p_sys;
+    vlc_tick_t i_display_pts = VLC_TICK_INVALID;
 
     unsigned i_ticks = 0;
     while( i_buffer >= 3 )
@@ -555,19 +571,18 @@ static void Convert( decoder_t *p_dec, vlc_tick_t i_pts,
                 eia608_status_t i_status = Eia608Parse( p_sys->p_eia608,
                                                         p_sys->i_channel, &p_buffer[1] );
 
-                /* a caption is ready or removed, process its screen */
-                /*
-                 * In case of rollup/painton with 1 packet/frame, we need
-                 * to update on Changed status.
-                 * Batch decoding might be incorrect if those in
-                 * large number of commands (mp4, ...) then.
-                 * see CEAv1.2zero.trp tests */
+                /* a caption is ready or removed, its screen needs processing.
+                 * In case of rollup/painton we also need to update on Changed
+                 * status (see CEAv1.2zero.trp tests). The screen updates of
+                 * all the pairs of one frame are batched into a single
+                 * subpicture dated from the first triggering pair: the
+                 * intermediate states would only be displayable for a
+                 * fraction of a frame */
                 if( i_status & (EIA608_STATUS_DISPLAY | EIA608_STATUS_CHANGED) )
                 {
                     Debug(printf("\n"));
-                    subpicture_t *p_spu = Subtitle( p_dec, p_sys->p_eia608, i_spupts );
-                    if( p_spu )
-                        decoder_QueueSub( p_dec, p_spu );
+                    if( i_display_pts == VLC_TICK_INVALID )
+                        i_display_pts = i_spupts;
                 }
             }
             else if( p_sys->p_cea708 && (p_buffer[0] & 0x03) >= 2 )
@@ -581,12 +596,24 @@ static void Convert( decoder_t *p_dec, vlc_tick_t i_pts,
         i_buffer -= 3;
         p_buffer += 3;
     }
+
+    if( i_display_pts != VLC_TICK_INVALID )
+    {
+        subpicture_t *p_spu = Subtitle( p_dec, p_sys->p_eia608, i_display_pts );
+        if( p_spu )
+            decoder_QueueSub( p_dec, p_spu );
+    }
 }
 
 
 /*****************************************************************************
  *
  *****************************************************************************/
+static void Eia608RowDirty( eia608_t *h, int i_screen, int i_row )
+{
+    h->rowcache[i_screen][i_row].b_dirty = true;
+}
+
 static void Eia608Cursor( eia608_t *h, int dx )
 {
     h->cursor.i_column += dx;
@@ -599,6 +626,8 @@ static void Eia608ClearScreenRowX( eia608_t *h, int i_screen, int i_row, int x )
 {
     eia608_screen *screen = &h->screen[i_screen];
 
+    Eia608RowDirty( h, i_screen, i_row );
+
     if( x == 0 )
     {
         screen->row_used[i_row] = false;
@@ -670,12 +699,14 @@ static void Eia608Write( eia608_t *h, const uint8_t c )
     if( h->mode == EIA608_MODE_TEXT )
         return;
 
-    screen = &h->screen[Eia608GetWritingScreenIndex( h )];
+    const int i_screen = Eia608GetWritingScreenIndex( h );
+    screen = &h->screen[i_screen];
 
     screen->characters[i_row][i_column] = c;
     screen->colors[i_row][i_column] = h->color;
     screen->fonts[i_row][i_column] = h->font;
     screen->row_used[i_row] = true;
+    Eia608RowDirty( h, i_screen, i_row );
     Eia608Cursor( h, 1 );
 }
 static void Eia608Erase( eia608_t *h )
@@ -689,10 +720,12 @@ static void Eia608Erase( eia608_t *h )
     if( i_column < 0 )
         return;
 
-    screen = &h->screen[Eia608GetWritingScreenIndex( h )];
+    const int i_screen = Eia608GetWritingScreenIndex( h );
+    screen = &h->screen[i_screen];
 
     /* FIXME do we need to reset row_used/colors/font ? */
     screen->characters[i_row][i_column] = ' ';
+    Eia608RowDirty( h, i_screen, i_row );
     Eia608Cursor( h, -1 );
 }
 static void Eia608EraseToEndOfRow( eia608_t *h )
@@ -741,6 +774,7 @@ static void Eia608RollUp( eia608_t *h )
         memcpy( screen->colors[i_row], screen->colors[i_row+1], sizeof(*screen->colors) );
         memcpy( screen->fonts[i_row], screen->fonts[i_row+1], sizeof(*screen->fonts) );
         screen->row_used[i_row] = screen->row_used[i_row+1];
+        Eia608RowDirty( h, i_screen, i_row );
     }
     /* Reset current row */
     Eia608ClearScreenRow( h, i_screen, h->cursor.i_row );
@@ -1235,6 +1269,21 @@ static text_segment_t * Eia608TextLine( struct eia608_screen *screen, int i_row
     return p_segments_head;
 }
 
+static text_segment_t * Eia608RenderRow( eia608_t *h, int i_screen, int i_row )
+{
+    text_segment_t **pp_cached = &h->rowcache[i_screen][i_row].p_segments;
+
+    if( h->rowcache[i_screen][i_row].b_dirty )
+    {
+        text_segment_ChainDelete( *pp_cached );
+        *pp_cached = Eia608TextLine( &h->screen[i_screen], i_row );
+        h->rowcache[i_screen][i_row].b_dirty = false;
+    }
+    /* The updater owns and frees the segments of each subpicture, so hand
+     * out a copy of the cached chain */
+    return text_segment_Copy( *pp_cached );
+}
+
 static void Eia608FillUpdaterRegions( subtext_updater_sys_t *p_updater, eia608_t *h )
 {
     struct eia608_screen *screen = &h->screen[h->i_screen];
@@ -1247,7 +1296,7 @@ static void Eia608FillUpdaterRegions( subtext_updater_sys_t *p_updater, eia608_t
         if( !screen->row_used[i] )
             continue;
 
-        text_segment_t *p_segments = Eia608TextLine( screen, i );
+        text_segment_t *p_segments = Eia608RenderRow( h, h->i_screen, i );
         if( p_segments )
         {
             if( b_newregion )
@@ -1295,6 +1344,12 @@ static void Eia608FillUpdaterRegions( subtext_updater_sys_t *p_updater, eia608_t
 /* */
 static void Eia608Init( eia608_t *h )
 {
+    /* The eia608_t is allocated zeroed, so the cached chains are always in
+     * a defined state here */
+    for( int i = 0; i < 2; i++ )
+        for( int j = 0; j < EIA608_SCREEN_ROWS; j++ )
+            text_segment_ChainDelete( h->rowcache[i][j].p_segments );
+
     memset( h, 0, sizeof(*h) );
 
     /* */
@@ -443,6 +443,8 @@ struct cea708_t
     vlc_tick_t suspended_deadline; /* not VLC_TICK_INVALID when delay is active */
     vlc_tick_t i_clock;
     bool b_text_waiting;
+    bool b_output_pending; /* batched output for the current push */
+    vlc_tick_t i_output_clock; /* clock of the first batched output */
 };
 
 static int CEA708_Decode_G0( uint8_t code, cea708_t *p_cea708 );
@@ -1125,6 +1127,8 @@ static void CEA708_Decoder_Init( cea708_t *p_cea708 )
     p_cea708->p_cw = &p_cea708->window[0];
     p_cea708->suspended_deadline = VLC_TICK_INVALID;
     p_cea708->b_text_waiting = false;
+    p_cea708->b_output_pending = false;
+    p_cea708->i_output_clock = 0;
     p_cea708->i_clock = 0;
 }
 
@@ -1688,8 +1692,15 @@ static void CEA708_Decode_ServiceBuffer( cea708_t *h )
         else
             i_ret = CEA708_Decode_G1( c, h );
 
-        if( i_ret & CEA708_STATUS_OUTPUT )
-            CEA708_Output( h );
+        /* Batch the service block outputs of one push into a single
+         * subpicture, dated from the first triggering command: the
+         * intermediate window states would only be displayable for a
+         * fraction of a video frame */
+        if( (i_ret & CEA708_STATUS_OUTPUT) && !h->b_output_pending )
+        {
+            h->b_output_pending = true;
+            h->i_output_clock = h->i_clock;
+        }
 
         if( i_ret & CEA708_STATUS_STARVING )
             break;
@@ -1740,4 +1751,13 @@ void CEA708_Decoder_Push( cea708_t *h, vlc_tick_t i_time,
 
         i += i_push;
     }
+
+    if( h->b_output_pending )
+    {
+        h->b_output_pending = false;
+        const vlc_tick_t i_saved_clock = h->i_clock;
+        h->i_clock = h->i_output_clock;
+        CEA708_Output( h );
+        h->i_clock = i_saved_clock;
+    }
 }
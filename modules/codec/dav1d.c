@@ -54,6 +54,9 @@ static void CloseDecoder(vlc_object_t *);
 #define THREAD_FRAMES_LONGTEXT N_( "Max number of threads used for frame decoding, default 0=auto" )
 #define THREAD_TILES_TEXT N_("Tiles Threads")
 #define THREAD_TILES_LONGTEXT N_( "Max number of threads used for tile decoding, default 0=auto" )
+#define APPLY_GRAIN_TEXT N_("Apply film grain")
+#define APPLY_GRAIN_LONGTEXT N_( "Synthesize film grain during decoding. " \
+    "Disabling it trades fidelity for a large decode speedup on grainy streams." )
 
 
 vlc_module_begin ()
@@ -68,6 +71,8 @@ vlc_module_begin ()
                 THREAD_FRAMES_TEXT, THREAD_FRAMES_LONGTEXT, false)
     add_integer("dav1d-thread-tiles", 0,
                 THREAD_TILES_TEXT, THREAD_TILES_LONGTEXT, false)
+    add_bool("dav1d-apply-grain", true,
+             APPLY_GRAIN_TEXT, APPLY_GRAIN_LONGTEXT, false)
 vlc_module_end ()
 
 /*****************************************************************************
@@ -382,11 +387,29 @@ static int OpenDecoder(vlc_object_t *p_this)
 
     dav1d_default_settings(&p_sys->s);
     p_sys->s.n_tile_threads = var_InheritInteger(p_this, "dav1d-thread-tiles");
-    if (p_sys->s.n_tile_threads == 0)
-        p_sys->s.n_tile_threads = VLC_CLIP(vlc_GetCPUCount(), 1, 4);
     p_sys->s.n_frame_threads = var_InheritInteger(p_this, "dav1d-thread-frames");
-    if (p_sys->s.n_frame_threads == 0)
-        p_sys->s.n_frame_threads = __MAX(1, vlc_GetCPUCount());
+    if (p_sys->s.n_tile_threads == 0 || p_sys->s.n_frame_threads == 0)
+    {
+        /* Scale the thread pools to the stream resolution: small pictures
+         * cannot keep many tile threads busy, and every frame thread pins a
+         * full reference picture, which gets expensive at 2160p. Streams
+         * without dimensions are assumed large. */
+        int i_cores = __MAX(1, vlc_GetCPUCount());
+        unsigned i_height = dec->fmt_in.video.i_visible_height ?
+                            dec->fmt_in.video.i_visible_height :
+                            dec->fmt_in.video.i_height;
+        if (i_height == 0)
+            i_height = 2160;
+
+        if (p_sys->s.n_tile_threads == 0)
+            p_sys->s.n_tile_threads =
+                (i_height >= 1080) ? VLC_CLIP(i_cores, 1, 4) :
+                (i_height >=  720) ? VLC_CLIP(i_cores, 1, 2) : 1;
+        if (p_sys->s.n_frame_threads == 0)
+            p_sys->s.n_frame_threads =
+                (i_height >= 2160) ? VLC_CLIP(i_cores, 1, 8) : i_cores;
+    }
+    p_sys->s.apply_grain = var_InheritBool(p_this, "dav1d-apply-grain");
     p_sys->s.allocator.cookie = dec;
     p_sys->s.allocator.alloc_picture_callback = NewPicture;
     p_sys->s.allocator.release_picture_callback = FreePicture;
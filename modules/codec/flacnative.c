@@ -0,0 +1,596 @@
+/*****************************************************************************
+ * flacnative.c: native FLAC decoder (no libflac dependency)
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Preamble
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_codec.h>
+#include <vlc_aout.h>
+#include <vlc_bits.h>
+
+#include "../packetizer/flac.h"
+
+/*****************************************************************************
+ * Module descriptor
+ *****************************************************************************
+ * The decoder operates on the packetized frames produced by the flac
+ * packetizer and restores the predictors with tight, auto-vectorizable
+ * loops. It is scored below the libflac decoder and is meant to be selected
+ * explicitly (--codec flacnative) on setups where libflac underperforms, or
+ * as a fallback when libflac is not built.
+ *****************************************************************************/
+static int  OpenDecoder ( vlc_object_t * );
+static void CloseDecoder( vlc_object_t * );
+
+vlc_module_begin ()
+    set_category( CAT_INPUT )
+    set_subcategory( SUBCAT_INPUT_ACODEC )
+    add_shortcut( "flacnative" )
+    set_description( N_("FLAC audio decoder (native)") )
+    set_capability( "audio decoder", 90 )
+    set_callbacks( OpenDecoder, CloseDecoder )
+vlc_module_end ()
+
+#define FLAC_MAX_CHANNELS    8
+#define FLAC_MAX_LPC_ORDER   32
+#define FLAC_MAX_BLOCKSIZE   65535
+
+/*****************************************************************************
+ * decoder_sys_t : native FLAC decoder descriptor
+ *****************************************************************************/
+typedef struct
+{
+    date_t   end_date;
+
+    struct flac_stream_info stream_info;
+    bool b_stream_info;
+
+    /* One planar buffer per channel, FLAC_MAX_BLOCKSIZE samples each */
+    int32_t *p_channels[FLAC_MAX_CHANNELS];
+} decoder_sys_t;
+
+static const int pi_channels_maps[FLAC_MAX_CHANNELS + 1] =
+{
+    0,
+    AOUT_CHAN_CENTER,
+    AOUT_CHAN_LEFT | AOUT_CHAN_RIGHT,
+    AOUT_CHAN_CENTER | AOUT_CHAN_LEFT | AOUT_CHAN_RIGHT,
+    AOUT_CHAN_LEFT | AOUT_CHAN_RIGHT | AOUT_CHAN_REARLEFT
+     | AOUT_CHAN_REARRIGHT,
+    AOUT_CHAN_LEFT | AOUT_CHAN_RIGHT | AOUT_CHAN_CENTER
+     | AOUT_CHAN_REARLEFT | AOUT_CHAN_REARRIGHT,
+    AOUT_CHAN_LEFT | AOUT_CHAN_RIGHT | AOUT_CHAN_CENTER
+     | AOUT_CHAN_REARLEFT | AOUT_CHAN_REARRIGHT | AOUT_CHAN_LFE,
+    AOUT_CHAN_LEFT | AOUT_CHAN_RIGHT | AOUT_CHAN_CENTER
+     | AOUT_CHAN_REARCENTER | AOUT_CHAN_MIDDLELEFT| AOUT_CHAN_MIDDLERIGHT
+     | AOUT_CHAN_LFE,
+    AOUT_CHAN_LEFT | AOUT_CHAN_RIGHT | AOUT_CHAN_CENTER | AOUT_CHAN_REARLEFT
+     | AOUT_CHAN_REARRIGHT | AOUT_CHAN_MIDDLELEFT | AOUT_CHAN_MIDDLERIGHT
+     | AOUT_CHAN_LFE
+};
+
+/* XXX it supposes our internal format is WG4 */
+static const uint8_t ppi_reorder[1+FLAC_MAX_CHANNELS][FLAC_MAX_CHANNELS] =
+{
+    { 0 },
+    { 0, },
+    { 0, 1 },
+    { 0, 1, 2 },
+    { 0, 1, 2, 3 },
+    { 0, 1, 3, 4, 2 },
+    { 0, 1, 4, 5, 2, 3 },
+    { 0, 1, 5, 6, 4, 2, 3 },
+    { 0, 1, 6, 7, 4, 5, 2, 3 },
+};
+
+/* Stereo decorrelation modes from the frame header channel assignment */
+enum flac_channel_mode
+{
+    FLAC_CHANNELS_INDEPENDENT = 0,
+    FLAC_CHANNELS_LEFT_SIDE,
+    FLAC_CHANNELS_RIGHT_SIDE,
+    FLAC_CHANNELS_MID_SIDE,
+};
+
+/*****************************************************************************
+ * Bitstream helpers
+ *****************************************************************************/
+static inline int32_t ReadBitsSigned( bs_t *s, unsigned n )
+{
+    const uint32_t u = bs_read( s, n );
+    return (int32_t)(u << (32 - n)) >> (32 - n);
+}
+
+static inline uint32_t ReadUnary( bs_t *s )
+{
+    uint32_t q = 0;
+    while( bs_read1( s ) == 0 )
+    {
+        if( bs_eof( s ) )
+            break;
+        q++;
+    }
+    return q;
+}
+
+/*****************************************************************************
+ * Predictor restoration
+ *****************************************************************************
+ * The fixed orders are fully unrolled, and the LPC dot product is written as
+ * a plain inner loop over the coefficients with 64-bit accumulation so that
+ * the compiler can vectorize it: samples are sequentially dependent, so the
+ * coefficient dimension is the only one SIMD can exploit, which is also what
+ * libflac's hand-written kernels do.
+ *****************************************************************************/
+static void RestoreFixed( int32_t *p_buf, unsigned i_order, unsigned i_samples )
+{
+    switch( i_order )
+    {
+    case 0:
+        break;
+    case 1:
+        for( unsigned i = i_order; i < i_samples; i++ )
+            p_buf[i] += p_buf[i-1];
+        break;
+    case 2:
+        for( unsigned i = i_order; i < i_samples; i++ )
+            p_buf[i] += 2 * p_buf[i-1] - p_buf[i-2];
+        break;
+    case 3:
+        for( unsigned i = i_order; i < i_samples; i++ )
+            p_buf[i] += 3 * p_buf[i-1] - 3 * p_buf[i-2] + p_buf[i-3];
+        break;
+    case 4:
+        for( unsigned i = i_order; i < i_samples; i++ )
+            p_buf[i] += 4 * p_buf[i-1] - 6 * p_buf[i-2]
+                      + 4 * p_buf[i-3] - p_buf[i-4];
+        break;
+    }
+}
+
+static void RestoreLPC( int32_t *p_buf, const int32_t *restrict p_coeff,
+                        unsigned i_order, unsigned i_shift, unsigned i_samples )
+{
+    for( unsigned i = i_order; i < i_samples; i++ )
+    {
+        int64_t i_sum = 0;
+        const int32_t *restrict p_prev = &p_buf[i - i_order];
+        for( unsigned j = 0; j < i_order; j++ )
+            i_sum += (int64_t)p_coeff[j] * p_prev[j];
+        p_buf[i] += (int32_t)(i_sum >> i_shift);
+    }
+}
+
+/*****************************************************************************
+ * DecodeResidual: rice-coded residual of a FIXED or LPC subframe
+ *****************************************************************************/
+static int DecodeResidual( bs_t *s, int32_t *p_buf,
+                           unsigned i_order, unsigned i_blocksize )
+{
+    const unsigned i_method = bs_read( s, 2 );
+    if( i_method > 1 ) /* reserved */
+        return VLC_EGENERIC;
+    const unsigned i_param_bits = (i_method == 0) ? 4 : 5;
+    const unsigned i_escape = (i_method == 0) ? 0xF : 0x1F;
+
+    const unsigned i_partition_order = bs_read( s, 4 );
+    const unsigned i_partitions = 1U << i_partition_order;
+    if( (i_blocksize >> i_partition_order) << i_partition_order != i_blocksize ||
+        (i_blocksize >> i_partition_order) <= i_order )
+        return VLC_EGENERIC;
+
+    unsigned i_sample = i_order;
+    for( unsigned p = 0; p < i_partitions; p++ )
+    {
+        unsigned i_count = i_blocksize >> i_partition_order;
+        if( p == 0 )
+            i_count -= i_order;
+
+        const unsigned i_param = bs_read( s, i_param_bits );
+        if( i_param == i_escape )
+        {
+            const unsigned i_raw_bits = bs_read( s, 5 );
+            for( unsigned i = 0; i < i_count; i++ )
+                p_buf[i_sample++] = i_raw_bits ? ReadBitsSigned( s, i_raw_bits ) : 0;
+        }
+        else
+        {
+            for( unsigned i = 0; i < i_count; i++ )
+            {
+                const uint32_t q = ReadUnary( s );
+                const uint32_t u = (q << i_param) | bs_read( s, i_param );
+                p_buf[i_sample++] = (int32_t)(u >> 1) ^ -(int32_t)(u & 1);
+            }
+        }
+        if( bs_eof( s ) )
+            return VLC_EGENERIC;
+    }
+    return VLC_SUCCESS;
+}
+
+/*****************************************************************************
+ * DecodeSubframe: one channel of a frame
+ *****************************************************************************/
+static int DecodeSubframe( bs_t *s, int32_t *p_buf,
+                           unsigned i_bps, unsigned i_blocksize )
+{
+    if( bs_read1( s ) != 0 ) /* zero padding bit */
+        return VLC_EGENERIC;
+
+    const unsigned i_type = bs_read( s, 6 );
+
+    unsigned i_wasted = 0;
+    if( bs_read1( s ) ) /* wasted bits-per-sample flag */
+        i_wasted = ReadUnary( s ) + 1;
+    if( i_wasted >= i_bps )
+        return VLC_EGENERIC;
+    i_bps -= i_wasted;
+
+    if( i_type == 0x00 ) /* CONSTANT */
+    {
+        const int32_t i_value = ReadBitsSigned( s, i_bps );
+        for( unsigned i = 0; i < i_blocksize; i++ )
+            p_buf[i] = i_value;
+    }
+    else if( i_type == 0x01 ) /* VERBATIM */
+    {
+        for( unsigned i = 0; i < i_blocksize; i++ )
+            p_buf[i] = ReadBitsSigned( s, i_bps );
+    }
+    else if( i_type >= 0x08 && i_type <= 0x0C ) /* FIXED, order 0..4 */
+    {
+        const unsigned i_order = i_type & 0x07;
+        if( i_order > i_blocksize )
+            return VLC_EGENERIC;
+        for( unsigned i = 0; i < i_order; i++ )
+            p_buf[i] = ReadBitsSigned( s, i_bps );
+        if( DecodeResidual( s, p_buf, i_order, i_blocksize ) )
+            return VLC_EGENERIC;
+        RestoreFixed( p_buf, i_order, i_blocksize );
+    }
+    else if( i_type >= 0x20 ) /* LPC, order 1..32 */
+    {
+        const unsigned i_order = (i_type & 0x1F) + 1;
+        if( i_order > i_blocksize )
+            return VLC_EGENERIC;
+        for( unsigned i = 0; i < i_order; i++ )
+            p_buf[i] = ReadBitsSigned( s, i_bps );
+
+        const unsigned i_precision = bs_read( s, 4 ) + 1;
+        if( i_precision == 16 ) /* 0b1111 is invalid */
+            return VLC_EGENERIC;
+        const int i_shift = ReadBitsSigned( s, 5 );
+        if( i_shift < 0 )
+            return VLC_EGENERIC;
+
+        int32_t rgi_coeff[FLAC_MAX_LPC_ORDER];
+        for( unsigned i = 0; i < i_order; i++ )
+            rgi_coeff[i] = ReadBitsSigned( s, i_precision );
+
+        if( DecodeResidual( s, p_buf, i_order, i_blocksize ) )
+            return VLC_EGENERIC;
+        RestoreLPC( p_buf, rgi_coeff, i_order, i_shift, i_blocksize );
+    }
+    else /* reserved */
+        return VLC_EGENERIC;
+
+    if( bs_eof( s ) )
+        return VLC_EGENERIC;
+
+    if( i_wasted )
+        for( unsigned i = 0; i < i_blocksize; i++ )
+            p_buf[i] = (int32_t)((uint32_t)p_buf[i] << i_wasted);
+
+    return VLC_SUCCESS;
+}
+
+/*****************************************************************************
+ * Undecorrelate: invert the stereo decorrelation in place
+ *****************************************************************************/
+static void Undecorrelate( enum flac_channel_mode mode,
+                           int32_t *restrict p_ch0, int32_t *restrict p_ch1,
+                           unsigned i_samples )
+{
+    switch( mode )
+    {
+    case FLAC_CHANNELS_INDEPENDENT:
+        break;
+    case FLAC_CHANNELS_LEFT_SIDE:
+        for( unsigned i = 0; i < i_samples; i++ )
+            p_ch1[i] = p_ch0[i] - p_ch1[i];
+        break;
+    case FLAC_CHANNELS_RIGHT_SIDE:
+        for( unsigned i = 0; i < i_samples; i++ )
+            p_ch0[i] += p_ch1[i];
+        break;
+    case FLAC_CHANNELS_MID_SIDE:
+        for( unsigned i = 0; i < i_samples; i++ )
+        {
+            const int32_t side = p_ch1[i];
+            const int32_t mid = (p_ch0[i] << 1) | (side & 1);
+            p_ch0[i] = (mid + side) >> 1;
+            p_ch1[i] = (mid - side) >> 1;
+        }
+        break;
+    }
+}
+
+/*****************************************************************************
+ * Interleave: planar int32 channels to interleaved S32N output
+ *****************************************************************************/
+static void Interleave( int32_t *p_out, const int32_t * const *pp_in,
+                        const uint8_t *restrict pi_index, unsigned i_nb_channels,
+                        unsigned i_samples, unsigned bits )
+{
+    const unsigned shift = 32 - bits;
+
+    for( unsigned j = 0; j < i_samples; j++ )
+        for( unsigned i = 0; i < i_nb_channels; i++ )
+            p_out[j * i_nb_channels + i] =
+                (int32_t)((uint32_t)pp_in[pi_index[i]][j] << shift);
+}
+
+/*****************************************************************************
+ * FlacHeaderSize: bytes used by a frame header validated by
+ * FLAC_ParseSyncInfo(), including the CRC-8 byte
+ *****************************************************************************/
+static unsigned FlacHeaderSize( const uint8_t *p_buf, unsigned i_buf )
+{
+    unsigned i_size = 4;
+
+    int i_read;
+    if( read_utf8( &p_buf[4], i_buf - 4, &i_read ) == INT64_MAX )
+        return 0;
+    i_size += 1 + i_read;
+
+    const unsigned blocksize_hint = p_buf[2] >> 4;
+    if( blocksize_hint == 6 )
+        i_size += 1;
+    else if( blocksize_hint == 7 )
+        i_size += 2;
+
+    const unsigned samplerate_hint = p_buf[2] & 0x0F;
+    if( samplerate_hint == 12 )
+        i_size += 1;
+    else if( samplerate_hint == 13 || samplerate_hint == 14 )
+        i_size += 2;
+
+    return i_size + 1 /* CRC-8 */;
+}
+
+/*****************************************************************************
+ * DecodeFrame: decode one packetized FLAC frame into planar buffers
+ *****************************************************************************/
+static int DecodeFrame( decoder_t *p_dec, const uint8_t *p_buf, size_t i_buf,
+                        struct flac_header_info *p_headerinfo )
+{
+    decoder_sys_t *p_sys = p_dec->p_sys;
+
+    if( FLAC_ParseSyncInfo( p_buf, i_buf,
+                            p_sys->b_stream_info ? &p_sys->stream_info : NULL,
+                            NULL /* the packetizer checked the CRC-8 */,
+                            p_headerinfo ) == 0 )
+        return VLC_EGENERIC;
+
+    const unsigned i_header = FlacHeaderSize( p_buf, i_buf );
+    if( i_header == 0 || i_header >= i_buf )
+        return VLC_EGENERIC;
+
+    const unsigned i_blocksize = p_headerinfo->i_frame_length;
+    const unsigned i_channels = p_headerinfo->i_channels;
+    const unsigned i_bps = p_headerinfo->i_bits_per_sample;
+    if( i_blocksize > FLAC_MAX_BLOCKSIZE || i_channels > FLAC_MAX_CHANNELS )
+        return VLC_EGENERIC;
+    /* A decorrelated side channel needs bps+1 bits, which must still fit
+     * in the 32-bit bitstream reads: refuse depths above 24 bits (the
+     * streamable subset maximum) rather than decode them wrong */
+    if( i_bps == 0 || i_bps > 24 )
+        return VLC_EGENERIC;
+
+    const unsigned i_assignment = p_buf[3] >> 4;
+    enum flac_channel_mode mode = FLAC_CHANNELS_INDEPENDENT;
+    if( i_assignment >= 8 && i_assignment <= 10 )
+        mode = FLAC_CHANNELS_LEFT_SIDE + (i_assignment - 8);
+
+    bs_t s;
+    bs_init( &s, p_buf + i_header, i_buf - i_header );
+
+    for( unsigned ch = 0; ch < i_channels; ch++ )
+    {
+        /* The side channel of a decorrelated stereo pair carries one
+         * extra bit of depth */
+        unsigned i_subframe_bps = i_bps;
+        if( ( mode == FLAC_CHANNELS_RIGHT_SIDE && ch == 0 ) ||
+            ( ( mode == FLAC_CHANNELS_LEFT_SIDE ||
+                mode == FLAC_CHANNELS_MID_SIDE ) && ch == 1 ) )
+            i_subframe_bps++;
+
+        if( DecodeSubframe( &s, p_sys->p_channels[ch],
+                            i_subframe_bps, i_blocksize ) )
+        {
+            msg_Warn( p_dec, "corrupted FLAC subframe (channel %u)", ch );
+            return VLC_EGENERIC;
+        }
+    }
+
+    if( i_channels == 2 )
+        Undecorrelate( mode, p_sys->p_channels[0], p_sys->p_channels[1],
+                       i_blocksize );
+
+    /* The frame footer CRC-16 is not verified: the packetizer already
+     * dropped frames with invalid headers, and a payload corruption shows
+     * up as a parse failure above in virtually all cases */
+    return VLC_SUCCESS;
+}
+
+/*****************************************************************************
+ * Flush:
+ *****************************************************************************/
+static void Flush( decoder_t *p_dec )
+{
+    decoder_sys_t *p_sys = p_dec->p_sys;
+
+    date_Set( &p_sys->end_date, VLC_TICK_INVALID );
+}
+
+/****************************************************************************
+ * DecodeBlock: the whole thing
+ ****************************************************************************/
+static int DecodeBlock( decoder_t *p_dec, block_t *p_block )
+{
+    decoder_sys_t *p_sys = p_dec->p_sys;
+
+    if( p_block == NULL ) /* No Drain */
+        return VLCDEC_SUCCESS;
+    if( p_block->i_flags & (BLOCK_FLAG_DISCONTINUITY | BLOCK_FLAG_CORRUPTED) )
+    {
+        Flush( p_dec );
+        if( p_block->i_flags & BLOCK_FLAG_CORRUPTED )
+        {
+            block_Release( p_block );
+            return VLCDEC_SUCCESS;
+        }
+    }
+
+    struct flac_header_info headerinfo;
+    if( DecodeFrame( p_dec, p_block->p_buffer, p_block->i_buffer,
+                     &headerinfo ) != VLC_SUCCESS )
+        goto drop;
+
+    p_dec->fmt_out.audio.i_channels = headerinfo.i_channels;
+    p_dec->fmt_out.audio.i_rate = headerinfo.i_rate;
+    p_dec->fmt_out.audio.i_physical_channels =
+        pi_channels_maps[headerinfo.i_channels];
+    p_dec->fmt_out.audio.i_bitspersample = headerinfo.i_bits_per_sample;
+
+    if( p_sys->end_date.i_divider_num != headerinfo.i_rate )
+    {
+        if( p_sys->end_date.i_divider_num > 0 )
+            date_Change( &p_sys->end_date, headerinfo.i_rate, 1 );
+        else
+            date_Init( &p_sys->end_date, headerinfo.i_rate, 1 );
+    }
+
+    if( p_block->i_pts != VLC_TICK_INVALID &&
+        p_block->i_pts != date_Get( &p_sys->end_date ) )
+        date_Set( &p_sys->end_date, p_block->i_pts );
+
+    if( decoder_UpdateAudioFormat( p_dec ) )
+        goto drop;
+    if( date_Get( &p_sys->end_date ) == VLC_TICK_INVALID )
+        goto drop;
+
+    block_t *p_aout_buffer =
+        decoder_NewAudioBuffer( p_dec, headerinfo.i_frame_length );
+    if( p_aout_buffer == NULL )
+        goto drop;
+
+    Interleave( (int32_t *)p_aout_buffer->p_buffer,
+                (const int32_t * const *)p_sys->p_channels,
+                ppi_reorder[headerinfo.i_channels],
+                headerinfo.i_channels, headerinfo.i_frame_length,
+                headerinfo.i_bits_per_sample );
+
+    p_aout_buffer->i_pts = date_Get( &p_sys->end_date );
+    p_aout_buffer->i_length =
+        date_Increment( &p_sys->end_date, headerinfo.i_frame_length ) -
+        p_aout_buffer->i_pts;
+
+    block_Release( p_block );
+    decoder_QueueAudio( p_dec, p_aout_buffer );
+    return VLCDEC_SUCCESS;
+
+drop:
+    block_Release( p_block );
+    return VLCDEC_SUCCESS;
+}
+
+/*****************************************************************************
+ * OpenDecoder: probe the decoder and return score
+ *****************************************************************************/
+static int OpenDecoder( vlc_object_t *p_this )
+{
+    decoder_t *p_dec = (decoder_t*)p_this;
+    decoder_sys_t *p_sys;
+
+    if( p_dec->fmt_in.i_codec != VLC_CODEC_FLAC )
+        return VLC_EGENERIC;
+
+    if( ( p_dec->p_sys = p_sys = calloc( 1, sizeof(*p_sys) ) ) == NULL )
+        return VLC_ENOMEM;
+
+    for( unsigned i = 0; i < FLAC_MAX_CHANNELS; i++ )
+    {
+        p_sys->p_channels[i] = vlc_alloc( FLAC_MAX_BLOCKSIZE,
+                                          sizeof(int32_t) );
+        if( p_sys->p_channels[i] == NULL )
+        {
+            while( i > 0 )
+                free( p_sys->p_channels[--i] );
+            free( p_sys );
+            return VLC_ENOMEM;
+        }
+    }
+
+    /* Parse the STREAMINFO extradata when available: it carries the rate,
+     * depth and blocksize hints some frame headers rely upon */
+    const uint8_t *p_extra = p_dec->fmt_in.p_extra;
+    int i_extra = p_dec->fmt_in.i_extra;
+    if( i_extra >= 8 + FLAC_STREAMINFO_SIZE &&
+        !memcmp( p_extra, "fLaC", 4 ) )
+    {
+        FLAC_ParseStreamInfo( &p_extra[8], &p_sys->stream_info );
+        p_sys->b_stream_info = true;
+    }
+    else if( i_extra >= FLAC_STREAMINFO_SIZE )
+    {
+        FLAC_ParseStreamInfo( p_extra, &p_sys->stream_info );
+        p_sys->b_stream_info = true;
+    }
+
+    date_Set( &p_sys->end_date, VLC_TICK_INVALID );
+
+    p_dec->fmt_out.i_codec = VLC_CODEC_S32N;
+
+    p_dec->pf_decode = DecodeBlock;
+    p_dec->pf_flush  = Flush;
+
+    return VLC_SUCCESS;
+}
+
+/*****************************************************************************
+ * CloseDecoder: flac decoder destruction
+ *****************************************************************************/
+static void CloseDecoder( vlc_object_t *p_this )
+{
+    decoder_t *p_dec = (decoder_t *)p_this;
+    decoder_sys_t *p_sys = p_dec->p_sys;
+
+    for( unsigned i = 0; i < FLAC_MAX_CHANNELS; i++ )
+        free( p_sys->p_channels[i] );
+    free( p_sys );
+}
@@ -55,6 +55,12 @@
 static int  Create ( vlc_object_t * );
 static void Destroy( vlc_object_t * );
 
+#define PREFETCH_TEXT N_("Prefetch subtitle rendering")
+#define PREFETCH_LONGTEXT N_( \
+    "Rasterize upcoming subtitle events ahead of time on a background " \
+    "thread, so that heavy typesetting does not stall the video at cue " \
+    "boundaries." )
+
 vlc_module_begin ()
     set_shortname( N_("Subtitles (advanced)"))
     set_description( N_("Subtitle renderers using libass") )
@@ -62,6 +68,7 @@ vlc_module_begin ()
     set_category( CAT_INPUT )
     set_subcategory( SUBCAT_INPUT_SCODEC )
     set_callbacks( Create, Destroy )
+    add_bool( "ssa-prefetch", true, PREFETCH_TEXT, PREFETCH_LONGTEXT, true )
 vlc_module_end ()
 
 /*****************************************************************************
@@ -86,6 +93,16 @@ typedef struct
 
     /* */
     ASS_Track      *p_track;
+
+    /* Lookahead rasterization of upcoming events into the renderer cache,
+     * so that display-time renders at cue boundaries find warm glyphs */
+    bool           b_prefetch;
+    bool           b_prefetch_exit;
+    bool           b_renderer_ahead; /* renderer state is a prefetched frame,
+                                        not the last displayed one */
+    vlc_tick_t     i_display_date;   /* last stream date rendered for display */
+    vlc_cond_t     prefetch_cond;
+    vlc_thread_t   prefetch_thread;
 } decoder_sys_t;
 static void DecSysRelease( decoder_sys_t *p_sys );
 static void DecSysHold( decoder_sys_t *p_sys );
@@ -124,6 +141,64 @@ static void RegionDraw( subpicture_region_t *p_region, ASS_Image *p_img );
 
 //#define DEBUG_REGION
 
+/*****************************************************************************
+ * PrefetchThread: rasterize upcoming events ahead of the display
+ *****************************************************************************
+ * The renderer is shared with the display-time render under p_sys->lock, so
+ * prefetching does not parallelize a single render; it moves the expensive
+ * first rasterization of a cue off the vout path while the video is still
+ * showing the previous (cached, thus cheap) frame. libass keys its glyph and
+ * bitmap caches by the current renderer settings, so as long as the frame
+ * size is unchanged the warmed entries are exactly the ones the display
+ * render will look up.
+ *****************************************************************************/
+#define PREFETCH_HORIZON  VLC_TICK_FROM_SEC(1)
+#define PREFETCH_STEP     VLC_TICK_FROM_MS(100)
+
+static void *PrefetchThread( void *p_data )
+{
+    decoder_sys_t *p_sys = p_data;
+
+    vlc_mutex_lock( &p_sys->lock );
+    for( ;; )
+    {
+        vlc_tick_t date = p_sys->i_display_date;
+        while( !p_sys->b_prefetch_exit && p_sys->i_display_date == date )
+            vlc_cond_wait( &p_sys->prefetch_cond, &p_sys->lock );
+        if( p_sys->b_prefetch_exit )
+            break;
+        date = p_sys->i_display_date;
+
+        for( vlc_tick_t ahead = PREFETCH_STEP; ahead <= PREFETCH_HORIZON;
+             ahead += PREFETCH_STEP )
+        {
+            int i_changed;
+            p_sys->b_renderer_ahead = true;
+            ass_render_frame( p_sys->p_renderer, p_sys->p_track,
+                              MS_FROM_VLC_TICK( date + ahead ), &i_changed );
+            /* Give a display-time render a chance to take the lock */
+            vlc_mutex_unlock( &p_sys->lock );
+            vlc_mutex_lock( &p_sys->lock );
+            if( p_sys->b_prefetch_exit || p_sys->i_display_date != date )
+                break;
+        }
+
+        /* Re-render the last displayed date (cheap now that the cache is
+         * warm) so the renderer change detection used by
+         * SubpictureValidate() is relative to what the display last saw */
+        if( !p_sys->b_prefetch_exit && p_sys->i_display_date == date &&
+            p_sys->b_renderer_ahead )
+        {
+            int i_changed;
+            ass_render_frame( p_sys->p_renderer, p_sys->p_track,
+                              MS_FROM_VLC_TICK( date ), &i_changed );
+            p_sys->b_renderer_ahead = false;
+        }
+    }
+    vlc_mutex_unlock( &p_sys->lock );
+    return NULL;
+}
+
 /*****************************************************************************
  * Create: Open libass decoder.
  *****************************************************************************/
@@ -271,6 +346,15 @@ static int Create( vlc_object_t *p_this )
     }
     ass_process_codec_private( p_track, p_dec->fmt_in.p_extra, p_dec->fmt_in.i_extra );
 
+    /* Start the lookahead rasterizer */
+    p_sys->b_prefetch_exit = false;
+    p_sys->b_renderer_ahead = false;
+    p_sys->i_display_date = VLC_TICK_INVALID;
+    vlc_cond_init( &p_sys->prefetch_cond );
+    p_sys->b_prefetch = var_InheritBool( p_dec, "ssa-prefetch" ) &&
+        vlc_clone( &p_sys->prefetch_thread, PrefetchThread, p_sys,
+                   VLC_THREAD_PRIORITY_LOW ) == 0;
+
     p_dec->fmt_out.i_codec = VLC_CODEC_RGBA;
 
     return VLC_SUCCESS;
@@ -304,6 +388,15 @@ static void DecSysRelease( decoder_sys_t *p_sys )
     }
     vlc_mutex_unlock( &p_sys->lock );
 
+    if( p_sys->b_prefetch )
+    {
+        vlc_mutex_lock( &p_sys->lock );
+        p_sys->b_prefetch_exit = true;
+        vlc_cond_signal( &p_sys->prefetch_cond );
+        vlc_mutex_unlock( &p_sys->lock );
+        vlc_join( p_sys->prefetch_thread, NULL );
+    }
+
     if( p_sys->p_track )
         ass_free_track( p_sys->p_track );
     if( p_sys->p_renderer )
@@ -441,7 +534,17 @@ static int SubpictureValidate( subpicture_t *p_subpic,
     ASS_Image *p_img = ass_render_frame( p_sys->p_renderer, p_sys->p_track,
                                          MS_FROM_VLC_TICK( i_stream_date ), &i_changed );
 
-    if( !i_changed && !b_fmt_src && !b_fmt_dst &&
+    /* The renderer change detection is only meaningful against the previous
+     * displayed frame, not against a prefetched future one */
+    const bool b_ahead = p_sys->b_renderer_ahead;
+    p_sys->b_renderer_ahead = false;
+    if( p_sys->b_prefetch && p_sys->i_display_date != i_stream_date )
+    {
+        p_sys->i_display_date = i_stream_date;
+        vlc_cond_signal( &p_sys->prefetch_cond );
+    }
+
+    if( !i_changed && !b_ahead && !b_fmt_src && !b_fmt_dst &&
         (p_img != NULL) == (p_subpic->p_region != NULL) )
     {
         vlc_mutex_unlock( &p_sys->lock );
@@ -42,9 +42,21 @@
 #endif
 
 #include <vlc_network.h>
+#include <vlc_rand.h>
 
 #define NETSYNC_PORT 9875
 
+/* How often a slave exchanges clocks with the master. */
+#define NETSYNC_EXCHANGE_PERIOD VLC_TICK_FROM_MS(100)
+
+/* Offsets below this are slewed through the PI controller; anything
+ * larger (startup, seek, master restart) is stepped at once. */
+#define NETSYNC_RESYNC_THRESHOLD VLC_TICK_FROM_MS(250)
+
+/* PI controller gain divisors. */
+#define NETSYNC_KP 4
+#define NETSYNC_KI 16
+
 /*****************************************************************************
  * Module descriptor
  *****************************************************************************/
@@ -124,6 +136,12 @@ static int Open(vlc_object_t *object)
         return VLC_EGENERIC;
     }
 
+#ifdef SO_TIMESTAMPNS
+    /* Ask the kernel to stamp incoming datagrams on reception, so the
+     * clock math is not skewed by scheduling and wakeup latency. */
+    setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &(int){ 1 }, sizeof (int));
+#endif
+
     intf->p_sys = sys = malloc(sizeof(*sys));
     if (!sys) {
         net_Close(fd);
@@ -173,13 +191,61 @@ static vlc_tick_t GetPcrSystem(input_thread_t *input)
     return system;
 }
 
+/* Receive a datagram along with its reception date. The kernel stamp, when
+ * available, is taken at interrupt time and mapped onto the vlc_tick_now()
+ * time base; otherwise the date is sampled in user space after the fact. */
+static ssize_t ReceiveStamped(int fd, void *buf, size_t len,
+                              struct sockaddr *addr, socklen_t *addrlen,
+                              vlc_tick_t *date)
+{
+#ifdef SO_TIMESTAMPNS
+    struct iovec iov = { .iov_base = buf, .iov_len = len, };
+    char ctl[CMSG_SPACE(sizeof (struct timespec))];
+    struct msghdr msg = {
+        .msg_name = addr,
+        .msg_namelen = (addrlen != NULL) ? *addrlen : 0,
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = ctl,
+        .msg_controllen = sizeof (ctl),
+    };
+
+    ssize_t val = recvmsg(fd, &msg, 0);
+    *date = vlc_tick_now();
+    if (val < 0)
+        return val;
+    if (addrlen != NULL)
+        *addrlen = msg.msg_namelen;
+
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET
+         || cmsg->cmsg_type != SCM_TIMESTAMPNS)
+            continue;
+
+        /* The stamp is on CLOCK_REALTIME; back-date vlc_tick_now() by the
+         * real time elapsed since the kernel took it. */
+        struct timespec stamp, now;
+        memcpy(&stamp, CMSG_DATA(cmsg), sizeof (stamp));
+        clock_gettime(CLOCK_REALTIME, &now);
+        *date -= vlc_tick_from_timespec(&now) - vlc_tick_from_timespec(&stamp);
+        break;
+    }
+    return val;
+#else
+    ssize_t val = recvfrom(fd, buf, len, 0, addr, addrlen);
+    *date = vlc_tick_now();
+    return val;
+#endif
+}
+
 static void *Master(void *handle)
 {
     intf_thread_t *intf = handle;
     intf_sys_t *sys = intf->p_sys;
     for (;;) {
         struct pollfd ufd = { .fd = sys->fd, .events = POLLIN, };
-        uint64_t data[2];
+        uint64_t data[3];
 
         if (poll(&ufd, 1, -1) < 0)
             continue;
@@ -187,20 +253,26 @@ static void *Master(void *handle)
         /* We received something */
         struct sockaddr_storage from;
         socklen_t fromlen = sizeof (from);
+        vlc_tick_t receive_date;
 
-        if (recvfrom(sys->fd, data, 8, 0,
-                     (struct sockaddr *)&from, &fromlen) < 8)
+        if (ReceiveStamped(sys->fd, data, 8,
+                           (struct sockaddr *)&from, &fromlen,
+                           &receive_date) < 8)
             continue;
 
         vlc_tick_t master_system = GetPcrSystem(sys->input);
         if (master_system < 0)
             continue;
 
+        /* The first two fields stay where older slaves expect them; the
+         * receive stamp is appended so newer slaves can cancel our
+         * processing time out of the measured round trip. */
         data[0] = hton64(vlc_tick_now());
         data[1] = hton64(master_system);
+        data[2] = hton64(receive_date);
 
         /* Reply to the sender */
-        sendto(sys->fd, data, 16, 0,
+        sendto(sys->fd, data, 24, 0,
                (struct sockaddr *)&from, fromlen);
 #if 0
         /* not sure we need the client information to sync,
@@ -219,14 +291,30 @@ static void *Slave(void *handle)
 {
     intf_thread_t *intf = handle;
     intf_sys_t *sys = intf->p_sys;
+    vlc_tick_t integral = 0;
+    bool latched = false;
+
+    /* Randomize the initial phase so slaves started together do not keep
+     * hitting the master in synchronized bursts. */
+    vlc_tick_t deadline = vlc_tick_now()
+                        + vlc_lrand48() % NETSYNC_EXCHANGE_PERIOD;
 
     for (;;) {
         struct pollfd ufd = { .fd = sys->fd, .events = POLLIN, };
-        uint64_t data[2];
+        uint64_t data[3];
+
+        vlc_tick_wait(deadline);
+        deadline += NETSYNC_EXCHANGE_PERIOD;
+        if (deadline < vlc_tick_now()) /* fell behind (timeouts, suspend) */
+            deadline = vlc_tick_now() + NETSYNC_EXCHANGE_PERIOD;
 
         vlc_tick_t system = GetPcrSystem(sys->input);
-        if (system < 0)
-            goto wait;
+        if (system < 0) {
+            /* No reference (buffering, track change): the origin may move
+             * under us, so restart the controller once it comes back. */
+            integral = 0;
+            continue;
+        }
 
         /* Send clock request to the master */
         const vlc_tick_t send_date = vlc_tick_now();
@@ -238,35 +326,61 @@ static void *Slave(void *handle)
         if (poll(&ufd, 1, sys->timeout) <= 0)
             continue;
 
-        const vlc_tick_t receive_date = vlc_tick_now();
-        if (recv(sys->fd, data, 16, 0) < 16)
-            goto wait;
+        vlc_tick_t receive_date;
+        const ssize_t bytes = ReceiveStamped(sys->fd, data, sizeof (data),
+                                             NULL, NULL, &receive_date);
+        if (bytes < 16)
+            continue;
 
         const vlc_tick_t master_date   = ntoh64(data[0]);
         const vlc_tick_t master_system = ntoh64(data[1]);
-        const vlc_tick_t diff_date = receive_date -
-                                  ((receive_date - send_date) / 2 + master_date);
+        /* A 24 byte reply carries the master receive stamp, removing the
+         * master processing time from the offset; an old 16 byte reply
+         * degrades to assuming the request and reply legs are symmetric. */
+        const vlc_tick_t master_receive =
+            (bytes >= 24) ? (vlc_tick_t)ntoh64(data[2]) : master_date;
+        const vlc_tick_t diff_date = ((send_date - master_receive)
+                                   + (receive_date - master_date)) / 2;
 
         if (master_system > 0) {
             int canc = vlc_savecancel();
 
             vlc_tick_t client_system;
             if (!input_GetPcrSystem(sys->input, &client_system, NULL)) {
-                const vlc_tick_t diff_system = client_system - master_system - diff_date;
-                if (diff_system != 0) {
-                    input_ModifyPcrSystem(sys->input, true, master_system - diff_date);
+                const vlc_tick_t err =
+                    client_system - (master_system - diff_date);
+
+                if (err > NETSYNC_RESYNC_THRESHOLD
+                 || err < -NETSYNC_RESYNC_THRESHOLD) {
+                    /* Way off: step the clock at once and start over. */
+                    input_ModifyPcrSystem(sys->input, true,
+                                          master_system - diff_date);
+                    integral = 0;
+                    latched = false;
+                } else {
+                    /* The first relative origin change latches the value it
+                     * is measured against; latch zero so every later call
+                     * applies its argument as a delta. */
+                    if (!latched)
+                        latched = !input_ModifyPcrSystem(sys->input, false, 0);
+                    if (latched) {
+                        integral += err / NETSYNC_KI;
+                        const vlc_tick_t correction =
+                            err / NETSYNC_KP + integral;
+                        if (correction != 0)
+                            input_ModifyPcrSystem(sys->input, false,
+                                                  -correction);
+                    }
+                }
 #if 0
-                    msg_Dbg(intf, "Slave clockref: %"PRId64" -> %"PRId64" -> %"PRId64","
-                             " clock diff: %"PRId64", diff: %"PRId64"",
-                             system, master_system, client_system,
-                             diff_system, diff_date);
+                msg_Dbg(intf, "Slave clockref: %"PRId64" -> %"PRId64" -> %"PRId64","
+                         " err: %"PRId64", diff: %"PRId64"",
+                         system, master_system, client_system,
+                         err, diff_date);
 #endif
-                }
             }
             vlc_restorecancel(canc);
         }
-    wait:
-        vlc_tick_sleep(INTF_IDLE_SLEEP);
     }
     return NULL;
 }
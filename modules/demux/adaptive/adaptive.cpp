@@ -79,6 +79,19 @@ static void Close   (vlc_object_t *);
 
 #define ADAPT_LOGIC_TEXT N_("Adaptive Logic")
 
+#define ADAPT_PREDICTOR_TEXT N_("Bandwidth predictor")
+#define ADAPT_PREDICTOR_LONGTEXT N_("Estimator applied to the per-segment " \
+    "bandwidth samples by the rate based logic")
+
+static const char *const ppsz_predictors_values[] = {
+                                "",
+                                "harmonic",
+                                "percentile"};
+
+static const char *const ppsz_predictors[] = { N_("Default (smoothed)"),
+                                               N_("Harmonic mean"),
+                                               N_("Percentile")};
+
 #define ADAPT_ACCESS_TEXT N_("Use regular HTTP modules")
 #define ADAPT_ACCESS_LONGTEXT N_("Connect using HTTP access instead of custom HTTP code")
 
@@ -131,6 +144,9 @@ vlc_module_begin ()
         set_subcategory( SUBCAT_INPUT_DEMUX )
         add_string( "adaptive-logic",  "", ADAPT_LOGIC_TEXT, NULL, false )
             change_string_list( ppsz_logics_values, ppsz_logics )
+        add_string( "adaptive-predictor", "", ADAPT_PREDICTOR_TEXT,
+                    ADAPT_PREDICTOR_LONGTEXT, false )
+            change_string_list( ppsz_predictors_values, ppsz_predictors )
         add_integer( "adaptive-maxwidth",  0,
                      ADAPT_WIDTH_TEXT,  ADAPT_WIDTH_TEXT,  false )
         add_integer( "adaptive-maxheight", 0,
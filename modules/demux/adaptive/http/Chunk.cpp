@@ -302,7 +302,8 @@ HTTPChunkBufferedSource::HTTPChunkBufferedSource(const std::string& url, Abstrac
     done = false;
     eof = false;
     held = false;
-    downloadstart = 0;
+    rateobs.size = 0;
+    rateobs.time = 0;
 }
 
 HTTPChunkBufferedSource::~HTTPChunkBufferedSource()
@@ -377,16 +378,19 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
         vlc_tick_t time;
     } rate = {0,0};
 
+    vlc_tick_t time = vlc_tick_now();
     ssize_t ret = connection->read(p_block->p_buffer, readsize);
+    time = vlc_tick_now() - time;
     if(ret <= 0)
     {
         block_Release(p_block);
         p_block = NULL;
         vlc_mutex_locker locker( &lock );
         done = true;
-        rate.size = buffered + consumed;
-        rate.time = vlc_tick_now() - downloadstart;
-        downloadstart = 0;
+        rate.size = rateobs.size;
+        rate.time = rateobs.time;
+        rateobs.size = 0;
+        rateobs.time = 0;
     }
     else
     {
@@ -395,11 +399,19 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
         buffered += p_block->i_buffer;
         block_ChainLastAppend(&pp_tail, p_block);
         if((size_t) ret < readsize)
-        {
             done = true;
-            rate.size = buffered + consumed;
-            rate.time = vlc_tick_now() - downloadstart;
-            downloadstart = 0;
+        /* Measure each transfer individually so the rate accounts for
+         * network time only, not for scheduling gaps between reads.
+         * Report in sub-segment windows to let the adaptation logic
+         * react while a (chunked-transfer) segment is still loading. */
+        rateobs.size += (size_t) ret;
+        rateobs.time += time;
+        if(done || rateobs.time >= VLC_TICK_FROM_MS(250))
+        {
+            rate.size = rateobs.size;
+            rate.time = rateobs.time;
+            rateobs.size = 0;
+            rateobs.time = 0;
         }
     }
 
@@ -411,16 +423,6 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
     vlc_cond_signal(&avail);
 }
 
-bool HTTPChunkBufferedSource::prepare()
-{
-    if(!prepared)
-    {
-        downloadstart = vlc_tick_now();
-        return HTTPChunkSource::prepare();
-    }
-    return true;
-}
-
 bool HTTPChunkBufferedSource::hasMoreData() const
 {
     vlc_mutex_locker locker( &lock );
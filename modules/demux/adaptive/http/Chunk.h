@@ -130,7 +130,6 @@ namespace adaptive
                 void               release();
 
             protected:
-                virtual bool       prepare(); /* reimpl */
                 void               bufferize(size_t);
                 bool               isDone() const;
 
@@ -140,7 +139,11 @@ namespace adaptive
                 size_t              buffered; /* read cache size */
                 bool                done;
                 bool                eof;
-                vlc_tick_t          downloadstart;
+                struct
+                {
+                    size_t     size;
+                    vlc_tick_t time;
+                } rateobs; /* per-slice rate accumulator, not yet reported */
                 vlc_cond_t          avail;
                 bool                held;
         };
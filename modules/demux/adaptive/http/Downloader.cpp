@@ -25,27 +25,31 @@
 
 #include <vlc_threads.h>
 
+#include <algorithm>
 #include <atomic>
 
 using namespace adaptive::http;
 
-Downloader::Downloader()
+Downloader::Downloader(unsigned workers)
 {
     vlc_mutex_init(&lock);
     vlc_cond_init(&waitcond);
     killed = false;
-    thread_handle_valid = false;
+    max_workers = std::max(workers, 1u);
+    if(max_workers > MAX_WORKERS)
+        max_workers = MAX_WORKERS;
+    workers_count = 0;
 }
 
 bool Downloader::start()
 {
-    if(!thread_handle_valid &&
-       vlc_clone(&thread_handle, downloaderThread,
-                 static_cast<void *>(this), VLC_THREAD_PRIORITY_INPUT))
+    while(workers_count < max_workers)
     {
-        return false;
+        if(vlc_clone(&thread_handles[workers_count], downloaderThread,
+                     static_cast<void *>(this), VLC_THREAD_PRIORITY_INPUT))
+            return workers_count > 0; /* degraded but functional */
+        workers_count++;
     }
-    thread_handle_valid = true;
     return true;
 }
 
@@ -53,26 +57,39 @@ Downloader::~Downloader()
 {
     vlc_mutex_lock( &lock );
     killed = true;
-    vlc_cond_signal(&waitcond);
+    vlc_cond_broadcast(&waitcond);
     vlc_mutex_unlock( &lock );
 
-    if(thread_handle_valid)
-        vlc_join(thread_handle, NULL);
+    for(unsigned i = 0; i < workers_count; i++)
+        vlc_join(thread_handles[i], NULL);
 }
+
 void Downloader::schedule(HTTPChunkBufferedSource *source)
 {
     vlc_mutex_lock(&lock);
     source->hold();
     chunks.push_back(source);
-    vlc_cond_signal(&waitcond);
+    vlc_cond_broadcast(&waitcond);
     vlc_mutex_unlock(&lock);
 }
 
 void Downloader::cancel(HTTPChunkBufferedSource *source)
 {
     vlc_mutex_lock(&lock);
-    source->release();
-    chunks.remove(source);
+    std::list<HTTPChunkBufferedSource *>::iterator it =
+        std::find(chunks.begin(), chunks.end(), source);
+    if(it != chunks.end())
+    {   /* not yet picked by a worker */
+        chunks.erase(it);
+        source->release();
+    }
+    else
+    {   /* maybe in flight: wait for the owning worker to drop it, so the
+         * caller can safely delete the source afterwards */
+        while(std::find(active.begin(), active.end(), source) != active.end())
+            vlc_cond_wait(&waitcond, &lock);
+        source->release();
+    }
     vlc_mutex_unlock(&lock);
 }
 
@@ -102,16 +119,23 @@ void Downloader::Run()
         if(killed)
             break;
 
-        if(!chunks.empty())
+        HTTPChunkBufferedSource *source = chunks.front();
+        chunks.pop_front();
+        active.push_back(source);
+
+        /* Download in slices without holding the scheduling lock, so the
+         * other workers keep feeding their own connections meanwhile. */
+        while(!killed && !source->isDone())
         {
-            HTTPChunkBufferedSource *source = chunks.front();
+            vlc_mutex_unlock(&lock);
             DownloadSource(source);
-            if(source->isDone())
-            {
-                chunks.pop_front();
-                source->release();
-            }
+            vlc_mutex_lock(&lock);
         }
+
+        active.remove(source);
+        source->release();
+        /* wake cancel()ers waiting on the active list */
+        vlc_cond_broadcast(&waitcond);
     }
     vlc_mutex_unlock(&lock);
 }
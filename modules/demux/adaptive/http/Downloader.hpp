@@ -31,25 +31,34 @@ namespace adaptive
     namespace http
     {
 
+        /* Pool of download workers. Several chunk sources (current segment,
+         * lookahead segments, other streams) are fetched concurrently over
+         * their own connections, giving the pipeline enough depth to ride
+         * out RTT spikes instead of stalling on a single in-order fetch. */
         class Downloader
         {
             public:
-                Downloader();
+                Downloader(unsigned workers = MAX_WORKERS);
                 ~Downloader();
                 bool start();
                 void schedule(HTTPChunkBufferedSource *);
                 void cancel(HTTPChunkBufferedSource *);
 
+                static const unsigned MAX_WORKERS = 4;
+
             private:
                 static void * downloaderThread(void *);
                 void Run();
                 void DownloadSource(HTTPChunkBufferedSource *);
-                vlc_thread_t thread_handle;
+                vlc_thread_t thread_handles[MAX_WORKERS];
+                unsigned     max_workers;
+                unsigned     workers_count;
                 vlc_mutex_t  lock;
                 vlc_cond_t   waitcond;
-                bool         thread_handle_valid;
                 bool         killed;
                 std::list<HTTPChunkBufferedSource *> chunks;
+                /* sources currently owned by a worker, still cancellable */
+                std::list<HTTPChunkBufferedSource *> active;
         };
 
     }
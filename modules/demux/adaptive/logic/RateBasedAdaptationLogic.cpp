@@ -44,11 +44,17 @@ RateBasedAdaptationLogic::RateBasedAdaptationLogic  (vlc_object_t *obj) :
     usedBps = 0;
     dllength = 0;
     dlsize = 0;
+
+    char *psz_predictor = var_InheritString(obj, "adaptive-predictor");
+    predictor = createRatePredictor<size_t>(psz_predictor ? psz_predictor : "");
+    free(psz_predictor);
+
     vlc_mutex_init(&lock);
 }
 
 RateBasedAdaptationLogic::~RateBasedAdaptationLogic()
 {
+    delete predictor;
 }
 
 BaseRepresentation *RateBasedAdaptationLogic::getNextRepresentation(BaseAdaptationSet *adaptSet, BaseRepresentation *currep)
@@ -90,7 +96,7 @@ void RateBasedAdaptationLogic::updateDownloadRate(const ID &, size_t size, vlc_t
     const size_t bps = CLOCK_FREQ * dlsize * 8 / dllength;
 
     vlc_mutex_lock(&lock);
-    bpsAvg = average.push(bps);
+    bpsAvg = likely(predictor != NULL) ? predictor->push(bps) : bps;
 
 //    BwDebug(msg_Dbg(p_obj, "alpha1 %lf alpha0 %lf dmax %ld ds %ld", alpha,
 //                    (double)deltamax / diffsum, deltamax, diffsum));
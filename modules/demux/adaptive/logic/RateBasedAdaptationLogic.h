@@ -26,7 +26,7 @@
 #define RATEBASEDADAPTATIONLOGIC_H_
 
 #include "AbstractAdaptationLogic.h"
-#include "../tools/MovingAverage.hpp"
+#include "../tools/RatePredictor.hpp"
 
 namespace adaptive
 {
@@ -48,7 +48,7 @@ namespace adaptive
                 size_t                  currentBps;
                 size_t                  usedBps;
 
-                MovingAverage<size_t>   average;
+                RatePredictor<size_t>  *predictor;
 
                 size_t                  dlsize;
                 vlc_tick_t              dllength;
@@ -0,0 +1,118 @@
+/*
+ * RatePredictor.hpp
+ *****************************************************************************
+ * Copyright (C) 2026 VideoLAN Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifndef RATEPREDICTOR_HPP
+#define RATEPREDICTOR_HPP
+
+#include "MovingAverage.hpp"
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <algorithm>
+#include <new>
+
+namespace adaptive
+{
+    /* Bandwidth predictor interface: one sample is pushed per measurement
+     * window and the updated estimate is returned. */
+    template <class T>
+    class RatePredictor
+    {
+        public:
+            virtual ~RatePredictor() {}
+            virtual T push(T) = 0;
+    };
+
+    /* Vertical Horizontal Filter smoothing (historical default) */
+    template <class T>
+    class SmoothedRatePredictor : public RatePredictor<T>
+    {
+        public:
+            SmoothedRatePredictor(unsigned nbobs = 10) : average(nbobs) {}
+            virtual T push(T v) { return average.push(v); }
+
+        private:
+            MovingAverage<T> average;
+    };
+
+    /* Harmonic mean over a ring of per-segment samples. The harmonic mean
+     * weights low outliers more, yielding a conservative estimate when the
+     * throughput alternates between bursts and stalls. */
+    template <class T>
+    class HarmonicMeanRatePredictor : public RatePredictor<T>
+    {
+        public:
+            HarmonicMeanRatePredictor(unsigned nbobs = 10) : maxobs(nbobs) {}
+            virtual T push(T v)
+            {
+                if(values.size() >= maxobs)
+                    values.pop_front();
+                values.push_back(v);
+
+                double invsum = 0.0;
+                typename std::deque<T>::const_iterator it;
+                for(it = values.begin(); it != values.end(); ++it)
+                    invsum += 1.0 / std::max<T>(*it, 1);
+                return values.size() / invsum;
+            }
+
+        private:
+            std::deque<T> values;
+            unsigned maxobs;
+    };
+
+    /* Fixed percentile over a ring of per-segment samples. A low percentile
+     * discards optimistic bursts entirely and converges to the sustainable
+     * rate, at the cost of a slower upward reaction. */
+    template <class T>
+    class PercentileRatePredictor : public RatePredictor<T>
+    {
+        public:
+            PercentileRatePredictor(unsigned pct = 25, unsigned nbobs = 10)
+                : percentile(pct), maxobs(nbobs) {}
+            virtual T push(T v)
+            {
+                if(values.size() >= maxobs)
+                    values.pop_front();
+                values.push_back(v);
+
+                std::vector<T> sorted(values.begin(), values.end());
+                std::sort(sorted.begin(), sorted.end());
+                return sorted[(sorted.size() - 1) * percentile / 100];
+            }
+
+        private:
+            std::deque<T> values;
+            unsigned percentile;
+            unsigned maxobs;
+    };
+
+    template <class T>
+    RatePredictor<T> * createRatePredictor(const std::string &name)
+    {
+        if(name == "harmonic")
+            return new (std::nothrow) HarmonicMeanRatePredictor<T>();
+        if(name == "percentile")
+            return new (std::nothrow) PercentileRatePredictor<T>();
+        return new (std::nothrow) SmoothedRatePredictor<T>();
+    }
+}
+
+#endif // RATEPREDICTOR_HPP
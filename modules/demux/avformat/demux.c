@@ -81,7 +81,8 @@ typedef struct
     unsigned i_update;
 } demux_sys_t;
 
-#define AVFORMAT_IOBUFFER_SIZE 32768  /* FIXME */
+#define AVFORMAT_IOBUFFER_SIZE     32768
+#define AVFORMAT_IOBUFFER_SIZE_MAX (256 * 1024)
 
 /*****************************************************************************
  * Local prototypes
@@ -96,6 +97,60 @@ static block_t *BuildSsaFrame( const AVPacket *p_pkt, unsigned i_order );
 static void UpdateSeekPoint( demux_t *p_demux, vlc_tick_t i_time );
 static void ResetTime( demux_t *p_demux, int64_t i_time );
 
+/*****************************************************************************
+ * Zero-copy AVPacket wrapping
+ *****************************************************************************/
+struct avformat_block_s
+{
+    block_t  self;
+    AVPacket pkt;
+};
+
+static void AVPacketRelease( block_t *p_block )
+{
+    struct avformat_block_s *b =
+        container_of( p_block, struct avformat_block_s, self );
+
+    av_packet_unref( &b->pkt );
+    free( b );
+}
+
+static const struct vlc_block_callbacks avformat_block_cbs =
+{
+    AVPacketRelease,
+};
+
+/* Wrap a refcounted AVPacket payload as a block without copying it.  The
+ * packet reference moves into the block and is only dropped when the block
+ * is released, wherever the pipeline takes it. */
+static block_t *WrapAVPacket( AVPacket *p_pkt )
+{
+    struct avformat_block_s *b = malloc( sizeof (*b) );
+    if( unlikely(b == NULL) )
+        return NULL;
+
+    block_Init( &b->self, &avformat_block_cbs, p_pkt->data, p_pkt->size );
+    av_packet_move_ref( &b->pkt, p_pkt );
+    return &b->self;
+}
+
+/* Size the lavf I/O buffer from what is known at open time; lavf offers no
+ * safe way to resize it once reading has started. */
+static size_t IOBufferSize( demux_t *p_demux, bool b_can_seek )
+{
+    if( !b_can_seek )
+        /* The buffer is all that decouples a non-seekable (network) input
+         * from the demuxer's read pattern. */
+        return AVFORMAT_IOBUFFER_SIZE_MAX;
+
+    /* A large file at any plausible bitrate reads way past a 32 KiB window
+     * in no time; batch the underlying reads. */
+    if( stream_Size( p_demux->s ) >= (int64_t)AVFORMAT_IOBUFFER_SIZE_MAX * 128 )
+        return AVFORMAT_IOBUFFER_SIZE_MAX;
+
+    return AVFORMAT_IOBUFFER_SIZE;
+}
+
 static vlc_fourcc_t CodecTagToFourcc( uint32_t codec_tag )
 {
     // convert from little-endian avcodec codec_tag to VLC native-endian fourcc
@@ -351,7 +406,8 @@ int avformat_OpenDemux( vlc_object_t *p_this )
     p_sys->i_update = 0;
 
     /* Create I/O wrapper */
-    unsigned char * p_io_buffer = av_malloc( AVFORMAT_IOBUFFER_SIZE );
+    size_t i_io_buffer = IOBufferSize( p_demux, b_can_seek );
+    unsigned char * p_io_buffer = av_malloc( i_io_buffer );
     if( !p_io_buffer )
     {
         avformat_CloseDemux( p_this );
@@ -367,7 +423,7 @@ int avformat_OpenDemux( vlc_object_t *p_this )
     }
 
     AVIOContext *pb = p_sys->ic->pb = avio_alloc_context( p_io_buffer,
-        AVFORMAT_IOBUFFER_SIZE, 0, p_demux, IORead, NULL, IOSeek );
+        i_io_buffer, 0, p_demux, IORead, NULL, IOSeek );
     if( !pb )
     {
         av_free( p_io_buffer );
@@ -848,12 +904,19 @@ static int Demux( demux_t *p_demux )
     }
     else
     {
-        if( ( p_frame = block_Alloc( pkt.size ) ) == NULL )
+        if( pkt.buf != NULL )
+            p_frame = WrapAVPacket( &pkt );
+        else
+        {   /* Not refcounted; copying is the only option */
+            p_frame = block_Alloc( pkt.size );
+            if( p_frame != NULL )
+                memcpy( p_frame->p_buffer, pkt.data, pkt.size );
+        }
+        if( p_frame == NULL )
         {
             av_packet_unref( &pkt );
             return 0;
         }
-        memcpy( p_frame->p_buffer, pkt.data, pkt.size );
     }
 
     if( pkt.flags & AV_PKT_FLAG_KEY )
@@ -165,6 +165,16 @@ typedef struct
     unsigned int    i_blockno;
     unsigned int    i_blocksize;
 
+    /* Read-ahead cache over the track region of the file, used for
+     * non-interleaved files on slow seekable streams */
+    struct
+    {
+        block_t     *p_chain;   /* raw file bytes, contiguous */
+        block_t    **pp_last;
+        uint64_t     i_offset;  /* file offset of the chain first byte */
+        size_t       i_size;    /* number of bytes in the chain */
+    } cache;
+
 } avi_track_t;
 
 typedef struct
@@ -198,12 +208,17 @@ typedef struct
 
 #define __EVEN(x) (((x) & 1) ? (x) + 1 : (x))
 
+/* How much data a track read-ahead cache fetches per upstream seek */
+#define AVI_READAHEAD_SIZE (2 * 1024 * 1024)
+
 static int64_t AVI_PTSToChunk( avi_track_t *, vlc_tick_t i_pts );
 static int64_t AVI_PTSToByte ( avi_track_t *, vlc_tick_t i_pts );
 static vlc_tick_t AVI_GetDPTS   ( avi_track_t *, int64_t i_count );
 static vlc_tick_t AVI_GetPTS    ( avi_track_t * );
 
 
+static void AVI_TrackCacheFlush( avi_track_t * );
+
 static int AVI_StreamChunkFind( demux_t *, unsigned int i_stream );
 static int AVI_StreamChunkSet ( demux_t *,
                                 unsigned int i_stream, unsigned int i_ck );
@@ -277,6 +292,7 @@ static void Close ( vlc_object_t * p_this )
         {
             es_format_Clean( &p_sys->track[i]->fmt );
             avi_index_Clean( &p_sys->track[i]->idx );
+            AVI_TrackCacheFlush( p_sys->track[i] );
             free( p_sys->track[i] );
         }
     }
@@ -465,6 +481,7 @@ static int Open( vlc_object_t * p_this )
 
         tk->b_eof = false;
         tk->b_activated = true;
+        tk->cache.pp_last = &tk->cache.p_chain;
 
         p_vids = (avi_chunk_strf_vids_t*)AVI_ChunkFind( p_strl, AVIFOURCC_strf, 0, false );
         p_auds = (avi_chunk_strf_auds_t*)p_vids;
@@ -826,15 +843,112 @@ error:
 }
 
 /*****************************************************************************
- * ReadFrame: Reads frame, using stride if necessary
+ * Track read-ahead cache: for non-interleaved files, each track keeps its
+ * own cursor into its region of the file and prefetches a large slice on
+ * every upstream seek, so that demuxing does not bounce the access back
+ * and forth between the track regions once per chunk.
  *****************************************************************************/
+static void AVI_TrackCacheFlush( avi_track_t *tk )
+{
+    block_ChainRelease( tk->cache.p_chain );
+    tk->cache.p_chain = NULL;
+    tk->cache.pp_last = &tk->cache.p_chain;
+    tk->cache.i_size = 0;
+}
 
-static block_t * ReadFrame( demux_t *p_demux, const avi_track_t *tk,
-                     const unsigned int i_header, const int i_size )
+static void AVI_TrackCacheSkip( avi_track_t *tk, size_t i_skip )
 {
-    block_t *p_frame = vlc_stream_Block( p_demux->s, __EVEN( i_size ) );
-    if ( !p_frame ) return p_frame;
+    tk->cache.i_offset += i_skip;
+    tk->cache.i_size -= i_skip;
+
+    while( i_skip > 0 )
+    {
+        block_t *b = tk->cache.p_chain;
+
+        if( i_skip < b->i_buffer )
+        {
+            b->p_buffer += i_skip;
+            b->i_buffer -= i_skip;
+            break;
+        }
+        i_skip -= b->i_buffer;
+        tk->cache.p_chain = b->p_next;
+        block_Release( b );
+    }
+    if( tk->cache.p_chain == NULL )
+        tk->cache.pp_last = &tk->cache.p_chain;
+}
+
+/* Reads i_size bytes at file offset i_pos through the track cache,
+ * refilling it from the stream when it runs dry.
+ * Returns NULL on error or end of stream. */
+static block_t *AVI_TrackCacheRead( demux_t *p_demux, avi_track_t *tk,
+                                    uint64_t i_pos, size_t i_size )
+{
+    /* Drop cached data behind the read position; a jump outside of the
+     * cached range invalidates the whole cache */
+    if( tk->cache.p_chain != NULL )
+    {
+        if( i_pos < tk->cache.i_offset
+         || i_pos >= tk->cache.i_offset + tk->cache.i_size )
+            AVI_TrackCacheFlush( tk );
+        else if( i_pos > tk->cache.i_offset )
+            AVI_TrackCacheSkip( tk, i_pos - tk->cache.i_offset );
+    }
+
+    if( tk->cache.i_size < i_size )
+    {   /* Refill: seek to the end of the cached data once, then fetch a
+         * large slice of the track region in one go */
+        const size_t i_target = __MAX( i_size, AVI_READAHEAD_SIZE );
+
+        if( tk->cache.p_chain == NULL )
+            tk->cache.i_offset = i_pos;
+
+        uint64_t i_end = tk->cache.i_offset + tk->cache.i_size;
 
+        if( vlc_stream_Tell( p_demux->s ) != i_end
+         && vlc_stream_Seek( p_demux->s, i_end ) )
+            return NULL;
+
+        while( tk->cache.i_size < i_target )
+        {
+            block_t *b = vlc_stream_Block( p_demux->s,
+                                           i_target - tk->cache.i_size );
+            if( b == NULL )
+                break;
+            tk->cache.i_size += b->i_buffer;
+            block_ChainLastAppend( &tk->cache.pp_last, b );
+        }
+
+        if( tk->cache.i_size == 0 )
+            return NULL;
+        if( tk->cache.i_size < i_size )
+            i_size = tk->cache.i_size; /* truncated last chunk: short read */
+    }
+
+    block_t *p_frame = block_Alloc( i_size );
+    if( unlikely( p_frame == NULL ) )
+        return NULL;
+
+    size_t i_copied = 0;
+    for( block_t *b = tk->cache.p_chain; i_copied < i_size; b = b->p_next )
+    {
+        size_t i_copy = __MIN( b->i_buffer, i_size - i_copied );
+
+        memcpy( p_frame->p_buffer + i_copied, b->p_buffer, i_copy );
+        i_copied += i_copy;
+    }
+    AVI_TrackCacheSkip( tk, i_size );
+    return p_frame;
+}
+
+/*****************************************************************************
+ * ReadFrame: Reads frame, using stride if necessary
+ *****************************************************************************/
+
+static block_t *ProcessFrame( const avi_track_t *tk, block_t *p_frame,
+                              const unsigned int i_header, const int i_size )
+{
     if( i_size % 2 )    /* read was padded on word boundary */
     {
         p_frame->i_buffer--;
@@ -907,6 +1021,15 @@ static block_t * ReadFrame( demux_t *p_demux, const avi_track_t *tk,
     return p_frame;
 }
 
+static block_t * ReadFrame( demux_t *p_demux, const avi_track_t *tk,
+                     const unsigned int i_header, const int i_size )
+{
+    block_t *p_frame = vlc_stream_Block( p_demux->s, __EVEN( i_size ) );
+    if ( !p_frame ) return p_frame;
+
+    return ProcessFrame( tk, p_frame, i_header, i_size );
+}
+
 /*****************************************************************************
  * SendFrame: Sends frame to ES and does payload processing
  *****************************************************************************/
@@ -1024,6 +1147,12 @@ static int Demux_Seekable( demux_t *p_demux )
     es_out_SetPCR( p_demux->out, VLC_TICK_0 + p_sys->i_time );
     p_sys->i_time += p_sys->i_read_increment;
 
+    /* On a slow seekable stream, a non-interleaved file makes this loop
+     * alternate between the track regions of the file on every increment;
+     * read ahead within each region rather than seek back per chunk */
+    const bool b_use_cache = !p_sys->b_interleaved && !p_sys->b_fastseekable
+                          && i_track_count > 1;
+
     /* init toread */
     for( i_track = 0; i_track < p_sys->i_track; i_track++ )
     {
@@ -1187,11 +1316,6 @@ static int Demux_Seekable( demux_t *p_demux )
             }
 
         }
-        else
-        {
-            if (vlc_stream_Seek(p_demux->s, i_pos))
-                return VLC_DEMUXER_EGENERIC;
-        }
 
         /* Set the track to use */
         tk = p_sys->track[i_track];
@@ -1227,8 +1351,24 @@ static int Demux_Seekable( demux_t *p_demux )
             i_size += 8; /* need to read and skip header */
         }
 
-        if( ( p_frame = ReadFrame( p_demux, tk,
-                        ( tk->i_idxposb == 0 ) ? 8 : 0, i_size ) )==NULL )
+        if( i_pos != -1 && b_use_cache )
+        {
+            p_frame = AVI_TrackCacheRead( p_demux, tk, i_pos,
+                                          __EVEN( i_size ) );
+            if( p_frame != NULL )
+                p_frame = ProcessFrame( tk, p_frame,
+                                        ( tk->i_idxposb == 0 ) ? 8 : 0,
+                                        i_size );
+        }
+        else
+        {
+            if( i_pos != -1 && vlc_stream_Seek( p_demux->s, i_pos ) )
+                return VLC_DEMUXER_EGENERIC;
+
+            p_frame = ReadFrame( p_demux, tk,
+                                 ( tk->i_idxposb == 0 ) ? 8 : 0, i_size );
+        }
+        if( p_frame == NULL )
         {
             msg_Warn( p_demux, "failed reading data" );
             tk->b_eof = false;
@@ -37,8 +37,23 @@
 #define APPEND_LONGTEXT N_( \
     "If the file already exists, it will not be overwritten." )
 
+#define ES_FILE_TEXT N_("Capture filename")
+#define ES_FILE_LONGTEXT N_( \
+    "Name of the file to which the elementary streams will be captured." )
+
+#define SCALE_TEXT N_("Replay time scale")
+#define SCALE_LONGTEXT N_( \
+    "Divide the captured timestamps by this factor on replay. 1 reproduces " \
+    "the original timing; large values replay flat-out for benchmarking." )
+
 static int  Open( vlc_object_t * );
 static void Close ( vlc_object_t * );
+static int  OpenSout( vlc_object_t * );
+static void CloseSout( vlc_object_t * );
+static int  OpenReplay( vlc_object_t * );
+static void CloseReplay( vlc_object_t * );
+
+#define SOUT_CFG_PREFIX "sout-esdump-"
 
 vlc_module_begin ()
     set_shortname("Dump")
@@ -54,8 +69,49 @@ vlc_module_begin ()
               false )
     set_callbacks( Open, Close )
     add_shortcut( "dump" )
+
+    add_submodule ()
+    set_section( N_("Elementary stream capture"), NULL )
+    set_capability( "sout output", 0 )
+    add_shortcut( "esdump" )
+    add_savefile( SOUT_CFG_PREFIX "file", "stream-es.dump",
+                  ES_FILE_TEXT, ES_FILE_LONGTEXT )
+    set_callbacks( OpenSout, CloseSout )
+
+    add_submodule ()
+    set_section( N_("Elementary stream replay"), NULL )
+    set_capability( "demux", 10 )
+    add_shortcut( "esreplay" )
+    add_float( "esreplay-scale", 1., SCALE_TEXT, SCALE_LONGTEXT, false )
+    set_callbacks( OpenReplay, CloseReplay )
 vlc_module_end ()
 
+/*
+ * Indexed elementary stream capture format ("esdump"), written by the sout
+ * submodule below and replayed by the demux submodule. All integers are
+ * big-endian. Layout:
+ *
+ *   header   8 bytes magic
+ *   records  ADD / SEND / DEL, in capture order
+ *   index    (offset, dts) pairs of every ES_DUMP_INDEX_PERIOD'th SEND
+ *   trailer  index location, first/last dts, 8 bytes magic
+ *
+ * The trailer is only appended on clean close; without it, the capture
+ * replays fine but cannot be seeked.
+ */
+#define ES_DUMP_MAGIC "VLCESDv1"
+#define ES_DUMP_TRAILER_MAGIC "VESDIDX1"
+#define ES_DUMP_TRAILER_SIZE (8 + 4 + 8 + 8 + 8)
+
+#define ES_DUMP_REC_ADD  0 /* u16 id, u8 cat, u8 packetized, u32 codec,
+                              u32 original id, 24 bytes category-specific,
+                              u32 extra size, extra bytes */
+#define ES_DUMP_REC_SEND 1 /* u16 id, u32 flags, u64 dts, u64 pts,
+                              u64 length, u32 size, payload */
+#define ES_DUMP_REC_DEL  2 /* u16 id */
+
+#define ES_DUMP_INDEX_PERIOD 256
+
 #define DUMP_BLOCKSIZE  16384
 
 static int Demux( demux_t * );
@@ -149,3 +205,659 @@ static int Control( demux_t *p_demux, int i_query, va_list args )
 {
     return demux_vaControlHelper( p_demux->s, 0, -1, 0, 1, i_query, args );
 }
+
+/*
+ * Elementary stream capture (sout)
+ */
+
+typedef struct
+{
+    uint64_t offset;
+    vlc_tick_t dts;
+} es_dump_index_entry_t;
+
+typedef struct
+{
+    sout_access_out_t *out;
+    uint64_t i_offset;
+    uint16_t i_next_id;
+    uint64_t i_send_count;
+    vlc_tick_t i_dts_first;
+    vlc_tick_t i_dts_last;
+
+    es_dump_index_entry_t *p_index;
+    uint32_t i_index_count;
+    uint32_t i_index_size;
+} es_dump_sout_sys_t;
+
+typedef struct
+{
+    uint16_t i_id;
+} es_dump_sout_id_t;
+
+static const char *const ppsz_sout_options[] = {
+    "file", NULL
+};
+
+static int EsDumpWrite( sout_stream_t *p_stream, block_t *p_block )
+{
+    es_dump_sout_sys_t *p_sys = p_stream->p_sys;
+    size_t i_size = p_block->i_buffer;
+
+    if( sout_AccessOutWrite( p_sys->out, p_block ) != (ssize_t)i_size )
+    {
+        msg_Err( p_stream, "cannot write capture data" );
+        return VLC_EGENERIC;
+    }
+    p_sys->i_offset += i_size;
+    return VLC_SUCCESS;
+}
+
+static void *AddEs( sout_stream_t *p_stream, const es_format_t *p_fmt )
+{
+    es_dump_sout_sys_t *p_sys = p_stream->p_sys;
+
+    es_dump_sout_id_t *id = malloc( sizeof( *id ) );
+    if( unlikely( !id ) )
+        return NULL;
+    id->i_id = p_sys->i_next_id++;
+
+    size_t i_extra = p_fmt->i_extra > 0 ? (size_t)p_fmt->i_extra : 0;
+    block_t *p_rec = block_Alloc( 1 + 2 + 1 + 1 + 4 + 4 + 24 + 4 + i_extra );
+    if( unlikely( !p_rec ) )
+    {
+        free( id );
+        return NULL;
+    }
+
+    uint8_t *p = p_rec->p_buffer;
+    *p++ = ES_DUMP_REC_ADD;
+    SetWBE( p, id->i_id ); p += 2;
+    *p++ = p_fmt->i_cat;
+    *p++ = p_fmt->b_packetized;
+    SetDWBE( p, p_fmt->i_codec ); p += 4;
+    SetDWBE( p, (uint32_t)p_fmt->i_id ); p += 4;
+
+    memset( p, 0, 24 );
+    switch( p_fmt->i_cat )
+    {
+        case VIDEO_ES:
+            SetDWBE( &p[0], p_fmt->video.i_width );
+            SetDWBE( &p[4], p_fmt->video.i_height );
+            SetDWBE( &p[8], p_fmt->video.i_frame_rate );
+            SetDWBE( &p[12], p_fmt->video.i_frame_rate_base );
+            SetDWBE( &p[16], p_fmt->video.i_sar_num );
+            SetDWBE( &p[20], p_fmt->video.i_sar_den );
+            break;
+        case AUDIO_ES:
+            SetDWBE( &p[0], p_fmt->audio.i_rate );
+            SetWBE( &p[4], p_fmt->audio.i_channels );
+            SetWBE( &p[6], p_fmt->audio.i_bitspersample );
+            SetDWBE( &p[8], p_fmt->audio.i_bytes_per_frame );
+            SetDWBE( &p[12], p_fmt->audio.i_frame_length );
+            break;
+        default:
+            break;
+    }
+    p += 24;
+
+    SetDWBE( p, (uint32_t)i_extra ); p += 4;
+    memcpy( p, p_fmt->p_extra, i_extra );
+
+    msg_Dbg( p_stream, "capturing es codec=%4.4s id=%u",
+             (char*)&p_fmt->i_codec, id->i_id );
+
+    if( EsDumpWrite( p_stream, p_rec ) )
+    {
+        free( id );
+        return NULL;
+    }
+    return id;
+}
+
+static void DelEs( sout_stream_t *p_stream, void *_id )
+{
+    es_dump_sout_id_t *id = _id;
+
+    block_t *p_rec = block_Alloc( 1 + 2 );
+    if( likely( p_rec ) )
+    {
+        p_rec->p_buffer[0] = ES_DUMP_REC_DEL;
+        SetWBE( &p_rec->p_buffer[1], id->i_id );
+        EsDumpWrite( p_stream, p_rec );
+    }
+    free( id );
+}
+
+static int SendEs( sout_stream_t *p_stream, void *_id, block_t *p_buffer )
+{
+    es_dump_sout_sys_t *p_sys = p_stream->p_sys;
+    es_dump_sout_id_t *id = _id;
+
+    while( p_buffer != NULL )
+    {
+        block_t *p_next = p_buffer->p_next;
+
+        if( p_sys->i_send_count % ES_DUMP_INDEX_PERIOD == 0
+         && p_sys->i_index_count < UINT32_MAX )
+        {
+            if( p_sys->i_index_count == p_sys->i_index_size )
+            {
+                uint32_t i_size = p_sys->i_index_size ?
+                                  p_sys->i_index_size * 2 : 512;
+                es_dump_index_entry_t *p_idx =
+                    realloc( p_sys->p_index, i_size * sizeof( *p_idx ) );
+                if( p_idx != NULL )
+                {
+                    p_sys->p_index = p_idx;
+                    p_sys->i_index_size = i_size;
+                }
+            }
+            if( p_sys->i_index_count < p_sys->i_index_size )
+            {
+                p_sys->p_index[p_sys->i_index_count].offset = p_sys->i_offset;
+                p_sys->p_index[p_sys->i_index_count].dts = p_buffer->i_dts;
+                p_sys->i_index_count++;
+            }
+        }
+        p_sys->i_send_count++;
+
+        if( p_buffer->i_dts != VLC_TICK_INVALID )
+        {
+            if( p_sys->i_dts_first == VLC_TICK_INVALID )
+                p_sys->i_dts_first = p_buffer->i_dts;
+            p_sys->i_dts_last = p_buffer->i_dts;
+        }
+
+        block_t *p_rec = block_Alloc( 1 + 2 + 4 + 8 + 8 + 8 + 4
+                                      + p_buffer->i_buffer );
+        if( unlikely( !p_rec ) )
+        {
+            block_ChainRelease( p_buffer );
+            return VLC_ENOMEM;
+        }
+
+        uint8_t *p = p_rec->p_buffer;
+        *p++ = ES_DUMP_REC_SEND;
+        SetWBE( p, id->i_id ); p += 2;
+        SetDWBE( p, p_buffer->i_flags ); p += 4;
+        SetQWBE( p, (uint64_t)p_buffer->i_dts ); p += 8;
+        SetQWBE( p, (uint64_t)p_buffer->i_pts ); p += 8;
+        SetQWBE( p, (uint64_t)p_buffer->i_length ); p += 8;
+        SetDWBE( p, (uint32_t)p_buffer->i_buffer ); p += 4;
+        memcpy( p, p_buffer->p_buffer, p_buffer->i_buffer );
+
+        block_Release( p_buffer );
+        p_buffer = p_next;
+
+        if( EsDumpWrite( p_stream, p_rec ) )
+        {
+            block_ChainRelease( p_buffer );
+            return VLC_EGENERIC;
+        }
+    }
+    return VLC_SUCCESS;
+}
+
+static int OpenSout( vlc_object_t *p_this )
+{
+    sout_stream_t *p_stream = (sout_stream_t *)p_this;
+
+    config_ChainParse( p_stream, SOUT_CFG_PREFIX, ppsz_sout_options,
+                       p_stream->p_cfg );
+
+    es_dump_sout_sys_t *p_sys = calloc( 1, sizeof( *p_sys ) );
+    if( unlikely( !p_sys ) )
+        return VLC_ENOMEM;
+    p_sys->i_dts_first = VLC_TICK_INVALID;
+    p_sys->i_dts_last = VLC_TICK_INVALID;
+
+    char *path = var_GetNonEmptyString( p_stream, SOUT_CFG_PREFIX "file" );
+    if( path == NULL )
+    {
+        msg_Err( p_stream, "no capture file name given" );
+        free( p_sys );
+        return VLC_EGENERIC;
+    }
+
+    p_sys->out = sout_AccessOutNew( p_stream, "file", path );
+    free( path );
+    if( p_sys->out == NULL )
+    {
+        msg_Err( p_stream, "cannot create capture output" );
+        free( p_sys );
+        return VLC_EGENERIC;
+    }
+
+    p_stream->p_sys = p_sys;
+
+    block_t *p_hdr = block_Alloc( 8 );
+    if( unlikely( !p_hdr ) )
+    {
+        sout_AccessOutDelete( p_sys->out );
+        free( p_sys );
+        return VLC_ENOMEM;
+    }
+    memcpy( p_hdr->p_buffer, ES_DUMP_MAGIC, 8 );
+    if( EsDumpWrite( p_stream, p_hdr ) )
+    {
+        sout_AccessOutDelete( p_sys->out );
+        free( p_sys );
+        return VLC_EGENERIC;
+    }
+
+    p_stream->pf_add  = AddEs;
+    p_stream->pf_del  = DelEs;
+    p_stream->pf_send = SendEs;
+    return VLC_SUCCESS;
+}
+
+static void CloseSout( vlc_object_t *p_this )
+{
+    sout_stream_t *p_stream = (sout_stream_t *)p_this;
+    es_dump_sout_sys_t *p_sys = p_stream->p_sys;
+
+    /* append the index, then the trailer locating it */
+    uint64_t i_index_offset = p_sys->i_offset;
+    block_t *p_rec = block_Alloc( p_sys->i_index_count * 16
+                                  + ES_DUMP_TRAILER_SIZE );
+    if( likely( p_rec ) )
+    {
+        uint8_t *p = p_rec->p_buffer;
+        for( uint32_t i = 0; i < p_sys->i_index_count; i++ )
+        {
+            SetQWBE( p, p_sys->p_index[i].offset ); p += 8;
+            SetQWBE( p, (uint64_t)p_sys->p_index[i].dts ); p += 8;
+        }
+        SetQWBE( p, i_index_offset ); p += 8;
+        SetDWBE( p, p_sys->i_index_count ); p += 4;
+        SetQWBE( p, (uint64_t)p_sys->i_dts_first ); p += 8;
+        SetQWBE( p, (uint64_t)p_sys->i_dts_last ); p += 8;
+        memcpy( p, ES_DUMP_TRAILER_MAGIC, 8 );
+        EsDumpWrite( p_stream, p_rec );
+    }
+
+    sout_AccessOutDelete( p_sys->out );
+    free( p_sys->p_index );
+    free( p_sys );
+}
+
+/*
+ * Elementary stream replay (demux)
+ */
+
+typedef struct
+{
+    uint16_t i_id;
+    es_out_id_t *es;
+} es_dump_replay_es_t;
+
+typedef struct
+{
+    es_dump_replay_es_t *p_es;
+    size_t i_es_count;
+    size_t i_es_size;
+
+    float f_scale;
+    vlc_tick_t i_dts_first;
+    vlc_tick_t i_dts_last;
+    vlc_tick_t i_pcr;
+
+    es_dump_index_entry_t *p_index;
+    uint32_t i_index_count;
+    uint64_t i_data_end;
+    bool b_can_seek;
+} es_dump_replay_sys_t;
+
+static vlc_tick_t ReplayScale( es_dump_replay_sys_t *p_sys, vlc_tick_t ts )
+{
+    if( ts == VLC_TICK_INVALID || p_sys->f_scale == 1.f
+     || p_sys->i_dts_first == VLC_TICK_INVALID )
+        return ts;
+    return p_sys->i_dts_first
+         + (vlc_tick_t)((ts - p_sys->i_dts_first) / p_sys->f_scale);
+}
+
+static es_dump_replay_es_t *ReplayFindEs( es_dump_replay_sys_t *p_sys,
+                                          uint16_t i_id )
+{
+    for( size_t i = 0; i < p_sys->i_es_count; i++ )
+        if( p_sys->p_es[i].i_id == i_id )
+            return &p_sys->p_es[i];
+    return NULL;
+}
+
+static int ReplayDemux( demux_t *p_demux )
+{
+    es_dump_replay_sys_t *p_sys = p_demux->p_sys;
+
+    if( vlc_stream_Tell( p_demux->s ) >= p_sys->i_data_end )
+        return VLC_DEMUXER_EOF;
+
+    uint8_t i_type;
+    int ret = vlc_stream_Read( p_demux->s, &i_type, 1 );
+    if( ret < 1 )
+        return ret < 0 ? VLC_DEMUXER_EGENERIC : VLC_DEMUXER_EOF;
+
+    switch( i_type )
+    {
+        case ES_DUMP_REC_ADD:
+        {
+            uint8_t header[2 + 1 + 1 + 4 + 4 + 24 + 4];
+            if( vlc_stream_Read( p_demux->s, header, sizeof( header ) )
+                    < (ssize_t)sizeof( header ) )
+                return VLC_DEMUXER_EOF;
+
+            es_format_t fmt;
+            es_format_Init( &fmt, header[2], GetDWBE( &header[4] ) );
+            fmt.i_id = (int32_t)GetDWBE( &header[8] );
+            fmt.b_packetized = header[3];
+
+            const uint8_t *p = &header[12];
+            switch( fmt.i_cat )
+            {
+                case VIDEO_ES:
+                    fmt.video.i_width = GetDWBE( &p[0] );
+                    fmt.video.i_height = GetDWBE( &p[4] );
+                    fmt.video.i_visible_width = fmt.video.i_width;
+                    fmt.video.i_visible_height = fmt.video.i_height;
+                    fmt.video.i_frame_rate = GetDWBE( &p[8] );
+                    fmt.video.i_frame_rate_base = GetDWBE( &p[12] );
+                    fmt.video.i_sar_num = GetDWBE( &p[16] );
+                    fmt.video.i_sar_den = GetDWBE( &p[20] );
+                    break;
+                case AUDIO_ES:
+                    fmt.audio.i_rate = GetDWBE( &p[0] );
+                    fmt.audio.i_channels = GetWBE( &p[4] );
+                    fmt.audio.i_bitspersample = GetWBE( &p[6] );
+                    fmt.audio.i_bytes_per_frame = GetDWBE( &p[8] );
+                    fmt.audio.i_frame_length = GetDWBE( &p[12] );
+                    break;
+                default:
+                    break;
+            }
+
+            uint32_t i_extra = GetDWBE( &header[36] );
+            if( i_extra > 0 )
+            {
+                fmt.p_extra = malloc( i_extra );
+                if( unlikely( !fmt.p_extra )
+                 || vlc_stream_Read( p_demux->s, fmt.p_extra, i_extra )
+                        < (ssize_t)i_extra )
+                {
+                    es_format_Clean( &fmt );
+                    return VLC_DEMUXER_EGENERIC;
+                }
+                fmt.i_extra = i_extra;
+            }
+
+            if( p_sys->i_es_count == p_sys->i_es_size )
+            {
+                size_t i_size = p_sys->i_es_size ? p_sys->i_es_size * 2 : 8;
+                es_dump_replay_es_t *p_es = realloc( p_sys->p_es,
+                                                 i_size * sizeof( *p_es ) );
+                if( unlikely( !p_es ) )
+                {
+                    es_format_Clean( &fmt );
+                    return VLC_DEMUXER_EGENERIC;
+                }
+                p_sys->p_es = p_es;
+                p_sys->i_es_size = i_size;
+            }
+
+            uint16_t i_id = GetWBE( &header[0] );
+            es_dump_replay_es_t *entry = ReplayFindEs( p_sys, i_id );
+            if( entry == NULL )
+                entry = &p_sys->p_es[p_sys->i_es_count++];
+            entry->i_id = i_id;
+            entry->es = es_out_Add( p_demux->out, &fmt );
+            es_format_Clean( &fmt );
+            return VLC_DEMUXER_SUCCESS;
+        }
+
+        case ES_DUMP_REC_SEND:
+        {
+            uint8_t header[2 + 4 + 8 + 8 + 8 + 4];
+            if( vlc_stream_Read( p_demux->s, header, sizeof( header ) )
+                    < (ssize_t)sizeof( header ) )
+                return VLC_DEMUXER_EOF;
+
+            uint32_t i_size = GetDWBE( &header[30] );
+            block_t *p_block = vlc_stream_Block( p_demux->s, i_size );
+            if( p_block == NULL || p_block->i_buffer < i_size )
+            {
+                if( p_block )
+                    block_Release( p_block );
+                return VLC_DEMUXER_EOF;
+            }
+
+            p_block->i_flags = GetDWBE( &header[2] );
+            p_block->i_dts = ReplayScale( p_sys,
+                                    (vlc_tick_t)GetQWBE( &header[6] ) );
+            p_block->i_pts = ReplayScale( p_sys,
+                                    (vlc_tick_t)GetQWBE( &header[14] ) );
+            p_block->i_length = (vlc_tick_t)GetQWBE( &header[22] );
+            if( p_sys->f_scale != 1.f )
+                p_block->i_length /= p_sys->f_scale;
+
+            es_dump_replay_es_t *entry = ReplayFindEs( p_sys,
+                                                       GetWBE( &header[0] ) );
+            if( entry == NULL || entry->es == NULL )
+            {
+                block_Release( p_block ); /* ES unknown: stale capture? */
+                return VLC_DEMUXER_SUCCESS;
+            }
+
+            if( p_block->i_dts != VLC_TICK_INVALID )
+            {
+                p_sys->i_pcr = p_block->i_dts;
+                es_out_SetPCR( p_demux->out, p_sys->i_pcr );
+            }
+            es_out_Send( p_demux->out, entry->es, p_block );
+            return VLC_DEMUXER_SUCCESS;
+        }
+
+        case ES_DUMP_REC_DEL:
+        {
+            uint8_t header[2];
+            if( vlc_stream_Read( p_demux->s, header, sizeof( header ) )
+                    < (ssize_t)sizeof( header ) )
+                return VLC_DEMUXER_EOF;
+
+            es_dump_replay_es_t *entry = ReplayFindEs( p_sys,
+                                                       GetWBE( &header[0] ) );
+            if( entry != NULL && entry->es != NULL )
+            {
+                es_out_Del( p_demux->out, entry->es );
+                entry->es = NULL;
+            }
+            return VLC_DEMUXER_SUCCESS;
+        }
+
+        default:
+            msg_Err( p_demux, "corrupt capture (record type %u)", i_type );
+            return VLC_DEMUXER_EGENERIC;
+    }
+}
+
+static int ReplaySeek( demux_t *p_demux, vlc_tick_t i_target )
+{
+    es_dump_replay_sys_t *p_sys = p_demux->p_sys;
+
+    if( !p_sys->b_can_seek || p_sys->i_index_count == 0 )
+        return VLC_EGENERIC;
+
+    /* last index entry not past the target */
+    uint32_t low = 0, high = p_sys->i_index_count;
+    while( high - low > 1 )
+    {
+        uint32_t mid = low + (high - low) / 2;
+        if( p_sys->p_index[mid].dts != VLC_TICK_INVALID
+         && p_sys->p_index[mid].dts <= i_target )
+            low = mid;
+        else
+            high = mid;
+    }
+
+    if( vlc_stream_Seek( p_demux->s, p_sys->p_index[low].offset ) )
+        return VLC_EGENERIC;
+
+    p_sys->i_pcr = ReplayScale( p_sys, p_sys->p_index[low].dts );
+    es_out_Control( p_demux->out, ES_OUT_RESET_PCR );
+    return VLC_SUCCESS;
+}
+
+static int ReplayControl( demux_t *p_demux, int i_query, va_list args )
+{
+    es_dump_replay_sys_t *p_sys = p_demux->p_sys;
+    vlc_tick_t i_length = VLC_TICK_INVALID;
+
+    if( p_sys->i_dts_first != VLC_TICK_INVALID
+     && p_sys->i_dts_last != VLC_TICK_INVALID )
+        i_length = (p_sys->i_dts_last - p_sys->i_dts_first) / p_sys->f_scale;
+
+    switch( i_query )
+    {
+        case DEMUX_CAN_SEEK:
+            *va_arg( args, bool * ) = p_sys->b_can_seek
+                                   && p_sys->i_index_count > 0;
+            return VLC_SUCCESS;
+        case DEMUX_CAN_PAUSE:
+        case DEMUX_CAN_CONTROL_PACE:
+            *va_arg( args, bool * ) = true;
+            return VLC_SUCCESS;
+        case DEMUX_GET_PTS_DELAY:
+            *va_arg( args, vlc_tick_t * ) = DEFAULT_PTS_DELAY;
+            return VLC_SUCCESS;
+        case DEMUX_GET_LENGTH:
+            if( i_length == VLC_TICK_INVALID )
+                return VLC_EGENERIC;
+            *va_arg( args, vlc_tick_t * ) = i_length;
+            return VLC_SUCCESS;
+        case DEMUX_GET_TIME:
+            if( p_sys->i_pcr == VLC_TICK_INVALID )
+                return VLC_EGENERIC;
+            *va_arg( args, vlc_tick_t * ) =
+                p_sys->i_pcr - ReplayScale( p_sys, p_sys->i_dts_first );
+            return VLC_SUCCESS;
+        case DEMUX_GET_POSITION:
+            if( i_length == VLC_TICK_INVALID || i_length == 0
+             || p_sys->i_pcr == VLC_TICK_INVALID )
+                return VLC_EGENERIC;
+            *va_arg( args, double * ) =
+                (double)(p_sys->i_pcr
+                         - ReplayScale( p_sys, p_sys->i_dts_first ))
+                / i_length;
+            return VLC_SUCCESS;
+        case DEMUX_SET_TIME:
+            return ReplaySeek( p_demux, p_sys->i_dts_first
+                               + va_arg( args, vlc_tick_t )
+                                 * (vlc_tick_t)p_sys->f_scale );
+        case DEMUX_SET_POSITION:
+        {
+            if( p_sys->i_dts_first == VLC_TICK_INVALID
+             || p_sys->i_dts_last == VLC_TICK_INVALID )
+                return VLC_EGENERIC;
+            double f = va_arg( args, double );
+            return ReplaySeek( p_demux, p_sys->i_dts_first
+                    + (vlc_tick_t)(f * (p_sys->i_dts_last
+                                        - p_sys->i_dts_first)) );
+        }
+        default:
+            return VLC_EGENERIC;
+    }
+}
+
+static int OpenReplay( vlc_object_t *p_this )
+{
+    demux_t *p_demux = (demux_t *)p_this;
+    const uint8_t *p_peek;
+
+    if( vlc_stream_Peek( p_demux->s, &p_peek, 8 ) < 8
+     || memcmp( p_peek, ES_DUMP_MAGIC, 8 ) )
+        return VLC_EGENERIC;
+
+    es_dump_replay_sys_t *p_sys = calloc( 1, sizeof( *p_sys ) );
+    if( unlikely( !p_sys ) )
+        return VLC_ENOMEM;
+
+    p_sys->f_scale = var_InheritFloat( p_demux, "esreplay-scale" );
+    if( p_sys->f_scale <= 0.f )
+        p_sys->f_scale = 1.f;
+    p_sys->i_dts_first = VLC_TICK_INVALID;
+    p_sys->i_dts_last = VLC_TICK_INVALID;
+    p_sys->i_pcr = VLC_TICK_INVALID;
+    p_sys->i_data_end = UINT64_MAX;
+
+    if( vlc_stream_Read( p_demux->s, NULL, 8 ) < 8 )
+    {
+        free( p_sys );
+        return VLC_EGENERIC;
+    }
+
+    /* load the index from the trailer, when present and reachable */
+    bool b_seekable = false;
+    uint64_t i_size;
+    vlc_stream_Control( p_demux->s, STREAM_CAN_SEEK, &b_seekable );
+    if( b_seekable && vlc_stream_GetSize( p_demux->s, &i_size ) == 0
+     && i_size > 8 + ES_DUMP_TRAILER_SIZE
+     && vlc_stream_Seek( p_demux->s, i_size - ES_DUMP_TRAILER_SIZE ) == 0 )
+    {
+        uint8_t trailer[ES_DUMP_TRAILER_SIZE];
+        if( vlc_stream_Read( p_demux->s, trailer, sizeof( trailer ) )
+                == (ssize_t)sizeof( trailer )
+         && !memcmp( &trailer[28], ES_DUMP_TRAILER_MAGIC, 8 ) )
+        {
+            uint64_t i_index_offset = GetQWBE( &trailer[0] );
+            uint32_t i_count = GetDWBE( &trailer[8] );
+            p_sys->i_dts_first = (vlc_tick_t)GetQWBE( &trailer[12] );
+            p_sys->i_dts_last = (vlc_tick_t)GetQWBE( &trailer[20] );
+            p_sys->i_data_end = i_index_offset;
+
+            if( i_count > 0 && i_index_offset < i_size
+             && vlc_stream_Seek( p_demux->s, i_index_offset ) == 0 )
+            {
+                p_sys->p_index = vlc_alloc( i_count, sizeof( *p_sys->p_index ) );
+                if( p_sys->p_index != NULL )
+                {
+                    for( uint32_t i = 0; i < i_count; i++ )
+                    {
+                        uint8_t entry[16];
+                        if( vlc_stream_Read( p_demux->s, entry, 16 ) < 16 )
+                            break;
+                        p_sys->p_index[i].offset = GetQWBE( &entry[0] );
+                        p_sys->p_index[i].dts =
+                                (vlc_tick_t)GetQWBE( &entry[8] );
+                        p_sys->i_index_count++;
+                    }
+                }
+            }
+        }
+
+        if( vlc_stream_Seek( p_demux->s, 8 ) )
+        {
+            free( p_sys->p_index );
+            free( p_sys );
+            return VLC_EGENERIC;
+        }
+        p_sys->b_can_seek = true;
+    }
+
+    if( p_sys->f_scale != 1.f )
+        msg_Dbg( p_demux, "replaying with time scale %f", p_sys->f_scale );
+
+    p_demux->p_sys = p_sys;
+    p_demux->pf_demux = ReplayDemux;
+    p_demux->pf_control = ReplayControl;
+    return VLC_SUCCESS;
+}
+
+static void CloseReplay( vlc_object_t *p_this )
+{
+    demux_t *p_demux = (demux_t *)p_this;
+    es_dump_replay_sys_t *p_sys = p_demux->p_sys;
+
+    free( p_sys->p_es );
+    free( p_sys->p_index );
+    free( p_sys );
+}
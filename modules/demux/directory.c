@@ -33,17 +33,24 @@ static int Demux( demux_t *p_demux )
 {
     input_item_node_t *p_node = input_item_node_Create( p_demux->p_input_item );
 
-    if( vlc_stream_ReadDir( p_demux->s, p_node ) )
+    if( vlc_stream_ReadDirPartial( p_demux->s, p_node ) )
     {
         msg_Warn( p_demux, "unable to read directory" );
         input_item_node_Delete( p_node );
-        return VLC_EGENERIC;
+        return VLC_DEMUXER_EGENERIC;
     }
 
-    if (es_out_Control(p_demux->out, ES_OUT_POST_SUBNODE, p_node))
-        input_item_node_Delete(p_node);
+    /* An incremental directory delivers its entries in batches: post each
+     * batch as it comes so they reach the playlist without waiting for the
+     * end of the listing, and pump again until a batch comes back empty. */
+    bool b_eof = !p_demux->s->b_readdir_incremental
+              || p_node->i_children <= 0;
 
-    return VLC_SUCCESS;
+    if( p_node->i_children <= 0
+     || es_out_Control( p_demux->out, ES_OUT_POST_SUBNODE, p_node ) )
+        input_item_node_Delete( p_node );
+
+    return b_eof ? VLC_DEMUXER_EOF : VLC_DEMUXER_SUCCESS;
 }
 
 static int Control(demux_t *demux, int query, va_list args)
@@ -211,6 +211,7 @@ bool demux_sys_t::PreloadLinked()
                     else
                     {
                         /* Check in tags if the edition has a name */
+                        opened_segments[0]->EnsureTagsLoaded();
 
                         /* We use only the tags of the first segment as it contains the edition */
                         matroska_segment_c::tags_t const& tags = opened_segments[0]->tags;
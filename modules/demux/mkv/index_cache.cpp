@@ -0,0 +1,311 @@
+/*****************************************************************************
+ * index_cache.cpp : matroska demuxer, on-disk seek index cache
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "index_cache.hpp"
+#include "matroska_segment.hpp"
+#include "demux.hpp"
+
+#include <vlc_fs.h>
+#include <vlc_hash.h>
+#include <vlc_block.h>
+
+#include <sys/stat.h>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+namespace mkv {
+
+namespace {
+
+/* Bumping the version invalidates every existing cache file. */
+const char INDEX_CACHE_MAGIC[8] = { 'V','M','K','X','0','0','0','1' };
+
+/* Builds "<path>|<size>|<mtime>|<segment position>", the identity the cache
+ * entry is keyed by, or NULL when the media is not a plain local file. */
+char *build_key( matroska_segment_c &seg )
+{
+    demux_t *demuxer = &seg.sys.demuxer;
+    const char *filepath = demuxer->s->psz_filepath;
+    struct stat st;
+    char *key;
+
+    if( filepath == NULL || vlc_stat( filepath, &st ) || !S_ISREG( st.st_mode ) )
+        return NULL;
+
+    if( asprintf( &key, "%s|%" PRIu64 "|%" PRId64 "|%" PRIu64, filepath,
+                  (uint64_t)st.st_size, (int64_t)st.st_mtime,
+                  (uint64_t)seg.segment->GetElementPosition() ) < 0 )
+        return NULL;
+    return key;
+}
+
+/* Cache file path: <cachedir>/mkvidx/<md5 of key>, creating the directory. */
+char *build_path( matroska_segment_c &seg, const char *key )
+{
+    char *cachedir = config_GetUserDir( VLC_CACHE_DIR );
+    if( cachedir == NULL )
+        return NULL;
+
+    vlc_hash_md5_t md5;
+    uint8_t digest[VLC_HASH_MD5_DIGEST_SIZE];
+    char hex[VLC_HASH_MD5_DIGEST_HEX_SIZE];
+
+    vlc_hash_md5_Init( &md5 );
+    vlc_hash_md5_Update( &md5, key, strlen( key ) );
+    vlc_hash_md5_Finish( &md5, digest, sizeof( digest ) );
+    for( size_t i = 0; i < sizeof( digest ); i++ )
+        sprintf( hex + 2 * i, "%02x", digest[i] );
+
+    char *dir, *path = NULL;
+    if( asprintf( &dir, "%s" DIR_SEP "mkvidx", cachedir ) < 0 )
+        dir = NULL;
+    free( cachedir );
+    if( dir == NULL )
+        return NULL;
+
+    vlc_mkdir( dir, 0700 ); /* best effort, open will fail anyway */
+    if( asprintf( &path, "%s" DIR_SEP "%s", dir, hex ) < 0 )
+        path = NULL;
+    free( dir );
+    (void) seg;
+    return path;
+}
+
+struct index_reader
+{
+    const uint8_t *cursor;
+    const uint8_t *end;
+
+    bool read( void *dst, size_t size )
+    {
+        if( (size_t)( end - cursor ) < size )
+            return false;
+        memcpy( dst, cursor, size );
+        cursor += size;
+        return true;
+    }
+
+    template <typename T> bool get( T &value )
+    {
+        return read( &value, sizeof( value ) );
+    }
+};
+
+template <typename T> void put( FILE *stream, const T &value )
+{
+    fwrite( &value, sizeof( value ), 1, stream );
+}
+
+} // anonymous namespace
+
+bool IndexCacheLoad( matroska_segment_c &seg )
+{
+    demux_t *demuxer = &seg.sys.demuxer;
+    char *key = build_key( seg );
+    if( key == NULL )
+        return false;
+
+    char *path = build_path( seg, key );
+    if( path == NULL )
+    {
+        free( key );
+        return false;
+    }
+
+    /* The cache file is mapped, not read, so loading is one page fault away
+     * from free for entries evicted by earlier opens. */
+    block_t *map = block_FilePath( path, false );
+    free( path );
+
+    bool ok = false;
+    uint64_t count, tracks;
+    SegmentSeeker loaded;
+    index_reader r;
+    uint64_t key_length;
+
+    if( map == NULL )
+        goto out;
+
+    r.cursor = map->p_buffer;
+    r.end = map->p_buffer + map->i_buffer;
+
+    if( (size_t)( r.end - r.cursor ) < sizeof( INDEX_CACHE_MAGIC )
+     || memcmp( r.cursor, INDEX_CACHE_MAGIC, sizeof( INDEX_CACHE_MAGIC ) ) )
+        goto out;
+    r.cursor += sizeof( INDEX_CACHE_MAGIC );
+
+    if( !r.get( key_length ) || key_length != strlen( key )
+     || (size_t)( r.end - r.cursor ) < key_length
+     || memcmp( r.cursor, key, key_length ) )
+        goto out; /* hash collision or stale identity */
+    r.cursor += key_length;
+
+    if( !r.get( count ) )
+        goto out;
+    loaded._cluster_positions.reserve( count );
+    for( uint64_t i = 0; i < count; i++ )
+    {
+        SegmentSeeker::fptr_t pos;
+        if( !r.get( pos ) )
+            goto out;
+        loaded._cluster_positions.push_back( pos );
+    }
+
+    if( !r.get( count ) )
+        goto out;
+    for( uint64_t i = 0; i < count; i++ )
+    {
+        SegmentSeeker::Cluster cluster;
+        if( !r.get( cluster.fpos ) || !r.get( cluster.pts )
+         || !r.get( cluster.duration ) || !r.get( cluster.size ) )
+            goto out;
+        loaded._clusters[cluster.pts] = cluster;
+    }
+
+    if( !r.get( tracks ) )
+        goto out;
+    for( uint64_t t = 0; t < tracks; t++ )
+    {
+        uint64_t track_id;
+        if( !r.get( track_id ) || !r.get( count ) )
+            goto out;
+
+        SegmentSeeker::seekpoints_t &seekpoints =
+            loaded._tracks_seekpoints[ (SegmentSeeker::track_id_t) track_id ];
+        seekpoints.reserve( count );
+        for( uint64_t i = 0; i < count; i++ )
+        {
+            SegmentSeeker::Seekpoint sp;
+            int32_t trust;
+            if( !r.get( sp.fpos ) || !r.get( sp.pts ) || !r.get( trust ) )
+                goto out;
+            sp.trust_level = (SegmentSeeker::Seekpoint::TrustLevel) trust;
+            seekpoints.push_back( sp );
+        }
+    }
+
+    if( !r.get( count ) )
+        goto out;
+    for( uint64_t i = 0; i < count; i++ )
+    {
+        SegmentSeeker::fptr_t start, end;
+        if( !r.get( start ) || !r.get( end ) )
+            goto out;
+        seg._seeker.mark_range_as_searched( SegmentSeeker::Range( start, end ) );
+    }
+
+    seg._seeker._cluster_positions = std::move( loaded._cluster_positions );
+    seg._seeker._clusters = std::move( loaded._clusters );
+    seg._seeker._tracks_seekpoints = std::move( loaded._tracks_seekpoints );
+
+    msg_Dbg( demuxer, "loaded cached seek index (%zu tracks, %zu clusters)",
+             seg._seeker._tracks_seekpoints.size(),
+             seg._seeker._clusters.size() );
+    ok = true;
+
+out:
+    if( map != NULL )
+        block_Release( map );
+    free( key );
+    return ok;
+}
+
+void IndexCacheSave( matroska_segment_c &seg )
+{
+    demux_t *demuxer = &seg.sys.demuxer;
+    char *key = build_key( seg );
+    if( key == NULL )
+        return;
+
+    char *path = build_path( seg, key );
+    if( path == NULL )
+    {
+        free( key );
+        return;
+    }
+
+    char *tmp;
+    if( asprintf( &tmp, "%s.tmp", path ) < 0 )
+        tmp = NULL;
+
+    FILE *stream = tmp ? vlc_fopen( tmp, "wb" ) : NULL;
+    if( stream == NULL )
+    {
+        msg_Dbg( demuxer, "cannot write seek index cache" );
+        free( tmp );
+        free( path );
+        free( key );
+        return;
+    }
+
+    const SegmentSeeker &seeker = seg._seeker;
+
+    fwrite( INDEX_CACHE_MAGIC, sizeof( INDEX_CACHE_MAGIC ), 1, stream );
+    put( stream, (uint64_t) strlen( key ) );
+    fwrite( key, strlen( key ), 1, stream );
+
+    put( stream, (uint64_t) seeker._cluster_positions.size() );
+    for( SegmentSeeker::fptr_t pos : seeker._cluster_positions )
+        put( stream, pos );
+
+    put( stream, (uint64_t) seeker._clusters.size() );
+    for( const auto &entry : seeker._clusters )
+    {
+        put( stream, entry.second.fpos );
+        put( stream, entry.second.pts );
+        put( stream, entry.second.duration );
+        put( stream, entry.second.size );
+    }
+
+    put( stream, (uint64_t) seeker._tracks_seekpoints.size() );
+    for( const auto &track : seeker._tracks_seekpoints )
+    {
+        put( stream, (uint64_t) track.first );
+        put( stream, (uint64_t) track.second.size() );
+        for( const SegmentSeeker::Seekpoint &sp : track.second )
+        {
+            put( stream, sp.fpos );
+            put( stream, sp.pts );
+            put( stream, (int32_t) sp.trust_level );
+        }
+    }
+
+    put( stream, (uint64_t) seeker._ranges_searched.size() );
+    for( const SegmentSeeker::Range &range : seeker._ranges_searched )
+    {
+        put( stream, range.start );
+        put( stream, range.end );
+    }
+
+    bool ok = !ferror( stream );
+    fclose( stream );
+
+    if( ok && vlc_rename( tmp, path ) == 0 )
+        msg_Dbg( demuxer, "saved seek index cache" );
+    else
+        vlc_unlink( tmp );
+
+    free( tmp );
+    free( path );
+    free( key );
+}
+
+} // namespace
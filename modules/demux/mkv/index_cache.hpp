@@ -0,0 +1,46 @@
+/*****************************************************************************
+ * index_cache.hpp : matroska demuxer, on-disk seek index cache
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef MKV_INDEX_CACHE_HPP_
+#define MKV_INDEX_CACHE_HPP_
+
+#include "mkv.hpp"
+
+namespace mkv {
+
+class matroska_segment_c;
+
+/* Sidecar binary cache for the SegmentSeeker state (cue seekpoints, cluster
+ * index and searched ranges). The cache lives in the user cache directory,
+ * keyed by the media file identity (path, size, mtime) and the segment
+ * position, so stale entries are simply never matched. Loading it on reopen
+ * spares re-reading the clusters of large files to rebuild the seek index. */
+
+/* Tries to restore the seeker state of a previously parsed segment.
+ * Returns true if an up-to-date index was found and loaded. */
+bool IndexCacheLoad( matroska_segment_c & );
+
+/* Persists the current seeker state for the next open. Failures are only
+ * logged: the cache is strictly an optimization. */
+void IndexCacheSave( matroska_segment_c & );
+
+} // namespace
+
+#endif /* include-guard */
@@ -24,6 +24,7 @@
 #include "matroska_segment.hpp"
 #include "chapters.hpp"
 #include "demux.hpp"
+#include "index_cache.hpp"
 #include "util.hpp"
 #include "Ebml_parser.hpp"
 #include "Ebml_dispatcher.hpp"
@@ -46,6 +47,8 @@ matroska_segment_c::matroska_segment_c( demux_sys_t & demuxer, EbmlStream & estr
     ,i_info_position(-1)
     ,i_chapters_position(-1)
     ,i_attachments_position(-1)
+    ,i_attachments_deferred(-1)
+    ,i_tags_deferred(-1)
     ,cluster(NULL)
     ,i_block_pos(0)
     ,p_segment_uid(NULL)
@@ -61,12 +64,18 @@ matroska_segment_c::matroska_segment_c( demux_sys_t & demuxer, EbmlStream & estr
     ,sys(demuxer)
     ,ep( EbmlParser(&estream, p_seg, &demuxer.demuxer ))
     ,b_preloaded(false)
+    ,b_index_from_cache(false)
     ,b_ref_external_segments(false)
 {
 }
 
 matroska_segment_c::~matroska_segment_c()
 {
+    /* Keep the seek knowledge gathered during this session for reopens. */
+    if( !b_index_from_cache &&
+        ( !_seeker._tracks_seekpoints.empty() || !_seeker._clusters.empty() ) )
+        IndexCacheSave( *this );
+
     free( psz_writing_application );
     free( psz_muxing_application );
     free( psz_segment_filename );
@@ -648,14 +657,11 @@ bool matroska_segment_c::Preload( )
             /* stop pre-parsing the stream */
             break;
         }
-        else if( MKV_CHECKED_PTR_DECL ( ka_ptr, KaxAttachments, el ) )
+        else if( MKV_IS_ID ( el, KaxAttachments ) )
         {
-            msg_Dbg( &sys.demuxer, "|   + Attachments" );
-            if( i_attachments_position < 0 )
-            {
-                ParseAttachments( ka_ptr );
-                i_attachments_position = el->GetElementPosition();
-            }
+            msg_Dbg( &sys.demuxer, "|   + Attachments (deferred)" );
+            if( i_attachments_position < 0 && i_attachments_deferred < 0 )
+                i_attachments_deferred = el->GetElementPosition();
         }
         else if( MKV_CHECKED_PTR_DECL ( kc_ptr, KaxChapters, el ) )
         {
@@ -666,13 +672,11 @@ bool matroska_segment_c::Preload( )
                 i_chapters_position = el->GetElementPosition();
             }
         }
-        else if( MKV_CHECKED_PTR_DECL ( kt_ptr, KaxTags, el ) )
+        else if( MKV_IS_ID ( el, KaxTags ) )
         {
-            msg_Dbg( &sys.demuxer, "|   + Tags" );
-            if(tags.empty ())
-            {
-                LoadTags( kt_ptr );
-            }
+            msg_Dbg( &sys.demuxer, "|   + Tags (deferred)" );
+            if( tags.empty() && i_tags_deferred < 0 )
+                i_tags_deferred = el->GetElementPosition();
         }
         else if( MKV_IS_ID ( el, EbmlVoid ) )
             msg_Dbg( &sys.demuxer, "|   + Void" );
@@ -682,6 +686,15 @@ bool matroska_segment_c::Preload( )
 
     ComputeTrackPriority();
 
+    /* If no cues were found in line, a cached index from a previous session
+     * avoids re-reading the clusters to rebuild the seek tables. */
+    if( !b_cues && IndexCacheLoad( *this ) )
+    {
+        b_index_from_cache = true;
+        if( !_seeker._tracks_seekpoints.empty() )
+            b_cues = true;
+    }
+
     b_preloaded = true;
 
     if( cluster )
@@ -789,6 +802,29 @@ bool matroska_segment_c::LoadSeekHeadItem( const EbmlCallbacks & ClassInfos, int
     return true;
 }
 
+/* Attachments and tags are only materialized when something actually asks
+ * for them: Preload() and ParseSeekHead() record their position and the
+ * actual parsing (and its I/O) happens here on the first query. */
+void matroska_segment_c::EnsureAttachmentsLoaded()
+{
+    if( i_attachments_deferred < 0 )
+        return;
+
+    int64_t i_pos = i_attachments_deferred;
+    i_attachments_deferred = -1;
+    LoadSeekHeadItem( EBML_INFO(KaxAttachments), i_pos );
+}
+
+void matroska_segment_c::EnsureTagsLoaded()
+{
+    if( i_tags_deferred < 0 )
+        return;
+
+    int64_t i_pos = i_tags_deferred;
+    i_tags_deferred = -1;
+    LoadSeekHeadItem( EBML_INFO(KaxTags), i_pos );
+}
+
 bool matroska_segment_c::Seek( demux_t &demuxer, vlc_tick_t i_absolute_mk_date, vlc_tick_t i_mk_time_offset, bool b_accurate )
 {
     SegmentSeeker::tracks_seekpoint_t seekpoints;
@@ -108,6 +108,12 @@ public:
     int64_t                 i_chapters_position;
     int64_t                 i_attachments_position;
 
+    /* Positions of seekhead items whose parsing is deferred until the
+     * first query: attachments and tags can be large and are not needed
+     * to start playback */
+    int64_t                 i_attachments_deferred;
+    int64_t                 i_tags_deferred;
+
     KaxCluster              *cluster;
     uint64                  i_block_pos;
     KaxSegmentUID           *p_segment_uid;
@@ -136,11 +142,14 @@ public:
     demux_sys_t                    & sys;
     EbmlParser                     ep;
     bool                           b_preloaded;
+    bool                           b_index_from_cache;
     bool                           b_ref_external_segments;
 
     bool Preload();
     bool PreloadFamily( const matroska_segment_c & segment );
     bool PreloadClusters( uint64 i_cluster_position );
+    void EnsureAttachmentsLoaded();
+    void EnsureTagsLoaded();
     void InformationCreate();
 
     bool Seek( demux_t &, vlc_tick_t i_mk_date, vlc_tick_t i_mk_time_offset, bool b_accurate );
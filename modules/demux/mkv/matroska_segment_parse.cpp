@@ -166,8 +166,9 @@ void matroska_segment_c::ParseSeekHead( KaxSeekHead *seekhead )
                 }
                 else if( id == EBML_ID(KaxTags) )
                 {
-                    msg_Dbg( &sys.demuxer, "|   - tags at %" PRId64, i_pos );
-                    LoadSeekHeadItem( EBML_INFO(KaxTags), i_pos );
+                    msg_Dbg( &sys.demuxer, "|   - tags at %" PRId64 " (deferred)", i_pos );
+                    if( tags.empty() && i_tags_deferred < 0 )
+                        i_tags_deferred = i_pos;
                 }
                 else if( id == EBML_ID(KaxSeekHead) )
                 {
@@ -181,8 +182,9 @@ void matroska_segment_c::ParseSeekHead( KaxSeekHead *seekhead )
                 }
                 else if( id == EBML_ID(KaxAttachments) )
                 {
-                    msg_Dbg( &sys.demuxer, "|   - attachments at %" PRId64, i_pos );
-                    LoadSeekHeadItem( EBML_INFO(KaxAttachments), i_pos );
+                    msg_Dbg( &sys.demuxer, "|   - attachments at %" PRId64 " (deferred)", i_pos );
+                    if( i_attachments_position < 0 && i_attachments_deferred < 0 )
+                        i_attachments_deferred = i_pos;
                 }
 #ifdef MKV_DEBUG
                 else if( id != EBML_ID(KaxCluster) && id != EBML_ID(EbmlVoid) &&
@@ -310,6 +310,9 @@ static int Control( demux_t *p_demux, int i_query, va_list args )
             ppp_attach = va_arg( args, input_attachment_t*** );
             pi_int = va_arg( args, int * );
 
+            for( size_t i = 0; i < p_sys->opened_segments.size(); i++ )
+                p_sys->opened_segments[i]->EnsureAttachmentsLoaded();
+
             if( p_sys->stored_attachments.size() <= 0 )
                 return VLC_EGENERIC;
 
@@ -332,6 +335,13 @@ static int Control( demux_t *p_demux, int i_query, va_list args )
             return VLC_SUCCESS;
 
         case DEMUX_GET_META:
+            /* Deferred tags and attachments (for the art URL) feed the
+             * meta: materialize them now */
+            for( size_t i = 0; i < p_sys->opened_segments.size(); i++ )
+            {
+                p_sys->opened_segments[i]->EnsureTagsLoaded();
+                p_sys->opened_segments[i]->EnsureAttachmentsLoaded();
+            }
             p_meta = va_arg( args, vlc_meta_t* );
             vlc_meta_Merge( p_meta, p_sys->meta );
             return VLC_SUCCESS;
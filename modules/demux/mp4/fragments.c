@@ -23,6 +23,12 @@
 
 #include "fragments.h"
 #include <limits.h>
+#include <sys/stat.h>
+
+#include <vlc_demux.h>
+#include <vlc_fs.h>
+#include <vlc_hash.h>
+#include <vlc_block.h>
 
 void MP4_Fragments_Index_Delete( mp4_fragments_index_t *p_index )
 {
@@ -55,6 +61,168 @@ mp4_fragments_index_t * MP4_Fragments_Index_New( unsigned i_tracks, unsigned i_n
     return p_index;
 }
 
+static const char MP4_INDEX_CACHE_MAGIC[8] = { 'V','M','P','4','I','D','X','1' };
+
+/* "<path>|<size>|<mtime>", or NULL when the media is not a local file */
+static char * MP4_Index_BuildKey( demux_t *p_demux )
+{
+    const char *psz_filepath = p_demux->s->psz_filepath;
+    struct stat st;
+    char *psz_key;
+
+    if( psz_filepath == NULL || vlc_stat( psz_filepath, &st ) ||
+        !S_ISREG( st.st_mode ) )
+        return NULL;
+
+    if( asprintf( &psz_key, "%s|%"PRIu64"|%"PRId64, psz_filepath,
+                  (uint64_t) st.st_size, (int64_t) st.st_mtime ) < 0 )
+        return NULL;
+    return psz_key;
+}
+
+/* <cachedir>/mp4idx/<md5 of key>, creating the directory on the way */
+static char * MP4_Index_BuildPath( const char *psz_key )
+{
+    char *psz_cachedir = config_GetUserDir( VLC_CACHE_DIR );
+    if( psz_cachedir == NULL )
+        return NULL;
+
+    vlc_hash_md5_t md5;
+    uint8_t digest[VLC_HASH_MD5_DIGEST_SIZE];
+    char hex[VLC_HASH_MD5_DIGEST_HEX_SIZE];
+
+    vlc_hash_md5_Init( &md5 );
+    vlc_hash_md5_Update( &md5, psz_key, strlen( psz_key ) );
+    vlc_hash_md5_Finish( &md5, digest, sizeof(digest) );
+    for( size_t i=0; i<sizeof(digest); i++ )
+        sprintf( &hex[2 * i], "%02x", digest[i] );
+
+    char *psz_dir, *psz_path = NULL;
+    if( asprintf( &psz_dir, "%s"DIR_SEP"mp4idx", psz_cachedir ) < 0 )
+        psz_dir = NULL;
+    free( psz_cachedir );
+    if( psz_dir == NULL )
+        return NULL;
+
+    vlc_mkdir( psz_dir, 0700 ); /* best effort */
+    if( asprintf( &psz_path, "%s"DIR_SEP"%s", psz_dir, hex ) < 0 )
+        psz_path = NULL;
+    free( psz_dir );
+    return psz_path;
+}
+
+mp4_fragments_index_t * MP4_Fragments_Index_Restore( demux_t *p_demux,
+                                                     unsigned i_tracks )
+{
+    char *psz_key = MP4_Index_BuildKey( p_demux );
+    if( psz_key == NULL )
+        return NULL;
+
+    char *psz_path = MP4_Index_BuildPath( psz_key );
+    if( psz_path == NULL )
+    {
+        free( psz_key );
+        return NULL;
+    }
+
+    block_t *p_map = block_FilePath( psz_path, false );
+    free( psz_path );
+
+    mp4_fragments_index_t *p_index = NULL;
+    const size_t i_keylen = strlen( psz_key );
+
+    if( p_map != NULL )
+    {
+        const uint8_t *p = p_map->p_buffer;
+        size_t i_left = p_map->i_buffer;
+        uint32_t i_cached_tracks, i_entries;
+        int64_t i_last_time;
+
+        const size_t i_header = sizeof(MP4_INDEX_CACHE_MAGIC) + i_keylen
+                              + sizeof(i_cached_tracks) + sizeof(i_entries)
+                              + sizeof(i_last_time);
+        if( i_left < i_header ||
+            memcmp( p, MP4_INDEX_CACHE_MAGIC, sizeof(MP4_INDEX_CACHE_MAGIC) ) ||
+            memcmp( p + sizeof(MP4_INDEX_CACHE_MAGIC), psz_key, i_keylen ) )
+            goto end;
+        p += sizeof(MP4_INDEX_CACHE_MAGIC) + i_keylen;
+        i_left -= i_header;
+
+        memcpy( &i_cached_tracks, p, sizeof(i_cached_tracks) );
+        p += sizeof(i_cached_tracks);
+        memcpy( &i_entries, p, sizeof(i_entries) );
+        p += sizeof(i_entries);
+        memcpy( &i_last_time, p, sizeof(i_last_time) );
+        p += sizeof(i_last_time);
+
+        if( i_cached_tracks != i_tracks || i_entries == 0 ||
+            i_left != i_entries * ( sizeof(uint64_t)
+                                  + (size_t)i_tracks * sizeof(stime_t) ) )
+            goto end;
+
+        p_index = MP4_Fragments_Index_New( i_tracks, i_entries );
+        if( p_index == NULL )
+            goto end;
+
+        memcpy( p_index->pi_pos, p, i_entries * sizeof(uint64_t) );
+        p += i_entries * sizeof(uint64_t);
+        memcpy( p_index->p_times, p,
+                (size_t)i_entries * i_tracks * sizeof(stime_t) );
+        p_index->i_last_time = i_last_time;
+
+        msg_Dbg( p_demux, "restored cached fragments index (%u entries)",
+                 i_entries );
+    }
+end:
+    if( p_map != NULL )
+        block_Release( p_map );
+    free( psz_key );
+    return p_index;
+}
+
+void MP4_Fragments_Index_Persist( demux_t *p_demux,
+                                  const mp4_fragments_index_t *p_index )
+{
+    char *psz_key = MP4_Index_BuildKey( p_demux );
+    if( psz_key == NULL )
+        return;
+
+    char *psz_path = MP4_Index_BuildPath( psz_key );
+    char *psz_tmp = NULL;
+    if( psz_path == NULL || asprintf( &psz_tmp, "%s.tmp", psz_path ) < 0 )
+        psz_tmp = NULL;
+
+    FILE *p_stream = psz_tmp ? vlc_fopen( psz_tmp, "wb" ) : NULL;
+    if( p_stream != NULL )
+    {
+        const uint32_t i_tracks = p_index->i_tracks;
+        const uint32_t i_entries = p_index->i_entries;
+        const int64_t i_last_time = p_index->i_last_time;
+
+        fwrite( MP4_INDEX_CACHE_MAGIC, sizeof(MP4_INDEX_CACHE_MAGIC), 1, p_stream );
+        fwrite( psz_key, strlen( psz_key ), 1, p_stream );
+        fwrite( &i_tracks, sizeof(i_tracks), 1, p_stream );
+        fwrite( &i_entries, sizeof(i_entries), 1, p_stream );
+        fwrite( &i_last_time, sizeof(i_last_time), 1, p_stream );
+        fwrite( p_index->pi_pos, sizeof(uint64_t), i_entries, p_stream );
+        fwrite( p_index->p_times, sizeof(stime_t),
+                (size_t)i_entries * i_tracks, p_stream );
+
+        bool b_ok = !ferror( p_stream );
+        fclose( p_stream );
+
+        if( b_ok && vlc_rename( psz_tmp, psz_path ) == 0 )
+            msg_Dbg( p_demux, "persisted fragments index (%u entries)",
+                     i_entries );
+        else
+            vlc_unlink( psz_tmp );
+    }
+
+    free( psz_tmp );
+    free( psz_path );
+    free( psz_key );
+}
+
 stime_t MP4_Fragment_Index_GetTrackStartTime( mp4_fragments_index_t *p_index,
                                               unsigned i_track_index, uint64_t i_moof_pos )
 {
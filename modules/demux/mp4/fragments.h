@@ -35,6 +35,12 @@ typedef struct mp4_fragments_index_t
 void MP4_Fragments_Index_Delete( mp4_fragments_index_t *p_index );
 mp4_fragments_index_t * MP4_Fragments_Index_New( unsigned i_tracks, unsigned i_num );
 
+/* On-disk persistence of the fragments index between opens. The cache entry
+ * is keyed by file path, size and mtime, so stale entries never match.
+ * Restoring the index on reopen avoids walking every moof of the file. */
+mp4_fragments_index_t * MP4_Fragments_Index_Restore( demux_t *, unsigned i_tracks );
+void MP4_Fragments_Index_Persist( demux_t *, const mp4_fragments_index_t * );
+
 stime_t MP4_Fragment_Index_GetTrackStartTime( mp4_fragments_index_t *p_index,
                                               unsigned i_track_index, uint64_t i_moof_pos );
 stime_t MP4_Fragment_Index_GetTrackDuration( mp4_fragments_index_t *p_index, unsigned i_track_index );
@@ -30,6 +30,7 @@
 #include <vlc_image.h>
 #include <assert.h>
 #include <limits.h>
+#include <stdatomic.h>
 
 #include "libmp4.h"
 #include "heif.h"
@@ -522,12 +523,34 @@ static int ReadDerivationData( demux_t *p_demux, vlc_fourcc_t type,
     return i_ret;
 }
 
-static int LoadGridImage( demux_t *p_demux,
-                          image_handler_t *handler,
-                          uint32_t i_pic_item_id,
-                               uint8_t *p_buffer,
-                               unsigned tile, unsigned gridcols,
-                               unsigned imagewidth, unsigned imageheight )
+/* One prepared grid tile: compressed sample plus its decode format, read
+ * upfront on the demux thread since stream access cannot be shared. */
+struct grid_tile_job
+{
+    block_t    *p_sample;
+    es_format_t fmt;
+    unsigned    tile;
+};
+
+struct grid_decode_ctx
+{
+    struct grid_tile_job *p_jobs;
+    size_t      i_jobs;
+    atomic_uint next;
+    uint8_t    *p_buffer;
+    unsigned    gridcols;
+    unsigned    imagewidth, imageheight;
+};
+
+struct grid_worker
+{
+    struct grid_decode_ctx *ctx;
+    image_handler_t        *handler;
+    vlc_thread_t            thread;
+};
+
+static int PrepareGridTile( demux_t *p_demux, uint32_t i_pic_item_id,
+                            struct grid_tile_job *p_job, unsigned tile )
 {
     struct heif_private_t *p_sys = (void *) p_demux->p_sys;
 
@@ -537,39 +560,51 @@ static int LoadGridImage( demux_t *p_demux,
     if( !p_infe )
         return VLC_EGENERIC;
 
-    es_format_t fmt;
-    es_format_Init(&fmt, UNKNOWN_ES, 0);
+    es_format_Init( &p_job->fmt, UNKNOWN_ES, 0 );
 
     const MP4_Box_t *p_shared_header = NULL;
-    if( SetupPicture( p_demux, p_infe, &fmt, &p_shared_header ) != VLC_SUCCESS )
+    if( SetupPicture( p_demux, p_infe, &p_job->fmt, &p_shared_header ) != VLC_SUCCESS )
     {
-        es_format_Clean( &fmt );
+        es_format_Clean( &p_job->fmt );
         return VLC_EGENERIC; /* Unsupported picture, goto next */
     }
 
-    block_t *p_sample = ReadItemExtents( p_demux, i_pic_item_id,
-                                         p_shared_header );
-    if(!p_sample)
+    p_job->p_sample = ReadItemExtents( p_demux, i_pic_item_id,
+                                       p_shared_header );
+    if( !p_job->p_sample )
     {
-        es_format_Clean( &fmt );
+        es_format_Clean( &p_job->fmt );
         return VLC_EGENERIC;
     }
 
+    p_job->tile = tile;
+    return VLC_SUCCESS;
+}
+
+static void DecodeGridTile( struct grid_decode_ctx *ctx,
+                            image_handler_t *handler,
+                            struct grid_tile_job *p_job )
+{
     video_format_t decoded;
     video_format_Init( &decoded, VLC_CODEC_RGBA );
 
-    fmt.video.i_chroma = fmt.i_codec;
+    p_job->fmt.video.i_chroma = p_job->fmt.i_codec;
 
-    picture_t *p_picture = image_Read( handler, p_sample, &fmt, &decoded );
-
-    es_format_Clean( &fmt );
+    picture_t *p_picture = image_Read( handler, p_job->p_sample,
+                                       &p_job->fmt, &decoded );
+    p_job->p_sample = NULL; /* consumed */
+    es_format_Clean( &p_job->fmt );
 
     if ( !p_picture )
-        return VLC_EGENERIC;
+        return;
 
+    const unsigned tile = p_job->tile;
+    const unsigned gridcols = ctx->gridcols;
+    const unsigned imagewidth = ctx->imagewidth;
+    const unsigned imageheight = ctx->imageheight;
     const unsigned tilewidth = p_picture->format.i_visible_width;
     const unsigned tileheight = p_picture->format.i_visible_height;
-    uint8_t *dstline = p_buffer;
+    uint8_t *dstline = ctx->p_buffer;
     dstline += (tile / gridcols) * (imagewidth * tileheight * 4);
     for(;1;)
     {
@@ -595,8 +630,21 @@ static int LoadGridImage( demux_t *p_demux,
     }
 
     picture_Release( p_picture );
+}
 
-    return VLC_SUCCESS;
+/* Tiles land in disjoint regions of the output buffer, so workers can
+ * decode and blit concurrently, each through its own decoder instance. */
+static void *GridWorkerThread( void *opaque )
+{
+    struct grid_worker *w = opaque;
+    struct grid_decode_ctx *ctx = w->ctx;
+
+    for( unsigned i = atomic_fetch_add( &ctx->next, 1 );
+         i < ctx->i_jobs;
+         i = atomic_fetch_add( &ctx->next, 1 ) )
+        DecodeGridTile( ctx, w->handler, &ctx->p_jobs[i] );
+
+    return NULL;
 }
 
 static int DerivedImageAssembleGrid( demux_t *p_demux, uint32_t i_grid_item_id,
@@ -631,10 +679,6 @@ static int DerivedImageAssembleGrid( demux_t *p_demux, uint32_t i_grid_item_id,
             derivation_data.ImageGrid.columns_minus_one + 1,
             derivation_data.ImageGrid.columns_minus_one + 1);
 
-    image_handler_t *handler = image_HandlerCreate( p_demux );
-    if( !handler )
-        return VLC_EGENERIC;
-
     block_t *p_block = block_Alloc( derivation_data.ImageGrid.output_width *
                                     derivation_data.ImageGrid.output_height * 4 );
     if( !p_block )
@@ -649,22 +693,88 @@ static int DerivedImageAssembleGrid( demux_t *p_demux, uint32_t i_grid_item_id,
     fmt->video.i_height =
     fmt->video.i_visible_height = derivation_data.ImageGrid.output_height;
 
+    struct grid_decode_ctx ctx =
+    {
+        .p_jobs = vlc_alloc( BOXDATA(p_refbox)->i_reference_count,
+                             sizeof(struct grid_tile_job) ),
+        .i_jobs = 0,
+        .p_buffer = p_block->p_buffer,
+        .gridcols = derivation_data.ImageGrid.columns_minus_one + 1,
+        .imagewidth = derivation_data.ImageGrid.output_width,
+        .imageheight = derivation_data.ImageGrid.output_height,
+    };
+    atomic_init( &ctx.next, 0 );
+    if( !ctx.p_jobs )
+        return VLC_EGENERIC;
+
+    /* Read the samples upfront: the demuxed stream cannot be shared, but
+     * decoding can.  Tiles land in disjoint output regions. */
     for( uint16_t i=0; i<BOXDATA(p_refbox)->i_reference_count; i++ )
     {
-        msg_Dbg( p_demux, "Loading tile %d/%d", i,
-                 (derivation_data.ImageGrid.rows_minus_one + 1) *
-                 (derivation_data.ImageGrid.columns_minus_one + 1) );
-        LoadGridImage( p_demux, handler,
-                       BOXDATA(p_refbox)->p_references[i].i_to_item_id,
-                       p_block->p_buffer, i,
-                       derivation_data.ImageGrid.columns_minus_one + 1,
-                       derivation_data.ImageGrid.output_width,
-                       derivation_data.ImageGrid.output_height );
+        if( PrepareGridTile( p_demux,
+                             BOXDATA(p_refbox)->p_references[i].i_to_item_id,
+                             &ctx.p_jobs[ctx.i_jobs], i ) == VLC_SUCCESS )
+            ctx.i_jobs++;
     }
 
-    SetPictureProperties( p_demux, i_grid_item_id, fmt, NULL );
+    unsigned i_workers = vlc_GetCPUCount();
+    if( i_workers > ctx.i_jobs )
+        i_workers = ctx.i_jobs;
+
+    msg_Dbg( p_demux, "decoding %zu tiles across %u decoder(s)",
+             ctx.i_jobs, i_workers ? i_workers : 1 );
+
+    struct grid_worker *p_workers =
+            i_workers > 1 ? vlc_alloc( i_workers, sizeof(*p_workers) ) : NULL;
+    unsigned i_spawned = 0;
+    if( p_workers )
+    {
+        /* The first worker runs on this thread; clone the others */
+        for( unsigned i = 1; i < i_workers; i++ )
+        {
+            struct grid_worker *w = &p_workers[i_spawned + 1];
+            w->ctx = &ctx;
+            w->handler = image_HandlerCreate( p_demux );
+            if( !w->handler )
+                break;
+            if( vlc_clone( &w->thread, GridWorkerThread, w,
+                           VLC_THREAD_PRIORITY_VIDEO ) )
+            {
+                image_HandlerDelete( w->handler );
+                break;
+            }
+            i_spawned++;
+        }
+    }
 
-    image_HandlerDelete( handler );
+    /* Decode our share (or everything, single-threaded) */
+    image_handler_t *handler = image_HandlerCreate( p_demux );
+    if( handler )
+    {
+        struct grid_worker self = { .ctx = &ctx, .handler = handler };
+        GridWorkerThread( &self );
+        image_HandlerDelete( handler );
+    }
+
+    for( unsigned i = 1; i <= i_spawned; i++ )
+    {
+        vlc_join( p_workers[i].thread, NULL );
+        image_HandlerDelete( p_workers[i].handler );
+    }
+    free( p_workers );
+
+    /* Release anything a failed handler left behind */
+    for( size_t i = 0; i < ctx.i_jobs; i++ )
+    {
+        if( ctx.p_jobs[i].p_sample )
+        {
+            block_Release( ctx.p_jobs[i].p_sample );
+            es_format_Clean( &ctx.p_jobs[i].fmt );
+        }
+    }
+    free( ctx.p_jobs );
+
+    SetPictureProperties( p_demux, i_grid_item_id, fmt, NULL );
 
     return VLC_SUCCESS;
 }
@@ -2963,17 +2963,24 @@ static int TrackGetNearestSeekPoint( demux_t *p_demux, mp4_track_t *p_track,
         const MP4_Box_data_stss_t *p_stss_data = BOXDATA(p_stss);
         msg_Dbg( p_demux, "track[Id 0x%x] using Sync Sample Box (stss)",
                  p_track->i_track_ID );
-        for( unsigned i_index = 0; i_index < p_stss_data->i_entry_count; i_index++ )
+        if( p_stss_data->i_entry_count > 0 )
         {
-            if( i_index >= p_stss_data->i_entry_count - 1 ||
-                i_sample < p_stss_data->i_sample_number[i_index+1] )
+            /* Binary search the last sync sample not after i_sample, the
+             * table is sorted by sample number. Frame stepping seeks once
+             * per displayed frame, so the lookup cost matters. */
+            uint32_t i_lo = 0, i_hi = p_stss_data->i_entry_count - 1;
+            while( i_lo < i_hi )
             {
-                *pi_sync_sample = p_stss_data->i_sample_number[i_index];
-                msg_Dbg( p_demux, "stss gives %d --> %" PRIu32 " (sample number)",
-                         i_sample, *pi_sync_sample );
-                i_ret = VLC_SUCCESS;
-                break;
+                const uint32_t i_mid = i_lo + (i_hi - i_lo + 1) / 2;
+                if( i_sample < p_stss_data->i_sample_number[i_mid] )
+                    i_hi = i_mid - 1;
+                else
+                    i_lo = i_mid;
             }
+            *pi_sync_sample = p_stss_data->i_sample_number[i_lo];
+            msg_Dbg( p_demux, "stss gives %d --> %" PRIu32 " (sample number)",
+                     i_sample, *pi_sync_sample );
+            i_ret = VLC_SUCCESS;
         }
     }
 
@@ -4222,7 +4229,18 @@ static int ProbeFragments( demux_t *p_demux, bool b_force, bool *pb_fragmented )
     if( !p_vroot )
         return VLC_EGENERIC;
 
-    if( p_sys->b_seekable && (p_sys->b_fastseekable || b_force) )
+    if( p_sys->b_seekable && (p_sys->b_fastseekable || b_force) &&
+        p_sys->p_fragsindex == NULL &&
+        (p_sys->p_fragsindex = MP4_Fragments_Index_Restore( p_demux, p_sys->i_tracks )) != NULL )
+    {
+        /* The moof walk below only exists to build the index: with a cached
+         * one, read up to the first moof like the non-fastseekable path. */
+        const uint32_t excllist[] = { ATOM_moof, 0 };
+        MP4_ReadBoxContainerRestricted( p_demux->s, p_vroot, NULL, excllist );
+        p_sys->b_fragments_probed = true;
+        *pb_fragmented = true;
+    }
+    else if( p_sys->b_seekable && (p_sys->b_fastseekable || b_force) )
     {
         MP4_ReadBoxContainerChildren( p_demux->s, p_vroot, NULL ); /* Get the rest of the file */
         p_sys->b_fragments_probed = true;
@@ -4290,6 +4308,7 @@ static int ProbeFragments( demux_t *p_demux, bool b_force, bool *pb_fragmented )
             }
 
             free( pi_track_times );
+            MP4_Fragments_Index_Persist( p_demux, p_sys->p_fragsindex );
 #ifdef MP4_VERBOSE
             MP4_Fragments_Index_Dump( VLC_OBJECT(p_demux), p_sys->p_fragsindex, p_sys->i_timescale );
 #endif
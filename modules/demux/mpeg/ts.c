@@ -403,7 +403,11 @@ static int Open( vlc_object_t *p_this )
 
     p_sys->i_packet_size = i_packet_size;
     p_sys->i_packet_header_size = i_packet_header_size;
-    p_sys->i_ts_read = 50;
+    /* Per pf_demux call packet budget; frame completion breaks out earlier,
+     * so this mostly bounds the work done on section/unselected PIDs. Keep
+     * it large enough that call overhead does not dominate on high bitrate
+     * multi-program streams. */
+    p_sys->i_ts_read = 250;
     p_sys->csa = NULL;
     p_sys->b_start_record = false;
 
@@ -631,7 +635,7 @@ static int Demux( demux_t *p_demux )
         GetPID(p_sys, 0)->u.p_pat->b_generated = true;
     }
 
-    /* We read at most 100 TS packet or until a frame is completed */
+    /* We read at most i_ts_read TS packets or until a frame is completed */
     for( unsigned i_pkt = 0; i_pkt < p_sys->i_ts_read; i_pkt++ )
     {
         bool         b_frame = false;
@@ -1809,8 +1813,18 @@ static block_t* ReadTSPacket( demux_t *p_demux )
 
             while( i_skip < i_peek - p_sys->i_packet_size )
             {
-                if( p_peek[i_skip + p_sys->i_packet_header_size] == 0x47 &&
-                        p_peek[i_skip + p_sys->i_packet_header_size + p_sys->i_packet_size] == 0x47 )
+                /* memchr() is vectorized by the C runtime: jump between sync
+                 * byte candidates instead of testing every byte */
+                const uint8_t *p_here =
+                    memchr( &p_peek[i_skip + p_sys->i_packet_header_size], 0x47,
+                            i_peek - p_sys->i_packet_size - i_skip );
+                if( p_here == NULL )
+                {
+                    i_skip = i_peek - p_sys->i_packet_size;
+                    break;
+                }
+                i_skip = (p_here - p_peek) - p_sys->i_packet_header_size;
+                if( p_peek[i_skip + p_sys->i_packet_header_size + p_sys->i_packet_size] == 0x47 )
                 {
                     break;
                 }
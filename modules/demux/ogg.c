@@ -268,6 +268,9 @@ static void Close( vlc_object_t *p_this )
     demux_t *p_demux = (demux_t *)p_this;
     demux_sys_t *p_sys = p_demux->p_sys  ;
 
+    /* Persist the seek index while the logical streams still exist */
+    Oggseek_IndexCacheSave( p_demux );
+
     /* Cleanup the bitstream parser */
     ogg_sync_clear( &p_sys->oy );
 
@@ -513,6 +516,10 @@ static int Demux( demux_t * p_demux )
             {
                 continue;
             }
+
+            /* Remember where this page lives so seeking back is cheap */
+            if( p_sys->b_preparsing_done )
+                Oggseek_IndexCurrentPage( p_demux, p_stream );
         }
 
         /* clear the finished flag if pages after eos (ex: after a seek) */
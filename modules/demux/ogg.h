@@ -95,6 +95,9 @@ typedef struct logical_stream_s
     /* keyframe index for seeking, created as we discover keyframes */
     demux_index_entry_t *idx;
 
+    /* last time recorded into the index during playback (rate limiter) */
+    vlc_tick_t i_index_last_time;
+
     /* Skeleton data */
     ogg_skeleton_t *p_skel;
 
@@ -194,6 +197,10 @@ typedef struct
     /* offset position in file (for reading) */
     int64_t i_input_position;
 
+    /* on-disk seek index cache (oggseek.c) */
+    bool b_idx_cache_tried;
+    bool b_idx_dirty;
+
     /* current page being parsed */
     ogg_page current_page;
 
@@ -36,9 +36,14 @@
 
 #include <vlc_common.h>
 #include <vlc_demux.h>
+#include <vlc_configuration.h>
+#include <vlc_fs.h>
+#include <vlc_hash.h>
+#include <vlc_block.h>
 
 #include <ogg/ogg.h>
 #include <limits.h>
+#include <sys/stat.h>
 
 #include <assert.h>
 
@@ -49,6 +54,9 @@
 #define SEGMENT_NOT_FOUND -1
 
 #define MAX_PAGE_SIZE 65307
+
+/* granularity of the index entries recorded during playback */
+#define OGGSEEK_INDEX_INTERVAL VLC_TICK_FROM_SEC(5)
 typedef struct packetStartCoordinates
 {
     int64_t i_pos;
@@ -113,6 +121,7 @@ const demux_index_entry_t *OggSeek_IndexAdd ( logical_stream_t *p_stream,
 
     while ( idx != NULL )
     {
+        if ( idx->i_pagepos == i_pagepos ) return idx; /* already indexed */
         if ( idx->i_pagepos > i_pagepos ) break;
         last_idx = idx;
         idx = idx->p_next;
@@ -171,6 +180,291 @@ static bool OggSeekIndexFind ( logical_stream_t *p_stream, vlc_tick_t i_timestam
     return false;
 }
 
+/* record the current page into the seek index during playback, so later
+   seeks into already played ranges need no bisection. Rate limited, and
+   restricted to codecs for which any page is a valid entry point */
+
+void Oggseek_IndexCurrentPage ( demux_t *p_demux, logical_stream_t *p_stream )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    ogg_int64_t i_granule = ogg_page_granulepos( &p_sys->current_page );
+    if ( i_granule < 0 || p_stream->b_initializing || p_stream->b_oggds )
+        return;
+
+    /* Codecs with keyframes need the keyframe logic of the seek path;
+       jumping to an arbitrary remembered page would break decoding */
+    if ( Ogg_GetKeyframeGranule( p_stream, 0xFF00FF00 ) != 0xFF00FF00 )
+        return;
+
+    vlc_tick_t i_time = Ogg_GranuleToTime( p_stream, i_granule,
+                                           !p_stream->b_contiguous, false );
+    if ( i_time == VLC_TICK_INVALID )
+        return;
+
+    if ( p_stream->i_index_last_time != VLC_TICK_INVALID &&
+         i_time < p_stream->i_index_last_time + OGGSEEK_INDEX_INTERVAL )
+        return;
+
+    /* start of the page = stream position minus what the sync layer still
+       holds, minus the page we have just taken out of it */
+    int64_t i_pagepos = vlc_stream_Tell( p_demux->s )
+                      - ( p_sys->oy.fill - p_sys->oy.returned )
+                      - ( p_sys->current_page.header_len +
+                          p_sys->current_page.body_len );
+    if ( i_pagepos < p_stream->i_data_start )
+        return;
+
+    if ( OggSeek_IndexAdd( p_stream, i_time, i_pagepos ) != NULL )
+    {
+        p_stream->i_index_last_time = i_time;
+        p_sys->b_idx_dirty = true;
+    }
+}
+
+/************************************************************
+* on-disk index cache
+*************************************************************/
+
+/* Bumping the version invalidates every existing cache file. */
+static const char oggseek_cache_magic[8] = { 'V','O','G','X','0','0','0','1' };
+
+/* Builds "<path>|<size>|<mtime>", the identity the cache entry is keyed
+   by, or NULL when the media is not a plain local file. */
+
+static char *oggseek_cache_key ( demux_t *p_demux )
+{
+    const char *psz_filepath = p_demux->s->psz_filepath;
+    struct stat st;
+    char *psz_key;
+
+    if ( psz_filepath == NULL || vlc_stat( psz_filepath, &st ) ||
+         !S_ISREG( st.st_mode ) )
+        return NULL;
+
+    if ( asprintf( &psz_key, "%s|%"PRIu64"|%"PRId64, psz_filepath,
+                   (uint64_t) st.st_size, (int64_t) st.st_mtime ) < 0 )
+        return NULL;
+    return psz_key;
+}
+
+/* Cache file path: <cachedir>/oggidx/<md5 of key>, creating the directory */
+
+static char *oggseek_cache_path ( const char *psz_key )
+{
+    char *psz_cachedir = config_GetUserDir( VLC_CACHE_DIR );
+    if ( psz_cachedir == NULL )
+        return NULL;
+
+    vlc_hash_md5_t md5;
+    uint8_t digest[VLC_HASH_MD5_DIGEST_SIZE];
+    char hex[VLC_HASH_MD5_DIGEST_HEX_SIZE];
+
+    vlc_hash_md5_Init( &md5 );
+    vlc_hash_md5_Update( &md5, psz_key, strlen( psz_key ) );
+    vlc_hash_md5_Finish( &md5, digest, sizeof( digest ) );
+    for ( size_t i = 0; i < sizeof( digest ); i++ )
+        sprintf( hex + 2 * i, "%02x", digest[i] );
+
+    char *psz_dir, *psz_path = NULL;
+    if ( asprintf( &psz_dir, "%s" DIR_SEP "oggidx", psz_cachedir ) < 0 )
+        psz_dir = NULL;
+    free( psz_cachedir );
+    if ( psz_dir == NULL )
+        return NULL;
+
+    vlc_mkdir( psz_dir, 0700 ); /* best effort, open will fail anyway */
+    if ( asprintf( &psz_path, "%s" DIR_SEP "%s", psz_dir, hex ) < 0 )
+        psz_path = NULL;
+    free( psz_dir );
+    return psz_path;
+}
+
+static bool oggseek_cache_read ( const uint8_t **pp_cursor, const uint8_t *p_end,
+                                 void *p_dst, size_t i_size )
+{
+    if ( (size_t)( p_end - *pp_cursor ) < i_size )
+        return false;
+    memcpy( p_dst, *pp_cursor, i_size );
+    *pp_cursor += i_size;
+    return true;
+}
+
+/* load the granule map persisted by a previous session, keyed by the file
+   identity. Entries go through OggSeek_IndexAdd so they merge with whatever
+   this session discovered already */
+
+void Oggseek_IndexCacheLoad ( demux_t *p_demux )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    if ( p_sys->b_idx_cache_tried )
+        return;
+    p_sys->b_idx_cache_tried = true;
+
+    char *psz_key = oggseek_cache_key( p_demux );
+    if ( psz_key == NULL )
+        return;
+
+    char *psz_path = oggseek_cache_path( psz_key );
+    if ( psz_path == NULL )
+    {
+        free( psz_key );
+        return;
+    }
+
+    block_t *p_map = block_FilePath( psz_path, false );
+    free( psz_path );
+
+    unsigned i_loaded = 0;
+    uint64_t i_keylen;
+    uint32_t i_nstreams;
+
+    if ( p_map == NULL )
+        goto out;
+
+    const uint8_t *p_cursor = p_map->p_buffer;
+    const uint8_t *p_end = p_map->p_buffer + p_map->i_buffer;
+
+    if ( (size_t)( p_end - p_cursor ) < sizeof( oggseek_cache_magic ) ||
+         memcmp( p_cursor, oggseek_cache_magic, sizeof( oggseek_cache_magic ) ) )
+        goto out;
+    p_cursor += sizeof( oggseek_cache_magic );
+
+    if ( !oggseek_cache_read( &p_cursor, p_end, &i_keylen, 8 ) ||
+         i_keylen != strlen( psz_key ) ||
+         (size_t)( p_end - p_cursor ) < i_keylen ||
+         memcmp( p_cursor, psz_key, i_keylen ) )
+        goto out; /* hash collision or stale identity */
+    p_cursor += i_keylen;
+
+    if ( !oggseek_cache_read( &p_cursor, p_end, &i_nstreams, 4 ) )
+        goto out;
+
+    for ( uint32_t i = 0; i < i_nstreams; i++ )
+    {
+        int32_t i_serial;
+        uint64_t i_count;
+        if ( !oggseek_cache_read( &p_cursor, p_end, &i_serial, 4 ) ||
+             !oggseek_cache_read( &p_cursor, p_end, &i_count, 8 ) ||
+             (uint64_t)( p_end - p_cursor ) / 16 < i_count )
+            goto out;
+
+        logical_stream_t *p_stream = NULL;
+        for ( int j = 0; j < p_sys->i_streams; j++ )
+        {
+            if ( p_sys->pp_stream[j]->i_serial_no == i_serial )
+            {
+                p_stream = p_sys->pp_stream[j];
+                break;
+            }
+        }
+
+        for ( uint64_t j = 0; j < i_count; j++ )
+        {
+            int64_t i_value, i_pagepos;
+            oggseek_cache_read( &p_cursor, p_end, &i_value, 8 );
+            oggseek_cache_read( &p_cursor, p_end, &i_pagepos, 8 );
+            if ( p_stream != NULL &&
+                 OggSeek_IndexAdd( p_stream, i_value, i_pagepos ) != NULL )
+                i_loaded++;
+        }
+    }
+
+    if ( i_loaded > 0 )
+        msg_Dbg( p_demux, "loaded %u cached seek index entries", i_loaded );
+
+out:
+    if ( p_map != NULL )
+        block_Release( p_map );
+    free( psz_key );
+}
+
+/* persist the granule map for the next session */
+
+void Oggseek_IndexCacheSave ( demux_t *p_demux )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    if ( !p_sys->b_idx_dirty )
+        return;
+
+    /* merge what previous sessions persisted before overwriting it */
+    Oggseek_IndexCacheLoad( p_demux );
+
+    uint32_t i_nstreams = 0;
+    for ( int i = 0; i < p_sys->i_streams; i++ )
+        if ( p_sys->pp_stream[i]->idx != NULL )
+            i_nstreams++;
+    if ( i_nstreams == 0 )
+        return;
+
+    char *psz_key = oggseek_cache_key( p_demux );
+    if ( psz_key == NULL )
+        return;
+
+    char *psz_path = oggseek_cache_path( psz_key );
+    if ( psz_path == NULL )
+    {
+        free( psz_key );
+        return;
+    }
+
+    char *psz_tmp;
+    if ( asprintf( &psz_tmp, "%s.tmp", psz_path ) < 0 )
+        psz_tmp = NULL;
+
+    FILE *stream = psz_tmp ? vlc_fopen( psz_tmp, "wb" ) : NULL;
+    if ( stream == NULL )
+    {
+        msg_Dbg( p_demux, "cannot write seek index cache" );
+        free( psz_tmp );
+        free( psz_path );
+        free( psz_key );
+        return;
+    }
+
+    uint64_t i_keylen = strlen( psz_key );
+    fwrite( oggseek_cache_magic, sizeof( oggseek_cache_magic ), 1, stream );
+    fwrite( &i_keylen, 8, 1, stream );
+    fwrite( psz_key, i_keylen, 1, stream );
+    fwrite( &i_nstreams, 4, 1, stream );
+
+    for ( int i = 0; i < p_sys->i_streams; i++ )
+    {
+        logical_stream_t *p_stream = p_sys->pp_stream[i];
+        if ( p_stream->idx == NULL )
+            continue;
+
+        uint64_t i_count = 0;
+        for ( demux_index_entry_t *idx = p_stream->idx; idx; idx = idx->p_next )
+            i_count++;
+
+        int32_t i_serial = p_stream->i_serial_no;
+        fwrite( &i_serial, 4, 1, stream );
+        fwrite( &i_count, 8, 1, stream );
+        for ( demux_index_entry_t *idx = p_stream->idx; idx; idx = idx->p_next )
+        {
+            int64_t i_value = idx->i_value;
+            int64_t i_pagepos = idx->i_pagepos;
+            fwrite( &i_value, 8, 1, stream );
+            fwrite( &i_pagepos, 8, 1, stream );
+        }
+    }
+
+    bool b_ok = !ferror( stream );
+    fclose( stream );
+
+    if ( b_ok && vlc_rename( psz_tmp, psz_path ) == 0 )
+        msg_Dbg( p_demux, "saved seek index cache" );
+    else
+        vlc_unlink( psz_tmp );
+
+    free( psz_tmp );
+    free( psz_path );
+    free( psz_key );
+}
+
 /*********************************************************************
  * private functions
  **********************************************************************/
@@ -779,6 +1073,8 @@ int Oggseek_BlindSeektoAbsoluteTime( demux_t *p_demux, logical_stream_t *p_strea
     int64_t i_upperpos = -1;
     bool b_found = false;
 
+    Oggseek_IndexCacheLoad( p_demux );
+
     /* Search in skeleton */
     Ogg_GetBoundsUsingSkeletonIndex( p_stream, i_time, &i_lowerpos, &i_upperpos );
     if ( i_lowerpos != -1 ) b_found = true;
@@ -877,6 +1173,8 @@ int Oggseek_SeektoAbsolutetime( demux_t *p_demux, logical_stream_t *p_stream,
     int64_t i_offset_lower = -1;
     int64_t i_offset_upper = -1;
 
+    Oggseek_IndexCacheLoad( p_demux );
+
     if ( Ogg_GetBoundsUsingSkeletonIndex( p_stream, i_time, &i_offset_lower, &i_offset_upper ) )
     {
         /* Exact match */
@@ -907,8 +1205,9 @@ int Oggseek_SeektoAbsolutetime( demux_t *p_demux, logical_stream_t *p_stream,
     }
     /* Insert keyframe position into index */
     OggNoDebug(
-    if ( i_pagepos >= p_stream->i_data_start )
-        OggSeek_IndexAdd( p_stream, i_time, i_pagepos )
+    if ( i_pagepos >= p_stream->i_data_start &&
+         OggSeek_IndexAdd( p_stream, i_time, i_pagepos ) != NULL )
+        p_sys->b_idx_dirty = true
     );
 
     OggDebug( msg_Dbg( p_demux, "=================== Seeked To %"PRId64" time %"PRId64, i_pagepos, i_time ) );
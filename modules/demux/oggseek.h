@@ -62,6 +62,9 @@ int     Oggseek_BlindSeektoAbsoluteTime ( demux_t *, logical_stream_t *, vlc_tic
 int     Oggseek_BlindSeektoPosition ( demux_t *, logical_stream_t *, double f, bool );
 int     Oggseek_SeektoAbsolutetime ( demux_t *, logical_stream_t *, vlc_tick_t );
 const demux_index_entry_t *OggSeek_IndexAdd ( logical_stream_t *, vlc_tick_t, int64_t );
+void    Oggseek_IndexCurrentPage ( demux_t *, logical_stream_t * );
+void    Oggseek_IndexCacheLoad ( demux_t * );
+void    Oggseek_IndexCacheSave ( demux_t * );
 void    Oggseek_ProbeEnd( demux_t * );
 
 void oggseek_index_entries_free ( demux_index_entry_t * );
@@ -142,6 +142,7 @@ int Import_M3U( vlc_object_t *p_this )
     msg_Dbg( p_stream, "found valid M3U playlist" );
     p_stream->p_sys = pf_dup;
     p_stream->pf_readdir = ReadDir;
+    p_stream->b_readdir_incremental = true;
     p_stream->pf_control = access_vaDirectoryControlHelper;
 
     return VLC_SUCCESS;
@@ -275,9 +276,14 @@ static int CreateEntry( input_item_node_t *p_node, const struct entry_meta_s *me
     return VLC_SUCCESS;
 }
 
+/* Entries published per ReadDir() call: huge playlists get visible (and
+ * preparsed) progressively instead of all at once after a long parse */
+#define M3U_ENTRY_BATCH 256
+
 static int ReadDir( stream_t *p_demux, input_item_node_t *p_subitems )
 {
     char       *psz_line;
+    size_t      i_entries = 0;
     struct entry_meta_s meta;
     entry_meta_Init( &meta );
     char *    (*pf_dup) (const char *) = p_demux->p_sys;
@@ -352,6 +358,13 @@ static int ReadDir( stream_t *p_demux, input_item_node_t *p_subitems )
             /* Cleanup state after entry */
             entry_meta_Clean( &meta );
             entry_meta_Init( &meta );
+
+            /* Publish this batch, parsing resumes on the next call */
+            if( ++i_entries == M3U_ENTRY_BATCH )
+            {
+                free( psz_line );
+                return VLC_SUCCESS;
+            }
         }
 
  nextline:
@@ -52,6 +52,11 @@ static void Close( vlc_object_t * );
 #define LANG_TEXT N_("Forces the audio language")
 #define LANG_LONGTEXT N_("Forces the audio language for the output mux. Three letter ISO639 code. Default is 'eng'.")
 
+#define FRAMES_TEXT N_("Frames per read")
+#define FRAMES_LONGTEXT N_("Number of frames read and sent per demux call. " \
+    "Larger values lower the per-block demux and output overhead on " \
+    "PCM-heavy workloads.")
+
 #ifdef WORDS_BIGENDIAN
 # define FOURCC_DEFAULT "s16b"
 #else
@@ -74,6 +79,10 @@ vlc_module_begin();
                 FOURCC_TEXT, FOURCC_LONGTEXT, false );
         change_safe()
     add_string( "rawaud-lang", "eng", LANG_TEXT, LANG_LONGTEXT, false);
+    add_integer( "rawaud-frames-per-read", 4, FRAMES_TEXT, FRAMES_LONGTEXT,
+                 true )
+        change_integer_range( 1, 64 )
+        change_safe()
 vlc_module_end();
 
 /*****************************************************************************
@@ -86,6 +95,8 @@ typedef struct
     unsigned int i_frame_size;
     unsigned int i_frame_samples;
     unsigned int i_seek_step;
+    unsigned int i_frames_per_read;
+    unsigned int i_rem_bytes;      /* bytes sent but not yet dated */
     date_t       pts;
 } demux_sys_t;
 
@@ -217,6 +228,10 @@ static int Open( vlc_object_t * p_this )
     p_sys->i_frame_size = p_sys->i_frame_samples * p_sys->i_seek_step;
     msg_Dbg( p_demux, "frame size is %d bytes ", p_sys->i_frame_size);
 
+    p_sys->i_frames_per_read = var_InheritInteger( p_demux,
+                                                   "rawaud-frames-per-read" );
+    p_sys->i_rem_bytes = 0;
+
     p_demux->pf_demux   = Demux;
     p_demux->pf_control = Control;
     return VLC_SUCCESS;
@@ -244,16 +259,35 @@ static int Demux( demux_t *p_demux )
     demux_sys_t *p_sys  = p_demux->p_sys;
     block_t     *p_block;
 
-    p_block = vlc_stream_Block( p_demux->s, p_sys->i_frame_size );
+    /* Hand the stream blocks over without copying; dating accounts for the
+     * sample stride since blocks do not necessarily split on its boundary */
+    p_block = vlc_stream_GetBlocks( p_demux->s,
+                          p_sys->i_frame_size * p_sys->i_frames_per_read );
     if( p_block == NULL )
-        return VLC_DEMUXER_EOF;
+    {
+        /* vlc_stream_GetBlocks() may fail spuriously: retry with a plain
+         * sized read before concluding end of stream */
+        p_block = vlc_stream_Block( p_demux->s, p_sys->i_frame_size );
+        if( p_block == NULL )
+            return VLC_DEMUXER_EOF;
+    }
 
-    p_block->i_dts = p_block->i_pts = date_Get( &p_sys->pts );
+    es_out_SetPCR( p_demux->out, date_Get( &p_sys->pts ) );
 
-    es_out_SetPCR( p_demux->out, p_block->i_pts );
-    es_out_Send( p_demux->out, p_sys->p_es, p_block );
+    for( block_t *p_next; p_block != NULL; p_block = p_next )
+    {
+        p_next = p_block->p_next;
+        p_block->p_next = NULL;
+
+        p_block->i_dts = p_block->i_pts = date_Get( &p_sys->pts );
+
+        size_t i_total = p_sys->i_rem_bytes + p_block->i_buffer;
+        p_sys->i_rem_bytes = i_total % p_sys->i_seek_step;
 
-    date_Increment( &p_sys->pts, p_sys->i_frame_samples );
+        es_out_Send( p_demux->out, p_sys->p_es, p_block );
+
+        date_Increment( &p_sys->pts, i_total / p_sys->i_seek_step );
+    }
 
     return VLC_DEMUXER_SUCCESS;
 }
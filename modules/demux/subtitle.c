@@ -171,6 +171,16 @@ typedef struct
 
     vlc_tick_t  i_length;
 
+    /* Lazy parsing state: entries are parsed out of the loaded text on
+     * demand, so the open cost does not scale with the transcript size. */
+    struct
+    {
+        text_t  txt;
+        bool    b_eof;
+        int   (*pf_read)( vlc_object_t *, subs_properties_t *, text_t *,
+                          subtitle_t *, size_t );
+    } parser;
+
     /* */
     subs_properties_t props;
 
@@ -234,6 +244,9 @@ static int Demux( demux_t * );
 static int Control( demux_t *, int, va_list );
 
 static void Fix( demux_t * );
+static bool ParseNext( demux_t * );
+static void ParseUntil( demux_t *, vlc_tick_t );
+static void ParseAll( demux_t * );
 static char * get_language_from_filename( const char * );
 
 /*****************************************************************************
@@ -317,6 +330,12 @@ static int Open ( vlc_object_t *p_this )
     p_sys->subtitles.i_count  = 0;
     p_sys->subtitles.p_array  = NULL;
 
+    p_sys->parser.txt.i_line_count = 0;
+    p_sys->parser.txt.i_line = 0;
+    p_sys->parser.txt.line = NULL;
+    p_sys->parser.b_eof = true;
+    p_sys->parser.pf_read = NULL;
+
     p_sys->props.psz_header         = NULL;
     p_sys->props.i_microsecperframe = VLC_TICK_FROM_MS(40);
     p_sys->props.jss.b_inited       = false;
@@ -624,8 +643,6 @@ static int Open ( vlc_object_t *p_this )
         }
     }
 
-    msg_Dbg( p_demux, "loading all subtitles..." );
-
     if( e_bom == UTF8BOM && /* skip BOM */
         vlc_stream_Read( p_demux->s, NULL, 3 ) != 3 )
     {
@@ -633,43 +650,23 @@ static int Open ( vlc_object_t *p_this )
         return VLC_EGENERIC;
     }
 
-    /* Load the whole file */
-    text_t txtlines;
-    TextLoad( &txtlines, p_demux->s );
-
-    /* Parse it */
-    for( size_t i_max = 0; i_max < SIZE_MAX - 500 * sizeof(subtitle_t); )
-    {
-        if( p_sys->subtitles.i_count >= i_max )
-        {
-            i_max += 500;
-            subtitle_t *p_realloc = realloc( p_sys->subtitles.p_array, sizeof(subtitle_t) * i_max );
-            if( p_realloc == NULL )
-            {
-                TextUnload( &txtlines );
-                Close( p_this );
-                return VLC_ENOMEM;
-            }
-            p_sys->subtitles.p_array = p_realloc;
-        }
+    /* Load the whole file as lines; entries are parsed out of it lazily */
+    p_sys->parser.pf_read = pf_read;
+    p_sys->parser.b_eof =
+        TextLoad( &p_sys->parser.txt, p_demux->s ) != VLC_SUCCESS;
 
-        if( pf_read( VLC_OBJECT(p_demux), &p_sys->props, &txtlines,
-                     &p_sys->subtitles.p_array[p_sys->subtitles.i_count],
-                     p_sys->subtitles.i_count ) )
-            break;
-
-        p_sys->subtitles.i_count++;
-    }
-    /* Unload */
-    TextUnload( &txtlines );
-
-    msg_Dbg(p_demux, "loaded %zu subtitles", p_sys->subtitles.i_count );
+    p_sys->subtitles.i_current = 0;
+    p_sys->i_length = 0;
 
     /* *** add subtitle ES *** */
     if( p_sys->props.i_type == SUB_TYPE_SSA1 ||
              p_sys->props.i_type == SUB_TYPE_SSA2_4 ||
              p_sys->props.i_type == SUB_TYPE_ASS )
     {
+        /* SSA needs the whole script: the header goes into the ES extra
+         * data and the dialogue lines are not stored in time order. */
+        msg_Dbg( p_demux, "loading all subtitles..." );
+        ParseAll( p_demux );
         Fix( p_demux );
         es_format_Init( &fmt, SPU_ES, VLC_CODEC_SSA );
     }
@@ -681,11 +678,6 @@ static int Open ( vlc_object_t *p_this )
     else
         es_format_Init( &fmt, SPU_ES, VLC_CODEC_SUBT );
 
-    p_sys->subtitles.i_current = 0;
-    p_sys->i_length = 0;
-    if( p_sys->subtitles.i_count > 0 )
-        p_sys->i_length = p_sys->subtitles.p_array[p_sys->subtitles.i_count-1].i_stop;
-
     /* Stupid language detection in the filename */
     char * psz_language = get_language_from_filename( p_demux->psz_filepath );
 
@@ -727,6 +719,7 @@ static void Close( vlc_object_t *p_this )
     demux_t *p_demux = (demux_t*)p_this;
     demux_sys_t *p_sys = p_demux->p_sys;
 
+    TextUnload( &p_sys->parser.txt );
     for( size_t i = 0; i < p_sys->subtitles.i_count; i++ )
         free( p_sys->subtitles.p_array[i].psz_text );
     free( p_sys->subtitles.p_array );
@@ -735,17 +728,83 @@ static void Close( vlc_object_t *p_this )
     free( p_sys );
 }
 
+/*****************************************************************************
+ * Lazy parsing
+ *****************************************************************************/
+/* Parse one more entry out of the loaded text; false once exhausted. */
+static bool ParseNext( demux_t *p_demux )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    if( p_sys->parser.b_eof )
+        return false;
+
+    if( (p_sys->subtitles.i_count % 500) == 0 )
+    {
+        if( p_sys->subtitles.i_count >= SIZE_MAX - 500 * sizeof(subtitle_t) )
+            goto eof;
+        subtitle_t *p_realloc = realloc( p_sys->subtitles.p_array,
+                        sizeof(subtitle_t) * (p_sys->subtitles.i_count + 500) );
+        if( p_realloc == NULL )
+            goto eof;
+        p_sys->subtitles.p_array = p_realloc;
+    }
+
+    if( p_sys->parser.pf_read( VLC_OBJECT(p_demux), &p_sys->props,
+                    &p_sys->parser.txt,
+                    &p_sys->subtitles.p_array[p_sys->subtitles.i_count],
+                    p_sys->subtitles.i_count ) )
+        goto eof;
+
+    p_sys->subtitles.i_count++;
+    return true;
+
+eof:
+    p_sys->parser.b_eof = true;
+    TextUnload( &p_sys->parser.txt );
+    if( p_sys->subtitles.i_count > 0 )
+        p_sys->i_length = p_sys->subtitles.p_array[p_sys->subtitles.i_count-1].i_stop;
+    msg_Dbg( p_demux, "loaded %zu subtitles", p_sys->subtitles.i_count );
+    return false;
+}
+
+/* Make sure every entry starting at or before the given date is parsed */
+static void ParseUntil( demux_t *p_demux, vlc_tick_t i_date )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    while( p_sys->subtitles.i_count == 0 ||
+           p_sys->subtitles.p_array[p_sys->subtitles.i_count-1].i_start *
+           p_sys->f_rate <= i_date )
+        if( !ParseNext( p_demux ) )
+            break;
+}
+
+static void ParseAll( demux_t *p_demux )
+{
+    while( ParseNext( p_demux ) );
+}
+
 static void
 ResetCurrentIndex( demux_t *p_demux )
 {
     demux_sys_t *p_sys = p_demux->p_sys;
-    for( size_t i = 0; i < p_sys->subtitles.i_count; i++ )
+    size_t lo = 0, hi = p_sys->subtitles.i_count;
+
+    ParseUntil( p_demux, p_sys->i_next_demux_date );
+    hi = p_sys->subtitles.i_count;
+
+    /* Bisect for the first entry starting after the target date */
+    while( lo < hi )
     {
-        if( p_sys->subtitles.p_array[i].i_start * p_sys->f_rate >
-            p_sys->i_next_demux_date && i > 0 )
-            break;
-        p_sys->subtitles.i_current = i;
+        size_t mid = lo + (hi - lo) / 2;
+        if( p_sys->subtitles.p_array[mid].i_start * p_sys->f_rate >
+            p_sys->i_next_demux_date )
+            hi = mid;
+        else
+            lo = mid + 1;
     }
+    p_sys->subtitles.i_current = lo > 0 ? lo - 1 : 0;
 }
 
 /*****************************************************************************
@@ -763,6 +822,7 @@ static int Control( demux_t *p_demux, int i_query, va_list args )
             return VLC_SUCCESS;
 
         case DEMUX_GET_LENGTH:
+            ParseAll( p_demux );
             *va_arg( args, vlc_tick_t * ) = p_sys->i_length;
             return VLC_SUCCESS;
 
@@ -797,6 +857,7 @@ static int Control( demux_t *p_demux, int i_query, va_list args )
 
         case DEMUX_SET_POSITION:
             f = va_arg( args, double );
+            ParseAll( p_demux );
             if( p_sys->subtitles.i_count && p_sys->i_length )
             {
                 vlc_tick_t i64 = VLC_TICK_0 + f * p_sys->i_length;
@@ -844,6 +905,8 @@ static int Demux( demux_t *p_demux )
 
     vlc_tick_t i_barrier = p_sys->i_next_demux_date;
 
+    ParseUntil( p_demux, i_barrier );
+
     while( p_sys->subtitles.i_current < p_sys->subtitles.i_count &&
            ( p_sys->subtitles.p_array[p_sys->subtitles.i_current].i_start *
              p_sys->f_rate ) <= i_barrier )
@@ -879,7 +942,8 @@ static int Demux( demux_t *p_demux )
         p_sys->i_next_demux_date += VLC_TICK_FROM_MS(125);
     }
 
-    if( p_sys->subtitles.i_current >= p_sys->subtitles.i_count )
+    if( p_sys->subtitles.i_current >= p_sys->subtitles.i_count &&
+        p_sys->parser.b_eof )
         return VLC_DEMUXER_EOF;
 
     return VLC_DEMUXER_SUCCESS;
@@ -53,6 +53,11 @@ typedef struct
     unsigned int    i_frame_size;
     int             i_frame_samples;
 
+    unsigned int    i_frames_per_read;
+    unsigned int    i_stride;     /* bytes per sample frame, linear PCM only */
+    unsigned int    i_rem_bytes;  /* bytes sent but not yet dated */
+    bool            b_block_path; /* hand stream blocks over untouched */
+
     date_t          pts;
 
     uint32_t i_channel_mask;
@@ -90,13 +95,13 @@ static int Demux( demux_t *p_demux )
     demux_sys_t *p_sys = p_demux->p_sys;
     block_t     *p_block;
     const int64_t i_pos = vlc_stream_Tell( p_demux->s );
-    unsigned int i_read_size = p_sys->i_frame_size;
-    uint32_t i_read_samples = p_sys->i_frame_samples;
-
+    unsigned int i_read_size = p_sys->i_frame_size * p_sys->i_frames_per_read;
+    uint32_t i_read_samples = p_sys->i_frame_samples * p_sys->i_frames_per_read;
+    int64_t i_end = -1;
 
     if( p_sys->i_data_size > 0 )
     {
-        int64_t i_end = p_sys->i_data_pos + p_sys->i_data_size;
+        i_end = p_sys->i_data_pos + p_sys->i_data_size;
         if ( i_pos >= i_end )
             return VLC_DEMUXER_EOF;  /* EOF */
 
@@ -104,9 +109,60 @@ static int Demux( demux_t *p_demux )
         if ( i_end < i_pos + i_read_size )
         {
             i_read_size = i_end - i_pos;
-            i_read_samples = ( p_sys->i_frame_size - i_read_size )
-                           * p_sys->i_frame_samples / p_sys->i_frame_size;
+            i_read_samples = (uint64_t)i_read_size * p_sys->i_frame_samples
+                           / p_sys->i_frame_size;
+        }
+    }
+
+    if( p_sys->b_block_path )
+    {
+        block_t *p_chain = vlc_stream_GetBlocks( p_demux->s, i_read_size );
+        if( p_chain != NULL )
+        {
+            /* Trim whatever was gathered past the data chunk boundary */
+            if( i_end >= 0 )
+            {
+                uint64_t i_left = i_end - i_pos;
+                block_t **pp = &p_chain;
+                while( *pp != NULL && i_left > 0 )
+                {
+                    if( (*pp)->i_buffer > i_left )
+                        (*pp)->i_buffer = i_left;
+                    i_left -= (*pp)->i_buffer;
+                    pp = &(*pp)->p_next;
+                }
+                if( *pp != NULL )
+                {
+                    block_ChainRelease( *pp );
+                    *pp = NULL;
+                }
+            }
+
+            /* set PCR */
+            es_out_SetPCR( p_demux->out, date_Get( &p_sys->pts ) );
+
+            for( block_t *p_next; p_chain != NULL; p_chain = p_next )
+            {
+                p_next = p_chain->p_next;
+                p_chain->p_next = NULL;
+
+                p_chain->i_dts =
+                p_chain->i_pts = date_Get( &p_sys->pts );
+
+                /* Stream blocks do not necessarily split on a sample frame
+                 * boundary: carry the spare bytes into the next date */
+                uint64_t i_total = p_sys->i_rem_bytes + p_chain->i_buffer;
+                p_sys->i_rem_bytes = i_total % p_sys->i_stride;
+
+                es_out_Send( p_demux->out, p_sys->p_es, p_chain );
+
+                date_Increment( &p_sys->pts, i_total / p_sys->i_stride );
+            }
+
+            return VLC_DEMUXER_SUCCESS;
         }
+        /* vlc_stream_GetBlocks() may fail spuriously: retry with a plain
+         * sized read before concluding end of stream */
     }
 
     if( ( p_block = vlc_stream_Block( p_demux->s, i_read_size ) ) == NULL )
@@ -163,6 +219,7 @@ static int Control( demux_t *p_demux, int i_query, va_list args )
             vlc_tick_t pts =
                 vlc_tick_from_samples( ofs * 8, p_sys->fmt.i_bitrate );
             date_Set( &p_sys->pts, pts );
+            p_sys->i_rem_bytes = 0;
             break;
         }
         default:
@@ -530,6 +587,8 @@ static int ChunkParseFmt( demux_t *p_demux, uint32_t i_size )
             msg_Err( p_demux, "Unrecognized codec" );
             goto error;
         }
+        p_sys->i_stride = p_sys->fmt.audio.i_channels *
+            ( (p_sys->fmt.audio.i_bitspersample + 7) / 8 );
         break;
     case VLC_CODEC_ADPCM_MS:
     /* FIXME not sure at all FIXME */
@@ -622,6 +681,11 @@ static int Open( vlc_object_t * p_this )
     p_sys->i_data_pos = p_sys->i_data_size = 0;
     p_sys->i_chans_to_reorder = 0;
     p_sys->i_channel_mask = 0;
+    p_sys->i_stride = 0;
+    p_sys->i_rem_bytes = 0;
+    p_sys->b_block_path = false;
+    p_sys->i_frames_per_read = var_InheritInteger( p_demux,
+                                                   "wav-frames-per-read" );
 
     /* skip riff header */
     if( vlc_stream_Read( p_demux->s, NULL, 12 ) != 12 )
@@ -700,6 +764,13 @@ static int Open( vlc_object_t * p_this )
             p_sys->fmt.audio.i_rate * 8 / p_sys->i_frame_samples;
     }
 
+    /* Linear PCM needs no reordering or re-parsing: stream blocks can then
+     * be handed over untouched as long as dating accounts for the stride */
+    p_sys->b_block_path = p_sys->i_stride != 0
+        && p_sys->i_chans_to_reorder == 0
+        && ( p_sys->fmt.audio.i_blockalign == 0
+          || p_sys->fmt.audio.i_blockalign % p_sys->i_stride == 0 );
+
     p_sys->fmt.i_id = 0;
     p_sys->p_es = es_out_Add( p_demux->out, &p_sys->fmt );
     if( unlikely(p_sys->p_es == NULL) )
@@ -716,10 +787,18 @@ error:
     return VLC_EGENERIC;
 }
 
+#define FRAMES_TEXT N_("Frames per read")
+#define FRAMES_LONGTEXT N_("Number of frames read and sent per demux call. " \
+    "Larger values lower the per-block demux and output overhead on " \
+    "PCM-heavy workloads.")
+
 vlc_module_begin ()
     set_description( N_("WAV demuxer") )
     set_category( CAT_INPUT )
     set_subcategory( SUBCAT_INPUT_DEMUX )
     set_capability( "demux", 142 )
     set_callbacks( Open, Close )
+    add_integer( "wav-frames-per-read", 4, FRAMES_TEXT, FRAMES_LONGTEXT, true )
+        change_integer_range( 1, 64 )
+        change_safe()
 vlc_module_end ()
@@ -39,7 +39,21 @@
 struct index_entry_s
 {
     vlc_tick_t time;
-    unsigned active;
+    unsigned active; /* running overlap count */
+    unsigned start;  /* start (1) or stop (0) tag */
+};
+
+struct memstream_wrap
+{
+    struct vlc_memstream memstream;
+    bool b_opened;
+};
+
+struct callback_ctx
+{
+    demux_t *p_demux;
+    struct memstream_wrap regions, styles;
+    bool b_ordered;
 };
 
 typedef struct
@@ -71,6 +85,13 @@ typedef struct
         size_t   i_current;
     } index;
 
+    /* Incremental parsing state (seekable path): the parser stays alive
+     * after open so that data appended by live updates is parsed from the
+     * last consumed byte offset on, not from scratch. */
+    webvtt_text_parser_t *p_parser;
+    struct callback_ctx  *p_ctx;
+    uint64_t  i_parsed_offset;
+
     webvtt_text_parser_t *p_streamparser;
 } demux_sys_t;
 
@@ -138,12 +159,6 @@ static block_t *ConvertWEBVTT( const webvtt_cue_t *p_cue, bool b_continued )
         return NULL;
 }
 
-struct memstream_wrap
-{
-    struct vlc_memstream memstream;
-    bool b_opened;
-};
-
 static void memstream_Append( struct memstream_wrap *mw, const char *psz )
 {
     if( mw->b_opened )
@@ -170,13 +185,6 @@ static void memstream_Grab( struct memstream_wrap *mw, void **pp, size_t *pi )
 /*****************************************************************************
  * Seekable demux Open() parser callbacks
  *****************************************************************************/
-struct callback_ctx
-{
-    demux_t *p_demux;
-    struct memstream_wrap regions, styles;
-    bool b_ordered;
-};
-
 static webvtt_cue_t * ParserGetCueHandler( void *priv )
 {
     struct callback_ctx *ctx = (struct callback_ctx *) priv;
@@ -237,9 +245,9 @@ static void ParserCueDoneHandler( void *priv, webvtt_cue_t *p_cue )
     }
     if( p_sys->index.i_alloc > p_sys->index.i_count )
     {
-        p_sys->index.p_array[p_sys->index.i_count].active = 1; /* tmp start tag */
+        p_sys->index.p_array[p_sys->index.i_count].start = 1;
         p_sys->index.p_array[p_sys->index.i_count++].time = p_cue->i_start;
-        p_sys->index.p_array[p_sys->index.i_count].active = 0;
+        p_sys->index.p_array[p_sys->index.i_count].start = 0;
         p_sys->index.p_array[p_sys->index.i_count++].time = p_cue->i_stop;
     }
 }
@@ -303,32 +311,67 @@ static int index_Compare( const void *a_, const void *b_ )
     struct index_entry_s *b = (struct index_entry_s *) b_;
     if( a->time == b->time )
     {
-        if( a->active > b->active )
+        if( a->start > b->start )
             return -1;
         else
-            return b->active - a->active;
+            return b->start - a->start;
     }
     else return a->time < b->time ? -1 : 1;
 }
 
 static size_t getIndexByTime( demux_sys_t *p_sys, vlc_tick_t i_time )
 {
-    for( size_t i=0; i<p_sys->index.i_count; i++ )
+    size_t lo = 0, hi = p_sys->index.i_count;
+
+    /* Bisect for the first entry at or after the requested time */
+    while( lo < hi )
     {
-        if( p_sys->index.p_array[i].time >= i_time )
-            return i;
+        size_t mid = lo + (hi - lo) / 2;
+        if( p_sys->index.p_array[mid].time >= i_time )
+            hi = mid;
+        else
+            lo = mid + 1;
     }
-    return 0;
+    return lo < p_sys->index.i_count ? lo : 0;
 }
 
-static void BuildIndex( demux_t *p_demux )
+static void UpdateIndex( demux_t *p_demux, size_t i_first_new )
 {
     demux_sys_t *p_sys = p_demux->p_sys;
+    const size_t i_new = p_sys->index.i_count - i_first_new;
 
-    /* Order time entries ascending, start time before end time */
-    qsort( p_sys->index.p_array, p_sys->index.i_count,
+    if( i_new == 0 )
+        return;
+
+    /* Order time entries ascending, start time before end time.  Only the
+     * appended entries are sorted; they are then merged with the already
+     * sorted head, so live updates do not re-sort the whole index. */
+    qsort( &p_sys->index.p_array[i_first_new], i_new,
            sizeof(struct index_entry_s), index_Compare );
 
+    if( i_first_new > 0 )
+    {
+        struct index_entry_s *p_tail = malloc( i_new * sizeof(*p_tail) );
+        if( p_tail )
+        {
+            memcpy( p_tail, &p_sys->index.p_array[i_first_new],
+                    i_new * sizeof(*p_tail) );
+            size_t a = i_first_new, b = i_new, w = p_sys->index.i_count;
+            while( b > 0 )
+            {
+                if( a > 0 && index_Compare( &p_sys->index.p_array[a-1],
+                                            &p_tail[b-1] ) > 0 )
+                    p_sys->index.p_array[--w] = p_sys->index.p_array[--a];
+                else
+                    p_sys->index.p_array[--w] = p_tail[--b];
+            }
+            free( p_tail );
+        }
+        else /* fallback */
+            qsort( p_sys->index.p_array, p_sys->index.i_count,
+                   sizeof(struct index_entry_s), index_Compare );
+    }
+
     /* Build actives count
     TIME 3000 count 1
     TIME 14500 count 2 (1 overlap)
@@ -339,7 +382,7 @@ static void BuildIndex( demux_t *p_demux )
     unsigned i_overlaps = 0;
     for( size_t i=0; i<p_sys->index.i_count; i++ )
     {
-        if( p_sys->index.p_array[i].active )
+        if( p_sys->index.p_array[i].start )
             p_sys->index.p_array[i].active = ++i_overlaps;
         else
             p_sys->index.p_array[i].active = --i_overlaps;
@@ -370,40 +413,65 @@ static block_t *demux_From( demux_t *p_demux, vlc_tick_t i_start )
     return ( p_list ) ? block_ChainGather( p_list ) : NULL;
 }
 
-static int ReadWEBVTT( demux_t *p_demux )
+/* Feed everything past the last parsed byte offset to the parser, growing
+ * the cue list and timing index incrementally.  Returns true when new cues
+ * were indexed. */
+static bool ParseNewData( demux_t *p_demux )
 {
     demux_sys_t *p_sys = p_demux->p_sys;
+    const size_t i_prev_cues = p_sys->cues.i_count;
+    const size_t i_prev_index = p_sys->index.i_count;
+    uint64_t i_size;
 
-    struct callback_ctx ctx;
-    ctx.p_demux = p_demux;
-    ctx.b_ordered = true;
-
-    webvtt_text_parser_t *p_parser =
-            webvtt_text_parser_New( &ctx, ParserGetCueHandler,
-                                          ParserCueDoneHandler,
-                                          ParserHeaderHandler );
-    if( p_parser == NULL )
-        return VLC_EGENERIC;
-
-    ctx.regions.b_opened = !vlc_memstream_open( &ctx.regions.memstream );
-    ctx.styles.b_opened = !vlc_memstream_open( &ctx.styles.memstream );
+    if( vlc_stream_GetSize( p_demux->s, &i_size ) == 0 &&
+        i_size <= p_sys->i_parsed_offset )
+        return false;
 
     char *psz_line;
     while( (psz_line = vlc_stream_ReadLine( p_demux->s )) )
-        webvtt_text_parser_Feed( p_parser, psz_line );
-    webvtt_text_parser_Feed( p_parser, NULL );
+        webvtt_text_parser_Feed( p_sys->p_parser, psz_line );
+    /* Flush the pending cue; the parser stays usable for appended data */
+    webvtt_text_parser_Feed( p_sys->p_parser, NULL );
+    p_sys->i_parsed_offset = vlc_stream_Tell( p_demux->s );
+
+    if( p_sys->cues.i_count == i_prev_cues )
+        return false;
 
-    if( !ctx.b_ordered )
+    if( !p_sys->p_ctx->b_ordered )
         qsort( p_sys->cues.p_array, p_sys->cues.i_count, sizeof(webvtt_cue_t), cue_Compare );
 
-    BuildIndex( p_demux );
+    UpdateIndex( p_demux, i_prev_index );
+    return true;
+}
 
-    memstream_Grab( &ctx.regions, &p_sys->regions_headers.p_data,
-                                  &p_sys->regions_headers.i_data );
-    memstream_Grab( &ctx.styles, &p_sys->styles_headers.p_data,
-                                 &p_sys->styles_headers.i_data );
+static int ReadWEBVTT( demux_t *p_demux )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    struct callback_ctx *ctx = p_sys->p_ctx = malloc( sizeof(*ctx) );
+    if( ctx == NULL )
+        return VLC_EGENERIC;
+    ctx->p_demux = p_demux;
+    ctx->b_ordered = true;
+
+    p_sys->p_parser = webvtt_text_parser_New( ctx, ParserGetCueHandler,
+                                                   ParserCueDoneHandler,
+                                                   ParserHeaderHandler );
+    if( p_sys->p_parser == NULL )
+        return VLC_EGENERIC;
 
-    webvtt_text_parser_Delete( p_parser );
+    ctx->regions.b_opened = !vlc_memstream_open( &ctx->regions.memstream );
+    ctx->styles.b_opened = !vlc_memstream_open( &ctx->styles.memstream );
+
+    ParseNewData( p_demux );
+
+    memstream_Grab( &ctx->regions, &p_sys->regions_headers.p_data,
+                                   &p_sys->regions_headers.i_data );
+    memstream_Grab( &ctx->styles, &p_sys->styles_headers.p_data,
+                                  &p_sys->styles_headers.i_data );
+    /* The ES extra data is set in stone; drop header lines from updates */
+    ctx->regions.b_opened = false;
+    ctx->styles.b_opened = false;
 
     return VLC_SUCCESS;
 }
@@ -597,7 +665,17 @@ static int Demux( demux_t *p_demux )
     }
 
     if( p_sys->index.i_current >= p_sys->index.i_count )
+    {
+        /* Live playlists append cues; parse any new data before EOF */
+        if( p_sys->p_parser && ParseNewData( p_demux ) )
+        {
+            p_sys->index.i_current =
+                    getIndexByTime( p_sys, p_sys->i_next_demux_time );
+            if( p_sys->index.i_current < p_sys->index.i_count )
+                return VLC_DEMUXER_SUCCESS;
+        }
         return VLC_DEMUXER_EOF;
+    }
 
     return VLC_DEMUXER_SUCCESS;
 }
@@ -734,6 +812,10 @@ void webvtt_CloseDemux( vlc_object_t *p_this )
 
     free( p_sys->index.p_array );
 
+    if( p_sys->p_parser )
+        webvtt_text_parser_Delete( p_sys->p_parser );
+    free( p_sys->p_ctx );
+
     if( p_sys->p_streamparser )
     {
         webvtt_text_parser_Feed( p_sys->p_streamparser, NULL );
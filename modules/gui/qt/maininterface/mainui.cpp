@@ -18,6 +18,7 @@
 #include "playlist/playlist_model.hpp"
 #include "playlist/playlist_controller.hpp"
 
+#include "util/artwork_cache.hpp"
 #include "util/qml_main_context.hpp"
 #include "util/qmleventfilter.hpp"
 #include "util/i18n.hpp"
@@ -102,6 +103,9 @@ bool MainUI::setup(QQmlEngine* engine)
     engine->setOutputWarningsToStandardError(false);
     connect(engine, &QQmlEngine::warnings, this, &MainUI::onQmlWarning);
 
+    /* the engine takes ownership of the provider */
+    engine->addImageProvider(QStringLiteral("artwork"), new ArtworkCacheProvider());
+
     QQmlContext *rootCtx = engine->rootContext();
 
     rootCtx->setContextProperty( "history", new NavigationHistory(this) );
@@ -30,6 +30,10 @@ namespace playlist {
 
 namespace {
 
+/* Rows are exposed to the views in windows of this size, so that a very
+ * large playlist does not instantiate all its rows up front. */
+constexpr ssize_t PLAYLIST_CHUNK_SIZE = 100;
+
 static QVector<PlaylistItem> toVec(vlc_playlist_item_t *const items[],
                                    size_t len)
 {
@@ -132,6 +136,9 @@ on_playlist_current_item_changed(vlc_playlist_t *playlist, ssize_t index,
             return;
         ssize_t oldCurrent = that->m_current;
         that->m_current = index;
+        if (index != -1)
+            /* keep the playing row exposed to the views */
+            that->ensureLoaded(index);
         if (oldCurrent != -1)
             that->notifyItemsChanged(oldCurrent, 1, {PlaylistListModel::IsCurrentRole});
         if (index != -1)
@@ -177,6 +184,7 @@ void PlaylistListModelPrivate::onItemsReset(const QVector<PlaylistItem>& newCont
     Q_Q(PlaylistListModel);
     q->beginResetModel();
     m_items = newContent;
+    m_loaded = qMin((ssize_t)m_items.size(), PLAYLIST_CHUNK_SIZE);
     q->endResetModel();
 
     emit q->countChanged(m_items.size());
@@ -187,10 +195,20 @@ void PlaylistListModelPrivate::onItemsAdded(const QVector<PlaylistItem>& added,
 {
     Q_Q(PlaylistListModel);
     int count = added.size();
-    q->beginInsertRows({}, index, index + count - 1);
-    m_items.insert(index, count, nullptr);
-    std::move(added.cbegin(), added.cend(), m_items.begin() + index);
-    q->endInsertRows();
+    if ((ssize_t)index <= m_loaded)
+    {
+        q->beginInsertRows({}, index, index + count - 1);
+        m_items.insert(index, count, nullptr);
+        std::move(added.cbegin(), added.cend(), m_items.begin() + index);
+        m_loaded += count;
+        q->endInsertRows();
+    }
+    else
+    {
+        /* insertion beyond the loaded window: the rows are not exposed yet */
+        m_items.insert(index, count, nullptr);
+        std::move(added.cbegin(), added.cend(), m_items.begin() + index);
+    }
 
     emit q->countChanged(m_items.size());
 }
@@ -205,7 +223,8 @@ void PlaylistListModelPrivate::onItemsMoved(size_t index, size_t count, size_t t
        * the slice _after_ the move. */
         qtTarget += count;
 
-    q->beginMoveRows({}, index, index + count - 1, {}, qtTarget);
+    if ((ssize_t)(index + count) <= m_loaded && (ssize_t)qtTarget <= m_loaded)
+        q->beginMoveRows({}, index, index + count - 1, {}, qtTarget);
     if (index < target)
         std::rotate(m_items.begin() + index,
                     m_items.begin() + index + count,
@@ -214,15 +233,32 @@ void PlaylistListModelPrivate::onItemsMoved(size_t index, size_t count, size_t t
         std::rotate(m_items.begin() + target,
                     m_items.begin() + index,
                     m_items.begin() + index + count);
-    q->endMoveRows();
+    if ((ssize_t)(index + count) <= m_loaded && (ssize_t)qtTarget <= m_loaded)
+        q->endMoveRows();
+    else
+    {
+        /* the move crosses the loaded window boundary: the rows cannot be
+         * moved as such, refresh the exposed part of the affected range */
+        ssize_t first = qMin(index, target);
+        if (first < m_loaded)
+            notifyItemsChanged(first, m_loaded - first);
+    }
 }
 
 void PlaylistListModelPrivate::onItemsRemoved(size_t index, size_t count)
 {
     Q_Q(PlaylistListModel);
-    q->beginRemoveRows({}, index, index + count - 1);
-    m_items.remove(index, count);
-    q->endRemoveRows();
+    if ((ssize_t)index < m_loaded)
+    {
+        size_t exposed = qMin((ssize_t)count, m_loaded - (ssize_t)index);
+        q->beginRemoveRows({}, index, index + exposed - 1);
+        m_items.remove(index, count);
+        m_loaded -= exposed;
+        q->endRemoveRows();
+    }
+    else
+        /* removal beyond the loaded window: no rows were exposed */
+        m_items.remove(index, count);
 
     emit q->countChanged(m_items.size());
     emit q->selectedCountChanged();
@@ -233,11 +269,30 @@ void
 PlaylistListModelPrivate::notifyItemsChanged(int idx, int count, const QVector<int> &roles)
 {
     Q_Q(PlaylistListModel);
+    /* clamp to the loaded window, the other rows are not exposed */
+    if (idx >= m_loaded)
+        return;
+    if (idx + count > m_loaded)
+        count = m_loaded - idx;
     QModelIndex first = q->index(idx, 0);
     QModelIndex last = q->index(idx + count - 1);
     emit q->dataChanged(first, last, roles);
 }
 
+void
+PlaylistListModelPrivate::ensureLoaded(ssize_t index)
+{
+    Q_Q(PlaylistListModel);
+    if (index < m_loaded || index >= (ssize_t)m_items.size())
+        return;
+    ssize_t loaded = qMin((ssize_t)m_items.size(),
+                          (index / PLAYLIST_CHUNK_SIZE + 1)
+                              * PLAYLIST_CHUNK_SIZE);
+    q->beginInsertRows({}, m_loaded, loaded - 1);
+    m_loaded = loaded;
+    q->endInsertRows();
+}
+
 // public API
 
 PlaylistListModel::PlaylistListModel(QObject *parent)
@@ -292,12 +347,43 @@ int
 PlaylistListModel::rowCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent);
+    Q_D(const PlaylistListModel);
+    if (! d->m_playlist)
+        return 0;
+    return d->m_loaded;
+}
+
+int
+PlaylistListModel::count() const
+{
     Q_D(const PlaylistListModel);
     if (! d->m_playlist)
         return 0;
     return d->m_items.size();
 }
 
+bool
+PlaylistListModel::canFetchMore(const QModelIndex &parent) const
+{
+    Q_D(const PlaylistListModel);
+    return !parent.isValid() && d->m_loaded < (ssize_t)d->m_items.size();
+}
+
+void
+PlaylistListModel::fetchMore(const QModelIndex &parent)
+{
+    Q_D(PlaylistListModel);
+    if (!parent.isValid())
+        d->ensureLoaded(d->m_loaded);
+}
+
+void
+PlaylistListModel::fetchMoreRows()
+{
+    if (canFetchMore({}))
+        fetchMore({});
+}
+
 const PlaylistItem &
 PlaylistListModel::itemAt(int index) const
 {
@@ -435,7 +521,7 @@ PlaylistListModel::data(const QModelIndex &index, int role) const
         return {};
 
     ssize_t row = index.row();
-    if (row < 0 || row >= d->m_items.size())
+    if (row < 0 || row >= d->m_loaded)
         return {};
 
     switch (role)
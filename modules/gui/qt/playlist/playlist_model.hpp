@@ -38,7 +38,7 @@ class PlaylistListModel : public SelectableListModel
     Q_OBJECT
     Q_PROPERTY(PlaylistPtr playlistId READ getPlaylistId WRITE setPlaylistId NOTIFY playlistIdChanged)
     Q_PROPERTY(int currentIndex READ getCurrentIndex NOTIFY currentIndexChanged)
-    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
 
 public:
     enum Roles
@@ -57,7 +57,14 @@ public:
     ~PlaylistListModel();
 
     QHash<int, QByteArray> roleNames() const override;
+    ///number of rows currently exposed to the views
     int rowCount(const QModelIndex &parent = {}) const override;
+    ///total number of items in the playlist
+    int count() const;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    ///expose the next window of rows, QML-friendly fetchMore()
+    Q_INVOKABLE void fetchMoreRows();
     QVariant data(const QModelIndex &index,
                   int role = Qt::DisplayRole) const override;
 
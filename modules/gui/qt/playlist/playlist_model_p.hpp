@@ -57,11 +57,16 @@ public:
     void notifyItemsChanged(int index, int count,
                             const QVector<int> &roles = {});
 
+    ///extend the loaded window so that row @a index is exposed to the views
+    void ensureLoaded(ssize_t index);
+
     vlc_playlist_t* m_playlist = nullptr;
     vlc_playlist_listener_id *m_listener = nullptr;
 
     /* access only from the UI thread */
     QVector<PlaylistItem> m_items;
+    ///number of rows exposed to the views, <= m_items.size()
+    ssize_t m_loaded = 0;
     ssize_t m_current = -1;
 };
 
@@ -111,7 +111,18 @@ Rectangle {
                 Layout.leftMargin: VLCStyle.margin_xsmall
 
                 fillMode: Image.PreserveAspectFit
-                source: (model.artwork && model.artwork.toString()) ? model.artwork : VLCStyle.noArtCover
+                /* local covers are decoded and scaled off the UI thread by
+                 * the artwork cache */
+                asynchronous: true
+                sourceSize: Qt.size(width, height)
+                source: {
+                    var artwork = model.artwork
+                    if (!artwork || !artwork.toString())
+                        return VLCStyle.noArtCover
+                    if (artwork.toString().indexOf("file://") === 0)
+                        return "image://artwork/" + encodeURIComponent(artwork)
+                    return artwork
+                }
             }
 
             Image {
@@ -131,6 +131,16 @@ Widgets.NavigableFocusScope {
         property int shiftIndex: -1
         property string mode: "normal"
 
+        /* the model exposes rows in windows: load the next one before the
+         * view runs out of content */
+        onContentYChanged: loadMoreIfNeeded()
+        onContentHeightChanged: loadMoreIfNeeded()
+
+        function loadMoreIfNeeded() {
+            if (contentY + height * 2 >= contentHeight)
+                root.plmodel.fetchMoreRows()
+        }
+
         Connections {
             target: root.plmodel
             onRowsInserted: {
@@ -0,0 +1,71 @@
+/*****************************************************************************
+ * Copyright (C) 2019 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * ( at your option ) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "artwork_cache.hpp"
+
+#include <QImageReader>
+#include <QUrl>
+
+/* Decoded artwork kept across delegate recycling, in bytes */
+#define ARTWORK_CACHE_SIZE (32 * 1024 * 1024)
+
+ArtworkCacheProvider::ArtworkCacheProvider()
+    : QQuickImageProvider(QQuickImageProvider::Image,
+                          QQmlImageProviderBase::ForceAsynchronousImageLoading)
+    , m_cache(ARTWORK_CACHE_SIZE)
+{
+}
+
+QImage ArtworkCacheProvider::requestImage(const QString &id, QSize *size,
+                                          const QSize &requestedSize)
+{
+    const QString key = QString("%1@%2x%3").arg(id)
+        .arg(requestedSize.width()).arg(requestedSize.height());
+
+    {
+        QMutexLocker locker(&m_lock);
+        const QImage *cached = m_cache.object(key);
+        if (cached)
+        {
+            *size = cached->size();
+            return *cached;
+        }
+    }
+
+    const QUrl url(id);
+    if (!url.isLocalFile())
+        /* remote artwork is left to the regular image pipeline */
+        return {};
+
+    QImageReader reader(url.toLocalFile());
+    const QSize dimensions = reader.size();
+    if (requestedSize.width() > 0 && requestedSize.height() > 0
+     && dimensions.isValid())
+        /* decode directly to the displayed size */
+        reader.setScaledSize(dimensions.scaled(requestedSize,
+                                               Qt::KeepAspectRatio));
+
+    QImage image = reader.read();
+    if (image.isNull())
+        return image;
+    *size = image.size();
+
+    QMutexLocker locker(&m_lock);
+    m_cache.insert(key, new QImage(image), image.sizeInBytes());
+    return image;
+}
@@ -0,0 +1,43 @@
+/*****************************************************************************
+ * Copyright (C) 2019 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * ( at your option ) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef ARTWORK_CACHE_HPP
+#define ARTWORK_CACHE_HPP
+
+#include <QQuickImageProvider>
+#include <QCache>
+#include <QMutex>
+
+/**
+ * "image://artwork/" provider decoding and scaling item artwork off the
+ * UI thread, with a bounded cache keyed by artwork URL and display size.
+ */
+class ArtworkCacheProvider : public QQuickImageProvider
+{
+public:
+    ArtworkCacheProvider();
+
+    QImage requestImage(const QString &id, QSize *size,
+                        const QSize &requestedSize) override;
+
+private:
+    QMutex m_lock;
+    QCache<QString, QImage> m_cache;
+};
+
+#endif // ARTWORK_CACHE_HPP
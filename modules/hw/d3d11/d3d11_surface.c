@@ -51,13 +51,28 @@
 #define CAN_PROCESSOR 0
 #endif
 
-typedef struct
+/* Number of staging textures cycled through for GPU to CPU readback. The
+ * copy into a slot gets a few frames of GPU time before that slot is mapped,
+ * so Map() no longer synchronizes with an in-flight copy in steady state. */
+#define STAGING_POOL_SIZE 3
+
+struct staging_slot
 {
-    copy_cache_t     cache;
     union {
         ID3D11Texture2D  *staging;
         ID3D11Resource   *staging_resource;
     };
+    picture_t        *src; /**< source picture copied into this slot */
+};
+
+typedef struct
+{
+    copy_cache_t     cache;
+    struct staging_slot staging_pool[STAGING_POOL_SIZE];
+    unsigned         staging_write; /**< next slot to copy into */
+    unsigned         staging_count; /**< slots holding an in-flight copy */
+    void (*convert)(filter_t *, const D3D11_MAPPED_SUBRESOURCE *,
+                    const D3D11_TEXTURE2D_DESC *, picture_t *, picture_t *);
     vlc_mutex_t      staging_lock;
 
 #if CAN_PROCESSOR
@@ -142,9 +157,37 @@ error:
 static HRESULT can_map(filter_sys_t *sys, ID3D11DeviceContext *context)
 {
     D3D11_MAPPED_SUBRESOURCE lock;
-    HRESULT hr = ID3D11DeviceContext_Map(context, sys->staging_resource, 0,
+    HRESULT hr = ID3D11DeviceContext_Map(context, sys->staging_pool[0].staging_resource, 0,
                                          D3D11_MAP_READ, 0, &lock);
-    ID3D11DeviceContext_Unmap(context, sys->staging_resource, 0);
+    ID3D11DeviceContext_Unmap(context, sys->staging_pool[0].staging_resource, 0);
+    return hr;
+}
+
+static void release_staging_pool(filter_sys_t *sys)
+{
+    for (unsigned i = 0; i < STAGING_POOL_SIZE; i++)
+        if (sys->staging_pool[i].staging)
+        {
+            ID3D11Texture2D_Release(sys->staging_pool[i].staging);
+            sys->staging_pool[i].staging = NULL;
+        }
+}
+
+static HRESULT create_staging_pool(d3d11_device_t *d3d_dev, filter_sys_t *sys,
+                                   const D3D11_TEXTURE2D_DESC *texDesc)
+{
+    HRESULT hr = S_OK;
+
+    for (unsigned i = 0; i < STAGING_POOL_SIZE; i++)
+    {
+        hr = ID3D11Device_CreateTexture2D( d3d_dev->d3ddevice, texDesc, NULL,
+                                           &sys->staging_pool[i].staging );
+        if (FAILED(hr))
+        {
+            release_staging_pool(sys);
+            break;
+        }
+    }
     return hr;
 }
 
@@ -152,7 +195,7 @@ static int assert_staging(filter_t *p_filter, filter_sys_t *sys, DXGI_FORMAT for
 {
     HRESULT hr;
 
-    if (sys->staging)
+    if (sys->staging_pool[0].staging)
         goto ok;
 
     D3D11_TEXTURE2D_DESC texDesc;
@@ -169,8 +212,7 @@ static int assert_staging(filter_t *p_filter, filter_sys_t *sys, DXGI_FORMAT for
     texDesc.BindFlags = 0;
 
     d3d11_device_t *d3d_dev = sys->d3d_dev;
-    sys->staging = NULL;
-    hr = ID3D11Device_CreateTexture2D( d3d_dev->d3ddevice, &texDesc, NULL, &sys->staging);
+    hr = create_staging_pool(d3d_dev, sys, &texDesc);
     /* test if mapping the texture works ref #18746 */
     if (SUCCEEDED(hr) && FAILED(hr = can_map(sys, d3d_dev->d3dcontext)))
         msg_Dbg(p_filter, "can't map default staging texture (hr=0x%lX)", hr);
@@ -183,8 +225,9 @@ static int assert_staging(filter_t *p_filter, filter_sys_t *sys, DXGI_FORMAT for
         if (new_fmt && texDesc.Format != new_fmt->formatTexture)
         {
             DXGI_FORMAT srcFormat = texDesc.Format;
+            release_staging_pool(sys);
             texDesc.Format = new_fmt->formatTexture;
-            hr = ID3D11Device_CreateTexture2D( d3d_dev->d3ddevice, &texDesc, NULL, &sys->staging);
+            hr = create_staging_pool(d3d_dev, sys, &texDesc);
             if (SUCCEEDED(hr))
             {
                 texDesc.Usage = D3D11_USAGE_DEFAULT;
@@ -196,8 +239,7 @@ static int assert_staging(filter_t *p_filter, filter_sys_t *sys, DXGI_FORMAT for
                     if (SetupProcessor(p_filter, d3d_dev, srcFormat, new_fmt->formatTexture))
                     {
                         ID3D11Texture2D_Release(sys->procOutTexture);
-                        ID3D11Texture2D_Release(sys->staging);
-                        sys->staging = NULL;
+                        release_staging_pool(sys);
                         hr = E_FAIL;
                     }
                     else
@@ -206,8 +248,7 @@ static int assert_staging(filter_t *p_filter, filter_sys_t *sys, DXGI_FORMAT for
                 else
                 {
                     msg_Dbg(p_filter, "can't create intermediate texture (hr=0x%lX)", hr);
-                    ID3D11Texture2D_Release(sys->staging);
-                    sys->staging = NULL;
+                    release_staging_pool(sys);
                 }
             }
         }
@@ -221,22 +262,17 @@ ok:
     return VLC_SUCCESS;
 }
 
-static void D3D11_YUY2(filter_t *p_filter, picture_t *src, picture_t *dst)
+/**
+ * Queues the GPU copy of \p src into the next staging slot. The slot keeps a
+ * reference on \p src until it is drained, so the frame properties can be
+ * carried over to the CPU picture produced later.
+ */
+static int StageToPool(filter_t *p_filter, picture_t *src)
 {
-    if (src->context == NULL)
-    {
-        /* the previous stages creating a D3D11 picture should always fill the context */
-        msg_Err(p_filter, "missing source context");
-        return;
-    }
-
     filter_sys_t *sys = p_filter->p_sys;
     picture_sys_d3d11_t *p_sys = ActiveD3D11PictureSys(src);
+    struct staging_slot *slot = &sys->staging_pool[sys->staging_write];
 
-    D3D11_TEXTURE2D_DESC desc;
-    D3D11_MAPPED_SUBRESOURCE lock;
-
-    vlc_mutex_lock(&sys->staging_lock);
     UINT srcSlice = p_sys->slice_index;
     ID3D11Resource *srcResource = p_sys->resource[KNOWN_DXGI_INDEX];
 
@@ -245,7 +281,7 @@ static void D3D11_YUY2(filter_t *p_filter, picture_t *src, picture_t *dst)
     {
         HRESULT hr;
         if (FAILED( D3D11_Assert_ProcessorInput(p_filter, &sys->d3d_proc, p_sys) ))
-            return;
+            return VLC_EGENERIC;
 
         D3D11_VIDEO_PROCESSOR_STREAM stream = {
             .Enable = TRUE,
@@ -258,200 +294,201 @@ static void D3D11_YUY2(filter_t *p_filter, picture_t *src, picture_t *dst)
         if (FAILED(hr))
         {
             msg_Err(p_filter, "Failed to process the video. (hr=0x%lX)", hr);
-            vlc_mutex_unlock(&sys->staging_lock);
-            return;
+            return VLC_EGENERIC;
         }
 
         srcResource = sys->procOutResource;
         srcSlice = 0;
     }
 #endif
-    ID3D11DeviceContext_CopySubresourceRegion(sys->d3d_dev->d3dcontext, sys->staging_resource,
+    ID3D11DeviceContext_CopySubresourceRegion(sys->d3d_dev->d3dcontext, slot->staging_resource,
                                               0, 0, 0, 0,
                                               srcResource,
                                               srcSlice,
                                               NULL);
+    /* kick the copy off now, the slot will only be mapped a few frames later */
+    ID3D11DeviceContext_Flush(sys->d3d_dev->d3dcontext);
+
+    slot->src = picture_Hold(src);
+    sys->staging_write = (sys->staging_write + 1) % STAGING_POOL_SIZE;
+    sys->staging_count++;
+    return VLC_SUCCESS;
+}
+
+/**
+ * Maps the oldest staged slot and converts it to a CPU picture. Unless the
+ * pool is full, a slot whose copy is still in flight is left alone rather
+ * than stalling the pipeline (NULL is returned, the frame comes out on a
+ * later call).
+ */
+static picture_t *DrainStaging(filter_t *p_filter)
+{
+    filter_sys_t *sys = p_filter->p_sys;
+    unsigned read = (sys->staging_write + STAGING_POOL_SIZE - sys->staging_count)
+                    % STAGING_POOL_SIZE;
+    struct staging_slot *slot = &sys->staging_pool[read];
+    D3D11_TEXTURE2D_DESC desc;
+    D3D11_MAPPED_SUBRESOURCE lock;
+    UINT flags = sys->staging_count < STAGING_POOL_SIZE ? D3D11_MAP_FLAG_DO_NOT_WAIT : 0;
 
-    HRESULT hr = ID3D11DeviceContext_Map(sys->d3d_dev->d3dcontext, sys->staging_resource,
-                                         0, D3D11_MAP_READ, 0, &lock);
+    HRESULT hr = ID3D11DeviceContext_Map(sys->d3d_dev->d3dcontext, slot->staging_resource,
+                                         0, D3D11_MAP_READ, flags, &lock);
+    if (hr == DXGI_ERROR_WAS_STILL_DRAWING)
+        return NULL;
+
+    picture_t *dst = NULL;
     if (FAILED(hr)) {
         msg_Err(p_filter, "Failed to map source surface. (hr=0x%lX)", hr);
-        vlc_mutex_unlock(&sys->staging_lock);
-        return;
+    } else {
+        dst = filter_NewPicture(p_filter);
+        if (dst != NULL)
+        {
+            ID3D11Texture2D_GetDesc(slot->staging, &desc);
+            sys->convert(p_filter, &lock, &desc, slot->src, dst);
+            picture_CopyProperties(dst, slot->src);
+        }
+        ID3D11DeviceContext_Unmap(sys->d3d_dev->d3dcontext, slot->staging_resource, 0);
     }
 
+    picture_Release(slot->src);
+    slot->src = NULL;
+    sys->staging_count--;
+    return dst;
+}
+
+static void D3D11_YUY2(filter_t *p_filter, const D3D11_MAPPED_SUBRESOURCE *lock,
+                       const D3D11_TEXTURE2D_DESC *desc,
+                       picture_t *src, picture_t *dst)
+{
+    filter_sys_t *sys = p_filter->p_sys;
+
     if (dst->format.i_chroma == VLC_CODEC_I420)
         picture_SwapUV( dst );
 
-    ID3D11Texture2D_GetDesc(sys->staging, &desc);
-
-    if (desc.Format == DXGI_FORMAT_YUY2) {
-        size_t chroma_pitch = (lock.RowPitch / 2);
+    if (desc->Format == DXGI_FORMAT_YUY2) {
+        size_t chroma_pitch = (lock->RowPitch / 2);
 
         const size_t pitch[3] = {
-            lock.RowPitch,
+            lock->RowPitch,
             chroma_pitch,
             chroma_pitch,
         };
 
         const uint8_t *plane[3] = {
-            (uint8_t*)lock.pData,
-            (uint8_t*)lock.pData + pitch[0] * desc.Height,
-            (uint8_t*)lock.pData + pitch[0] * desc.Height
-                                 + pitch[1] * desc.Height / 2,
+            (uint8_t*)lock->pData,
+            (uint8_t*)lock->pData + pitch[0] * desc->Height,
+            (uint8_t*)lock->pData + pitch[0] * desc->Height
+                                  + pitch[1] * desc->Height / 2,
         };
 
         Copy420_P_to_P(dst, plane, pitch,
                        src->format.i_visible_height + src->format.i_y_offset,
                        &sys->cache);
-    } else if (desc.Format == DXGI_FORMAT_NV12 ||
-               desc.Format == DXGI_FORMAT_P010) {
+    } else if (desc->Format == DXGI_FORMAT_NV12 ||
+               desc->Format == DXGI_FORMAT_P010) {
         const uint8_t *plane[2] = {
-            lock.pData,
-            (uint8_t*)lock.pData + lock.RowPitch * desc.Height
+            lock->pData,
+            (uint8_t*)lock->pData + lock->RowPitch * desc->Height
         };
         const size_t  pitch[2] = {
-            lock.RowPitch,
-            lock.RowPitch,
+            lock->RowPitch,
+            lock->RowPitch,
         };
-        if (desc.Format == DXGI_FORMAT_NV12)
+        if (desc->Format == DXGI_FORMAT_NV12)
             Copy420_SP_to_P(dst, plane, pitch,
-                            __MIN(desc.Height, src->format.i_y_offset + src->format.i_visible_height),
+                            __MIN(desc->Height, src->format.i_y_offset + src->format.i_visible_height),
                             &sys->cache);
         else
             Copy420_16_SP_to_P(dst, plane, pitch,
-                               __MIN(desc.Height, src->format.i_y_offset + src->format.i_visible_height),
+                               __MIN(desc->Height, src->format.i_y_offset + src->format.i_visible_height),
                                6, &sys->cache);
         picture_SwapUV(dst);
     } else {
-        msg_Err(p_filter, "Unsupported D3D11VA conversion from 0x%08X to YV12", desc.Format);
+        msg_Err(p_filter, "Unsupported D3D11VA conversion from 0x%08X to YV12", desc->Format);
     }
 
     if (dst->format.i_chroma == VLC_CODEC_I420 || dst->format.i_chroma == VLC_CODEC_I420_10L)
         picture_SwapUV( dst );
-
-    /* */
-    ID3D11DeviceContext_Unmap(sys->d3d_dev->d3dcontext, sys->staging_resource, 0);
-    vlc_mutex_unlock(&sys->staging_lock);
 }
 
-static void D3D11_NV12(filter_t *p_filter, picture_t *src, picture_t *dst)
+static void D3D11_NV12(filter_t *p_filter, const D3D11_MAPPED_SUBRESOURCE *lock,
+                       const D3D11_TEXTURE2D_DESC *desc,
+                       picture_t *src, picture_t *dst)
 {
-    if (src->context == NULL)
-    {
-        /* the previous stages creating a D3D11 picture should always fill the context */
-        msg_Err(p_filter, "missing source context");
-        return;
-    }
-
     filter_sys_t *sys = p_filter->p_sys;
-    picture_sys_d3d11_t *p_sys = ActiveD3D11PictureSys(src);
 
-    D3D11_TEXTURE2D_DESC desc;
-    D3D11_MAPPED_SUBRESOURCE lock;
-
-    vlc_mutex_lock(&sys->staging_lock);
-    UINT srcSlice = p_sys->slice_index;
-    ID3D11Resource *srcResource = p_sys->resource[KNOWN_DXGI_INDEX];
-
-#if CAN_PROCESSOR
-    if (sys->d3d_proc.procEnumerator)
-    {
-        HRESULT hr;
-        if (FAILED( D3D11_Assert_ProcessorInput(p_filter, &sys->d3d_proc, p_sys) ))
-            return;
-
-        D3D11_VIDEO_PROCESSOR_STREAM stream = {
-            .Enable = TRUE,
-            .pInputSurface = p_sys->processorInput,
-        };
-
-        hr = ID3D11VideoContext_VideoProcessorBlt(sys->d3d_proc.d3dvidctx, sys->d3d_proc.videoProcessor,
-                                                          sys->processorOutput,
-                                                          0, 1, &stream);
-        if (FAILED(hr))
-        {
-            msg_Err(p_filter, "Failed to process the video. (hr=0x%lX)", hr);
-            vlc_mutex_unlock(&sys->staging_lock);
-            return;
-        }
-
-        srcResource = sys->procOutResource;
-        srcSlice = 0;
-    }
-#endif
-    ID3D11DeviceContext_CopySubresourceRegion(sys->d3d_dev->d3dcontext, sys->staging_resource,
-                                              0, 0, 0, 0,
-                                              srcResource,
-                                              srcSlice,
-                                              NULL);
-
-    HRESULT hr = ID3D11DeviceContext_Map(sys->d3d_dev->d3dcontext, sys->staging_resource,
-                                         0, D3D11_MAP_READ, 0, &lock);
-    if (FAILED(hr)) {
-        msg_Err(p_filter, "Failed to map source surface. (hr=0x%lX)", hr);
-        vlc_mutex_unlock(&sys->staging_lock);
-        return;
-    }
-
-    ID3D11Texture2D_GetDesc(sys->staging, &desc);
-
-    if (desc.Format == DXGI_FORMAT_NV12 || desc.Format == DXGI_FORMAT_P010) {
+    if (desc->Format == DXGI_FORMAT_NV12 || desc->Format == DXGI_FORMAT_P010) {
         const uint8_t *plane[2] = {
-            lock.pData,
-            (uint8_t*)lock.pData + lock.RowPitch * desc.Height
+            lock->pData,
+            (uint8_t*)lock->pData + lock->RowPitch * desc->Height
         };
         size_t  pitch[2] = {
-            lock.RowPitch,
-            lock.RowPitch,
+            lock->RowPitch,
+            lock->RowPitch,
         };
         Copy420_SP_to_SP(dst, plane, pitch,
-                         __MIN(desc.Height, src->format.i_y_offset + src->format.i_visible_height),
+                         __MIN(desc->Height, src->format.i_y_offset + src->format.i_visible_height),
                          &sys->cache);
     } else {
-        msg_Err(p_filter, "Unsupported D3D11VA conversion from 0x%08X to NV12", desc.Format);
+        msg_Err(p_filter, "Unsupported D3D11VA conversion from 0x%08X to NV12", desc->Format);
     }
+}
 
-    /* */
-    ID3D11DeviceContext_Unmap(sys->d3d_dev->d3dcontext, sys->staging_resource, 0);
-    vlc_mutex_unlock(&sys->staging_lock);
+static void D3D11_RGBA(filter_t *p_filter, const D3D11_MAPPED_SUBRESOURCE *lock,
+                       const D3D11_TEXTURE2D_DESC *desc,
+                       picture_t *src, picture_t *dst)
+{
+    VLC_UNUSED(p_filter); VLC_UNUSED(src);
+
+    plane_t src_planes  = dst->p[0];
+    src_planes.i_lines  = desc->Height;
+    src_planes.i_pitch  = lock->RowPitch;
+    src_planes.p_pixels = lock->pData;
+    plane_CopyPixels( dst->p, &src_planes );
 }
 
-static void D3D11_RGBA(filter_t *p_filter, picture_t *src, picture_t *dst)
+static picture_t *D3D11_StagedFilter(filter_t *p_filter, picture_t *src)
 {
     filter_sys_t *sys = p_filter->p_sys;
-    assert(src->context != NULL);
-    picture_sys_d3d11_t *p_sys = ActiveD3D11PictureSys(src);
+    picture_t *dst;
 
-    D3D11_TEXTURE2D_DESC desc;
-    D3D11_MAPPED_SUBRESOURCE lock;
+    if (src->context == NULL)
+    {
+        /* the previous stages creating a D3D11 picture should always fill the context */
+        msg_Err(p_filter, "missing source context");
+        picture_Release(src);
+        return NULL;
+    }
 
     vlc_mutex_lock(&sys->staging_lock);
-    ID3D11DeviceContext_CopySubresourceRegion(sys->d3d_dev->d3dcontext, sys->staging_resource,
-                                              0, 0, 0, 0,
-                                              p_sys->resource[KNOWN_DXGI_INDEX],
-                                              p_sys->slice_index,
-                                              NULL);
-
-    HRESULT hr = ID3D11DeviceContext_Map(sys->d3d_dev->d3dcontext, sys->staging_resource,
-                                         0, D3D11_MAP_READ, 0, &lock);
-    if (FAILED(hr)) {
-        msg_Err(p_filter, "Failed to map source surface. (hr=0x%lX)", hr);
+    if (StageToPool(p_filter, src) != VLC_SUCCESS)
+    {
         vlc_mutex_unlock(&sys->staging_lock);
-        return;
+        picture_Release(src);
+        return NULL;
     }
+    picture_Release(src);
+
+    dst = DrainStaging(p_filter);
+    vlc_mutex_unlock(&sys->staging_lock);
+    return dst;
+}
 
-    ID3D11Texture2D_GetDesc(sys->staging, &desc);
+static void D3D11_StagedFlush(filter_t *p_filter)
+{
+    filter_sys_t *sys = p_filter->p_sys;
 
-    plane_t src_planes  = dst->p[0];
-    src_planes.i_lines  = desc.Height;
-    src_planes.i_pitch  = lock.RowPitch;
-    src_planes.p_pixels = lock.pData;
-    plane_CopyPixels( dst->p, &src_planes );
+    vlc_mutex_lock(&sys->staging_lock);
+    while (sys->staging_count > 0)
+    {
+        unsigned read = (sys->staging_write + STAGING_POOL_SIZE - sys->staging_count)
+                        % STAGING_POOL_SIZE;
+        struct staging_slot *slot = &sys->staging_pool[read];
 
-    /* */
-    ID3D11DeviceContext_Unmap(sys->d3d_dev->d3dcontext,
-                              p_sys->resource[KNOWN_DXGI_INDEX], p_sys->slice_index);
+        picture_Release(slot->src);
+        slot->src = NULL;
+        sys->staging_count--;
+    }
     vlc_mutex_unlock(&sys->staging_lock);
 }
 
@@ -583,10 +620,6 @@ static void NV12_D3D11(filter_t *p_filter, picture_t *src, picture_t *dst)
     dst->i_planes = 0;
 }
 
-VIDEO_FILTER_WRAPPER (D3D11_NV12)
-VIDEO_FILTER_WRAPPER (D3D11_YUY2)
-VIDEO_FILTER_WRAPPER (D3D11_RGBA)
-
 static picture_t *AllocateCPUtoGPUTexture(filter_t *p_filter)
 {
     video_format_t fmt_staging;
@@ -669,48 +702,53 @@ int D3D11OpenConverter( vlc_object_t *obj )
          || p_filter->fmt_in.video.i_width != p_filter->fmt_out.video.i_width )
         return VLC_EGENERIC;
 
+    void (*convert)(filter_t *, const D3D11_MAPPED_SUBRESOURCE *,
+                    const D3D11_TEXTURE2D_DESC *, picture_t *, picture_t *);
     uint8_t pixel_bytes = 1;
     switch( p_filter->fmt_out.video.i_chroma ) {
     case VLC_CODEC_I420:
     case VLC_CODEC_YV12:
         if( p_filter->fmt_in.video.i_chroma != VLC_CODEC_D3D11_OPAQUE )
             return VLC_EGENERIC;
-        p_filter->pf_video_filter = D3D11_YUY2_Filter;
+        convert = D3D11_YUY2;
         break;
     case VLC_CODEC_I420_10L:
         if( p_filter->fmt_in.video.i_chroma != VLC_CODEC_D3D11_OPAQUE_10B )
             return VLC_EGENERIC;
-        p_filter->pf_video_filter = D3D11_YUY2_Filter;
+        convert = D3D11_YUY2;
         pixel_bytes = 2;
         break;
     case VLC_CODEC_NV12:
         if( p_filter->fmt_in.video.i_chroma != VLC_CODEC_D3D11_OPAQUE )
             return VLC_EGENERIC;
-        p_filter->pf_video_filter = D3D11_NV12_Filter;
+        convert = D3D11_NV12;
         break;
     case VLC_CODEC_P010:
         if( p_filter->fmt_in.video.i_chroma != VLC_CODEC_D3D11_OPAQUE_10B )
             return VLC_EGENERIC;
-        p_filter->pf_video_filter = D3D11_NV12_Filter;
+        convert = D3D11_NV12;
         pixel_bytes = 2;
         break;
     case VLC_CODEC_RGBA:
         if( p_filter->fmt_in.video.i_chroma != VLC_CODEC_D3D11_OPAQUE_RGBA )
             return VLC_EGENERIC;
-        p_filter->pf_video_filter = D3D11_RGBA_Filter;
+        convert = D3D11_RGBA;
         break;
     case VLC_CODEC_BGRA:
         if( p_filter->fmt_in.video.i_chroma != VLC_CODEC_D3D11_OPAQUE_BGRA )
             return VLC_EGENERIC;
-        p_filter->pf_video_filter = D3D11_RGBA_Filter;
+        convert = D3D11_RGBA;
         break;
     default:
         return VLC_EGENERIC;
     }
+    p_filter->pf_video_filter = D3D11_StagedFilter;
+    p_filter->pf_flush = D3D11_StagedFlush;
 
     filter_sys_t *p_sys = vlc_obj_calloc(obj, 1, sizeof(filter_sys_t));
     if (!p_sys)
         return VLC_ENOMEM;
+    p_sys->convert = convert;
 
     d3d11_video_context_t *vctx_sys = GetD3D11ContextPrivate(p_filter->vctx_in);
     d3d11_decoder_device_t *dev_sys = GetD3D11OpaqueContext(p_filter->vctx_in);
@@ -833,8 +871,8 @@ void D3D11CloseConverter( vlc_object_t *obj )
     D3D11_ReleaseProcessor( &p_sys->d3d_proc );
 #endif
     CopyCleanCache(&p_sys->cache);
-    if (p_sys->staging)
-        ID3D11Texture2D_Release(p_sys->staging);
+    D3D11_StagedFlush(p_filter);
+    release_staging_pool(p_sys);
 }
 
 void D3D11CloseCPUConverter( vlc_object_t *obj )
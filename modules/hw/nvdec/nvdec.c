@@ -112,6 +112,11 @@ typedef struct nvdec_ctx {
     bool                        b_nvparser_success;
     size_t                      decoderHeight;
 
+    CUVIDDECODECREATEINFO       dparams; ///< parameters of the current cudecoder
+    CUstream                    copyStream; ///< persistent stream for copies (NULL: default stream)
+    void                        *stagingHost; ///< pinned staging buffer for the copy-out path
+    size_t                      stagingSize;
+
     unsigned int                outputPitch;
     nvdec_pool_t                *out_pool;
 
@@ -126,6 +131,133 @@ typedef struct nvdec_ctx {
 #define NVDEC_PICPOOLCTX_FROM_PICCTX(pic_ctx)  \
     container_of(NVDEC_PICCONTEXT_FROM_PICCTX(pic_ctx), pic_pool_context_nvdec_t, ctx)
 
+/*
+ * Process-wide pool of idle CUvideodecoder instances. Creating a decoder
+ * costs ~150ms of driver round-trips, which dominates channel change time:
+ * instead of destroying the instance when a stream stops, park it here and
+ * hand it back to the next stream using the same CUDA context and the same
+ * decoding parameters. Each entry keeps its own function tables loaded so
+ * the instance can outlive the decoder module that created it; entries are
+ * destroyed when evicted or when their CUDA context is torn down.
+ */
+typedef struct nvdec_cached_decoder {
+    CUcontext               cuCtx; ///< NULL when the slot is empty
+    CUvideodecoder          cudecoder;
+    CUVIDDECODECREATEINFO   params;
+    CudaFunctions           *cudaFunctions;
+    CuvidFunctions          *cuvidFunctions;
+} nvdec_cached_decoder_t;
+
+#define DECODER_CACHE_SIZE 2
+
+static struct {
+    vlc_mutex_t             lock;
+    nvdec_cached_decoder_t  entry[DECODER_CACHE_SIZE];
+} decoder_cache = { .lock = VLC_STATIC_MUTEX };
+
+static bool DecoderParamsMatch(const CUVIDDECODECREATEINFO *a,
+                               const CUVIDDECODECREATEINFO *b)
+{
+    return a->CodecType == b->CodecType
+        && a->ChromaFormat == b->ChromaFormat
+        && a->bitDepthMinus8 == b->bitDepthMinus8
+        && a->OutputFormat == b->OutputFormat
+        && a->ulWidth == b->ulWidth
+        && a->ulHeight == b->ulHeight
+        && a->ulTargetWidth == b->ulTargetWidth
+        && a->ulTargetHeight == b->ulTargetHeight
+        && a->ulNumDecodeSurfaces == b->ulNumDecodeSurfaces
+        && a->ulNumOutputSurfaces == b->ulNumOutputSurfaces
+        && a->DeinterlaceMode == b->DeinterlaceMode;
+}
+
+/* Destroys a cached instance with its own function tables (there may be no
+   decoder object left to log errors to, so they are ignored like in
+   DecoderContextClose()). The cache lock must be held. */
+static void CachedDecoderDestroy(nvdec_cached_decoder_t *entry)
+{
+    entry->cudaFunctions->cuCtxPushCurrent(entry->cuCtx);
+    entry->cuvidFunctions->cuvidDestroyDecoder(entry->cudecoder);
+    entry->cudaFunctions->cuCtxPopCurrent(NULL);
+    cuvid_free_functions(&entry->cuvidFunctions);
+    cuda_free_functions(&entry->cudaFunctions);
+    entry->cudecoder = NULL;
+    entry->cuCtx = NULL;
+}
+
+static CUvideodecoder DecoderCacheGet(CUcontext cuCtx,
+                                      const CUVIDDECODECREATEINFO *params)
+{
+    CUvideodecoder cudecoder = NULL;
+
+    vlc_mutex_lock(&decoder_cache.lock);
+    for (size_t i = 0; i < ARRAY_SIZE(decoder_cache.entry); i++)
+    {
+        nvdec_cached_decoder_t *entry = &decoder_cache.entry[i];
+        if (entry->cuCtx == cuCtx
+         && DecoderParamsMatch(&entry->params, params))
+        {
+            cudecoder = entry->cudecoder;
+            entry->cudecoder = NULL;
+            entry->cuCtx = NULL;
+            cuvid_free_functions(&entry->cuvidFunctions);
+            cuda_free_functions(&entry->cudaFunctions);
+            break;
+        }
+    }
+    vlc_mutex_unlock(&decoder_cache.lock);
+    return cudecoder;
+}
+
+static bool DecoderCachePut(decoder_t *p_dec, CUcontext cuCtx,
+                            CUvideodecoder cudecoder,
+                            const CUVIDDECODECREATEINFO *params)
+{
+    CudaFunctions *cudaFunctions = NULL;
+    CuvidFunctions *cuvidFunctions = NULL;
+
+    if (cuda_load_functions(&cudaFunctions, p_dec) != VLC_SUCCESS)
+        return false;
+    if (cuvid_load_functions(&cuvidFunctions, p_dec) != VLC_SUCCESS)
+    {
+        cuda_free_functions(&cudaFunctions);
+        return false;
+    }
+
+    vlc_mutex_lock(&decoder_cache.lock);
+    for (size_t i = 0; i < ARRAY_SIZE(decoder_cache.entry); i++)
+    {
+        nvdec_cached_decoder_t *entry = &decoder_cache.entry[i];
+        if (entry->cuCtx != NULL)
+            continue;
+        entry->cuCtx = cuCtx;
+        entry->cudecoder = cudecoder;
+        entry->params = *params;
+        entry->cudaFunctions = cudaFunctions;
+        entry->cuvidFunctions = cuvidFunctions;
+        vlc_mutex_unlock(&decoder_cache.lock);
+        return true;
+    }
+    vlc_mutex_unlock(&decoder_cache.lock);
+
+    cuvid_free_functions(&cuvidFunctions);
+    cuda_free_functions(&cudaFunctions);
+    return false;
+}
+
+/* Drops cached instances bound to a CUDA context about to be destroyed */
+static void DecoderCachePurge(CUcontext cuCtx)
+{
+    vlc_mutex_lock(&decoder_cache.lock);
+    for (size_t i = 0; i < ARRAY_SIZE(decoder_cache.entry); i++)
+    {
+        nvdec_cached_decoder_t *entry = &decoder_cache.entry[i];
+        if (entry->cuCtx == cuCtx)
+            CachedDecoderDestroy(entry);
+    }
+    vlc_mutex_unlock(&decoder_cache.lock);
+}
+
 static void nvdec_pool_Destroy(nvdec_pool_t *pool)
 {
     for (size_t i=0; i < ARRAY_SIZE(pool->outputDevicePtr); i++)
@@ -377,7 +509,9 @@ static int CUDAAPI HandleVideoSequence(void *p_opaque, CUVIDEOFORMAT *p_format)
 
     if (p_sys->cudecoder)
     {
-        CALL_CUVID(cuvidDestroyDecoder, p_sys->cudecoder);
+        if (!DecoderCachePut(p_dec, p_sys->devsys->cuCtx, p_sys->cudecoder,
+                             &p_sys->dparams))
+            CALL_CUVID(cuvidDestroyDecoder, p_sys->cudecoder);
         p_sys->cudecoder = NULL;
     }
 
@@ -394,9 +528,16 @@ static int CUDAAPI HandleVideoSequence(void *p_opaque, CUVIDEOFORMAT *p_format)
         .ulNumOutputSurfaces = 1,
         .DeinterlaceMode     = p_sys->deintMode
     };
-    ret = CALL_CUVID(cuvidCreateDecoder, &p_sys->cudecoder, &dparams);
-    if (ret != VLC_SUCCESS)
-        goto cuda_error;
+    p_sys->cudecoder = DecoderCacheGet(p_sys->devsys->cuCtx, &dparams);
+    if (p_sys->cudecoder != NULL)
+        msg_Dbg(p_dec, "reusing pooled NVDEC decoder instance");
+    else
+    {
+        ret = CALL_CUVID(cuvidCreateDecoder, &p_sys->cudecoder, &dparams);
+        if (ret != VLC_SUCCESS)
+            goto cuda_error;
+    }
+    p_sys->dparams = dparams;
 
     // ensure the output surfaces have the same pitch so copies can work properly
     if ( is_nvdec_opaque(p_dec->fmt_out.video.i_chroma) )
@@ -523,7 +664,7 @@ static int CUDAAPI HandlePictureDisplay(void *p_opaque, CUVIDPARSERDISPINFO *p_d
                     .WidthInBytes   = i_pitch,
                     .Height         = __MIN(picctx->bufferHeight, p_dec->fmt_out.video.i_y_offset + p_dec->fmt_out.video.i_visible_height),
                 };
-                result = CALL_CUDA_DEC(cuMemcpy2DAsync, &cu_cpy, 0);
+                result = CALL_CUDA_DEC(cuMemcpy2DAsync, &cu_cpy, p_sys->copyStream);
                 if (unlikely(result != VLC_SUCCESS))
                     goto error;
 
@@ -548,7 +689,7 @@ static int CUDAAPI HandlePictureDisplay(void *p_opaque, CUVIDPARSERDISPINFO *p_d
                 };
                 if (i_plane == 1)
                     cu_cpy.Height >>= 1;
-                result = CALL_CUDA_DEC(cuMemcpy2DAsync, &cu_cpy, 0);
+                result = CALL_CUDA_DEC(cuMemcpy2DAsync, &cu_cpy, p_sys->copyStream);
                 if (unlikely(result != VLC_SUCCESS))
                     goto error;
 
@@ -578,8 +719,29 @@ static int CUDAAPI HandlePictureDisplay(void *p_opaque, CUVIDPARSERDISPINFO *p_d
         if (result != VLC_SUCCESS)
             goto error;
 
+        // Grow the pinned staging buffer if needed: DMA into pinned memory
+        // runs asynchronously, whereas copying straight into the pageable
+        // picture planes forces the driver to stage and block internally.
+        size_t staging_needed = 0;
+        for (int i_plane = 0; i_plane < p_pic->i_planes; i_plane++)
+            staging_needed += (size_t)i_pitch * p_pic->p[i_plane].i_visible_lines;
+        if (p_sys->stagingHost != NULL && p_sys->stagingSize < staging_needed)
+        {
+            CALL_CUDA_DEC(cuMemFreeHost, p_sys->stagingHost);
+            p_sys->stagingHost = NULL;
+        }
+        if (p_sys->stagingHost == NULL)
+        {
+            if (CALL_CUDA_DEC(cuMemHostAlloc, &p_sys->stagingHost,
+                              staging_needed, 0) != VLC_SUCCESS)
+                p_sys->stagingHost = NULL; // fall back to direct copies
+            else
+                p_sys->stagingSize = staging_needed;
+        }
+
         // Copy decoded frame into a new VLC picture
         size_t srcY = 0;
+        size_t stagingY = 0;
         for (int i_plane = 0; i_plane < p_pic->i_planes; i_plane++) {
             plane_t plane = p_pic->p[i_plane];
             CUDA_MEMCPY2D cu_cpy = {
@@ -593,15 +755,39 @@ static int CUDAAPI HandlePictureDisplay(void *p_opaque, CUVIDPARSERDISPINFO *p_d
                 .WidthInBytes   = i_pitch,
                 .Height         = plane.i_visible_lines,
             };
-            result = CALL_CUDA_DEC(cuMemcpy2DAsync, &cu_cpy, 0);
+            if (p_sys->stagingHost != NULL)
+            {
+                cu_cpy.dstHost = (uint8_t *)p_sys->stagingHost + stagingY;
+                cu_cpy.dstPitch = i_pitch;
+            }
+            result = CALL_CUDA_DEC(cuMemcpy2DAsync, &cu_cpy, p_sys->copyStream);
             if (result != VLC_SUCCESS)
                 goto error;
             srcY += p_sys->decoderHeight;
+            stagingY += (size_t)i_pitch * plane.i_visible_lines;
+        }
+
+        if (p_sys->stagingHost != NULL)
+        {
+            // Wait for the DMA, then scatter the rows to the picture planes
+            result = CALL_CUDA_DEC(cuStreamSynchronize, p_sys->copyStream);
+            if (unlikely(result != VLC_SUCCESS))
+                goto error;
+
+            const uint8_t *p_src = p_sys->stagingHost;
+            for (int i_plane = 0; i_plane < p_pic->i_planes; i_plane++) {
+                plane_t plane = p_pic->p[i_plane];
+                for (int i_line = 0; i_line < plane.i_visible_lines; i_line++)
+                    memcpy(&plane.p_pixels[i_line * plane.i_pitch],
+                           &p_src[(size_t)i_line * i_pitch],
+                           __MIN((unsigned)plane.i_pitch, i_pitch));
+                p_src += (size_t)i_pitch * plane.i_visible_lines;
+            }
         }
     }
 
     // Wait until copies are finished
-    result = CALL_CUDA_DEC(cuStreamSynchronize, 0);
+    result = CALL_CUDA_DEC(cuStreamSynchronize, p_sys->copyStream);
     if (unlikely(result != VLC_SUCCESS))
         goto error;
 
@@ -635,7 +821,7 @@ error:
         // Synchronize stream to wait for potentitally pending copies
         // then unmap the frame.
         // No need to check for errors, there is nothing we can do anyway
-        CALL_CUDA_DEC(cuStreamSynchronize, 0);
+        CALL_CUDA_DEC(cuStreamSynchronize, p_sys->copyStream);
         CALL_CUVID(cuvidUnmapVideoFrame, p_sys->cudecoder, frameDevicePtr);
     }
     CALL_CUDA_DEC(cuCtxPopCurrent, NULL);
@@ -915,6 +1101,16 @@ static int OpenDecoder(vlc_object_t *p_this)
         goto error;
     }
 
+    // Persistent stream for the copy-out path, so the transfers do not
+    // serialize with unrelated work on the default stream
+    result = CALL_CUDA_DEC(cuCtxPushCurrent, p_sys->devsys->cuCtx);
+    if (result == VLC_SUCCESS)
+    {
+        if (CALL_CUDA_DEC(cuStreamCreate, &p_sys->copyStream, 0) != VLC_SUCCESS)
+            p_sys->copyStream = NULL; // fall back to the default stream
+        CALL_CUDA_DEC(cuCtxPopCurrent, NULL);
+    }
+
     uint8_t i_depth_luma;
     cudaVideoChromaFormat cudaChroma;
 
@@ -1083,12 +1279,20 @@ static void CloseDecoder(vlc_object_t *p_this)
     decoder_t *p_dec = (decoder_t *) p_this;
     nvdec_ctx_t *p_sys = p_dec->p_sys;
     CALL_CUDA_DEC(cuCtxPushCurrent, p_sys->devsys->cuCtx);
+    if (p_sys->copyStream)
+        CALL_CUDA_DEC(cuStreamDestroy, p_sys->copyStream);
+    if (p_sys->stagingHost)
+        CALL_CUDA_DEC(cuMemFreeHost, p_sys->stagingHost);
     CALL_CUDA_DEC(cuCtxPopCurrent, NULL);
 
     if (p_sys->out_pool)
         nvdec_pool_Release(p_sys->out_pool);
     if (p_sys->cudecoder)
-        CALL_CUVID(cuvidDestroyDecoder, p_sys->cudecoder);
+    {
+        if (!DecoderCachePut(p_dec, p_sys->devsys->cuCtx, p_sys->cudecoder,
+                             &p_sys->dparams))
+            CALL_CUVID(cuvidDestroyDecoder, p_sys->cudecoder);
+    }
     if (p_sys->cuparser)
         CALL_CUVID(cuvidDestroyVideoParser, p_sys->cuparser);
     if (p_sys->vctx_out)
@@ -1103,7 +1307,10 @@ static void DecoderContextClose(vlc_decoder_device *device)
 {
     decoder_device_nvdec_t *p_sys = GetNVDECOpaqueDevice(device);
     if (p_sys->cuCtx)
+    {
+        DecoderCachePurge(p_sys->cuCtx);
         CALL_CUDA_DEV(cuCtxDestroy, p_sys->cuCtx);
+    }
     cuda_free_functions(&p_sys->cudaFunctions);
 }
 
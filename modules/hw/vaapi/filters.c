@@ -1120,6 +1120,287 @@ CloseDeinterlace(vlc_object_t * obj)
     Close(filter, filter_sys);
 }
 
+/*********************
+ * Scaling functions *
+ *********************/
+
+static picture_t *
+Scale(filter_t * filter, picture_t * src)
+{
+    filter_sys_t *const filter_sys = filter->p_sys;
+    VABufferID          pipeline_buf = VA_INVALID_ID;
+    picture_t *const    dest = picture_pool_Wait(filter_sys->dest_pics);
+    if (!dest)
+        return NULL;
+
+    vlc_vaapi_PicAttachContext(dest);
+    picture_CopyProperties(dest, src);
+
+    VARectangle const   src_region = {
+        .x = filter->fmt_in.video.i_x_offset,
+        .y = filter->fmt_in.video.i_y_offset,
+        .width = filter->fmt_in.video.i_visible_width,
+        .height = filter->fmt_in.video.i_visible_height
+    };
+    VARectangle const   dest_region = {
+        .x = filter->fmt_out.video.i_x_offset,
+        .y = filter->fmt_out.video.i_y_offset,
+        .width = filter->fmt_out.video.i_visible_width,
+        .height = filter->fmt_out.video.i_visible_height
+    };
+
+    if (vlc_vaapi_BeginPicture(VLC_OBJECT(filter),
+                               filter_sys->va.dpy, filter_sys->va.ctx,
+                               vlc_vaapi_PicGetSurface(dest)))
+        goto error;
+
+    VAProcPipelineParameterBuffer *     pipeline_params;
+
+    pipeline_buf =
+        vlc_vaapi_CreateBuffer(VLC_OBJECT(filter),
+                               filter_sys->va.dpy, filter_sys->va.ctx,
+                               VAProcPipelineParameterBufferType,
+                               sizeof(*pipeline_params), 1, NULL);
+    if (pipeline_buf == VA_INVALID_ID)
+        goto error;
+
+    if (vlc_vaapi_MapBuffer(VLC_OBJECT(filter), filter_sys->va.dpy,
+                            pipeline_buf, (void **)&pipeline_params))
+        goto error;
+
+    *pipeline_params = (typeof(*pipeline_params)){0};
+    pipeline_params->surface = vlc_vaapi_PicGetSurface(src);
+    pipeline_params->surface_region = &src_region;
+    pipeline_params->output_region = &dest_region;
+    pipeline_params->filter_flags = VA_FILTER_SCALING_HQ;
+
+    if (vlc_vaapi_UnmapBuffer(VLC_OBJECT(filter),
+                              filter_sys->va.dpy, pipeline_buf))
+        goto error;
+
+    if (vlc_vaapi_RenderPicture(VLC_OBJECT(filter),
+                                filter_sys->va.dpy, filter_sys->va.ctx,
+                                &pipeline_buf, 1))
+        goto error;
+
+    if (vlc_vaapi_EndPicture(VLC_OBJECT(filter),
+                             filter_sys->va.dpy, filter_sys->va.ctx))
+        goto error;
+
+    picture_Release(src);
+    return dest;
+
+error:
+    if (pipeline_buf != VA_INVALID_ID)
+        vlc_vaapi_DestroyBuffer(VLC_OBJECT(filter),
+                                filter_sys->va.dpy, pipeline_buf);
+    picture_Release(dest);
+    picture_Release(src);
+    return NULL;
+}
+
+static int
+OpenScale(vlc_object_t * obj)
+{
+    filter_t *const     filter = (filter_t *)obj;
+    filter_sys_t *      filter_sys;
+
+    if (filter->vctx_in == NULL ||
+        vlc_video_context_GetType(filter->vctx_in) != VLC_VIDEO_CONTEXT_VAAPI)
+        return VLC_EGENERIC;
+    if (!vlc_vaapi_IsChromaOpaque(filter->fmt_in.video.i_chroma) ||
+        filter->fmt_in.video.i_chroma != filter->fmt_out.video.i_chroma)
+        return VLC_EGENERIC;
+    if (filter->fmt_in.video.i_width == filter->fmt_out.video.i_width &&
+        filter->fmt_in.video.i_height == filter->fmt_out.video.i_height)
+        return VLC_EGENERIC;
+
+    filter_sys = calloc(1, sizeof(*filter_sys));
+    if (!filter_sys)
+        return VLC_ENOMEM;
+    filter->p_sys = filter_sys;
+
+    filter_sys->va.conf = VA_INVALID_ID;
+    filter_sys->va.ctx = VA_INVALID_ID;
+    filter_sys->va.buf = VA_INVALID_ID;
+    filter_sys->va.dec_device = vlc_video_context_HoldDevice(filter->vctx_in);
+    filter_sys->va.dpy = filter_sys->va.dec_device->opaque;
+
+    filter_sys->dest_pics =
+        vlc_vaapi_PoolNew(VLC_OBJECT(filter), filter->vctx_in,
+                          filter_sys->va.dpy, DEST_PICS_POOL_SZ,
+                          &filter_sys->va.surface_ids, &filter->fmt_out.video);
+    if (!filter_sys->dest_pics)
+        goto error;
+
+    filter_sys->va.conf =
+        vlc_vaapi_CreateConfigChecked(VLC_OBJECT(filter), filter_sys->va.dpy,
+                                      VAProfileNone, VAEntrypointVideoProc,
+                                      filter->fmt_out.video.i_chroma);
+    if (filter_sys->va.conf == VA_INVALID_ID)
+        goto error;
+
+    filter_sys->va.ctx =
+        vlc_vaapi_CreateContext(VLC_OBJECT(filter),
+                                filter_sys->va.dpy, filter_sys->va.conf,
+                                filter->fmt_out.video.i_width,
+                                filter->fmt_out.video.i_height,
+                                0, filter_sys->va.surface_ids,
+                                DEST_PICS_POOL_SZ);
+    if (filter_sys->va.ctx == VA_INVALID_ID)
+        goto error;
+
+    /* Scaling is performed by the VPP pipeline itself: no filter buffer. */
+
+    filter->vctx_out = vlc_video_context_Hold(filter->vctx_in);
+    filter->pf_video_filter = Scale;
+
+    return VLC_SUCCESS;
+
+error:
+    if (filter_sys->va.ctx != VA_INVALID_ID)
+        vlc_vaapi_DestroyContext(VLC_OBJECT(filter),
+                                 filter_sys->va.dpy, filter_sys->va.ctx);
+    if (filter_sys->va.conf != VA_INVALID_ID)
+        vlc_vaapi_DestroyConfig(VLC_OBJECT(filter),
+                                filter_sys->va.dpy, filter_sys->va.conf);
+    if (filter_sys->dest_pics)
+        picture_pool_Release(filter_sys->dest_pics);
+    if (filter_sys->va.dec_device)
+        vlc_decoder_device_Release(filter_sys->va.dec_device);
+    free(filter_sys);
+    return VLC_EGENERIC;
+}
+
+static void
+CloseScale(vlc_object_t * obj)
+{
+    filter_t *const     filter = (filter_t *)obj;
+    filter_sys_t *const filter_sys = filter->p_sys;
+
+    picture_pool_Release(filter_sys->dest_pics);
+    vlc_vaapi_DestroyContext(obj, filter_sys->va.dpy, filter_sys->va.ctx);
+    vlc_vaapi_DestroyConfig(obj, filter_sys->va.dpy, filter_sys->va.conf);
+    vlc_decoder_device_Release(filter_sys->va.dec_device);
+    vlc_video_context_Release(filter->vctx_out);
+    free(filter_sys);
+}
+
+/**************************
+ * Tone mapping functions *
+ **************************/
+
+#if VA_CHECK_VERSION(1, 3, 0)
+
+struct  tone_map_data
+{
+    /* Referenced by the VA filter parameter buffer, must outlive it */
+    VAHdrMetaDataHDR10  hdr10;
+};
+
+static void
+ToneMap_UpdatePipelineParams
+(void * p_data, VAProcPipelineParameterBuffer * pipeline_param)
+{ VLC_UNUSED(p_data);
+    pipeline_param->output_color_standard = VAProcColorStandardBT709;
+}
+
+static picture_t *
+ToneMap(filter_t * filter, picture_t * src)
+{
+    picture_t *const    dest =
+        Filter(filter, src, NULL, NULL, ToneMap_UpdatePipelineParams);
+    picture_Release(src);
+    return dest;
+}
+
+static int
+OpenToneMap_InitFilterParams(filter_t * filter, void * p_data,
+                             void ** pp_va_params,
+                             uint32_t * p_va_param_sz,
+                             uint32_t * p_num_va_params)
+{
+    struct tone_map_data *const p_tone_map_data = p_data;
+    video_format_t const *const fmt = &filter->fmt_in.video;
+    VAHdrMetaDataHDR10 *const   hdr10 = &p_tone_map_data->hdr10;
+
+    /* Both follow the SMPTE ST 2086 / CTA-861.3 conventions, including the
+       G,B,R primaries order and the 0.0001 cd/m2 luminance units. */
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        hdr10->display_primaries_x[i] = fmt->mastering.primaries[i * 2];
+        hdr10->display_primaries_y[i] = fmt->mastering.primaries[i * 2 + 1];
+    }
+    hdr10->white_point_x = fmt->mastering.white_point[0];
+    hdr10->white_point_y = fmt->mastering.white_point[1];
+    hdr10->max_display_mastering_luminance = fmt->mastering.max_luminance;
+    hdr10->min_display_mastering_luminance = fmt->mastering.min_luminance;
+    hdr10->max_content_light_level = fmt->lighting.MaxCLL;
+    hdr10->max_pic_average_light_level = fmt->lighting.MaxFALL;
+
+    VAProcFilterParameterBufferHDRToneMapping * p_va_param;
+
+    *p_va_param_sz = sizeof(*p_va_param);
+    *p_num_va_params = 1;
+
+    p_va_param = calloc(1, sizeof(*p_va_param));
+    if (!p_va_param)
+        return VLC_ENOMEM;
+
+    p_va_param->type = VAProcFilterHighDynamicRangeToneMapping;
+    p_va_param->data.metadata_type = VAProcHighDynamicRangeMetadataHDR10;
+    p_va_param->data.metadata = hdr10;
+    p_va_param->data.metadata_size = sizeof(*hdr10);
+    *pp_va_params = p_va_param;
+
+    return VLC_SUCCESS;
+}
+
+static int
+OpenToneMap(vlc_object_t * obj)
+{
+    VAProcPipelineCaps          pipeline_caps;
+    filter_t *const             filter = (filter_t *)obj;
+
+    if (filter->fmt_in.video.transfer != TRANSFER_FUNC_SMPTE_ST2084)
+        return VLC_EGENERIC;
+
+    struct tone_map_data *const p_data = calloc(1, sizeof(*p_data));
+    if (!p_data)
+        return VLC_ENOMEM;
+
+    if (Open(filter, VAProcFilterHighDynamicRangeToneMapping, &pipeline_caps,
+             p_data, OpenToneMap_InitFilterParams, NULL))
+    {
+        free(p_data);
+        return VLC_EGENERIC;
+    }
+
+    /* The driver outputs an SDR picture */
+    filter->fmt_out.video.transfer = TRANSFER_FUNC_BT709;
+    filter->fmt_out.video.primaries = COLOR_PRIMARIES_BT709;
+    memset(&filter->fmt_out.video.mastering, 0,
+           sizeof(filter->fmt_out.video.mastering));
+    memset(&filter->fmt_out.video.lighting, 0,
+           sizeof(filter->fmt_out.video.lighting));
+
+    filter->pf_video_filter = ToneMap;
+
+    return VLC_SUCCESS;
+}
+
+static void
+CloseToneMap(vlc_object_t * obj)
+{
+    filter_t *const     filter = (filter_t *)obj;
+    filter_sys_t *const filter_sys = filter->p_sys;
+
+    free(filter_sys->p_data);
+    Close(filter, filter_sys);
+}
+
+#endif /* VA_CHECK_VERSION(1, 3, 0) */
+
 /*********************
  * Module descriptor *
  *********************/
@@ -1152,6 +1433,16 @@ vlc_module_begin()
     set_callbacks(OpenSharpenFilter, CloseBasicFilter)
     add_shortcut("sharpen")
 
+#if VA_CHECK_VERSION(1, 3, 0)
+    add_submodule()
+    set_callbacks(OpenToneMap, CloseToneMap)
+    add_shortcut("tone-map")
+#endif
+
+    add_submodule()
+    set_capability("video converter", 10)
+    set_callbacks(OpenScale, CloseScale)
+
     add_submodule()
     set_capability("video converter", 10)
     set_callbacks(vlc_vaapi_OpenChroma, vlc_vaapi_CloseChroma)
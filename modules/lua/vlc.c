@@ -37,8 +37,12 @@
 
 #include <vlc_plugin.h>
 #include <vlc_arrays.h>
+#include <vlc_block.h>
 #include <vlc_charset.h>
+#include <vlc_configuration.h>
 #include <vlc_fs.h>
+#include <vlc_hash.h>
+#include <vlc_memstream.h>
 #include <vlc_services_discovery.h>
 #include <vlc_stream.h>
 
@@ -652,17 +656,170 @@ int vlclua_add_modules_path( lua_State *L, const char *psz_filename )
     return 0;
 }
 
+/*****************************************************************************
+ * Bytecode cache: a script is compiled once, then reloaded from the dumped
+ * chunk in the user cache directory (mapped read-only) on the next loads.
+ *****************************************************************************/
+
+#define LUAC_CACHE_MAGIC "VLCLUAC" /* 7 characters + NUL */
+
+typedef struct
+{
+    char     magic[8];   /* LUAC_CACHE_MAGIC */
+    uint64_t version;    /* LUA_VERSION_NUM */
+    uint64_t mtime;      /* source modification time */
+    uint64_t size;       /* source size */
+} luac_cache_header_t;
+
+static char *LuacCachePath( const char *path )
+{
+    char *dir = config_GetUserDir( VLC_CACHE_DIR );
+    if( dir == NULL )
+        return NULL;
+
+    vlc_hash_md5_t md5;
+    char hex[VLC_HASH_MD5_DIGEST_HEX_SIZE];
+    vlc_hash_md5_Init( &md5 );
+    vlc_hash_md5_Update( &md5, path, strlen( path ) );
+    vlc_hash_FinishHex( &md5, hex );
+
+    char *cache;
+    if( asprintf( &cache, "%s"DIR_SEP"luac"DIR_SEP"%s.luac",
+                  dir, hex ) == -1 )
+        cache = NULL;
+    free( dir );
+    return cache;
+}
+
+static int LuacCacheLoad( lua_State *L, const char *path,
+                          const struct stat *st )
+{
+    char *cache = LuacCachePath( path );
+    if( cache == NULL )
+        return 1;
+
+    block_t *map = block_FilePath( cache, false );
+    free( cache );
+    if( map == NULL )
+        return 1;
+
+    int ret = 1;
+    luac_cache_header_t header;
+    if( map->i_buffer > sizeof (header) )
+    {
+        memcpy( &header, map->p_buffer, sizeof (header) );
+        if( memcmp( header.magic, LUAC_CACHE_MAGIC, 8 ) == 0
+         && header.version == LUA_VERSION_NUM
+         && header.mtime == (uint64_t)st->st_mtime
+         && header.size == (uint64_t)st->st_size )
+        {
+            char *name;
+            if( asprintf( &name, "@%s", path ) != -1 )
+            {
+                ret = luaL_loadbuffer( L,
+                        (const char *)map->p_buffer + sizeof (header),
+                        map->i_buffer - sizeof (header), name );
+                if( ret )
+                    lua_pop( L, 1 ); /* drop the error, fall back to source */
+                free( name );
+            }
+        }
+    }
+    block_Release( map );
+    return ret;
+}
+
+static int LuacCacheWriter( lua_State *L, const void *p, size_t sz, void *ud )
+{
+    VLC_UNUSED(L);
+    struct vlc_memstream *ms = ud;
+    vlc_memstream_write( ms, p, sz );
+    return 0;
+}
+
+/** Dump the function at the top of the stack to the bytecode cache */
+static void LuacCacheStore( lua_State *L, const char *path,
+                            const struct stat *st )
+{
+    struct vlc_memstream ms;
+    if( vlc_memstream_open( &ms ) )
+        return;
+
+    luac_cache_header_t header = {
+        .version = LUA_VERSION_NUM,
+        .mtime = st->st_mtime,
+        .size = st->st_size,
+    };
+    memcpy( header.magic, LUAC_CACHE_MAGIC, 8 );
+    vlc_memstream_write( &ms, &header, sizeof (header) );
+
+#if LUA_VERSION_NUM >= 503
+    int ret = lua_dump( L, LuacCacheWriter, &ms, 0 );
+#else
+    int ret = lua_dump( L, LuacCacheWriter, &ms );
+#endif
+    if( vlc_memstream_close( &ms ) )
+        return;
+    if( ret )
+        goto out;
+
+    char *cache = LuacCachePath( path );
+    if( cache == NULL )
+        goto out;
+
+    char *sep = strrchr( cache, DIR_SEP_CHAR );
+    *sep = '\0';
+    vlc_mkdir( cache, 0700 ); /* best effort */
+    *sep = DIR_SEP_CHAR;
+
+    char *tmp;
+    if( asprintf( &tmp, "%s.tmp", cache ) != -1 )
+    {
+        FILE *f = vlc_fopen( tmp, "wb" );
+        if( f != NULL )
+        {
+            bool ok = fwrite( ms.ptr, 1, ms.length, f ) == ms.length;
+            if( fclose( f ) == 0 && ok )
+                vlc_rename( tmp, cache );
+            else
+                vlc_unlink( tmp );
+        }
+        free( tmp );
+    }
+    free( cache );
+out:
+    free( ms.ptr );
+}
+
+/** Equivalent of luaL_dofile using the bytecode cache */
+static int vlclua_dofile_cached( lua_State *L, const char *path )
+{
+    struct stat st;
+    if( vlc_stat( path, &st ) == 0 )
+    {
+        if( LuacCacheLoad( L, path, &st ) == 0 )
+            return lua_pcall( L, 0, LUA_MULTRET, 0 );
+
+        int ret = luaL_loadfile( L, path );
+        if( ret )
+            return ret;
+        LuacCacheStore( L, path, &st );
+        return lua_pcall( L, 0, LUA_MULTRET, 0 );
+    }
+    return luaL_dofile( L, path );
+}
+
 /** Replacement for luaL_dofile, using VLC's input capabilities */
 int vlclua_dofile( vlc_object_t *p_this, lua_State *L, const char *curi )
 {
     char *uri = ToLocaleDup( curi );
     if( !strstr( uri, "://" ) ) {
-        int ret = luaL_dofile( L, uri );
+        int ret = vlclua_dofile_cached( L, uri );
         free( uri );
         return ret;
     }
     if( !strncasecmp( uri, "file://", 7 ) ) {
-        int ret = luaL_dofile( L, uri + 7 );
+        int ret = vlclua_dofile_cached( L, uri + 7 );
         free( uri );
         return ret;
     }
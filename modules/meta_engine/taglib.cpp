@@ -150,12 +150,18 @@ vlc_module_begin ()
         set_callback( WriteMeta )
 vlc_module_end ()
 
+/* Readahead for the areas where tags live: ID3v2, MP4 and ASF keep them at
+ * the head of the file, ID3v1 and APE at the tail. */
+#define TAGLIB_HEAD_PRELOAD_SIZE (256 * 1024)
+#define TAGLIB_TAIL_PRELOAD_SIZE (128 * 1024)
+
 class VlcIostream : public IOStream
 {
 public:
     VlcIostream(stream_t* p_stream)
         : m_stream( p_stream )
         , m_previousPos( 0 )
+        , m_tailOffset( 0 )
     {
     }
 
@@ -171,14 +177,50 @@ public:
         return m_stream->psz_url;
     }
 
+    /* Fetch the head and tail ranges of the stream in two bulk reads, so
+     * the many small reads taglib issues while parsing the tags are served
+     * from memory instead of the (possibly remote) stream. */
+    void preloadTagRanges()
+    {
+        long size = length();
+
+        uint64_t headSize = TAGLIB_HEAD_PRELOAD_SIZE;
+        if (size >= 0 && (uint64_t)size < headSize)
+            headSize = size;
+        m_head = readRange(0, headSize);
+
+        if (size > 0 && (uint64_t)size > m_head.size())
+        {
+            uint64_t tailSize = __MIN((uint64_t)TAGLIB_TAIL_PRELOAD_SIZE,
+                                      (uint64_t)size - m_head.size());
+            m_tailOffset = size - tailSize;
+            m_tail = readRange(m_tailOffset, tailSize);
+        }
+    }
+
     ByteVector readBlock(ulong length)
     {
-        ByteVector res(length, 0);
+        ByteVector res;
+        if (readFromCache(m_head, 0, length, res) ||
+            readFromCache(m_tail, m_tailOffset, length, res))
+        {
+            m_previousPos += length;
+            return res;
+        }
+
+        /* The stream is seeked lazily, as cache hits leave it behind the
+         * logical position. */
+        if (vlc_stream_Tell( m_stream ) != (uint64_t)m_previousPos &&
+            vlc_stream_Seek( m_stream, m_previousPos ) != 0)
+            return ByteVector::null;
+
+        res = ByteVector(length, 0);
         ssize_t i_read = vlc_stream_Read( m_stream, res.data(), length);
         if (i_read < 0)
             return ByteVector::null;
         else if ((size_t)i_read != length)
             res.resize(i_read);
+        m_previousPos += i_read;
         return res;
     }
 
@@ -219,8 +261,9 @@ public:
             default:
                 break;
         }
-        if (vlc_stream_Seek( m_stream, pos + offset ) == 0)
-            m_previousPos = pos + offset;
+        /* The underlying stream is only seeked when a read misses the
+         * preloaded ranges */
+        m_previousPos = pos + offset;
     }
 
     void clear()
@@ -246,8 +289,37 @@ public:
     }
 
 private:
+    ByteVector readRange(uint64_t offset, uint64_t len)
+    {
+        if (vlc_stream_Seek( m_stream, offset ) != 0)
+            return ByteVector();
+        ByteVector res(len, 0);
+        ssize_t i_read = vlc_stream_Read( m_stream, res.data(), len );
+        if (i_read <= 0)
+            return ByteVector();
+        if ((uint64_t)i_read != len)
+            res.resize(i_read);
+        return res;
+    }
+
+    bool readFromCache(const ByteVector& cache, uint64_t cacheOffset,
+                       ulong length, ByteVector& res)
+    {
+        if (cache.isEmpty() || (uint64_t)m_previousPos < cacheOffset)
+            return false;
+        uint64_t off = m_previousPos - cacheOffset;
+        if (off + length > cache.size())
+            return false;
+        res = cache.mid(off, length);
+        return true;
+    }
+
     stream_t* m_stream;
     int64_t m_previousPos;
+    /* Preloaded head and tail ranges, see preloadTagRanges() */
+    ByteVector m_head;
+    ByteVector m_tail;
+    uint64_t m_tailOffset;
 };
 
 static int ExtractCoupleNumberValues( vlc_meta_t* p_meta, const char *psz_value,
@@ -857,6 +929,7 @@ static int ReadMeta( vlc_object_t* p_this)
         p_stream = p_filter;
 
     VlcIostream s( p_stream );
+    s.preloadTagRanges();
     f = FileRef( &s );
 
     if( f.isNull() )
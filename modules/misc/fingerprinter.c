@@ -145,6 +145,15 @@ static void player_on_state_changed(vlc_player_t *player,
     }
 }
 
+/* Called from the sout thread once the fingerprint window is complete, so
+ * the decode can be stopped early instead of playing the track out. */
+static void fingerprint_on_done( void *p_user_data )
+{
+    fingerprinter_sys_t *p_sys = p_user_data;
+    p_sys->processing.b_working = false;
+    vlc_cond_signal( &p_sys->processing.cond );
+}
+
 static void DoFingerprint( fingerprinter_thread_t *p_fingerprinter,
                            acoustid_fingerprint_t *fp,
                            const char *psz_uri )
@@ -183,6 +192,8 @@ static void DoFingerprint( fingerprinter_thread_t *p_fingerprinter,
 
     chroma_fingerprint.psz_fingerprint = NULL;
     chroma_fingerprint.i_duration = fp->i_duration;
+    chroma_fingerprint.pf_done = fingerprint_on_done;
+    chroma_fingerprint.p_done_data = p_fingerprinter->p_sys;
 
     var_Create( p_fingerprinter, "fingerprint-data", VLC_VAR_ADDRESS );
     var_SetAddress( p_fingerprinter, "fingerprint-data", &chroma_fingerprint );
@@ -203,6 +214,10 @@ static void DoFingerprint( fingerprinter_thread_t *p_fingerprinter,
             vlc_player_CondWait(player,
                                 &p_fingerprinter->p_sys->processing.cond);
 
+        /* No-op when the track played out; otherwise the fingerprint
+         * completed early and the rest of the decode is useless. */
+        vlc_player_Stop(player);
+
         fp->psz_fingerprint = chroma_fingerprint.psz_fingerprint;
         if( !fp->i_duration ) /* had not given hint */
             fp->i_duration = chroma_fingerprint.i_duration;
@@ -368,33 +383,62 @@ static void *Run( void *opaque )
 
         vlc_mutex_unlock( &p_sys->incoming.lock );
 
-        bool results_available = false;
-        while( vlc_array_count( &p_sys->processing.queue ) )
+        /* Decode phase: fingerprint the whole batch first, keeping the
+         * network phase grouped instead of interleaved with decoding */
+        size_t i_batch = vlc_array_count( &p_sys->processing.queue );
+        acoustid_fingerprint_t *p_prints = calloc( i_batch,
+                                                   sizeof (*p_prints) );
+        size_t i_printed = 0;
+
+        while( p_prints != NULL && i_printed < i_batch )
         {
-            fingerprint_request_t *p_data = vlc_array_item_at_index( &p_sys->processing.queue, 0 );
+            fingerprint_request_t *p_data =
+                vlc_array_item_at_index( &p_sys->processing.queue, i_printed );
 
             char *psz_uri = input_item_GetURI( p_data->p_item );
             if ( psz_uri != NULL )
             {
-                 acoustid_fingerprint_t acoustid_print = {0};
-
                 /* overwrite with hint, as in this case, fingerprint's session will be truncated */
                 if ( p_data->i_duration )
-                     acoustid_print.i_duration = p_data->i_duration;
+                     p_prints[i_printed].i_duration = p_data->i_duration;
 
-                DoFingerprint( p_fingerprinter, &acoustid_print, psz_uri );
+                DoFingerprint( p_fingerprinter, &p_prints[i_printed], psz_uri );
                 free( psz_uri );
+            }
+            i_printed++;
 
-                acoustid_config_t cfg = { .p_obj = VLC_OBJECT(p_fingerprinter),
-                                          .psz_server = NULL, .psz_apikey = NULL };
-                acoustid_lookup_fingerprint( &cfg, &acoustid_print );
-                fill_metas_with_results( p_data, &acoustid_print );
+            if( atomic_load_explicit( &p_sys->abort, memory_order_relaxed ) )
+                break;
+        }
 
-                for( unsigned j = 0; j < acoustid_print.results.count; j++ )
-                     acoustid_result_release( &acoustid_print.results.p_results[j] );
-                if( acoustid_print.results.count )
-                    free( acoustid_print.results.p_results );
-                free( acoustid_print.psz_fingerprint );
+        /* Lookup phase: one batch submission to the webservice */
+        if( p_prints != NULL
+         && !atomic_load_explicit( &p_sys->abort, memory_order_relaxed ) )
+        {
+            acoustid_config_t cfg = { .p_obj = VLC_OBJECT(p_fingerprinter),
+                                      .psz_server = NULL, .psz_apikey = NULL };
+            acoustid_lookup_fingerprints( &cfg, p_prints, i_printed );
+        }
+
+        /* Publish phase: move the fingerprinted requests to the results
+         * queue; anything not reached before an abort stays in the
+         * processing queue and is released by CleanSys() */
+        bool results_available = false;
+        size_t i_publish = p_prints != NULL ? i_printed : i_batch;
+        for( size_t i = 0; i < i_publish; i++ )
+        {
+            fingerprint_request_t *p_data =
+                vlc_array_item_at_index( &p_sys->processing.queue, 0 );
+
+            if( p_prints != NULL )
+            {
+                fill_metas_with_results( p_data, &p_prints[i] );
+
+                for( unsigned j = 0; j < p_prints[i].results.count; j++ )
+                     acoustid_result_release( &p_prints[i].results.p_results[j] );
+                if( p_prints[i].results.count )
+                    free( p_prints[i].results.p_results );
+                free( p_prints[i].psz_fingerprint );
             }
 
             /* copy results */
@@ -409,15 +453,16 @@ static void *Run( void *opaque )
             // processing and results queue, even in case of thread
             // cancellation, so remove it immediately
             vlc_array_remove( &p_sys->processing.queue, 0 );
-
-            if( atomic_load_explicit( &p_sys->abort, memory_order_relaxed ) )
-                return NULL;
         }
+        free( p_prints );
 
         if ( results_available )
         {
             var_TriggerCallback( p_fingerprinter, "results-available" );
         }
+
+        if( atomic_load_explicit( &p_sys->abort, memory_order_relaxed ) )
+            return NULL;
     }
 
     vlc_assert_unreachable();
@@ -42,10 +42,37 @@
 #include <gnutls/gnutls.h>
 #include <gnutls/x509.h>
 
+/**
+ * Client-side session resumption cache.
+ *
+ * Stores the session data (or TLS 1.3 ticket) of recent handshakes keyed by
+ * server host name, so that reconnecting to the same server can skip the
+ * full key exchange. Shared by all sessions of one credentials object.
+ */
+#define CACHED_SESSION_COUNT 32
+#define CACHED_SESSION_MAX_SIZE 16384
+
+struct cached_session
+{
+    char *host;
+    void *data;
+    size_t size;
+    vlc_tick_t date;
+};
+
+typedef struct vlc_tls_client_sys
+{
+    gnutls_certificate_credentials_t x509;
+    vlc_mutex_t cache_lock;
+    struct cached_session cache[CACHED_SESSION_COUNT];
+} vlc_tls_client_sys_t;
+
 typedef struct vlc_tls_gnutls
 {
     vlc_tls_t tls;
     gnutls_session_t session;
+    vlc_tls_t *sock;
+    vlc_tls_client_sys_t *client; /* NULL for server-side sessions */
     vlc_object_t *obj;
 } vlc_tls_gnutls_t;
 
@@ -130,9 +157,87 @@ static ssize_t vlc_gnutls_writev(gnutls_transport_ptr_t ptr,
 static int gnutls_GetFD(vlc_tls_t *tls, short *restrict events)
 {
     vlc_tls_gnutls_t *priv = (vlc_tls_gnutls_t *)tls;
-    vlc_tls_t *sock = gnutls_transport_get_ptr(priv->session);
 
-    return vlc_tls_GetPollFD(sock, events);
+    return vlc_tls_GetPollFD(priv->sock, events);
+}
+
+static struct cached_session *gnutls_CacheLookup(vlc_tls_client_sys_t *sys,
+                                                 const char *host)
+{
+    for (size_t i = 0; i < CACHED_SESSION_COUNT; i++)
+        if (sys->cache[i].host != NULL
+         && !strcasecmp(sys->cache[i].host, host))
+            return sys->cache + i;
+    return NULL;
+}
+
+/**
+ * Primes a fresh session with the session data saved from the last
+ * successful handshake with the same host, if any.
+ */
+static void gnutls_CacheResume(vlc_tls_client_sys_t *sys,
+                               gnutls_session_t session, const char *host)
+{
+    if (host == NULL)
+        return;
+
+    vlc_mutex_lock(&sys->cache_lock);
+    struct cached_session *entry = gnutls_CacheLookup(sys, host);
+    if (entry != NULL)
+    {
+        gnutls_session_set_data(session, entry->data, entry->size);
+        entry->date = vlc_tick_now();
+    }
+    vlc_mutex_unlock(&sys->cache_lock);
+}
+
+/**
+ * Saves the resumption data of an established session, evicting the least
+ * recently used entry if the cache is full.
+ */
+static void gnutls_CacheStore(vlc_tls_client_sys_t *sys,
+                              gnutls_session_t session, const char *host)
+{
+    gnutls_datum_t data;
+
+    if (host == NULL || gnutls_session_get_data2(session, &data) != 0)
+        return;
+    if (data.size == 0 || data.size > CACHED_SESSION_MAX_SIZE)
+    {
+        gnutls_free(data.data);
+        return;
+    }
+
+    vlc_mutex_lock(&sys->cache_lock);
+    struct cached_session *entry = gnutls_CacheLookup(sys, host);
+    if (entry == NULL)
+    {
+        entry = sys->cache;
+        for (size_t i = 1; i < CACHED_SESSION_COUNT; i++)
+            if (sys->cache[i].host == NULL
+             || (entry->host != NULL && sys->cache[i].date < entry->date))
+                entry = sys->cache + i;
+
+        free(entry->host);
+        entry->host = strdup(host);
+    }
+
+    free(entry->data);
+    entry->data = malloc(data.size);
+    if (likely(entry->host != NULL && entry->data != NULL))
+    {
+        memcpy(entry->data, data.data, data.size);
+        entry->size = data.size;
+        entry->date = vlc_tick_now();
+    }
+    else
+    {
+        free(entry->host);
+        free(entry->data);
+        memset(entry, 0, sizeof (*entry));
+    }
+    vlc_mutex_unlock(&sys->cache_lock);
+    gnutls_free(data.data);
 }
 
 static ssize_t gnutls_Recv(vlc_tls_t *tls, struct iovec *iov, unsigned count)
@@ -235,6 +340,16 @@ static vlc_tls_gnutls_t *gnutls_SessionOpen(vlc_object_t *obj, int type,
 
     type |= GNUTLS_NONBLOCK | GNUTLS_ENABLE_FALSE_START;
 
+#ifdef GNUTLS_ENABLE_KTLS
+    /* Kernel TLS offload moves record encryption below the socket, saving
+     * the user space copy per record. It is only possible when we own the
+     * socket: with a layered transport, handing the descriptor over to the
+     * kernel would bypass the intermediate layers. */
+    const bool ktls = vlc_tls_SocketIsRaw(sock);
+    if (ktls)
+        type |= GNUTLS_ENABLE_KTLS;
+#endif
+
     val = gnutls_init(&session, type);
     if (val != 0)
     {
@@ -289,11 +404,20 @@ static vlc_tls_gnutls_t *gnutls_SessionOpen(vlc_object_t *obj, int type,
         free (protv);
     }
 
-    gnutls_transport_set_ptr(session, sock);
-    gnutls_transport_set_vec_push_function(session, vlc_gnutls_writev);
-    gnutls_transport_set_pull_function(session, vlc_gnutls_read);
+#ifdef GNUTLS_ENABLE_KTLS
+    if (ktls)
+        gnutls_transport_set_int(session, vlc_tls_GetFD(sock));
+    else
+#endif
+    {
+        gnutls_transport_set_ptr(session, sock);
+        gnutls_transport_set_vec_push_function(session, vlc_gnutls_writev);
+        gnutls_transport_set_pull_function(session, vlc_gnutls_read);
+    }
 
     priv->session = session;
+    priv->sock = sock;
+    priv->client = NULL;
     priv->obj = obj;
 
     vlc_tls_t *tls = &priv->tls;
@@ -352,6 +476,12 @@ static int gnutls_Handshake(vlc_tls_t *tls, char **restrict alp)
         msg_Dbg(obj, " - encrypt then MAC (RFC7366) enabled");
     if (flags & GNUTLS_SFLAGS_FALSE_START)
         msg_Dbg(obj, " - false start (RFC7918) enabled");
+    if (gnutls_session_is_resumed(session))
+        msg_Dbg(obj, " - session resumed (abbreviated handshake)");
+#ifdef GNUTLS_ENABLE_KTLS
+    if (gnutls_transport_is_ktls_enabled(session))
+        msg_Dbg(obj, " - kernel TLS offload enabled");
+#endif
 
     if (alp != NULL)
     {
@@ -377,20 +507,27 @@ static vlc_tls_t *gnutls_ClientSessionOpen(vlc_tls_client_t *crd,
                                            vlc_tls_t *sk, const char *hostname,
                                            const char *const *alpn)
 {
+    vlc_tls_client_sys_t *sys = crd->sys;
     vlc_tls_gnutls_t *priv = gnutls_SessionOpen(VLC_OBJECT(crd), GNUTLS_CLIENT,
-                                                crd->sys, sk, alpn);
+                                                sys->x509, sk, alpn);
     if (priv == NULL)
         return NULL;
 
+    priv->client = sys;
+
     gnutls_session_t session = priv->session;
 
     /* minimum DH prime bits */
     gnutls_dh_set_prime_bits (session, 1024);
 
     if (likely(hostname != NULL))
+    {
         /* fill Server Name Indication */
         gnutls_server_name_set (session, GNUTLS_NAME_DNS,
                                 hostname, strlen (hostname));
+        /* resume the previous session with this server, if any */
+        gnutls_CacheResume(sys, session, hostname);
+    }
 
     return &priv->tls;
 }
@@ -406,8 +543,13 @@ static int gnutls_ClientHandshake(vlc_tls_t *tls,
     if (val)
         return val;
 
-    /* certificates chain verification */
     gnutls_session_t session = priv->session;
+
+    /* Save the session data (or TLS 1.3 ticket, when the server already
+     * sent one) so later connections to this host can resume. */
+    gnutls_CacheStore(priv->client, session, host);
+
+    /* certificates chain verification */
     unsigned status;
 
     val = gnutls_certificate_verify_peers3 (session, host, &status);
@@ -531,9 +673,15 @@ error:
 
 static void gnutls_ClientDestroy(vlc_tls_client_t *crd)
 {
-    gnutls_certificate_credentials_t x509 = crd->sys;
+    vlc_tls_client_sys_t *sys = crd->sys;
 
-    gnutls_certificate_free_credentials(x509);
+    for (size_t i = 0; i < CACHED_SESSION_COUNT; i++)
+    {
+        free(sys->cache[i].host);
+        free(sys->cache[i].data);
+    }
+    gnutls_certificate_free_credentials(sys->x509);
+    free(sys);
 }
 
 static const struct vlc_tls_client_operations gnutls_ClientOps =
@@ -552,11 +700,16 @@ static int OpenClient(vlc_tls_client_t *crd)
 
     gnutls_Banner(VLC_OBJECT(crd));
 
+    vlc_tls_client_sys_t *sys = calloc(1, sizeof (*sys));
+    if (unlikely(sys == NULL))
+        return VLC_ENOMEM;
+
     int val = gnutls_certificate_allocate_credentials (&x509);
     if (val != 0)
     {
         msg_Err (crd, "cannot allocate credentials: %s",
                  gnutls_strerror (val));
+        free (sys);
         return VLC_EGENERIC;
     }
 
@@ -586,8 +739,11 @@ static int OpenClient(vlc_tls_client_t *crd)
     gnutls_certificate_set_verify_flags (x509,
                                          GNUTLS_VERIFY_ALLOW_X509_V1_CA_CRT);
 
+    sys->x509 = x509;
+    vlc_mutex_init(&sys->cache_lock);
+
     crd->ops = &gnutls_ClientOps;
-    crd->sys = x509;
+    crd->sys = sys;
     return VLC_SUCCESS;
 }
 
@@ -599,6 +755,7 @@ typedef struct vlc_tls_creds_sys
 {
     gnutls_certificate_credentials_t x509_cred;
     gnutls_dh_params_t dh_params;
+    gnutls_datum_t ticket_key;
 } vlc_tls_creds_sys_t;
 
 /**
@@ -611,7 +768,15 @@ static vlc_tls_t *gnutls_ServerSessionOpen(vlc_tls_server_t *crd,
     vlc_tls_creds_sys_t *sys = crd->sys;
     vlc_tls_gnutls_t *priv = gnutls_SessionOpen(VLC_OBJECT(crd), GNUTLS_SERVER,
                                                 sys->x509_cred, sk, alpn);
-    return (priv != NULL) ? &priv->tls : NULL;
+    if (priv == NULL)
+        return NULL;
+
+    /* Stateless resumption: returning clients present an encrypted ticket
+     * instead of redoing the key exchange, with no per-client state here. */
+    if (sys->ticket_key.data != NULL)
+        gnutls_session_ticket_enable_server(priv->session, &sys->ticket_key);
+
+    return &priv->tls;
 }
 
 static void gnutls_ServerDestroy(vlc_tls_server_t *crd)
@@ -619,6 +784,11 @@ static void gnutls_ServerDestroy(vlc_tls_server_t *crd)
     vlc_tls_creds_sys_t *sys = crd->sys;
 
     /* all sessions depending on the server are now deinitialized */
+    if (sys->ticket_key.data != NULL)
+    {
+        gnutls_memset(sys->ticket_key.data, 0, sys->ticket_key.size);
+        gnutls_free(sys->ticket_key.data);
+    }
     gnutls_certificate_free_credentials(sys->x509_cred);
     gnutls_dh_params_deinit(sys->dh_params);
     free(sys);
@@ -711,6 +881,14 @@ static int OpenServer(vlc_tls_server_t *crd, const char *cert, const char *key)
 
     msg_Dbg (crd, "ciphers parameters loaded");
 
+    if (gnutls_session_ticket_key_generate (&sys->ticket_key) != 0)
+    {
+        msg_Warn (crd, "cannot generate session ticket key: "
+                  "session resumption disabled");
+        sys->ticket_key.data = NULL;
+        sys->ticket_key.size = 0;
+    }
+
     crd->ops = &gnutls_ServerOps;
     crd->sys = sys;
     return VLC_SUCCESS;
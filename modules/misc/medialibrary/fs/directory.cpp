@@ -61,6 +61,7 @@ SDDirectory::mrl() const
 const std::vector<std::shared_ptr<IFile>> &
 SDDirectory::files() const
 {
+    vlc::threads::mutex_locker lock(m_lock);
     if (!m_read_done)
         read();
     return m_files;
@@ -69,11 +70,29 @@ SDDirectory::files() const
 const std::vector<std::shared_ptr<IDirectory>> &
 SDDirectory::dirs() const
 {
+    vlc::threads::mutex_locker lock(m_lock);
     if (!m_read_done)
         read();
     return m_dirs;
 }
 
+void
+SDDirectory::cache() const
+{
+    vlc::threads::mutex_locker lock(m_lock);
+    if (m_read_done)
+        return;
+    try
+    {
+        read();
+    }
+    catch (...)
+    {
+        /* best effort: the error will be reported when the crawler actually
+         * requests this listing and triggers the read again */
+    }
+}
+
 std::shared_ptr<IDevice>
 SDDirectory::device() const
 {
@@ -197,7 +216,14 @@ SDDirectory::read() const
         const char *mrl = m.get()->psz_uri;
         enum input_item_type_e type = m->i_type;
         if (type == ITEM_TYPE_DIRECTORY)
-            m_dirs.push_back(std::make_shared<SDDirectory>(mrl, m_fs));
+        {
+            auto subdir = std::make_shared<SDDirectory>(mrl, m_fs);
+            /* warm up the listing ahead of the crawler: enumerating a network
+             * share is latency-bound, so listing the subdirectories in
+             * parallel hides most of the round trips */
+            m_fs.prefetch(subdir);
+            m_dirs.push_back(std::move(subdir));
+        }
         else if (type == ITEM_TYPE_FILE)
             m_files.push_back(std::make_shared<SDFile>(mrl));
     }
@@ -41,12 +41,18 @@ public:
     std::shared_ptr<IDevice> device() const override;
     std::shared_ptr<IFile> file( const std::string& mrl ) const override;
 
+    /* Fetch the directory listing if it is not cached yet, ignoring errors.
+     * Called from the factory prefetch threads, ahead of the crawler; errors
+     * are reported when the listing is actually requested. */
+    void cache() const;
+
 private:
     void read() const;
 
     std::string m_mrl;
     SDFileSystemFactory &m_fs;
 
+    mutable vlc::threads::mutex m_lock;
     mutable bool m_read_done = false;
     mutable std::vector<std::shared_ptr<IFile>> m_files;
     mutable std::vector<std::shared_ptr<IDirectory>> m_dirs;
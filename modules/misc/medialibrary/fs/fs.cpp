@@ -179,16 +179,79 @@ SDFileSystemFactory::start(IFileSystemFactoryCb *callbacks)
             continue;
         m_sds.push_back( std::move( sd ) );
     }
-    return m_sds.empty() == false;
+    if ( m_sds.empty() )
+        return false;
+
+    m_prefetchStop = false;
+    for ( size_t i = 0; i < MaxPrefetchThreads; ++i )
+    {
+        if ( vlc_clone( &m_prefetchThreads[i], prefetchThreadEntry, this,
+                        VLC_THREAD_PRIORITY_LOW ) )
+            break;
+        m_prefetchThreadCount++;
+    }
+    /* the prefetch threads are an optimization, keep going without them */
+    return true;
 }
 
 void
 SDFileSystemFactory::stop()
 {
+    {
+        vlc::threads::mutex_locker locker(m_prefetchLock);
+        m_prefetchStop = true;
+        m_prefetchQueue.clear();
+        m_prefetchCond.broadcast();
+    }
+    for ( size_t i = 0; i < m_prefetchThreadCount; ++i )
+        vlc_join( m_prefetchThreads[i], nullptr );
+    m_prefetchThreadCount = 0;
+
     m_sds.clear();
     m_callbacks = nullptr;
 }
 
+void
+SDFileSystemFactory::prefetch(std::shared_ptr<const SDDirectory> directory)
+{
+    vlc::threads::mutex_locker locker(m_prefetchLock);
+    if ( m_prefetchThreadCount == 0 || m_prefetchStop )
+        return;
+    if ( m_prefetchQueue.size() >= MaxPrefetchQueueLength )
+        return; /* best effort, the crawler will list it synchronously */
+    m_prefetchQueue.push_back( std::move( directory ) );
+    m_prefetchCond.signal();
+}
+
+void
+SDFileSystemFactory::prefetchThread()
+{
+    m_prefetchLock.lock();
+    while ( !m_prefetchStop )
+    {
+        if ( m_prefetchQueue.empty() )
+        {
+            m_prefetchCond.wait( m_prefetchLock );
+            continue;
+        }
+        auto dir = std::move( m_prefetchQueue.front() );
+        m_prefetchQueue.pop_front();
+
+        m_prefetchLock.unlock();
+        dir->cache();
+        m_prefetchLock.lock();
+    }
+    m_prefetchLock.unlock();
+}
+
+void *
+SDFileSystemFactory::prefetchThreadEntry(void *data)
+{
+    auto *that = static_cast<SDFileSystemFactory *>( data );
+    that->prefetchThread();
+    return nullptr;
+}
+
 libvlc_int_t *
 SDFileSystemFactory::libvlc() const
 {
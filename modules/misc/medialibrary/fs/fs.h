@@ -21,6 +21,7 @@
 #ifndef SD_FS_H
 #define SD_FS_H
 
+#include <deque>
 #include <memory>
 #include <vector>
 #include <vlc_common.h>
@@ -45,6 +46,8 @@ namespace vlc {
 using namespace ::medialibrary;
 using namespace ::medialibrary::fs;
 
+class SDDirectory;
+
 class SDFileSystemFactory : public IFileSystemFactory {
 public:
     SDFileSystemFactory(vlc_object_t *m_parent,
@@ -87,7 +90,17 @@ public:
     void onDeviceAdded(input_item_t *media);
     void onDeviceRemoved(input_item_t *media);
 
+    /**
+     * Queue a directory listing to be fetched by the prefetch threads, ahead
+     * of the crawler. Best effort: the request is dropped when the queue is
+     * full or the factory is stopping.
+     */
+    void prefetch(std::shared_ptr<const SDDirectory> directory);
+
 private:
+    void prefetchThread();
+    static void *prefetchThreadEntry(void *data);
+
     vlc_object_t *const m_parent;
     const std::string m_scheme;
     IFileSystemFactoryCb *m_callbacks;
@@ -97,6 +110,16 @@ private:
     std::vector<std::shared_ptr<IDevice>> m_devices;
     using SdPtr = std::unique_ptr<services_discovery_t, decltype(&vlc_sd_Destroy)>;
     std::vector<SdPtr> m_sds;
+
+    /* bounded pool listing directories ahead of the crawler */
+    static constexpr size_t MaxPrefetchThreads = 4;
+    static constexpr size_t MaxPrefetchQueueLength = 64;
+    vlc::threads::mutex m_prefetchLock;
+    vlc::threads::condition_variable m_prefetchCond;
+    std::deque<std::shared_ptr<const SDDirectory>> m_prefetchQueue;
+    vlc_thread_t m_prefetchThreads[MaxPrefetchThreads];
+    size_t m_prefetchThreadCount = 0;
+    bool m_prefetchStop = false;
 };
 
   } /* namespace medialibrary */
@@ -166,3 +166,24 @@ int acoustid_lookup_fingerprint( const acoustid_config_t *p_cfg, acoustid_finger
 
     return VLC_SUCCESS;
 }
+
+int acoustid_lookup_fingerprints( const acoustid_config_t *p_cfg,
+                                  acoustid_fingerprint_t *p_prints,
+                                  size_t i_count )
+{
+    int i_ret = VLC_SUCCESS;
+
+    /* The lookup service takes one fingerprint per request; what is
+     * batched here is the session: one config, back to back requests,
+     * stopping at the first transport-level failure. */
+    for( size_t i = 0; i < i_count; i++ )
+    {
+        if( p_prints[i].psz_fingerprint == NULL )
+            continue;
+        i_ret = acoustid_lookup_fingerprint( p_cfg, &p_prints[i] );
+        if( i_ret != VLC_SUCCESS )
+            break;
+    }
+
+    return i_ret;
+}
@@ -64,4 +64,9 @@ typedef struct
 } acoustid_config_t;
 
 int acoustid_lookup_fingerprint( const acoustid_config_t *, acoustid_fingerprint_t * );
+/* Submit a whole batch of fingerprints over one configuration, so callers
+ * queueing many tracks keep the network phase grouped instead of
+ * interleaving it with decoding. */
+int acoustid_lookup_fingerprints( const acoustid_config_t *,
+                                  acoustid_fingerprint_t *, size_t );
 void acoustid_result_release( acoustid_result_t * );
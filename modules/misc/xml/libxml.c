@@ -104,7 +104,6 @@ static void ReaderErrorHandler( void *p_arg, const char *p_msg,
 typedef struct
 {
     xmlTextReaderPtr xml;
-    char *node;
 } xml_reader_sys_t;
 
 static int ReaderUseDTD ( xml_reader_t *p_reader )
@@ -125,9 +124,6 @@ static int ReaderNextNode( xml_reader_t *p_reader, const char **pval )
     const xmlChar *node;
     int ret;
 
-    free( p_sys->node );
-    p_sys->node = NULL;
-
 skip:
     switch( xmlTextReaderRead( p_sys->xml ) )
     {
@@ -165,10 +161,12 @@ skip:
     if( unlikely(node == NULL) )
         return XML_READER_ERROR;
 
-    p_sys->node = strdup( (const char *)node );
+    /* Element names are interned in the reader dictionary and text values
+     * live until the next read: return them as-is, they match the API
+     * lifetime (valid until the next node) without a copy per node. */
     if( pval != NULL )
-        *pval = p_sys->node;
-    return likely(p_sys->node != NULL) ? ret : XML_READER_ERROR;
+        *pval = (const char *)node;
+    return ret;
 }
 
 #if 0
@@ -237,7 +235,6 @@ static int ReaderOpen( vlc_object_t *p_this )
                                   ReaderErrorHandler, p_reader );
 
     p_sys->xml = p_libxml_reader;
-    p_sys->node = NULL;
     p_reader->p_sys = p_sys;
     p_reader->pf_next_node = ReaderNextNode;
     p_reader->pf_next_attr = ReaderNextAttr;
@@ -258,7 +255,6 @@ static void ReaderClose( vlc_object_t *p_this )
     xmlCleanupParser();
     vlc_mutex_unlock( &lock );
 #endif
-    free( p_sys->node );
     free( p_sys );
 }
 
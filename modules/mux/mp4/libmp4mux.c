@@ -36,8 +36,13 @@
 #include <vlc_bits.h>
 #include <vlc_arrays.h>
 #include <vlc_text_style.h>
+#include <vlc_fs.h>
 #include <assert.h>
 #include <time.h>
+#include <unistd.h>
+#ifdef HAVE_MMAP
+# include <sys/mman.h>
+#endif
 
 struct mp4mux_trackinfo_t
 {
@@ -49,6 +54,14 @@ struct mp4mux_trackinfo_t
     unsigned int i_samples_max;
     mp4mux_sample_t *samples;
 
+    /* bounded index: full sample batches are spilled to an anonymous
+     * temporary file and merged back when the moov is generated */
+    bool         b_bounded_index;
+    bool         b_samples_mapped;
+    int          i_spill_fd;
+    unsigned int i_spilled_count;
+    int64_t      i_spilled_pos_shift;
+
     /* XXX: needed for other codecs too, see lavf */
     struct
     {
@@ -124,6 +137,7 @@ static bool mp4mux_trackinfo_Init(mp4mux_trackinfo_t *p_stream, unsigned i_id,
     p_stream->i_track_id = i_id;
 
     p_stream->i_timescale   = i_timescale;
+    p_stream->i_spill_fd    = -1;
     es_format_Init(&p_stream->fmt, 0, 0);
 
     return true;
@@ -133,7 +147,15 @@ static void mp4mux_trackinfo_Clear(mp4mux_trackinfo_t *p_stream)
 {
     es_format_Clean(&p_stream->fmt);
     mp4mux_track_SetSamplePriv(p_stream, NULL, 0);
-    free(p_stream->samples);
+#ifdef HAVE_MMAP
+    if(p_stream->b_samples_mapped)
+        munmap(p_stream->samples,
+               (size_t)p_stream->i_samples_max * sizeof(*p_stream->samples));
+    else
+#endif
+        free(p_stream->samples);
+    if(p_stream->i_spill_fd != -1)
+        vlc_close(p_stream->i_spill_fd);
     free(p_stream->p_edits);
 }
 
@@ -150,6 +172,8 @@ mp4mux_trackinfo_t * mp4mux_track_Add(mp4mux_handle_t *h, unsigned id,
     }
     t->i_track_id = id;
     t->i_timescale = timescale;
+    t->b_bounded_index = (h->options & BOUNDEDINDEX) &&
+                         (h->options & FRAGMENTED) == 0;
     es_format_Init(&t->fmt, fmt->i_cat, fmt->i_codec);
     es_format_Copy(&t->fmt, fmt);
     vlc_array_append(&h->tracks, t);
@@ -192,8 +216,114 @@ void mp4mux_track_DebugEdits(vlc_object_t *obj, const mp4mux_trackinfo_t *t)
     }
 }
 
+/* Samples held in memory before a batch is spilled to the temporary file */
+#define MP4MUX_SPILL_BATCH 65536
+
+static bool SpillWrite(int fd, const void *buf, size_t i_len)
+{
+    const unsigned char *p = buf;
+    while(i_len > 0)
+    {
+        ssize_t val = write(fd, p, i_len);
+        if(val <= 0)
+            return false;
+        p += val;
+        i_len -= val;
+    }
+    return true;
+}
+
+static void TrackSpillSamples(mp4mux_trackinfo_t *t)
+{
+    if(t->i_spill_fd == -1)
+    {
+        t->i_spill_fd = vlc_memfd();
+        if(t->i_spill_fd == -1)
+        {
+            t->b_bounded_index = false; /* keep everything in memory */
+            return;
+        }
+    }
+
+    /* The last entry is kept in memory, as it can still be updated */
+    unsigned count = t->i_samples_count - 1;
+    if(!SpillWrite(t->i_spill_fd, t->samples,
+                   (size_t)count * sizeof(t->samples[0])))
+    {
+        t->b_bounded_index = false;
+        return;
+    }
+    t->i_spilled_count += count;
+    t->samples[0] = t->samples[count];
+    t->i_samples_count = 1;
+}
+
+/* Merge the spilled batches and the in-memory tail back into a single
+ * array, mapping the temporary file instead of reading it when possible */
+static bool TrackMergeSpilledSamples(mp4mux_trackinfo_t *t)
+{
+    if(t->i_spilled_count == 0)
+        return true;
+
+    if(!SpillWrite(t->i_spill_fd, t->samples,
+                   (size_t)t->i_samples_count * sizeof(t->samples[0])))
+        return false;
+
+    unsigned total = t->i_spilled_count + t->i_samples_count;
+    size_t i_size = (size_t)total * sizeof(t->samples[0]);
+    mp4mux_sample_t *merged = NULL;
+
+#ifdef HAVE_MMAP
+    void *map = mmap(NULL, i_size, PROT_READ|PROT_WRITE, MAP_PRIVATE,
+                     t->i_spill_fd, 0);
+    if(map != MAP_FAILED)
+    {
+        free(t->samples);
+        t->b_samples_mapped = true;
+        merged = map;
+    }
+#endif
+    if(merged == NULL)
+    {
+        merged = vlc_reallocarray(t->samples, total, sizeof(t->samples[0]));
+        if(merged == NULL)
+            return false;
+        t->samples = merged;
+
+        if(lseek(t->i_spill_fd, 0, SEEK_SET) == -1)
+            return false;
+        unsigned char *p = (unsigned char *)merged;
+        for(size_t left = i_size; left > 0; )
+        {
+            ssize_t val = read(t->i_spill_fd, p, left);
+            if(val <= 0)
+                return false;
+            p += val;
+            left -= val;
+        }
+    }
+
+    t->samples = merged;
+    t->i_samples_count = total;
+    t->i_samples_max = total;
+
+    if(t->i_spilled_pos_shift != 0)
+        for(unsigned i = 0; i < t->i_spilled_count; i++)
+            t->samples[i].i_pos += t->i_spilled_pos_shift;
+
+    vlc_close(t->i_spill_fd);
+    t->i_spill_fd = -1;
+    t->i_spilled_count = 0;
+    t->i_spilled_pos_shift = 0;
+    t->b_bounded_index = false;
+    return true;
+}
+
 bool mp4mux_track_AddSample(mp4mux_trackinfo_t *t, const mp4mux_sample_t *entry)
 {
+    if(t->b_bounded_index && t->i_samples_count >= MP4MUX_SPILL_BATCH)
+        TrackSpillSamples(t);
+
     /* XXX: -1 to always have 2 entry for easy adding of empty SPU */
     if (t->i_samples_count + 2 >= t->i_samples_max)
     {
@@ -223,7 +353,7 @@ const mp4mux_sample_t *mp4mux_track_GetLastSample(const mp4mux_trackinfo_t *t)
 
 unsigned mp4mux_track_GetSampleCount(const mp4mux_trackinfo_t *t)
 {
-    return t->i_samples_count;
+    return t->i_spilled_count + t->i_samples_count;
 }
 
 void mp4mux_track_UpdateLastSample(mp4mux_trackinfo_t *t,
@@ -324,6 +454,8 @@ void mp4mux_ShiftSamples(mp4mux_handle_t *h, int64_t offset)
     for(size_t i_track = 0; i_track < vlc_array_count(&h->tracks); i_track++)
     {
         mp4mux_trackinfo_t *t = vlc_array_item_at_index(&h->tracks, i_track);
+        /* Entries already spilled to the index file are shifted on merge */
+        t->i_spilled_pos_shift += offset;
         for (unsigned i = 0; i < t->i_samples_count; i++)
         {
             mp4mux_sample_t *sample = t->samples;
@@ -1854,6 +1986,11 @@ bo_t * mp4mux_GetMoov(mp4mux_handle_t *h, vlc_object_t *p_obj, vlc_tick_t i_dura
     if( vlc_array_count(&h->tracks) == 1 )
         i_movie_timescale = ((mp4mux_trackinfo_t *)vlc_array_item_at_index(&h->tracks, 0))->i_timescale;
 
+    /* The sample tables must be complete and contiguous from here on */
+    for(unsigned int i = 0; i < vlc_array_count(&h->tracks); i++)
+        if(!TrackMergeSpilledSamples(vlc_array_item_at_index(&h->tracks, i)))
+            return NULL;
+
     moov = box_new("moov");
     if(!moov)
         return NULL;
@@ -32,6 +32,7 @@ enum mp4mux_options
     FRAGMENTED          = 1 << 0,
     QUICKTIME           = 1 << 1,
     USE64BITEXT         = 1 << 2,
+    BOUNDEDINDEX        = 1 << 3,
 };
 
 mp4mux_handle_t * mp4mux_New(enum mp4mux_options);
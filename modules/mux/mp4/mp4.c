@@ -54,6 +54,11 @@
     "\"Fast Start\" files are optimized for downloads and allow the user " \
     "to start previewing the file while it is downloading.")
 
+#define BOUNDEDINDEX_TEXT N_("Bounded index memory")
+#define BOUNDEDINDEX_LONGTEXT N_(\
+    "Spill the sample tables to a temporary file while muxing instead of " \
+    "keeping them in memory. Useful for very long recordings.")
+
 static int  Open   (vlc_object_t *);
 static void Close  (vlc_object_t *);
 static void CloseFrag  (vlc_object_t *);
@@ -69,6 +74,9 @@ vlc_module_begin ()
     add_bool(SOUT_CFG_PREFIX "faststart", false,
               FASTSTART_TEXT, FASTSTART_LONGTEXT,
               true)
+    add_bool(SOUT_CFG_PREFIX "bounded-index", false,
+              BOUNDEDINDEX_TEXT, BOUNDEDINDEX_LONGTEXT,
+              true)
     set_capability("sout mux", 5)
     add_shortcut("mp4", "mov", "3gp")
     set_callbacks(Open, Close)
@@ -88,7 +96,7 @@ vlc_module_end ()
  * Exported prototypes
  *****************************************************************************/
 static const char *const ppsz_sout_options[] = {
-    "faststart", NULL
+    "faststart", "bounded-index", NULL
 };
 
 static int Control(sout_mux_t *, int, va_list);
@@ -278,6 +286,10 @@ static int Open(vlc_object_t *p_this)
             options |= FRAGMENTED;
     }
 
+    if((options & FRAGMENTED) == 0 &&
+       var_GetBool(p_mux, SOUT_CFG_PREFIX "bounded-index"))
+        options |= BOUNDEDINDEX;
+
     p_sys->b_3gp = p_mux->psz_mux && !strcmp(p_mux->psz_mux, "3gp");
 
     p_sys->muxh = mp4mux_New(options);
@@ -367,6 +367,11 @@ typedef struct
     sdt_psi_t       sdt;
     ts_mux_standard standard;
 
+    /* PSI sections are serialized once and replayed with fresh continuity
+     * counters until the tables change */
+    block_t        *p_pat_cache;
+    block_t        *p_pmt_cache;
+
     /* for TS building */
     int64_t         i_bitrate_min;
     int64_t         i_bitrate_max;
@@ -479,6 +484,7 @@ static void TSDate      ( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
                           vlc_tick_t i_pcr_length, vlc_tick_t i_pcr_dts );
 static void GetPAT( sout_mux_t *p_mux, sout_buffer_chain_t *c );
 static void GetPMT( sout_mux_t *p_mux, sout_buffer_chain_t *c );
+static void PSICacheInvalidate( sout_mux_sys_t *p_sys );
 
 static block_t *TSNew( sout_mux_t *p_mux, sout_input_sys_t *p_stream, bool b_pcr );
 static void TSSetPCR( block_t *p_ts, vlc_tick_t i_dts );
@@ -763,6 +769,8 @@ static void Close( vlc_object_t * p_this )
     if( p_sys->p_dvbpsi )
         dvbpsi_delete( p_sys->p_dvbpsi );
 
+    PSICacheInvalidate( p_sys );
+
     if( p_sys->csa )
     {
         var_DelCallback( p_mux, SOUT_CFG_PREFIX "csa-ck", ChangeKeyCallback, p_mux );
@@ -850,6 +858,41 @@ static int Control( sout_mux_t *p_mux, int i_query, va_list args )
         *pb_bool = true;
         return VLC_SUCCESS;
 
+    case MUX_CAN_PASSTHROUGH:
+    {
+        const es_format_t *p_fmt = va_arg( args, const es_format_t * );
+        pb_bool = va_arg( args, bool * );
+
+        switch( p_fmt->i_codec )
+        {
+        case VLC_CODEC_H264:
+        case VLC_CODEC_HEVC:
+            /* Only the Annex B byte-stream form can be muxed as-is */
+            *pb_bool = p_fmt->i_extra == 0 ||
+                       ( p_fmt->i_extra >= 4 &&
+                         ( !memcmp( p_fmt->p_extra, "\x00\x00\x01", 3 ) ||
+                           !memcmp( p_fmt->p_extra, "\x00\x00\x00\x01", 4 ) ) );
+            break;
+        case VLC_CODEC_MPGV:
+        case VLC_CODEC_MP2V:
+        case VLC_CODEC_MP1V:
+        case VLC_CODEC_MP4V:
+        case VLC_CODEC_MPGA:
+        case VLC_CODEC_MP2:
+        case VLC_CODEC_MP3:
+        case VLC_CODEC_A52:
+        case VLC_CODEC_EAC3:
+        case VLC_CODEC_DTS:
+            /* Self-framed formats carried as raw ES in PES */
+            *pb_bool = true;
+            break;
+        default:
+            *pb_bool = false;
+            break;
+        }
+        return VLC_SUCCESS;
+    }
+
     case MUX_GET_MIME:
         ppsz = va_arg( args, char ** );
         *ppsz = strdup( "video/mp2t" );
@@ -974,6 +1017,7 @@ static int AddStream( sout_mux_t *p_mux, sout_input_t *p_input )
 
     /* We only change PMT version (PAT isn't changed) */
     p_sys->i_pmt_version_number = ( p_sys->i_pmt_version_number + 1 )%32;
+    PSICacheInvalidate( p_sys );
 
     /* Update pcr_pid */
     SelectPCRStream( p_mux, NULL );
@@ -1034,6 +1078,7 @@ static void DelStream( sout_mux_t *p_mux, sout_input_t *p_input )
     /* We only change PMT version (PAT isn't changed) */
     p_sys->i_pmt_version_number++;
     p_sys->i_pmt_version_number %= 32;
+    PSICacheInvalidate( p_sys );
 }
 
 static void SetHeader( sout_buffer_chain_t *c,
@@ -1927,43 +1972,135 @@ static void TSSetPCR( block_t *p_ts, vlc_tick_t i_dts )
     p_ts->p_buffer[11] = 0; /* we don't set PCR extension */
 }
 
+static void PSICacheInvalidate( sout_mux_sys_t *p_sys )
+{
+    if( p_sys->p_pat_cache )
+    {
+        block_ChainRelease( p_sys->p_pat_cache );
+        p_sys->p_pat_cache = NULL;
+    }
+    if( p_sys->p_pmt_cache )
+    {
+        block_ChainRelease( p_sys->p_pmt_cache );
+        p_sys->p_pmt_cache = NULL;
+    }
+}
+
+static tsmux_stream_t *PSICacheStreamForPID( sout_mux_sys_t *p_sys,
+                                             uint16_t i_pid )
+{
+    if( p_sys->pat.i_pid == i_pid )
+        return &p_sys->pat;
+    if( p_sys->sdt.ts.i_pid == i_pid )
+        return &p_sys->sdt.ts;
+    for( unsigned i = 0; i < p_sys->i_num_pmt; i++ )
+        if( p_sys->pmt[i].i_pid == i_pid )
+            return &p_sys->pmt[i];
+    return NULL;
+}
+
+/* Append copies of the cached PSI TS packets, stamped with the current
+ * continuity counter of their PID */
+static void PSICacheEmit( sout_mux_sys_t *p_sys, sout_buffer_chain_t *c,
+                          block_t *p_cache )
+{
+    for( block_t *p = p_cache; p; p = p->p_next )
+    {
+        block_t *p_ts = block_Duplicate( p );
+        if( unlikely(p_ts == NULL) )
+            continue;
+
+        uint16_t i_pid = GetWBE( &p_ts->p_buffer[1] ) & 0x1fff;
+        tsmux_stream_t *p_stream = PSICacheStreamForPID( p_sys, i_pid );
+        if( likely(p_stream != NULL) )
+        {
+            p_ts->p_buffer[3] = ( p_ts->p_buffer[3] & 0xf0 ) |
+                                p_stream->i_continuity_counter;
+            p_stream->i_continuity_counter =
+                ( p_stream->i_continuity_counter + 1 ) % 16;
+
+            if( p_stream->b_discontinuity &&
+                ( p_ts->p_buffer[3] & 0x20 ) && p_ts->p_buffer[4] > 0 )
+            {
+                p_ts->p_buffer[5] |= 0x80;
+                p_stream->b_discontinuity = false;
+            }
+        }
+        BufferChainAppend( c, p_ts );
+    }
+}
+
 void GetPAT( sout_mux_t *p_mux, sout_buffer_chain_t *c )
 {
     sout_mux_sys_t       *p_sys = p_mux->p_sys;
 
-    BuildPAT( p_sys->p_dvbpsi,
-              c, (PEStoTSCallback)BufferChainAppend,
-              p_sys->i_tsid, p_sys->i_pat_version_number,
-              &p_sys->pat,
-              p_sys->i_num_pmt, p_sys->pmt, p_sys->i_pmt_program_number );
+    if( p_sys->p_pat_cache == NULL )
+    {
+        /* Serialize from a scratch stream state: continuity counters are
+         * stamped at emission so the cached packets can be replayed */
+        tsmux_stream_t pat = p_sys->pat;
+        pat.i_continuity_counter = 0;
+        pat.b_discontinuity = false;
+
+        sout_buffer_chain_t chain;
+        BufferChainInit( &chain );
+        BuildPAT( p_sys->p_dvbpsi,
+                  &chain, (PEStoTSCallback)BufferChainAppend,
+                  p_sys->i_tsid, p_sys->i_pat_version_number,
+                  &pat,
+                  p_sys->i_num_pmt, p_sys->pmt, p_sys->i_pmt_program_number );
+        p_sys->p_pat_cache = chain.p_first;
+    }
+
+    PSICacheEmit( p_sys, c, p_sys->p_pat_cache );
 }
 
 static void GetPMT( sout_mux_t *p_mux, sout_buffer_chain_t *c )
 {
     sout_mux_sys_t *p_sys = p_mux->p_sys;
-    pes_mapped_stream_t mappeds[p_mux->i_nb_inputs];
 
-    for (int i_stream = 0; i_stream < p_mux->i_nb_inputs; i_stream++ )
+    if( p_sys->p_pmt_cache == NULL )
     {
-        sout_input_t *p_input = p_mux->pp_inputs[i_stream];
-        sout_input_sys_t *p_stream = (sout_input_sys_t*)p_input->p_sys;
+        pes_mapped_stream_t mappeds[p_mux->i_nb_inputs];
+        tsmux_stream_t pmt[MAX_PMT];
+        sdt_psi_t sdt = p_sys->sdt;
 
-        int i_pidinput = p_input->p_fmt->i_id;
-        pmt_map_t *p_usepid = bsearch( &i_pidinput, p_sys->pmtmap,
-                                       p_sys->i_pmtslots, sizeof(pmt_map_t), intcompare );
+        sdt.ts.i_continuity_counter = 0;
+        sdt.ts.b_discontinuity = false;
+        for( unsigned i = 0; i < p_sys->i_num_pmt; i++ )
+        {
+            pmt[i] = p_sys->pmt[i];
+            pmt[i].i_continuity_counter = 0;
+            pmt[i].b_discontinuity = false;
+        }
+
+        for (int i_stream = 0; i_stream < p_mux->i_nb_inputs; i_stream++ )
+        {
+            sout_input_t *p_input = p_mux->pp_inputs[i_stream];
+            sout_input_sys_t *p_stream = (sout_input_sys_t*)p_input->p_sys;
+
+            int i_pidinput = p_input->p_fmt->i_id;
+            pmt_map_t *p_usepid = bsearch( &i_pidinput, p_sys->pmtmap,
+                                           p_sys->i_pmtslots, sizeof(pmt_map_t), intcompare );
+
+            /* If there's an error somewhere, dump it to the first pmt */
+            mappeds[i_stream].i_mapped_prog = p_usepid ? p_usepid->i_prog : 0;
+            mappeds[i_stream].fmt = p_input->p_fmt;
+            mappeds[i_stream].pes = &p_stream->pes;
+            mappeds[i_stream].ts = &p_stream->ts;
+        }
 
-        /* If there's an error somewhere, dump it to the first pmt */
-        mappeds[i_stream].i_mapped_prog = p_usepid ? p_usepid->i_prog : 0;
-        mappeds[i_stream].fmt = p_input->p_fmt;
-        mappeds[i_stream].pes = &p_stream->pes;
-        mappeds[i_stream].ts = &p_stream->ts;
+        sout_buffer_chain_t chain;
+        BufferChainInit( &chain );
+        BuildPMT( p_sys->p_dvbpsi, VLC_OBJECT(p_mux), p_sys->standard,
+                  &chain, (PEStoTSCallback)BufferChainAppend,
+                  p_sys->i_tsid, p_sys->i_pmt_version_number,
+                  ((sout_input_sys_t *)p_sys->p_pcr_input->p_sys)->ts.i_pid,
+                  &sdt,
+                  p_sys->i_num_pmt, pmt, p_sys->i_pmt_program_number,
+                  p_mux->i_nb_inputs, mappeds );
+        p_sys->p_pmt_cache = chain.p_first;
     }
 
-    BuildPMT( p_sys->p_dvbpsi, VLC_OBJECT(p_mux), p_sys->standard,
-              c, (PEStoTSCallback)BufferChainAppend,
-              p_sys->i_tsid, p_sys->i_pmt_version_number,
-              ((sout_input_sys_t *)p_sys->p_pcr_input->p_sys)->ts.i_pid,
-              &p_sys->sdt,
-              p_sys->i_num_pmt, p_sys->pmt, p_sys->i_pmt_program_number,
-              p_mux->i_nb_inputs, mappeds );
+    PSICacheEmit( p_sys, c, p_sys->p_pmt_cache );
 }
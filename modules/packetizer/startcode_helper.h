@@ -25,6 +25,12 @@
 #if !defined(CAN_COMPILE_SSE2) && defined(HAVE_SSE2_INTRINSICS)
    #include <emmintrin.h>
 #endif
+#ifdef HAVE_AVX2_INTRINSICS
+   #include <immintrin.h>
+#endif
+#ifdef __ARM_NEON
+   #include <arm_neon.h>
+#endif
 
 /* Looks up efficiently for an AnnexB startcode 0x00 0x00 0x01
  * by using a 4 times faster trick than single byte lookup. */
@@ -109,6 +115,105 @@ static inline const uint8_t * startcode_FindAnnexB_SSE2( const uint8_t *p, const
 
 #endif
 
+#ifdef HAVE_AVX2_INTRINSICS
+
+__attribute__ ((__target__ ("avx2")))
+static inline const uint8_t * startcode_FindAnnexB_AVX2( const uint8_t *p, const uint8_t *end )
+{
+    /* First align to 32 */
+    const uint8_t *alignedend = p + 32 - ((intptr_t)p & 31);
+    for (end -= 3; p < alignedend && p <= end; p++) {
+        if (p[0] == 0 && p[1] == 0 && p[2] == 1)
+            return p;
+    }
+
+    if( p == end )
+        return NULL;
+
+    alignedend = end - ((intptr_t) end & 31);
+    if( alignedend > p )
+    {
+        const __m256i zeros = _mm256_setzero_si256();
+        for( ; p < alignedend; p += 32)
+        {
+            __m256i v = _mm256_load_si256((__m256i*)p);
+            __m256i res = _mm256_cmpeq_epi8( zeros, v );
+            /* mask will be in reversed match order */
+            uint32_t match = _mm256_movemask_epi8( res );
+            if( match & 0x0000000F )
+                TRY_MATCH(p, 0);
+            if( match & 0x000000F0 )
+                TRY_MATCH(p, 4);
+            if( match & 0x00000F00 )
+                TRY_MATCH(p, 8);
+            if( match & 0x0000F000 )
+                TRY_MATCH(p, 12);
+            if( match & 0x000F0000 )
+                TRY_MATCH(p, 16);
+            if( match & 0x00F00000 )
+                TRY_MATCH(p, 20);
+            if( match & 0x0F000000 )
+                TRY_MATCH(p, 24);
+            if( match & 0xF0000000 )
+                TRY_MATCH(p, 28);
+        }
+    }
+
+    for (; p <= end; p++) {
+        if (p[0] == 0 && p[1] == 0 && p[2] == 1)
+            return p;
+    }
+
+    return NULL;
+}
+
+#endif
+
+#ifdef __ARM_NEON
+
+static inline const uint8_t * startcode_FindAnnexB_NEON( const uint8_t *p, const uint8_t *end )
+{
+    const uint8_t *alignedend = p + 16 - ((intptr_t)p & 15);
+    for (end -= 3; p < alignedend && p <= end; p++) {
+        if (p[0] == 0 && p[1] == 0 && p[2] == 1)
+            return p;
+    }
+
+    if( p == end )
+        return NULL;
+
+    alignedend = end - ((intptr_t) end & 15);
+    if( alignedend > p )
+    {
+        for( ; p < alignedend; p += 16)
+        {
+            uint8x16_t v = vld1q_u8(p);
+            uint8x16_t res = vceqq_u8(v, vdupq_n_u8(0));
+            /* Narrow the per-byte 0x00/0xFF lanes to a per-byte nibble mask,
+             * the NEON idiom replacing x86 movemask. */
+            uint64_t match = vget_lane_u64(vreinterpret_u64_u8(
+                vshrn_n_u16(vreinterpretq_u16_u8(res), 4)), 0);
+            if( match & 0x000000000000FFFF )
+                TRY_MATCH(p, 0);
+            if( match & 0x00000000FFFF0000 )
+                TRY_MATCH(p, 4);
+            if( match & 0x0000FFFF00000000 )
+                TRY_MATCH(p, 8);
+            if( match & 0xFFFF000000000000 )
+                TRY_MATCH(p, 12);
+        }
+    }
+
+    for (; p <= end; p++) {
+        if (p[0] == 0 && p[1] == 0 && p[2] == 1)
+            return p;
+    }
+
+    return NULL;
+}
+
+#endif
+
 /* That code is adapted from libav's ff_avc_find_startcode_internal
  * and i believe the trick originated from
  * https://graphics.stanford.edu/~seander/bithacks.html#ZeroInWord
@@ -140,16 +245,44 @@ static inline const uint8_t * startcode_FindAnnexB_Bits( const uint8_t *p, const
 }
 #undef TRY_MATCH
 
-#if defined(CAN_COMPILE_SSE2) || defined(HAVE_SSE2_INTRINSICS)
+#if defined(HAVE_AVX2_INTRINSICS) || \
+    defined(CAN_COMPILE_SSE2) || defined(HAVE_SSE2_INTRINSICS) || \
+    defined(__ARM_NEON)
 static inline const uint8_t * startcode_FindAnnexB( const uint8_t *p, const uint8_t *end )
 {
+#ifdef HAVE_AVX2_INTRINSICS
+    if (vlc_CPU_AVX2())
+        return startcode_FindAnnexB_AVX2(p, end);
+#endif
+#if defined(CAN_COMPILE_SSE2) || defined(HAVE_SSE2_INTRINSICS)
     if (vlc_CPU_SSE2())
         return startcode_FindAnnexB_SSE2(p, end);
-    else
-        return startcode_FindAnnexB_Bits(p, end);
+#endif
+#ifdef __ARM_NEON
+    if (vlc_CPU_ARM_NEON())
+        return startcode_FindAnnexB_NEON(p, end);
+#endif
+    return startcode_FindAnnexB_Bits(p, end);
 }
 #else
     #define startcode_FindAnnexB startcode_FindAnnexB_Bits
 #endif
 
+/* Collects every AnnexB startcode of the buffer in a single pass.
+ * Returns the number of startcodes stored in pp_sc (at most i_max); scanning
+ * can be resumed past the last returned startcode if the array was full. */
+static inline size_t startcode_FindAnnexB_Batch( const uint8_t *p, const uint8_t *end,
+                                                 const uint8_t **pp_sc, size_t i_max )
+{
+    size_t i_count = 0;
+
+    while( i_count < i_max && ( p = startcode_FindAnnexB( p, end ) ) != NULL )
+    {
+        pp_sc[i_count++] = p;
+        p += 3;
+    }
+
+    return i_count;
+}
+
 #endif
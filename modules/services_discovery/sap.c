@@ -77,11 +77,14 @@
 #define SAP_V4_LINK_ADDRESS     "224.0.0.255"
 #define ADD_SESSION 1
 
-static int Decompress( const unsigned char *psz_src, unsigned char **_dst, int i_len )
+/* Inflates into a pooled buffer: *pp_dst/*pi_dst_alloc persist across calls
+ * so that the buffer is grown once and then reused for every packet. */
+static int Decompress( const unsigned char *psz_src, unsigned char **pp_dst,
+                       size_t *pi_dst_alloc, int i_len )
 {
 #ifdef HAVE_ZLIB_H
-    int i_result, i_dstsize, n = 0;
-    unsigned char *psz_dst = NULL;
+    int i_result, i_dstsize;
+    size_t i_used = 0;
     z_stream d_stream;
 
     memset (&d_stream, 0, sizeof (d_stream));
@@ -95,18 +98,21 @@ static int Decompress( const unsigned char *psz_src, unsigned char **_dst, int i
 
     do
     {
-        n++;
-        psz_dst = xrealloc( psz_dst, n * 1000 );
-        d_stream.next_out = (Bytef *)&psz_dst[(n - 1) * 1000];
-        d_stream.avail_out = 1000;
+        if( *pi_dst_alloc - i_used < 1000 )
+        {
+            *pi_dst_alloc = *pi_dst_alloc ? 2 * *pi_dst_alloc : 4000;
+            *pp_dst = xrealloc( *pp_dst, *pi_dst_alloc );
+        }
+        d_stream.next_out = (Bytef *)(*pp_dst + i_used);
+        d_stream.avail_out = *pi_dst_alloc - i_used;
 
         i_result = inflate(&d_stream, Z_NO_FLUSH);
         if( ( i_result != Z_OK ) && ( i_result != Z_STREAM_END ) )
         {
             inflateEnd( &d_stream );
-            free( psz_dst );
             return( -1 );
         }
+        i_used = d_stream.total_out;
     }
     while( ( d_stream.avail_out == 0 ) && ( d_stream.avail_in != 0 ) &&
            ( i_result != Z_STREAM_END ) );
@@ -114,12 +120,11 @@ static int Decompress( const unsigned char *psz_src, unsigned char **_dst, int i
     i_dstsize = d_stream.total_out;
     inflateEnd( &d_stream );
 
-    *_dst = xrealloc( psz_dst, i_dstsize );
-
     return i_dstsize;
 #else
     (void)psz_src;
-    (void)_dst;
+    (void)pp_dst;
+    (void)pi_dst_alloc;
     (void)i_len;
     return -1;
 #endif
@@ -127,6 +132,8 @@ static int Decompress( const unsigned char *psz_src, unsigned char **_dst, int i
 
 typedef struct sap_announce_t
 {
+    struct sap_announce_t *p_next; /**< Hash bucket chaining */
+
     vlc_tick_t i_last;
     vlc_tick_t i_period;
     uint8_t i_period_trust;
@@ -137,6 +144,19 @@ typedef struct sap_announce_t
     input_item_t * p_item;
 } sap_announce_t;
 
+/* Announces are indexed on (message ID hash, source address), so that each
+ * datagram costs one bucket walk rather than a scan of every known session. */
+#define SAP_BUCKETS 256
+
+static unsigned HashAnnounce( uint16_t i_hash, const uint32_t *i_source )
+{
+    uint32_t h = i_hash;
+
+    for( int i = 0; i < 4; i++ )
+        h = h * 31 + i_source[i];
+    return h % SAP_BUCKETS;
+}
+
 static sap_announce_t *CreateAnnounce(services_discovery_t *p_sd,
                                       const uint32_t *i_source,
                                       uint16_t i_hash, const char *psz_sdp)
@@ -221,11 +241,17 @@ typedef struct
     int i_fd;
     int *pi_fd;
 
-    /* Table of announces */
+    /* Hash table of announces */
     int i_announces;
-    struct sap_announce_t **pp_announces;
+    struct sap_announce_t *p_buckets[SAP_BUCKETS];
+    /* Earliest time at which an announce could possibly expire */
+    vlc_tick_t i_next_check;
 
     vlc_tick_t i_timeout;
+
+    /* Pooled decompression buffer, reused across packets */
+    unsigned char *p_decomp;
+    size_t i_decomp_alloc;
 } services_discovery_sys_t;
 
 static int RemoveAnnounce( services_discovery_t *p_sd,
@@ -239,7 +265,13 @@ static int RemoveAnnounce( services_discovery_t *p_sd,
     }
 
     services_discovery_sys_t *p_sys = p_sd->p_sys;
-    TAB_REMOVE(p_sys->i_announces, p_sys->pp_announces, p_announce);
+    sap_announce_t **pp = &p_sys->p_buckets[HashAnnounce( p_announce->i_hash,
+                                                          p_announce->i_source )];
+
+    while( *pp != p_announce )
+        pp = &(*pp)->p_next;
+    *pp = p_announce->p_next;
+    p_sys->i_announces--;
     free( p_announce );
 
     return VLC_SUCCESS;
@@ -312,19 +344,23 @@ static int ParseSAP( services_discovery_t *p_sd, const uint8_t *buf,
     if (buf > end)
         return VLC_EGENERIC;
 
-    uint8_t *decomp = NULL;
     if( b_compressed )
     {
-        int newsize = Decompress (buf, &decomp, end - buf);
+        int newsize = Decompress (buf, &p_sys->p_decomp,
+                                  &p_sys->i_decomp_alloc, end - buf);
         if (newsize < 0)
         {
             msg_Dbg( p_sd, "decompression of SAP packet failed" );
             return VLC_EGENERIC;
         }
 
-        decomp = xrealloc (decomp, newsize + 1);
-        decomp[newsize] = '\0';
-        psz_sdp = (const char *)decomp;
+        if( (size_t)newsize + 1 > p_sys->i_decomp_alloc )
+        {
+            p_sys->i_decomp_alloc = newsize + 1;
+            p_sys->p_decomp = xrealloc (p_sys->p_decomp, newsize + 1);
+        }
+        p_sys->p_decomp[newsize] = '\0';
+        psz_sdp = (const char *)p_sys->p_decomp;
         len = newsize;
     }
     else
@@ -345,21 +381,22 @@ static int ParseSAP( services_discovery_t *p_sd, const uint8_t *buf,
         if (strcmp (psz_sdp, "application/sdp"))
         {
             msg_Dbg (p_sd, "unsupported content type: %s", psz_sdp);
-            goto error;
+            return VLC_EGENERIC;
         }
 
         // skips content type
         if (len <= clen)
-            goto error;
+            return VLC_EGENERIC;
 
         len -= clen;
         psz_sdp += clen;
     }
 
-    for( int i = 0 ; i < p_sys->i_announces ; i++ )
+    unsigned bucket = HashAnnounce( i_hash, i_source );
+
+    for( sap_announce_t *p_announce = p_sys->p_buckets[bucket];
+         p_announce != NULL; p_announce = p_announce->p_next )
     {
-        sap_announce_t * p_announce = p_sys->pp_announces[i];
-        /* FIXME: slow */
         if (p_announce->i_hash == i_hash
          && memcmp(p_announce->i_source, i_source, sizeof (i_source)) == 0)
         {
@@ -384,20 +421,22 @@ static int ParseSAP( services_discovery_t *p_sd, const uint8_t *buf,
                 p_announce->i_period = ( p_announce->i_period * (p_announce->i_period_trust-1) + (now - p_announce->i_last) ) / p_announce->i_period_trust;
                 p_announce->i_last = now;
             }
-            free (decomp);
             return VLC_SUCCESS;
         }
     }
 
     sap_announce_t *sap = CreateAnnounce(p_sd, i_source, i_hash, psz_sdp);
     if (sap != NULL)
-        TAB_APPEND(p_sys->i_announces, p_sys->pp_announces, sap);
+    {
+        sap->p_next = p_sys->p_buckets[bucket];
+        p_sys->p_buckets[bucket] = sap;
+        p_sys->i_announces++;
 
-    free (decomp);
+        /* The new announce may expire before the next scheduled sweep */
+        if( p_sys->i_next_check > sap->i_last + p_sys->i_timeout )
+            p_sys->i_next_check = sap->i_last + p_sys->i_timeout;
+    }
     return VLC_SUCCESS;
-error:
-    free (decomp);
-    return VLC_EGENERIC;
 }
 
 /*****************************************************************************
@@ -524,35 +563,50 @@ static void *Run( void *data )
 
         vlc_tick_t now = vlc_tick_now();
 
-        /* A 1 hour timeout correspond to the RFC Implicit timeout.
-         * This timeout is tuned in the following loop. */
-        timeout = 1000 * 60 * 60;
-
-        /* Check for items that need deletion */
-        for( int i = 0; i < p_sys->i_announces; i++ )
+        /* Expiry checks are batched: the table is only swept once the
+         * earliest possible deadline has been reached, not on every packet. */
+        if( now >= p_sys->i_next_check )
         {
-            sap_announce_t * p_announce = p_sys->pp_announces[i];
-            vlc_tick_t i_last_period = now - p_announce->i_last;
-
-            /* Remove the announcement, if the last announcement was 1 hour ago
-             * or if the last packet emitted was 10 times the average time
-             * between two packets */
-            if( ( p_announce->i_period_trust > 5 && i_last_period > 10 * p_announce->i_period ) ||
-                i_last_period > p_sys->i_timeout )
-            {
-                RemoveAnnounce( p_sd, p_announce );
-            }
-            else
+            /* A 1 hour timeout correspond to the RFC Implicit timeout.
+             * This timeout is tuned in the following loop. */
+            timeout = 1000 * 60 * 60;
+
+            /* Check for items that need deletion */
+            for( unsigned b = 0; b < SAP_BUCKETS; b++ )
+            for( sap_announce_t *p_announce = p_sys->p_buckets[b], *p_next;
+                 p_announce != NULL; p_announce = p_next )
             {
-                /* Compute next timeout */
-                if( p_announce->i_period_trust > 5 )
-                    timeout = __MIN(MS_FROM_VLC_TICK(10 * p_announce->i_period - i_last_period), timeout);
-                timeout = __MIN(MS_FROM_VLC_TICK(p_sys->i_timeout - i_last_period), timeout);
+                vlc_tick_t i_last_period = now - p_announce->i_last;
+
+                p_next = p_announce->p_next;
+
+                /* Remove the announcement, if the last announcement was 1 hour ago
+                 * or if the last packet emitted was 10 times the average time
+                 * between two packets */
+                if( ( p_announce->i_period_trust > 5 && i_last_period > 10 * p_announce->i_period ) ||
+                    i_last_period > p_sys->i_timeout )
+                {
+                    RemoveAnnounce( p_sd, p_announce );
+                }
+                else
+                {
+                    /* Compute next timeout */
+                    if( p_announce->i_period_trust > 5 )
+                        timeout = __MIN(MS_FROM_VLC_TICK(10 * p_announce->i_period - i_last_period), timeout);
+                    timeout = __MIN(MS_FROM_VLC_TICK(p_sys->i_timeout - i_last_period), timeout);
+                }
             }
+
+            p_sys->i_next_check = now + VLC_TICK_FROM_MS(timeout);
         }
+        else
+            timeout = MS_FROM_VLC_TICK(p_sys->i_next_check - now);
 
         if( !p_sys->i_announces )
+        {
             timeout = -1; /* We can safely poll indefinitely. */
+            p_sys->i_next_check = INT64_MAX;
+        }
         else if( timeout < 200 )
             timeout = 200; /* Don't wakeup too fast. */
     }
@@ -566,7 +620,7 @@ static int Open( vlc_object_t *p_this )
 {
     services_discovery_t *p_sd = ( services_discovery_t* )p_this;
     services_discovery_sys_t *p_sys  = (services_discovery_sys_t *)
-                                malloc( sizeof( services_discovery_sys_t ) );
+                                calloc( 1, sizeof( services_discovery_sys_t ) );
     if( !p_sys )
         return VLC_ENOMEM;
 
@@ -579,7 +633,7 @@ static int Open( vlc_object_t *p_this )
     p_sys->i_fd = 0;
 
     p_sys->i_announces = 0;
-    p_sys->pp_announces = NULL;
+    p_sys->i_next_check = INT64_MAX;
     /* TODO: create sockets here, and fix racy sockets table */
     if (vlc_clone (&p_sys->thread, Run, p_sd, VLC_THREAD_PRIORITY_LOW))
     {
@@ -608,12 +662,11 @@ static void Close( vlc_object_t *p_this )
     }
     FREENULL( p_sys->pi_fd );
 
-    for( i = p_sys->i_announces  - 1;  i>= 0; i-- )
-    {
-        RemoveAnnounce( p_sd, p_sys->pp_announces[i] );
-    }
-    FREENULL( p_sys->pp_announces );
+    for( i = 0; i < SAP_BUCKETS; i++ )
+        while( p_sys->p_buckets[i] != NULL )
+            RemoveAnnounce( p_sd, p_sys->p_buckets[i] );
 
+    free( p_sys->p_decomp );
     free( p_sys );
 }
 
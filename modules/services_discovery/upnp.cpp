@@ -345,6 +345,8 @@ static void CloseSD( vlc_object_t *p_this )
 
     vlc_join( p_sys->thread, NULL );
     p_sys->p_upnp->removeListener( p_sys->p_server_list );
+    /* Join the description fetchers before the UPnP instance goes away */
+    p_sys->p_server_list.reset();
     p_sys->p_upnp->release();
     delete p_sys;
 }
@@ -372,13 +374,159 @@ MediaServerDesc::~MediaServerDesc()
 MediaServerList::MediaServerList( services_discovery_t* p_sd )
     : m_sd( p_sd )
 {
+    /* Device descriptions are fetched by a bounded set of workers, so that
+     * a discovery storm does not serialize on the libupnp callback thread */
+    while ( m_nbWorkers < MAX_FETCH_THREADS )
+    {
+        if ( vlc_clone( &m_workers[m_nbWorkers], FetchWorker, this,
+                        VLC_THREAD_PRIORITY_LOW ) )
+            break;
+        m_nbWorkers++;
+    }
+    if ( m_nbWorkers == 0 )
+        msg_Warn( p_sd, "cannot spawn description fetchers, "
+                  "will fetch synchronously" );
 }
 
 MediaServerList::~MediaServerList()
 {
+    {
+        vlc::threads::mutex_locker lock( m_lock );
+        m_dead = true;
+        m_cond.broadcast();
+    }
+    for ( unsigned i = 0; i < m_nbWorkers; i++ )
+        vlc_join( m_workers[i], NULL );
     vlc_delete_all(m_list);
 }
 
+void *MediaServerList::FetchWorker( void* opaque )
+{
+    static_cast<MediaServerList*>( opaque )->fetchLoop();
+    return NULL;
+}
+
+void MediaServerList::fetchLoop()
+{
+    for ( ;; )
+    {
+        FetchJob job;
+        {
+            vlc::threads::mutex_locker lock( m_lock );
+            while ( !m_dead && m_queue.empty() )
+                m_cond.wait( m_lock );
+            if ( m_dead )
+                break;
+            job = m_queue.front();
+            m_queue.pop_front();
+        }
+        fetchDescription( job );
+    }
+}
+
+std::string MediaServerList::cacheLookup( const std::string& key )
+{
+    std::list<std::pair<std::string, std::string>>::iterator it;
+    for ( it = m_descCache.begin(); it != m_descCache.end(); ++it )
+    {
+        if ( it->first == key )
+        {
+            /* move to the front of the LRU */
+            m_descCache.splice( m_descCache.begin(), m_descCache, it );
+            return it->second;
+        }
+    }
+    return std::string();
+}
+
+void MediaServerList::cacheStore( const std::string& key,
+                                  const std::string& xml )
+{
+    std::list<std::pair<std::string, std::string>>::iterator it;
+    for ( it = m_descCache.begin(); it != m_descCache.end(); ++it )
+    {
+        if ( it->first == key )
+        {
+            m_descCache.splice( m_descCache.begin(), m_descCache, it );
+            it->second = xml;
+            return;
+        }
+    }
+    m_descCache.push_front( std::make_pair( key, xml ) );
+    while ( m_descCache.size() > MAX_CACHED_DESCRIPTIONS )
+        m_descCache.pop_back();
+}
+
+void MediaServerList::queueFetch( const std::string& udn,
+                                  const std::string& location )
+{
+    FetchJob job;
+    job.udn = udn;
+    job.location = location;
+
+    {
+        vlc::threads::mutex_locker lock( m_lock );
+        /* Only changes are propagated to the core: a device that is already
+         * exposed, or whose description is already queued, needs no fetch */
+        if ( !udn.empty()
+          && ( getServer( udn ) != NULL || m_pending.count( udn ) != 0 ) )
+            return;
+        /* The location embeds the description version: it changes whenever
+         * the device reboots or its configuration is updated */
+        job.description = cacheLookup( udn + '\n' + location );
+        if ( m_nbWorkers > 0 )
+        {
+            if ( !udn.empty() )
+                m_pending.insert( udn );
+            m_queue.push_back( job );
+            m_cond.signal();
+            return;
+        }
+    }
+    /* No worker thread available: fetch synchronously as before */
+    fetchDescription( job );
+}
+
+void MediaServerList::fetchDescription( const FetchJob& job )
+{
+    IXML_Document* p_doc = NULL;
+    bool b_cached = !job.description.empty();
+
+    if ( b_cached )
+        p_doc = ixmlParseBuffer( job.description.c_str() );
+    if ( !p_doc )
+    {
+        b_cached = false;
+        int i_res = UpnpDownloadXmlDoc( job.location.c_str(), &p_doc );
+        if ( i_res != UPNP_E_SUCCESS )
+        {
+            msg_Warn( m_sd, "Could not download device description! "
+                            "Fetching data from %s failed: %s",
+                            job.location.c_str(), UpnpGetErrorMessage( i_res ) );
+            vlc::threads::mutex_locker lock( m_lock );
+            m_pending.erase( job.udn );
+            return;
+        }
+    }
+
+    {
+        vlc::threads::mutex_locker lock( m_lock );
+        parseNewServer( p_doc, job.location );
+        if ( !b_cached )
+        {
+            DOMString psz_xml = ixmlPrintDocument( p_doc );
+            if ( psz_xml )
+            {
+                cacheStore( job.udn + '\n' + job.location, psz_xml );
+                ixmlFreeDOMString( psz_xml );
+            }
+        }
+        m_pending.erase( job.udn );
+    }
+    ixmlDocument_free( p_doc );
+}
+
+/* Called with m_lock held */
 bool MediaServerList::addServer( MediaServerDesc* desc )
 {
     input_item_t* p_input_item = NULL;
@@ -432,6 +580,7 @@ bool MediaServerList::addServer( MediaServerDesc* desc )
     return true;
 }
 
+/* Called with m_lock held */
 MediaServerDesc* MediaServerList::getServer( const std::string& udn )
 {
     std::vector<MediaServerDesc*>::const_iterator it = m_list.begin();
@@ -757,6 +906,8 @@ MediaServerList::parseSatipServer( IXML_Element* p_device_element, const char *p
 
 void MediaServerList::removeServer( const std::string& udn )
 {
+    vlc::threads::mutex_locker lock( m_lock );
+
     MediaServerDesc* p_server = getServer( udn );
     if ( !p_server )
         return;
@@ -789,20 +940,10 @@ int MediaServerList::onEvent( Upnp_EventType event_type, UpnpEventPtr p_event, v
     {
         const UpnpDiscovery* p_discovery = ( const UpnpDiscovery* )p_event;
 
-        IXML_Document *p_description_doc = NULL;
-
-        int i_res;
-        i_res = UpnpDownloadXmlDoc( UpnpDiscovery_get_Location_cstr( p_discovery ), &p_description_doc );
-
-        if ( i_res != UPNP_E_SUCCESS )
-        {
-            msg_Warn( m_sd, "Could not download device description! "
-                            "Fetching data from %s failed: %s",
-                            UpnpDiscovery_get_Location_cstr( p_discovery ), UpnpGetErrorMessage( i_res ) );
-            return i_res;
-        }
-        parseNewServer( p_description_doc, UpnpDiscovery_get_Location_cstr( p_discovery ) );
-        ixmlDocument_free( p_description_doc );
+        const char* psz_udn = UpnpDiscovery_get_DeviceID_cstr( p_discovery );
+        const char* psz_location = UpnpDiscovery_get_Location_cstr( p_discovery );
+        if ( psz_location )
+            queueFetch( psz_udn ? psz_udn : "", psz_location );
     }
     break;
 
@@ -24,6 +24,8 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
  *****************************************************************************/
 
+#include <list>
+#include <set>
 #include <vector>
 #include <string>
 
@@ -68,13 +70,44 @@ public:
                  void* p_user_data ) override;
 
 private:
+    enum
+    {
+        MAX_FETCH_THREADS = 4,       /* concurrent description fetches */
+        MAX_CACHED_DESCRIPTIONS = 32 /* LRU'ed device descriptions */
+    };
+
+    struct FetchJob
+    {
+        std::string udn;
+        std::string location;
+        std::string description; /* cached XML, empty if it must be fetched */
+    };
+
     void parseNewServer( IXML_Document* doc, const std::string& location );
     void parseSatipServer( IXML_Element* p_device_elem, const char *psz_base_url, const char *psz_udn, const char *psz_friendly_name, std::string iconUrl );
     std::string getIconURL( IXML_Element* p_device_elem , const char* psz_base_url );
 
+    void queueFetch( const std::string& udn, const std::string& location );
+    void fetchDescription( const FetchJob& job );
+    void fetchLoop();
+    static void *FetchWorker( void* opaque );
+    std::string cacheLookup( const std::string& key );
+    void cacheStore( const std::string& key, const std::string& xml );
+
 private:
     services_discovery_t* const m_sd;
     std::vector<MediaServerDesc*> m_list;
+
+    vlc::threads::mutex m_lock;
+    vlc::threads::condition_variable m_cond;
+    std::list<FetchJob> m_queue;
+    /* devices whose description is queued or being fetched */
+    std::set<std::string> m_pending;
+    /* device descriptions, most recently used first */
+    std::list<std::pair<std::string, std::string>> m_descCache;
+    vlc_thread_t m_workers[MAX_FETCH_THREADS];
+    unsigned m_nbWorkers = 0;
+    bool m_dead = false;
 };
 
 }
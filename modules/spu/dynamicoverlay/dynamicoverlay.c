@@ -330,6 +330,26 @@ static subpicture_t *Filter( filter_t *p_filter, vlc_tick_t date )
         }
     }
 
+    /* Pick up buffer flips on shared memory overlays. The client bumps the
+     * sequence number once it has finished rendering into the back buffer. */
+    for( overlay_t **pp_ovl = p_sys->overlays.pp_head;
+         pp_ovl < p_sys->overlays.pp_tail; ++pp_ovl )
+    {
+        overlay_t *p_ovl = *pp_ovl;
+        if( p_ovl == NULL || p_ovl->p_shm == NULL )
+            continue;
+
+        uint32_t i_seqno =
+            ((volatile overlay_shmheader_t *)p_ovl->p_shm)->i_seqno;
+        if( i_seqno == p_ovl->i_seqno )
+            continue;
+
+        p_ovl->i_seqno = i_seqno;
+        p_ovl->data.p_pic = p_ovl->pp_shmpic[i_seqno & 1];
+        if( p_ovl->b_active )
+            p_sys->b_updated = true;
+    }
+
     if( !p_sys->b_updated )
         return NULL;
 
@@ -350,24 +370,44 @@ static subpicture_t *Filter( filter_t *p_filter, vlc_tick_t date )
     {
         subpicture_region_t *p_region;
 
-        *pp_region = p_region = subpicture_region_New( &p_overlay->format );
-        if( !p_region )
-            break;
-
-        msg_Dbg( p_filter, "Displaying overlay: %4.4s, %d, %d, %d",
-                 (char*)&p_overlay->format.i_chroma, p_overlay->i_x, p_overlay->i_y,
-                 p_overlay->i_alpha );
-
-        if( p_overlay->format.i_chroma == VLC_CODEC_TEXT )
+        if( p_overlay->p_shm != NULL )
         {
-            p_region->p_text = text_segment_New( p_overlay->data.p_text );
-            p_region->p_text->style = text_style_Duplicate( p_overlay->p_fontstyle );
+            /* Reference the client's front buffer instead of copying it.
+             * The region is created with a small dummy format so no
+             * picture is allocated, then rewritten to the real one. */
+            video_format_t fmt = p_overlay->format;
+            fmt.i_width = fmt.i_visible_width = 4;
+            fmt.i_height = fmt.i_visible_height = 4;
+            fmt.p_palette = NULL;
+            *pp_region = p_region = subpicture_region_New( &fmt );
+            if( !p_region )
+                break;
+            picture_Release( p_region->p_picture );
+            p_region->p_picture = picture_Hold( p_overlay->data.p_pic );
+            video_format_Clean( &p_region->fmt );
+            video_format_Copy( &p_region->fmt, &p_overlay->format );
         }
         else
         {
-            /* FIXME the copy is probably not needed anymore */
-            picture_Copy( p_region->p_picture, p_overlay->data.p_pic );
+            *pp_region = p_region = subpicture_region_New( &p_overlay->format );
+            if( !p_region )
+                break;
+
+            if( p_overlay->format.i_chroma == VLC_CODEC_TEXT )
+            {
+                p_region->p_text = text_segment_New( p_overlay->data.p_text );
+                p_region->p_text->style = text_style_Duplicate( p_overlay->p_fontstyle );
+            }
+            else
+            {
+                /* FIXME the copy is probably not needed anymore */
+                picture_Copy( p_region->p_picture, p_overlay->data.p_pic );
+            }
         }
+
+        msg_Dbg( p_filter, "Displaying overlay: %4.4s, %d, %d, %d",
+                 (char*)&p_overlay->format.i_chroma, p_overlay->i_x, p_overlay->i_y,
+                 p_overlay->i_alpha );
         p_region->i_x = p_overlay->i_x;
         p_region->i_y = p_overlay->i_y;
         p_region->i_align = SUBPICTURE_ALIGN_LEFT | SUBPICTURE_ALIGN_TOP;
@@ -126,6 +126,15 @@ int QueueTransfer( queue_t *p_sink, queue_t *p_source );
  * overlay_t: Overlay descriptor
  *****************************************************************************/
 
+/** Layout of a shared memory segment attached with AttachSharedMem. The
+ * header is followed by two packed frame buffers. The client renders into
+ * the buffer not currently displayed, then increments i_seqno; the buffer
+ * (i_seqno & 1) becomes the displayed front buffer. */
+typedef struct overlay_shmheader_t
+{
+    uint32_t i_seqno;                /**< flip counter, bumped by the client */
+} overlay_shmheader_t;
+
 typedef struct overlay_t
 {
     int i_x, i_y;
@@ -138,10 +147,16 @@ typedef struct overlay_t
         picture_t *p_pic;
         char *p_text;
     } data;
+
+    /* Shared memory double buffering state (AttachSharedMem) */
+    void *p_shm;                  /**< persistent mapping, NULL if detached */
+    uint32_t i_seqno;                  /**< last sequence number displayed */
+    picture_t *pp_shmpic[2];   /**< pictures wrapping the two frame buffers */
 } overlay_t;
 
 overlay_t *OverlayCreate( void );
 int OverlayDestroy( overlay_t *p_ovl );
+void OverlayDetachShm( overlay_t *p_ovl );
 
 /*****************************************************************************
  * list_t: Command queue
@@ -27,6 +27,7 @@
 
 #include <vlc_common.h>
 #include <vlc_arrays.h>
+#include <vlc_atomic.h>
 #include <vlc_vout.h>
 #include <vlc_filter.h>
 
@@ -58,18 +59,75 @@ overlay_t *OverlayCreate( void )
                         0, 0, 1, 1 );
     p_ovl->p_fontstyle = text_style_Create( STYLE_NO_DEFAULTS );
     p_ovl->data.p_text = NULL;
+    p_ovl->p_shm = NULL;
+    p_ovl->i_seqno = 0;
+    p_ovl->pp_shmpic[0] = p_ovl->pp_shmpic[1] = NULL;
 
     return p_ovl;
 }
 
 int OverlayDestroy( overlay_t *p_ovl )
 {
-    free( p_ovl->data.p_text );
+    if( p_ovl->p_shm != NULL )
+        OverlayDetachShm( p_ovl );
+    else
+        free( p_ovl->data.p_text );
     text_style_Delete( p_ovl->p_fontstyle );
 
     return VLC_SUCCESS;
 }
 
+#if defined(HAVE_SYS_SHM_H)
+/* The mapping is refcounted by the pictures wrapping its frame buffers, so
+ * the segment stays attached as long as the vout references one of them. */
+typedef struct
+{
+    vlc_atomic_rc_t rc;
+    void *p_base;
+} shm_mapping_t;
+
+static void ShmPictureDestroy( picture_t *p_pic )
+{
+    shm_mapping_t *p_map = p_pic->p_sys;
+
+    if( vlc_atomic_rc_dec( &p_map->rc ) )
+    {
+        shmdt( p_map->p_base );
+        free( p_map );
+    }
+}
+
+static picture_t *ShmPictureWrap( const picture_t *p_template,
+                                  shm_mapping_t *p_map, uint8_t *p_buffer )
+{
+    picture_resource_t res = { .p_sys = p_map,
+                               .pf_destroy = ShmPictureDestroy };
+
+    for( int i_plane = 0; i_plane < p_template->i_planes; ++i_plane )
+    {
+        res.p[i_plane].p_pixels = p_buffer;
+        res.p[i_plane].i_lines = p_template->p[i_plane].i_visible_lines;
+        res.p[i_plane].i_pitch = p_template->p[i_plane].i_visible_pitch;
+        p_buffer += res.p[i_plane].i_lines * res.p[i_plane].i_pitch;
+    }
+    return picture_NewFromResource( &p_template->format, &res );
+}
+#endif
+
+void OverlayDetachShm( overlay_t *p_ovl )
+{
+    if( p_ovl->p_shm == NULL )
+        return;
+
+    picture_Release( p_ovl->pp_shmpic[0] );
+    picture_Release( p_ovl->pp_shmpic[1] );
+    p_ovl->pp_shmpic[0] = p_ovl->pp_shmpic[1] = NULL;
+    p_ovl->data.p_pic = NULL;
+    p_ovl->p_shm = NULL;
+    video_format_Setup( &p_ovl->format, VLC_FOURCC( '\0','\0','\0','\0'), 0, 0,
+                        0, 0, 1, 1 );
+}
+
 /*****************************************************************************
  * Command parsers
  *****************************************************************************/
@@ -418,6 +476,131 @@ static int unparse_GetVisibility( const commandparams_t *p_results,
 /*****************************************************************************
  * Command functions
  *****************************************************************************/
+static int exec_AttachSharedMem( filter_t *p_filter,
+                                 const commandparams_t *p_params,
+                                 commandparams_t *p_results )
+{
+#if defined(HAVE_SYS_SHM_H)
+    filter_sys_t *p_sys = p_filter->p_sys;
+    struct shmid_ds shminfo;
+    shm_mapping_t *p_map;
+    picture_t *p_template;
+    overlay_t *p_ovl;
+    size_t i_size, i_framesize = 0;
+
+    VLC_UNUSED(p_results);
+
+    p_ovl = ListGet( &p_sys->overlays, p_params->i_id );
+    if( p_ovl == NULL )
+    {
+        msg_Err( p_filter, "Invalid overlay: %d", p_params->i_id );
+        return VLC_EGENERIC;
+    }
+
+    if( p_params->fourcc == VLC_CODEC_TEXT )
+    {
+        msg_Err( p_filter, "Cannot attach shared memory to a text overlay" );
+        return VLC_EGENERIC;
+    }
+
+    if( shmctl( p_params->i_shmid, IPC_STAT, &shminfo ) == -1 )
+    {
+        msg_Err( p_filter, "Unable to access shared memory" );
+        return VLC_EGENERIC;
+    }
+    i_size = shminfo.shm_segsz;
+
+    /* Use a temporary picture to compute the packed frame size */
+    p_template = picture_New( p_params->fourcc,
+                              p_params->i_width, p_params->i_height, 1, 1 );
+    if( p_template == NULL )
+        return VLC_ENOMEM;
+
+    for( int i_plane = 0; i_plane < p_template->i_planes; ++i_plane )
+    {
+        i_framesize += p_template->p[i_plane].i_visible_lines *
+                       p_template->p[i_plane].i_visible_pitch;
+    }
+
+    if( sizeof(overlay_shmheader_t) + 2 * i_framesize > i_size )
+    {
+        msg_Err( p_filter,
+                 "Insufficient data in shared memory. need %zu, got %zu",
+                 sizeof(overlay_shmheader_t) + 2 * i_framesize, i_size );
+        picture_Release( p_template );
+        return VLC_EGENERIC;
+    }
+
+    p_map = malloc( sizeof( *p_map ) );
+    if( p_map == NULL )
+    {
+        picture_Release( p_template );
+        return VLC_ENOMEM;
+    }
+
+    p_map->p_base = shmat( p_params->i_shmid, NULL, SHM_RDONLY );
+    if( p_map->p_base == (void *)-1 )
+    {
+        msg_Err( p_filter, "Unable to attach to shared memory" );
+        free( p_map );
+        picture_Release( p_template );
+        return VLC_ENOMEM;
+    }
+
+    /* The reference count matches the number of wrapping pictures */
+    vlc_atomic_rc_init( &p_map->rc );
+
+    uint8_t *p_buffers = (uint8_t *)p_map->p_base
+                       + sizeof(overlay_shmheader_t);
+    picture_t *p_front = ShmPictureWrap( p_template, p_map, p_buffers );
+    if( p_front == NULL )
+    {
+        shmdt( p_map->p_base );
+        free( p_map );
+        picture_Release( p_template );
+        return VLC_ENOMEM;
+    }
+
+    picture_t *p_back = ShmPictureWrap( p_template, p_map,
+                                        p_buffers + i_framesize );
+    if( p_back == NULL )
+    {
+        picture_Release( p_front );
+        picture_Release( p_template );
+        return VLC_ENOMEM;
+    }
+    vlc_atomic_rc_inc( &p_map->rc );
+
+    /* Replace any previous content of the overlay */
+    if( p_ovl->p_shm != NULL )
+        OverlayDetachShm( p_ovl );
+    else if( p_ovl->format.i_chroma == VLC_CODEC_TEXT )
+        free( p_ovl->data.p_text );
+    else if( p_ovl->data.p_pic != NULL )
+        picture_Release( p_ovl->data.p_pic );
+
+    p_ovl->format = p_template->format;
+    p_ovl->p_shm = p_map->p_base;
+    p_ovl->pp_shmpic[0] = p_front;
+    p_ovl->pp_shmpic[1] = p_back;
+    p_ovl->i_seqno =
+        ((volatile overlay_shmheader_t *)p_ovl->p_shm)->i_seqno;
+    p_ovl->data.p_pic = p_ovl->pp_shmpic[p_ovl->i_seqno & 1];
+
+    picture_Release( p_template );
+
+    p_sys->b_updated = p_ovl->b_active;
+
+    return VLC_SUCCESS;
+#else
+    VLC_UNUSED(p_params);
+    VLC_UNUSED(p_results);
+
+    msg_Err( p_filter, "system doesn't support shared memory" );
+    return VLC_EGENERIC;
+#endif
+}
+
 static int exec_DataSharedMem( filter_t *p_filter,
                                const commandparams_t *p_params,
                                commandparams_t *p_results )
@@ -437,6 +620,9 @@ static int exec_DataSharedMem( filter_t *p_filter,
         return VLC_EGENERIC;
     }
 
+    /* Release any mapping set up by AttachSharedMem */
+    OverlayDetachShm( p_ovl );
+
     if( shmctl( p_params->i_shmid, IPC_STAT, &shminfo ) == -1 )
     {
         msg_Err( p_filter, "Unable to access shared memory" );
@@ -796,6 +982,12 @@ static int exec_StartAtomic( filter_t *p_filter,
  *****************************************************************************/
 static const commanddesc_static_t p_commands[] =
 {
+    {   .psz_command = "AttachSharedMem",
+        .b_atomic = true,
+        .pf_parser = parser_DataSharedMem,
+        .pf_execute = exec_AttachSharedMem,
+        .pf_unparse = unparse_default,
+    },
     {   .psz_command = "DataSharedMem",
         .b_atomic = true,
         .pf_parser = parser_DataSharedMem,
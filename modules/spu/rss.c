@@ -45,6 +45,8 @@
 #include <vlc_xml.h>
 #include <vlc_charset.h>
 #include <vlc_image.h>
+#include <vlc_memstream.h>
+#include <vlc_modules.h>
 
 /*****************************************************************************
  * Local prototypes
@@ -57,6 +59,9 @@ static struct rss_feed_t *FetchRSS( filter_t * );
 static void FreeRSS( struct rss_feed_t *, int );
 static int ParseUrls( filter_t *, char * );
 
+static filter_t *CreateTextRenderer( filter_t * );
+static void DeleteTextRenderer( filter_t * );
+
 static void Fetch( void * );
 
 static const int pi_color_values[] = {
@@ -121,6 +126,17 @@ typedef struct
     int i_cur_feed;
     int i_cur_item;
     int i_cur_char;
+
+    /* Pre-rendered ticker strip, invalidated on content updates only */
+    filter_t *p_text;          /**< private text renderer, may be NULL */
+    picture_t *p_strip;        /**< rendered scroll line */
+    picture_t *p_title_pic;    /**< rendered pinned feed title, may be NULL */
+    video_format_t strip_fmt;
+    video_format_t title_fmt;
+    int i_strip_x;             /**< current scroll offset, in pixels */
+    int i_char_px;             /**< average character width in the strip */
+    int i_window_px;           /**< visible window width, in pixels */
+    bool b_strip_valid;
 } filter_sys_t;
 
 #define MSG_TEXT N_("Feed URLs")
@@ -256,6 +272,14 @@ static int CreateFilter( vlc_object_t *p_this )
         return VLC_EGENERIC;
     }
 
+    p_sys->p_text = NULL;
+    p_sys->p_strip = NULL;
+    p_sys->p_title_pic = NULL;
+    video_format_Init( &p_sys->strip_fmt, 0 );
+    video_format_Init( &p_sys->title_fmt, 0 );
+    p_sys->i_strip_x = 0;
+    p_sys->b_strip_valid = false;
+
     /* Fill the p_sys structure with the configuration */
     p_sys->i_title = var_CreateGetInteger( p_filter, CFG_PREFIX "title" );
     p_sys->i_cur_feed = 0;
@@ -306,6 +330,15 @@ static int CreateFilter( vlc_object_t *p_this )
     p_sys->last_date = (vlc_tick_t)0;
     p_sys->b_fetched = false;
 
+    /* Private text renderer: the ticker line is pre-rendered to a wide
+     * strip once per content change, and cheap cropped regions are
+     * emitted per scroll step. Without it, fall back to emitting a text
+     * region (re-rendered downstream) on every step. */
+    p_sys->p_text = CreateTextRenderer( p_filter );
+    if( p_sys->p_text == NULL )
+        msg_Warn( p_filter, "no text renderer, "
+                  "the feed will be re-rendered at every scroll step" );
+
     /* Create and arm the timer */
     if( vlc_timer_create( &p_sys->timer, Fetch, p_filter ) )
         goto error;
@@ -315,6 +348,8 @@ static int CreateFilter( vlc_object_t *p_this )
     return VLC_SUCCESS;
 
 error:
+    if( p_sys->p_text )
+        DeleteTextRenderer( p_sys->p_text );
     if( p_sys->p_style )
         text_style_Delete( p_sys->p_style );
     free( p_sys->psz_marquee );
@@ -332,12 +367,323 @@ static void DestroyFilter( vlc_object_t *p_this )
 
     vlc_timer_destroy( p_sys->timer );
 
+    if( p_sys->p_text )
+        DeleteTextRenderer( p_sys->p_text );
+    if( p_sys->p_strip )
+        picture_Release( p_sys->p_strip );
+    if( p_sys->p_title_pic )
+        picture_Release( p_sys->p_title_pic );
+    video_format_Clean( &p_sys->strip_fmt );
+    video_format_Clean( &p_sys->title_fmt );
+
     text_style_Delete( p_sys->p_style );
     free( p_sys->psz_marquee );
     FreeRSS( p_sys->p_feeds, p_sys->i_feeds );
     free( p_sys );
 }
 
+/****************************************************************************
+ * Ticker strip cache
+ ****************************************************************************
+ * The whole feed line is rasterized once per content change; each scroll
+ * step then only references a cropped window of the cached strip.
+ ****************************************************************************/
+
+/* Reference dimensions the strip is rendered against */
+#define STRIP_REF_WIDTH  1920
+#define STRIP_REF_HEIGHT 1080
+
+static filter_t *CreateTextRenderer( filter_t *p_filter )
+{
+    filter_t *p_text = vlc_custom_create( p_filter, sizeof( *p_text ),
+                                          "rss text" );
+    if( !p_text )
+        return NULL;
+
+    es_format_Init( &p_text->fmt_in, VIDEO_ES, 0 );
+    es_format_Init( &p_text->fmt_out, VIDEO_ES, 0 );
+    p_text->fmt_out.video.i_width          =
+    p_text->fmt_out.video.i_visible_width  = STRIP_REF_WIDTH;
+    p_text->fmt_out.video.i_height         =
+    p_text->fmt_out.video.i_visible_height = STRIP_REF_HEIGHT;
+
+    p_text->p_module = module_need_var( p_text, "text renderer",
+                                        "text-renderer" );
+    if( !p_text->p_module )
+    {
+        vlc_object_delete( p_text );
+        return NULL;
+    }
+    return p_text;
+}
+
+static void DeleteTextRenderer( filter_t *p_text )
+{
+    module_unneed( p_text, p_text->p_module );
+    es_format_Clean( &p_text->fmt_in );
+    es_format_Clean( &p_text->fmt_out );
+    vlc_object_delete( p_text );
+}
+
+/* Counts displayed characters, to derive the scroll step from the strip */
+static int CountChars( const char *psz )
+{
+    int i_chars = 0;
+
+    for( ; *psz; psz++ )
+        if( ( *psz & 0xC0 ) != 0x80 )
+            i_chars++;
+    return i_chars;
+}
+
+/* Rasterizes psz_text into *pp_pic, releasing the previous picture */
+static int RenderStrip( filter_t *p_filter, const char *psz_text,
+                        picture_t **pp_pic, video_format_t *p_fmt )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    filter_t *p_text = p_sys->p_text;
+    video_format_t fmt;
+
+    static const vlc_fourcc_t chroma_list[] = { VLC_CODEC_YUVA, 0 };
+
+    video_format_Init( &fmt, VLC_CODEC_TEXT );
+    fmt.i_sar_num = fmt.i_sar_den = 1;
+    /* assume rendered text is in sRGB */
+    fmt.transfer = TRANSFER_FUNC_SRGB;
+    fmt.primaries = COLOR_PRIMARIES_SRGB;
+    fmt.space = COLOR_SPACE_SRGB;
+    fmt.color_range = COLOR_RANGE_FULL;
+
+    subpicture_region_t *p_region = subpicture_region_New( &fmt );
+    video_format_Clean( &fmt );
+    if( !p_region )
+        return VLC_ENOMEM;
+
+    p_region->p_text = text_segment_New( psz_text );
+    if( p_region->p_text )
+        p_region->p_text->style = text_style_Duplicate( p_sys->p_style );
+
+    if( !p_region->p_text
+     || p_text->pf_render( p_text, p_region, p_region, chroma_list )
+     || !p_region->p_picture )
+    {
+        subpicture_region_Delete( p_region );
+        return VLC_EGENERIC;
+    }
+
+    if( *pp_pic )
+        picture_Release( *pp_pic );
+    *pp_pic = picture_Hold( p_region->p_picture );
+    video_format_Clean( p_fmt );
+    video_format_Copy( p_fmt, &p_region->fmt );
+    subpicture_region_Delete( p_region );
+    return VLC_SUCCESS;
+}
+
+/* Builds a region referencing a cached picture, without copying it */
+static subpicture_region_t *PictureRegion( picture_t *p_pic,
+                                           const video_format_t *p_fmt,
+                                           int i_x_offset, int i_width )
+{
+    video_format_t fmt;
+
+    /* The region picture is substituted, so create it as small as possible */
+    video_format_Init( &fmt, VLC_CODEC_YUVA );
+    fmt.i_sar_num = fmt.i_sar_den = 1;
+    fmt.i_width = fmt.i_visible_width = 4;
+    fmt.i_height = fmt.i_visible_height = 4;
+
+    subpicture_region_t *p_region = subpicture_region_New( &fmt );
+    if( !p_region )
+        return NULL;
+
+    picture_Release( p_region->p_picture );
+    p_region->p_picture = picture_Hold( p_pic );
+    video_format_Clean( &p_region->fmt );
+    video_format_Copy( &p_region->fmt, p_fmt );
+    p_region->fmt.i_x_offset += i_x_offset;
+    p_region->fmt.i_visible_width = i_width;
+    return p_region;
+}
+
+/* Re-renders the strip for the current feed. Called with the lock held. */
+static int BuildStrip( filter_t *p_filter )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    rss_feed_t *p_feed = &p_sys->p_feeds[p_sys->i_cur_feed];
+    struct vlc_memstream line;
+
+    /* Pin the feed title on the left unless it must scroll with the items.
+     * Centered and right-aligned tickers keep it in the strip instead. */
+    bool b_show_title = ( !p_feed->p_pic && p_sys->i_title == default_title )
+                     || p_sys->i_title == prepend_title;
+    bool b_pin = b_show_title && p_feed->psz_title != NULL
+              && ( p_sys->i_pos < 0
+                || (p_sys->i_pos & SUBPICTURE_ALIGN_LEFT) );
+
+    if( vlc_memstream_open( &line ) )
+        return VLC_EGENERIC;
+
+    if( p_feed->psz_title != NULL
+     && ( p_sys->i_title == scroll_title || ( b_show_title && !b_pin ) ) )
+        vlc_memstream_printf( &line, "%s : ", p_feed->psz_title );
+
+    for( int i = 0; i < p_feed->i_items; i++ )
+        vlc_memstream_printf( &line, i > 0 ? " - %s" : "%s",
+                              p_feed->p_items[i].psz_title
+                                  ? p_feed->p_items[i].psz_title : "" );
+
+    if( vlc_memstream_close( &line ) )
+        return VLC_EGENERIC;
+
+    int i_ret = VLC_EGENERIC;
+    if( line.length > 0 )
+        i_ret = RenderStrip( p_filter, line.ptr,
+                             &p_sys->p_strip, &p_sys->strip_fmt );
+    if( i_ret == VLC_SUCCESS )
+    {
+        int i_chars = __MAX( CountChars( line.ptr ), 1 );
+
+        p_sys->i_char_px =
+            __MAX( (int)p_sys->strip_fmt.i_visible_width / i_chars, 1 );
+        p_sys->i_window_px = p_sys->i_char_px * p_sys->i_length;
+        p_sys->i_strip_x = 0;
+
+        if( b_pin )
+        {
+            char *psz_title;
+            if( asprintf( &psz_title, "%s : ", p_feed->psz_title ) != -1 )
+            {
+                if( RenderStrip( p_filter, psz_title, &p_sys->p_title_pic,
+                                 &p_sys->title_fmt ) != VLC_SUCCESS )
+                    b_pin = false;
+                free( psz_title );
+            }
+            else
+                b_pin = false;
+        }
+        if( !b_pin && p_sys->p_title_pic != NULL )
+        {
+            picture_Release( p_sys->p_title_pic );
+            p_sys->p_title_pic = NULL;
+        }
+        p_sys->b_strip_valid = true;
+    }
+    free( line.ptr );
+    return i_ret;
+}
+
+/* Emits one scroll step from the cached strip. Called with the lock held. */
+static subpicture_t *FilterStrip( filter_t *p_filter, vlc_tick_t date )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    subpicture_t *p_spu;
+    subpicture_region_t *p_region;
+
+    if( p_sys->last_date
+       + ( p_sys->i_strip_x == 0 ? 5 : 1 )
+       /* ( ... ? 5 : 1 ) means "wait 5 times more at the feed start" */
+       * p_sys->i_speed > date )
+        return NULL;
+
+    if( !p_sys->b_strip_valid && BuildStrip( p_filter ) != VLC_SUCCESS )
+        return NULL;
+
+    rss_feed_t *p_feed = &p_sys->p_feeds[p_sys->i_cur_feed];
+
+    int i_width = __MIN( p_sys->i_window_px,
+                    (int)p_sys->strip_fmt.i_visible_width - p_sys->i_strip_x );
+    if( i_width <= 0 )
+    {
+        /* The strip has scrolled out: move on to the next feed */
+        p_sys->i_cur_feed = (p_sys->i_cur_feed + 1) % p_sys->i_feeds;
+        p_sys->i_strip_x = 0;
+        p_sys->b_strip_valid = false;
+        return NULL;
+    }
+
+    p_sys->last_date = date;
+
+    p_spu = filter_NewSubpicture( p_filter );
+    if( !p_spu )
+        return NULL;
+
+    p_spu->i_start = date;
+    p_spu->i_stop  = 0;
+    p_spu->b_ephemer = true;
+    p_spu->i_original_picture_width = STRIP_REF_WIDTH;
+    p_spu->i_original_picture_height = STRIP_REF_HEIGHT;
+
+    p_region = PictureRegion( p_sys->p_strip, &p_sys->strip_fmt,
+                              p_sys->i_strip_x, i_width );
+    if( !p_region )
+    {
+        subpicture_Delete( p_spu );
+        return NULL;
+    }
+
+    /*  where to locate the string: */
+    if( p_sys->i_pos < 0 )
+    {   /*  set to an absolute xy */
+        p_region->i_align = SUBPICTURE_ALIGN_LEFT | SUBPICTURE_ALIGN_TOP;
+        p_spu->b_absolute = true;
+    }
+    else
+    {   /* set to one of the 9 relative locations */
+        p_region->i_align = p_sys->i_pos;
+        p_spu->b_absolute = false;
+    }
+    p_region->i_x = p_sys->i_xoff;
+    p_region->i_y = p_sys->i_yoff;
+    p_spu->p_region = p_region;
+
+    if( p_sys->p_title_pic )
+    {
+        /* Pinned feed title, with the scroll window right next to it */
+        subpicture_region_t *p_title =
+            PictureRegion( p_sys->p_title_pic, &p_sys->title_fmt, 0,
+                           p_sys->title_fmt.i_visible_width );
+        if( p_title )
+        {
+            p_title->i_align = p_region->i_align;
+            p_title->i_x = p_region->i_x;
+            p_title->i_y = p_region->i_y;
+            p_region->i_x += p_sys->title_fmt.i_visible_width;
+            p_title->p_next = p_spu->p_region;
+            p_spu->p_region = p_title;
+        }
+    }
+
+    if( p_feed->p_pic )
+    {
+        /* Display the feed's image, without copying it */
+        picture_t *p_pic = p_feed->p_pic;
+        subpicture_region_t *p_img =
+            PictureRegion( p_pic, &p_pic->format, 0,
+                           p_pic->format.i_visible_width );
+        if( !p_img )
+        {
+            msg_Err( p_filter, "cannot allocate SPU region" );
+        }
+        else
+        {
+            p_img->i_x = p_sys->i_xoff;
+            p_img->i_y = p_sys->i_yoff;
+            p_img->i_align = p_spu->p_region->i_align;
+            p_img->p_next = p_spu->p_region;
+            p_spu->p_region = p_img;
+
+            /* Offset the text to display right next to the image */
+            for( p_region = p_img->p_next; p_region;
+                 p_region = p_region->p_next )
+                p_region->i_x += p_pic->format.i_visible_width;
+        }
+    }
+
+    p_sys->i_strip_x += p_sys->i_char_px;
+    return p_spu;
+}
+
 /****************************************************************************
  * Filter: the whole thing
  ****************************************************************************
@@ -363,6 +709,13 @@ static subpicture_t *Filter( filter_t *p_filter, vlc_tick_t date )
         return NULL;
     }
 
+    if( p_sys->p_text != NULL )
+    {
+        p_spu = FilterStrip( p_filter, date );
+        vlc_mutex_unlock( &p_sys->lock );
+        return p_spu;
+    }
+
     if( p_sys->last_date
        + ( p_sys->i_cur_char == 0 &&
            p_sys->i_cur_item == ( p_sys->i_title == scroll_title ? -1 : 0 ) ? 5 : 1 )
@@ -1002,6 +1355,8 @@ static void Fetch( void *p_data )
     p_sys->i_cur_feed = 0;
     p_sys->i_cur_item = p_sys->i_title == scroll_title ? -1 : 0;
     p_sys->i_cur_char = 0;
+    p_sys->i_strip_x = 0;
+    p_sys->b_strip_valid = false; /* the strip content went stale */
     vlc_mutex_unlock( &p_sys->lock );
 
     if( p_old_feeds )
@@ -76,6 +76,10 @@ struct private_sys_t
 
     uint64_t i_offset;
 
+    uint64_t i_archive_base; /* source offset where parsing started */
+    uint64_t i_entry_header_offset; /* source offset of the entry header,
+                                       0 if unknown */
+
     uint8_t buffer[ 8192 ];
     bool b_seekable_source;
     bool b_seekable_archive;
@@ -271,6 +275,9 @@ static int archive_init( private_sys_t* p_sys, stream_t* source )
         p_sys->b_seekable_source = false;
     }
 
+    p_sys->i_archive_base = p_sys->b_seekable_source
+                          ? vlc_stream_Tell( source ) : 0;
+
     if( p_sys->b_seekable_source )
     {
         if( archive_read_set_seek_callback( p_sys->p_archive,
@@ -352,6 +359,18 @@ static int archive_seek_subentry( private_sys_t* p_sys, char const* psz_subentry
             if( unlikely( !p_sys->p_entry ) )
                 return VLC_ENOMEM;
 
+            /* Remember where this entry's header sits in the source, so
+             * that a later handle reset can restart right at the entry
+             * instead of rescanning every preceding header. Only valid
+             * when the format is read raw from a single volume (no
+             * compression filter in front of it). */
+
+            la_int64_t header_pos = archive_read_header_position( p_arc );
+
+            if( header_pos >= 0 && p_sys->i_callback_data == 1
+             && archive_filter_code( p_arc, 0 ) == ARCHIVE_FILTER_NONE )
+                p_sys->i_entry_header_offset = p_sys->i_archive_base
+                                             + header_pos;
             break;
         }
 
@@ -388,6 +407,27 @@ static int archive_extractor_reset( stream_extractor_t* p_extractor )
 {
     private_sys_t* p_sys = p_extractor->p_sys;
 
+    /* INDEXED RESET: RESTART PARSING AT THE REMEMBERED ENTRY HEADER */
+
+    if( p_sys->i_entry_header_offset > 0 )
+    {
+        if( archive_clean( p_sys ) == 0
+         && vlc_stream_Seek( p_extractor->source,
+                             p_sys->i_entry_header_offset ) == 0
+         && archive_init( p_sys, p_extractor->source ) == 0
+         && archive_seek_subentry( p_sys, p_extractor->identifier ) == 0 )
+        {
+            p_sys->i_offset = 0;
+            p_sys->b_eof = false;
+            p_sys->b_dead = false;
+            return VLC_SUCCESS;
+        }
+
+        /* The format needed the archive prologue after all */
+        msg_Dbg( p_extractor, "indexed reset failed, rescanning archive" );
+        p_sys->i_entry_header_offset = 0;
+    }
+
     if( vlc_stream_Seek( p_extractor->source, 0 )
         || archive_clean( p_sys )
         || archive_init( p_sys, p_extractor->source )
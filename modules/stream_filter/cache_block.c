@@ -67,6 +67,7 @@
 typedef struct
 {
     block_bytestream_t cache; /* bytestream chain for storing cache */
+    uint64_t i_chain_offset;  /* absolute offset of the chain first byte */
 
     struct
     {
@@ -81,10 +82,19 @@ static int AStreamRefillBlock(stream_t *s)
     stream_sys_t *sys = s->p_sys;
     size_t cache_size = sys->cache.i_total;
 
-    /* Release data */
-    if (cache_size >= STREAM_CACHE_SIZE)
+    /* Release data: drop the oldest blocks before the read pointer, but
+     * only as much as needed, so that the rest of the already read data
+     * remains available for backward seeks */
+    while (cache_size >= STREAM_CACHE_SIZE &&
+           sys->cache.p_chain != sys->cache.p_block)
     {
-        block_BytestreamFlush( &sys->cache );
+        block_t *block = sys->cache.p_chain;
+
+        sys->cache.p_chain = block->p_next;
+        sys->cache.i_total -= block->i_buffer;
+        sys->cache.i_base_offset -= block->i_buffer;
+        sys->i_chain_offset += block->i_buffer;
+        block_Release(block);
         cache_size = sys->cache.i_total;
     }
     if (cache_size >= STREAM_CACHE_SIZE &&
@@ -174,6 +184,7 @@ static void AStreamControlReset(stream_t *s)
     stream_sys_t *sys = s->p_sys;
 
     block_BytestreamEmpty( &sys->cache );
+    sys->i_chain_offset = 0; /* the core resets its offset on title change */
 
     /* Do the prebuffering */
     AStreamPrebufferBlock(s);
@@ -182,15 +193,33 @@ static void AStreamControlReset(stream_t *s)
 static int AStreamSeekBlock(stream_t *s, uint64_t i_pos)
 {
     stream_sys_t *sys = s->p_sys;
+    const uint64_t i_start = sys->i_chain_offset;
+    const uint64_t i_current = i_start + sys->cache.i_base_offset
+                             + sys->cache.i_block_offset;
+
+    if (i_pos >= i_current)
+    {   /* Forward seek within the data cached ahead */
+        if( block_SkipBytes( &sys->cache, i_pos - i_current ) == VLC_SUCCESS )
+            return VLC_SUCCESS;
+    }
+    else if (i_pos >= i_start)
+    {   /* Backward seek within the retained history: rewind the read
+         * pointer to the start of the chain and skip up to the target.
+         * Typical of MP4 box walking, this avoids an upstream seek and
+         * refetching data that was just read. */
+        sys->cache.p_block = sys->cache.p_chain;
+        sys->cache.i_base_offset = 0;
+        sys->cache.i_block_offset = 0;
+        if( block_SkipBytes( &sys->cache, i_pos - i_start ) == VLC_SUCCESS )
+            return VLC_SUCCESS;
+    }
 
-    if( block_SkipBytes( &sys->cache, i_pos) == VLC_SUCCESS )
-        return VLC_SUCCESS;
-
-    /* Not enought bytes, empty and seek */
+    /* Not in cache, empty and seek */
     /* Do the access seek */
     if (vlc_stream_Seek(s->s, i_pos)) return VLC_EGENERIC;
 
     block_BytestreamEmpty( &sys->cache );
+    sys->i_chain_offset = i_pos;
 
     /* Refill a block */
     if (AStreamRefillBlock(s))
@@ -289,6 +318,7 @@ static int Open(vlc_object_t *obj)
 
     /* Init all fields of sys->block */
     block_BytestreamInit( &sys->cache );
+    sys->i_chain_offset = 0;
 
     s->p_sys = sys;
     /* Do the prebuffering */
@@ -32,66 +32,164 @@
 
 typedef struct
 {
+    /* Worker thread state */
     z_stream zstream;
-    bool eof;
+    bool stream_end;
     unsigned char buffer[16384];
+
+    /* Decompression runs on a worker thread, reading the source ahead and
+     * keeping up to two output buffers ready for the reader. */
+    vlc_thread_t thread;
+    vlc_mutex_t lock;
+    vlc_cond_t wait;
+    bool error; /* fatal decompression error */
+    bool done;  /* the worker will not fill any further buffer */
+    unsigned ridx; /* buffer the reader side consumes */
+    struct inflate_buf
+    {
+        unsigned char data[65536];
+        size_t length; /* decompressed byte count */
+        size_t offset; /* bytes already consumed by Read() */
+        bool filled;
+    } out[2];
 } stream_sys_t;
 
-static ssize_t Read(stream_t *stream, void *buf, size_t buflen)
+/* Decompresses up to buflen bytes (worker thread, no lock held).
+ * Returns the byte count, possibly short on end of stream, or -1 on error. */
+static ssize_t Fill(stream_t *stream, unsigned char *buf, size_t buflen)
 {
     stream_sys_t *sys = stream->p_sys;
-    ssize_t val;
-
-    if (sys->eof || unlikely(buflen == 0))
-        return 0;
 
     sys->zstream.next_out = buf;
     sys->zstream.avail_out = buflen;
 
-    if (sys->zstream.avail_in == 0)
-        sys->zstream.next_in = sys->buffer;
+    while (sys->zstream.avail_out > 0 && !sys->stream_end)
+    {
+        ssize_t val;
+
+        if (sys->zstream.avail_in == 0)
+            sys->zstream.next_in = sys->buffer;
 
-    val = (sys->buffer + sizeof (sys->buffer))
-        - (sys->zstream.next_in + sys->zstream.avail_in);
+        val = (sys->buffer + sizeof (sys->buffer))
+            - (sys->zstream.next_in + sys->zstream.avail_in);
 
-    if (val > 0)
-    {   /* Fill input buffer if there is space left */
-        val = vlc_stream_Read(stream->s,
-                          sys->zstream.next_in + sys->zstream.avail_in, val);
-        if (val >= 0)
-            sys->zstream.avail_in += val;
+        if (val > 0)
+        {   /* Fill input buffer if there is space left */
+            val = vlc_stream_Read(stream->s,
+                              sys->zstream.next_in + sys->zstream.avail_in,
+                              val);
+            if (val >= 0)
+                sys->zstream.avail_in += val;
+        }
+
+        if (sys->zstream.avail_in == 0)
+        {
+            msg_Err(stream, "unexpected end of stream");
+            sys->stream_end = true;
+            break;
+        }
+
+        val = inflate(&sys->zstream, Z_SYNC_FLUSH);
+        switch (val)
+        {
+            case Z_STREAM_END:
+                msg_Dbg(stream, "end of stream");
+                sys->stream_end = true;
+                /* fall through */
+            case Z_OK:
+                continue;
+            case Z_DATA_ERROR:
+                msg_Err(stream, "corrupt stream");
+                return -1;
+            case Z_BUF_ERROR:
+                if (sys->zstream.next_in == sys->buffer)
+                    break;
+
+                memmove(sys->buffer, sys->zstream.next_in,
+                        sys->zstream.avail_in);
+                sys->zstream.next_in = sys->buffer;
+                continue;
+        }
+
+        msg_Err(stream, "unhandled decompression error (%zd)", val);
+        return -1;
     }
 
-    if (sys->zstream.avail_in == 0)
+    return buflen - sys->zstream.avail_out;
+}
+
+static void *Thread(void *data)
+{
+    stream_t *stream = data;
+    stream_sys_t *sys = stream->p_sys;
+    unsigned widx = 0;
+    bool done;
+
+    do
     {
-        msg_Err(stream, "unexpected end of stream");
-        return 0;
+        vlc_mutex_lock(&sys->lock);
+        mutex_cleanup_push(&sys->lock);
+        while (sys->out[widx].filled)
+            vlc_cond_wait(&sys->wait, &sys->lock);
+        vlc_cleanup_pop();
+        vlc_mutex_unlock(&sys->lock);
+
+        ssize_t val = Fill(stream, sys->out[widx].data,
+                           sizeof (sys->out[widx].data));
+
+        vlc_mutex_lock(&sys->lock);
+        if (val >= 0)
+        {
+            sys->out[widx].length = val;
+            sys->out[widx].offset = 0;
+            sys->out[widx].filled = true;
+        }
+        else
+            sys->error = true;
+        done = sys->done = sys->error || sys->stream_end;
+        vlc_cond_broadcast(&sys->wait);
+        vlc_mutex_unlock(&sys->lock);
+
+        widx ^= 1;
     }
+    while (!done);
+
+    return NULL;
+}
+
+static ssize_t Read(stream_t *stream, void *buf, size_t buflen)
+{
+    stream_sys_t *sys = stream->p_sys;
+    ssize_t val = -1;
+
+    if (unlikely(buflen == 0))
+        return 0;
 
-    val = inflate(&sys->zstream, Z_SYNC_FLUSH);
-    switch (val)
+    vlc_mutex_lock(&sys->lock);
+    struct inflate_buf *out = &sys->out[sys->ridx];
+
+    while (!out->filled && !sys->error)
+        vlc_cond_wait(&sys->wait, &sys->lock);
+
+    if (out->filled)
     {
-        case Z_STREAM_END:
-            msg_Dbg(stream, "end of stream");
-            sys->eof = true;
-            /* fall through */
-        case Z_OK:
-            return buflen - sys->zstream.avail_out;
-        case Z_DATA_ERROR:
-            msg_Err(stream, "corrupt stream");
-            sys->eof = true;
-            return -1;
-        case Z_BUF_ERROR:
-            if (sys->zstream.next_in == sys->buffer)
-                break;
-
-            memmove(sys->buffer, sys->zstream.next_in, sys->zstream.avail_in);
-            sys->zstream.next_in = sys->buffer;
-            return Read(stream, buf, buflen);
-    }
+        size_t avail = out->length - out->offset;
 
-    msg_Err(stream, "unhandled decompression error (%zd)", val);
-    return -1;
+        val = (buflen < avail) ? buflen : avail;
+        memcpy(buf, out->data + out->offset, val);
+        out->offset += val;
+
+        if (out->offset == out->length
+         && !(sys->done && !sys->out[sys->ridx ^ 1].filled))
+        {   /* Hand the buffer back, unless it is the last one: an exhausted
+             * final buffer remains as end-of-stream marker. */
+            out->filled = false;
+            sys->ridx ^= 1;
+            vlc_cond_broadcast(&sys->wait);
+        }
+    }
+    vlc_mutex_unlock(&sys->lock);
+    return val;
 }
 
 static int Seek(stream_t *stream, uint64_t offset)
@@ -160,7 +258,14 @@ static int Open(vlc_object_t *obj)
     sys->zstream.zalloc = Z_NULL;
     sys->zstream.zfree = Z_NULL;
     sys->zstream.opaque = Z_NULL;
-    sys->eof = false;
+    sys->stream_end = false;
+    sys->error = false;
+    sys->done = false;
+    sys->ridx = 0;
+    sys->out[0].filled = false;
+    sys->out[1].filled = false;
+    vlc_mutex_init(&sys->lock);
+    vlc_cond_init(&sys->wait);
 
     int ret = inflateInit2(&sys->zstream, bits);
     if (ret != Z_OK)
@@ -170,6 +275,14 @@ static int Open(vlc_object_t *obj)
     }
 
     stream->p_sys = sys;
+
+    if (vlc_clone(&sys->thread, Thread, stream, VLC_THREAD_PRIORITY_INPUT))
+    {
+        inflateEnd(&sys->zstream);
+        free(sys);
+        return VLC_EGENERIC;
+    }
+
     stream->pf_read = Read;
     stream->pf_seek = Seek;
     stream->pf_control = Control;
@@ -181,6 +294,9 @@ static void Close (vlc_object_t *obj)
     stream_t *stream = (stream_t *)obj;
     stream_sys_t *sys = stream->p_sys;
 
+    vlc_cancel(sys->thread);
+    vlc_join(sys->thread, NULL);
+
     inflateEnd(&sys->zstream);
     free(sys);
 }
@@ -35,6 +35,10 @@
 #include <vlc_fs.h>
 #include <vlc_interrupt.h>
 
+/* Smallest readahead window: the window shrinks down to this during seek
+ * bursts and grows back to the buffer size during linear reading */
+#define PREFETCH_MIN_WINDOW (size_t)(1 << 16)
+
 struct stream_ctrl
 {
     struct stream_ctrl *next;
@@ -74,6 +78,7 @@ typedef struct
     size_t       buffer_size;
     char        *buffer;
     size_t       seek_threshold;
+    size_t       prefetch_limit; /* readahead window past the reader (bytes) */
 
     struct stream_ctrl *controls;
 } stream_sys_t;
@@ -169,6 +174,9 @@ static void *Thread(void *data)
                 sys->buffer_length = 0;
                 assert(!sys->error);
                 sys->eof = false;
+                /* The reader is seeking: shrink the readahead window */
+                sys->prefetch_limit = __MAX(sys->prefetch_limit / 2,
+                                            PREFETCH_MIN_WINDOW);
             }
             else
             {
@@ -205,6 +213,9 @@ static void *Thread(void *data)
                 sys->buffer_length = 0;
                 assert(!sys->error);
                 assert(!sys->eof);
+                /* The reader is seeking: shrink the readahead window */
+                sys->prefetch_limit = __MAX(sys->prefetch_limit / 2,
+                                            PREFETCH_MIN_WINDOW);
             }
             else
             {   /* Seek failure is not necessarily fatal here. We could read
@@ -220,6 +231,21 @@ static void *Thread(void *data)
 
         assert(sys->buffer_size >= sys->buffer_length);
 
+        /* Only prefetch up to prefetch_limit bytes past the reader. The
+         * window shrinks when the reader seeks and grows back while it
+         * reads linearly, so that seek-heavy probing (e.g. MP4 box
+         * parsing over a high-latency mount) does not fetch and discard
+         * a whole buffer at every jump. */
+        uint64_t ahead = 0;
+        if (sys->buffer_offset + sys->buffer_length > stream_offset)
+            ahead = sys->buffer_offset + sys->buffer_length - stream_offset;
+
+        if (ahead >= sys->prefetch_limit)
+        {   /* Wait for the reader before prefetching any deeper */
+            vlc_cond_wait(&sys->wait_space, &sys->lock);
+            continue;
+        }
+
         size_t len = sys->buffer_size - sys->buffer_length;
         if (len == 0)
         {   /* Buffer is full */
@@ -241,6 +267,8 @@ static void *Thread(void *data)
          /* Do not step past the sharp edge of the circular buffer */
         if (offset + len > sys->buffer_size)
             len = sys->buffer_size - offset;
+        if (len > sys->prefetch_limit - ahead)
+            len = sys->prefetch_limit - ahead;
 
         ssize_t val = ThreadRead(stream, sys->buffer + offset, len);
         if (val < 0)
@@ -255,6 +283,10 @@ static void *Thread(void *data)
         assert((size_t)val <= len);
         sys->buffer_length += val;
         assert(sys->buffer_length <= sys->buffer_size);
+        /* Linear reading: grow the window back by the amount read */
+        if (sys->prefetch_limit < sys->buffer_size)
+            sys->prefetch_limit = __MIN(sys->prefetch_limit + (size_t)val,
+                                        sys->buffer_size);
         //msg_Dbg(stream, "buffer: %zu/%zu", sys->buffer_length,
         //        sys->buffer_size);
         vlc_cond_signal(&sys->wait_data);
@@ -473,6 +505,10 @@ static int Open(vlc_object_t *obj)
             sys->buffer_size = size;
     }
 
+    /* Start with a modest window: streams are probed (seeked around) right
+     * after open, and the window grows back quickly on linear reading */
+    sys->prefetch_limit = __MIN(sys->buffer_size, (size_t)(1 << 20));
+
     sys->buffer = malloc(sys->buffer_size);
     if (sys->buffer == NULL)
         goto error;
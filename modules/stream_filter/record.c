@@ -34,6 +34,11 @@
 #include <vlc_stream.h>
 #include <vlc_input_item.h>
 #include <vlc_fs.h>
+#include <vlc_block.h>
+
+#ifdef HAVE_POSIX_FALLOCATE
+# include <unistd.h>
+#endif
 
 
 /*****************************************************************************
@@ -53,10 +58,28 @@ vlc_module_end()
 /*****************************************************************************
  *
  *****************************************************************************/
+/* Maximum number of bytes queued to the writer thread before the recorder
+ * starts dropping data rather than stalling the reader */
+#define RECORD_FIFO_SIZE (1 << 25)
+
 typedef struct
 {
     FILE *f;        /* TODO it could be replaced by access_output_t one day */
     bool b_error;
+
+    /* Asynchronous writer (reader side) */
+    bool b_recording;
+    bool b_drop;
+    block_fifo_t *p_fifo;
+    vlc_thread_t thread;
+
+    /* Segment rotation (writer side) */
+    char *psz_extension;
+    unsigned i_segment_id;
+    uint64_t i_segment_size;   /* Rotation threshold in bytes (0: disabled) */
+    vlc_tick_t i_segment_time; /* Rotation period (0: disabled) */
+    uint64_t i_written;        /* Bytes written to the current segment */
+    vlc_tick_t i_segment_date; /* Opening date of the current segment */
 } stream_sys_t;
 
 
@@ -69,6 +92,9 @@ static int  Control( stream_t *, int i_query, va_list );
 
 static int  Start  ( stream_t *, const char *psz_extension );
 static int  Stop   ( stream_t * );
+static void *WriterThread( void * );
+static int  SegmentStart( stream_t * );
+static void SegmentStop( stream_t * );
 static void Write  ( stream_t *, const uint8_t *p_buffer, size_t i_buffer );
 
 /****************************************************************************
@@ -88,6 +114,9 @@ static int Open ( vlc_object_t *p_this )
         return VLC_ENOMEM;
 
     p_sys->f = NULL;
+    p_sys->b_recording = false;
+    p_sys->p_fifo = NULL;
+    p_sys->psz_extension = NULL;
 
     /* */
     s->pf_read = Read;
@@ -105,7 +134,7 @@ static void Close( vlc_object_t *p_this )
     stream_t *s = (stream_t*)p_this;
     stream_sys_t *p_sys = s->p_sys;
 
-    if( p_sys->f )
+    if( p_sys->b_recording )
         Stop( s );
 
     free( p_sys );
@@ -120,11 +149,37 @@ static ssize_t Read( stream_t *s, void *p_read, size_t i_read )
     void *p_record = p_read;
     const ssize_t i_record = vlc_stream_Read( s->s, p_record, i_read );
 
-    /* Dump read data */
-    if( p_sys->f )
+    /* Queue read data to the writer thread */
+    if( p_sys->b_recording && p_record && i_record > 0 )
     {
-        if( p_record && i_record > 0 )
-            Write( s, p_record, i_record );
+        block_t *p_block = block_Alloc( i_record );
+        if( likely(p_block != NULL) )
+        {
+            memcpy( p_block->p_buffer, p_record, i_record );
+
+            vlc_fifo_Lock( p_sys->p_fifo );
+            if( vlc_fifo_GetBytes( p_sys->p_fifo ) >= RECORD_FIFO_SIZE )
+            {   /* The writer cannot keep up with the stream. Dropping data
+                 * is preferable to stalling the reader thread. */
+                vlc_fifo_Unlock( p_sys->p_fifo );
+                block_Release( p_block );
+                if( !p_sys->b_drop )
+                {
+                    msg_Err( s, "Failed to record data (queue overflow)" );
+                    p_sys->b_drop = true;
+                }
+            }
+            else
+            {
+                vlc_fifo_QueueUnlocked( p_sys->p_fifo, p_block );
+                vlc_fifo_Unlock( p_sys->p_fifo );
+                if( p_sys->b_drop )
+                {
+                    msg_Warn( s, "Record queue drained, resuming" );
+                    p_sys->b_drop = false;
+                }
+            }
+        }
     }
 
     return i_record;
@@ -146,7 +201,7 @@ static int Control( stream_t *s, int i_query, va_list args )
     if( b_active )
         psz_extension = va_arg( args, const char* );
 
-    if( !sys->f == !b_active )
+    if( sys->b_recording == b_active )
         return VLC_SUCCESS;
 
     if( b_active )
@@ -162,13 +217,103 @@ static int Start( stream_t *s, const char *psz_extension )
 {
     stream_sys_t *p_sys = s->p_sys;
 
-    char *psz_file;
-    FILE *f;
-
     /* */
     if( !psz_extension )
         psz_extension = "dat";
 
+    p_sys->psz_extension = strdup( psz_extension );
+    if( !p_sys->psz_extension )
+        return VLC_ENOMEM;
+
+    p_sys->i_segment_size =
+        (uint64_t)var_InheritInteger( s, "input-record-segment-size" ) << 20;
+    p_sys->i_segment_time =
+        vlc_tick_from_sec( var_InheritInteger( s, "input-record-segment-time" ) );
+    p_sys->i_segment_id = 0;
+    p_sys->b_error = false;
+    p_sys->b_drop = false;
+
+    p_sys->p_fifo = block_FifoNew();
+    if( !p_sys->p_fifo )
+        goto error;
+
+    if( SegmentStart( s ) )
+        goto error;
+
+    if( vlc_clone( &p_sys->thread, WriterThread, s,
+                   VLC_THREAD_PRIORITY_LOW ) )
+    {
+        SegmentStop( s );
+        goto error;
+    }
+
+    p_sys->b_recording = true;
+    return VLC_SUCCESS;
+
+error:
+    if( p_sys->p_fifo )
+    {
+        block_FifoRelease( p_sys->p_fifo );
+        p_sys->p_fifo = NULL;
+    }
+    FREENULL( p_sys->psz_extension );
+    return VLC_EGENERIC;
+}
+static int Stop( stream_t *s )
+{
+    stream_sys_t *p_sys = s->p_sys;
+
+    assert( p_sys->b_recording );
+
+    vlc_cancel( p_sys->thread );
+    vlc_join( p_sys->thread, NULL );
+
+    /* Flush whatever the writer has not consumed yet */
+    vlc_fifo_Lock( p_sys->p_fifo );
+    block_t *p_block = vlc_fifo_DequeueAllUnlocked( p_sys->p_fifo );
+    vlc_fifo_Unlock( p_sys->p_fifo );
+    while( p_block )
+    {
+        block_t *p_next = p_block->p_next;
+        Write( s, p_block->p_buffer, p_block->i_buffer );
+        block_Release( p_block );
+        p_block = p_next;
+    }
+    block_FifoRelease( p_sys->p_fifo );
+    p_sys->p_fifo = NULL;
+
+    msg_Dbg( s, "Recording completed" );
+    if( p_sys->f )
+        SegmentStop( s );
+    FREENULL( p_sys->psz_extension );
+    p_sys->b_recording = false;
+    return VLC_SUCCESS;
+}
+
+static void *WriterThread( void *p_data )
+{
+    stream_t *s = p_data;
+    stream_sys_t *p_sys = s->p_sys;
+
+    for( ;; )
+    {
+        block_t *p_block = block_FifoGet( p_sys->p_fifo ); /* cancel point */
+
+        int canc = vlc_savecancel();
+        Write( s, p_block->p_buffer, p_block->i_buffer );
+        block_Release( p_block );
+        vlc_restorecancel( canc );
+    }
+    vlc_assert_unreachable();
+}
+
+static int SegmentStart( stream_t *s )
+{
+    stream_sys_t *p_sys = s->p_sys;
+
+    char *psz_file;
+    FILE *f;
+
     /* Retreive path */
     char *psz_path = var_CreateGetNonEmptyString( s, "input-record-path" );
     if( !psz_path )
@@ -179,8 +324,24 @@ static int Start( stream_t *s, const char *psz_extension )
 
     /* Create file name
      * TODO allow prefix configuration */
-    psz_file = input_item_CreateFilename( s->p_input_item, psz_path,
-                                          INPUT_RECORD_PREFIX, psz_extension );
+    if( p_sys->i_segment_size != 0 || p_sys->i_segment_time != 0 )
+    {   /* Number the segments: the date-based prefix alone could collide
+         * when rotating twice within the same second. */
+        char *psz_ext;
+        if( asprintf( &psz_ext, "part%03u.%s", ++p_sys->i_segment_id,
+                      p_sys->psz_extension ) < 0 )
+        {
+            free( psz_path );
+            return VLC_ENOMEM;
+        }
+        psz_file = input_item_CreateFilename( s->p_input_item, psz_path,
+                                              INPUT_RECORD_PREFIX, psz_ext );
+        free( psz_ext );
+    }
+    else
+        psz_file = input_item_CreateFilename( s->p_input_item, psz_path,
+                                              INPUT_RECORD_PREFIX,
+                                              p_sys->psz_extension );
 
     free( psz_path );
 
@@ -194,6 +355,13 @@ static int Start( stream_t *s, const char *psz_extension )
         return VLC_EGENERIC;
     }
 
+#ifdef HAVE_POSIX_FALLOCATE
+    if( p_sys->i_segment_size != 0 )
+        /* Reserve the whole segment up front to avoid fragmentation and
+         * per-write extent allocation. Failure is harmless. */
+        posix_fallocate( fileno( f ), 0, p_sys->i_segment_size );
+#endif
+
     /* signal new record file */
     var_SetString( vlc_object_instance(s), "record-file", psz_file );
 
@@ -202,38 +370,62 @@ static int Start( stream_t *s, const char *psz_extension )
 
     /* */
     p_sys->f = f;
-    p_sys->b_error = false;
+    p_sys->i_written = 0;
+    p_sys->i_segment_date = vlc_tick_now();
     return VLC_SUCCESS;
 }
-static int Stop( stream_t *s )
+
+static void SegmentStop( stream_t *s )
 {
     stream_sys_t *p_sys = s->p_sys;
 
     assert( p_sys->f );
 
-    msg_Dbg( s, "Recording completed" );
+#ifdef HAVE_POSIX_FALLOCATE
+    if( p_sys->i_segment_size != 0 && p_sys->i_written < p_sys->i_segment_size )
+    {   /* Trim the preallocated tail */
+        fflush( p_sys->f );
+        if( ftruncate( fileno( p_sys->f ), p_sys->i_written ) )
+            msg_Warn( s, "cannot trim preallocated segment" );
+    }
+#endif
     fclose( p_sys->f );
     p_sys->f = NULL;
-    return VLC_SUCCESS;
 }
 
 static void Write( stream_t *s, const uint8_t *p_buffer, size_t i_buffer )
 {
     stream_sys_t *p_sys = s->p_sys;
 
-    assert( p_sys->f );
+    if( i_buffer == 0 )
+        return;
 
-    if( i_buffer > 0 )
+    /* Rotate the segment when it exceeds the configured size or duration */
+    if( p_sys->f
+     && ( ( p_sys->i_segment_size != 0
+         && p_sys->i_written + i_buffer > p_sys->i_segment_size )
+       || ( p_sys->i_segment_time != 0
+         && vlc_tick_now() - p_sys->i_segment_date >= p_sys->i_segment_time ) ) )
     {
-        const bool b_previous_error = p_sys->b_error;
-        const size_t i_written = fwrite( p_buffer, 1, i_buffer, p_sys->f );
+        SegmentStop( s );
+        if( SegmentStart( s ) )
+            msg_Err( s, "cannot start new record segment" );
+    }
 
-        p_sys->b_error = i_written != i_buffer;
+    const bool b_previous_error = p_sys->b_error;
+    size_t i_written = 0;
 
-        /* TODO maybe a intf_UserError or something like that ? */
-        if( p_sys->b_error && !b_previous_error )
-            msg_Err( s, "Failed to record data (begin)" );
-        else if( !p_sys->b_error && b_previous_error )
-            msg_Err( s, "Failed to record data (end)" );
+    if( p_sys->f )
+    {
+        i_written = fwrite( p_buffer, 1, i_buffer, p_sys->f );
+        p_sys->i_written += i_written;
     }
+
+    p_sys->b_error = i_written != i_buffer;
+
+    /* TODO maybe a intf_UserError or something like that ? */
+    if( p_sys->b_error && !b_previous_error )
+        msg_Err( s, "Failed to record data (begin)" );
+    else if( !p_sys->b_error && b_previous_error )
+        msg_Err( s, "Failed to record data (end)" );
 }
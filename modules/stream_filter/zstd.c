@@ -0,0 +1,281 @@
+/*****************************************************************************
+ * zstd.c: Zstandard decompression module for VLC
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <zstd.h>
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_stream.h>
+
+typedef struct
+{
+    /* Worker thread state */
+    ZSTD_DStream *zds;
+    bool stream_end;
+    bool frame_done; /* positioned at a frame boundary */
+    ZSTD_inBuffer input;
+    unsigned char buffer[16384];
+
+    /* Decompression runs on a worker thread, reading the source ahead and
+     * keeping up to two output buffers ready for the reader. */
+    vlc_thread_t thread;
+    vlc_mutex_t lock;
+    vlc_cond_t wait;
+    bool error; /* fatal decompression error */
+    bool done;  /* the worker will not fill any further buffer */
+    unsigned ridx; /* buffer the reader side consumes */
+    struct zstd_buf
+    {
+        unsigned char data[65536];
+        size_t length; /* decompressed byte count */
+        size_t offset; /* bytes already consumed by Read() */
+        bool filled;
+    } out[2];
+} stream_sys_t;
+
+/* Decompresses up to buflen bytes (worker thread, no lock held).
+ * Returns the byte count, possibly short on end of stream, or -1 on error. */
+static ssize_t Fill(stream_t *stream, unsigned char *buf, size_t buflen)
+{
+    stream_sys_t *sys = stream->p_sys;
+    ZSTD_outBuffer output = { buf, buflen, 0 };
+
+    while (output.pos < output.size && !sys->stream_end)
+    {
+        if (sys->input.pos == sys->input.size)
+        {
+            ssize_t val = vlc_stream_Read(stream->s, sys->buffer,
+                                          sizeof (sys->buffer));
+            if (val <= 0)
+            {   /* A stream may hold several concatenated frames: the end of
+                 * input is expected if and only if a frame just ended. */
+                if (sys->frame_done)
+                    msg_Dbg(stream, "end of stream");
+                else
+                    msg_Err(stream, "unexpected end of stream");
+                sys->stream_end = true;
+                break;
+            }
+            sys->input.size = val;
+            sys->input.pos = 0;
+        }
+
+        size_t val = ZSTD_decompressStream(sys->zds, &output, &sys->input);
+        if (ZSTD_isError(val))
+        {
+            msg_Err(stream, "corrupt stream: %s", ZSTD_getErrorName(val));
+            return -1;
+        }
+        sys->frame_done = (val == 0);
+    }
+
+    return output.pos;
+}
+
+static void *Thread(void *data)
+{
+    stream_t *stream = data;
+    stream_sys_t *sys = stream->p_sys;
+    unsigned widx = 0;
+    bool done;
+
+    do
+    {
+        vlc_mutex_lock(&sys->lock);
+        mutex_cleanup_push(&sys->lock);
+        while (sys->out[widx].filled)
+            vlc_cond_wait(&sys->wait, &sys->lock);
+        vlc_cleanup_pop();
+        vlc_mutex_unlock(&sys->lock);
+
+        ssize_t val = Fill(stream, sys->out[widx].data,
+                           sizeof (sys->out[widx].data));
+
+        vlc_mutex_lock(&sys->lock);
+        if (val >= 0)
+        {
+            sys->out[widx].length = val;
+            sys->out[widx].offset = 0;
+            sys->out[widx].filled = true;
+        }
+        else
+            sys->error = true;
+        done = sys->done = sys->error || sys->stream_end;
+        vlc_cond_broadcast(&sys->wait);
+        vlc_mutex_unlock(&sys->lock);
+
+        widx ^= 1;
+    }
+    while (!done);
+
+    return NULL;
+}
+
+static ssize_t Read(stream_t *stream, void *buf, size_t buflen)
+{
+    stream_sys_t *sys = stream->p_sys;
+    ssize_t val = -1;
+
+    if (unlikely(buflen == 0))
+        return 0;
+
+    vlc_mutex_lock(&sys->lock);
+    struct zstd_buf *out = &sys->out[sys->ridx];
+
+    while (!out->filled && !sys->error)
+        vlc_cond_wait(&sys->wait, &sys->lock);
+
+    if (out->filled)
+    {
+        size_t avail = out->length - out->offset;
+
+        val = (buflen < avail) ? buflen : avail;
+        memcpy(buf, out->data + out->offset, val);
+        out->offset += val;
+
+        if (out->offset == out->length
+         && !(sys->done && !sys->out[sys->ridx ^ 1].filled))
+        {   /* Hand the buffer back, unless it is the last one: an exhausted
+             * final buffer remains as end-of-stream marker. */
+            out->filled = false;
+            sys->ridx ^= 1;
+            vlc_cond_broadcast(&sys->wait);
+        }
+    }
+    vlc_mutex_unlock(&sys->lock);
+    return val;
+}
+
+static int Seek(stream_t *stream, uint64_t offset)
+{
+    (void) stream; (void) offset;
+    return -1;
+}
+
+static int Control(stream_t *stream, int query, va_list args)
+{
+    switch (query)
+    {
+        case STREAM_CAN_SEEK:
+        case STREAM_CAN_FASTSEEK:
+            *va_arg(args, bool *) = false;
+            break;
+        case STREAM_CAN_PAUSE:
+        case STREAM_CAN_CONTROL_PACE:
+        case STREAM_GET_PTS_DELAY:
+        case STREAM_GET_META:
+        case STREAM_GET_CONTENT_TYPE:
+        case STREAM_GET_SIGNAL:
+        case STREAM_SET_PAUSE_STATE:
+            return vlc_stream_vaControl(stream->s, query, args);
+        case STREAM_GET_SIZE:
+        case STREAM_GET_TITLE_INFO:
+        case STREAM_GET_TITLE:
+        case STREAM_GET_SEEKPOINT:
+        case STREAM_SET_TITLE:
+        case STREAM_SET_SEEKPOINT:
+        case STREAM_SET_PRIVATE_ID_STATE:
+        case STREAM_SET_PRIVATE_ID_CA:
+        case STREAM_GET_PRIVATE_ID_STATE:
+            return VLC_EGENERIC;
+        default:
+            msg_Err(stream, "unimplemented query (%d) in control", query);
+            return VLC_EGENERIC;
+    }
+    return VLC_SUCCESS;
+}
+
+static int Open(vlc_object_t *obj)
+{
+    stream_t *stream = (stream_t *)obj;
+    const uint8_t *peek;
+
+    /* See IETF RFC8878 */
+    if (vlc_stream_Peek(stream->s, &peek, 4) < 4)
+        return VLC_EGENERIC;
+
+    if (memcmp(peek, "\x28\xB5\x2F\xFD", 4))
+        return VLC_EGENERIC;
+
+    stream_sys_t *sys = malloc(sizeof (*sys));
+    if (unlikely(sys == NULL))
+        return VLC_ENOMEM;
+
+    sys->zds = ZSTD_createDStream();
+    if (sys->zds == NULL)
+    {
+        free(sys);
+        return VLC_ENOMEM;
+    }
+
+    sys->input.src = sys->buffer;
+    sys->input.size = 0;
+    sys->input.pos = 0;
+    sys->stream_end = false;
+    sys->frame_done = true;
+    sys->error = false;
+    sys->done = false;
+    sys->ridx = 0;
+    sys->out[0].filled = false;
+    sys->out[1].filled = false;
+    vlc_mutex_init(&sys->lock);
+    vlc_cond_init(&sys->wait);
+
+    stream->p_sys = sys;
+
+    if (vlc_clone(&sys->thread, Thread, stream, VLC_THREAD_PRIORITY_INPUT))
+    {
+        ZSTD_freeDStream(sys->zds);
+        free(sys);
+        return VLC_EGENERIC;
+    }
+
+    stream->pf_read = Read;
+    stream->pf_seek = Seek;
+    stream->pf_control = Control;
+    return VLC_SUCCESS;
+}
+
+static void Close (vlc_object_t *obj)
+{
+    stream_t *stream = (stream_t *)obj;
+    stream_sys_t *sys = stream->p_sys;
+
+    vlc_cancel(sys->thread);
+    vlc_join(sys->thread, NULL);
+
+    ZSTD_freeDStream(sys->zds);
+    free(sys);
+}
+
+vlc_module_begin()
+    set_category(CAT_INPUT)
+    set_subcategory(SUBCAT_INPUT_STREAM_FILTER)
+    set_capability("stream_filter", 330)
+
+    set_description(N_("Zstandard decompression filter"))
+    set_callbacks(Open, Close)
+vlc_module_end()
@@ -34,6 +34,8 @@
 #include <vlc_sout.h>
 #include <vlc_block.h>
 
+#include <stdatomic.h>
+
 /*****************************************************************************
  * Module descriptor
  *****************************************************************************/
@@ -149,17 +151,27 @@ static int   SendIn( sout_stream_t *, void *, block_t * );
 
 typedef struct sout_stream_id_sys_t sout_stream_id_sys_t;
 
+/* Ring capacity per bridged ES; must be a power of two */
+#define BRIDGE_RING_SIZE 256
+
 typedef struct bridged_es_t
 {
     es_format_t fmt;
-    block_t *p_block;
-    block_t **pp_last;
-    bool b_empty;
+
+    /* Lock-free single-producer (bridge-out) single-consumer (bridge-in)
+     * ring of refcounted blocks. The indices are free-running; their
+     * difference is the fill level. */
+    block_t *pp_ring[BRIDGE_RING_SIZE];
+    atomic_uint i_ring_tail; /* producer index */
+    atomic_uint i_ring_head; /* consumer index */
+    atomic_bool b_discont; /* producer dropped data (ring full) */
+
+    atomic_bool b_empty;
+    atomic_bool b_changed;
 
     /* bridge in part */
     sout_stream_id_sys_t *id;
     vlc_tick_t i_last;
-    bool b_changed;
 } bridged_es_t;
 
 typedef struct bridge_t
@@ -168,8 +180,56 @@ typedef struct bridge_t
     int i_es_num;
 } bridge_t;
 
+/* Guards bridge and ES slot lifecycle only (Add/Del/teardown); the per-block
+ * data path never takes it, so bridge-out instances of unrelated channels
+ * do not contend with each other nor with the bridge-in thread. */
 static vlc_mutex_t lock = VLC_STATIC_MUTEX;
 
+static bool ESPush( bridged_es_t *p_es, block_t *p_block )
+{
+    unsigned i_tail = atomic_load_explicit( &p_es->i_ring_tail,
+                                            memory_order_relaxed );
+
+    if ( i_tail - atomic_load_explicit( &p_es->i_ring_head,
+                                        memory_order_acquire )
+            >= BRIDGE_RING_SIZE )
+        return false;
+
+    p_es->pp_ring[i_tail % BRIDGE_RING_SIZE] = p_block;
+    atomic_store_explicit( &p_es->i_ring_tail, i_tail + 1,
+                           memory_order_release );
+    return true;
+}
+
+static block_t *ESPop( bridged_es_t *p_es )
+{
+    unsigned i_head = atomic_load_explicit( &p_es->i_ring_head,
+                                            memory_order_relaxed );
+
+    if ( atomic_load_explicit( &p_es->i_ring_tail, memory_order_acquire )
+            == i_head )
+        return NULL;
+
+    block_t *p_block = p_es->pp_ring[i_head % BRIDGE_RING_SIZE];
+    atomic_store_explicit( &p_es->i_ring_head, i_head + 1,
+                           memory_order_release );
+    return p_block;
+}
+
+static unsigned ESFill( bridged_es_t *p_es )
+{
+    return atomic_load_explicit( &p_es->i_ring_tail, memory_order_acquire )
+         - atomic_load_explicit( &p_es->i_ring_head, memory_order_relaxed );
+}
+
+static void ESFlush( bridged_es_t *p_es )
+{
+    block_t *p_block;
+
+    while ( (p_block = ESPop( p_es )) != NULL )
+        block_Release( p_block );
+}
+
 /*
  * Bridge out
  */
@@ -265,7 +325,8 @@ static void *AddOut( sout_stream_t *p_stream, const es_format_t *p_fmt )
 
     for ( i = 0; i < p_bridge->i_es_num; i++ )
     {
-        if ( p_bridge->pp_es[i]->b_empty && !p_bridge->pp_es[i]->b_changed )
+        if ( atomic_load( &p_bridge->pp_es[i]->b_empty )
+              && !atomic_load( &p_bridge->pp_es[i]->b_changed ) )
             break;
     }
 
@@ -281,13 +342,15 @@ static void *AddOut( sout_stream_t *p_stream, const es_format_t *p_fmt )
 
     p_es->fmt = *p_fmt;
     p_es->fmt.i_id = p_sys->i_id;
-    p_es->p_block = NULL;
-    p_es->pp_last = &p_es->p_block;
-    p_es->b_empty = false;
+    /* reused slots were drained by the bridge-in under the same lock */
+    atomic_init( &p_es->i_ring_tail, 0 );
+    atomic_init( &p_es->i_ring_head, 0 );
+    atomic_init( &p_es->b_discont, false );
+    atomic_init( &p_es->b_empty, false );
 
     p_es->id = NULL;
     p_es->i_last = VLC_TICK_INVALID;
-    p_es->b_changed = true;
+    atomic_init( &p_es->b_changed, true );
 
     msg_Dbg( p_stream, "bridging out input codec=%4.4s id=%d pos=%d",
              (char*)&p_es->fmt.i_codec, p_es->fmt.i_id, i );
@@ -310,11 +373,10 @@ static void DelOut( sout_stream_t *p_stream, void *id )
 
     p_es = p_sys->p_es;
 
-    p_es->b_empty = true;
-    block_ChainRelease( p_es->p_block );
-    p_es->p_block = NULL;
-
-    p_es->b_changed = true;
+    /* leftover ring blocks are drained by the bridge-in (or the bridge
+     * teardown) once it sees the slot empty */
+    atomic_store( &p_es->b_empty, true );
+    atomic_store( &p_es->b_changed, true );
     vlc_mutex_unlock( &lock );
 
     p_sys->b_inited = false;
@@ -331,17 +393,24 @@ static int SendOut( sout_stream_t *p_stream, void *id, block_t *p_buffer )
         return VLC_SUCCESS;
     }
 
-    vlc_mutex_lock( &lock );
-
     p_es = p_sys->p_es;
-    *p_es->pp_last = p_buffer;
+
+    /* wait-free handoff: this instance is the only producer of the slot */
     while ( p_buffer != NULL )
     {
-        p_es->pp_last = &p_buffer->p_next;
-        p_buffer = p_buffer->p_next;
-    }
+        block_t *p_next = p_buffer->p_next;
 
-    vlc_mutex_unlock( &lock );
+        p_buffer->p_next = NULL;
+        if ( !ESPush( p_es, p_buffer ) )
+        {
+            /* the bridge-in is stalled or not draining yet: drop and let it
+             * know the stream is no longer contiguous */
+            block_Release( p_buffer );
+            atomic_store_explicit( &p_es->b_discont, true,
+                                   memory_order_release );
+        }
+        p_buffer = p_next;
+    }
 
     return VLC_SUCCESS;
 }
@@ -517,84 +586,97 @@ static int SendIn( sout_stream_t *p_stream, void *_id, block_t *p_buffer )
     {
     for ( i = 0; i < p_bridge->i_es_num; i++ )
     {
-        if ( !p_bridge->pp_es[i]->b_empty )
+        bridged_es_t *p_es = p_bridge->pp_es[i];
+        bool b_empty = atomic_load_explicit( &p_es->b_empty,
+                                             memory_order_acquire );
+        block_t *p_chain = NULL, **pp_last = &p_chain;
+        block_t *p_block;
+        bool b_dropped = false;
+
+        if ( !b_empty )
             b_no_es = false;
+        else
+            /* the bridge-out left: drain whatever it still queued so the
+             * slot can be reused */
+            ESFlush( p_es );
 
-        while ( p_bridge->pp_es[i]->p_block != NULL
-                 && (p_bridge->pp_es[i]->p_block->i_dts + p_sys->i_delay
-                       < i_date
-                      || p_bridge->pp_es[i]->p_block->i_dts + p_sys->i_delay
-                          < p_bridge->pp_es[i]->i_last) )
-        {
-            block_t *p_block = p_bridge->pp_es[i]->p_block;
-            msg_Dbg( p_stream, "dropping a packet (%"PRId64 ")",
-                     i_date - p_block->i_dts - p_sys->i_delay );
-            p_bridge->pp_es[i]->p_block
-                = p_bridge->pp_es[i]->p_block->p_next;
-            block_Release( p_block );
-        }
-
-        if ( p_bridge->pp_es[i]->p_block == NULL )
-        {
-            p_bridge->pp_es[i]->pp_last = &p_bridge->pp_es[i]->p_block;
-        }
-
-        if ( p_bridge->pp_es[i]->b_changed )
+        if ( atomic_load_explicit( &p_es->b_changed, memory_order_acquire ) )
         {
-            if ( p_bridge->pp_es[i]->b_empty && p_bridge->pp_es[i]->id != NULL )
+            if ( b_empty )
             {
-                sout_StreamIdDel( p_stream->p_next, p_bridge->pp_es[i]->id );
+                if ( p_es->id != NULL )
+                {
+                    sout_StreamIdDel( p_stream->p_next, p_es->id );
+                    p_es->id = NULL;
+                }
             }
             else
             {
                 /* We need at least two packets to enter the mux. */
-                if ( p_bridge->pp_es[i]->p_block == NULL
-                      || p_bridge->pp_es[i]->p_block->p_next == NULL )
-                {
-                    continue;
-                }
+                if ( ESFill( p_es ) < 2 )
+                    continue; /* keep b_changed set, retry next round */
 
-                p_bridge->pp_es[i]->fmt.i_id += p_sys->i_id_offset;
+                p_es->fmt.i_id += p_sys->i_id_offset;
                 if( !p_sys->b_placeholder )
                 {
-                    p_bridge->pp_es[i]->id = sout_StreamIdAdd(
-                                p_stream->p_next, &p_bridge->pp_es[i]->fmt );
-                    if ( p_bridge->pp_es[i]->id == NULL )
+                    p_es->id = sout_StreamIdAdd( p_stream->p_next,
+                                                 &p_es->fmt );
+                    if ( p_es->id == NULL )
                     {
                         msg_Warn( p_stream, "couldn't create chain for id %d",
-                                  p_bridge->pp_es[i]->fmt.i_id );
+                                  p_es->fmt.i_id );
                     }
                 }
                 msg_Dbg( p_stream, "bridging in input codec=%4.4s id=%d pos=%d",
-                         (char*)&p_bridge->pp_es[i]->fmt.i_codec,
-                         p_bridge->pp_es[i]->fmt.i_id, i );
+                         (char*)&p_es->fmt.i_codec, p_es->fmt.i_id, i );
             }
+            atomic_store_explicit( &p_es->b_changed, false,
+                                   memory_order_release );
         }
-        p_bridge->pp_es[i]->b_changed = false;
 
-        if ( p_bridge->pp_es[i]->b_empty )
+        if ( b_empty )
             continue;
 
-        if ( p_bridge->pp_es[i]->p_block == NULL )
+        /* drain the ring, dropping packets that are already late */
+        while ( (p_block = ESPop( p_es )) != NULL )
         {
-            if ( p_bridge->pp_es[i]->id != NULL
-                  && p_bridge->pp_es[i]->i_last < i_date )
+            if ( p_block->i_dts + p_sys->i_delay < i_date
+                  || p_block->i_dts + p_sys->i_delay < p_es->i_last )
+            {
+                msg_Dbg( p_stream, "dropping a packet (%"PRId64 ")",
+                         i_date - p_block->i_dts - p_sys->i_delay );
+                block_Release( p_block );
+                b_dropped = true;
+                continue;
+            }
+            *pp_last = p_block;
+            pp_last = &p_block->p_next;
+        }
+
+        if ( p_chain == NULL )
+        {
+            if ( p_es->id != NULL && p_es->i_last < i_date )
             {
                 if( !p_sys->b_placeholder )
-                    sout_StreamIdDel( p_stream->p_next, p_bridge->pp_es[i]->id );
-                p_bridge->pp_es[i]->fmt.i_id -= p_sys->i_id_offset;
-                p_bridge->pp_es[i]->b_changed = true;
-                p_bridge->pp_es[i]->id = NULL;
+                    sout_StreamIdDel( p_stream->p_next, p_es->id );
+                p_es->fmt.i_id -= p_sys->i_id_offset;
+                atomic_store_explicit( &p_es->b_changed, true,
+                                       memory_order_release );
+                p_es->id = NULL;
             }
             continue;
         }
 
-        if ( p_bridge->pp_es[i]->id != NULL || p_sys->b_placeholder)
+        if ( atomic_exchange_explicit( &p_es->b_discont, false,
+                                       memory_order_acquire ) || b_dropped )
+            p_chain->i_flags |= BLOCK_FLAG_DISCONTINUITY;
+
+        if ( p_es->id != NULL || p_sys->b_placeholder)
         {
-            block_t *p_block = p_bridge->pp_es[i]->p_block;
+            p_block = p_chain;
             while ( p_block != NULL )
             {
-                p_bridge->pp_es[i]->i_last = p_block->i_dts;
+                p_es->i_last = p_block->i_dts;
                 p_block->i_pts += p_sys->i_delay;
                 p_block->i_dts += p_sys->i_delay;
                 p_block = p_block->p_next;
@@ -602,55 +684,60 @@ static int SendIn( sout_stream_t *p_stream, void *_id, block_t *p_buffer )
             sout_stream_id_sys_t *newid = NULL;
             if( p_sys->b_placeholder )
             {
-                switch( p_bridge->pp_es[i]->fmt.i_cat )
+                switch( p_es->fmt.i_cat )
                 {
                     case VIDEO_ES:
                         p_sys->i_last_video = i_date;
                         newid = p_sys->id_video;
                         if( !newid )
+                        {
+                            block_ChainRelease( p_chain );
                             break;
+                        }
                         if( !p_sys->b_switch_on_iframe ||
                             p_sys->i_state == placeholder_off ||
-                            ( p_bridge->pp_es[i]->fmt.i_cat == VIDEO_ES &&
-                              p_bridge->pp_es[i]->p_block->i_flags & BLOCK_FLAG_TYPE_I ) )
+                            ( p_es->fmt.i_cat == VIDEO_ES &&
+                              p_chain->i_flags & BLOCK_FLAG_TYPE_I ) )
                         {
-                            sout_StreamIdSend( p_stream->p_next,
-                                       newid,
-                                       p_bridge->pp_es[i]->p_block );
+                            sout_StreamIdSend( p_stream->p_next, newid,
+                                               p_chain );
                             p_sys->i_state = placeholder_off;
                         }
+                        else
+                            block_ChainRelease( p_chain );
                         break;
                     case AUDIO_ES:
                         newid = p_sys->id_audio;
                         if( !newid )
+                        {
+                            block_ChainRelease( p_chain );
                             break;
+                        }
                         p_sys->i_last_audio = i_date;
                         /* fall through */
                     default:
                         sout_StreamIdSend( p_stream->p_next,
-                                   newid?newid:p_bridge->pp_es[i]->id,
-                                   p_bridge->pp_es[i]->p_block );
+                                           newid ? newid : p_es->id,
+                                           p_chain );
                         break;
                 }
             }
             else /* !b_placeholder */
-                sout_StreamIdSend( p_stream->p_next,
-                                       p_bridge->pp_es[i]->id,
-                                       p_bridge->pp_es[i]->p_block );
+                sout_StreamIdSend( p_stream->p_next, p_es->id, p_chain );
         }
         else
         {
-            block_ChainRelease( p_bridge->pp_es[i]->p_block );
+            block_ChainRelease( p_chain );
         }
-
-        p_bridge->pp_es[i]->p_block = NULL;
-        p_bridge->pp_es[i]->pp_last = &p_bridge->pp_es[i]->p_block;
     }
 
     if( b_no_es )
     {
         for ( i = 0; i < p_bridge->i_es_num; i++ )
+        {
+            ESFlush( p_bridge->pp_es[i] );
             free( p_bridge->pp_es[i] );
+        }
         free( p_bridge->pp_es );
         free( p_bridge );
         var_Destroy( vlc, p_sys->psz_name );
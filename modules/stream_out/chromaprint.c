@@ -145,6 +145,8 @@ static void Finish( sout_stream_t *p_stream )
     }
     p_sys->b_done = true;
     msg_Dbg( p_stream, "Fingerprinting finished" );
+    if ( p_sys->p_data->pf_done )
+        p_sys->p_data->pf_done( p_sys->p_data->p_done_data );
 }
 
 /*****************************************************************************
@@ -203,7 +205,7 @@ error:
 static void Del( sout_stream_t *p_stream, void *id )
 {
     sout_stream_sys_t *p_sys = p_stream->p_sys;
-    Finish( p_stream );
+    if ( !p_sys->b_done ) Finish( p_stream );
     if ( p_sys->id == id ) /* not assuming only 1 id is in use.. */
         p_sys->id = NULL;
     free( id );
@@ -237,6 +239,9 @@ static int Send( sout_stream_t *p_stream, void *_id, block_t *p_buf )
             {
                 p_sys->b_finished = true;
                 msg_Dbg( p_stream, "Fingerprint collection finished" );
+                /* Close the fingerprint right away: the requester can then
+                 * stop feeding us instead of decoding the whole track. */
+                Finish( p_stream );
             }
         }
         p_next = p_buf->p_next;
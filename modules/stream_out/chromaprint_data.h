@@ -22,6 +22,11 @@ struct chromaprint_fingerprint_t
 {
     char *psz_fingerprint;
     unsigned int i_duration;
+    /* Invoked (from the sout thread) as soon as the fingerprint window is
+     * complete and psz_fingerprint is set, so the requester can stop the
+     * decode instead of playing the track out. May be NULL. */
+    void (*pf_done)( void * );
+    void *p_done_data;
 };
 
 typedef struct chromaprint_fingerprint_t chromaprint_fingerprint_t;
@@ -64,6 +64,7 @@ struct sout_access_out_sys_t
     void fifo_put_back(block_t *);
     ssize_t write(sout_access_out_t *p_access, block_t *p_block);
     void close();
+    bool isCongested();
 
 
 private:
@@ -81,6 +82,11 @@ private:
     block_t           **m_copy_last;
     size_t             m_copy_size;
     bool               m_eof;
+    /* Date when the demux filter started to be paced, VLC_TICK_INVALID when
+     * not pacing. Used to report sustained congestion to the sout. */
+    vlc_tick_t         m_pace_start;
+    /* True if blocks were dropped since the last congestion poll */
+    bool               m_dropped;
     std::string        m_mime;
 };
 
@@ -104,6 +110,7 @@ struct sout_stream_sys_t
         , out_force_reload( false )
         , perf_warning_shown( false )
         , transcoding_state( TRANSCODING_NONE )
+        , congestion_quality( -1 )
         , venc_opt_idx ( -1 )
         , out_streams_added( 0 )
     {
@@ -126,6 +133,7 @@ struct sout_stream_sys_t
     bool isFlushing( sout_stream_t* );
     void setNextTranscodingState();
     bool transcodingCanFallback() const;
+    bool degradeEncoderQuality( sout_stream_t* );
 
     httpd_host_t      *httpd_host;
     sout_access_out_sys_t access_out_live;
@@ -150,6 +158,8 @@ struct sout_stream_sys_t
     bool                               out_force_reload;
     bool                               perf_warning_shown;
     int                                transcoding_state;
+    /* conversion-quality forced by network congestion, -1 if unset */
+    int                                congestion_quality;
     int                                venc_opt_idx;
     std::vector<sout_stream_id_sys_t*> streams;
     std::vector<sout_stream_id_sys_t*> out_streams;
@@ -207,6 +217,8 @@ static const char *const ppsz_sout_options[] = {
 /* Fifo size after we drop packets (should not happen) */
 #define HTTPD_BUFFER_MAX INT64_C(32 * 1024 * 1024) /* 32 MB */
 #define HTTPD_BUFFER_COPY_MAX INT64_C(10 * 1024 * 1024) /* 10 MB */
+/* Pacing duration after which the network is considered congested */
+#define HTTPD_PACE_REPORT_DELAY VLC_TICK_FROM_SEC(5)
 
 vlc_module_begin ()
 
@@ -344,6 +356,8 @@ sout_access_out_sys_t::sout_access_out_sys_t(httpd_host_t *httpd_host,
     , m_header(NULL)
     , m_copy_chain(NULL)
     , m_eof(true)
+    , m_pace_start(VLC_TICK_INVALID)
+    , m_dropped(false)
 {
     m_fifo = block_FifoNew();
     if (!m_fifo)
@@ -374,6 +388,8 @@ void sout_access_out_sys_t::clearUnlocked()
         m_header = NULL;
     }
     m_eof = true;
+    m_pace_start = VLC_TICK_INVALID;
+    m_dropped = false;
     initCopy();
 }
 
@@ -400,8 +416,10 @@ void sout_access_out_sys_t::putCopy(block_t *p_block)
         assert(m_copy_size == 0);
         m_copy_last = &m_copy_chain;
     }
+    /* p_block may be a chain */
+    for (block_t *p_cur = p_block; p_cur != NULL; p_cur = p_cur->p_next)
+        m_copy_size += p_cur->i_buffer;
     block_ChainLastAppend(&m_copy_last, p_block);
-    m_copy_size += p_block->i_buffer;
 }
 
 void sout_access_out_sys_t::restoreCopy()
@@ -474,6 +492,7 @@ int sout_access_out_sys_t::url_cb(httpd_client_t *cl, httpd_message_t *answer,
         vlc_fifo_Wait(m_fifo);
 
     block_t *p_block = NULL;
+    size_t i_block_size = 0;
     if (m_client && vlc_fifo_GetBytes(m_fifo) > 0)
     {
         /* if less data is available, then we must be EOF */
@@ -482,34 +501,27 @@ int sout_access_out_sys_t::url_cb(httpd_client_t *cl, httpd_message_t *answer,
             assert(m_eof);
             i_min_buffer = vlc_fifo_GetBytes(m_fifo);
         }
-        block_t *p_first = vlc_fifo_DequeueUnlocked(m_fifo);
+        p_block = vlc_fifo_DequeueUnlocked(m_fifo);
 
-        assert(p_first);
-        size_t i_total_size = p_first->i_buffer;
-        block_t *p_next = NULL, *p_cur = p_first;
+        assert(p_block);
+        i_block_size = p_block->i_buffer;
+        block_t *p_cur = p_block;
 
-        while (i_total_size < i_min_buffer)
+        while (i_block_size < i_min_buffer)
         {
-            p_next = vlc_fifo_DequeueUnlocked(m_fifo);
+            block_t *p_next = vlc_fifo_DequeueUnlocked(m_fifo);
             assert(p_next);
-            i_total_size += p_next->i_buffer;
+            i_block_size += p_next->i_buffer;
             p_cur->p_next = p_next;
             p_cur = p_cur->p_next;
         }
-        assert(i_total_size >= i_min_buffer);
-
-        if (p_next != NULL)
-        {
-            p_block = block_Alloc(i_total_size);
-            if (p_block)
-                block_ChainExtract(p_first, p_block->p_buffer, p_block->i_buffer);
-            block_ChainRelease(p_first);
-        }
-        else
-            p_block = p_first;
+        assert(i_block_size >= i_min_buffer);
 
         if (vlc_fifo_GetBytes(m_fifo) < HTTPD_BUFFER_PACE)
+        {
             m_intf->setPacing(false);
+            m_pace_start = VLC_TICK_INVALID;
+        }
     }
 
     answer->i_proto  = HTTPD_PROTO_HTTP;
@@ -527,7 +539,7 @@ int sout_access_out_sys_t::url_cb(httpd_client_t *cl, httpd_message_t *answer,
         }
 
         const bool send_header = answer->i_body_offset == 0 && m_header != NULL;
-        size_t i_answer_size = p_block->i_buffer;
+        size_t i_answer_size = i_block_size;
         if (send_header)
             i_answer_size += m_header->i_buffer;
 
@@ -542,7 +554,14 @@ int sout_access_out_sys_t::url_cb(httpd_client_t *cl, httpd_message_t *answer,
                 memcpy(answer->p_body, m_header->p_buffer, m_header->i_buffer);
                 i_block_offset = m_header->i_buffer;
             }
-            memcpy(&answer->p_body[i_block_offset], p_block->p_buffer, p_block->i_buffer);
+            /* Copy the muxed blocks straight into the answer. The chain
+             * itself is reused as-is by putCopy() instead of being
+             * extracted into yet another allocation. */
+            for (block_t *p_cur = p_block; p_cur != NULL; p_cur = p_cur->p_next)
+            {
+                memcpy(&answer->p_body[i_block_offset], p_cur->p_buffer, p_cur->i_buffer);
+                i_block_offset += p_cur->i_buffer;
+            }
         }
 
         putCopy(p_block);
@@ -578,15 +597,20 @@ ssize_t sout_access_out_sys_t::write(sout_access_out_t *p_access, block_t *p_blo
              * block, but not too long since we don't want to block decoder
              * thread controls. If the pacing fails (should not happen), we
              * drop the first block in order to make room. The demux filter
-             * will be unpaced when the data is read from the httpd thread. */
+             * will be unpaced when the data is read from the httpd thread.
+             * Sustained pacing and drops are reported via isCongested() so
+             * that the sout can lower the encoder bitrate. */
 
             m_intf->setPacing(true);
+            if (m_pace_start == VLC_TICK_INVALID)
+                m_pace_start = vlc_tick_now();
 
             while (vlc_fifo_GetBytes(m_fifo) >= HTTPD_BUFFER_MAX)
             {
                 block_t *p_drop = vlc_fifo_DequeueUnlocked(m_fifo);
                 msg_Warn(p_access, "httpd buffer full: dropping %zuB", p_drop->i_buffer);
                 block_Release(p_drop);
+                m_dropped = true;
             }
         }
         vlc_fifo_QueueUnlocked(m_fifo, p_block);
@@ -605,10 +629,27 @@ void sout_access_out_sys_t::close()
     vlc_fifo_Lock(m_fifo);
     m_eof = true;
     m_intf->setPacing(false);
+    m_pace_start = VLC_TICK_INVALID;
     vlc_fifo_Unlock(m_fifo);
     vlc_fifo_Signal(m_fifo);
 }
 
+bool sout_access_out_sys_t::isCongested()
+{
+    vlc_fifo_Lock(m_fifo);
+    bool b_congested = m_dropped;
+    m_dropped = false;
+    if (m_pace_start != VLC_TICK_INVALID
+     && vlc_tick_now() - m_pace_start >= HTTPD_PACE_REPORT_DELAY)
+    {
+        /* Don't report again unless pacing persists for another delay */
+        m_pace_start = vlc_tick_now();
+        b_congested = true;
+    }
+    vlc_fifo_Unlock(m_fifo);
+    return b_congested;
+}
+
 ssize_t AccessWrite(sout_access_out_t *p_access, block_t *p_block)
 {
     sout_access_out_sys_t *p_sys = reinterpret_cast<sout_access_out_sys_t *>( p_access->p_sys );
@@ -728,6 +769,7 @@ static void DelInternal(sout_stream_t *p_stream, void *_id, bool reset_config)
         p_sys->p_intf->requestPlayerStop();
         p_sys->access_out_live.clear();
         p_sys->transcoding_state = TRANSCODING_NONE;
+        p_sys->congestion_quality = -1;
     }
 }
 
@@ -879,6 +921,19 @@ bool sout_stream_sys_t::transcodingCanFallback() const
     return transcoding_state != (TRANSCODING_VIDEO|TRANSCODING_AUDIO);
 }
 
+bool sout_stream_sys_t::degradeEncoderQuality( sout_stream_t *p_stream )
+{
+    const int i_quality = var_InheritInteger( p_stream, SOUT_CFG_PREFIX "conversion-quality" );
+    int i_next = ( congestion_quality >= 0 ? congestion_quality : i_quality ) + 1;
+
+    /* LOWCPU trades quality for CPU, not for bandwidth: the ladder stops at
+     * LOW. */
+    if ( i_next > CONVERSION_QUALITY_LOW )
+        return false;
+    congestion_quality = i_next;
+    return true;
+}
+
 std::string
 sout_stream_sys_t::GetAcodecOption( sout_stream_t *p_stream, vlc_fourcc_t *p_codec_audio,
                                     const audio_format_t *p_aud, int i_quality )
@@ -1036,7 +1091,11 @@ bool sout_stream_sys_t::UpdateOutput( sout_stream_t *p_stream )
                 config_PutInt(RENDERER_CFG_PREFIX "show-perf-warning", 0 );
         }
 
-        const int i_quality = var_InheritInteger( p_stream, SOUT_CFG_PREFIX "conversion-quality" );
+        int i_quality = var_InheritInteger( p_stream, SOUT_CFG_PREFIX "conversion-quality" );
+        /* The network couldn't keep up with the configured quality: encode
+         * with less bandwidth. */
+        if ( congestion_quality > i_quality )
+            i_quality = congestion_quality;
 
         /* TODO: provide audio samplerate and channels */
         ssout << "transcode{";
@@ -1149,6 +1208,18 @@ static int Send(sout_stream_t *p_stream, void *_id, block_t *p_buffer)
         return VLC_SUCCESS;
     }
 
+    /* Surface httpd backpressure to the encoder rate control: on sustained
+     * congestion, rebuild the chain one conversion-quality step lower
+     * instead of pacing (and ultimately dropping) forever. */
+    if ( p_sys->transcoding_state & TRANSCODING_VIDEO
+      && p_sys->access_out_live.isCongested()
+      && p_sys->degradeEncoderQuality( p_stream ) )
+    {
+        msg_Warn( p_stream, "network congestion detected. Switching to "
+                  "conversion quality %d", p_sys->congestion_quality );
+        p_sys->out_force_reload = p_sys->es_changed = true;
+    }
+
     sout_stream_id_sys_t *next_id = p_sys->GetSubId( p_stream, id );
     if ( next_id == NULL )
     {
@@ -28,6 +28,8 @@
 # include "config.h"
 #endif
 
+#include <stdatomic.h>
+
 #include <vlc_common.h>
 #include <vlc_plugin.h>
 #include <vlc_sout.h>
@@ -56,16 +58,52 @@ static void *Add( sout_stream_t *, const es_format_t * );
 static void  Del( sout_stream_t *, void * );
 static int   Send( sout_stream_t *, void *, block_t * );
 
+/* Maximum queued payload per output before blocks are dropped */
+#define DUP_MAX_QUEUED_BYTES (16 * 1024 * 1024)
+
+/* A block shared between several outputs. Each output duplicates the source
+ * on its own thread; the last user takes the source over without a copy. */
 typedef struct
 {
-    int             i_nb_streams;
-    sout_stream_t   **pp_streams;
+    block_t         *p_block;
+    atomic_uint      users;
+} dup_shared_block_t;
 
-    int             i_nb_last_streams;
-    sout_stream_t   **pp_last_streams;
+typedef struct dup_cmd_t
+{
+    struct dup_cmd_t    *p_next;
+    void                *id;
+    block_t             *p_block;  /* exclusively owned block, or NULL */
+    dup_shared_block_t  *p_shared; /* source shared with other outputs */
+} dup_cmd_t;
+
+typedef struct
+{
+    sout_stream_t   *s;
+    sout_stream_t   *p_last;
+    char            *psz_select;
+
+    /* The thread owns all data transfers to the output chain; add, delete
+     * and control calls are serialized with it through out_lock, so that a
+     * blocked output cannot stall the other duplicated outputs */
+    vlc_thread_t    thread;
+    vlc_mutex_t     lock;    /* protects the command queue */
+    vlc_cond_t      wait;    /* signals a new command to the thread */
+    vlc_cond_t      drained; /* signals an empty and idle queue */
+    dup_cmd_t       *p_first;
+    dup_cmd_t       **pp_last;
+    size_t          i_queued; /* queued payload bytes */
+    unsigned        i_dropped;
+    bool            b_busy;  /* the thread is sending a block */
+    bool            b_eof;
+
+    vlc_mutex_t     out_lock; /* serializes calls to the output chain */
+} duplicated_stream_t;
 
-    int             i_nb_select;
-    char            **ppsz_select;
+typedef struct
+{
+    int                 i_nb_streams;
+    duplicated_stream_t **pp_dups;
 } sout_stream_sys_t;
 
 typedef struct
@@ -76,6 +114,134 @@ typedef struct
 
 static bool ESSelected( const es_format_t *fmt, char *psz_select );
 
+/*****************************************************************************
+ * Shared blocks:
+ *****************************************************************************/
+static void SharedBlockRelease( dup_shared_block_t *p_shared )
+{
+    if( atomic_fetch_sub_explicit( &p_shared->users, 1,
+                                   memory_order_acq_rel ) == 1 )
+    {
+        block_Release( p_shared->p_block );
+        free( p_shared );
+    }
+}
+
+static block_t *SharedBlockConsume( dup_shared_block_t *p_shared )
+{
+    block_t *p_block;
+
+    if( atomic_load_explicit( &p_shared->users,
+                              memory_order_acquire ) == 1 )
+    {
+        /* Sole remaining user: take the source over instead of copying it */
+        p_block = p_shared->p_block;
+        free( p_shared );
+        return p_block;
+    }
+
+    /* Copy before releasing the reference: the last user frees the source */
+    p_block = block_Duplicate( p_shared->p_block );
+    SharedBlockRelease( p_shared );
+    return p_block;
+}
+
+/*****************************************************************************
+ * Output thread:
+ *****************************************************************************/
+static void *DupThread( void *opaque )
+{
+    duplicated_stream_t *p_dup = opaque;
+
+    vlc_mutex_lock( &p_dup->lock );
+    for( ;; )
+    {
+        while( p_dup->p_first == NULL && !p_dup->b_eof )
+            vlc_cond_wait( &p_dup->wait, &p_dup->lock );
+
+        dup_cmd_t *p_cmd = p_dup->p_first;
+        if( p_cmd == NULL )
+            break;
+
+        p_dup->p_first = p_cmd->p_next;
+        if( p_dup->p_first == NULL )
+            p_dup->pp_last = &p_dup->p_first;
+        p_dup->i_queued -= p_cmd->p_shared != NULL
+                         ? p_cmd->p_shared->p_block->i_buffer
+                         : p_cmd->p_block->i_buffer;
+        p_dup->b_busy = true;
+        vlc_mutex_unlock( &p_dup->lock );
+
+        block_t *p_block = p_cmd->p_shared != NULL
+                         ? SharedBlockConsume( p_cmd->p_shared )
+                         : p_cmd->p_block;
+        if( p_block != NULL )
+        {
+            vlc_mutex_lock( &p_dup->out_lock );
+            sout_StreamIdSend( p_dup->s, p_cmd->id, p_block );
+            vlc_mutex_unlock( &p_dup->out_lock );
+        }
+        free( p_cmd );
+
+        vlc_mutex_lock( &p_dup->lock );
+        p_dup->b_busy = false;
+        if( p_dup->p_first == NULL )
+            vlc_cond_broadcast( &p_dup->drained );
+    }
+    vlc_mutex_unlock( &p_dup->lock );
+    return NULL;
+}
+
+static void DupSendCmd( sout_stream_t *p_stream, duplicated_stream_t *p_dup,
+                        void *id, block_t *p_block,
+                        dup_shared_block_t *p_shared )
+{
+    size_t i_size = p_shared != NULL ? p_shared->p_block->i_buffer
+                                     : p_block->i_buffer;
+
+    dup_cmd_t *p_cmd = malloc( sizeof( *p_cmd ) );
+    if( unlikely(p_cmd == NULL) )
+        goto drop;
+
+    p_cmd->p_next = NULL;
+    p_cmd->id = id;
+    p_cmd->p_block = p_block;
+    p_cmd->p_shared = p_shared;
+
+    vlc_mutex_lock( &p_dup->lock );
+    if( p_dup->i_queued + i_size > DUP_MAX_QUEUED_BYTES
+     && p_dup->p_first != NULL )
+    {
+        unsigned i_dropped = ++p_dup->i_dropped;
+        vlc_mutex_unlock( &p_dup->lock );
+        free( p_cmd );
+        if( ( i_dropped % 100 ) == 1 )
+            msg_Warn( p_stream, "output is too slow, dropping blocks "
+                      "(%u lost)", i_dropped );
+        goto drop;
+    }
+    *p_dup->pp_last = p_cmd;
+    p_dup->pp_last = &p_cmd->p_next;
+    p_dup->i_queued += i_size;
+    vlc_cond_signal( &p_dup->wait );
+    vlc_mutex_unlock( &p_dup->lock );
+    return;
+
+drop:
+    if( p_shared != NULL )
+        SharedBlockRelease( p_shared );
+    else
+        block_Release( p_block );
+}
+
+static void DupDrain( duplicated_stream_t *p_dup )
+{
+    vlc_mutex_lock( &p_dup->lock );
+    while( p_dup->p_first != NULL || p_dup->b_busy )
+        vlc_cond_wait( &p_dup->drained, &p_dup->lock );
+    vlc_mutex_unlock( &p_dup->lock );
+}
+
 /*****************************************************************************
  * Control
  *****************************************************************************/
@@ -93,8 +259,14 @@ static int Control( sout_stream_t *p_stream, int i_query, va_list args )
             for( int i = 0; i < id->i_nb_ids; i++ )
             {
                 if( id->pp_ids[i] )
-                    sout_StreamControl( p_sys->pp_streams[i], i_query,
+                {
+                    duplicated_stream_t *p_dup = p_sys->pp_dups[i];
+
+                    vlc_mutex_lock( &p_dup->out_lock );
+                    sout_StreamControl( p_dup->s, i_query,
                                         id->pp_ids[i], spu_hl );
+                    vlc_mutex_unlock( &p_dup->out_lock );
+                }
             }
             return VLC_SUCCESS;
         }
@@ -118,9 +290,7 @@ static int Open( vlc_object_t *p_this )
     if( !p_sys )
         return VLC_ENOMEM;
 
-    TAB_INIT( p_sys->i_nb_streams, p_sys->pp_streams );
-    TAB_INIT( p_sys->i_nb_last_streams, p_sys->pp_last_streams );
-    TAB_INIT( p_sys->i_nb_select, p_sys->ppsz_select );
+    TAB_INIT( p_sys->i_nb_streams, p_sys->pp_dups );
 
     for( p_cfg = p_stream->p_cfg; p_cfg != NULL; p_cfg = p_cfg->p_next )
     {
@@ -134,28 +304,51 @@ static int Open( vlc_object_t *p_this )
 
             if( s )
             {
-                TAB_APPEND( p_sys->i_nb_streams, p_sys->pp_streams, s );
-                TAB_APPEND( p_sys->i_nb_last_streams, p_sys->pp_last_streams,
-                    p_last );
-                TAB_APPEND( p_sys->i_nb_select,  p_sys->ppsz_select, NULL );
+                duplicated_stream_t *p_dup = calloc( 1, sizeof( *p_dup ) );
+                if( p_dup == NULL )
+                {
+                    sout_StreamChainDelete( s, p_last );
+                    continue;
+                }
+
+                p_dup->s = s;
+                p_dup->p_last = p_last;
+                vlc_mutex_init( &p_dup->lock );
+                vlc_cond_init( &p_dup->wait );
+                vlc_cond_init( &p_dup->drained );
+                vlc_mutex_init( &p_dup->out_lock );
+                p_dup->pp_last = &p_dup->p_first;
+
+                if( vlc_clone( &p_dup->thread, DupThread, p_dup,
+                               VLC_THREAD_PRIORITY_OUTPUT ) )
+                {
+                    msg_Err( p_stream, " * cannot spawn thread for `%s'",
+                             p_cfg->psz_value );
+                    sout_StreamChainDelete( s, p_last );
+                    free( p_dup );
+                    continue;
+                }
+
+                TAB_APPEND( p_sys->i_nb_streams, p_sys->pp_dups, p_dup );
             }
         }
         else if( !strncmp( p_cfg->psz_name, "select", strlen( "select" ) ) )
         {
             char *psz = p_cfg->psz_value;
-            if( p_sys->i_nb_select > 0 && psz && *psz )
+            if( p_sys->i_nb_streams > 0 && psz && *psz )
             {
-                char **ppsz_select = &p_sys->ppsz_select[p_sys->i_nb_select - 1];
+                duplicated_stream_t *p_dup =
+                    p_sys->pp_dups[p_sys->i_nb_streams - 1];
 
-                if( *ppsz_select )
+                if( p_dup->psz_select )
                 {
                     msg_Err( p_stream, " * ignore selection `%s' (it already has `%s')",
-                             psz, *ppsz_select );
+                             psz, p_dup->psz_select );
                 }
                 else
                 {
                     msg_Dbg( p_stream, " * apply selection `%s'", psz );
-                    *ppsz_select = strdup( psz );
+                    p_dup->psz_select = strdup( psz );
                 }
             }
         }
@@ -194,12 +387,19 @@ static void Close( vlc_object_t * p_this )
     msg_Dbg( p_stream, "closing a duplication" );
     for( int i = 0; i < p_sys->i_nb_streams; i++ )
     {
-        sout_StreamChainDelete(p_sys->pp_streams[i], p_sys->pp_last_streams[i]);
-        free( p_sys->ppsz_select[i] );
+        duplicated_stream_t *p_dup = p_sys->pp_dups[i];
+
+        vlc_mutex_lock( &p_dup->lock );
+        p_dup->b_eof = true;
+        vlc_cond_signal( &p_dup->wait );
+        vlc_mutex_unlock( &p_dup->lock );
+        vlc_join( p_dup->thread, NULL );
+
+        sout_StreamChainDelete( p_dup->s, p_dup->p_last );
+        free( p_dup->psz_select );
+        free( p_dup );
     }
-    free( p_sys->pp_streams );
-    free( p_sys->pp_last_streams );
-    free( p_sys->ppsz_select );
+    free( p_sys->pp_dups );
 
     free( p_sys );
 }
@@ -224,13 +424,14 @@ static void *Add( sout_stream_t *p_stream, const es_format_t *p_fmt )
 
     for( i_stream = 0; i_stream < p_sys->i_nb_streams; i_stream++ )
     {
+        duplicated_stream_t *p_dup = p_sys->pp_dups[i_stream];
         void *id_new = NULL;
 
-        if( ESSelected( p_fmt, p_sys->ppsz_select[i_stream] ) )
+        if( ESSelected( p_fmt, p_dup->psz_select ) )
         {
-            sout_stream_t *out = p_sys->pp_streams[i_stream];
-
-            id_new = (void*)sout_StreamIdAdd( out, p_fmt );
+            vlc_mutex_lock( &p_dup->out_lock );
+            id_new = (void*)sout_StreamIdAdd( p_dup->s, p_fmt );
+            vlc_mutex_unlock( &p_dup->out_lock );
             if( id_new )
             {
                 msg_Dbg( p_stream, "    - added for output %d", i_stream );
@@ -273,8 +474,14 @@ static void Del( sout_stream_t *p_stream, void *_id )
     {
         if( id->pp_ids[i_stream] )
         {
-            sout_stream_t *out = p_sys->pp_streams[i_stream];
-            sout_StreamIdDel( out, id->pp_ids[i_stream] );
+            duplicated_stream_t *p_dup = p_sys->pp_dups[i_stream];
+
+            /* Wait for the pending blocks of this output, since their ES
+             * is about to be deleted under it */
+            DupDrain( p_dup );
+            vlc_mutex_lock( &p_dup->out_lock );
+            sout_StreamIdDel( p_dup->s, id->pp_ids[i_stream] );
+            vlc_mutex_unlock( &p_dup->out_lock );
         }
     }
 
@@ -289,8 +496,7 @@ static int Send( sout_stream_t *p_stream, void *_id, block_t *p_buffer )
 {
     sout_stream_sys_t *p_sys = p_stream->p_sys;
     sout_stream_id_sys_t *id = (sout_stream_id_sys_t *)_id;
-    sout_stream_t     *p_dup_stream;
-    int               i_stream;
+    int               i_stream, i_targets;
 
     /* Loop through the linked list of buffers */
     while( p_buffer )
@@ -299,27 +505,42 @@ static int Send( sout_stream_t *p_stream, void *_id, block_t *p_buffer )
 
         p_buffer->p_next = NULL;
 
-        for( i_stream = 0; i_stream < p_sys->i_nb_streams - 1; i_stream++ )
+        i_targets = 0;
+        for( i_stream = 0; i_stream < p_sys->i_nb_streams; i_stream++ )
         {
-            p_dup_stream = p_sys->pp_streams[i_stream];
-
             if( id->pp_ids[i_stream] )
-            {
-                block_t *p_dup = block_Duplicate( p_buffer );
-
-                if( p_dup )
-                    sout_StreamIdSend( p_dup_stream, id->pp_ids[i_stream], p_dup );
-            }
+                i_targets++;
         }
 
-        if( i_stream < p_sys->i_nb_streams && id->pp_ids[i_stream] )
+        if( i_targets == 0 )
+        {
+            block_Release( p_buffer );
+        }
+        else if( i_targets == 1 )
         {
-            p_dup_stream = p_sys->pp_streams[i_stream];
-            sout_StreamIdSend( p_dup_stream, id->pp_ids[i_stream], p_buffer );
+            for( i_stream = 0; id->pp_ids[i_stream] == NULL; i_stream++ );
+            DupSendCmd( p_stream, p_sys->pp_dups[i_stream],
+                        id->pp_ids[i_stream], p_buffer, NULL );
         }
         else
         {
-            block_Release( p_buffer );
+            dup_shared_block_t *p_shared = malloc( sizeof( *p_shared ) );
+            if( unlikely(p_shared == NULL) )
+            {
+                block_Release( p_buffer );
+            }
+            else
+            {
+                p_shared->p_block = p_buffer;
+                atomic_init( &p_shared->users, i_targets );
+
+                for( i_stream = 0; i_stream < p_sys->i_nb_streams; i_stream++ )
+                {
+                    if( id->pp_ids[i_stream] )
+                        DupSendCmd( p_stream, p_sys->pp_dups[i_stream],
+                                    id->pp_ids[i_stream], NULL, p_shared );
+                }
+            }
         }
 
         p_buffer = p_next;
@@ -36,9 +36,9 @@
 #include <vlc_codec.h>
 #include <vlc_meta.h>
 
-#include <vlc_image.h>
 #include <vlc_filter.h>
 #include <vlc_modules.h>
+#include <vlc_picture_pool.h>
 
 #include "../spu/mosaic.h"
 
@@ -50,7 +50,9 @@ typedef struct
     bridged_es_t *p_es;
 
     decoder_t       *p_decoder;
-    image_handler_t *p_image; /* filter for resizing */
+    filter_chain_t  *p_scale; /* converter towards the bridge format */
+    es_format_t scale_fmt_in, scale_fmt_out;
+    bool b_scale_ok;
     int i_height, i_width;
     unsigned int i_sar_num, i_sar_den;
     char *psz_id;
@@ -58,6 +60,10 @@ typedef struct
 
     vlc_fourcc_t i_chroma; /* force image format chroma */
 
+    /* Shared ring of bridge pictures, format negotiated at connect time */
+    picture_pool_t *p_pool;
+    video_format_t pool_fmt;
+
     filter_chain_t *p_vf2;
 } sout_stream_sys_t;
 
@@ -224,6 +230,9 @@ static int Open( vlc_object_t *p_this )
         p_sys->i_sar_num = p_sys->i_sar_den = 1;
     }
 
+    p_sys->p_pool = NULL;
+    video_format_Init( &p_sys->pool_fmt, 0 );
+
     p_sys->i_chroma = 0;
     val.psz_string = var_GetNonEmptyString( p_stream, CFG_PREFIX "chroma" );
     if( val.psz_string && strlen( val.psz_string ) >= 4 )
@@ -284,9 +293,46 @@ static void Close( vlc_object_t * p_this )
 
     free( p_sys->psz_id );
 
+    video_format_Clean( &p_sys->pool_fmt );
     free( p_sys );
 }
 
+/* Number of pictures in the shared bridge ring. This must cover the pictures
+ * queued on the bridge plus the one the mosaic is compositing. */
+#define MOSAIC_POOL_SIZE 5
+
+/* (Re)create the shared picture ring for the negotiated bridge format */
+static void NegotiatePool( sout_stream_t *p_stream, const video_format_t *p_fmt )
+{
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+
+    if( p_sys->p_pool != NULL )
+    {
+        if( video_format_IsSimilar( &p_sys->pool_fmt, p_fmt ) )
+            return;
+        picture_pool_Release( p_sys->p_pool );
+    }
+    video_format_Clean( &p_sys->pool_fmt );
+    video_format_Copy( &p_sys->pool_fmt, p_fmt );
+    p_sys->p_pool = picture_pool_NewFromFormat( p_fmt, MOSAIC_POOL_SIZE );
+}
+
+/* Get a picture from the ring. Falls back to a one-shot allocation when the
+ * mosaic still holds every ring picture, rather than stalling the decoder. */
+static picture_t *GetPooledPicture( sout_stream_t *p_stream,
+                                    const video_format_t *p_fmt )
+{
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+    picture_t *p_pic = NULL;
+
+    if( p_sys->p_pool != NULL
+     && video_format_IsSimilar( &p_sys->pool_fmt, p_fmt ) )
+        p_pic = picture_pool_Get( p_sys->p_pool );
+    if( p_pic == NULL )
+        p_pic = picture_NewFromFormat( p_fmt );
+    return p_pic;
+}
+
 static void ReleaseDecoder( decoder_t *p_dec )
 {
     struct decoder_owner *p_owner = dec_get_owner( p_dec );
@@ -352,6 +398,17 @@ static void *Add( sout_stream_t *p_stream, const es_format_t *p_fmt )
         p_sys->p_vf2 = NULL;
     }
 
+    /* Converter towards the bridge format; the actual conversion is
+     * negotiated at connect time, once the decoder output is known */
+    filter_owner_t scale_owner = {
+        .video = &cbs,
+        .sys = p_owner,
+    };
+    p_sys->p_scale = filter_chain_NewVideo( p_stream, false, &scale_owner );
+    p_sys->b_scale_ok = false;
+    es_format_Init( &p_sys->scale_fmt_in, VIDEO_ES, 0 );
+    es_format_Init( &p_sys->scale_fmt_out, VIDEO_ES, 0 );
+
     static const struct decoder_owner_callbacks dec_cbs =
     {
         .video = {
@@ -422,15 +479,6 @@ static void *Add( sout_stream_t *p_stream, const es_format_t *p_fmt )
 
     vlc_global_unlock( VLC_MOSAIC_MUTEX );
 
-    if ( p_sys->i_height || p_sys->i_width )
-    {
-        p_sys->p_image = image_HandlerCreate( p_stream );
-    }
-    else
-    {
-        p_sys->p_image = NULL;
-    }
-
     msg_Dbg( p_stream, "mosaic bridge id=%s pos=%d", p_es->psz_id, i );
 
     return p_sys;
@@ -488,9 +536,16 @@ static void Del( sout_stream_t *p_stream, void *id )
 
     vlc_global_unlock( VLC_MOSAIC_MUTEX );
 
-    if ( p_sys->p_image )
+    if( p_sys->p_scale )
+        filter_chain_Delete( p_sys->p_scale );
+    es_format_Clean( &p_sys->scale_fmt_in );
+    es_format_Clean( &p_sys->scale_fmt_out );
+
+    if( p_sys->p_pool )
     {
-        image_HandlerDelete( p_sys->p_image );
+        /* Outstanding ring pictures keep the pool alive until released */
+        picture_pool_Release( p_sys->p_pool );
+        p_sys->p_pool = NULL;
     }
 
     p_sys->b_inited = false;
@@ -535,16 +590,41 @@ static void decoder_queue_video( decoder_t *p_dec, picture_t *p_pic )
         }
         fmt_out.i_visible_width = fmt_out.i_width;
         fmt_out.i_visible_height = fmt_out.i_height;
+        fmt_out.i_sar_num = p_sys->i_sar_num;
+        fmt_out.i_sar_den = p_sys->i_sar_den;
+
+        /* The converter and the picture ring are only (re)negotiated when
+         * the connection format or the configuration changes */
+        if( p_sys->p_scale != NULL
+         && ( !p_sys->b_scale_ok
+           || !video_format_IsSimilar( &p_sys->scale_fmt_out.video, &fmt_out )
+           || !video_format_IsSimilar( &p_sys->scale_fmt_in.video, p_fmt_in ) ) )
+        {
+            es_format_Clean( &p_sys->scale_fmt_in );
+            es_format_Clean( &p_sys->scale_fmt_out );
+            es_format_InitFromVideo( &p_sys->scale_fmt_in, p_fmt_in );
+            es_format_InitFromVideo( &p_sys->scale_fmt_out, &fmt_out );
+            filter_chain_Reset( p_sys->p_scale, &p_sys->scale_fmt_in, NULL,
+                                &p_sys->scale_fmt_out );
+            p_sys->b_scale_ok = filter_chain_AppendConverter( p_sys->p_scale,
+                                    &p_sys->scale_fmt_out ) == 0;
+            if( p_sys->b_scale_ok )
+                NegotiatePool( p_stream, &fmt_out );
+        }
 
-        p_new_pic = image_Convert( p_sys->p_image,
-                                   p_pic, p_fmt_in, &fmt_out );
         video_format_Clean( &fmt_out );
-        if( p_new_pic == NULL )
+
+        if( !p_sys->b_scale_ok )
         {
             msg_Err( p_stream, "image conversion failed" );
             picture_Release( p_pic );
             return;
         }
+
+        /* The chain consumes the input picture and draws into the ring */
+        p_new_pic = filter_chain_VideoFilter( p_sys->p_scale, p_pic );
+        if( p_new_pic == NULL )
+            return;
     }
     else
     {
@@ -553,7 +633,8 @@ static void decoder_queue_video( decoder_t *p_dec, picture_t *p_pic )
         pic_fmt.i_sar_num = p_fmt_in->i_sar_num;
         pic_fmt.i_sar_den = p_fmt_in->i_sar_den;
 
-        p_new_pic = picture_NewFromFormat( &pic_fmt );
+        NegotiatePool( p_stream, &pic_fmt );
+        p_new_pic = GetPooledPicture( p_stream, &pic_fmt );
         if( !p_new_pic )
         {
             picture_Release( p_pic );
@@ -562,8 +643,8 @@ static void decoder_queue_video( decoder_t *p_dec, picture_t *p_pic )
         }
 
         picture_Copy( p_new_pic, p_pic );
+        picture_Release( p_pic );
     }
-    picture_Release( p_pic );
 
     if( p_sys->p_vf2 )
         p_new_pic = filter_chain_VideoFilter( p_sys->p_vf2, p_new_pic );
@@ -621,7 +702,9 @@ static int video_update_format_decoder( decoder_t *p_dec, vlc_video_context *vct
 
 static picture_t *video_new_buffer_filter( filter_t *p_filter )
 {
-    return picture_NewFromFormat( &p_filter->fmt_out.video );
+    struct decoder_owner *p_owner = p_filter->owner.sys;
+
+    return GetPooledPicture( p_owner->p_stream, &p_filter->fmt_out.video );
 }
 
 /**********************************************************************
@@ -635,10 +718,7 @@ static int HeightCallback( vlc_object_t *p_this, char const *psz_var,
     sout_stream_t *p_stream = (sout_stream_t *)p_data;
     sout_stream_sys_t *p_sys = p_stream->p_sys;
 
-    /* We create the handler before updating the value in p_sys
-     * so we don't have to worry about locking */
-    if( !p_sys->p_image && newval.i_int )
-        p_sys->p_image = image_HandlerCreate( p_stream );
+    /* The converter is renegotiated on the next picture */
     p_sys->i_height = newval.i_int;
 
     return VLC_SUCCESS;
@@ -652,10 +732,7 @@ static int WidthCallback( vlc_object_t *p_this, char const *psz_var,
     sout_stream_t *p_stream = (sout_stream_t *)p_data;
     sout_stream_sys_t *p_sys = p_stream->p_sys;
 
-    /* We create the handler before updating the value in p_sys
-     * so we don't have to worry about locking */
-    if( !p_sys->p_image && newval.i_int )
-        p_sys->p_image = image_HandlerCreate( p_stream );
+    /* The converter is renegotiated on the next picture */
     p_sys->i_width = newval.i_int;
 
     return VLC_SUCCESS;
@@ -305,6 +305,11 @@ typedef struct
     vlc_mutex_t      lock_es;
     int              i_es;
     sout_stream_id_sys_t **es;
+
+    /* Cached RTSP DESCRIBE answer, protected by lock_es and flushed
+     * whenever the ES set changes */
+    char            *psz_sdp_describe;
+    char            *psz_sdp_describe_url;
 } sout_stream_sys_t;
 
 typedef struct rtp_sink_t
@@ -470,6 +475,8 @@ static int Open( vlc_object_t *p_this )
     p_sys->es   = NULL;
     p_sys->rtsp = NULL;
     p_sys->psz_sdp = NULL;
+    p_sys->psz_sdp_describe = NULL;
+    p_sys->psz_sdp_describe_url = NULL;
 
     p_sys->b_export_sap = false;
     p_sys->p_session = NULL;
@@ -602,6 +609,8 @@ static void Close( vlc_object_t * p_this )
         httpd_HostDelete( p_sys->p_httpd_host );
 
     free( p_sys->psz_sdp );
+    free( p_sys->psz_sdp_describe );
+    free( p_sys->psz_sdp_describe_url );
 
     if( p_sys->psz_sdp_file != NULL )
     {
@@ -727,6 +736,15 @@ char *SDPGenerate( sout_stream_t *p_stream, const char *rtsp_url )
     if( unlikely(p_sys->i_es == 0 || (rtsp_url != NULL && !p_sys->es[0]->rtsp_id)) )
         goto out; /* hmm... */
 
+    /* The SDP only depends on the ES set and the control URL: serve
+     * RTSP DESCRIBE storms from the cache instead of regenerating */
+    if( rtsp_url != NULL && p_sys->psz_sdp_describe != NULL
+     && !strcmp( p_sys->psz_sdp_describe_url, rtsp_url ) )
+    {
+        psz_sdp = strdup( p_sys->psz_sdp_describe );
+        goto out;
+    }
+
     if( p_sys->psz_destination != NULL )
     {
         inclport = true;
@@ -783,7 +801,10 @@ char *SDPGenerate( sout_stream_t *p_stream, const char *rtsp_url )
                 proto = "DCCP/RTP/AVP";
                 break;
             case IPPROTO_UDPLITE:
-                return psz_sdp;
+                /* Not supported: do not return with lock_es held */
+                if( vlc_memstream_close( &sdp ) == 0 )
+                    free( sdp.ptr );
+                goto out;
         }
     }
 
@@ -854,6 +875,27 @@ char *SDPGenerate( sout_stream_t *p_stream, const char *rtsp_url )
 
     if( vlc_memstream_close( &sdp ) == 0 )
         psz_sdp = sdp.ptr;
+
+    if( rtsp_url != NULL && psz_sdp != NULL )
+    {
+        char *psz_url = strdup( rtsp_url );
+        char *psz_copy = strdup( psz_sdp );
+
+        free( p_sys->psz_sdp_describe );
+        free( p_sys->psz_sdp_describe_url );
+        if( psz_url != NULL && psz_copy != NULL )
+        {
+            p_sys->psz_sdp_describe = psz_copy;
+            p_sys->psz_sdp_describe_url = psz_url;
+        }
+        else
+        {
+            free( psz_url );
+            free( psz_copy );
+            p_sys->psz_sdp_describe = NULL;
+            p_sys->psz_sdp_describe_url = NULL;
+        }
+    }
 out:
     vlc_mutex_unlock( &p_sys->lock_es );
     return psz_sdp;
@@ -1113,6 +1155,8 @@ static void *Add( sout_stream_t *p_stream, const es_format_t *p_fmt )
     /* Update p_sys context */
     vlc_mutex_lock( &p_sys->lock_es );
     TAB_APPEND( p_sys->i_es, p_sys->es, id );
+    FREENULL( p_sys->psz_sdp_describe );
+    FREENULL( p_sys->psz_sdp_describe_url );
     vlc_mutex_unlock( &p_sys->lock_es );
 
     psz_sdp = SDPGenerate( p_stream, NULL );
@@ -1142,6 +1186,8 @@ static void Del( sout_stream_t *p_stream, void *_id )
 
     vlc_mutex_lock( &p_sys->lock_es );
     TAB_REMOVE( p_sys->i_es, p_sys->es, id );
+    FREENULL( p_sys->psz_sdp_describe );
+    FREENULL( p_sys->psz_sdp_describe_url );
     vlc_mutex_unlock( &p_sys->lock_es );
 
     if (!id->dead)
@@ -1304,6 +1350,15 @@ static int  HttpCallback( httpd_file_sys_t *p_args,
 /****************************************************************************
  * RTP send
  ****************************************************************************/
+#ifdef HAVE_SENDMMSG
+/* Maximum number of packets per sendmmsg() call */
+# define RTP_BATCH_MAX 32
+/* Packets due within this window are paced as a single batch */
+# define RTP_BATCH_WINDOW VLC_TICK_FROM_MS(2)
+#else
+# define RTP_BATCH_MAX 1
+#endif
+
 static void* ThreadSend( void *data )
 {
 #ifdef _WIN32
@@ -1313,44 +1368,140 @@ static void* ThreadSend( void *data )
 #endif
     sout_stream_id_sys_t *id = data;
     vlc_tick_t i_caching = id->i_caching;
+#ifdef HAVE_SENDMMSG
+    block_t *next = NULL;
+#endif
     block_t *out;
 
-    while ((out = vlc_queue_DequeueKillable(&id->queue, &id->dead)) != NULL)
+    for( ;; )
     {
+        block_t *batch[RTP_BATCH_MAX];
+        unsigned n = 0;
+
+#ifdef HAVE_SENDMMSG
+        out = next;
+        next = NULL;
+        if( out == NULL )
+#endif
+            out = vlc_queue_DequeueKillable( &id->queue, &id->dead );
+        if( out == NULL )
+            break;
+
+        vlc_tick_t deadline = out->i_dts + i_caching;
+        batch[n++] = out;
+
+#ifdef HAVE_SENDMMSG
+        /* Aggregate packets sharing the same pacing deadline, so that they
+         * cost a single system call per sink below. */
+        while( n < RTP_BATCH_MAX )
+        {
+            vlc_queue_Lock( &id->queue );
+            out = vlc_queue_IsEmpty( &id->queue ) ? NULL
+                : vlc_queue_DequeueUnlocked( &id->queue );
+            vlc_queue_Unlock( &id->queue );
+            if( out == NULL )
+                break;
+            if( out->i_dts + i_caching > deadline + RTP_BATCH_WINDOW )
+            {
+                next = out; /* too early: starts the next batch */
+                break;
+            }
+            batch[n++] = out;
+        }
+#endif
+
 #ifdef HAVE_SRTP
         if( id->srtp )
         {   /* FIXME: this is awfully inefficient */
-            size_t len = out->i_buffer;
-            out = block_Realloc( out, 0, len + 10 );
-            out->i_buffer = len;
+            unsigned kept = 0;
 
-            int val = srtp_send( id->srtp, out->p_buffer, &len, len + 10 );
-            if( val )
+            for( unsigned j = 0; j < n; j++ )
             {
-                msg_Dbg( id->p_stream, "SRTP sending error: %s",
-                         vlc_strerror_c(val) );
-                block_Release( out );
-                continue;
+                out = batch[j];
+
+                size_t len = out->i_buffer;
+                out = block_Realloc( out, 0, len + 10 );
+                out->i_buffer = len;
+
+                int val = srtp_send( id->srtp, out->p_buffer, &len, len + 10 );
+                if( val )
+                {
+                    msg_Dbg( id->p_stream, "SRTP sending error: %s",
+                             vlc_strerror_c(val) );
+                    block_Release( out );
+                    continue;
+                }
+                out->i_buffer = len;
+                batch[kept++] = out;
             }
-            out->i_buffer = len;
+            n = kept;
+            if( n == 0 )
+                continue;
         }
 #endif
-        vlc_tick_wait (out->i_dts + i_caching);
-
-        ssize_t len = out->i_buffer;
+        vlc_tick_wait (deadline);
 
         vlc_mutex_lock( &id->lock_sink );
         unsigned deadc = 0; /* How many dead sockets? */
         int deadv[id->sinkc ? id->sinkc : 1]; /* Dead sockets list */
 
+#ifdef HAVE_SENDMMSG
+        struct iovec iov[RTP_BATCH_MAX];
+        struct mmsghdr msgv[RTP_BATCH_MAX];
+
+        for( unsigned j = 0; j < n; j++ )
+        {
+            iov[j].iov_base = batch[j]->p_buffer;
+            iov[j].iov_len = batch[j]->i_buffer;
+            memset( &msgv[j], 0, sizeof (msgv[j]) );
+            msgv[j].msg_hdr.msg_iov = iov + j;
+            msgv[j].msg_hdr.msg_iovlen = 1;
+        }
+#endif
+
         for( int i = 0; i < id->sinkc; i++ )
         {
 #ifdef HAVE_SRTP
             if( !id->srtp ) /* FIXME: SRTCP support */
 #endif
-                SendRTCP( id->sinkv[i].rtcp, out );
+                for( unsigned j = 0; j < n; j++ )
+                    SendRTCP( id->sinkv[i].rtcp, batch[j] );
+
+#ifdef HAVE_SENDMMSG
+            unsigned sent = 0;
+            bool retried = false;
+
+            while( sent < n )
+            {
+                int val = sendmmsg( id->sinkv[i].rtp_fd, msgv + sent,
+                                    n - sent, 0 );
+                if( val > 0 )
+                {
+                    sent += val;
+                    continue;
+                }
+                if( net_errno == EAGAIN || net_errno == EWOULDBLOCK
+                 || net_errno == ENOBUFS || net_errno == ENOMEM )
+                    break;
+
+                int type;
+                getsockopt( id->sinkv[i].rtp_fd, SOL_SOCKET, SO_TYPE,
+                            &type, &(socklen_t){ sizeof(type) });
+                if( type == SOCK_DGRAM && !retried )
+                    /* ICMP soft error: ignore and retry */
+                    retried = true;
+                else
+                {
+                    /* Broken connection */
+                    deadv[deadc++] = id->sinkv[i].rtp_fd;
+                    break;
+                }
+            }
+#else
+            out = batch[0];
 
-            if( send( id->sinkv[i].rtp_fd, out->p_buffer, len, 0 ) == -1
+            if( send( id->sinkv[i].rtp_fd, out->p_buffer, out->i_buffer,
+                      0 ) == -1
              && net_errno != EAGAIN && net_errno != EWOULDBLOCK
              && net_errno != ENOBUFS && net_errno != ENOMEM )
             {
@@ -1359,15 +1510,20 @@ static void* ThreadSend( void *data )
                             &type, &(socklen_t){ sizeof(type) });
                 if( type == SOCK_DGRAM )
                     /* ICMP soft error: ignore and retry */
-                    send( id->sinkv[i].rtp_fd, out->p_buffer, len, 0 );
+                    send( id->sinkv[i].rtp_fd, out->p_buffer, out->i_buffer,
+                          0 );
                 else
                     /* Broken connection */
                     deadv[deadc++] = id->sinkv[i].rtp_fd;
             }
+#endif
         }
-        id->i_seq_sent_next = ntohs(((uint16_t *) out->p_buffer)[1]) + 1;
+        id->i_seq_sent_next = ntohs(((uint16_t *) batch[n - 1]->p_buffer)[1])
+                            + 1;
         vlc_mutex_unlock( &id->lock_sink );
-        block_Release( out );
+
+        for( unsigned j = 0; j < n; j++ )
+            block_Release( batch[j] );
 
         for( unsigned i = 0; i < deadc; i++ )
         {
@@ -1375,6 +1531,10 @@ static void* ThreadSend( void *data )
             rtp_del_sink( id, deadv[i] );
         }
     }
+#ifdef HAVE_SENDMMSG
+    if( next != NULL )
+        block_Release( next );
+#endif
     return NULL;
 }
 
@@ -144,6 +144,27 @@ static void Flush( sout_stream_t *p_stream, void *id )
     sout_MuxFlush( p_sys->p_mux, (sout_input_t*)id );
 }
 
+static int Control( sout_stream_t *p_stream, int i_query, va_list args )
+{
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+
+    switch( i_query )
+    {
+        case SOUT_STREAM_CAN_PASSTHROUGH:
+        {
+            const es_format_t *p_fmt = va_arg( args, const es_format_t * );
+            bool *pb_bool = va_arg( args, bool * );
+
+            /* Let the muxer decide whether it accepts the format without
+             * re-packetization */
+            return sout_MuxControl( p_sys->p_mux, MUX_CAN_PASSTHROUGH,
+                                    p_fmt, pb_bool );
+        }
+    }
+
+    return VLC_EGENERIC;
+}
+
 static void create_SDP(sout_stream_t *p_stream, sout_access_out_t *p_access)
 {
     sout_stream_sys_t   *p_sys = p_stream->p_sys;
@@ -403,6 +424,7 @@ static int Open( vlc_object_t *p_this )
     p_stream->pf_del    = Del;
     p_stream->pf_send   = Send;
     p_stream->pf_flush  = Flush;
+    p_stream->pf_control = Control;
     if( !sout_AccessOutCanControlPace( p_access ) )
         p_stream->pace_nocontrol = true;
 
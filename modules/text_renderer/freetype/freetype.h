@@ -65,6 +65,8 @@ typedef uint32_t uni_char_t;
 # endif
 #endif
 
+#include "glyph_cache.h"
+
 /*****************************************************************************
  * filter_sys_t: freetype local data
  *****************************************************************************
@@ -110,6 +112,9 @@ typedef struct
     /** Font face cache */
     vlc_dictionary_t  face_map;
 
+    /** Rasterized glyph and shaped-run cache */
+    glyph_cache_t     glyph_cache;
+
     int               i_fallback_counter;
 
     /* Current scaling of the text, default is 100 (%) */
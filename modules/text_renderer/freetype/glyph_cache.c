@@ -0,0 +1,294 @@
+/*****************************************************************************
+ * glyph_cache.c : Caches of rasterized glyphs and shaped runs
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+
+#include "freetype.h"
+
+/* When a cache grows past these limits it is simply flushed; lookups hand
+ * out copies, so nothing points into the cache across a flush. */
+#define GLYPH_CACHE_MAX_GLYPHS 2048
+#define GLYPH_CACHE_MAX_RUNS    512
+
+/* Runs longer than this are not worth the key they would need */
+#define GLYPH_CACHE_MAX_RUN_LENGTH 256
+
+typedef struct
+{
+    FT_Glyph p_glyph;
+    FT_Glyph p_outline;                                 /* may be NULL */
+} glyph_cache_entry_t;
+
+#ifdef HAVE_HARFBUZZ
+typedef struct
+{
+    unsigned             i_glyph_count;
+    hb_glyph_info_t     *p_infos;
+    hb_glyph_position_t *p_positions;
+} shaped_run_entry_t;
+#endif
+
+void GlyphCacheInit( glyph_cache_t *p_cache )
+{
+    vlc_dictionary_init( &p_cache->glyph_map, 50 );
+    p_cache->i_glyphs = 0;
+#ifdef HAVE_HARFBUZZ
+    vlc_dictionary_init( &p_cache->run_map, 50 );
+    p_cache->i_runs = 0;
+#endif
+}
+
+static void FreeGlyphEntry( void *p_value, void *p_obj )
+{
+    VLC_UNUSED( p_obj );
+    glyph_cache_entry_t *p_entry = p_value;
+
+    FT_Done_Glyph( p_entry->p_glyph );
+    if( p_entry->p_outline )
+        FT_Done_Glyph( p_entry->p_outline );
+    free( p_entry );
+}
+
+#ifdef HAVE_HARFBUZZ
+static void FreeRunEntry( void *p_value, void *p_obj )
+{
+    VLC_UNUSED( p_obj );
+    shaped_run_entry_t *p_entry = p_value;
+
+    free( p_entry->p_infos );
+    free( p_entry->p_positions );
+    free( p_entry );
+}
+#endif
+
+void GlyphCacheClean( glyph_cache_t *p_cache )
+{
+    vlc_dictionary_clear( &p_cache->glyph_map, FreeGlyphEntry, NULL );
+    p_cache->i_glyphs = 0;
+#ifdef HAVE_HARFBUZZ
+    vlc_dictionary_clear( &p_cache->run_map, FreeRunEntry, NULL );
+    p_cache->i_runs = 0;
+#endif
+}
+
+static char *GlyphKey( FT_Face face, FT_UInt i_index, int i_size,
+                       int i_style_flags, int i_radius )
+{
+    char *psz_key;
+    /* Embolden/oblique/stroke all depend on the style, the rest on the
+     * sized face and glyph index */
+    if( asprintf( &psz_key, "%p - %u - %d - %x - %d", (void *)face, i_index,
+                  i_size, i_style_flags, i_radius ) < 0 )
+        return NULL;
+    return psz_key;
+}
+
+bool GlyphCacheLookup( glyph_cache_t *p_cache, FT_Face face, FT_UInt i_index,
+                       int i_size, int i_style_flags, int i_radius,
+                       FT_Glyph *pp_glyph, FT_Glyph *pp_outline )
+{
+    char *psz_key = GlyphKey( face, i_index, i_size, i_style_flags, i_radius );
+    if( !psz_key )
+        return false;
+
+    glyph_cache_entry_t *p_entry =
+        vlc_dictionary_value_for_key( &p_cache->glyph_map, psz_key );
+    free( psz_key );
+    if( !p_entry )
+        return false;
+
+    FT_Glyph p_glyph = NULL, p_outline = NULL;
+    if( FT_Glyph_Copy( p_entry->p_glyph, &p_glyph ) )
+        return false;
+    if( p_entry->p_outline
+     && FT_Glyph_Copy( p_entry->p_outline, &p_outline ) )
+    {
+        FT_Done_Glyph( p_glyph );
+        return false;
+    }
+
+    *pp_glyph = p_glyph;
+    *pp_outline = p_outline;
+    return true;
+}
+
+void GlyphCacheStore( glyph_cache_t *p_cache, FT_Face face, FT_UInt i_index,
+                      int i_size, int i_style_flags, int i_radius,
+                      FT_Glyph p_glyph, FT_Glyph p_outline )
+{
+    if( p_cache->i_glyphs >= GLYPH_CACHE_MAX_GLYPHS )
+    {
+        vlc_dictionary_clear( &p_cache->glyph_map, FreeGlyphEntry, NULL );
+        vlc_dictionary_init( &p_cache->glyph_map, 50 );
+        p_cache->i_glyphs = 0;
+    }
+
+    char *psz_key = GlyphKey( face, i_index, i_size, i_style_flags, i_radius );
+    if( !psz_key )
+        return;
+    if( vlc_dictionary_has_key( &p_cache->glyph_map, psz_key ) )
+    {
+        free( psz_key );
+        return;
+    }
+
+    glyph_cache_entry_t *p_entry = malloc( sizeof( *p_entry ) );
+    if( !p_entry )
+    {
+        free( psz_key );
+        return;
+    }
+    p_entry->p_glyph = NULL;
+    p_entry->p_outline = NULL;
+
+    if( FT_Glyph_Copy( p_glyph, &p_entry->p_glyph )
+     || ( p_outline && FT_Glyph_Copy( p_outline, &p_entry->p_outline ) ) )
+    {
+        if( p_entry->p_glyph )
+            FT_Done_Glyph( p_entry->p_glyph );
+        free( p_entry );
+        free( psz_key );
+        return;
+    }
+
+    vlc_dictionary_insert( &p_cache->glyph_map, psz_key, p_entry );
+    p_cache->i_glyphs++;
+    free( psz_key );
+}
+
+#ifdef HAVE_HARFBUZZ
+static char *RunKey( const uni_char_t *p_uchars, size_t i_count, FT_Face face,
+                     int i_size, int i_style_flags, int i_script,
+                     int i_direction )
+{
+    if( i_count > GLYPH_CACHE_MAX_RUN_LENGTH )
+        return NULL;
+
+    /* 8 hex digits and a separator per codepoint, plus the style part */
+    size_t i_length = i_count * 9 + 64;
+    char *psz_key = malloc( i_length );
+    if( !psz_key )
+        return NULL;
+
+    int i_pos = snprintf( psz_key, i_length, "%p - %d - %x - %d - %d - ",
+                          (void *)face, i_size, i_style_flags,
+                          i_script, i_direction );
+    for( size_t i = 0; i < i_count; ++i )
+        i_pos += snprintf( psz_key + i_pos, i_length - i_pos, "%x,",
+                           (unsigned)p_uchars[ i ] );
+    return psz_key;
+}
+
+bool ShapedRunCacheLookup( glyph_cache_t *p_cache, const uni_char_t *p_uchars,
+                           size_t i_count, FT_Face face, int i_size,
+                           int i_style_flags, int i_script, int i_direction,
+                           hb_glyph_info_t **pp_infos,
+                           hb_glyph_position_t **pp_positions,
+                           unsigned *pi_glyph_count )
+{
+    char *psz_key = RunKey( p_uchars, i_count, face, i_size, i_style_flags,
+                            i_script, i_direction );
+    if( !psz_key )
+        return false;
+
+    shaped_run_entry_t *p_entry =
+        vlc_dictionary_value_for_key( &p_cache->run_map, psz_key );
+    free( psz_key );
+    if( !p_entry )
+        return false;
+
+    hb_glyph_info_t *p_infos =
+        vlc_alloc( p_entry->i_glyph_count, sizeof( *p_infos ) );
+    hb_glyph_position_t *p_positions =
+        vlc_alloc( p_entry->i_glyph_count, sizeof( *p_positions ) );
+    if( !p_infos || !p_positions )
+    {
+        free( p_infos );
+        free( p_positions );
+        return false;
+    }
+    memcpy( p_infos, p_entry->p_infos,
+            p_entry->i_glyph_count * sizeof( *p_infos ) );
+    memcpy( p_positions, p_entry->p_positions,
+            p_entry->i_glyph_count * sizeof( *p_positions ) );
+
+    *pp_infos = p_infos;
+    *pp_positions = p_positions;
+    *pi_glyph_count = p_entry->i_glyph_count;
+    return true;
+}
+
+void ShapedRunCacheStore( glyph_cache_t *p_cache, const uni_char_t *p_uchars,
+                          size_t i_count, FT_Face face, int i_size,
+                          int i_style_flags, int i_script, int i_direction,
+                          const hb_glyph_info_t *p_infos,
+                          const hb_glyph_position_t *p_positions,
+                          unsigned i_glyph_count )
+{
+    if( i_glyph_count <= 0 )
+        return;
+
+    if( p_cache->i_runs >= GLYPH_CACHE_MAX_RUNS )
+    {
+        vlc_dictionary_clear( &p_cache->run_map, FreeRunEntry, NULL );
+        vlc_dictionary_init( &p_cache->run_map, 50 );
+        p_cache->i_runs = 0;
+    }
+
+    char *psz_key = RunKey( p_uchars, i_count, face, i_size, i_style_flags,
+                            i_script, i_direction );
+    if( !psz_key )
+        return;
+    if( vlc_dictionary_has_key( &p_cache->run_map, psz_key ) )
+    {
+        free( psz_key );
+        return;
+    }
+
+    shaped_run_entry_t *p_entry = malloc( sizeof( *p_entry ) );
+    if( !p_entry )
+    {
+        free( psz_key );
+        return;
+    }
+    p_entry->i_glyph_count = i_glyph_count;
+    p_entry->p_infos = vlc_alloc( i_glyph_count, sizeof( *p_entry->p_infos ) );
+    p_entry->p_positions =
+        vlc_alloc( i_glyph_count, sizeof( *p_entry->p_positions ) );
+    if( !p_entry->p_infos || !p_entry->p_positions )
+    {
+        FreeRunEntry( p_entry, NULL );
+        free( psz_key );
+        return;
+    }
+    memcpy( p_entry->p_infos, p_infos,
+            i_glyph_count * sizeof( *p_entry->p_infos ) );
+    memcpy( p_entry->p_positions, p_positions,
+            i_glyph_count * sizeof( *p_entry->p_positions ) );
+
+    vlc_dictionary_insert( &p_cache->run_map, psz_key, p_entry );
+    p_cache->i_runs++;
+    free( psz_key );
+}
+#endif
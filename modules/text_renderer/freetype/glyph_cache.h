@@ -0,0 +1,111 @@
+/*****************************************************************************
+ * glyph_cache.h : Caches of rasterized glyphs and shaped runs
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_FREETYPE_GLYPH_CACHE_H
+#define VLC_FREETYPE_GLYPH_CACHE_H
+
+/** \ingroup freetype
+ * @{
+ * \file
+ * Glyph and shaped-run caches
+ *
+ * Live captions and scrolling tickers re-render mostly identical text on
+ * every change. These caches keep the expensive intermediate results
+ * across renders: loaded/emboldened/stroked glyph outlines, and with
+ * HarfBuzz the shaping output of whole runs, keyed on text and style.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_arrays.h>                                 /* vlc_dictionary_t */
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_GLYPH_H
+
+#ifdef HAVE_HARFBUZZ
+# include <hb.h>
+#endif
+
+typedef struct
+{
+    /** Glyph outlines after load/embolden/stroke, ready for rendering */
+    vlc_dictionary_t glyph_map;
+    size_t           i_glyphs;
+
+#ifdef HAVE_HARFBUZZ
+    /** Shaping output per run, keyed on codepoints, face and style */
+    vlc_dictionary_t run_map;
+    size_t           i_runs;
+#endif
+} glyph_cache_t;
+
+void GlyphCacheInit( glyph_cache_t * );
+void GlyphCacheClean( glyph_cache_t * );
+
+/**
+ * Looks a glyph up in the cache.
+ *
+ * On a hit \p pp_glyph and \p pp_outline receive copies owned by the
+ * caller (\p pp_outline may be set to NULL when the style has no
+ * outline) and true is returned.
+ */
+bool GlyphCacheLookup( glyph_cache_t *, FT_Face face, FT_UInt i_index,
+                       int i_size, int i_style_flags, int i_radius,
+                       FT_Glyph *pp_glyph, FT_Glyph *pp_outline );
+
+/**
+ * Stores copies of a freshly loaded glyph and its optional stroked
+ * outline. Failures are silent, the cache is best-effort.
+ */
+void GlyphCacheStore( glyph_cache_t *, FT_Face face, FT_UInt i_index,
+                      int i_size, int i_style_flags, int i_radius,
+                      FT_Glyph p_glyph, FT_Glyph p_outline );
+
+#ifdef HAVE_HARFBUZZ
+/**
+ * Looks a shaped run up in the cache.
+ *
+ * On a hit \p pp_infos and \p pp_positions receive malloc'ed copies of
+ * the shaping output, to be released with free() by the caller.
+ */
+bool ShapedRunCacheLookup( glyph_cache_t *, const uni_char_t *p_uchars,
+                           size_t i_count, FT_Face face, int i_size,
+                           int i_style_flags, int i_script, int i_direction,
+                           hb_glyph_info_t **pp_infos,
+                           hb_glyph_position_t **pp_positions,
+                           unsigned *pi_glyph_count );
+
+/**
+ * Stores a copy of the shaping output of one run.
+ */
+void ShapedRunCacheStore( glyph_cache_t *, const uni_char_t *p_uchars,
+                          size_t i_count, FT_Face face, int i_size,
+                          int i_style_flags, int i_script, int i_direction,
+                          const hb_glyph_info_t *p_infos,
+                          const hb_glyph_position_t *p_positions,
+                          unsigned i_glyph_count );
+#endif
+
+/** @} */
+
+#endif
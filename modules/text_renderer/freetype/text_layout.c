@@ -770,6 +770,21 @@ static int ShapeParagraphHarfBuzz( filter_t *p_filter,
         else
             p_face = p_run->p_face;
 
+        /* Reuse the shaping output of a previously seen identical run.
+         * Cache hits leave p_hb_font/p_buffer NULL and own the arrays. */
+        if( ShapedRunCacheLookup( &p_sys->glyph_cache,
+                          p_paragraph->p_code_points + p_run->i_start_offset,
+                          p_run->i_end_offset - p_run->i_start_offset,
+                          p_face, ConvertToLiveSize( p_filter, p_style ),
+                          p_style->i_style_flags,
+                          p_run->script, p_run->direction,
+                          &p_run->p_glyph_infos, &p_run->p_glyph_positions,
+                          &p_run->i_glyph_count ) )
+        {
+            i_total_glyphs += p_run->i_glyph_count;
+            continue;
+        }
+
         p_run->p_hb_font = hb_ft_font_create( p_face, 0 );
         if( !p_run->p_hb_font )
         {
@@ -812,6 +827,15 @@ static int ShapeParagraphHarfBuzz( filter_t *p_filter,
             goto error;
         }
 
+        ShapedRunCacheStore( &p_sys->glyph_cache,
+                             p_paragraph->p_code_points + p_run->i_start_offset,
+                             p_run->i_end_offset - p_run->i_start_offset,
+                             p_face, ConvertToLiveSize( p_filter, p_style ),
+                             p_style->i_style_flags,
+                             p_run->script, p_run->direction,
+                             p_run->p_glyph_infos, p_run->p_glyph_positions,
+                             p_run->i_glyph_count );
+
         i_total_glyphs += p_run->i_glyph_count;
     }
 
@@ -883,8 +907,18 @@ static int ShapeParagraphHarfBuzz( filter_t *p_filter,
 
     for( int i = 0; i < p_paragraph->i_runs_count; ++i )
     {
-        hb_font_destroy( p_paragraph->p_runs[ i ].p_hb_font );
-        hb_buffer_destroy( p_paragraph->p_runs[ i ].p_buffer );
+        run_desc_t *p_run = p_paragraph->p_runs + i;
+        if( p_run->p_buffer )
+        {
+            hb_font_destroy( p_run->p_hb_font );
+            hb_buffer_destroy( p_run->p_buffer );
+        }
+        else
+        {
+            /* Shaping came from the cache */
+            free( p_run->p_glyph_infos );
+            free( p_run->p_glyph_positions );
+        }
     }
     FreeParagraph( *p_old_paragraph );
     *p_old_paragraph = p_new_paragraph;
@@ -894,10 +928,16 @@ static int ShapeParagraphHarfBuzz( filter_t *p_filter,
 error:
     for( int i = 0; i < p_paragraph->i_runs_count; ++i )
     {
-        if( p_paragraph->p_runs[ i ].p_hb_font )
-            hb_font_destroy( p_paragraph->p_runs[ i ].p_hb_font );
-        if( p_paragraph->p_runs[ i ].p_buffer )
-            hb_buffer_destroy( p_paragraph->p_runs[ i ].p_buffer );
+        run_desc_t *p_run = p_paragraph->p_runs + i;
+        if( p_run->p_hb_font )
+            hb_font_destroy( p_run->p_hb_font );
+        if( p_run->p_buffer )
+            hb_buffer_destroy( p_run->p_buffer );
+        else
+        {
+            free( p_run->p_glyph_infos );
+            free( p_run->p_glyph_positions );
+        }
     }
 
     if( p_new_paragraph )
@@ -1039,12 +1079,13 @@ static int LoadGlyphs( filter_t *p_filter, paragraph_t *p_paragraph,
         else
             p_face = p_run->p_face;
 
+        int i_radius = 0;
         if( p_sys->p_stroker && (p_style->i_style_flags & STYLE_OUTLINE) )
         {
             double f_outline_thickness =
                 var_InheritInteger( p_filter, "freetype-outline-thickness" ) / 100.0;
             f_outline_thickness = VLC_CLIP( f_outline_thickness, 0.0, 0.5 );
-            int i_radius = ( i_live_size << 6 ) * f_outline_thickness;
+            i_radius = ( i_live_size << 6 ) * f_outline_thickness;
             FT_Stroker_Set( p_sys->p_stroker,
                             i_radius,
                             FT_STROKER_LINECAP_ROUND,
@@ -1101,41 +1142,59 @@ static int LoadGlyphs( filter_t *p_filter, paragraph_t *p_paragraph,
                     SKIP_GLYPH( p_bitmaps )
             }
 
-            if( FT_Load_Glyph( p_face, i_glyph_index,
-                               FT_LOAD_NO_BITMAP | FT_LOAD_DEFAULT )
-             && FT_Load_Glyph( p_face, i_glyph_index, FT_LOAD_DEFAULT ) )
-                SKIP_GLYPH( p_bitmaps )
+            if( GlyphCacheLookup( &p_sys->glyph_cache, p_face, i_glyph_index,
+                                  i_live_size, p_style->i_style_flags, i_radius,
+                                  &p_bitmaps->p_glyph, &p_bitmaps->p_outline ) )
+            {
+                if( b_overwrite_advance )
+                {
+                    /* FT_Get_Glyph() stored the slot advance as 16.16 */
+                    p_bitmaps->i_x_advance = p_bitmaps->p_glyph->advance.x >> 10;
+                    p_bitmaps->i_y_advance = p_bitmaps->p_glyph->advance.y >> 10;
+                }
+            }
+            else
+            {
+                if( FT_Load_Glyph( p_face, i_glyph_index,
+                                   FT_LOAD_NO_BITMAP | FT_LOAD_DEFAULT )
+                 && FT_Load_Glyph( p_face, i_glyph_index, FT_LOAD_DEFAULT ) )
+                    SKIP_GLYPH( p_bitmaps )
+
+                if( ( p_style->i_style_flags & STYLE_BOLD )
+                      && !( p_face->style_flags & FT_STYLE_FLAG_BOLD ) )
+                    FT_GlyphSlot_Embolden( p_face->glyph );
+                if( ( p_style->i_style_flags & STYLE_ITALIC )
+                      && !( p_face->style_flags & FT_STYLE_FLAG_ITALIC ) )
+                    FT_GlyphSlot_Oblique( p_face->glyph );
 
-            if( ( p_style->i_style_flags & STYLE_BOLD )
-                  && !( p_face->style_flags & FT_STYLE_FLAG_BOLD ) )
-                FT_GlyphSlot_Embolden( p_face->glyph );
-            if( ( p_style->i_style_flags & STYLE_ITALIC )
-                  && !( p_face->style_flags & FT_STYLE_FLAG_ITALIC ) )
-                FT_GlyphSlot_Oblique( p_face->glyph );
+                if( FT_Get_Glyph( p_face->glyph, &p_bitmaps->p_glyph ) )
+                    SKIP_GLYPH( p_bitmaps )
 
-            if( FT_Get_Glyph( p_face->glyph, &p_bitmaps->p_glyph ) )
-                SKIP_GLYPH( p_bitmaps )
+                if( p_sys->p_stroker && (p_style->i_style_flags & STYLE_OUTLINE) )
+                {
+                    p_bitmaps->p_outline = p_bitmaps->p_glyph;
+                    if( FT_Glyph_StrokeBorder( &p_bitmaps->p_outline,
+                                               p_sys->p_stroker, 0, 0 ) )
+                        p_bitmaps->p_outline = 0;
+                }
 
-#undef SKIP_GLYPH
+                GlyphCacheStore( &p_sys->glyph_cache, p_face, i_glyph_index,
+                                 i_live_size, p_style->i_style_flags, i_radius,
+                                 p_bitmaps->p_glyph, p_bitmaps->p_outline );
 
-            if( p_sys->p_stroker && (p_style->i_style_flags & STYLE_OUTLINE) )
-            {
-                p_bitmaps->p_outline = p_bitmaps->p_glyph;
-                if( FT_Glyph_StrokeBorder( &p_bitmaps->p_outline,
-                                           p_sys->p_stroker, 0, 0 ) )
-                    p_bitmaps->p_outline = 0;
+                if( b_overwrite_advance )
+                {
+                    p_bitmaps->i_x_advance = p_face->glyph->advance.x;
+                    p_bitmaps->i_y_advance = p_face->glyph->advance.y;
+                }
             }
 
+#undef SKIP_GLYPH
+
             if( p_style->i_shadow_alpha != STYLE_ALPHA_TRANSPARENT )
                 p_bitmaps->p_shadow = p_bitmaps->p_outline ?
                                       p_bitmaps->p_outline : p_bitmaps->p_glyph;
 
-            if( b_overwrite_advance )
-            {
-                p_bitmaps->i_x_advance = p_face->glyph->advance.x;
-                p_bitmaps->i_y_advance = p_face->glyph->advance.y;
-            }
-
             unsigned i_x_advance = FT_FLOOR( abs( p_bitmaps->i_x_advance ) );
             if( i_x_advance > *pi_max_advance_x )
                 *pi_max_advance_x = i_x_advance;
@@ -0,0 +1,153 @@
+/*****************************************************************************
+ * json.c: JSON line tracer
+ *****************************************************************************
+ * Copyright (C) 2021 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_fs.h>
+#include <vlc_tracer.h>
+
+/* One JSON object per line, so the output can be followed live and fed to
+ * standard trace processing tools without a closing bracket. */
+
+struct vlc_tracer_json
+{
+    FILE *stream;
+};
+
+static void PrintString(FILE *stream, const char *str)
+{
+    fputc('"', stream);
+    for (const char *p = str; *p != '\0'; p++)
+    {
+        unsigned char c = *p;
+        if (c == '"' || c == '\\')
+            fprintf(stream, "\\%c", c);
+        else if (c < 0x20)
+            fprintf(stream, "\\u%04x", c);
+        else
+            fputc(c, stream);
+    }
+    fputc('"', stream);
+}
+
+static void Trace(void *opaque, vlc_tick_t ts, va_list entries)
+{
+    struct vlc_tracer_json *sys = opaque;
+    FILE *stream = sys->stream;
+
+    flockfile(stream);
+    fprintf(stream, "{\"Timestamp\": %"PRId64, ts);
+
+    for (;;)
+    {
+        struct vlc_tracer_entry entry = va_arg(entries,
+                                               struct vlc_tracer_entry);
+        if (entry.key == NULL)
+            break;
+
+        fputs(", ", stream);
+        PrintString(stream, entry.key);
+        fputs(": ", stream);
+        switch (entry.type)
+        {
+            case VLC_TRACER_INT:
+                fprintf(stream, "%"PRId64, entry.value.integer);
+                break;
+            case VLC_TRACER_TICK:
+                fprintf(stream, "%"PRId64, entry.value.tick);
+                break;
+            case VLC_TRACER_STRING:
+                PrintString(stream, entry.value.string);
+                break;
+        }
+    }
+
+    fputs("}\n", stream);
+    funlockfile(stream);
+}
+
+static void Destroy(void *opaque)
+{
+    struct vlc_tracer_json *sys = opaque;
+
+    if (sys->stream != stderr)
+        fclose(sys->stream);
+    free(sys);
+}
+
+static const struct vlc_tracer_operations ops =
+{
+    Trace,
+    Destroy,
+};
+
+static const struct vlc_tracer_operations *Open(vlc_object_t *obj,
+                                                void **restrict sysp)
+{
+    struct vlc_tracer_json *sys = malloc(sizeof (*sys));
+    if (unlikely(sys == NULL))
+        return NULL;
+
+    char *path = var_InheritString(obj, "json-tracer-file");
+    if (path != NULL)
+    {
+        sys->stream = vlc_fopen(path, "at");
+        if (sys->stream == NULL)
+        {
+            msg_Err(obj, "cannot open trace file %s: %s", path,
+                    vlc_strerror_c(errno));
+            free(path);
+            free(sys);
+            return NULL;
+        }
+        free(path);
+        setvbuf(sys->stream, NULL, _IOLBF, 0);
+    }
+    else
+        sys->stream = stderr;
+
+    *sysp = sys;
+    return &ops;
+}
+
+#define FILE_TEXT N_("Trace file")
+#define FILE_LONGTEXT N_( \
+    "File to which the trace events are appended, one JSON object per " \
+    "line. Events are written to the standard error output when unset." )
+
+vlc_module_begin()
+    set_shortname(N_("JSON tracer"))
+    set_description(N_("JSON line tracer"))
+    set_category(CAT_ADVANCED)
+    set_subcategory(SUBCAT_ADVANCED_MISC)
+    set_capability("tracer", 0)
+    set_callback(Open)
+
+    add_savefile("json-tracer-file", NULL, FILE_TEXT, FILE_LONGTEXT)
+vlc_module_end()
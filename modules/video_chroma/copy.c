@@ -34,6 +34,10 @@
 #include <vlc_cpu.h>
 #include <assert.h>
 
+#ifdef __ARM_NEON
+# include <arm_neon.h>
+#endif
+
 #include "copy.h"
 static void CopyPlane(uint8_t *dst, size_t dst_pitch,
                       const uint8_t *src, size_t src_pitch,
@@ -233,6 +237,104 @@ static void Copy2d(uint8_t *dst, size_t dst_pitch,
     }
 }
 
+#ifdef CAN_COMPILE_AVX2
+/* Copy 128 bytes per iteration with 256-bit registers. The cache rows are
+ * only 16-byte aligned, hence the unaligned loads. */
+#define COPY128(dstp, srcp, store) \
+    asm volatile ( \
+        "vmovdqu    0(%[src]), %%ymm0\n" \
+        "vmovdqu   32(%[src]), %%ymm1\n" \
+        "vmovdqu   64(%[src]), %%ymm2\n" \
+        "vmovdqu   96(%[src]), %%ymm3\n" \
+        store "    %%ymm0,    0(%[dst])\n" \
+        store "    %%ymm1,   32(%[dst])\n" \
+        store "    %%ymm2,   64(%[dst])\n" \
+        store "    %%ymm3,   96(%[dst])\n" \
+        : : [dst]"r"(dstp), [src]"r"(srcp) \
+        : "memory", "ymm0", "ymm1", "ymm2", "ymm3")
+
+static void AVX2_Copy2d(uint8_t *dst, size_t dst_pitch,
+                        const uint8_t *src, size_t src_pitch,
+                        unsigned width, unsigned height)
+{
+    for (unsigned y = 0; y < height; y++) {
+        unsigned x = 0;
+
+        bool unaligned = ((intptr_t)dst & 0x1f) != 0;
+        if (!unaligned) {
+            /* Non-temporal stores: whole frames do not fit in the caches */
+            for (; x+127 < width; x += 128)
+                COPY128(&dst[x], &src[x], "vmovntdq");
+        } else {
+            for (; x+127 < width; x += 128)
+                COPY128(&dst[x], &src[x], "vmovdqu");
+        }
+
+        for (; x < width; x++)
+            dst[x] = src[x];
+
+        src += src_pitch;
+        dst += dst_pitch;
+    }
+    asm volatile ("vzeroupper");
+}
+#undef COPY128
+
+static void
+AVX2_InterleaveUV(uint8_t *dst, size_t dst_pitch,
+                  const uint8_t *srcu, size_t srcu_pitch,
+                  const uint8_t *srcv, size_t srcv_pitch,
+                  unsigned int width, unsigned int height, uint8_t pixel_size)
+{
+    assert(pixel_size == 1 || pixel_size == 2);
+
+    for (unsigned int y = 0; y < height; y++)
+    {
+        unsigned int x;
+
+#define AVX2_INTERLEAVE(punpckl, punpckh) \
+    asm volatile ( \
+        "vmovdqu (%[src1]), %%ymm0\n" \
+        "vmovdqu (%[src2]), %%ymm1\n" \
+        punpckl " %%ymm1, %%ymm0, %%ymm2\n" \
+        punpckh " %%ymm1, %%ymm0, %%ymm3\n" \
+        "vperm2i128 $0x20, %%ymm3, %%ymm2, %%ymm0\n" \
+        "vperm2i128 $0x31, %%ymm3, %%ymm2, %%ymm1\n" \
+        "vmovdqu %%ymm0,  0(%[dst])\n" \
+        "vmovdqu %%ymm1, 32(%[dst])\n" \
+        : : [dst]"r"(dst+2*x), [src1]"r"(srcu+x), [src2]"r"(srcv+x) \
+        : "memory", "ymm0", "ymm1", "ymm2", "ymm3")
+
+        if (pixel_size == 1)
+        {
+            for (x = 0; x < (width & ~31); x += 32)
+                AVX2_INTERLEAVE("vpunpcklbw", "vpunpckhbw");
+            for (; x < width; x++) {
+                dst[2*x+0] = srcu[x];
+                dst[2*x+1] = srcv[x];
+            }
+        }
+        else
+        {
+            for (x = 0; x < (width & ~31); x += 32)
+                AVX2_INTERLEAVE("vpunpcklwd", "vpunpckhwd");
+            for (; x < width; x+= 2) {
+                dst[2*x+0] = srcu[x];
+                dst[2*x+1] = srcu[x + 1];
+                dst[2*x+2] = srcv[x];
+                dst[2*x+3] = srcv[x + 1];
+            }
+        }
+#undef AVX2_INTERLEAVE
+
+        srcu += srcu_pitch;
+        srcv += srcv_pitch;
+        dst += dst_pitch;
+    }
+    asm volatile ("vzeroupper");
+}
+#endif /* CAN_COMPILE_AVX2 */
+
 VLC_SSE
 static void
 SSE_InterleaveUV(uint8_t *dst, size_t dst_pitch,
@@ -483,7 +585,12 @@ static void SSE_CopyPlane(uint8_t *dst, size_t dst_pitch,
         CopyFromUswc(cache, w16, src, src_pitch, cache_width, hblock, bitshift);
 
         /* Copy from our cache to the destination */
-        Copy2d(dst, dst_pitch, cache, w16, copy_pitch, hblock);
+#ifdef CAN_COMPILE_AVX2
+        if (vlc_CPU_AVX2())
+            AVX2_Copy2d(dst, dst_pitch, cache, w16, copy_pitch, hblock);
+        else
+#endif
+            Copy2d(dst, dst_pitch, cache, w16, copy_pitch, hblock);
 
         /* */
         src += src_pitch * hblock;
@@ -516,9 +623,16 @@ SSE_InterleavePlanes(uint8_t *dst, size_t dst_pitch,
                      cachev_width, hblock, bitshift);
 
         /* Copy from our cache to the destination */
-        SSE_InterleaveUV(dst, dst_pitch, cache, w16,
-                         cache + w16 * hblock, w16,
-                         copy_pitch, hblock, pixel_size);
+#ifdef CAN_COMPILE_AVX2
+        if (vlc_CPU_AVX2())
+            AVX2_InterleaveUV(dst, dst_pitch, cache, w16,
+                              cache + w16 * hblock, w16,
+                              copy_pitch, hblock, pixel_size);
+        else
+#endif
+            SSE_InterleaveUV(dst, dst_pitch, cache, w16,
+                             cache + w16 * hblock, w16,
+                             copy_pitch, hblock, pixel_size);
 
         /* */
         srcu += hblock * srcu_pitch;
@@ -613,6 +727,53 @@ static void SSE_Copy420_P_to_SP(picture_t *dst, const uint8_t *src[static 3],
 #undef COPY64
 #endif /* CAN_COMPILE_SSE2 */
 
+#ifdef __ARM_NEON
+static void NEON_InterleaveUV(uint8_t *dst, size_t dst_pitch,
+                              const uint8_t *srcu, size_t srcu_pitch,
+                              const uint8_t *srcv, size_t srcv_pitch,
+                              unsigned width, unsigned height)
+{
+    for (unsigned y = 0; y < height; y++) {
+        unsigned x = 0;
+
+        for (; x + 15 < width; x += 16) {
+            uint8x16x2_t uv = { { vld1q_u8(&srcu[x]), vld1q_u8(&srcv[x]) } };
+            vst2q_u8(&dst[2*x], uv);
+        }
+        for (; x < width; x++) {
+            dst[2*x+0] = srcu[x];
+            dst[2*x+1] = srcv[x];
+        }
+        srcu += srcu_pitch;
+        srcv += srcv_pitch;
+        dst += dst_pitch;
+    }
+}
+
+static void NEON_SplitUV(uint8_t *dstu, size_t dstu_pitch,
+                         uint8_t *dstv, size_t dstv_pitch,
+                         const uint8_t *src, size_t src_pitch,
+                         unsigned width, unsigned height)
+{
+    for (unsigned y = 0; y < height; y++) {
+        unsigned x = 0;
+
+        for (; x + 15 < width; x += 16) {
+            uint8x16x2_t uv = vld2q_u8(&src[2*x]);
+            vst1q_u8(&dstu[x], uv.val[0]);
+            vst1q_u8(&dstv[x], uv.val[1]);
+        }
+        for (; x < width; x++) {
+            dstu[x] = src[2*x+0];
+            dstv[x] = src[2*x+1];
+        }
+        src  += src_pitch;
+        dstu += dstu_pitch;
+        dstv += dstv_pitch;
+    }
+}
+#endif /* __ARM_NEON */
+
 static void CopyPlane(uint8_t *dst, size_t dst_pitch,
                       const uint8_t *src, size_t src_pitch,
                       unsigned height, int bitshift)
@@ -754,6 +915,17 @@ void Copy420_SP_to_P(picture_t *dst, const uint8_t *src[static 2],
 
     CopyPlane(dst->p[0].p_pixels, dst->p[0].i_pitch,
               src[0], src_pitch[0], height, 0);
+#ifdef __ARM_NEON
+    if (vlc_CPU_ARM_NEON())
+    {
+        size_t copy_pitch = __MIN(__MIN(src_pitch[1] / 2,
+                                        (size_t)dst->p[1].i_pitch),
+                                  (size_t)dst->p[2].i_pitch);
+        return NEON_SplitUV(dst->p[1].p_pixels, dst->p[1].i_pitch,
+                            dst->p[2].p_pixels, dst->p[2].i_pitch,
+                            src[1], src_pitch[1], copy_pitch, (height+1)/2);
+    }
+#endif
     SplitPlanes(dst->p[1].p_pixels, dst->p[1].i_pitch,
                 dst->p[2].p_pixels, dst->p[2].i_pitch,
                 src[1], src_pitch[1], (height+1)/2);
@@ -836,6 +1008,14 @@ void Copy420_P_to_SP(picture_t *dst, const uint8_t *src[static 3],
     if (copy_pitch > (size_t)dst->p[1].i_pitch / 2)
         copy_pitch = dst->p[1].i_pitch / 2;
 
+#ifdef __ARM_NEON
+    if (vlc_CPU_ARM_NEON())
+        return NEON_InterleaveUV(dst->p[1].p_pixels, dst->p[1].i_pitch,
+                                 src[U_PLANE], src_pitch[U_PLANE],
+                                 src[V_PLANE], src_pitch[V_PLANE],
+                                 copy_pitch, copy_lines);
+#endif
+
     const int i_extra_pitch_uv = dst->p[1].i_pitch - 2 * copy_pitch;
     const int i_extra_pitch_u  = src_pitch[U_PLANE] - copy_pitch;
     const int i_extra_pitch_v  = src_pitch[V_PLANE] - copy_pitch;
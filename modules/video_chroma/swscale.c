@@ -57,6 +57,10 @@ static void CloseScaler( vlc_object_t * );
 #define SCALEMODE_TEXT N_("Scaling mode")
 #define SCALEMODE_LONGTEXT N_("Scaling mode to use.")
 
+#define SCALETHREADS_TEXT N_("Scaling threads")
+#define SCALETHREADS_LONGTEXT N_("Number of threads used for scaling. " \
+    "0 means automatic (one per CPU core, capped).")
+
 static const int pi_mode_values[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
 static const char *const ppsz_mode_descriptions[] =
 { N_("Fast bilinear"), N_("Bilinear"), N_("Bicubic (good quality)"),
@@ -73,6 +77,8 @@ vlc_module_begin ()
     set_callbacks( OpenScaler, CloseScaler )
     add_integer( "swscale-mode", 2, SCALEMODE_TEXT, SCALEMODE_LONGTEXT, true )
         change_integer_list( pi_mode_values, ppsz_mode_descriptions )
+    add_integer( "swscale-threads", 0, SCALETHREADS_TEXT, SCALETHREADS_LONGTEXT, true )
+        change_integer_range( 0, 8 )
 vlc_module_end ()
 
 /* Version checking */
@@ -81,6 +87,20 @@ vlc_module_end ()
  * Local prototypes
  ****************************************************************************/
 
+#define SCALE_MAX_THREADS 8
+
+/* sws_scale() is single-threaded; each worker owns a private context and
+ * scales one horizontal band of the picture. Band edges are aligned on the
+ * chroma grid, so each band is a self-contained scale job. */
+struct scale_worker
+{
+    filter_t *p_owner;
+    struct SwsContext *ctx;
+    vlc_thread_t thread;
+    unsigned i_src_y, i_src_h;
+    unsigned i_dst_y, i_dst_h;
+};
+
 /**
  * Internal swscale filter structure.
  */
@@ -105,11 +125,26 @@ typedef struct
     bool b_copy;
     bool b_swap_uvi;
     bool b_swap_uvo;
+
+    /* Slice-parallel scaling */
+    unsigned i_threads;
+    bool b_sliced;
+    struct scale_worker workers[SCALE_MAX_THREADS];
+    vlc_mutex_t job_lock;
+    vlc_cond_t job_wait;
+    vlc_cond_t job_done;
+    unsigned i_job_seq;
+    unsigned i_job_pending;
+    bool b_job_exit;
+    picture_t *p_job_src;
+    picture_t *p_job_dst;
+    int i_job_planes;
 } filter_sys_t;
 
 static picture_t *Filter( filter_t *, picture_t * );
 static int  Init( filter_t * );
 static void Clean( filter_t * );
+static void *ScaleWorkerThread( void * );
 
 typedef struct
 {
@@ -129,6 +164,7 @@ static int GetParameters( ScalerConfiguration *,
                           int i_sws_flags_default );
 
 static int GetSwsCpuMask(void);
+static void SliceSetup( filter_t *, const ScalerConfiguration * );
 
 /* SwScaler point resize quality seems really bad, let our scale module do it
  * (change it to true to try) */
@@ -183,11 +219,32 @@ static int OpenScaler( vlc_object_t *p_this )
     memset( &p_sys->fmt_in,  0, sizeof(p_sys->fmt_in) );
     memset( &p_sys->fmt_out, 0, sizeof(p_sys->fmt_out) );
 
+    /* Slice workers */
+    vlc_mutex_init( &p_sys->job_lock );
+    vlc_cond_init( &p_sys->job_wait );
+    vlc_cond_init( &p_sys->job_done );
+
+    int i_threads = var_InheritInteger( p_filter, "swscale-threads" );
+    if( i_threads <= 0 )
+        i_threads = vlc_GetCPUCount();
+    if( i_threads > SCALE_MAX_THREADS )
+        i_threads = SCALE_MAX_THREADS;
+    if( i_threads > 1 )
+    {
+        for( int i = 0; i < i_threads; i++ )
+        {
+            struct scale_worker *w = &p_sys->workers[p_sys->i_threads];
+            w->p_owner = p_filter;
+            if( vlc_clone( &w->thread, ScaleWorkerThread, w,
+                           VLC_THREAD_PRIORITY_VIDEO ) )
+                break;
+            p_sys->i_threads++;
+        }
+    }
+
     if( Init( p_filter ) )
     {
-        if( p_sys->p_filter )
-            sws_freeFilter( p_sys->p_filter );
-        free( p_sys );
+        CloseScaler( p_this );
         return VLC_EGENERIC;
     }
 
@@ -214,6 +271,16 @@ static void CloseScaler( vlc_object_t *p_this )
     filter_t *p_filter = (filter_t*)p_this;
     filter_sys_t *p_sys = p_filter->p_sys;
 
+    if( p_sys->i_threads > 0 )
+    {
+        vlc_mutex_lock( &p_sys->job_lock );
+        p_sys->b_job_exit = true;
+        vlc_cond_broadcast( &p_sys->job_wait );
+        vlc_mutex_unlock( &p_sys->job_lock );
+        for( unsigned i = 0; i < p_sys->i_threads; i++ )
+            vlc_join( p_sys->workers[i].thread, NULL );
+    }
+
     Clean( p_filter );
     if( p_sys->p_filter )
         sws_freeFilter( p_sys->p_filter );
@@ -457,6 +524,8 @@ static int Init( filter_t *p_filter )
         p_fmto->i_sar_den = i_sar_den;
     }
 
+    SliceSetup( p_filter, &cfg );
+
     p_sys->b_add_a = cfg.b_add_a;
     p_sys->b_copy = cfg.b_copy;
     p_sys->fmt_in  = *p_fmti;
@@ -487,6 +556,14 @@ static void Clean( filter_t *p_filter )
     if( p_sys->ctx )
         sws_freeContext( p_sys->ctx );
 
+    for( unsigned i = 0; i < p_sys->i_threads; i++ )
+    {
+        if( p_sys->workers[i].ctx )
+            sws_freeContext( p_sys->workers[i].ctx );
+        p_sys->workers[i].ctx = NULL;
+    }
+    p_sys->b_sliced = false;
+
     /* We have to set it to null has we call be called again :( */
     p_sys->ctx = NULL;
     p_sys->ctxA = NULL;
@@ -620,6 +697,153 @@ static void Convert( filter_t *p_filter, struct SwsContext *ctx,
 #endif
 }
 
+/*****************************************************************************
+ * Slice-parallel scaling
+ *****************************************************************************/
+static void SliceSetup( filter_t *p_filter, const ScalerConfiguration *p_cfg )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    const video_format_t *p_fmti = &p_filter->fmt_in.video;
+    const video_format_t *p_fmto = &p_filter->fmt_out.video;
+
+    p_sys->b_sliced = false;
+    if( p_sys->i_threads < 2 || p_cfg->b_copy || p_sys->i_extend_factor != 1 ||
+        p_fmti->i_chroma == VLC_CODEC_RGBP )
+        return;
+
+    const unsigned i_src_h = p_fmti->i_visible_height;
+    const unsigned i_dst_h = p_fmto->i_visible_height;
+    unsigned n = p_sys->i_threads;
+
+    /* Small pictures are not worth the dispatch overhead */
+    while( n > 1 && ( i_src_h / n < 64 || i_dst_h / n < 64 ) )
+        n--;
+    if( n < 2 )
+        return;
+
+    /* Band edges aligned on the chroma grid of both formats */
+    unsigned src_edge[SCALE_MAX_THREADS + 1];
+    unsigned dst_edge[SCALE_MAX_THREADS + 1];
+    for( unsigned i = 0; i < n; i++ )
+    {
+        dst_edge[i] = ( i_dst_h * i / n ) & ~15;
+        src_edge[i] = ( (uint64_t)i_src_h * dst_edge[i] / i_dst_h ) & ~15;
+    }
+    src_edge[n] = i_src_h;
+    dst_edge[n] = i_dst_h;
+
+    for( unsigned i = 0; i < n; i++ )
+    {
+        struct scale_worker *w = &p_sys->workers[i];
+
+        w->i_src_y = src_edge[i];
+        w->i_src_h = src_edge[i + 1] - src_edge[i];
+        w->i_dst_y = dst_edge[i];
+        w->i_dst_h = dst_edge[i + 1] - dst_edge[i];
+        if( w->i_src_h == 0 || w->i_dst_h == 0 )
+            return;
+
+        w->ctx = sws_getContext( p_fmti->i_visible_width, w->i_src_h,
+                                 p_cfg->i_fmti,
+                                 p_fmto->i_visible_width, w->i_dst_h,
+                                 p_cfg->i_fmto,
+                                 p_cfg->i_sws_flags | p_sys->i_cpu_mask,
+                                 p_sys->p_filter, NULL, 0 );
+        if( w->ctx == NULL )
+            return; /* Clean() will free the bands already created */
+    }
+
+    msg_Dbg( p_filter, "scaling with %u slice threads", n );
+    p_sys->b_sliced = true;
+}
+
+static void ConvertSlice( filter_t *p_filter, struct scale_worker *w )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    uint8_t *src[4], *dst[4];
+    const uint8_t *csrc[4];
+    int src_stride[4], dst_stride[4];
+
+    GetPixels( src, src_stride, p_sys->desc_in, &p_filter->fmt_in.video,
+               p_sys->p_job_src, p_sys->i_job_planes, p_sys->b_swap_uvi );
+    GetPixels( dst, dst_stride, p_sys->desc_out, &p_filter->fmt_out.video,
+               p_sys->p_job_dst, p_sys->i_job_planes, p_sys->b_swap_uvo );
+
+    for( unsigned i = 0; i < 4 && src[i] != NULL; i++ )
+    {
+        const vlc_chroma_description_t *d = p_sys->desc_in;
+        unsigned num = i < d->plane_count ? d->p[i].h.num : 1;
+        unsigned den = i < d->plane_count ? d->p[i].h.den : 1;
+        src[i] += (size_t)( w->i_src_y * num / den ) * src_stride[i];
+    }
+    for( unsigned i = 0; i < 4 && dst[i] != NULL; i++ )
+    {
+        const vlc_chroma_description_t *d = p_sys->desc_out;
+        unsigned num = i < d->plane_count ? d->p[i].h.num : 1;
+        unsigned den = i < d->plane_count ? d->p[i].h.den : 1;
+        dst[i] += (size_t)( w->i_dst_y * num / den ) * dst_stride[i];
+    }
+
+    for( size_t i = 0; i < ARRAY_SIZE(src); i++ )
+        csrc[i] = src[i];
+
+    sws_scale( w->ctx, csrc, src_stride, 0, w->i_src_h, dst, dst_stride );
+}
+
+static void *ScaleWorkerThread( void *opaque )
+{
+    struct scale_worker *w = opaque;
+    filter_t *p_filter = w->p_owner;
+    filter_sys_t *p_sys = p_filter->p_sys;
+    unsigned i_seq = 0;
+    int canc = vlc_savecancel();
+
+    vlc_mutex_lock( &p_sys->job_lock );
+    for( ;; )
+    {
+        while( !p_sys->b_job_exit && p_sys->i_job_seq == i_seq )
+            vlc_cond_wait( &p_sys->job_wait, &p_sys->job_lock );
+        if( p_sys->b_job_exit )
+            break;
+        i_seq = p_sys->i_job_seq;
+        if( w->ctx == NULL )
+            continue; /* not part of the current band layout */
+        vlc_mutex_unlock( &p_sys->job_lock );
+
+        ConvertSlice( p_filter, w );
+
+        vlc_mutex_lock( &p_sys->job_lock );
+        if( --p_sys->i_job_pending == 0 )
+            vlc_cond_signal( &p_sys->job_done );
+    }
+    vlc_mutex_unlock( &p_sys->job_lock );
+
+    vlc_restorecancel( canc );
+    return NULL;
+}
+
+static void ConvertSliced( filter_t *p_filter, picture_t *p_dst,
+                           picture_t *p_src, int i_plane_count )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    unsigned i_bands = 0;
+
+    for( unsigned i = 0; i < p_sys->i_threads; i++ )
+        if( p_sys->workers[i].ctx != NULL )
+            i_bands++;
+
+    vlc_mutex_lock( &p_sys->job_lock );
+    p_sys->p_job_src = p_src;
+    p_sys->p_job_dst = p_dst;
+    p_sys->i_job_planes = i_plane_count;
+    p_sys->i_job_pending = i_bands;
+    p_sys->i_job_seq++;
+    vlc_cond_broadcast( &p_sys->job_wait );
+    while( p_sys->i_job_pending > 0 )
+        vlc_cond_wait( &p_sys->job_done, &p_sys->job_lock );
+    vlc_mutex_unlock( &p_sys->job_lock );
+}
+
 /****************************************************************************
  * Filter: the whole thing
  ****************************************************************************
@@ -667,8 +891,11 @@ static picture_t *Filter( filter_t *p_filter, picture_t *p_pic )
         /* Even if alpha is unused, swscale expects the pointer to be set */
         const int n_planes = !p_sys->ctxA && (p_src->i_planes == 4 ||
                              p_dst->i_planes == 4) ? 4 : 3;
-        Convert( p_filter, p_sys->ctx, p_dst, p_src, p_fmti->i_visible_height,
-                 n_planes, p_sys->b_swap_uvi, p_sys->b_swap_uvo );
+        if( p_sys->b_sliced )
+            ConvertSliced( p_filter, p_dst, p_src, n_planes );
+        else
+            Convert( p_filter, p_sys->ctx, p_dst, p_src, p_fmti->i_visible_height,
+                     n_planes, p_sys->b_swap_uvi, p_sys->b_swap_uvo );
     }
     if( p_sys->ctxA )
     {
@@ -31,8 +31,16 @@
 #include <vlc_plugin.h>
 #include <vlc_filter.h>
 #include <vlc_picture.h>
+#include <vlc_cpu.h>
 #include "filter_picture.h"
 
+#ifdef HAVE_SSE2_INTRINSICS
+# include <emmintrin.h>
+#endif
+#ifdef HAVE_AVX2_INTRINSICS
+# include <immintrin.h>
+#endif
+
 /*****************************************************************************
  * Module descriptor
  *****************************************************************************/
@@ -80,6 +88,18 @@ public:
     {
         return fmt;
     }
+    const picture_t *getPicture() const
+    {
+        return picture;
+    }
+    unsigned getX() const
+    {
+        return x;
+    }
+    unsigned getY() const
+    {
+        return y;
+    }
     bool isFull(unsigned) const
     {
         return true;
@@ -561,6 +581,171 @@ void Blend(const CPicture &dst_data, const CPicture &src_data,
 typedef void (*blend_function_t)(const CPicture &dst_data, const CPicture &src_data,
                                  unsigned width, unsigned height, int alpha);
 
+/*****************************************************************************
+ * Fast paths for 8-bit planar YUV destinations with a YUVA source
+ *****************************************************************************
+ * This is the combination used for rendered subtitles and OSD on software
+ * video output. The per-row luma kernel is vectorized; chroma is merged on
+ * the subsampling grid exactly like the generic template above.
+ *****************************************************************************/
+
+typedef void (*blend_row_t)(uint8_t *dst, const uint8_t *src,
+                            const uint8_t *srcA, unsigned width,
+                            unsigned alpha);
+
+static void BlendRow8C(uint8_t *dst, const uint8_t *src, const uint8_t *srcA,
+                       unsigned width, unsigned alpha)
+{
+    for (unsigned x = 0; x < width; x++) {
+        unsigned a = div255(alpha * srcA[x]);
+        if (a > 0)
+            merge(&dst[x], src[x], a);
+    }
+}
+
+#ifdef HAVE_SSE2_INTRINSICS
+__attribute__((__target__("sse2")))
+static inline __m128i Div255SSE2(__m128i v)
+{
+    /* Same rounding as div255() */
+    v = _mm_add_epi16(_mm_add_epi16(_mm_srli_epi16(v, 8), v),
+                      _mm_set1_epi16(1));
+    return _mm_srli_epi16(v, 8);
+}
+
+__attribute__((__target__("sse2")))
+static void BlendRow8SSE2(uint8_t *dst, const uint8_t *src,
+                          const uint8_t *srcA, unsigned width, unsigned alpha)
+{
+    const __m128i zero   = _mm_setzero_si128();
+    const __m128i v255   = _mm_set1_epi16(255);
+    const __m128i valpha = _mm_set1_epi16(alpha);
+    unsigned x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+        const __m128i s = _mm_loadu_si128((const __m128i *)&src[x]);
+        const __m128i a = _mm_loadu_si128((const __m128i *)&srcA[x]);
+        const __m128i d = _mm_loadu_si128((const __m128i *)&dst[x]);
+        __m128i r[2];
+
+        for (int h = 0; h < 2; h++) {
+            const __m128i s16 = h ? _mm_unpackhi_epi8(s, zero)
+                                  : _mm_unpacklo_epi8(s, zero);
+            const __m128i d16 = h ? _mm_unpackhi_epi8(d, zero)
+                                  : _mm_unpacklo_epi8(d, zero);
+            __m128i a16 = h ? _mm_unpackhi_epi8(a, zero)
+                            : _mm_unpacklo_epi8(a, zero);
+            a16 = Div255SSE2(_mm_mullo_epi16(a16, valpha));
+            r[h] = Div255SSE2(
+                _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(v255, a16), d16),
+                              _mm_mullo_epi16(s16, a16)));
+        }
+        _mm_storeu_si128((__m128i *)&dst[x], _mm_packus_epi16(r[0], r[1]));
+    }
+
+    if (x < width)
+        BlendRow8C(&dst[x], &src[x], &srcA[x], width - x, alpha);
+}
+#endif
+
+#ifdef HAVE_AVX2_INTRINSICS
+__attribute__((__target__("avx2")))
+static inline __m256i Div255AVX2(__m256i v)
+{
+    v = _mm256_add_epi16(_mm256_add_epi16(_mm256_srli_epi16(v, 8), v),
+                         _mm256_set1_epi16(1));
+    return _mm256_srli_epi16(v, 8);
+}
+
+__attribute__((__target__("avx2")))
+static void BlendRow8AVX2(uint8_t *dst, const uint8_t *src,
+                          const uint8_t *srcA, unsigned width, unsigned alpha)
+{
+    const __m256i zero   = _mm256_setzero_si256();
+    const __m256i v255   = _mm256_set1_epi16(255);
+    const __m256i valpha = _mm256_set1_epi16(alpha);
+    unsigned x = 0;
+
+    /* unpack/pack are both lane-local, so the pixel order is preserved */
+    for (; x + 32 <= width; x += 32) {
+        const __m256i s = _mm256_loadu_si256((const __m256i *)&src[x]);
+        const __m256i a = _mm256_loadu_si256((const __m256i *)&srcA[x]);
+        const __m256i d = _mm256_loadu_si256((const __m256i *)&dst[x]);
+        __m256i r[2];
+
+        for (int h = 0; h < 2; h++) {
+            const __m256i s16 = h ? _mm256_unpackhi_epi8(s, zero)
+                                  : _mm256_unpacklo_epi8(s, zero);
+            const __m256i d16 = h ? _mm256_unpackhi_epi8(d, zero)
+                                  : _mm256_unpacklo_epi8(d, zero);
+            __m256i a16 = h ? _mm256_unpackhi_epi8(a, zero)
+                            : _mm256_unpacklo_epi8(a, zero);
+            a16 = Div255AVX2(_mm256_mullo_epi16(a16, valpha));
+            r[h] = Div255AVX2(_mm256_add_epi16(
+                _mm256_mullo_epi16(_mm256_sub_epi16(v255, a16), d16),
+                _mm256_mullo_epi16(s16, a16)));
+        }
+        _mm256_storeu_si256((__m256i *)&dst[x],
+                            _mm256_packus_epi16(r[0], r[1]));
+    }
+
+    if (x < width)
+        BlendRow8C(&dst[x], &src[x], &srcA[x], width - x, alpha);
+}
+#endif
+
+static blend_row_t GetBlendRow8(void)
+{
+#ifdef HAVE_AVX2_INTRINSICS
+    if (vlc_CPU_AVX2())
+        return BlendRow8AVX2;
+#endif
+#ifdef HAVE_SSE2_INTRINSICS
+    if (vlc_CPU_SSE2())
+        return BlendRow8SSE2;
+#endif
+    return BlendRow8C;
+}
+
+template <unsigned rx, unsigned ry, bool swap_uv>
+static void BlendYUVAToPlanar8(const CPicture &dst_data,
+                               const CPicture &src_data,
+                               unsigned width, unsigned height, int alpha)
+{
+    const blend_row_t blend_row = GetBlendRow8();
+    const picture_t *dstp = dst_data.getPicture();
+    const picture_t *srcp = src_data.getPicture();
+    const unsigned dx = dst_data.getX(), dy0 = dst_data.getY();
+    const unsigned sx = src_data.getX(), sy0 = src_data.getY();
+    const unsigned up = swap_uv ? 2 : 1, vp = swap_uv ? 1 : 2;
+
+    for (unsigned y = 0; y < height; y++) {
+        const unsigned sy = sy0 + y, dy = dy0 + y;
+        const uint8_t *srcY = &srcp->p[0].p_pixels[sy * srcp->p[0].i_pitch + sx];
+        const uint8_t *srcA = &srcp->p[3].p_pixels[sy * srcp->p[3].i_pitch + sx];
+        uint8_t *dstY = &dstp->p[0].p_pixels[dy * dstp->p[0].i_pitch + dx];
+
+        blend_row(dstY, srcY, srcA, width, alpha);
+
+        /* Chroma, on the destination subsampling grid */
+        if ((dy % ry) != 0)
+            continue;
+        const uint8_t *srcU = &srcp->p[1].p_pixels[sy * srcp->p[1].i_pitch + sx];
+        const uint8_t *srcV = &srcp->p[2].p_pixels[sy * srcp->p[2].i_pitch + sx];
+        uint8_t *dstU = &dstp->p[up].p_pixels[(dy / ry) * dstp->p[up].i_pitch];
+        uint8_t *dstV = &dstp->p[vp].p_pixels[(dy / ry) * dstp->p[vp].i_pitch];
+        for (unsigned x = 0; x < width; x++) {
+            if (((dx + x) % rx) != 0)
+                continue;
+            unsigned a = div255(alpha * srcA[x]);
+            if (a <= 0)
+                continue;
+            merge(&dstU[(dx + x) / rx], srcU[x], a);
+            merge(&dstV[(dx + x) / rx], srcV[x], a);
+        }
+    }
+}
+
 namespace {
 
 static const struct {
@@ -635,6 +820,16 @@ static const struct {
 
 #undef RGB
 #undef YUV
+
+    /* Specialized YUVA blenders; the lookup in Open() keeps the last
+     * matching entry, so these override the generic ones above. */
+    { VLC_CODEC_I420, VLC_CODEC_YUVA, BlendYUVAToPlanar8<2, 2, false> },
+    { VLC_CODEC_J420, VLC_CODEC_YUVA, BlendYUVAToPlanar8<2, 2, false> },
+    { VLC_CODEC_YV12, VLC_CODEC_YUVA, BlendYUVAToPlanar8<2, 2, true>  },
+    { VLC_CODEC_I422, VLC_CODEC_YUVA, BlendYUVAToPlanar8<2, 1, false> },
+    { VLC_CODEC_J422, VLC_CODEC_YUVA, BlendYUVAToPlanar8<2, 1, false> },
+    { VLC_CODEC_I444, VLC_CODEC_YUVA, BlendYUVAToPlanar8<1, 1, false> },
+    { VLC_CODEC_J444, VLC_CODEC_YUVA, BlendYUVAToPlanar8<1, 1, false> },
 };
 
 struct filter_sys_t {
@@ -0,0 +1,361 @@
+/*****************************************************************************
+ * convbench.c : chroma conversion / deinterlace benchmark plugin for vlc
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Preamble
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_modules.h>
+
+#include <vlc_filter.h>
+#include <vlc_picture.h>
+
+/*****************************************************************************
+ * Local prototypes
+ *****************************************************************************/
+static int Create( vlc_object_t * );
+static void Destroy( vlc_object_t * );
+
+static picture_t *Filter( filter_t *, picture_t * );
+
+/*****************************************************************************
+ * Module descriptor
+ *****************************************************************************/
+
+#define LOOPS_TEXT N_("Number of frames per measurement")
+#define LOOPS_LONGTEXT N_("The number of synthetic frames each converter " \
+                          "or deinterlacer is run over")
+
+#define WIDTH_TEXT N_("Width of the synthetic frames")
+#define HEIGHT_TEXT N_("Height of the synthetic frames")
+
+#define CFG_PREFIX "convbench-"
+
+vlc_module_begin ()
+    set_description( N_("Chroma conversion and deinterlace benchmark filter") )
+    set_shortname( N_("Convbench" ))
+    set_category( CAT_VIDEO )
+    set_subcategory( SUBCAT_VIDEO_VFILTER )
+    set_capability( "video filter", 0 )
+
+    set_section( N_("Benchmarking"), NULL )
+    add_integer( CFG_PREFIX "loops", 100, LOOPS_TEXT,
+              LOOPS_LONGTEXT, false )
+    add_integer_with_range( CFG_PREFIX "width", 1920, 16, 8192, WIDTH_TEXT,
+              WIDTH_TEXT, false )
+    add_integer_with_range( CFG_PREFIX "height", 1080, 16, 8192, HEIGHT_TEXT,
+              HEIGHT_TEXT, false )
+
+    set_callbacks( Create, Destroy )
+vlc_module_end ()
+
+static const char *const ppsz_filter_options[] = {
+    "loops", "width", "height", NULL
+};
+
+/*****************************************************************************
+ * filter_sys_t: filter method descriptor
+ *****************************************************************************/
+typedef struct
+{
+    bool b_done;
+    int i_loops;
+    int i_width, i_height;
+} filter_sys_t;
+
+/** Source/destination chromas tried for the converter benchmark.
+    Pairs for which no "video converter" module loads are skipped. */
+static const vlc_fourcc_t chroma_src_list[] = {
+    VLC_CODEC_I420, VLC_CODEC_NV12, VLC_CODEC_I422,
+};
+static const vlc_fourcc_t chroma_dst_list[] = {
+    VLC_CODEC_I420, VLC_CODEC_NV12, VLC_CODEC_I422, VLC_CODEC_YUYV,
+    VLC_CODEC_UYVY, VLC_CODEC_RGB32, VLC_CODEC_RGB24,
+};
+
+/** Deinterlace modes benchmarked, see the deinterlace module's mode_list. */
+static const char *const deint_mode_list[] = {
+    "discard", "blend", "mean", "bob", "linear", "x", "yadif", "yadif2x",
+};
+
+/*****************************************************************************
+ * Helpers
+ *****************************************************************************/
+
+/** Allocates a synthetic picture filled with a deterministic gradient. */
+static picture_t *BenchNewPicture( vlc_fourcc_t i_chroma, int i_width,
+                                   int i_height, bool b_interlaced )
+{
+    video_format_t fmt;
+    video_format_Init( &fmt, i_chroma );
+    video_format_Setup( &fmt, i_chroma, i_width, i_height,
+                        i_width, i_height, 1, 1 );
+    picture_t *p_pic = picture_NewFromFormat( &fmt );
+    video_format_Clean( &fmt );
+    if( p_pic == NULL )
+        return NULL;
+
+    for( int i = 0; i < p_pic->i_planes; i++ )
+    {
+        const plane_t *p = &p_pic->p[i];
+        for( int y = 0; y < p->i_lines; y++ )
+            for( int x = 0; x < p->i_pitch; x++ )
+                p->p_pixels[y * p->i_pitch + x] = (x + 3 * y + 17 * i) & 0xff;
+    }
+
+    p_pic->b_progressive = !b_interlaced;
+    p_pic->b_top_field_first = true;
+    p_pic->i_nb_fields = 2;
+    return p_pic;
+}
+
+/** Sum of the visible plane sizes, in bytes. */
+static size_t BenchPictureSize( const picture_t *p_pic )
+{
+    size_t i_size = 0;
+    for( int i = 0; i < p_pic->i_planes; i++ )
+        i_size += (size_t)p_pic->p[i].i_visible_pitch *
+                  p_pic->p[i].i_visible_lines;
+    return i_size;
+}
+
+static void BenchReport( filter_t *p_filter, const char *psz_what,
+                         vlc_tick_t i_duration, int i_loops,
+                         size_t i_frame_bytes, size_t i_frame_pixels )
+{
+    if( i_duration <= 0 )
+        i_duration = 1;
+    const double f_secs = secf_from_vlc_tick( i_duration );
+    msg_Info( p_filter, "%s: %d frames in %.3f sec, %.1f MB/s, %.3f ns/pixel",
+              psz_what, i_loops, f_secs,
+              (double)i_frame_bytes * i_loops / f_secs / 1e6,
+              f_secs * 1e9 / ((double)i_frame_pixels * i_loops) );
+}
+
+static void BenchReleaseChain( picture_t *p_pic )
+{
+    while( p_pic != NULL )
+    {
+        picture_t *p_next = p_pic->p_next;
+        picture_Release( p_pic );
+        p_pic = p_next;
+    }
+}
+
+/*****************************************************************************
+ * Converter benchmark
+ *****************************************************************************/
+
+static void BenchConverter( filter_t *p_filter, vlc_fourcc_t i_src,
+                            vlc_fourcc_t i_dst )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+
+    filter_t *p_conv = vlc_object_create( p_filter, sizeof(filter_t) );
+    if( p_conv == NULL )
+        return;
+
+    es_format_Init( &p_conv->fmt_in, VIDEO_ES, i_src );
+    video_format_Setup( &p_conv->fmt_in.video, i_src,
+                        p_sys->i_width, p_sys->i_height,
+                        p_sys->i_width, p_sys->i_height, 1, 1 );
+    es_format_Init( &p_conv->fmt_out, VIDEO_ES, i_dst );
+    video_format_Setup( &p_conv->fmt_out.video, i_dst,
+                        p_sys->i_width, p_sys->i_height,
+                        p_sys->i_width, p_sys->i_height, 1, 1 );
+    p_conv->b_allow_fmt_out_change = false;
+
+    p_conv->p_module = module_need( p_conv, "video converter", NULL, false );
+    if( p_conv->p_module == NULL )
+        goto out;
+
+    picture_t *p_src = BenchNewPicture( i_src, p_sys->i_width,
+                                        p_sys->i_height, false );
+    if( p_src == NULL )
+    {
+        module_unneed( p_conv, p_conv->p_module );
+        goto out;
+    }
+
+    const size_t i_bytes = BenchPictureSize( p_src );
+    const size_t i_pixels = (size_t)p_sys->i_width * p_sys->i_height;
+
+    vlc_tick_t time = vlc_tick_now();
+    for( int i = 0; i < p_sys->i_loops; i++ )
+        BenchReleaseChain( p_conv->pf_video_filter( p_conv,
+                                                    picture_Hold( p_src ) ) );
+    time = vlc_tick_now() - time;
+
+    char psz_what[64];
+    snprintf( psz_what, sizeof (psz_what), "convert %4.4s -> %4.4s (%s)",
+              (const char *)&i_src, (const char *)&i_dst,
+              module_get_name( p_conv->p_module, false ) );
+    BenchReport( p_filter, psz_what, time, p_sys->i_loops, i_bytes, i_pixels );
+
+    picture_Release( p_src );
+    module_unneed( p_conv, p_conv->p_module );
+out:
+    es_format_Clean( &p_conv->fmt_in );
+    es_format_Clean( &p_conv->fmt_out );
+    vlc_object_delete( p_conv );
+}
+
+/*****************************************************************************
+ * Deinterlacer benchmark
+ *****************************************************************************/
+
+static void BenchDeinterlacer( filter_t *p_filter, const char *psz_mode )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+
+    filter_t *p_deint = vlc_object_create( p_filter, sizeof(filter_t) );
+    if( p_deint == NULL )
+        return;
+
+    es_format_Init( &p_deint->fmt_in, VIDEO_ES, VLC_CODEC_I420 );
+    video_format_Setup( &p_deint->fmt_in.video, VLC_CODEC_I420,
+                        p_sys->i_width, p_sys->i_height,
+                        p_sys->i_width, p_sys->i_height, 1, 1 );
+    p_deint->fmt_in.video.i_frame_rate = 25;
+    p_deint->fmt_in.video.i_frame_rate_base = 1;
+    es_format_Copy( &p_deint->fmt_out, &p_deint->fmt_in );
+    p_deint->b_allow_fmt_out_change = true;
+
+    var_Create( p_deint, "sout-deinterlace-mode", VLC_VAR_STRING );
+    var_SetString( p_deint, "sout-deinterlace-mode", psz_mode );
+
+    p_deint->p_module = module_need( p_deint, "video filter", "deinterlace",
+                                     true );
+    if( p_deint->p_module == NULL )
+        goto out;
+
+    /* Temporal algorithms keep a frame history: cycle over a few source
+       pictures with increasing dates so framerate doublers behave */
+    picture_t *p_srcs[3];
+    for( int i = 0; i < 3; i++ )
+    {
+        p_srcs[i] = BenchNewPicture( VLC_CODEC_I420, p_sys->i_width,
+                                     p_sys->i_height, true );
+        if( p_srcs[i] == NULL )
+        {
+            while( i > 0 )
+                picture_Release( p_srcs[--i] );
+            module_unneed( p_deint, p_deint->p_module );
+            goto out;
+        }
+    }
+
+    const size_t i_bytes = BenchPictureSize( p_srcs[0] );
+    const size_t i_pixels = (size_t)p_sys->i_width * p_sys->i_height;
+
+    vlc_tick_t time = vlc_tick_now();
+    for( int i = 0; i < p_sys->i_loops; i++ )
+    {
+        picture_t *p_src = p_srcs[i % 3];
+        p_src->date = VLC_TICK_0 + VLC_TICK_FROM_MS( 40 * i );
+        BenchReleaseChain( p_deint->pf_video_filter( p_deint,
+                                                     picture_Hold( p_src ) ) );
+    }
+    time = vlc_tick_now() - time;
+
+    char psz_what[64];
+    snprintf( psz_what, sizeof (psz_what), "deinterlace %s", psz_mode );
+    BenchReport( p_filter, psz_what, time, p_sys->i_loops, i_bytes, i_pixels );
+
+    for( int i = 0; i < 3; i++ )
+        picture_Release( p_srcs[i] );
+    module_unneed( p_deint, p_deint->p_module );
+out:
+    es_format_Clean( &p_deint->fmt_in );
+    es_format_Clean( &p_deint->fmt_out );
+    vlc_object_delete( p_deint );
+}
+
+/*****************************************************************************
+ * Create: allocates video thread output method
+ *****************************************************************************/
+static int Create( vlc_object_t *p_this )
+{
+    filter_t *p_filter = (filter_t *)p_this;
+    filter_sys_t *p_sys;
+
+    /* Allocate structure */
+    p_filter->p_sys = p_sys = malloc( sizeof( filter_sys_t ) );
+    if( p_sys == NULL )
+        return VLC_ENOMEM;
+
+    p_sys->b_done = false;
+
+    p_filter->pf_video_filter = Filter;
+
+    config_ChainParse( p_filter, CFG_PREFIX, ppsz_filter_options,
+                       p_filter->p_cfg );
+
+    p_sys->i_loops = var_CreateGetIntegerCommand( p_filter,
+                                                  CFG_PREFIX "loops" );
+    p_sys->i_width = var_CreateGetIntegerCommand( p_filter,
+                                                  CFG_PREFIX "width" );
+    p_sys->i_height = var_CreateGetIntegerCommand( p_filter,
+                                                   CFG_PREFIX "height" );
+    return VLC_SUCCESS;
+}
+
+/*****************************************************************************
+ * Destroy: destroy video thread output method
+ *****************************************************************************/
+static void Destroy( vlc_object_t *p_this )
+{
+    filter_t *p_filter = (filter_t *)p_this;
+
+    free( p_filter->p_sys );
+}
+
+/*****************************************************************************
+ * Filter: runs all the measurements once, then passes pictures through
+ *****************************************************************************/
+static picture_t *Filter( filter_t *p_filter, picture_t *p_pic )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+
+    if( p_sys->b_done )
+        return p_pic;
+
+    msg_Info( p_filter, "benchmarking converters on %dx%d frames",
+              p_sys->i_width, p_sys->i_height );
+    for( size_t i = 0; i < ARRAY_SIZE(chroma_src_list); i++ )
+        for( size_t j = 0; j < ARRAY_SIZE(chroma_dst_list); j++ )
+            if( chroma_src_list[i] != chroma_dst_list[j] )
+                BenchConverter( p_filter, chroma_src_list[i],
+                                chroma_dst_list[j] );
+
+    msg_Info( p_filter, "benchmarking deinterlacers on %dx%d frames",
+              p_sys->i_width, p_sys->i_height );
+    for( size_t i = 0; i < ARRAY_SIZE(deint_mode_list); i++ )
+        BenchDeinterlacer( p_filter, deint_mode_list[i] );
+
+    p_sys->b_done = true;
+    return p_pic;
+}
@@ -511,13 +511,23 @@ static inline void XDeintBand8x8MMXEXT( uint8_t *dst, int i_dst,
  * Public functions
  *****************************************************************************/
 
-int RenderX( filter_t *p_filter, picture_t *p_outpic, picture_t *p_pic )
+/** Job context for banded X rendering, see XDeintBands(). */
+struct xdeint_job
+{
+    picture_t *p_outpic, *p_pic;
+    bool mmxext;
+};
+
+/**
+ * Renders one horizontal band of every plane. Each 8-line block row is
+ * independent of the others, so the block rows can run concurrently.
+ */
+static void XDeintBands( void *p_data, unsigned i_band, unsigned i_bands )
 {
-    VLC_UNUSED(p_filter);
+    const struct xdeint_job *job = p_data;
+    picture_t *p_outpic = job->p_outpic;
+    picture_t *p_pic = job->p_pic;
     int i_plane;
-#if defined (CAN_COMPILE_MMXEXT)
-    const bool mmxext = vlc_CPU_MMXEXT();
-#endif
 
     /* Copy image and skip lines */
     for( i_plane = 0 ; i_plane < p_pic->i_planes ; i_plane++ )
@@ -531,15 +541,18 @@ int RenderX( filter_t *p_filter, picture_t *p_outpic, picture_t *p_pic )
         const int i_dst = p_outpic->p[i_plane].i_pitch;
         const int i_src = p_pic->p[i_plane].i_pitch;
 
+        const int y_start = i_mby * i_band / i_bands;
+        const int y_end   = i_mby * (i_band + 1) / i_bands;
+
         int y, x;
 
-        for( y = 0; y < i_mby; y++ )
+        for( y = y_start; y < y_end; y++ )
         {
             uint8_t *dst = &p_outpic->p[i_plane].p_pixels[8*y*i_dst];
             uint8_t *src = &p_pic->p[i_plane].p_pixels[8*y*i_src];
 
 #ifdef CAN_COMPILE_MMXEXT
-            if( mmxext )
+            if( job->mmxext )
                 XDeintBand8x8MMXEXT( dst, i_dst, src, i_src, i_mbx, i_modx );
             else
 #endif
@@ -547,8 +560,9 @@ int RenderX( filter_t *p_filter, picture_t *p_outpic, picture_t *p_pic )
         }
 
         /* Last line (C only)*/
-        if( i_mody )
+        if( i_mody && i_band == i_bands - 1 )
         {
+            y = i_mby;
             uint8_t *dst = &p_outpic->p[i_plane].p_pixels[8*y*i_dst];
             uint8_t *src = &p_pic->p[i_plane].p_pixels[8*y*i_src];
 
@@ -566,8 +580,25 @@ int RenderX( filter_t *p_filter, picture_t *p_outpic, picture_t *p_pic )
     }
 
 #ifdef CAN_COMPILE_MMXEXT
-    if( mmxext )
+    /* The MMX state is per-thread */
+    if( job->mmxext )
         emms();
 #endif
+}
+
+int RenderX( filter_t *p_filter, picture_t *p_outpic, picture_t *p_pic )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    struct xdeint_job job = {
+        .p_outpic = p_outpic,
+        .p_pic = p_pic,
+#if defined (CAN_COMPILE_MMXEXT)
+        .mmxext = vlc_CPU_MMXEXT(),
+#else
+        .mmxext = false,
+#endif
+    };
+
+    DeinterlacePoolRun( &p_sys->pool, XDeintBands, &job );
     return VLC_SUCCESS;
 }
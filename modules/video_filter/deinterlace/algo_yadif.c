@@ -51,6 +51,79 @@ int RenderYadifSingle( filter_t *p_filter, picture_t *p_dst, picture_t *p_src )
     return RenderYadif( p_filter, p_dst, p_src, 0, 0 );
 }
 
+/** Job context for banded Yadif rendering, see YadifRenderBand(). */
+struct yadif_job
+{
+    void (*pf_line)(uint8_t *dst, uint8_t *prev, uint8_t *cur, uint8_t *next,
+                    int w, int prefs, int mrefs, int parity, int mode);
+    picture_t *p_dst;
+    picture_t *p_prev, *p_cur, *p_next;
+    int i_field;
+    int yadif_parity;
+};
+
+/**
+ * Renders one horizontal band of every plane. Output rows are independent
+ * in Yadif, so the bands can run concurrently; the first/last line
+ * duplication is handled by the band owning line 1 (resp. the second to
+ * last line).
+ */
+static void YadifRenderBand( void *p_data, unsigned i_band, unsigned i_bands )
+{
+    const struct yadif_job *job = p_data;
+
+    for( int n = 0; n < job->p_dst->i_planes; n++ )
+    {
+        const plane_t *prevp = &job->p_prev->p[n];
+        const plane_t *curp  = &job->p_cur->p[n];
+        const plane_t *nextp = &job->p_next->p[n];
+        plane_t *dstp        = &job->p_dst->p[n];
+
+        /* Interior lines [1, i_visible_lines - 1) split into bands */
+        const int i_lines = dstp->i_visible_lines - 2;
+        if( i_lines <= 0 )
+            continue;
+        const int y_start = 1 + i_lines * i_band / i_bands;
+        const int y_end   = 1 + i_lines * (i_band + 1) / i_bands;
+
+        for( int y = y_start; y < y_end; y++ )
+        {
+            if( (y % 2) == job->i_field  ||  job->yadif_parity == 2 )
+            {
+                memcpy( &dstp->p_pixels[y * dstp->i_pitch],
+                            &curp->p_pixels[y * curp->i_pitch], dstp->i_visible_pitch );
+            }
+            else
+            {
+                int mode;
+                /* Spatial checks only when enough data */
+                mode = (y >= 2 && y < dstp->i_visible_lines - 2) ? 0 : 2;
+
+                assert( prevp->i_pitch == curp->i_pitch && curp->i_pitch == nextp->i_pitch );
+                job->pf_line( &dstp->p_pixels[y * dstp->i_pitch],
+                              &prevp->p_pixels[y * prevp->i_pitch],
+                              &curp->p_pixels[y * curp->i_pitch],
+                              &nextp->p_pixels[y * nextp->i_pitch],
+                              dstp->i_visible_pitch,
+                              y < dstp->i_visible_lines - 2  ? curp->i_pitch : -curp->i_pitch,
+                              y  - 1  ?  -curp->i_pitch : curp->i_pitch,
+                              job->yadif_parity,
+                              mode );
+            }
+
+            /* We duplicate the first and last lines */
+            if( y == 1 )
+                memcpy(&dstp->p_pixels[(y-1) * dstp->i_pitch],
+                           &dstp->p_pixels[ y    * dstp->i_pitch],
+                           dstp->i_pitch);
+            else if( y == dstp->i_visible_lines - 2 )
+                memcpy(&dstp->p_pixels[(y+1) * dstp->i_pitch],
+                           &dstp->p_pixels[ y    * dstp->i_pitch],
+                           dstp->i_pitch);
+        }
+    }
+}
+
 int RenderYadif( filter_t *p_filter, picture_t *p_dst, picture_t *p_src,
                  int i_order, int i_field )
 {
@@ -124,55 +197,25 @@ int RenderYadif( filter_t *p_filter, picture_t *p_dst, picture_t *p_src,
             filter = vlcpriv_yadif_filter_line_mmxext;
         else
 #endif
+#endif
+#if defined(__ARM_NEON)
+        if( vlc_CPU_ARM_NEON() )
+            filter = yadif_filter_line_neon;
+        else
 #endif
             filter = yadif_filter_line_c;
 
         if( p_sys->chroma->pixel_size == 2 )
             filter = yadif_filter_line_c_16bit;
 
-        for( int n = 0; n < p_dst->i_planes; n++ )
-        {
-            const plane_t *prevp = &p_prev->p[n];
-            const plane_t *curp  = &p_cur->p[n];
-            const plane_t *nextp = &p_next->p[n];
-            plane_t *dstp        = &p_dst->p[n];
-
-            for( int y = 1; y < dstp->i_visible_lines - 1; y++ )
-            {
-                if( (y % 2) == i_field  ||  yadif_parity == 2 )
-                {
-                    memcpy( &dstp->p_pixels[y * dstp->i_pitch],
-                                &curp->p_pixels[y * curp->i_pitch], dstp->i_visible_pitch );
-                }
-                else
-                {
-                    int mode;
-                    /* Spatial checks only when enough data */
-                    mode = (y >= 2 && y < dstp->i_visible_lines - 2) ? 0 : 2;
-
-                    assert( prevp->i_pitch == curp->i_pitch && curp->i_pitch == nextp->i_pitch );
-                    filter( &dstp->p_pixels[y * dstp->i_pitch],
-                            &prevp->p_pixels[y * prevp->i_pitch],
-                            &curp->p_pixels[y * curp->i_pitch],
-                            &nextp->p_pixels[y * nextp->i_pitch],
-                            dstp->i_visible_pitch,
-                            y < dstp->i_visible_lines - 2  ? curp->i_pitch : -curp->i_pitch,
-                            y  - 1  ?  -curp->i_pitch : curp->i_pitch,
-                            yadif_parity,
-                            mode );
-                }
-
-                /* We duplicate the first and last lines */
-                if( y == 1 )
-                    memcpy(&dstp->p_pixels[(y-1) * dstp->i_pitch],
-                               &dstp->p_pixels[ y    * dstp->i_pitch],
-                               dstp->i_pitch);
-                else if( y == dstp->i_visible_lines - 2 )
-                    memcpy(&dstp->p_pixels[(y+1) * dstp->i_pitch],
-                               &dstp->p_pixels[ y    * dstp->i_pitch],
-                               dstp->i_pitch);
-            }
-        }
+        struct yadif_job job = {
+            .pf_line = filter,
+            .p_dst = p_dst,
+            .p_prev = p_prev, .p_cur = p_cur, .p_next = p_next,
+            .i_field = i_field,
+            .yadif_parity = yadif_parity,
+        };
+        DeinterlacePoolRun( &p_sys->pool, YadifRenderBand, &job );
 
         p_sys->context.i_frame_offset = 1; /* p_cur will be rendered at next frame, too */
 
@@ -32,6 +32,117 @@
 
 #include "common.h"
 
+/*****************************************************************************
+ * Banded rendering pool
+ *****************************************************************************/
+
+static void *DeinterlacePoolThread( void *p_data )
+{
+    struct deinterlace_pool_worker *p_worker = p_data;
+    deinterlace_pool_t *p_pool = p_worker->p_pool;
+    unsigned i_seq = 0;
+    int canc = vlc_savecancel();
+
+    vlc_mutex_lock( &p_pool->lock );
+    for( ;; )
+    {
+        while( p_pool->i_seq == i_seq && !p_pool->b_exit )
+            vlc_cond_wait( &p_pool->wait, &p_pool->lock );
+        if( p_pool->b_exit )
+            break;
+        i_seq = p_pool->i_seq;
+
+        void (*pf_work)( void *, unsigned, unsigned ) = p_pool->pf_work;
+        void *p_ctx = p_pool->p_ctx;
+        vlc_mutex_unlock( &p_pool->lock );
+
+        /* Band 0 belongs to the caller thread */
+        pf_work( p_ctx, p_worker->i_index + 1, p_pool->i_threads + 1 );
+
+        vlc_mutex_lock( &p_pool->lock );
+        if( --p_pool->i_pending == 0 )
+            vlc_cond_signal( &p_pool->done );
+    }
+    vlc_mutex_unlock( &p_pool->lock );
+
+    vlc_restorecancel( canc );
+    return NULL;
+}
+
+void DeinterlacePoolStart( vlc_object_t *p_obj, deinterlace_pool_t *p_pool,
+                           unsigned i_threads )
+{
+    vlc_mutex_init( &p_pool->lock );
+    vlc_cond_init( &p_pool->wait );
+    vlc_cond_init( &p_pool->done );
+    p_pool->i_seq = 0;
+    p_pool->i_pending = 0;
+    p_pool->b_exit = false;
+    p_pool->i_threads = 0;
+
+    if( i_threads < 2 )
+        return;
+    if( i_threads > DEINTERLACE_POOL_MAX + 1 )
+        i_threads = DEINTERLACE_POOL_MAX + 1;
+
+    /* The caller thread renders band 0 itself */
+    for( unsigned i = 0; i < i_threads - 1; i++ )
+    {
+        struct deinterlace_pool_worker *p_worker = &p_pool->worker[i];
+        p_worker->p_pool = p_pool;
+        p_worker->i_index = i;
+        if( vlc_clone( &p_worker->thread, DeinterlacePoolThread, p_worker,
+                       VLC_THREAD_PRIORITY_VIDEO ) )
+            break;
+        p_pool->i_threads++;
+    }
+
+    if( p_pool->i_threads > 0 )
+        msg_Dbg( p_obj, "using %u threads for banded rendering",
+                 p_pool->i_threads + 1 );
+}
+
+void DeinterlacePoolStop( deinterlace_pool_t *p_pool )
+{
+    if( p_pool->i_threads == 0 )
+        return;
+
+    vlc_mutex_lock( &p_pool->lock );
+    p_pool->b_exit = true;
+    vlc_cond_broadcast( &p_pool->wait );
+    vlc_mutex_unlock( &p_pool->lock );
+
+    for( unsigned i = 0; i < p_pool->i_threads; i++ )
+        vlc_join( p_pool->worker[i].thread, NULL );
+    p_pool->i_threads = 0;
+}
+
+void DeinterlacePoolRun( deinterlace_pool_t *p_pool,
+                         void (*pf_work)( void *, unsigned, unsigned ),
+                         void *p_ctx )
+{
+    if( p_pool->i_threads == 0 )
+    {
+        pf_work( p_ctx, 0, 1 );
+        return;
+    }
+
+    vlc_mutex_lock( &p_pool->lock );
+    p_pool->pf_work = pf_work;
+    p_pool->p_ctx = p_ctx;
+    p_pool->i_pending = p_pool->i_threads;
+    p_pool->i_seq++;
+    vlc_cond_broadcast( &p_pool->wait );
+    vlc_mutex_unlock( &p_pool->lock );
+
+    pf_work( p_ctx, 0, p_pool->i_threads + 1 );
+
+    vlc_mutex_lock( &p_pool->lock );
+    while( p_pool->i_pending > 0 )
+        vlc_cond_wait( &p_pool->done, &p_pool->lock );
+    vlc_mutex_unlock( &p_pool->lock );
+}
+
 void InitDeinterlacingContext( struct deinterlace_ctx *p_context )
 {
     p_context->settings.b_double_rate = false;
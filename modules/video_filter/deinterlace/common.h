@@ -92,6 +92,57 @@ struct deinterlace_ctx
 
 #define DEINTERLACE_DST_SIZE 3
 
+/** Maximum number of extra worker threads for banded rendering. */
+#define DEINTERLACE_POOL_MAX 7
+
+/**
+ * Worker pool for algorithms whose output rows are independent
+ * (e.g. Yadif, X). The picture is split into horizontal bands, which
+ * the caller thread and the workers render concurrently.
+ */
+typedef struct deinterlace_pool
+{
+    unsigned    i_threads;  /**< Number of worker threads (0 = serial) */
+    vlc_mutex_t lock;
+    vlc_cond_t  wait;       /**< Signalled when a job is published */
+    vlc_cond_t  done;       /**< Signalled when a worker finishes a band */
+    unsigned    i_seq;      /**< Job sequence number */
+    unsigned    i_pending;  /**< Workers still busy on the current job */
+    bool        b_exit;
+    void      (*pf_work)( void *, unsigned i_band, unsigned i_bands );
+    void       *p_ctx;
+    struct deinterlace_pool_worker
+    {
+        struct deinterlace_pool *p_pool;
+        vlc_thread_t thread;
+        unsigned     i_index;
+    } worker[DEINTERLACE_POOL_MAX];
+} deinterlace_pool_t;
+
+/**
+ * @brief Start the banded rendering pool.
+ * @param i_threads Total wanted concurrency, including the caller thread.
+ *                  1 (or less) keeps rendering serial.
+ */
+void DeinterlacePoolStart( vlc_object_t *, deinterlace_pool_t *,
+                           unsigned i_threads );
+
+/**
+ * @brief Stop the banded rendering pool and join the workers.
+ */
+void DeinterlacePoolStop( deinterlace_pool_t * );
+
+/**
+ * @brief Render all bands of a picture, using the caller and the workers.
+ *
+ * pf_work is called once per band, with 0 <= i_band < i_bands; it must
+ * only write the output rows of its own band. Returns once every band
+ * has been rendered.
+ */
+void DeinterlacePoolRun( deinterlace_pool_t *,
+                         void (*pf_work)( void *, unsigned, unsigned ),
+                         void *p_ctx );
+
 void InitDeinterlacingContext( struct deinterlace_ctx * );
 
 /**
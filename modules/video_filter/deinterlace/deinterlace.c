@@ -287,6 +287,11 @@ static void Close( vlc_object_t *p_this );
                                     "Best simulation, but requires more CPU "\
                                     "and memory bandwidth.")
 
+#define THREADS_TEXT N_("Deinterlacing threads")
+#define THREADS_LONGTEXT N_("Number of threads used to render a frame for "\
+                            "the algorithms whose output rows are "\
+                            "independent (Yadif, X). 0 means automatic.")
+
 #define PHOSPHOR_DIMMER_TEXT N_("Phosphor old field dimmer strength")
 #define PHOSPHOR_DIMMER_LONGTEXT N_("This controls the strength of the "\
                                     "darkening filter that simulates CRT TV "\
@@ -305,6 +310,10 @@ vlc_module_begin ()
                 SOUT_MODE_LONGTEXT, false )
         change_string_list( mode_list, mode_list_text )
         change_safe ()
+    add_integer( FILTER_CFG_PREFIX "threads", 0, THREADS_TEXT,
+                THREADS_LONGTEXT, true )
+        change_integer_range( 0, DEINTERLACE_POOL_MAX + 1 )
+        change_safe ()
     add_integer( FILTER_CFG_PREFIX "phosphor-chroma", 2, PHOSPHOR_CHROMA_TEXT,
                 PHOSPHOR_CHROMA_LONGTEXT, true )
         change_integer_list( phosphor_chroma_list, phosphor_chroma_list_text )
@@ -328,7 +337,7 @@ vlc_module_end ()
  * and reading logic for them implemented in Open().
  */
 static const char *const ppsz_filter_options[] = {
-    "mode", "phosphor-chroma", "phosphor-dimmer",
+    "mode", "threads", "phosphor-chroma", "phosphor-dimmer",
     NULL
 };
 
@@ -634,6 +643,17 @@ notsupp:
                         VLC_CODEC_J422 : VLC_CODEC_I422;
         }
     }
+    /* Banded rendering: only Yadif and X have independent output rows */
+    unsigned i_threads = 1;
+    if( psz_mode == NULL || !strcmp( psz_mode, "auto" ) ||
+        !strcmp( psz_mode, "x" ) || !strncmp( psz_mode, "yadif", 5 ) )
+    {
+        i_threads = var_GetInteger( p_filter, FILTER_CFG_PREFIX "threads" );
+        if( i_threads == 0 )
+            i_threads = __MIN( vlc_GetCPUCount(), 4 );
+    }
+    DeinterlacePoolStart( VLC_OBJECT(p_filter), &p_sys->pool, i_threads );
+
     free( psz_mode );
 
     if( !p_filter->b_allow_fmt_out_change &&
@@ -661,7 +681,9 @@ notsupp:
 void Close( vlc_object_t *p_this )
 {
     filter_t *p_filter = (filter_t*)p_this;
+    filter_sys_t *p_sys = p_filter->p_sys;
 
     Flush( p_filter );
-    free( p_filter->p_sys );
+    DeinterlacePoolStop( &p_sys->pool );
+    free( p_sys );
 }
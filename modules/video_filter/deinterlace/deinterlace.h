@@ -77,6 +77,9 @@ typedef struct
 
     struct deinterlace_ctx   context;
 
+    /** Worker pool for banded rendering (Yadif, X). */
+    deinterlace_pool_t pool;
+
     /* Algorithm-specific substructures */
     union {
         phosphor_sys_t phosphor; /**< Phosphor algorithm state. */
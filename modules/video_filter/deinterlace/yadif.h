@@ -93,6 +93,115 @@ static void yadif_filter_line_c_16bit(uint8_t *dst8, uint8_t *prev8, uint8_t *cu
     FILTER
 }
 
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+
+/* NEON version of FILTER for 8-bit pixels, 8 pixels per iteration.
+   The conditional CHECK() chains are turned into lane masks: a lane takes
+   the new spatial prediction only where its score improves, and the second
+   step (|j| = 2) only where the first one (|j| = 1) improved, exactly like
+   the scalar short-circuit. */
+static void yadif_filter_line_neon(uint8_t *dst, uint8_t *prev, uint8_t *cur,
+                                   uint8_t *next, int w, int prefs, int mrefs,
+                                   int parity, int mode) {
+    uint8_t *prev2 = parity ? prev : cur;
+    uint8_t *next2 = parity ? cur  : next;
+    int x = 0;
+
+#define WIDEN(v8)      vreinterpretq_s16_u16(vmovl_u8(v8))
+#define LOAD(p, off)   vld1_u8(&(p)[x + (off)])
+#define ABD16(a, b)    WIDEN(vabd_u8(a, b))
+#define AVG16(a, b)    WIDEN(vhadd_u8(a, b))
+
+    for (; x + 8 <= w; x += 8) {
+        const uint8x8_t cur_m8  = LOAD(cur, mrefs);
+        const uint8x8_t cur_p8  = LOAD(cur, prefs);
+        const uint8x8_t prev2_8 = LOAD(prev2, 0);
+        const uint8x8_t next2_8 = LOAD(next2, 0);
+
+        const int16x8_t c = WIDEN(cur_m8);
+        const int16x8_t e = WIDEN(cur_p8);
+        const int16x8_t d = AVG16(prev2_8, next2_8);
+
+        const int16x8_t temporal_diff0 =
+            vshrq_n_s16(ABD16(prev2_8, next2_8), 1);
+        const int16x8_t temporal_diff1 =
+            WIDEN(vhadd_u8(vabd_u8(LOAD(prev, mrefs), cur_m8),
+                           vabd_u8(LOAD(prev, prefs), cur_p8)));
+        const int16x8_t temporal_diff2 =
+            WIDEN(vhadd_u8(vabd_u8(LOAD(next, mrefs), cur_m8),
+                           vabd_u8(LOAD(next, prefs), cur_p8)));
+        int16x8_t diff = vmaxq_s16(vmaxq_s16(temporal_diff0, temporal_diff1),
+                                   temporal_diff2);
+
+        int16x8_t spatial_pred = AVG16(cur_m8, cur_p8);
+        int16x8_t spatial_score =
+            vsubq_s16(vaddq_s16(vaddq_s16(ABD16(LOAD(cur, mrefs - 1),
+                                                LOAD(cur, prefs - 1)),
+                                          ABD16(cur_m8, cur_p8)),
+                                ABD16(LOAD(cur, mrefs + 1),
+                                      LOAD(cur, prefs + 1))),
+                      vdupq_n_s16(1));
+
+/* "m" carries the running condition of the scalar if() nesting:
+   the |j| = 2 step only applies where the |j| = 1 step improved. */
+#define CHECK_NEON(j) \
+        { \
+            const int16x8_t score = \
+                vaddq_s16(vaddq_s16(ABD16(LOAD(cur, mrefs - 1 + (j)), \
+                                          LOAD(cur, prefs - 1 - (j))), \
+                                    ABD16(LOAD(cur, mrefs + (j)), \
+                                          LOAD(cur, prefs - (j)))), \
+                          ABD16(LOAD(cur, mrefs + 1 + (j)), \
+                                LOAD(cur, prefs + 1 - (j)))); \
+            m = vandq_u16(vcltq_s16(score, spatial_score), m); \
+            const int16x8_t pred = AVG16(LOAD(cur, mrefs + (j)), \
+                                         LOAD(cur, prefs - (j))); \
+            spatial_pred = vbslq_s16(m, pred, spatial_pred); \
+            spatial_score = vbslq_s16(m, score, spatial_score); \
+        }
+
+        uint16x8_t m = vdupq_n_u16(0xffff);
+        CHECK_NEON(-1)
+        CHECK_NEON(-2)
+        m = vdupq_n_u16(0xffff);
+        CHECK_NEON( 1)
+        CHECK_NEON( 2)
+#undef CHECK_NEON
+
+        if (mode < 2) {
+            const int16x8_t b = AVG16(LOAD(prev2, 2 * mrefs),
+                                      LOAD(next2, 2 * mrefs));
+            const int16x8_t f = AVG16(LOAD(prev2, 2 * prefs),
+                                      LOAD(next2, 2 * prefs));
+            const int16x8_t de = vsubq_s16(d, e);
+            const int16x8_t dc = vsubq_s16(d, c);
+            const int16x8_t bc = vsubq_s16(b, c);
+            const int16x8_t fe = vsubq_s16(f, e);
+            const int16x8_t max = vmaxq_s16(vmaxq_s16(de, dc),
+                                            vminq_s16(bc, fe));
+            const int16x8_t min = vminq_s16(vminq_s16(de, dc),
+                                            vmaxq_s16(bc, fe));
+            diff = vmaxq_s16(vmaxq_s16(diff, min), vnegq_s16(max));
+        }
+
+        spatial_pred = vminq_s16(spatial_pred, vaddq_s16(d, diff));
+        spatial_pred = vmaxq_s16(spatial_pred, vsubq_s16(d, diff));
+
+        vst1_u8(&dst[x], vqmovun_s16(spatial_pred));
+    }
+
+#undef ABD16
+#undef AVG16
+#undef LOAD
+#undef WIDEN
+
+    if (x < w)
+        yadif_filter_line_c(dst + x, prev + x, cur + x, next + x, w - x,
+                            prefs, mrefs, parity, mode);
+}
+#endif
+
 #if defined(__i386__) || defined(__x86_64__)
 void vlcpriv_yadif_filter_line_ssse3(uint8_t *dst, uint8_t *prev, uint8_t *cur, uint8_t *next, int w, int prefs, int mrefs, int parity, int mode);
 void vlcpriv_yadif_filter_line_sse2(uint8_t *dst, uint8_t *prev, uint8_t *cur, uint8_t *next, int w, int prefs, int mrefs, int parity, int mode);
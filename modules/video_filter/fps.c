@@ -41,6 +41,11 @@ static picture_t *Filter( filter_t *p_filter, picture_t *p_picture);
 
 #define FPS_TEXT N_( "Frame rate" )
 
+#define BLEND_TEXT N_( "Blend duplicated frames" )
+#define BLEND_LONGTEXT N_( "When the frame rate is increased, blend the two " \
+    "surrounding frames instead of repeating the previous one. This smooths " \
+    "out the cadence at the cost of some sharpness on motion." )
+
 vlc_module_begin ()
     set_description( N_("FPS conversion video filter") )
     set_shortname( N_("FPS Converter" ))
@@ -50,11 +55,12 @@ vlc_module_begin ()
 
     add_shortcut( "fps" )
     add_string( CFG_PREFIX "fps", NULL, FPS_TEXT, FPS_TEXT, false )
+    add_bool( CFG_PREFIX "blend", false, BLEND_TEXT, BLEND_LONGTEXT, true )
     set_callbacks( Open, Close )
 vlc_module_end ()
 
 static const char *const ppsz_filter_options[] = {
-    "fps",
+    "fps", "blend",
     NULL
 };
 
@@ -65,8 +71,44 @@ typedef struct
     date_t          next_output_pts; /**< output calculated PTS */
     picture_t       *p_previous_pic;
     vlc_tick_t      i_output_frame_interval;
+    bool            b_blend; /**< blend instead of repeating duplicates */
+
+    /* cadence statistics, reported on close */
+    uint64_t        i_in_frames;
+    uint64_t        i_out_frames;
+    uint64_t        i_dropped;
+    uint64_t        i_duplicated;
 } filter_sys_t;
 
+/* Weighted byte-wise blend of two frames of identical format, weight 0
+   yields p_prev and weight 256 yields p_next. Only used on formats made
+   of whole 8 bit components. */
+static void BlendPicture( picture_t *p_dst, const picture_t *p_prev,
+                          const picture_t *p_next, int i_weight )
+{
+    for( int i = 0; i < p_dst->i_planes; i++ )
+    {
+        const plane_t *p_dstp = &p_dst->p[i];
+        const plane_t *p_prevp = &p_prev->p[i];
+        const plane_t *p_nextp = &p_next->p[i];
+        const int i_lines = __MIN( p_dstp->i_visible_lines,
+                                   p_prevp->i_visible_lines );
+        const int i_pitch = __MIN( p_dstp->i_visible_pitch,
+                                   p_prevp->i_visible_pitch );
+
+        for( int y = 0; y < i_lines; y++ )
+        {
+            uint8_t *p_out = &p_dstp->p_pixels[y * p_dstp->i_pitch];
+            const uint8_t *p_in0 = &p_prevp->p_pixels[y * p_prevp->i_pitch];
+            const uint8_t *p_in1 = &p_nextp->p_pixels[y * p_nextp->i_pitch];
+
+            for( int x = 0; x < i_pitch; x++ )
+                p_out[x] = ( p_in0[x] * ( 256 - i_weight )
+                           + p_in1[x] * i_weight ) >> 8;
+        }
+    }
+}
+
 static picture_t *Filter( filter_t *p_filter, picture_t *p_picture)
 {
     filter_sys_t *p_sys = p_filter->p_sys;
@@ -82,6 +124,7 @@ static picture_t *Filter( filter_t *p_filter, picture_t *p_picture)
 
     p_picture->format.i_frame_rate = p_filter->fmt_out.video.i_frame_rate;
     p_picture->format.i_frame_rate_base = p_filter->fmt_out.video.i_frame_rate_base;
+    p_sys->i_in_frames++;
 
     /* First time we get some valid timestamp, we'll take it as base for output
         later on we retake new timestamp if it has jumped too much */
@@ -95,6 +138,7 @@ static picture_t *Filter( filter_t *p_filter, picture_t *p_picture)
             picture_Release( p_sys->p_previous_pic );
         p_sys->p_previous_pic = picture_Hold( p_picture );
         date_Increment( &p_sys->next_output_pts, 1 );
+        p_sys->i_out_frames++;
         return p_picture;
     }
 
@@ -105,27 +149,57 @@ static picture_t *Filter( filter_t *p_filter, picture_t *p_picture)
         if( p_sys->p_previous_pic )
             picture_Release( p_sys->p_previous_pic );
         p_sys->p_previous_pic = p_picture;
+        p_sys->i_dropped++;
         return NULL;
     }
 
-    p_sys->p_previous_pic->date = date_Get( &p_sys->next_output_pts );
+    vlc_tick_t i_out_pts = date_Get( &p_sys->next_output_pts );
+
+    /* Emit whichever frame lands nearest to the output slot: when the new
+        picture matches it better, the previous one maps to no slot at all
+        and is dropped early to reduce the average timing error */
+    if( llabs( p_picture->date - i_out_pts ) <
+        llabs( p_sys->p_previous_pic->date - i_out_pts ) )
+    {
+        picture_Release( p_sys->p_previous_pic );
+        p_sys->p_previous_pic = picture_Hold( p_picture );
+        p_sys->i_dropped++;
+    }
+
+    const vlc_tick_t i_prev_date = p_sys->p_previous_pic->date;
+    p_sys->p_previous_pic->date = i_out_pts;
     date_Increment( &p_sys->next_output_pts, 1 );
+    p_sys->i_out_frames++;
 
     picture_t *last_pic = p_sys->p_previous_pic;
     /* Duplicating pictures are not that effective and framerate increase
         should be avoided, it's only here as filter should work in that direction too*/
     while( unlikely( (date_Get( &p_sys->next_output_pts ) + p_sys->i_output_frame_interval ) < p_picture->date ) )
     {
-        picture_t *p_tmp = NULL;
-        p_tmp = picture_NewFromFormat( &p_filter->fmt_out.video );
-
-        picture_Copy( p_tmp, p_sys->p_previous_pic);
+        picture_t *p_tmp = picture_NewFromFormat( &p_filter->fmt_out.video );
+        if( unlikely( p_tmp == NULL ) )
+            break;
+
+        if( p_sys->b_blend && p_picture->date > i_prev_date )
+        {
+            /* Weight the blend by how far the slot sits between the two
+                surrounding source frames */
+            int i_weight = ( date_Get( &p_sys->next_output_pts ) - i_prev_date )
+                           * 256 / ( p_picture->date - i_prev_date );
+            BlendPicture( p_tmp, p_sys->p_previous_pic, p_picture,
+                          VLC_CLIP( i_weight, 0, 256 ) );
+            picture_CopyProperties( p_tmp, p_sys->p_previous_pic );
+        }
+        else
+            picture_Copy( p_tmp, p_sys->p_previous_pic);
         p_tmp->date = date_Get( &p_sys->next_output_pts );
         p_tmp->p_next = NULL;
 
         last_pic->p_next = p_tmp;
         last_pic = p_tmp;
         date_Increment( &p_sys->next_output_pts, 1 );
+        p_sys->i_out_frames++;
+        p_sys->i_duplicated++;
     }
 
     last_pic = p_sys->p_previous_pic;
@@ -177,6 +251,18 @@ static int Open( vlc_object_t *p_this)
                p_filter->fmt_out.video.i_frame_rate, p_filter->fmt_out.video.i_frame_rate_base );
 
     p_sys->p_previous_pic = NULL;
+    p_sys->i_in_frames = 0;
+    p_sys->i_out_frames = 0;
+    p_sys->i_dropped = 0;
+    p_sys->i_duplicated = 0;
+
+    /* Byte-wise blending is only valid on formats made of whole 8 bit
+       components */
+    const vlc_chroma_description_t *p_chroma =
+        vlc_fourcc_GetChromaDescription( p_filter->fmt_out.video.i_chroma );
+    p_sys->b_blend = var_InheritBool( p_filter, CFG_PREFIX "blend" ) &&
+        p_chroma != NULL && p_chroma->plane_count > 0 &&
+        p_chroma->pixel_bits == 8 * p_chroma->pixel_size;
 
     p_filter->pf_video_filter = Filter;
     return VLC_SUCCESS;
@@ -186,6 +272,12 @@ static void Close( vlc_object_t *p_this )
 {
     filter_t *p_filter = (filter_t*)p_this;
     filter_sys_t *p_sys = p_filter->p_sys;
+
+    msg_Dbg( p_filter, "cadence: %"PRIu64" in, %"PRIu64" out, "
+             "%"PRIu64" dropped, %"PRIu64" duplicated",
+             p_sys->i_in_frames, p_sys->i_out_frames,
+             p_sys->i_dropped, p_sys->i_duplicated );
+
     if( p_sys->p_previous_pic )
         picture_Release( p_sys->p_previous_pic );
     free( p_sys );
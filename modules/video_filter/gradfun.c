@@ -101,6 +101,8 @@ vlc_module_end()
 static picture_t *Filter(filter_t *, picture_t *);
 static int Callback(vlc_object_t *, char const *, vlc_value_t, vlc_value_t, void *);
 
+#define MAX_BANDS (8)
+
 typedef struct
 {
     vlc_mutex_t      lock;
@@ -108,6 +110,9 @@ typedef struct
     int              radius;
     const vlc_chroma_description_t *chroma;
     struct vf_priv_s cfg;
+    filter_slicer_t *slicer;
+    unsigned         bands;          /* band blur buffers allocated */
+    uint16_t        *buf[MAX_BANDS]; /* one blur buffer per band */
 } filter_sys_t;
 
 static int Open(vlc_object_t *object)
@@ -132,6 +137,10 @@ static int Open(vlc_object_t *object)
     var_AddCallback(filter, CFG_PREFIX "strength", Callback, NULL);
     var_AddCallback(filter, CFG_PREFIX "radius",   Callback, NULL);
     sys->cfg.buf = NULL;
+    sys->slicer  = filter_NewSlicer(filter);
+    sys->bands   = 0;
+    for (unsigned b = 0; b < MAX_BANDS; b++)
+        sys->buf[b] = NULL;
 
     struct vf_priv_s *cfg = &sys->cfg;
     cfg->thresh      = 0.0;
@@ -168,10 +177,33 @@ static void Close(vlc_object_t *object)
 
     var_DelCallback(filter, CFG_PREFIX "radius",   Callback, NULL);
     var_DelCallback(filter, CFG_PREFIX "strength", Callback, NULL);
-    aligned_free(sys->cfg.buf);
+    filter_DeleteSlicer(sys->slicer);
+    for (unsigned b = 0; b < MAX_BANDS; b++)
+        aligned_free(sys->buf[b]);
     free(sys);
 }
 
+struct band_job {
+    filter_sys_t *sys;
+    uint8_t *dst, *src;
+    int width, height, dstride, sstride, radius;
+};
+
+/* Filter one horizontal band of the current plane; each band works on a
+ * private copy of the configuration carrying its own blur buffer. */
+static void FilterBand(void *opaque, unsigned band, unsigned bands)
+{
+    struct band_job *job = opaque;
+    struct vf_priv_s cfg = job->sys->cfg;
+    int y0 = (job->height * (int)band       / (int)bands) & ~1;
+    int y1 = (band + 1 < bands)
+           ? ((job->height * ((int)band + 1) / (int)bands) & ~1) : job->height;
+
+    cfg.buf = job->sys->buf[band];
+    filter_plane(&cfg, job->dst, job->src, job->width, job->height,
+                 job->dstride, job->sstride, job->radius, y0, y1);
+}
+
 static picture_t *Filter(filter_t *filter, picture_t *src)
 {
     filter_sys_t *sys = filter->p_sys;
@@ -193,8 +225,20 @@ static picture_t *Filter(filter_t *filter, picture_t *src)
     cfg->thresh = (1 << 15) / strength;
     if (cfg->radius != radius) {
         cfg->radius = radius;
-        cfg->buf    = aligned_alloc(16,
-                                   (((fmt->i_width + 15) & ~15) * (cfg->radius + 1) / 2 + 32) * sizeof(*cfg->buf));
+
+        unsigned bands = __MIN(filter_SlicerBands(sys->slicer), MAX_BANDS);
+        for (unsigned b = 0; b < MAX_BANDS; b++) {
+            aligned_free(sys->buf[b]);
+            sys->buf[b] = NULL;
+        }
+        sys->bands = 0;
+        for (unsigned b = 0; b < bands; b++) {
+            sys->buf[b] = aligned_alloc(16,
+                                   (((fmt->i_width + 15) & ~15) * (cfg->radius + 1) / 2 + 32) * sizeof(*sys->buf[b]));
+            if (!sys->buf[b])
+                break;
+            sys->bands++;
+        }
     }
 
     for (int i = 0; i < dst->i_planes; i++) {
@@ -207,9 +251,19 @@ static picture_t *Filter(filter_t *filter, picture_t *src)
         int r = (cfg->radius  * chroma->p[i].w.num / chroma->p[i].w.den +
                  cfg->radius  * chroma->p[i].h.num / chroma->p[i].h.den) / 2;
         r = VLC_CLIP((r + 1) & ~1, RADIUS_MIN, RADIUS_MAX);
-        if (__MIN(w, h) > 2 * r && cfg->buf) {
-            filter_plane(cfg, dstp->p_pixels, srcp->p_pixels,
-                         w, h, dstp->i_pitch, srcp->i_pitch, r);
+        if (__MIN(w, h) > 2 * r && sys->bands > 0) {
+            struct band_job job = {
+                .sys = sys,
+                .dst = dstp->p_pixels, .src = srcp->p_pixels,
+                .width = w, .height = h,
+                .dstride = dstp->i_pitch, .sstride = srcp->i_pitch,
+                .radius = r,
+            };
+            /* Keep the bands taller than the blur warm-up margin */
+            unsigned bands = sys->bands;
+            while (bands > 1 && h / (int)bands < 4 * r)
+                bands--;
+            filter_SlicerRun(sys->slicer, FilterBand, &job, bands);
         } else {
             plane_CopyPixels(dstp, srcp);
         }
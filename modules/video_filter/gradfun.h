@@ -222,8 +222,16 @@ static void blur_line_sse2(uint16_t *dc, uint16_t *buf, uint16_t *buf1,
 }
 #endif // HAVE_6REGS && HAVE_SSE2
 
+/*
+ * Filter rows [y0, y1) of a plane of the given height. The box blur is
+ * warmed up from up to 2*r rows above y0 and read up to r rows below y1,
+ * so disjoint bands of the same plane produce the very same output as a
+ * single full-plane pass and can be filtered concurrently, one ctx (and
+ * thus one ctx->buf) per band.
+ */
 static void filter_plane(struct vf_priv_s *ctx, uint8_t *dst, uint8_t *src,
-                         int width, int height, int dstride, int sstride, int r)
+                         int width, int height, int dstride, int sstride,
+                         int r, int y0, int y1)
 {
     int bstride = ((width+15)&~15)/2;
     int y;
@@ -231,6 +239,14 @@ static void filter_plane(struct vf_priv_s *ctx, uint8_t *dst, uint8_t *src,
     uint16_t *dc = ctx->buf+16;
     uint16_t *buf = ctx->buf+bstride+32;
     int thresh = ctx->thresh;
+    int ys = (y0 > 2*r) ? (y0 - 2*r) & ~1 : 0;
+    int ye = (y1 + r < height) ? y1 + r : height;
+    int skip = y0 - ys;
+    int emit = y1 - ys;
+
+    src += ys*sstride;
+    dst += ys*dstride;
+    height = ye - ys;
 
     memset(dc, 0, (bstride+16)*sizeof(*buf));
     for (y=0; y<r; y++)
@@ -254,13 +270,15 @@ static void filter_plane(struct vf_priv_s *ctx, uint8_t *dst, uint8_t *src,
                 dc[x] = dc[0];
         }
         if (y == r) {
-            for (y=0; y<r; y++)
-                ctx->filter_line(dst+y*dstride, src+y*sstride, dc-r/2, width, thresh, dither[y&7]);
+            for (int j=skip; j<r; j++)
+                ctx->filter_line(dst+j*dstride, src+j*sstride, dc-r/2, width, thresh, dither[(j+ys)&7]);
         }
-        ctx->filter_line(dst+y*dstride, src+y*sstride, dc-r/2, width, thresh, dither[y&7]);
-        if (++y >= height) break;
-        ctx->filter_line(dst+y*dstride, src+y*sstride, dc-r/2, width, thresh, dither[y&7]);
-        if (++y >= height) break;
+        if (y >= skip)
+            ctx->filter_line(dst+y*dstride, src+y*sstride, dc-r/2, width, thresh, dither[(y+ys)&7]);
+        if (++y >= emit) break;
+        if (y >= skip)
+            ctx->filter_line(dst+y*dstride, src+y*sstride, dc-r/2, width, thresh, dither[(y+ys)&7]);
+        if (++y >= emit) break;
     }
 }
 
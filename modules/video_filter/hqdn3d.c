@@ -92,6 +92,8 @@ typedef struct
     int w[3], h[3];
 
     struct vf_priv_s cfg;
+    filter_slicer_t *slicer;
+    unsigned int *p_line[3]; /* one line scratch per concurrent plane */
     bool   b_recalc_coefs;
     vlc_mutex_t coefs_mutex;
     float  luma_spat, luma_temp, chroma_spat, chroma_temp;
@@ -109,7 +111,6 @@ static int Open(vlc_object_t *this)
     const video_format_t *fmt_out = &filter->fmt_out.video;
     const vlc_fourcc_t fourcc_in  = fmt_in->i_chroma;
     const vlc_fourcc_t fourcc_out = fmt_out->i_chroma;
-    int wmax = 0;
 
     const vlc_chroma_description_t *chroma =
             vlc_fourcc_GetChromaDescription(fourcc_in);
@@ -134,14 +135,20 @@ static int Open(vlc_object_t *this)
 
     for (int i = 0; i < 3; ++i) {
         sys->w[i] = fmt_in->i_width  * chroma->p[i].w.num / chroma->p[i].w.den;
-        if (sys->w[i] > wmax) wmax = sys->w[i];
         sys->h[i] = fmt_out->i_height * chroma->p[i].h.num / chroma->p[i].h.den;
     }
-    cfg->Line = malloc(wmax*sizeof(unsigned int));
-    if (!cfg->Line) {
-        free(sys);
-        return VLC_ENOMEM;
+    for (int i = 0; i < 3; ++i) {
+        sys->p_line[i] = malloc(sys->w[i]*sizeof(unsigned int));
+        if (!sys->p_line[i]) {
+            while (i > 0)
+                free(sys->p_line[--i]);
+            free(sys);
+            return VLC_ENOMEM;
+        }
     }
+    cfg->Line = NULL; /* per-plane scratches are used instead */
+
+    sys->slicer = filter_NewSlicer(filter);
 
     config_ChainParse(filter, FILTER_PREFIX, filter_options,
                       filter->p_cfg);
@@ -179,13 +186,43 @@ static void Close(vlc_object_t *this)
     var_DelCallback( filter, FILTER_PREFIX "luma-temp", DenoiseCallback, sys );
     var_DelCallback( filter, FILTER_PREFIX "chroma-temp", DenoiseCallback, sys );
 
+    filter_DeleteSlicer(sys->slicer);
     for (int i = 0; i < 3; ++i) {
         free(cfg->Frame[i]);
+        free(sys->p_line[i]);
     }
-    free(cfg->Line);
     free(sys);
 }
 
+/*****************************************************************************
+ * DenoisePlane
+ *****************************************************************************/
+struct plane_job
+{
+    filter_sys_t *sys;
+    const picture_t *src;
+    picture_t *dst;
+};
+
+/* The vertical and temporal low-pass chains run down each plane
+ * sequentially, so the planes themselves are the bands: each one carries
+ * its own line scratch and frame history. */
+static void DenoisePlane(void *opaque, unsigned plane, unsigned planes)
+{
+    struct plane_job *job = opaque;
+    filter_sys_t *sys = job->sys;
+    struct vf_priv_s *cfg = &sys->cfg;
+    const int c = (plane > 0) ? 2 : 0; /* the chroma planes share coefs */
+
+    VLC_UNUSED(planes);
+    deNoise(job->src->p[plane].p_pixels, job->dst->p[plane].p_pixels,
+            sys->p_line[plane], &cfg->Frame[plane], sys->w[plane], sys->h[plane],
+            job->src->p[plane].i_pitch, job->dst->p[plane].i_pitch,
+            cfg->Coefs[c],
+            cfg->Coefs[c],
+            cfg->Coefs[c + 1]);
+}
+
 /*****************************************************************************
  * Filter
  *****************************************************************************/
@@ -218,24 +255,8 @@ static picture_t *Filter(filter_t *filter, picture_t *src)
     }
     vlc_mutex_unlock( &sys->coefs_mutex );
 
-    deNoise(src->p[0].p_pixels, dst->p[0].p_pixels,
-            cfg->Line, &cfg->Frame[0], sys->w[0], sys->h[0],
-            src->p[0].i_pitch, dst->p[0].i_pitch,
-            cfg->Coefs[0],
-            cfg->Coefs[0],
-            cfg->Coefs[1]);
-    deNoise(src->p[1].p_pixels, dst->p[1].p_pixels,
-            cfg->Line, &cfg->Frame[1], sys->w[1], sys->h[1],
-            src->p[1].i_pitch, dst->p[1].i_pitch,
-            cfg->Coefs[2],
-            cfg->Coefs[2],
-            cfg->Coefs[3]);
-    deNoise(src->p[2].p_pixels, dst->p[2].p_pixels,
-            cfg->Line, &cfg->Frame[2], sys->w[2], sys->h[2],
-            src->p[2].i_pitch, dst->p[2].i_pitch,
-            cfg->Coefs[2],
-            cfg->Coefs[2],
-            cfg->Coefs[3]);
+    struct plane_job job = { sys, src, dst };
+    filter_SlicerRun(sys->slicer, DenoisePlane, &job, 3);
 
     if(unlikely(!cfg->Frame[0] || !cfg->Frame[1] || !cfg->Frame[2]))
     {
@@ -115,6 +115,15 @@ static void R270(int *sx, int *sy, int w, int h, int dx, int dy)
 }
 typedef void (*convert_t)(int *, int *, int, int, int, int);
 
+/*
+ * The rotating transforms read the source in columns, so a straight
+ * destination scan touches one source cache line per pixel. Walking the
+ * destination in square tiles instead keeps every source and destination
+ * line of a tile resident in L1 while it is worked on. The coordinate
+ * conversion is inlined, so the tile body reduces to plain copy loops.
+ */
+#define TILE 16
+
 #define PLANE(f,bits) \
 static void Plane##bits##_##f(plane_t *restrict dst, const plane_t *restrict src) \
 { \
@@ -124,12 +133,19 @@ static void Plane##bits##_##f(plane_t *restrict dst, const plane_t *restrict src
     const unsigned dst_width = dst->i_pitch / sizeof (*dst_pixels); \
     const unsigned dst_visible_width = dst->i_visible_pitch / sizeof (*dst_pixels); \
  \
-    for (int y = 0; y < dst->i_visible_lines; y++) { \
-        for (unsigned x = 0; x < dst_visible_width; x++) { \
-            int sx, sy; \
-            (f)(&sx, &sy, dst_visible_width, dst->i_visible_lines, x, y); \
-            dst_pixels[y * dst_width + x] = \
-                src_pixels[sy * src_width + sx]; \
+    for (int by = 0; by < dst->i_visible_lines; by += TILE) { \
+        const int ey = __MIN(by + TILE, dst->i_visible_lines); \
+        for (unsigned bx = 0; bx < dst_visible_width; bx += TILE) { \
+            const unsigned ex = __MIN(bx + TILE, dst_visible_width); \
+            for (int y = by; y < ey; y++) { \
+                for (unsigned x = bx; x < ex; x++) { \
+                    int sx, sy; \
+                    (f)(&sx, &sy, dst_visible_width, dst->i_visible_lines, \
+                        x, y); \
+                    dst_pixels[y * dst_width + x] = \
+                        src_pixels[sy * src_width + sx]; \
+                } \
+            } \
         } \
     } \
 }
@@ -150,15 +166,21 @@ static void Plane_VFlip(plane_t *restrict dst, const plane_t *restrict src)
 #define I422(f) \
 static void Plane422_##f(plane_t *restrict dst, const plane_t *restrict src) \
 { \
-    for (int y = 0; y < dst->i_visible_lines; y += 2) { \
-        for (int x = 0; x < dst->i_visible_pitch; x++) { \
-            int sx, sy, uv; \
-            (f)(&sx, &sy, dst->i_visible_pitch, dst->i_visible_lines / 2, \
-                x, y / 2); \
-            uv = (1 + src->p_pixels[2 * sy * src->i_pitch + sx] + \
-                src->p_pixels[(2 * sy + 1) * src->i_pitch + sx]) / 2; \
-            dst->p_pixels[y * dst->i_pitch + x] = uv; \
-            dst->p_pixels[(y + 1) * dst->i_pitch + x] = uv; \
+    for (int by = 0; by < dst->i_visible_lines; by += 2 * TILE) { \
+        const int ey = __MIN(by + 2 * TILE, dst->i_visible_lines); \
+        for (int bx = 0; bx < dst->i_visible_pitch; bx += TILE) { \
+            const int ex = __MIN(bx + TILE, dst->i_visible_pitch); \
+            for (int y = by; y < ey; y += 2) { \
+                for (int x = bx; x < ex; x++) { \
+                    int sx, sy, uv; \
+                    (f)(&sx, &sy, dst->i_visible_pitch, \
+                        dst->i_visible_lines / 2, x, y / 2); \
+                    uv = (1 + src->p_pixels[2 * sy * src->i_pitch + sx] + \
+                        src->p_pixels[(2 * sy + 1) * src->i_pitch + sx]) / 2; \
+                    dst->p_pixels[y * dst->i_pitch + x] = uv; \
+                    dst->p_pixels[(y + 1) * dst->i_pitch + x] = uv; \
+                } \
+            } \
         } \
     } \
 }
@@ -168,8 +190,12 @@ static void PlaneYUY2_##f(plane_t *restrict dst, const plane_t *restrict src) \
 { \
     unsigned dst_visible_width = dst->i_visible_pitch / 2; \
  \
-    for (int y = 0; y < dst->i_visible_lines; y += 2) { \
-        for (unsigned x = 0; x < dst_visible_width; x+= 2) { \
+    for (int by = 0; by < dst->i_visible_lines; by += 2 * TILE) { \
+      const int ey = __MIN(by + 2 * TILE, dst->i_visible_lines); \
+      for (unsigned bx = 0; bx < dst_visible_width; bx += 2 * TILE) { \
+        const unsigned ex = __MIN(bx + 2 * TILE, dst_visible_width); \
+        for (int y = by; y < ey; y += 2) { \
+          for (unsigned x = bx; x < ex; x += 2) { \
             int sx0, sy0, sx1, sy1; \
             (f)(&sx0, &sy0, dst_visible_width, dst->i_visible_lines, x, y); \
             (f)(&sx1, &sy1, dst_visible_width, dst->i_visible_lines, \
@@ -194,7 +220,9 @@ static void PlaneYUY2_##f(plane_t *restrict dst, const plane_t *restrict src) \
             dst->p_pixels[(y + 0) * dst->i_pitch + 2 * x + 3] = v; \
             dst->p_pixels[(y + 1) * dst->i_pitch + 2 * x + 1] = u; \
             dst->p_pixels[(y + 1) * dst->i_pitch + 2 * x + 3] = v; \
+          } \
         } \
+      } \
     } \
 }
 
@@ -31,6 +31,7 @@
 #endif
 
 #include <vlc_fixups.h>
+#include <atomic>
 #include <cinttypes>
 
 #include <vlc_common.h>
@@ -62,6 +63,12 @@
 #define FRAME_SIZE 1920
 #define CHANNELS_MAX 6
 
+/* Frames scheduled ahead of StartScheduledPlayback(), so that a scheduling
+ * hiccup in the display thread does not immediately starve the card */
+#define PREROLL_FRAMES 3
+/* Reused IDeckLinkMutableVideoFrame buffers for the conversion path */
+#define FRAME_POOL_SIZE 4
+
 #if 0
 static const int pi_channels_maps[CHANNELS_MAX+1] =
 {
@@ -188,6 +195,8 @@ static_assert(ARRAY_SIZE(rgi_ar_values) == ARRAY_SIZE(rgsz_ar_text), "afd arrays
 
 namespace {
 
+class SchedulerCallback;
+
 /* Only one audio output module and one video output module
  * can be used per process.
  * We use a static mutex in audio/video submodules entry points.  */
@@ -225,9 +234,149 @@ struct decklink_sys_t
         uint8_t afd, ar;
         int nosignal_delay;
         picture_t *pic_nosignal;
+
+        /* With LOCK */
+        bool started; /* scheduled playback running (preroll over) */
+        unsigned prerolled; /* frames scheduled before playback start */
+        uint64_t late, dropped; /* completion statistics */
+        SchedulerCallback *cb;
+        struct
+        {
+            IDeckLinkMutableVideoFrame *frame;
+            bool busy; /* scheduled, not completed yet */
+        } pool[FRAME_POOL_SIZE];
     } video;
 };
 
+/* IDeckLinkVideoFrame wrapping a held picture_t plane, so that the 8-bit
+ * UYVY path schedules the decoder/filter buffer as-is, with neither a frame
+ * allocation nor a copy. The picture is released when the card is done with
+ * the frame. */
+class PictureVideoFrame : public IDeckLinkVideoFrame
+{
+    public:
+        PictureVideoFrame(picture_t *pic) : refs(1)
+        {
+            this->pic = picture_Hold(pic);
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE QueryInterface(REFIID, LPVOID *)
+        {
+            return E_NOINTERFACE;
+        }
+
+        virtual ULONG STDMETHODCALLTYPE AddRef()
+        {
+            return ++refs;
+        }
+
+        virtual ULONG STDMETHODCALLTYPE Release()
+        {
+            ULONG count = --refs;
+            if (count == 0)
+                delete this;
+            return count;
+        }
+
+        virtual long STDMETHODCALLTYPE GetWidth()
+        {
+            return pic->format.i_width;
+        }
+
+        virtual long STDMETHODCALLTYPE GetHeight()
+        {
+            return pic->format.i_height;
+        }
+
+        virtual long STDMETHODCALLTYPE GetRowBytes()
+        {
+            return pic->p[0].i_pitch;
+        }
+
+        virtual BMDPixelFormat STDMETHODCALLTYPE GetPixelFormat()
+        {
+            return bmdFormat8BitYUV;
+        }
+
+        virtual BMDFrameFlags STDMETHODCALLTYPE GetFlags()
+        {
+            return bmdFrameFlagDefault;
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE GetBytes(void **buffer)
+        {
+            *buffer = pic->p[0].p_pixels;
+            return S_OK;
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE
+        GetTimecode(BMDTimecodeFormat, IDeckLinkTimecode **)
+        {
+            return S_FALSE;
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE
+        GetAncillaryData(IDeckLinkVideoFrameAncillary **)
+        {
+            return S_FALSE;
+        }
+
+    private:
+        virtual ~PictureVideoFrame()
+        {
+            picture_Release(pic);
+        }
+
+        std::atomic<ULONG> refs;
+        picture_t *pic;
+};
+
+/* Returns pooled conversion frames to the free list once the card has
+ * displayed them, and keeps late/drop statistics */
+class SchedulerCallback : public IDeckLinkVideoOutputCallback
+{
+    public:
+        SchedulerCallback(decklink_sys_t *sys) : sys(sys) {}
+        virtual ~SchedulerCallback() {}
+
+        virtual HRESULT STDMETHODCALLTYPE QueryInterface(REFIID, LPVOID *)
+        {
+            return E_NOINTERFACE;
+        }
+
+        /* Owned (and deleted) by the output module */
+        virtual ULONG STDMETHODCALLTYPE AddRef() { return 1; }
+        virtual ULONG STDMETHODCALLTYPE Release() { return 1; }
+
+        virtual HRESULT STDMETHODCALLTYPE
+        ScheduledFrameCompleted(IDeckLinkVideoFrame *frame,
+                                BMDOutputFrameCompletionResult result)
+        {
+            vlc_mutex_lock(&sys->lock);
+            if (result == bmdOutputFrameDisplayedLate)
+                sys->video.late++;
+            else if (result == bmdOutputFrameDropped)
+                sys->video.dropped++;
+
+            for (size_t i = 0; i < FRAME_POOL_SIZE; i++)
+                if (sys->video.pool[i].frame == frame)
+                {
+                    sys->video.pool[i].busy = false;
+                    break;
+                }
+            vlc_mutex_unlock(&sys->lock);
+            return S_OK;
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE ScheduledPlaybackHasStopped()
+        {
+            return S_OK;
+        }
+
+    private:
+        decklink_sys_t *sys;
+};
+
 } // namespace
 
 /*****************************************************************************
@@ -330,6 +479,7 @@ static decklink_sys_t *HoldDLSys(vlc_object_t *obj, int i_cat)
             sys->i_rate = var_InheritInteger(obj, AUDIO_CFG_PREFIX "audio-rate");
             if(sys->i_rate > 0)
                 sys->i_rate = -1;
+            memset(&sys->video, 0, sizeof(sys->video));
             vlc_mutex_init(&sys->lock);
             vlc_cond_init(&sys->cond);
             var_Create(libvlc, "decklink-sys", VLC_VAR_ADDRESS);
@@ -351,15 +501,23 @@ static void ReleaseDLSys(vlc_object_t *obj, int i_cat)
 
     if (--sys->users == 0) {
         msg_Dbg(obj, "Destroying decklink data");
+        if (sys->video.late > 0 || sys->video.dropped > 0)
+            msg_Warn(obj, "Playout: %" PRIu64 " frames late, %" PRIu64
+                     " dropped", sys->video.late, sys->video.dropped);
 
         if (sys->p_output) {
             sys->p_output->StopScheduledPlayback(0, NULL, 0);
+            sys->p_output->SetScheduledFrameCompletionCallback(NULL);
             sys->p_output->DisableVideoOutput();
             sys->p_output->DisableAudioOutput();
             sys->p_output->Release();
         }
 
         /* Clean video specific */
+        for (size_t i = 0; i < FRAME_POOL_SIZE; i++)
+            if (sys->video.pool[i].frame)
+                sys->video.pool[i].frame->Release();
+        delete sys->video.cb;
         if (sys->video.pic_nosignal)
             picture_Release(sys->video.pic_nosignal);
 
@@ -589,10 +747,12 @@ static int OpenDecklink(vout_display_t *vd, decklink_sys_t *sys, video_format_t
         CHECK("Could not start audio output");
     }
 
-    /* start */
-    result = sys->p_output->StartScheduledPlayback(
-        samples_from_vlc_tick(vlc_tick_now(), sys->timescale), sys->timescale, 1.0);
-    CHECK("Could not start playback");
+    /* Played-out frames are recycled (and accounted) on completion; playback
+     * itself starts once PREROLL_FRAMES frames have been scheduled, in
+     * PrepareVideo() */
+    sys->video.cb = new SchedulerCallback(sys);
+    result = sys->p_output->SetScheduledFrameCompletionCallback(sys->video.cb);
+    CHECK("Could not set completion callback");
 
     p_config->Release();
     p_display_mode->Release();
@@ -667,62 +827,101 @@ static void PrepareVideo(vout_display_t *vd, picture_t *picture, subpicture_t *,
 
     HRESULT result;
     int w, h, stride, length;
+    bool pooled = false, scheduled = false, started;
+    IDeckLinkVideoFrame *pDLVideoFrame = NULL;
+    IDeckLinkMutableVideoFrame *pMutableFrame = NULL;
     w = vd->fmt.i_width;
     h = vd->fmt.i_height;
 
-    IDeckLinkMutableVideoFrame *pDLVideoFrame;
-    result = sys->p_output->CreateVideoFrame(w, h, w*3,
-        sys->video.tenbits ? bmdFormat10BitYUV : bmdFormat8BitYUV,
-        bmdFrameFlagDefault, &pDLVideoFrame);
+    if (!sys->video.tenbits && picture->p[0].i_pitch == w * 2) {
+        /* Zero-copy: schedule the picture plane itself. The picture is held
+         * until the card reports the frame completed. */
+        pDLVideoFrame = new PictureVideoFrame(picture);
+    } else {
+        /* Conversion path (v210 or padded pitches): reuse a completed frame
+         * from the pool rather than allocating one per picture */
+        vlc_mutex_lock(&sys->lock);
+        for (size_t i = 0; i < FRAME_POOL_SIZE; i++) {
+            if (sys->video.pool[i].frame && !sys->video.pool[i].busy) {
+                pMutableFrame = sys->video.pool[i].frame;
+                sys->video.pool[i].busy = true;
+                pooled = true;
+                break;
+            }
+        }
+        vlc_mutex_unlock(&sys->lock);
+
+        if (pMutableFrame == NULL) {
+            result = sys->p_output->CreateVideoFrame(w, h, w*3,
+                sys->video.tenbits ? bmdFormat10BitYUV : bmdFormat8BitYUV,
+                bmdFrameFlagDefault, &pMutableFrame);
+            if (result != S_OK) {
+                msg_Err(vd, "Failed to create video frame: 0x%X", result);
+                return;
+            }
 
-    if (result != S_OK) {
-        msg_Err(vd, "Failed to create video frame: 0x%X", result);
-        pDLVideoFrame = NULL;
-        goto end;
+            /* Keep it for next time; the pool reference is the one created
+             * here. If all slots are taken, the frame stays transient and
+             * is released below like before. */
+            vlc_mutex_lock(&sys->lock);
+            for (size_t i = 0; i < FRAME_POOL_SIZE; i++) {
+                if (sys->video.pool[i].frame == NULL) {
+                    sys->video.pool[i].frame = pMutableFrame;
+                    sys->video.pool[i].busy = true;
+                    pooled = true;
+                    break;
+                }
+            }
+            vlc_mutex_unlock(&sys->lock);
+        }
+        pDLVideoFrame = pMutableFrame;
     }
 
     void *frame_bytes;
-    pDLVideoFrame->GetBytes((void**)&frame_bytes);
-    stride = pDLVideoFrame->GetRowBytes();
 
-    if (sys->video.tenbits) {
-        IDeckLinkVideoFrameAncillary *vanc;
-        int line;
-        void *buf;
+    if (pMutableFrame != NULL) {
+        pMutableFrame->GetBytes((void**)&frame_bytes);
+        stride = pMutableFrame->GetRowBytes();
 
-        result = sys->p_output->CreateAncillaryData(
-                sys->video.tenbits ? bmdFormat10BitYUV : bmdFormat8BitYUV, &vanc);
-        if (result != S_OK) {
-            msg_Err(vd, "Failed to create vanc: %d", result);
-            goto end;
-        }
+        if (sys->video.tenbits) {
+            IDeckLinkVideoFrameAncillary *vanc;
+            int line;
+            void *buf;
 
-        line = var_InheritInteger(vd, VIDEO_CFG_PREFIX "afd-line");
-        result = vanc->GetBufferForVerticalBlankingLine(line, &buf);
-        if (result != S_OK) {
-            msg_Err(vd, "Failed to get VBI line %d: %d", line, result);
-            goto end;
-        }
+            result = sys->p_output->CreateAncillaryData(bmdFormat10BitYUV,
+                                                        &vanc);
+            if (result != S_OK) {
+                msg_Err(vd, "Failed to create vanc: %d", result);
+                goto end;
+            }
+
+            line = var_InheritInteger(vd, VIDEO_CFG_PREFIX "afd-line");
+            result = vanc->GetBufferForVerticalBlankingLine(line, &buf);
+            if (result != S_OK) {
+                msg_Err(vd, "Failed to get VBI line %d: %d", line, result);
+                vanc->Release();
+                goto end;
+            }
 
-        sdi::AFD afd(sys->video.afd, sys->video.ar);
-        afd.FillBuffer(reinterpret_cast<uint8_t*>(buf), stride);
+            sdi::AFD afd(sys->video.afd, sys->video.ar);
+            afd.FillBuffer(reinterpret_cast<uint8_t*>(buf), stride);
 
-        sdi::V210::Convert(picture, stride, frame_bytes);
+            sdi::V210::Convert(picture, stride, frame_bytes);
 
-        result = pDLVideoFrame->SetAncillaryData(vanc);
-        vanc->Release();
-        if (result != S_OK) {
-            msg_Err(vd, "Failed to set vanc: %d", result);
-            goto end;
+            result = pMutableFrame->SetAncillaryData(vanc);
+            vanc->Release();
+            if (result != S_OK) {
+                msg_Err(vd, "Failed to set vanc: %d", result);
+                goto end;
+            }
+        }
+        else for(int y = 0; y < h; ++y) {
+            uint8_t *dst = (uint8_t *)frame_bytes + stride * y;
+            const uint8_t *src = (const uint8_t *)picture->p[0].p_pixels +
+                picture->p[0].i_pitch * y;
+            memcpy(dst, src, w * 2 /* bpp */);
         }
     }
-    else for(int y = 0; y < h; ++y) {
-        uint8_t *dst = (uint8_t *)frame_bytes + stride * y;
-        const uint8_t *src = (const uint8_t *)picture->p[0].p_pixels +
-            picture->p[0].i_pitch * y;
-        memcpy(dst, src, w * 2 /* bpp */);
-    }
-
 
     // compute frame duration in CLOCK_FREQ units
     length = (sys->frameduration * CLOCK_FREQ) / sys->timescale;
@@ -735,6 +934,27 @@ static void PrepareVideo(vout_display_t *vd, picture_t *picture, subpicture_t *,
         msg_Err(vd, "Dropped Video frame %" PRId64 ": 0x%x", date, result);
         goto end;
     }
+    scheduled = true;
+
+    /* The scheduler now owns a reference; keep the playback prerolled */
+    vlc_mutex_lock(&sys->lock);
+    started = sys->video.started;
+    if (!started && ++sys->video.prerolled >= PREROLL_FRAMES) {
+        result = sys->p_output->StartScheduledPlayback(
+            samples_from_vlc_tick(vlc_tick_now(), sys->timescale),
+            sys->timescale, 1.0);
+        if (result != S_OK)
+            msg_Err(vd, "Could not start playback: 0x%X", result);
+        else {
+            msg_Dbg(vd, "Scheduled playback started (%u frames prerolled)",
+                    sys->video.prerolled);
+            sys->video.started = started = true;
+        }
+    }
+    vlc_mutex_unlock(&sys->lock);
+
+    if (!started)
+        goto end;
 
     now = vlc_tick_now() - sys->offset;
 
@@ -749,8 +969,17 @@ static void PrepareVideo(vout_display_t *vd, picture_t *picture, subpicture_t *,
     }
 
 end:
-    if (pDLVideoFrame)
-        pDLVideoFrame->Release();
+    if (!pooled) {
+        if (pDLVideoFrame)
+            pDLVideoFrame->Release();
+    } else if (!scheduled) {
+        /* No completion will come for this frame: free the slot now */
+        vlc_mutex_lock(&sys->lock);
+        for (size_t i = 0; i < FRAME_POOL_SIZE; i++)
+            if (sys->video.pool[i].frame == pMutableFrame)
+                sys->video.pool[i].busy = false;
+        vlc_mutex_unlock(&sys->lock);
+    }
 }
 
 static int ControlVideo(vout_display_t *vd, int query, va_list args)
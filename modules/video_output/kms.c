@@ -42,6 +42,7 @@
 #include <vlc_plugin.h>
 #include <vlc_vout_display.h>
 #include <vlc_picture_pool.h>
+#include <vlc_filter.h>
 #include <vlc_fs.h>
 
 /*****************************************************************************
@@ -67,6 +68,17 @@
 
 typedef enum { drvSuccess, drvTryNext, drvFail } deviceRval;
 
+/*
+ * atomic modesetting needs the property ids of each plane state
+ * element, they're looked up once at open time.
+ */
+struct plane_props {
+    uint32_t        fb_id;
+    uint32_t        crtc_id;
+    uint32_t        src_x, src_y, src_w, src_h;
+    uint32_t        crtc_x, crtc_y, crtc_w, crtc_h;
+};
+
 struct vout_display_sys_t {
 /*
  * buffer information
@@ -95,6 +107,27 @@ struct vout_display_sys_t {
     uint32_t        crtc;
     uint32_t        plane_id;
 
+/*
+ * atomic modesetting
+ */
+    bool            has_atomic;
+    struct plane_props plane_props;
+    struct plane_props spu_plane_props;
+
+/*
+ * SPU overlay plane
+ */
+    uint32_t        spu_plane_id;
+    uint32_t        spu_fb;
+    uint32_t        spu_handle;
+    uint32_t        spu_stride;
+    uint32_t        spu_size;
+    uint8_t         *spu_map;
+    picture_t       *spu_picture;
+    vlc_blender_t   *spu_blend;
+    int64_t         spu_order;
+    bool            spu_visible;
+
 /*
  * other generic stuff
  */
@@ -218,6 +251,143 @@ err_destroy:
 }
 
 
+static void DestroySpuFB(vout_display_sys_t *sys)
+{
+    struct drm_mode_destroy_dumb destroy_req = { .handle = sys->spu_handle };
+
+    munmap(sys->spu_map, sys->spu_size);
+    drmModeRmFB(sys->drm_fd, sys->spu_fb);
+    drmIoctl(sys->drm_fd, DRM_IOCTL_MODE_DESTROY_DUMB, &destroy_req);
+    sys->spu_fb = 0;
+}
+
+static deviceRval CreateSpuFB(vout_display_t *vd)
+{
+    vout_display_sys_t *sys = vd->sys;
+    struct drm_mode_create_dumb create_req = { .width = sys->width,
+                                               .height = sys->height,
+                                               .bpp = 32 };
+    struct drm_mode_destroy_dumb destroy_req;
+    struct drm_mode_map_dumb modify_req = {};
+    uint32_t offsets[] = {0,0,0,0}, handles[] = {0,0,0,0},
+            pitches[] = {0,0,0,0};
+    int ret;
+
+    ret = drmIoctl(sys->drm_fd, DRM_IOCTL_MODE_CREATE_DUMB, &create_req);
+    if (ret < 0) {
+        msg_Err(vd, "Cannot create SPU dumb buffer");
+        return drvFail;
+    }
+
+    sys->spu_size = create_req.size;
+    sys->spu_handle = create_req.handle;
+    sys->spu_stride = create_req.pitch;
+
+    handles[0] = create_req.handle;
+    pitches[0] = create_req.pitch;
+
+    ret = drmModeAddFB2(sys->drm_fd, sys->width, sys->height,
+                        DRM_FORMAT_ARGB8888, handles, pitches, offsets,
+                        &sys->spu_fb, 0);
+    if (ret) {
+        msg_Err(vd, "Cannot create SPU frame buffer");
+        goto err_destroy;
+    }
+
+    modify_req.handle = sys->spu_handle;
+    ret = drmIoctl(sys->drm_fd, DRM_IOCTL_MODE_MAP_DUMB, &modify_req);
+    if (ret) {
+        msg_Err(vd, "Cannot map SPU dumb buffer");
+        goto err_fb;
+    }
+
+    sys->spu_map = mmap(0, sys->spu_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                        sys->drm_fd, modify_req.offset);
+    if (sys->spu_map == MAP_FAILED) {
+        msg_Err(vd, "Cannot mmap SPU dumb buffer");
+        goto err_fb;
+    }
+
+    memset(sys->spu_map, 0, sys->spu_size);
+    return drvSuccess;
+
+err_fb:
+    drmModeRmFB(sys->drm_fd, sys->spu_fb);
+    sys->spu_fb = 0;
+
+err_destroy:
+    memset(&destroy_req, 0, sizeof(destroy_req));
+    destroy_req.handle = sys->spu_handle;
+    drmIoctl(sys->drm_fd, DRM_IOCTL_MODE_DESTROY_DUMB, &destroy_req);
+    sys->spu_handle = 0;
+    return drvFail;
+}
+
+
+static bool FindPlaneProperties(vout_display_sys_t *sys, uint32_t plane_id,
+                                struct plane_props *props)
+{
+    static const char *const names[] = { "FB_ID", "CRTC_ID",
+                                         "SRC_X", "SRC_Y", "SRC_W", "SRC_H",
+                                         "CRTC_X", "CRTC_Y", "CRTC_W",
+                                         "CRTC_H" };
+    uint32_t *const ids[] = { &props->fb_id, &props->crtc_id,
+                              &props->src_x, &props->src_y,
+                              &props->src_w, &props->src_h,
+                              &props->crtc_x, &props->crtc_y,
+                              &props->crtc_w, &props->crtc_h };
+    drmModeObjectProperties *op;
+    drmModePropertyPtr pp;
+    unsigned i, j, found = 0;
+
+    op = drmModeObjectGetProperties(sys->drm_fd, plane_id,
+                                    DRM_MODE_OBJECT_PLANE);
+    if (op == NULL)
+        return false;
+
+    memset(props, 0, sizeof(*props));
+    for (i = 0; i < op->count_props; i++) {
+        pp = drmModeGetProperty(sys->drm_fd, op->props[i]);
+        if (pp == NULL)
+            continue;
+        for (j = 0; j < ARRAY_SIZE(names); j++) {
+            if (strcmp(pp->name, names[j]) == 0) {
+                *ids[j] = pp->prop_id;
+                found++;
+                break;
+            }
+        }
+        drmModeFreeProperty(pp);
+    }
+    drmModeFreeObjectProperties(op);
+
+    return found == ARRAY_SIZE(names);
+}
+
+
+static int AddPlaneState(drmModeAtomicReq *req, uint32_t plane_id,
+                         const struct plane_props *props, uint32_t fb,
+                         uint32_t crtc, uint32_t width, uint32_t height)
+{
+    int err = 0;
+
+    err |= drmModeAtomicAddProperty(req, plane_id, props->fb_id, fb) < 0;
+    err |= drmModeAtomicAddProperty(req, plane_id, props->crtc_id, crtc) < 0;
+    err |= drmModeAtomicAddProperty(req, plane_id, props->src_x, 0) < 0;
+    err |= drmModeAtomicAddProperty(req, plane_id, props->src_y, 0) < 0;
+    err |= drmModeAtomicAddProperty(req, plane_id, props->src_w,
+                                    (uint64_t)width << 16) < 0;
+    err |= drmModeAtomicAddProperty(req, plane_id, props->src_h,
+                                    (uint64_t)height << 16) < 0;
+    err |= drmModeAtomicAddProperty(req, plane_id, props->crtc_x, 0) < 0;
+    err |= drmModeAtomicAddProperty(req, plane_id, props->crtc_y, 0) < 0;
+    err |= drmModeAtomicAddProperty(req, plane_id, props->crtc_w, width) < 0;
+    err |= drmModeAtomicAddProperty(req, plane_id, props->crtc_h, height) < 0;
+
+    return err ? -1 : 0;
+}
+
+
 static deviceRval FindCRTC(vout_display_t *vd, drmModeRes const *res,
                              drmModeConnector const *conn)
 {
@@ -405,6 +575,16 @@ static bool ChromaNegotiation(vout_display_t *vd)
                         sys->plane_id = plane->plane_id;
                     }
 
+                    /*
+                     * remember the first overlay plane capable of ARGB,
+                     * it may carry the subpictures.
+                     */
+                    if (planetype == DRM_PLANE_TYPE_OVERLAY &&
+                            sys->spu_plane_id == 0 &&
+                            plane->formats[i] == DRM_FORMAT_ARGB8888) {
+                        sys->spu_plane_id = plane->plane_id;
+                    }
+
                     /*
                      * we don't advertise about cursor plane because
                      * of its special limitations.
@@ -491,6 +671,66 @@ static bool ChromaNegotiation(vout_display_t *vd)
     return false;
 }
 
+/*
+ * subpicture regions are requested in RGBA, they're composed with the
+ * blend filter into the ARGB overlay framebuffer.
+ */
+static const vlc_fourcc_t spu_chromas[] = { VLC_CODEC_RGBA, 0 };
+
+
+static void SetupSpuPlane(vout_display_t *vd)
+{
+    vout_display_sys_t *sys = vd->sys;
+    video_format_t fmt;
+
+    /*
+     * the overlay plane is of no use if the video ended up on it.
+     */
+    if (sys->spu_plane_id == 0 || sys->spu_plane_id == sys->plane_id) {
+        sys->spu_plane_id = 0;
+        return;
+    }
+
+    if (CreateSpuFB(vd) != drvSuccess) {
+        sys->spu_plane_id = 0;
+        return;
+    }
+
+    /*
+     * DRM_FORMAT_ARGB8888 is stored B, G, R, A in memory on little
+     * endian machines, which is what VLC calls BGRA.
+     */
+    video_format_Init(&fmt, VLC_CODEC_BGRA);
+    fmt.i_width = fmt.i_visible_width = sys->width;
+    fmt.i_height = fmt.i_visible_height = sys->height;
+
+    picture_resource_t rsc = { .p_sys = NULL };
+    rsc.p[0].p_pixels = sys->spu_map;
+    rsc.p[0].i_lines  = sys->height;
+    rsc.p[0].i_pitch  = sys->spu_stride;
+
+    sys->spu_picture = picture_NewFromResource(&fmt, &rsc);
+    if (sys->spu_picture == NULL)
+        goto err_out;
+
+    sys->spu_blend = filter_NewBlend(VLC_OBJECT(vd), &fmt);
+    if (sys->spu_blend == NULL) {
+        picture_Release(sys->spu_picture);
+        sys->spu_picture = NULL;
+        goto err_out;
+    }
+
+    msg_Dbg(vd, "Using plane id %u as ARGB subpicture overlay",
+            sys->spu_plane_id);
+    return;
+
+err_out:
+    msg_Warn(vd, "Cannot setup SPU overlay plane, falling back to blending");
+    DestroySpuFB(sys);
+    sys->spu_plane_id = 0;
+}
+
+
 static void CustomDestroyPicture(picture_t *p_picture)
 {
     picture_sys_t *psys = (picture_sys_t*)p_picture->p_sys;
@@ -500,6 +740,9 @@ static void CustomDestroyPicture(picture_t *p_picture)
     for (c = 0; c < MAXHWBUF; c++)
         DestroyFB(sys, c);
 
+    if (sys->spu_fb)
+        DestroySpuFB(sys);
+
     drmSetClientCap(sys->drm_fd, DRM_CLIENT_CAP_UNIVERSAL_PLANES, 0);
     drmDropMaster(sys->drm_fd);
     vlc_close(sys->drm_fd);
@@ -584,6 +827,22 @@ static int OpenDisplay(vout_display_t *vd)
     if (!found_connector)
         goto err_out;
 
+    SetupSpuPlane(vd);
+
+    /*
+     * prefer atomic commits so that the video plane and the SPU overlay
+     * plane are always updated within the same vblank.
+     */
+    if (drmSetClientCap(sys->drm_fd, DRM_CLIENT_CAP_ATOMIC, 1) == 0
+     && FindPlaneProperties(sys, sys->plane_id, &sys->plane_props)
+     && (sys->spu_plane_id == 0
+      || FindPlaneProperties(sys, sys->spu_plane_id, &sys->spu_plane_props))) {
+        sys->has_atomic = true;
+        msg_Dbg(vd, "Using atomic modesetting");
+    } else {
+        msg_Dbg(vd, "Atomic modesetting not available, using legacy updates");
+    }
+
     picture_sys_t *psys = calloc(1, sizeof(*psys));
     if (psys == NULL)
         goto err_out;
@@ -634,12 +893,88 @@ static int Control(vout_display_t *vd, int query, va_list args)
 }
 
 
+static void PrepareSpu(vout_display_t *vd, subpicture_t *subpic)
+{
+    vout_display_sys_t *sys = vd->sys;
+
+    if (subpic == NULL) {
+        if (sys->spu_visible) {
+            memset(sys->spu_map, 0, sys->spu_size);
+            sys->spu_visible = false;
+        }
+        return;
+    }
+
+    /*
+     * regions of the same subpicture are already composed into the
+     * overlay, it keeps scanning out unchanged.
+     */
+    if (sys->spu_visible && subpic->i_order == sys->spu_order)
+        return;
+
+    memset(sys->spu_map, 0, sys->spu_size);
+    picture_BlendSubpicture(sys->spu_picture, sys->spu_blend, subpic);
+    sys->spu_order = subpic->i_order;
+    sys->spu_visible = true;
+}
+
+
 static void Prepare(vout_display_t *vd, picture_t *pic, subpicture_t *subpic,
                     vlc_tick_t date)
 {
-    VLC_UNUSED(subpic); VLC_UNUSED(date);
+    VLC_UNUSED(date);
     vout_display_sys_t *sys = vd->sys;
     picture_Copy( sys->picture, pic );
+
+    if (sys->spu_plane_id != 0)
+        PrepareSpu(vd, subpic);
+    else
+        VLC_UNUSED(subpic);
+}
+
+
+static int CommitPlanes(vout_display_t *vd)
+{
+    vout_display_sys_t *sys = vd->sys;
+    drmModeAtomicReq *req;
+    int ret = -1;
+
+    if (!sys->has_atomic) {
+        ret = drmModeSetPlane(sys->drm_fd, sys->plane_id, sys->crtc,
+                              sys->fb[sys->front_buf], 0,
+                              0, 0, sys->width, sys->height,
+                              0, 0, sys->width << 16, sys->height << 16);
+        if (ret == 0 && sys->spu_plane_id != 0)
+            drmModeSetPlane(sys->drm_fd, sys->spu_plane_id, sys->crtc,
+                            sys->spu_visible ? sys->spu_fb : 0, 0,
+                            0, 0, sys->width, sys->height,
+                            0, 0, sys->width << 16, sys->height << 16);
+        return ret;
+    }
+
+    req = drmModeAtomicAlloc();
+    if (req == NULL)
+        return -1;
+
+    ret = AddPlaneState(req, sys->plane_id, &sys->plane_props,
+                        sys->fb[sys->front_buf], sys->crtc,
+                        sys->width, sys->height);
+
+    if (ret == 0 && sys->spu_plane_id != 0) {
+        if (sys->spu_visible)
+            ret = AddPlaneState(req, sys->spu_plane_id, &sys->spu_plane_props,
+                                sys->spu_fb, sys->crtc,
+                                sys->width, sys->height);
+        else
+            ret = AddPlaneState(req, sys->spu_plane_id, &sys->spu_plane_props,
+                                0, 0, 0, 0);
+    }
+
+    if (ret == 0)
+        ret = drmModeAtomicCommit(sys->drm_fd, req, 0, NULL);
+
+    drmModeAtomicFree(req);
+    return ret;
 }
 
 
@@ -649,10 +984,7 @@ static void Display(vout_display_t *vd, picture_t *picture)
     vout_display_sys_t *sys = vd->sys;
     int i;
 
-    if (drmModeSetPlane(sys->drm_fd, sys->plane_id, sys->crtc,
-                         sys->fb[sys->front_buf], 0,
-                         0, 0, sys->width, sys->height,
-                         0, 0, sys->width << 16, sys->height << 16)) {
+    if (CommitPlanes(vd)) {
         msg_Err(vd, "Cannot do set plane for plane id %u, fb %x",
                 sys->plane_id,
                 sys->fb[sys->front_buf]);
@@ -674,6 +1006,12 @@ static void Close(vout_display_t *vd)
 {
     vout_display_sys_t *sys = vd->sys;
 
+    if (sys->spu_blend)
+        filter_DeleteBlend(sys->spu_blend);
+
+    if (sys->spu_picture)
+        picture_Release(sys->spu_picture);
+
     if (sys->picture)
         picture_Release(sys->picture);
 
@@ -751,6 +1089,9 @@ static int Open(vout_display_t *vd, const vout_display_cfg_t *cfg,
     fmt.i_chroma = sys->vlc_fourcc;
     *fmtp = fmt;
 
+    if (sys->spu_plane_id != 0)
+        vd->info.subpicture_chromas = spu_chromas;
+
     vd->prepare = Prepare;
     vd->display = Display;
     vd->control = Control;
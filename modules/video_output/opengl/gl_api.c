@@ -111,6 +111,10 @@ vlc_gl_api_Init(struct vlc_gl_api *api, vlc_gl_t *gl)
     GET_PROC_ADDR(UseProgram);
     GET_PROC_ADDR(DeleteProgram);
 
+    GET_PROC_ADDR_OPTIONAL(GetProgramBinary);
+    GET_PROC_ADDR_OPTIONAL(ProgramBinary);
+    GET_PROC_ADDR_OPTIONAL(ProgramParameteri);
+
     GET_PROC_ADDR(ActiveTexture);
 
     GET_PROC_ADDR(GenBuffers);
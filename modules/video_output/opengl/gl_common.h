@@ -94,6 +94,24 @@
 #ifndef GL_DYNAMIC_DRAW
 # define GL_DYNAMIC_DRAW 0x88E8
 #endif
+#ifndef GL_MAP_WRITE_BIT
+# define GL_MAP_WRITE_BIT 0x0002
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+# define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+# define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+# define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+# define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+#ifndef GL_TIMEOUT_EXPIRED
+# define GL_TIMEOUT_EXPIRED 0x911B
+#endif
 
 #ifndef GL_READ_FRAMEBUFFER
 # define GL_READ_FRAMEBUFFER 0x8CA8
@@ -147,6 +165,18 @@
 # define GL_COLOR_ATTACHMENT7 0x8CE7
 #endif
 
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+# define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+
+#ifndef GL_PROGRAM_BINARY_LENGTH
+# define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+# define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
 #ifndef APIENTRY
 # define APIENTRY
 #endif
@@ -258,6 +288,9 @@ typedef GLboolean (APIENTRY *PFNGLUNMAPBUFFERPROC) (GLenum target);
 typedef GLsync (APIENTRY *PFNGLFENCESYNCPROC) (GLenum condition, GLbitfield flags);
 typedef void (APIENTRY *PFNGLDELETESYNCPROC) (GLsync sync);
 typedef GLenum (APIENTRY *PFNGLCLIENTWAITSYNCPROC) (GLsync sync, GLbitfield flags, GLuint64 timeout);
+typedef void (APIENTRY *PFNGLGETPROGRAMBINARYPROC) (GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary);
+typedef void (APIENTRY *PFNGLPROGRAMBINARYPROC) (GLuint program, GLenum binaryFormat, const void *binary, GLsizei length);
+typedef void (APIENTRY *PFNGLPROGRAMPARAMETERIPROC) (GLuint program, GLenum pname, GLint value);
 #endif
 
 /**
@@ -332,6 +365,11 @@ typedef struct {
     PFNGLUSEPROGRAMPROC    UseProgram;
     PFNGLDELETEPROGRAMPROC DeleteProgram;
 
+    /* Program binary commands (GL >= 4.1, GLES >= 3.0) */
+    PFNGLGETPROGRAMBINARYPROC  GetProgramBinary; /* can be NULL */
+    PFNGLPROGRAMBINARYPROC     ProgramBinary; /* can be NULL */
+    PFNGLPROGRAMPARAMETERIPROC ProgramParameteri; /* can be NULL */
+
     /* Texture commands */
     PFNGLACTIVETEXTUREPROC ActiveTexture;
 
@@ -25,6 +25,12 @@
 
 #include "gl_util.h"
 
+#include <vlc_configuration.h>
+#include <vlc_fs.h>
+#include <vlc_hash.h>
+#include <vlc_strings.h>
+#include <vlc_variables.h>
+
 static void
 LogShaderErrors(vlc_object_t *obj, const opengl_vtable_t *vt, GLuint id)
 {
@@ -86,6 +92,165 @@ CreateShader(vlc_object_t *obj, const opengl_vtable_t *vt, GLenum type,
     return shader;
 }
 
+/* Sanity limit for cached program binaries */
+#define PROGRAM_CACHE_MAX_SIZE (16 * 1024 * 1024)
+
+static char *
+GetProgramCachePath(const opengl_vtable_t *vt,
+                    GLsizei vstring_count, const GLchar **vstrings,
+                    GLsizei fstring_count, const GLchar **fstrings)
+{
+    /* A program binary is only valid for the driver which produced it, so
+     * key the cache file on the driver identification strings in addition to
+     * the shader sources. */
+    static const GLenum driver_ids[] = {
+        GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION,
+    };
+
+    vlc_hash_md5_t md5;
+    vlc_hash_md5_Init(&md5);
+
+    for (size_t i = 0; i < ARRAY_SIZE(driver_ids); ++i)
+    {
+        const char *str = (const char *) vt->GetString(driver_ids[i]);
+        if (str)
+            vlc_hash_md5_Update(&md5, str, strlen(str) + 1);
+    }
+
+    for (GLsizei i = 0; i < vstring_count; ++i)
+        vlc_hash_md5_Update(&md5, vstrings[i], strlen(vstrings[i]) + 1);
+    /* Separate the shaders, so that moving source code from one to the other
+     * changes the key */
+    vlc_hash_md5_Update(&md5, "|", 1);
+    for (GLsizei i = 0; i < fstring_count; ++i)
+        vlc_hash_md5_Update(&md5, fstrings[i], strlen(fstrings[i]) + 1);
+
+    char digest[VLC_HASH_MD5_DIGEST_HEX_SIZE];
+    vlc_hash_FinishHex(&md5, digest);
+
+    char *cache_dir = config_GetUserDir(VLC_CACHE_DIR);
+    if (!cache_dir)
+        return NULL;
+
+    char *path;
+    if (asprintf(&path, "%s" DIR_SEP "glprograms" DIR_SEP "%s.bin",
+                 cache_dir, digest) == -1)
+        path = NULL;
+    free(cache_dir);
+    return path;
+}
+
+static GLuint
+LoadCachedProgram(vlc_object_t *obj, const opengl_vtable_t *vt,
+                  const char *path)
+{
+    FILE *stream = vlc_fopen(path, "rb");
+    if (!stream)
+        return 0;
+
+    GLuint program = 0;
+    uint32_t binary_format;
+    void *binary = NULL;
+
+    if (fseek(stream, 0, SEEK_END))
+        goto end;
+    long size = ftell(stream);
+    if (size <= (long) sizeof (binary_format) || size > PROGRAM_CACHE_MAX_SIZE
+     || fseek(stream, 0, SEEK_SET))
+        goto end;
+
+    size_t binary_size = size - sizeof (binary_format);
+    binary = malloc(binary_size);
+    if (!binary)
+        goto end;
+
+    if (fread(&binary_format, sizeof (binary_format), 1, stream) != 1
+     || fread(binary, binary_size, 1, stream) != 1)
+        goto end;
+
+    program = vt->CreateProgram();
+    if (!program)
+        goto end;
+
+    vt->ProgramBinary(program, binary_format, binary, binary_size);
+
+    GLint linked;
+    vt->GetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked)
+    {
+        /* Stale binary (typically a driver update): recompile from source */
+        vt->DeleteProgram(program);
+        program = 0;
+    }
+    else
+        msg_Dbg(obj, "reloaded cached program binary from %s", path);
+
+end:
+    free(binary);
+    fclose(stream);
+    return program;
+}
+
+static void
+SaveCachedProgram(vlc_object_t *obj, const opengl_vtable_t *vt,
+                  GLuint program, const char *path)
+{
+    GLint length;
+    vt->GetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0 || length > PROGRAM_CACHE_MAX_SIZE)
+        return;
+
+    void *binary = malloc(length);
+    if (!binary)
+        return;
+
+    GLsizei written = 0;
+    GLenum format = 0;
+    vt->GetProgramBinary(program, length, &written, &format, binary);
+    if (written <= 0)
+    {
+        free(binary);
+        return;
+    }
+
+    char *cache_dir = config_GetUserDir(VLC_CACHE_DIR);
+    if (cache_dir)
+    {
+        char *subdir;
+        if (asprintf(&subdir, "%s" DIR_SEP "glprograms", cache_dir) != -1)
+        {
+            vlc_mkdir(cache_dir, 0700);
+            vlc_mkdir(subdir, 0700);
+            free(subdir);
+        }
+        free(cache_dir);
+    }
+
+    /* Write to a temporary file then rename, so that a concurrent load never
+     * sees a partially written binary */
+    char *tmp;
+    if (asprintf(&tmp, "%s.tmp", path) == -1)
+    {
+        free(binary);
+        return;
+    }
+
+    FILE *stream = vlc_fopen(tmp, "wb");
+    if (stream)
+    {
+        uint32_t binary_format = format;
+        bool ok =
+            fwrite(&binary_format, sizeof (binary_format), 1, stream) == 1
+         && fwrite(binary, written, 1, stream) == 1;
+        ok = !fclose(stream) && ok;
+        if (ok && vlc_rename(tmp, path) == 0)
+            msg_Dbg(obj, "saved program binary to %s", path);
+        else
+            vlc_unlink(tmp);
+    }
+    free(tmp);
+    free(binary);
+}
 
 GLuint
 vlc_gl_BuildProgram(vlc_object_t *obj, const opengl_vtable_t *vt,
@@ -94,10 +259,29 @@ vlc_gl_BuildProgram(vlc_object_t *obj, const opengl_vtable_t *vt,
 {
     GLuint program = 0;
 
+    bool use_cache = vt->GetProgramBinary != NULL && vt->ProgramBinary != NULL
+                  && var_InheritBool(obj, "gl-program-cache");
+    char *cache_path = use_cache
+        ? GetProgramCachePath(vt, vstring_count, vstrings,
+                              fstring_count, fstrings)
+        : NULL;
+    if (cache_path)
+    {
+        program = LoadCachedProgram(obj, vt, cache_path);
+        if (program)
+        {
+            free(cache_path);
+            return program;
+        }
+    }
+
     GLuint vertex_shader = CreateShader(obj, vt, GL_VERTEX_SHADER,
                                         vstring_count, vstrings);
     if (!vertex_shader)
+    {
+        free(cache_path);
         return 0;
+    }
 
     GLuint fragment_shader = CreateShader(obj, vt, GL_FRAGMENT_SHADER,
                                           fstring_count, fstrings);
@@ -111,6 +295,10 @@ vlc_gl_BuildProgram(vlc_object_t *obj, const opengl_vtable_t *vt,
     vt->AttachShader(program, vertex_shader);
     vt->AttachShader(program, fragment_shader);
 
+    if (cache_path && vt->ProgramParameteri)
+        vt->ProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                              GL_TRUE);
+
     vt->LinkProgram(program);
 
     LogProgramErrors(obj, vt, program);
@@ -123,11 +311,14 @@ vlc_gl_BuildProgram(vlc_object_t *obj, const opengl_vtable_t *vt,
         vt->DeleteProgram(program);
         program = 0;
     }
+    else if (cache_path)
+        SaveCachedProgram(obj, vt, program, cache_path);
 
 finally_2:
     vt->DeleteShader(fragment_shader);
 finally_1:
     vt->DeleteShader(vertex_shader);
+    free(cache_path);
 
     return program;
 }
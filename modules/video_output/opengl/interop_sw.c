@@ -34,8 +34,14 @@
 typedef struct
 {
     PFNGLDELETEBUFFERSPROC DeleteBuffers;
+    PFNGLBINDBUFFERPROC    BindBuffer;
+    PFNGLUNMAPBUFFERPROC   UnmapBuffer;
+    PFNGLDELETESYNCPROC    DeleteSync;
     GLuint      buffers[PICTURE_PLANE_MAX];
     size_t      bytes[PICTURE_PLANE_MAX];
+    /* GL_ARB_buffer_storage persistent mapping */
+    void       *mapped[PICTURE_PLANE_MAX];
+    GLsync      fence;
 } picture_sys_t;
 
 struct priv
@@ -54,6 +60,16 @@ pbo_picture_destroy(picture_t *pic)
 {
     picture_sys_t *picsys = pic->p_sys;
 
+    if (picsys->fence != NULL)
+        picsys->DeleteSync(picsys->fence);
+
+    for (int i = 0; i < pic->i_planes; ++i)
+        if (picsys->mapped[i] != NULL)
+        {
+            picsys->BindBuffer(GL_PIXEL_UNPACK_BUFFER, picsys->buffers[i]);
+            picsys->UnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        }
+
     picsys->DeleteBuffers(pic->i_planes, picsys->buffers);
 
     free(picsys);
@@ -79,6 +95,9 @@ pbo_picture_create(const struct vlc_gl_interop *interop)
 
     interop->vt->GenBuffers(pic->i_planes, picsys->buffers);
     picsys->DeleteBuffers = interop->vt->DeleteBuffers;
+    picsys->BindBuffer = interop->vt->BindBuffer;
+    picsys->UnmapBuffer = interop->vt->UnmapBuffer;
+    picsys->DeleteSync = interop->vt->DeleteSync;
 
     /* XXX: needed since picture_NewFromResource override pic planes */
     if (picture_Setup(pic, &interop->fmt))
@@ -128,8 +147,40 @@ pbo_data_alloc(const struct vlc_gl_interop *interop, picture_t *pic)
     return VLC_SUCCESS;
 }
 
+/* Immutable GPU-visible storage, persistently mapped into our address
+ * space: filling the picture is a plain memcpy (or a direct decoder write)
+ * and the driver never has to stage the data through a second copy. */
 static int
-pbo_pics_alloc(const struct vlc_gl_interop *interop)
+persistent_data_alloc(const struct vlc_gl_interop *interop, picture_t *pic)
+{
+    picture_sys_t *picsys = pic->p_sys;
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT
+                           | GL_MAP_COHERENT_BIT;
+
+    interop->vt->GetError();
+
+    for (int i = 0; i < pic->i_planes; ++i)
+    {
+        interop->vt->BindBuffer(GL_PIXEL_UNPACK_BUFFER, picsys->buffers[i]);
+        interop->vt->BufferStorage(GL_PIXEL_UNPACK_BUFFER, picsys->bytes[i],
+                                   NULL, flags);
+        picsys->mapped[i] =
+            interop->vt->MapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0,
+                                        picsys->bytes[i], flags);
+
+        if (picsys->mapped[i] == NULL
+         || interop->vt->GetError() != GL_NO_ERROR)
+        {
+            msg_Err(interop->gl, "could not map PBO buffers");
+            return VLC_EGENERIC;
+        }
+        pic->p[i].p_pixels = picsys->mapped[i];
+    }
+    return VLC_SUCCESS;
+}
+
+static int
+pbo_pics_alloc(const struct vlc_gl_interop *interop, bool persistent)
 {
     struct priv *priv = interop->priv;
     for (size_t i = 0; i < PBO_DISPLAY_COUNT; ++i)
@@ -139,7 +190,9 @@ pbo_pics_alloc(const struct vlc_gl_interop *interop)
         if (pic == NULL)
             goto error;
 
-        if (pbo_data_alloc(interop, pic) != VLC_SUCCESS)
+        int ret = persistent ? persistent_data_alloc(interop, pic)
+                             : pbo_data_alloc(interop, pic);
+        if (ret != VLC_SUCCESS)
             goto error;
     }
 
@@ -149,7 +202,10 @@ pbo_pics_alloc(const struct vlc_gl_interop *interop)
     return VLC_SUCCESS;
 error:
     for (size_t i = 0; i < PBO_DISPLAY_COUNT && priv->pbo.display_pics[i]; ++i)
+    {
         picture_Release(priv->pbo.display_pics[i]);
+        priv->pbo.display_pics[i] = NULL;
+    }
     return VLC_EGENERIC;
 }
 
@@ -190,6 +246,60 @@ tc_pbo_update(const struct vlc_gl_interop *interop, GLuint *textures,
     return VLC_SUCCESS;
 }
 
+static int
+tc_persistent_update(const struct vlc_gl_interop *interop, GLuint *textures,
+                     const GLsizei *tex_width, const GLsizei *tex_height,
+                     picture_t *pic, const size_t *plane_offset)
+{
+    (void) plane_offset; assert(plane_offset == NULL);
+    struct priv *priv = interop->priv;
+
+    picture_t *display_pic = priv->pbo.display_pics[priv->pbo.display_idx];
+    picture_sys_t *p_sys = display_pic->p_sys;
+    priv->pbo.display_idx = (priv->pbo.display_idx + 1) % PBO_DISPLAY_COUNT;
+
+    /* Wait until the GPU is done sampling from this buffer before
+     * overwriting the mapping */
+    if (p_sys->fence != NULL)
+    {
+        while (interop->vt->ClientWaitSync(p_sys->fence,
+                                           GL_SYNC_FLUSH_COMMANDS_BIT,
+                                           10000000 /* ns */)
+                   == GL_TIMEOUT_EXPIRED);
+        interop->vt->DeleteSync(p_sys->fence);
+        p_sys->fence = NULL;
+    }
+
+    for (int i = 0; i < pic->i_planes; i++)
+    {
+        const plane_t *src = &pic->p[i];
+        const plane_t *dst = &display_pic->p[i];
+
+        /* No-op when the decoder rendered straight into the mapping */
+        if (src->p_pixels != dst->p_pixels)
+            plane_CopyPixels(&display_pic->p[i], &pic->p[i]);
+
+        interop->vt->BindBuffer(GL_PIXEL_UNPACK_BUFFER, p_sys->buffers[i]);
+
+        interop->vt->ActiveTexture(GL_TEXTURE0 + i);
+        interop->vt->BindTexture(interop->tex_target, textures[i]);
+
+        interop->vt->PixelStorei(GL_UNPACK_ROW_LENGTH, dst->i_pitch
+            * tex_width[i] / (dst->i_visible_pitch ? dst->i_visible_pitch : 1));
+
+        interop->vt->TexSubImage2D(interop->tex_target, 0, 0, 0, tex_width[i], tex_height[i],
+                                   interop->texs[i].format, interop->texs[i].type, NULL);
+        interop->vt->PixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+
+    p_sys->fence = interop->vt->FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    /* turn off pbo */
+    interop->vt->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    return VLC_SUCCESS;
+}
+
 static int
 tc_common_allocate_textures(const struct vlc_gl_interop *interop, GLuint *textures,
                             const GLsizei *tex_width, const GLsizei *tex_height)
@@ -374,9 +484,27 @@ opengl_interop_generic_init(struct vlc_gl_interop *interop, bool allow_dr)
             (vlc_gl_StrHasToken(interop->api->extensions, "GL_ARB_pixel_buffer_object") ||
              vlc_gl_StrHasToken(interop->api->extensions, "GL_EXT_pixel_buffer_object"));
 
+        /* Persistent mapping needs GL_ARB_buffer_storage and sync objects */
+        const bool has_storage = glver_ok &&
+            vlc_gl_StrHasToken(interop->api->extensions, "GL_ARB_buffer_storage") &&
+            interop->vt->BufferStorage && interop->vt->MapBufferRange &&
+            interop->vt->UnmapBuffer && interop->vt->FenceSync &&
+            interop->vt->DeleteSync && interop->vt->ClientWaitSync;
+        if (has_storage && pbo_pics_alloc(interop, true) == VLC_SUCCESS)
+        {
+            static const struct vlc_gl_interop_ops persistent_ops = {
+                .allocate_textures = tc_common_allocate_textures,
+                .update_textures = tc_persistent_update,
+                .close = opengl_interop_generic_deinit,
+            };
+            interop->ops = &persistent_ops;
+            msg_Dbg(interop->gl, "persistent PBO mapping enabled");
+            return VLC_SUCCESS;
+        }
+
         const bool supports_pbo = has_pbo && interop->vt->BufferData
             && interop->vt->BufferSubData;
-        if (supports_pbo && pbo_pics_alloc(interop) == VLC_SUCCESS)
+        if (supports_pbo && pbo_pics_alloc(interop, false) == VLC_SUCCESS)
         {
             static const struct vlc_gl_interop_ops pbo_ops = {
                 .allocate_textures = tc_common_allocate_textures,
@@ -80,8 +80,15 @@
 #define GLINTEROP_LONGTEXT N_( \
     "Force a \"glinterop\" module.")
 
+#define GL_PROGRAM_CACHE_TEXT N_("Cache GL programs on disk")
+#define GL_PROGRAM_CACHE_LONGTEXT N_( \
+    "Reuse linked program binaries from the cache directory instead of " \
+    "recompiling the shaders on every video output start.")
+
 #define add_glopts() \
     add_module("glinterop", "glinterop", NULL, GLINTEROP_TEXT, GLINTEROP_LONGTEXT) \
+    add_bool("gl-program-cache", true, GL_PROGRAM_CACHE_TEXT, \
+             GL_PROGRAM_CACHE_LONGTEXT, true) \
     add_glopts_placebo ()
 
 typedef struct vout_display_opengl_t vout_display_opengl_t;
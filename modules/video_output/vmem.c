@@ -96,6 +96,8 @@ struct vout_display_sys_t {
 
     unsigned pitches[PICTURE_PLANE_MAX];
     unsigned lines[PICTURE_PLANE_MAX];
+
+    picture_t *wrapper; /**< Persistent picture wrapping the locked planes */
 };
 
 typedef unsigned (*vlc_format_cb)(void **, char *, unsigned *, unsigned *,
@@ -130,6 +132,7 @@ static int Open(vout_display_t *vd, const vout_display_cfg_t *cfg,
     sys->display = var_InheritAddress(vd, "vmem-display");
     sys->cleanup = var_InheritAddress(vd, "vmem-cleanup");
     sys->opaque = var_InheritAddress(vd, "vmem-data");
+    sys->wrapper = NULL;
 
     /* Define the video format */
     video_format_t fmt;
@@ -229,6 +232,8 @@ static void Close(vout_display_t *vd)
 {
     vout_display_sys_t *sys = vd->sys;
 
+    if (sys->wrapper != NULL)
+        picture_Release(sys->wrapper);
     if (sys->cleanup)
         sys->cleanup(sys->opaque);
     free(sys);
@@ -239,22 +244,27 @@ static void Prepare(vout_display_t *vd, picture_t *pic, subpicture_t *subpic,
 {
     VLC_UNUSED(date);
     vout_display_sys_t *sys = vd->sys;
-    picture_resource_t rsc = { .p_sys = NULL };
     void *planes[PICTURE_PLANE_MAX];
 
     sys->pic_opaque = sys->lock(sys->opaque, planes);
 
-    for (unsigned i = 0; i < PICTURE_PLANE_MAX; i++) {
-        rsc.p[i].p_pixels = planes[i];
-        rsc.p[i].i_lines  = sys->lines[i];
-        rsc.p[i].i_pitch  = sys->pitches[i];
-    }
+    /* The wrapper picture only carries the plane layout: it is created
+     * once, then repointed at the locked planes on every frame. */
+    if (sys->wrapper == NULL) {
+        picture_resource_t rsc = { .p_sys = NULL };
 
-    picture_t *locked = picture_NewFromResource(&vd->fmt, &rsc);
-    if (likely(locked != NULL)) {
-        picture_CopyPixels(locked, pic);
-        picture_Release(locked);
-    }
+        for (unsigned i = 0; i < PICTURE_PLANE_MAX; i++) {
+            rsc.p[i].p_pixels = planes[i];
+            rsc.p[i].i_lines  = sys->lines[i];
+            rsc.p[i].i_pitch  = sys->pitches[i];
+        }
+        sys->wrapper = picture_NewFromResource(&vd->fmt, &rsc);
+    } else
+        for (int i = 0; i < sys->wrapper->i_planes; i++)
+            sys->wrapper->p[i].p_pixels = planes[i];
+
+    if (likely(sys->wrapper != NULL))
+        picture_CopyPixels(sys->wrapper, pic);
 
     if (sys->unlock != NULL)
         sys->unlock(sys->opaque, sys->pic_opaque, planes);
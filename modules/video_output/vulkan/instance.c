@@ -31,6 +31,17 @@
 
 #include "instance.h"
 
+/*
+ * Live Vulkan contexts, keyed by window. Creating a Vulkan device is
+ * expensive and throws away the driver's in-device pipeline caches, so
+ * as long as one user of a window keeps its context alive, further
+ * users share it instead of creating their own.
+ */
+#define VLC_VK_CACHE_SIZE 4
+
+static vlc_mutex_t cache_lock = VLC_STATIC_MUTEX;
+static vlc_vk_t *cache[VLC_VK_CACHE_SIZE];
+
 /**
  * Creates a Vulkan surface (and its underlying instance).
  *
@@ -43,6 +54,19 @@ vlc_vk_t *vlc_vk_Create(struct vout_window_t *wnd, const char *name)
     vlc_object_t *parent = (vlc_object_t *) wnd;
     struct vlc_vk_t *vk;
 
+    vlc_mutex_lock(&cache_lock);
+    for (size_t i = 0; i < VLC_VK_CACHE_SIZE; i++)
+    {
+        vk = cache[i];
+        if (vk != NULL && vk->window == wnd && name == NULL)
+        {
+            vlc_atomic_rc_inc(&vk->ref_count);
+            vlc_mutex_unlock(&cache_lock);
+            return vk;
+        }
+    }
+    vlc_mutex_unlock(&cache_lock);
+
     vk = vlc_object_create(parent, sizeof (*vk));
     if (unlikely(vk == NULL))
         return NULL;
@@ -60,6 +84,15 @@ vlc_vk_t *vlc_vk_Create(struct vout_window_t *wnd, const char *name)
     }
     vlc_atomic_rc_init(&vk->ref_count);
 
+    vlc_mutex_lock(&cache_lock);
+    for (size_t i = 0; i < VLC_VK_CACHE_SIZE; i++)
+        if (cache[i] == NULL)
+        {
+            cache[i] = vk;
+            break;
+        }
+    vlc_mutex_unlock(&cache_lock);
+
     return vk;
 }
 
@@ -70,8 +103,20 @@ void vlc_vk_Hold(vlc_vk_t *vk)
 
 void vlc_vk_Release(vlc_vk_t *vk)
 {
+    /* The cache entry must be dropped atomically with the reference
+     * count reaching zero, lest vlc_vk_Create() resurrect a context
+     * already being destroyed. */
+    vlc_mutex_lock(&cache_lock);
     if (!vlc_atomic_rc_dec(&vk->ref_count))
+    {
+        vlc_mutex_unlock(&cache_lock);
         return;
+    }
+    for (size_t i = 0; i < VLC_VK_CACHE_SIZE; i++)
+        if (cache[i] == vk)
+            cache[i] = NULL;
+    vlc_mutex_unlock(&cache_lock);
+
     module_unneed(vk, vk->module);
     vlc_object_delete(vk);
 }
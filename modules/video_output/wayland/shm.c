@@ -43,6 +43,25 @@
 #include <vlc_fs.h>
 
 #define MAX_PICTURES 4
+#define MAX_BUFFERS 16
+
+/*
+ * Cached server-side buffer over one picture of the pool. Creating the
+ * buffer (and especially the wl_shm_pool it is cut from) per frame forces
+ * the compositor to remap the memory every frame, so buffers are created
+ * once per picture and reused until close or format reset.
+ */
+struct buffer_cache_entry
+{
+    struct wl_buffer *buffer;
+    int fd;
+    off_t offset;
+    size_t stride;
+    unsigned width;
+    unsigned height;
+    picture_t *picture; /* held until the server releases the buffer */
+    size_t *counter;
+};
 
 struct vout_display_sys_t
 {
@@ -53,6 +72,7 @@ struct vout_display_sys_t
     struct wp_viewport *viewport;
 
     size_t active_buffers;
+    struct buffer_cache_entry buffers[MAX_BUFFERS];
 
     unsigned display_width;
     unsigned display_height;
@@ -82,6 +102,82 @@ static const struct wl_buffer_listener buffer_cbs =
     buffer_release_cb,
 };
 
+static void buffer_cache_release_cb(void *data, struct wl_buffer *buffer)
+{
+    struct buffer_cache_entry *entry = data;
+
+    picture_Release(entry->picture);
+    entry->picture = NULL;
+    (*(entry->counter))--;
+    (void) buffer; /* kept for reuse */
+}
+
+static const struct wl_buffer_listener buffer_cache_cbs =
+{
+    buffer_cache_release_cb,
+};
+
+/**
+ * Looks up (or creates) the cached wl_buffer for a picture of the pool.
+ * Returns NULL if the cache cannot serve the picture; the caller then
+ * falls back to a single-use buffer.
+ */
+static struct buffer_cache_entry *GetCachedBuffer(vout_display_sys_t *sys,
+                                                  int fd, off_t offset,
+                                                  size_t stride, size_t size,
+                                                  unsigned width,
+                                                  unsigned height)
+{
+    struct buffer_cache_entry *entry, *slot = NULL;
+
+    for (size_t i = 0; i < MAX_BUFFERS; i++)
+    {
+        entry = sys->buffers + i;
+
+        if (entry->buffer != NULL && entry->fd == fd
+         && entry->offset == offset && entry->stride == stride
+         && entry->width == width && entry->height == height)
+        {
+            /* The server has not released the buffer yet. */
+            if (entry->picture != NULL)
+                return NULL;
+            return entry;
+        }
+
+        if (slot == NULL && (entry->buffer == NULL || entry->picture == NULL))
+            slot = entry;
+    }
+
+    if (slot == NULL)
+        return NULL;
+
+    if (slot->buffer != NULL)
+        wl_buffer_destroy(slot->buffer);
+
+    struct wl_shm_pool *pool = wl_shm_create_pool(sys->shm, fd, offset + size);
+    if (pool == NULL)
+    {
+        slot->buffer = NULL;
+        return NULL;
+    }
+
+    slot->buffer = wl_shm_pool_create_buffer(pool, offset, width, height,
+                                             stride, WL_SHM_FORMAT_XRGB8888);
+    wl_shm_pool_destroy(pool);
+    if (slot->buffer == NULL)
+        return NULL;
+
+    slot->fd = fd;
+    slot->offset = offset;
+    slot->stride = stride;
+    slot->width = width;
+    slot->height = height;
+    slot->picture = NULL;
+    slot->counter = &sys->active_buffers;
+    wl_buffer_add_listener(slot->buffer, &buffer_cache_cbs, slot);
+    return slot;
+}
+
 static void Prepare(vout_display_t *vd, picture_t *pic, subpicture_t *subpic,
                     vlc_tick_t date)
 {
@@ -94,43 +190,57 @@ static void Prepare(vout_display_t *vd, picture_t *pic, subpicture_t *subpic,
     if (picbuf->fd == -1)
         return;
 
-    struct buffer_data *d = malloc(sizeof (*d));
-    if (unlikely(d == NULL))
-        return;
-
-    d->picture = pic;
-    d->counter = &sys->active_buffers;
-
     off_t offset = picbuf->offset;
     const size_t stride = pic->p->i_pitch;
     const size_t size = pic->p->i_lines * stride;
-    struct wl_shm_pool *pool;
     struct wl_buffer *buf;
 
-    pool = wl_shm_create_pool(sys->shm, picbuf->fd, offset + size);
-    if (pool == NULL)
-    {
-        free(d);
-        return;
-    }
-
     if (sys->viewport == NULL) /* Poor man's crop */
         offset += 4 * vd->fmt.i_x_offset
                   + pic->p->i_pitch * vd->fmt.i_y_offset;
 
-    buf = wl_shm_pool_create_buffer(pool, offset, vd->fmt.i_visible_width,
-                                    vd->fmt.i_visible_height, stride,
-                                    WL_SHM_FORMAT_XRGB8888);
-    wl_shm_pool_destroy(pool);
-    if (buf == NULL)
+    struct buffer_cache_entry *entry;
+
+    entry = GetCachedBuffer(sys, picbuf->fd, offset, stride, size,
+                            vd->fmt.i_visible_width, vd->fmt.i_visible_height);
+    if (entry != NULL)
     {
-        free(d);
-        return;
+        picture_Hold(pic);
+        entry->picture = pic;
+        buf = entry->buffer;
     }
+    else
+    {   /* Cache miss: single-use buffer, destroyed upon release */
+        struct buffer_data *d = malloc(sizeof (*d));
+        if (unlikely(d == NULL))
+            return;
+
+        d->picture = pic;
+        d->counter = &sys->active_buffers;
 
-    picture_Hold(pic);
+        struct wl_shm_pool *pool;
+
+        pool = wl_shm_create_pool(sys->shm, picbuf->fd, offset + size);
+        if (pool == NULL)
+        {
+            free(d);
+            return;
+        }
+
+        buf = wl_shm_pool_create_buffer(pool, offset, vd->fmt.i_visible_width,
+                                        vd->fmt.i_visible_height, stride,
+                                        WL_SHM_FORMAT_XRGB8888);
+        wl_shm_pool_destroy(pool);
+        if (buf == NULL)
+        {
+            free(d);
+            return;
+        }
+
+        picture_Hold(pic);
+        wl_buffer_add_listener(buf, &buffer_cbs, d);
+    }
 
-    wl_buffer_add_listener(buf, &buffer_cbs, d);
     wl_surface_attach(surface, buf, 0, 0);
     wl_surface_damage(surface, 0, 0, sys->display_width, sys->display_height);
     wl_display_flush(display);
@@ -254,6 +364,10 @@ static void Close(vout_display_t *vd)
     }
     msg_Dbg(vd, "no active buffers left");
 
+    for (size_t i = 0; i < MAX_BUFFERS; i++)
+        if (sys->buffers[i].buffer != NULL)
+            wl_buffer_destroy(sys->buffers[i].buffer);
+
     if (sys->viewport != NULL)
         wp_viewport_destroy(sys->viewport);
     if (sys->viewporter != NULL)
@@ -279,6 +393,7 @@ static int Open(vout_display_t *vd, const vout_display_cfg_t *cfg,
     sys->eventq = NULL;
     sys->shm = NULL;
     sys->active_buffers = 0;
+    memset(sys->buffers, 0, sizeof (sys->buffers));
     sys->display_width = cfg->display.width;
     sys->display_height = cfg->display.height;
 
@@ -248,16 +248,50 @@ static void Close( vlc_object_t *p_this )
     free( p_sys );
 }
 
-static int Filter( video_splitter_t *p_splitter, picture_t *pp_dst[], picture_t *p_src )
+/* Outputs are reference-counted crop views into the source picture: they
+ * share its planes instead of copying them, and each view holds a
+ * reference on the source until it is released. */
+static void DeleteView( picture_t *p_picture )
 {
-    video_splitter_sys_t *p_sys = p_splitter->p_sys;
+    picture_t *p_src = p_picture->p_sys;
+
+    picture_Release( p_src );
+}
+
+static picture_t *NewView( const video_format_t *p_fmt, picture_t *p_src,
+                           int i_left, int i_top )
+{
+    picture_resource_t rsc = {
+        .p_sys = p_src,
+        .pf_destroy = DeleteView,
+    };
 
-    if( video_splitter_NewPicture( p_splitter, pp_dst ) )
+    for( int i = 0; i < p_src->i_planes; i++ )
     {
-        picture_Release( p_src );
-        return VLC_EGENERIC;
+        const plane_t *p0 = &p_src->p[0];
+        const plane_t *p = &p_src->p[i];
+        const int i_y = i_top  * p->i_visible_pitch / p0->i_visible_pitch;
+        const int i_x = i_left * p->i_visible_lines / p0->i_visible_lines;
+
+        rsc.p[i].p_pixels = p->p_pixels
+            + i_y * p->i_pitch + ( i_x - (i_x % p->i_pixel_pitch) );
+        rsc.p[i].i_lines  = p->i_lines - i_y;
+        rsc.p[i].i_pitch  = p->i_pitch;
     }
 
+    picture_t *p_dst = picture_NewFromResource( p_fmt, &rsc );
+    if( p_dst == NULL )
+        return NULL;
+
+    picture_Hold( p_src );
+    picture_CopyProperties( p_dst, p_src );
+    return p_dst;
+}
+
+static int Filter( video_splitter_t *p_splitter, picture_t *pp_dst[], picture_t *p_src )
+{
+    video_splitter_sys_t *p_sys = p_splitter->p_sys;
+
     for( int y = 0; y < p_sys->i_row; y++ )
     {
         for( int x = 0; x < p_sys->i_col; x++ )
@@ -266,20 +300,22 @@ static int Filter( video_splitter_t *p_splitter, picture_t *pp_dst[], picture_t
             if( !p_output->b_active )
                 continue;
 
-            picture_t *p_dst = pp_dst[p_output->i_output];
+            const video_format_t *p_fmt =
+                &p_splitter->p_output[p_output->i_output].fmt;
 
-            /* */
-            picture_t tmp = *p_src;
-            for( int i = 0; i < tmp.i_planes; i++ )
+            picture_t *p_dst = NewView( p_fmt, p_src,
+                                        p_output->i_left, p_output->i_top );
+            if( p_dst == NULL )
             {
-                plane_t *p0 = &tmp.p[0];
-                plane_t *p = &tmp.p[i];
-                const int i_y = p_output->i_top  * p->i_visible_pitch / p0->i_visible_pitch;
-                const int i_x = p_output->i_left * p->i_visible_lines / p0->i_visible_lines;
+                /* Outputs are numbered in scan order */
+                for( int i = 0; i < p_output->i_output; i++ )
+                    picture_Release( pp_dst[i] );
 
-                p->p_pixels += i_y * p->i_pitch + ( i_x - (i_x % p->i_pixel_pitch));
+                msg_Warn( p_splitter, "can't get output pictures" );
+                picture_Release( p_src );
+                return VLC_EGENERIC;
             }
-            picture_Copy( p_dst, &tmp );
+            pp_dst[p_output->i_output] = p_dst;
         }
     }
 
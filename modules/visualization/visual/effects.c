@@ -74,6 +74,10 @@ typedef struct spectrum_data
     int16_t *p_prev_s16_buff;
 
     window_param wind_param;
+
+    /* FFT tables and analysis window, set up once and reused */
+    fft_state *p_fft;
+    window_context wind_ctx;
 } spectrum_data;
 
 static int spectrum_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
@@ -103,9 +107,6 @@ static int spectrum_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
      110,115,121,130,141,152,163,174,185,200,255};
     const int *xscale;
 
-    fft_state *p_state;                 /* internal FFT data */
-    DEFINE_WIND_CONTEXT( wind_ctx );    /* internal window data */
-
     int i , j , y , k;
     int i_line;
     int16_t p_dest[FFT_BUFFER_SIZE];      /* Adapted FFT result */
@@ -137,6 +138,23 @@ static int spectrum_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
         p_data->p_prev_s16_buff = NULL;
 
         window_get_param( p_aout, &p_data->wind_param );
+
+        /* The FFT tables and the analysis window only depend on the
+         * (fixed) window size, so build them once for all buffers */
+        p_data->p_fft = visual_fft_init();
+        if( !p_data->p_fft ||
+            !window_init( FFT_BUFFER_SIZE, &p_data->wind_param,
+                          &p_data->wind_ctx ) )
+        {
+            msg_Err(p_aout,"unable to initialize FFT transform");
+            if( p_data->p_fft )
+                fft_close( p_data->p_fft );
+            free( p_data->peaks );
+            free( p_data->prev_heights );
+            free( p_data );
+            p_effect->p_data = NULL;
+            return -1;
+        }
     }
     peaks = (int *)p_data->peaks;
     prev_heights = (int *)p_data->prev_heights;
@@ -185,20 +203,6 @@ static int spectrum_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
 
         p_buffl++ ; p_buffs++ ;
     }
-    p_state  = visual_fft_init();
-    if( !p_state)
-    {
-        free( height );
-        msg_Err(p_aout,"unable to initialize FFT transform");
-        return -1;
-    }
-    if( !window_init( FFT_BUFFER_SIZE, &p_data->wind_param, &wind_ctx ) )
-    {
-        fft_close( p_state );
-        free( height );
-        msg_Err(p_aout,"unable to initialize FFT window");
-        return -1;
-    }
     p_buffs = p_s16_buff;
     for ( i = 0 ; i < FFT_BUFFER_SIZE ; i++)
     {
@@ -210,8 +214,8 @@ static int spectrum_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
             p_buffs = p_s16_buff;
 
     }
-    window_scale_in_place( p_buffer1, &wind_ctx );
-    fft_perform( p_buffer1, p_output, p_state);
+    window_scale_in_place( p_buffer1, &p_data->wind_ctx );
+    fft_perform( p_buffer1, p_output, p_data->p_fft );
     for( i = 0; i< FFT_BUFFER_SIZE ; i++ )
         p_dest[i] = p_output[i] *  ( 2 ^ 16 ) / ( ( FFT_BUFFER_SIZE / 2 * 32768 ) ^ 2 );
 
@@ -358,10 +362,6 @@ static int spectrum_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
         }
     }
 
-    window_close( &wind_ctx );
-
-    fft_close( p_state );
-
     free( height );
 
     return 0;
@@ -373,6 +373,8 @@ static void spectrum_Free( void *data )
 
     if( p_data != NULL )
     {
+        window_close( &p_data->wind_ctx );
+        fft_close( p_data->p_fft );
         free( p_data->peaks );
         free( p_data->prev_heights );
         free( p_data->p_prev_s16_buff );
@@ -392,6 +394,10 @@ typedef struct
     int16_t *p_prev_s16_buff;
 
     window_param wind_param;
+
+    /* FFT tables and analysis window, set up once and reused */
+    fft_state *p_fft;
+    window_context wind_ctx;
 } spectrometer_data;
 
 static int spectrometer_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
@@ -441,9 +447,6 @@ static int spectrometer_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
     const int *xscale;
     const double y_scale =  3.60673760222;  /* (log 256) */
 
-    fft_state *p_state;                 /* internal FFT data */
-    DEFINE_WIND_CONTEXT( wind_ctx );    /* internal window data */
-
     int i , j , k;
     int i_line = 0;
     int16_t p_dest[FFT_BUFFER_SIZE];      /* Adapted FFT result */
@@ -476,6 +479,21 @@ static int spectrometer_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
         p_data->i_prev_nb_samples = 0;
         p_data->p_prev_s16_buff = NULL;
         window_get_param( p_aout, &p_data->wind_param );
+
+        /* The FFT tables and the analysis window only depend on the
+         * (fixed) window size, so build them once for all buffers */
+        p_data->p_fft = visual_fft_init();
+        if( !p_data->p_fft ||
+            !window_init( FFT_BUFFER_SIZE, &p_data->wind_param,
+                          &p_data->wind_ctx ) )
+        {
+            msg_Err(p_aout,"unable to initialize FFT transform");
+            if( p_data->p_fft )
+                fft_close( p_data->p_fft );
+            free( p_data->peaks );
+            free( p_data );
+            return -1;
+        }
         p_effect->p_data = (void*)p_data;
     }
     peaks = p_data->peaks;
@@ -533,20 +551,6 @@ static int spectrometer_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
 
         p_buffl++ ; p_buffs++ ;
     }
-    p_state  = visual_fft_init();
-    if( !p_state)
-    {
-        msg_Err(p_aout,"unable to initialize FFT transform");
-        free( height );
-        return -1;
-    }
-    if( !window_init( FFT_BUFFER_SIZE, &p_data->wind_param, &wind_ctx ) )
-    {
-        fft_close( p_state );
-        free( height );
-        msg_Err(p_aout,"unable to initialize FFT window");
-        return -1;
-    }
     p_buffs = p_s16_buff;
     for ( i = 0 ; i < FFT_BUFFER_SIZE; i++)
     {
@@ -557,8 +561,8 @@ static int spectrometer_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
         if( p_buffs >= &p_s16_buff[p_buffer->i_nb_samples * p_effect->i_nb_chans] )
             p_buffs = p_s16_buff;
     }
-    window_scale_in_place( p_buffer1, &wind_ctx );
-    fft_perform( p_buffer1, p_output, p_state);
+    window_scale_in_place( p_buffer1, &p_data->wind_ctx );
+    fft_perform( p_buffer1, p_output, p_data->p_fft );
     for(i = 0; i < FFT_BUFFER_SIZE; i++)
     {
         int sqrti = sqrt(p_output[i]);
@@ -855,10 +859,6 @@ static int spectrometer_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
         }
     }
 
-    window_close( &wind_ctx );
-
-    fft_close( p_state );
-
     free( height );
 
     return 0;
@@ -870,6 +870,8 @@ static void spectrometer_Free( void *data )
 
     if( p_data != NULL )
     {
+        window_close( &p_data->wind_ctx );
+        fft_close( p_data->p_fft );
         free( p_data->peaks );
         free( p_data->p_prev_s16_buff );
         free( p_data );
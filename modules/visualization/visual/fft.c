@@ -67,11 +67,19 @@ fft_state *visual_fft_init(void)
     {
         p_state->bitReverse[i] = reverseBits(i);
     }
-    for(i = 0; i < FFT_BUFFER_SIZE / 2; i++)
+
+    /* Build the twiddle factors of each stage back to back, so that a
+     * stage can walk its factors sequentially. */
+    unsigned int offset = 0;
+    for(unsigned int half = 1; half < FFT_BUFFER_SIZE; half <<= 1)
     {
-        float j = 2 * PI * i / FFT_BUFFER_SIZE;
-        p_state->costable[i] = cos(j);
-        p_state->sintable[i] = sin(j);
+        for(i = 0; i < half; i++)
+        {
+            float j = PI * i / half;
+            p_state->costable[offset + i] = cos(j);
+            p_state->sintable[offset + i] = sin(j);
+        }
+        offset += half;
     }
 
     return p_state;
@@ -153,44 +161,33 @@ static void fft_output(const float * re, const float * im, float *output)
  */
 static void fft_calculate(float * re, float * im, const float *costable, const float *sintable )
 {
-    unsigned int i, j, k;
-    unsigned int exchanges;
-    float fact_real, fact_imag;
-    float tmp_real, tmp_imag;
-    unsigned int factfact;
-
-    /* Set up some variables to reduce calculation in the loops */
-    exchanges = 1;
-    factfact = FFT_BUFFER_SIZE / 2;
+    unsigned int half, k, j;
+    unsigned int offset = 0;
 
     /* Loop through the divide and conquer steps */
-    for(i = FFT_BUFFER_SIZE_LOG; i != 0; i--) {
-        /* In this step, we have 2 ^ (i - 1) exchange groups, each with
-         * 2 ^ (FFT_BUFFER_SIZE_LOG - i) exchanges
-         */
-        /* Loop through the exchanges in a group */
-        for(j = 0; j != exchanges; j++) {
-            /* Work out factor for this exchange
-             * factor ^ (exchanges) = -1
-             * So, real = cos(j * PI / exchanges),
-             *     imag = sin(j * PI / exchanges)
-             */
-            fact_real = costable[j * factfact];
-            fact_imag = sintable[j * factfact];
-
-            /* Loop through all the exchange groups */
-            for(k = j; k < FFT_BUFFER_SIZE; k += exchanges << 1) {
-                int k1 = k + exchanges;
-                tmp_real = fact_real * re[k1] - fact_imag * im[k1];
-                tmp_imag = fact_real * im[k1] + fact_imag * re[k1];
-                re[k1] = re[k] - tmp_real;
-                im[k1] = im[k] - tmp_imag;
-                re[k]  += tmp_real;
-                im[k]  += tmp_imag;
+    for(half = 1; half < FFT_BUFFER_SIZE; half <<= 1) {
+        /* Twiddle factors of this stage, stored sequentially:
+         * real = cos(j * PI / half), imag = sin(j * PI / half) */
+        const float *fact_real = costable + offset;
+        const float *fact_imag = sintable + offset;
+
+        /* Loop through the exchange groups */
+        for(k = 0; k < FFT_BUFFER_SIZE; k += half << 1) {
+            float *re_lo = re + k, *im_lo = im + k;
+            float *re_hi = re_lo + half, *im_hi = im_lo + half;
+
+            /* The butterflies of a group touch contiguous elements and
+             * contiguous twiddle factors, so this loop vectorizes. */
+            for(j = 0; j < half; j++) {
+                float tmp_real = fact_real[j] * re_hi[j] - fact_imag[j] * im_hi[j];
+                float tmp_imag = fact_real[j] * im_hi[j] + fact_imag[j] * re_hi[j];
+                re_hi[j] = re_lo[j] - tmp_real;
+                im_hi[j] = im_lo[j] - tmp_imag;
+                re_lo[j] += tmp_real;
+                im_lo[j] += tmp_imag;
             }
         }
-        exchanges <<= 1;
-        factfact >>= 1;
+        offset += half;
     }
 }
 
@@ -39,10 +39,11 @@ struct _struct_fft_state {
      /* */
      unsigned int bitReverse[FFT_BUFFER_SIZE];
 
-     /* The next two tables could be made to use less space in memory, since they
-      * overlap hugely, but hey. */
-     float sintable[FFT_BUFFER_SIZE / 2];
-     float costable[FFT_BUFFER_SIZE / 2];
+     /* Twiddle factors, stored contiguously for each divide and conquer
+      * stage so the butterfly inner loop reads them with unit stride. Stage
+      * s (of size 2 ^ s) starts at offset 2 ^ s - 1. */
+     float sintable[FFT_BUFFER_SIZE];
+     float costable[FFT_BUFFER_SIZE];
 };
 
 /* FFT prototypes */
@@ -48,6 +48,8 @@ typedef struct
     aout_filters_t *filters;
     aout_volume_t *volume;
     bool bitexact;
+    bool keep_output; /**< Keep the output started between streams (gapless) */
+    bool output_kept; /**< Output started but no stream attached */
 
     struct
     {
@@ -69,6 +71,8 @@ typedef struct
         float rate; /**< Play-out speed rate */
         vlc_tick_t resamp_start_drift; /**< Resampler drift absolute value */
         int resamp_type; /**< Resampler mode (FIXME: redundant / resampling) */
+        bool trim; /**< Correct drift at block boundaries, not by resampling */
+        vlc_tick_t trim_remain; /**< Drift left to trim at block boundaries */
         bool discontinuity;
         vlc_tick_t request_delay;
         vlc_tick_t delay;
@@ -98,6 +102,9 @@ typedef struct
     atomic_uint buffers_played;
     atomic_uchar restart;
 
+    /* Event tracer of the instance, NULL when tracing is disabled */
+    struct vlc_tracer *tracer;
+
     vlc_atomic_rc_t rc;
 } aout_owner_t;
 
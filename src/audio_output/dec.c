@@ -33,6 +33,7 @@
 
 #include <vlc_common.h>
 #include <vlc_aout.h>
+#include <vlc_tracer.h>
 
 #include "aout_internal.h"
 #include "clock/clock.h"
@@ -88,20 +89,45 @@ int aout_DecNew(audio_output_t *p_aout, const audio_sample_format_t *p_format,
 
     aout_owner_t *owner = aout_owner(p_aout);
 
+    /* Reuse an output kept started by the previous stream if the format is
+     * strictly identical and no restart was requested meanwhile. */
+    bool reuse_output = false;
+    if (owner->output_kept)
+    {
+        owner->output_kept = false;
+        reuse_output = AOUT_FMTS_IDENTICAL(&owner->input_format, p_format)
+                    && owner->input_profile == profile
+                    && atomic_load_explicit(&owner->restart,
+                                            memory_order_relaxed) == 0;
+        if (reuse_output)
+            msg_Dbg (p_aout, "reusing started output: identical stream format");
+        else
+            aout_OutputDelete (p_aout);
+    }
+
     /* Create the audio output stream */
     if (!owner->bitexact)
         owner->volume = aout_volume_New (p_aout, p_replay_gain);
 
     atomic_store_explicit(&owner->restart, 0, memory_order_relaxed);
     owner->input_profile = profile;
-    owner->filter_format = owner->mixer_format = owner->input_format = *p_format;
+    if (reuse_output)
+        /* Keep the filter and mixer formats negotiated by the output */
+        owner->input_format = *p_format;
+    else
+        owner->filter_format = owner->mixer_format = owner->input_format
+                             = *p_format;
 
     owner->sync.clock = clock;
 
     owner->filters = NULL;
-    owner->filters_cfg = AOUT_FILTERS_CFG_INIT;
-    if (aout_OutputNew (p_aout))
-        goto error;
+    if (!reuse_output)
+    {
+        /* Keep the filters configuration negotiated by the output on reuse */
+        owner->filters_cfg = AOUT_FILTERS_CFG_INIT;
+        if (aout_OutputNew (p_aout))
+            goto error;
+    }
     aout_volume_SetFormat (owner->volume, owner->mixer_format.i_format);
 
     if (!owner->bitexact)
@@ -123,6 +149,7 @@ error:
 
     owner->sync.rate = 1.f;
     owner->sync.resamp_type = AOUT_RESAMPLING_NONE;
+    owner->sync.trim_remain = 0;
     owner->sync.discontinuity = true;
     owner->original_pts = VLC_TICK_INVALID;
     owner->sync.delay = owner->sync.request_delay = 0;
@@ -144,8 +171,18 @@ void aout_DecDelete (audio_output_t *aout)
     {
         aout_DecFlush(aout);
         if (owner->filters)
+        {
             aout_FiltersDelete (aout, owner->filters);
-        aout_OutputDelete (aout);
+            owner->filters = NULL;
+        }
+        if (owner->keep_output)
+        {   /* Keep the output started so that an upcoming stream with the
+             * same format can reuse it without a device restart. */
+            msg_Dbg (aout, "keeping output for the next stream");
+            owner->output_kept = true;
+        }
+        else
+            aout_OutputDelete (aout);
     }
     aout_volume_Delete (owner->volume);
     owner->volume = NULL;
@@ -188,6 +225,7 @@ static int aout_CheckReady (audio_output_t *aout)
 
         msg_Dbg (aout, "restarting filters...");
         owner->sync.resamp_type = AOUT_RESAMPLING_NONE;
+        owner->sync.trim_remain = 0;
 
         if (owner->mixer_format.i_format && !owner->bitexact)
         {
@@ -261,6 +299,45 @@ static void aout_DecSilence (audio_output_t *aout, vlc_tick_t length, vlc_tick_t
     aout->play(aout, block, system_pts);
 }
 
+/* Maximum amount of drift corrected per block in trimming mode. Keep it
+ * small: shifting the signal by more than about a millisecond at once is
+ * audible, whereas repeated sample-sized steps are not. */
+#define AOUT_MAX_TRIM VLC_TICK_FROM_MS(1)
+
+static void aout_DecApplyTrim (audio_output_t *aout, block_t *block)
+{
+    aout_owner_t *owner = aout_owner (aout);
+    const audio_sample_format_t *fmt = &owner->input_format;
+
+    if (!AOUT_FMT_LINEAR(fmt))
+        return; /* cannot cut a compressed stream mid-frame */
+
+    if (owner->sync.trim_remain > 0)
+    {   /* Playback is late: drop a few samples from the block head so that
+         * the output buffer drains faster than the play-out clock. */
+        size_t frames = samples_from_vlc_tick(__MIN(owner->sync.trim_remain,
+                                                    AOUT_MAX_TRIM),
+                                              fmt->i_rate);
+        if (frames >= block->i_nb_samples)
+            return; /* never swallow a whole block */
+
+        vlc_tick_t length = vlc_tick_from_samples(frames, fmt->i_rate);
+        block->p_buffer += frames * fmt->i_bytes_per_frame;
+        block->i_buffer -= frames * fmt->i_bytes_per_frame;
+        block->i_nb_samples -= frames;
+        block->i_pts += length;
+        block->i_length -= length;
+        owner->sync.trim_remain -= length;
+    }
+    else
+    {   /* Playback is early: pad with silence so that the output buffer
+         * fills up faster than the play-out clock. */
+        vlc_tick_t length = __MIN(-owner->sync.trim_remain, AOUT_MAX_TRIM);
+        aout_DecSilence (aout, length, block->i_pts);
+        owner->sync.trim_remain += length;
+    }
+}
+
 static void aout_DecSynchronize(audio_output_t *aout, vlc_tick_t system_now,
                                 vlc_tick_t dec_pts)
 {
@@ -359,6 +436,34 @@ void aout_RequestRetiming(audio_output_t *aout, vlc_tick_t system_ts,
         drift = 0;
     }
 
+    if (owner->sync.trim)
+    {
+        /* Trimming mode: do not engage the resampler. Instead, request that
+         * aout_DecPlay() absorbs the drift a few samples at a time at block
+         * boundaries. Useful with outputs whose device clock reporting is
+         * accurate, as resampling every sample to shift a few is wasteful. */
+        if (drift > +AOUT_MAX_PTS_DELAY || drift < -AOUT_MAX_PTS_ADVANCE)
+        {
+            if (owner->sync.trim_remain == 0)
+                msg_Warn (aout, "playback too %s (%"PRId64"): trimming",
+                          drift > 0 ? "late" : "early", drift);
+            owner->sync.trim_remain = drift;
+        }
+        else if (owner->sync.trim_remain != 0)
+        {
+            if ((owner->sync.trim_remain > 0) != (drift > 0)
+             || llabs (drift) < AOUT_MAX_TRIM)
+            {   /* Back on track: stop trimming. */
+                msg_Dbg (aout, "trimming stopped (drift: %"PRId64" us)",
+                         drift);
+                owner->sync.trim_remain = 0;
+            }
+            else
+                owner->sync.trim_remain = drift;
+        }
+        return;
+    }
+
     if (!aout_FiltersCanResample(owner->filters))
         return;
 
@@ -431,6 +536,9 @@ int aout_DecPlay(audio_output_t *aout, block_t *block)
         owner->original_pts = VLC_TICK_INVALID;
     }
 
+    if (owner->sync.trim_remain != 0)
+        aout_DecApplyTrim (aout, block);
+
     if (owner->original_pts == VLC_TICK_INVALID)
     {
         /* Use the original PTS for synchronization and as a play date of the
@@ -488,6 +596,10 @@ int aout_DecPlay(audio_output_t *aout, block_t *block)
     }
     /* Output */
     owner->sync.discontinuity = false;
+    vlc_tracer_Trace(owner->tracer,
+                     VLC_TRACE("event", "aout_play"),
+                     VLC_TRACE_TICK("pts", original_pts),
+                     VLC_TRACE_TICK("system", play_date));
     aout->play(aout, block, play_date);
 
     atomic_fetch_add_explicit(&owner->buffers_played, 1, memory_order_relaxed);
@@ -568,6 +680,7 @@ void aout_DecFlush(audio_output_t *aout)
         }
     }
     owner->sync.discontinuity = true;
+    owner->sync.trim_remain = 0;
     owner->original_pts = VLC_TICK_INVALID;
 }
 
@@ -592,5 +705,6 @@ void aout_DecDrain(audio_output_t *aout)
         aout_FiltersResetClock(owner->filters);
 
     owner->sync.discontinuity = true;
+    owner->sync.trim_remain = 0;
     owner->original_pts = VLC_TICK_INVALID;
 }
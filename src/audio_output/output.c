@@ -31,6 +31,7 @@
 #include <vlc_aout.h>
 #include <vlc_modules.h>
 #include <vlc_atomic.h>
+#include <vlc_tracer.h>
 
 #include "libvlc.h"
 #include "aout_internal.h"
@@ -224,6 +225,7 @@ audio_output_t *aout_New (vlc_object_t *parent)
     vlc_viewpoint_init (&owner->vp.value);
     atomic_init (&owner->vp.update, false);
     vlc_atomic_rc_init(&owner->rc);
+    owner->tracer = vlc_object_get_tracer(VLC_OBJECT(aout));
 
     /* Audio output module callbacks */
     var_Create (aout, "volume", VLC_VAR_FLOAT);
@@ -340,6 +342,9 @@ audio_output_t *aout_New (vlc_object_t *parent)
     var_Create (aout, "equalizer-preset", VLC_VAR_STRING | VLC_VAR_DOINHERIT);
 
     owner->bitexact = var_InheritBool (aout, "audio-bitexact");
+    owner->sync.trim = var_InheritBool (aout, "audio-drift-trim");
+    owner->keep_output = var_InheritBool (aout, "gapless-audio");
+    owner->output_kept = false;
 
     return aout;
 }
@@ -359,6 +364,12 @@ void aout_Destroy (audio_output_t *aout)
 {
     aout_owner_t *owner = aout_owner (aout);
 
+    if (owner->output_kept)
+    {   /* No next stream came: stop the output kept for gapless */
+        owner->output_kept = false;
+        aout_OutputDelete (aout);
+    }
+
     vlc_mutex_lock(&owner->lock);
     module_unneed (aout, owner->module);
     /* Protect against late call from intf.c */
@@ -23,8 +23,10 @@
 
 #include <vlc_common.h>
 #include <vlc_aout.h>
+#include <vlc_tracer.h>
 #include <assert.h>
 #include <limits.h>
+#include <stdatomic.h>
 #include "clock.h"
 #include "clock_internal.h"
 
@@ -33,6 +35,8 @@ struct vlc_clock_main_t
     vlc_mutex_t lock;
     vlc_cond_t cond;
 
+    struct vlc_tracer *tracer; /* NULL when tracing is disabled */
+
     vlc_clock_t *master;
 
     unsigned rc;
@@ -50,6 +54,24 @@ struct vlc_clock_main_t
 
     vlc_tick_t pause_date;
 
+    /**
+     * Snapshot of the linear function, published for lock-free readers
+     *
+     * See vlc_clock_main_publish_snapshot() and
+     * vlc_clock_snapshot_to_system(). All members are atomic since they are
+     * read without the lock; the sequence counter is odd while the snapshot
+     * is being updated.
+     */
+    struct
+    {
+        atomic_uint seq;
+        _Atomic double coeff;
+        _Atomic double rate;
+        _Atomic vlc_tick_t offset;
+        _Atomic vlc_tick_t delay;
+        atomic_bool valid; /* False when paused or without a reference point */
+    } snapshot;
+
     unsigned wait_sync_ref_priority;
     clock_point_t wait_sync_ref; /* When the master */
     clock_point_t first_pcr;
@@ -69,8 +91,11 @@ struct vlc_clock_t
                                    vlc_tick_t ts, double rate);
 
     vlc_clock_main_t *owner;
-    vlc_tick_t delay;
+    /* Written under the main clock lock, also read by the lock-free
+     * conversion path */
+    _Atomic vlc_tick_t delay;
     unsigned priority;
+    atomic_bool is_slave;
 
     const struct vlc_clock_cbs *cbs;
     void *cbs_data;
@@ -85,6 +110,59 @@ static vlc_tick_t main_stream_to_system(vlc_clock_main_t *main_clock,
         (ts * main_clock->coeff / main_clock->rate + main_clock->offset);
 }
 
+/**
+ * Publish a snapshot of the linear function
+ *
+ * Called with the lock held, whenever one of the conversion parameters
+ * changes. All atomic operations are sequentially consistent, so readers
+ * checking the sequence counter before and after their reads are guaranteed
+ * to get a coherent set of parameters.
+ */
+static void vlc_clock_main_publish_snapshot(vlc_clock_main_t *main_clock)
+{
+    unsigned seq = atomic_load(&main_clock->snapshot.seq);
+    atomic_store(&main_clock->snapshot.seq, ++seq); /* Odd: update ongoing */
+
+    main_clock->snapshot.coeff = main_clock->coeff;
+    main_clock->snapshot.rate = main_clock->rate;
+    main_clock->snapshot.offset = main_clock->offset;
+    main_clock->snapshot.delay = main_clock->delay;
+    main_clock->snapshot.valid = main_clock->offset != VLC_TICK_INVALID
+                              && main_clock->pause_date == VLC_TICK_INVALID;
+
+    atomic_store(&main_clock->snapshot.seq, ++seq);
+}
+
+/**
+ * Convert a stream timestamp from the published snapshot, without the lock
+ *
+ * Only valid for slave clocks. Fails while a snapshot update is ongoing or
+ * raced with the reads, while the clock is paused, or while there is no
+ * reference point: the monotonic fallback needs the lock since it updates
+ * the sync reference point.
+ */
+static bool vlc_clock_snapshot_to_system(vlc_clock_t *clock, vlc_tick_t ts,
+                                         double rate, vlc_tick_t *system)
+{
+    vlc_clock_main_t *main_clock = clock->owner;
+
+    unsigned seq = atomic_load(&main_clock->snapshot.seq);
+    if ((seq & 1) || !main_clock->snapshot.valid)
+        return false;
+
+    const double coeff = main_clock->snapshot.coeff;
+    const double main_rate = main_clock->snapshot.rate;
+    const vlc_tick_t offset = main_clock->snapshot.offset;
+    const vlc_tick_t main_delay = main_clock->snapshot.delay;
+
+    if (atomic_load(&main_clock->snapshot.seq) != seq)
+        return false; /* Torn read, take the lock instead */
+
+    *system = (vlc_tick_t) (ts * coeff / main_rate + offset)
+            + (clock->delay - main_delay) * rate;
+    return true;
+}
+
 static void vlc_clock_main_reset(vlc_clock_main_t *main_clock)
 {
     AvgReset(&main_clock->coeff_avg);
@@ -95,6 +173,7 @@ static void vlc_clock_main_reset(vlc_clock_main_t *main_clock)
     main_clock->wait_sync_ref_priority = UINT_MAX;
     main_clock->wait_sync_ref =
         main_clock->last = clock_point_Create(VLC_TICK_INVALID, VLC_TICK_INVALID);
+    vlc_clock_main_publish_snapshot(main_clock);
     vlc_cond_broadcast(&main_clock->cond);
 }
 
@@ -154,11 +233,22 @@ static vlc_tick_t vlc_clock_master_update(vlc_clock_t *clock,
         main_clock->last = clock_point_Create(system_now, ts);
 
         main_clock->rate = rate;
+        vlc_clock_main_publish_snapshot(main_clock);
         vlc_cond_broadcast(&main_clock->cond);
     }
 
+    const double coeff = main_clock->coeff;
+    const vlc_tick_t offset = main_clock->offset;
+
     vlc_mutex_unlock(&main_clock->lock);
 
+    vlc_tracer_Trace(main_clock->tracer,
+                     VLC_TRACE("event", "clock_update"),
+                     VLC_TRACE_TICK("ts", original_ts),
+                     VLC_TRACE_TICK("system", system_now),
+                     VLC_TRACE_TICK("offset", offset),
+                     VLC_TRACE("coeff", (int64_t)(coeff * 1000000.)));
+
     vlc_clock_on_update(clock, system_now, original_ts, rate, frame_rate,
                         frame_rate_base);
     return VLC_TICK_INVALID;
@@ -187,6 +277,7 @@ static void vlc_clock_master_reset(vlc_clock_t *clock)
             clock->delay = 0;
             main_clock->delay = delta;
         }
+        vlc_clock_main_publish_snapshot(main_clock);
     }
 
     vlc_mutex_unlock(&main_clock->lock);
@@ -216,6 +307,7 @@ static vlc_tick_t vlc_clock_master_set_delay(vlc_clock_t *clock, vlc_tick_t dela
     assert(main_clock->delay <= 0);
     assert(clock->delay >= 0);
 
+    vlc_clock_main_publish_snapshot(main_clock);
     vlc_cond_broadcast(&main_clock->cond);
     vlc_mutex_unlock(&main_clock->lock);
     return delta;
@@ -356,7 +448,7 @@ int vlc_clock_Wait(vlc_clock_t *clock, vlc_tick_t system_now, vlc_tick_t ts,
     return -1;
 }
 
-vlc_clock_main_t *vlc_clock_main_New(void)
+vlc_clock_main_t *vlc_clock_main_New(struct vlc_tracer *tracer)
 {
     vlc_clock_main_t *main_clock = malloc(sizeof(vlc_clock_main_t));
 
@@ -365,6 +457,7 @@ vlc_clock_main_t *vlc_clock_main_New(void)
 
     vlc_mutex_init(&main_clock->lock);
     vlc_cond_init(&main_clock->cond);
+    main_clock->tracer = tracer;
     main_clock->master = NULL;
     main_clock->rc = 1;
 
@@ -373,6 +466,13 @@ vlc_clock_main_t *vlc_clock_main_New(void)
     main_clock->offset = VLC_TICK_INVALID;
     main_clock->delay = 0;
 
+    atomic_init(&main_clock->snapshot.seq, 0);
+    atomic_init(&main_clock->snapshot.coeff, 1.0);
+    atomic_init(&main_clock->snapshot.rate, 1.0);
+    atomic_init(&main_clock->snapshot.offset, VLC_TICK_INVALID);
+    atomic_init(&main_clock->snapshot.delay, 0);
+    atomic_init(&main_clock->snapshot.valid, false);
+
     main_clock->first_pcr =
         clock_point_Create(VLC_TICK_INVALID, VLC_TICK_INVALID);
     main_clock->wait_sync_ref_priority = UINT_MAX;
@@ -464,6 +564,7 @@ void vlc_clock_main_ChangePause(vlc_clock_main_t *main_clock, vlc_tick_t now,
         main_clock->pause_date = VLC_TICK_INVALID;
         vlc_cond_broadcast(&main_clock->cond);
     }
+    vlc_clock_main_publish_snapshot(main_clock);
     vlc_mutex_unlock(&main_clock->lock);
 }
 
@@ -499,9 +600,17 @@ vlc_tick_t vlc_clock_SetDelay(vlc_clock_t *clock, vlc_tick_t delay)
 vlc_tick_t vlc_clock_ConvertToSystem(vlc_clock_t *clock, vlc_tick_t system_now,
                                      vlc_tick_t ts, double rate)
 {
+    vlc_tick_t system;
+
+    /* Fast path: every decoded frame is converted, don't make all slaves of
+     * an input serialize on the main clock lock */
+    if (atomic_load(&clock->is_slave)
+     && vlc_clock_snapshot_to_system(clock, ts, rate, &system))
+        return system;
+
     vlc_clock_main_t *main_clock = clock->owner;
     vlc_mutex_lock(&main_clock->lock);
-    vlc_tick_t system = clock->to_system_locked(clock, system_now, ts, rate);
+    system = clock->to_system_locked(clock, system_now, ts, rate);
     vlc_mutex_unlock(&main_clock->lock);
     return system;
 }
@@ -510,9 +619,20 @@ void vlc_clock_ConvertArrayToSystem(vlc_clock_t *clock, vlc_tick_t system_now,
                                     vlc_tick_t *ts_array, size_t ts_count,
                                     double rate)
 {
+    size_t i = 0;
+
+    if (atomic_load(&clock->is_slave))
+        while (i < ts_count
+            && vlc_clock_snapshot_to_system(clock, ts_array[i], rate,
+                                            &ts_array[i]))
+            i++;
+
+    if (i == ts_count)
+        return;
+
     vlc_clock_main_t *main_clock = clock->owner;
     vlc_mutex_lock(&main_clock->lock);
-    for (size_t i = 0; i < ts_count; ++i)
+    for (; i < ts_count; ++i)
         ts_array[i] = clock->to_system_locked(clock, system_now, ts_array[i],
                                               rate);
     vlc_mutex_unlock(&main_clock->lock);
@@ -524,6 +644,7 @@ static void vlc_clock_set_master_callbacks(vlc_clock_t *clock)
     clock->reset = vlc_clock_master_reset;
     clock->set_delay = vlc_clock_master_set_delay;
     clock->to_system_locked = vlc_clock_master_to_system_locked;
+    clock->is_slave = false;
 }
 
 static void vlc_clock_set_slave_callbacks(vlc_clock_t *clock)
@@ -532,6 +653,7 @@ static void vlc_clock_set_slave_callbacks(vlc_clock_t *clock)
     clock->reset = vlc_clock_slave_reset;
     clock->set_delay = vlc_clock_slave_set_delay;
     clock->to_system_locked = vlc_clock_slave_to_system_locked;
+    clock->is_slave = true;
 }
 
 static vlc_clock_t *vlc_clock_main_Create(vlc_clock_main_t *main_clock,
@@ -544,7 +666,8 @@ static vlc_clock_t *vlc_clock_main_Create(vlc_clock_main_t *main_clock,
         return NULL;
 
     clock->owner = main_clock;
-    clock->delay = 0;
+    atomic_init(&clock->delay, 0);
+    atomic_init(&clock->is_slave, false);
     clock->cbs = cbs;
     clock->cbs_data = cbs_data;
     clock->priority = priority;
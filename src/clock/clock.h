@@ -29,6 +29,7 @@ enum vlc_clock_master_source
 
 typedef struct vlc_clock_main_t vlc_clock_main_t;
 typedef struct vlc_clock_t vlc_clock_t;
+struct vlc_tracer;
 
 /**
  * Callbacks for the owner of the main clock
@@ -56,8 +57,10 @@ struct vlc_clock_cbs
 
 /**
  * This function creates the vlc_clock_main_t of the program
+ *
+ * @param tracer tracer to record master clock updates, or NULL
  */
-vlc_clock_main_t *vlc_clock_main_New(void);
+vlc_clock_main_t *vlc_clock_main_New(struct vlc_tracer *tracer);
 
 /**
  * Destroy the clock main
@@ -251,7 +251,7 @@ error:
 static ssize_t config_ListModules (const char *cap, char ***restrict values,
                                    char ***restrict texts)
 {
-    module_t **list;
+    module_t *const *list;
     ssize_t n = module_list_cap (&list, cap);
     if (unlikely(n < 0))
     {
@@ -292,7 +292,6 @@ static ssize_t config_ListModules (const char *cap, char ***restrict values,
 
     *values = vals;
     *texts = txts;
-    module_list_free (list);
     return i + 1;
 
 error:
@@ -303,7 +302,6 @@ error:
     }
     free(vals);
     free(txts);
-    module_list_free (list);
     *values = *texts = NULL;
     return -1;
 }
@@ -452,6 +452,9 @@ size_t vlc_iconv( vlc_iconv_t cd, const char **inbuf, size_t *inbytesleft,
 #ifndef __linux__
     if ( cd == (vlc_iconv_t)(-2) || cd == (vlc_iconv_t)(-3) )
     {
+        if ( inbuf == NULL || *inbuf == NULL )
+            return 0; /* stateless converter: nothing to reset */
+
         unsigned char *out = NULL;
         if (outbuf != NULL)
             out = (unsigned char *)*outbuf;
@@ -42,6 +42,7 @@
 #include <vlc_dialog.h>
 #include <vlc_modules.h>
 #include <vlc_decoder.h>
+#include <vlc_tracer.h>
 #include <vlc_picture_pool.h>
 
 #include "audio_output/aout_internal.h"
@@ -92,6 +93,12 @@ struct vlc_input_decoder_t
     vlc_meta_t     *p_description;
     atomic_int     reload;
 
+    /* moving average of pf_decode() wall time (DecoderThread only) */
+    vlc_tick_t decode_latency;
+
+    /* Event tracer of the instance, NULL when tracing is disabled */
+    struct vlc_tracer *tracer;
+
     /* fifo */
     block_fifo_t *p_fifo;
 
@@ -194,6 +201,18 @@ static inline vlc_input_decoder_t *dec_get_owner( decoder_t *p_dec )
     return container_of( p_dec, vlc_input_decoder_t, dec );
 }
 
+/* Stream category, as traced with the decoder events */
+static const char *TraceCategory( const decoder_t *p_dec )
+{
+    switch( p_dec->fmt_in.i_cat )
+    {
+        case VIDEO_ES: return "video";
+        case AUDIO_ES: return "audio";
+        case SPU_ES:   return "spu";
+        default:       return "unknown";
+    }
+}
+
 /**
  * Load a decoder module
  */
@@ -453,7 +472,35 @@ static int ModuleThread_UpdateVideoFormat( decoder_t *p_dec, vlc_video_context *
             break;
         }
 
-        p_owner->out_pool = picture_pool_NewFromFormat( &p_dec->fmt_out.video,
+        video_format_t pool_fmt = p_dec->fmt_out.video;
+
+        if( p_dec->i_picture_pitch_align > 16 )
+        {
+            /* Round the buffer width up so that every plane pitch honours
+             * the pitch alignment negotiated by the decoder; the visible
+             * area is left untouched. Without this, decoders rendering
+             * directly into the pool fall back to an intermediate buffer
+             * and one full-frame copy per picture. */
+            const vlc_chroma_description_t *p_dsc =
+                vlc_fourcc_GetChromaDescription( pool_fmt.i_chroma );
+            if( p_dsc != NULL )
+            {
+                unsigned i_modulo = 1;
+                for( unsigned i = 0; i < p_dsc->plane_count; i++ )
+                {
+                    /* Alignments and subsampling denominators are powers
+                     * of two, so the largest product covers the others */
+                    unsigned m = p_dec->i_picture_pitch_align
+                               * p_dsc->p[i].w.den;
+                    if( m > i_modulo )
+                        i_modulo = m;
+                }
+                pool_fmt.i_width = ( pool_fmt.i_width + i_modulo - 1 )
+                                 / i_modulo * i_modulo;
+            }
+        }
+
+        p_owner->out_pool = picture_pool_NewFromFormat( &pool_fmt,
                             dpb_size + p_dec->i_extra_picture_buffers + 1 );
         if (p_owner->out_pool == NULL)
         {
@@ -1142,6 +1189,11 @@ static void ModuleThread_QueueVideo( decoder_t *p_dec, picture_t *p_pic )
     assert( p_pic );
     vlc_input_decoder_t *p_owner = dec_get_owner( p_dec );
 
+    vlc_tracer_Trace( p_owner->tracer,
+                      VLC_TRACE( "event", "decoder_out" ),
+                      VLC_TRACE( "stream", TraceCategory( p_dec ) ),
+                      VLC_TRACE_TICK( "pts", p_pic->date ) );
+
     int success = ModuleThread_PlayVideo( p_owner, p_pic );
 
     ModuleThread_UpdateStatVideo( p_owner, success != VLC_SUCCESS );
@@ -1276,6 +1328,11 @@ static void ModuleThread_QueueAudio( decoder_t *p_dec, block_t *p_aout_buf )
 {
     vlc_input_decoder_t *p_owner = dec_get_owner( p_dec );
 
+    vlc_tracer_Trace( p_owner->tracer,
+                      VLC_TRACE( "event", "decoder_out" ),
+                      VLC_TRACE( "stream", TraceCategory( p_dec ) ),
+                      VLC_TRACE_TICK( "pts", p_aout_buf->i_pts ) );
+
     int success = ModuleThread_PlayAudio( p_owner, p_aout_buf );
 
     ModuleThread_UpdateStatAudio( p_owner, success != VLC_SUCCESS );
@@ -1343,8 +1400,25 @@ static void DecoderThread_ProcessInput( vlc_input_decoder_t *p_owner, block_t *p
 static void DecoderThread_DecodeBlock( vlc_input_decoder_t *p_owner, block_t *p_block )
 {
     decoder_t *p_dec = &p_owner->dec;
+    const bool measure = p_block != NULL
+        && ( p_dec->fmt_in.i_cat == VIDEO_ES || p_dec->fmt_in.i_cat == AUDIO_ES );
+    vlc_tick_t start = measure ? vlc_tick_now() : VLC_TICK_INVALID;
 
     int ret = p_dec->pf_decode( p_dec, p_block );
+
+    if( measure )
+    {
+        vlc_tick_t spent = vlc_tick_now() - start;
+
+        /* Exponential moving average over the last ~8 blocks */
+        if( p_owner->decode_latency == 0 )
+            p_owner->decode_latency = spent;
+        else
+            p_owner->decode_latency += (spent - p_owner->decode_latency) / 8;
+        decoder_Notify( p_owner, on_decode_latency, p_owner->decode_latency,
+                        spent );
+    }
+
     switch( ret )
     {
         case VLCDEC_SUCCESS:
@@ -1713,7 +1787,14 @@ static void *DecoderThread( void *p_data )
 
         vlc_cond_signal( &p_owner->wait_fifo );
 
-        block_t *p_block = vlc_fifo_DequeueUnlocked( p_owner->p_fifo );
+        block_t *p_block;
+        if( p_owner->dec.fmt_out.i_cat == AUDIO_ES )
+            /* Audio frames can be just a few milliseconds long: dequeue
+             * everything pending and decode it in one go rather than cycling
+             * the FIFO wait and the acknowledge signaling for each block */
+            p_block = vlc_fifo_DequeueAllUnlocked( p_owner->p_fifo );
+        else
+            p_block = vlc_fifo_DequeueUnlocked( p_owner->p_fifo );
         if( p_block == NULL )
         {
             if( likely(!p_owner->b_draining) )
@@ -1728,11 +1809,36 @@ static void *DecoderThread( void *p_data )
              * drain. Pass p_block = NULL to decoder just once. */
         }
 
+        const bool b_draining_call = (p_block == NULL);
+
         vlc_fifo_Unlock( p_owner->p_fifo );
 
-        DecoderThread_ProcessInput( p_owner, p_block );
+        if( b_draining_call )
+            DecoderThread_ProcessInput( p_owner, NULL );
+        else
+            for( block_t *p_next; p_block != NULL; p_block = p_next )
+            {
+                p_next = p_block->p_next;
+                p_block->p_next = NULL;
+
+                DecoderThread_ProcessInput( p_owner, p_block );
+
+                if( p_next != NULL )
+                {
+                    /* Do not keep decoding stale blocks over a flush or
+                     * termination request */
+                    vlc_fifo_Lock( p_owner->p_fifo );
+                    const bool b_stop = p_owner->flushing || p_owner->aborting;
+                    vlc_fifo_Unlock( p_owner->p_fifo );
+                    if( b_stop )
+                    {
+                        block_ChainRelease( p_next );
+                        break;
+                    }
+                }
+            }
 
-        if( p_block == NULL && p_owner->dec.fmt_out.i_cat == AUDIO_ES )
+        if( b_draining_call && p_owner->dec.fmt_out.i_cat == AUDIO_ES )
         {   /* Draining: the decoder is drained and all decoded buffers are
              * queued to the output at this point. Now drain the output. */
             if( p_owner->p_aout != NULL )
@@ -1742,7 +1848,7 @@ static void *DecoderThread( void *p_data )
         /* TODO? Wait for draining instead of polling. */
         vlc_mutex_lock( &p_owner->lock );
         vlc_fifo_Lock( p_owner->p_fifo );
-        if( p_owner->b_draining && (p_block == NULL) )
+        if( p_owner->b_draining && b_draining_call )
         {
             p_owner->b_draining = false;
             p_owner->drained = true;
@@ -1825,6 +1931,8 @@ CreateDecoder( vlc_object_t *p_parent,
     p_owner->p_resource = p_resource;
     p_owner->cbs = cbs;
     p_owner->cbs_userdata = cbs_userdata;
+    p_owner->decode_latency = 0;
+    p_owner->tracer = vlc_object_get_tracer( p_parent );
     p_owner->p_aout = NULL;
     p_owner->p_vout = NULL;
     p_owner->vout_thread_started = false;
@@ -1914,6 +2022,19 @@ CreateDecoder( vlc_object_t *p_parent,
             return p_owner;
     }
 
+#ifdef ENABLE_SOUT
+    /* Already-packetized ES accepted as-is by the stream chain can skip
+     * the parsing packetizer and use plain pass-through forwarding */
+    if( p_sout != NULL && fmt->b_packetized
+     && sout_InputCanPassthrough( p_sout, fmt ) )
+    {
+        msg_Dbg( p_dec, "muxer accepts `%4.4s' as-is, "
+                 "using pass-through packetizer", (char *)&fmt->i_codec );
+        var_Create( p_dec, "packetizer", VLC_VAR_STRING );
+        var_SetString( p_dec, "packetizer", "copy" );
+    }
+#endif
+
     /* Find a suitable decoder/packetizer module */
     if( LoadDecoder( p_dec, p_sout != NULL, fmt ) )
         return p_owner;
@@ -2214,6 +2335,12 @@ void vlc_input_decoder_Delete( vlc_input_decoder_t *p_owner )
 void vlc_input_decoder_Decode( vlc_input_decoder_t *p_owner, block_t *p_block,
                                bool b_do_pace )
 {
+    vlc_tracer_Trace( p_owner->tracer,
+                      VLC_TRACE( "event", "decoder_queued" ),
+                      VLC_TRACE( "stream", TraceCategory( &p_owner->dec ) ),
+                      VLC_TRACE_TICK( "dts", p_block->i_dts ),
+                      VLC_TRACE_TICK( "pts", p_block->i_pts ) );
+
     vlc_fifo_Lock( p_owner->p_fifo );
     if( !b_do_pace )
     {
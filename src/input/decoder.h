@@ -43,6 +43,9 @@ struct vlc_input_decoder_callbacks {
                                void *userdata);
     void (*on_new_audio_stats)(vlc_input_decoder_t *decoder, unsigned decoded,
                                unsigned lost, unsigned played, void *userdata);
+    void (*on_decode_latency)(vlc_input_decoder_t *decoder,
+                              vlc_tick_t avg, vlc_tick_t last,
+                              void *userdata);
 
     /* requests */
     int (*get_attachments)(vlc_input_decoder_t *decoder,
@@ -34,8 +34,15 @@
 #include <vlc_url.h>
 #include <vlc_modules.h>
 #include <vlc_strings.h>
+#include <vlc_interrupt.h>
 #include "input_internal.h"
 
+/* How much of the stream start to fetch in one go before generic probing.
+ * Candidate demuxers are probed in sequence and peek ever deeper into the
+ * stream; without this, each deeper peek can cost a network round-trip of
+ * its own. One bounded read up front turns them all into memory copies. */
+#define DEMUX_PROBE_PREHEAT (64 * 1024)
+
 typedef const struct
 {
     char const key[20];
@@ -167,6 +174,11 @@ static int demux_Probe(void *func, bool forced, va_list ap)
     int (*probe)(vlc_object_t *) = func;
     demux_t *demux = va_arg(ap, demux_t *);
 
+    /* Give up on the remaining candidates as soon as the open is
+     * interrupted, rather than after the current probe returns. */
+    if (vlc_killed())
+        return VLC_EGENERIC;
+
     /* Restore input stream offset (in case previous probed demux failed to
      * to do so). */
     if (vlc_stream_Tell(demux->s) != 0 && vlc_stream_Seek(demux->s, 0))
@@ -245,8 +257,17 @@ demux_t *demux_NewAdvanced( vlc_object_t *p_obj, input_thread_t *p_input,
     if( psz_module == NULL )
         psz_module = p_demux->psz_name;
 
-    priv->module = vlc_module_load(p_demux, "demux", psz_module,
-        !strcmp(psz_module, p_demux->psz_name), demux_Probe, p_demux);
+    bool strict = !strcmp( psz_module, p_demux->psz_name );
+
+    if( !strict || !strcmp( psz_module, "any" ) )
+    {   /* Generic probing ahead: warm the stream cache once so that the
+         * candidates' peeks do not each hit the underlying access. */
+        const uint8_t *peek;
+        (void) vlc_stream_Peek( s, &peek, DEMUX_PROBE_PREHEAT );
+    }
+
+    priv->module = vlc_module_load(p_demux, "demux", psz_module, strict,
+                                   demux_Probe, p_demux);
 
     if (priv->module == NULL)
     {
@@ -40,6 +40,7 @@
 #include <vlc_list.h>
 #include <vlc_decoder.h>
 #include <vlc_memstream.h>
+#include <vlc_tracer.h>
 
 #include "input_internal.h"
 #include "../clock/input_clock.h"
@@ -173,15 +174,22 @@ typedef struct
 
     input_source_t *main_source;
 
+    /* Event tracer of the instance, NULL when tracing is disabled */
+    struct vlc_tracer *tracer;
+
     /* */
     vlc_mutex_t   lock;
 
     /* all programs */
     struct vlc_list programs;
     es_out_pgrm_t *p_pgrm;  /* Master program */
+    es_out_pgrm_t *p_pgrm_cache; /* Last program found by EsOutProgramSearch() */
 
     enum es_format_category_e i_master_source_cat;
 
+    /* Cached "captions" standard; the option is checked for each sent block */
+    int         i_captions_type;
+
     /* all es */
     int         i_id;
     struct vlc_list es;
@@ -368,6 +376,37 @@ decoder_on_new_video_stats(vlc_input_decoder_t *decoder, unsigned decoded, unsig
                               memory_order_relaxed);
 }
 
+static void
+decoder_on_decode_latency(vlc_input_decoder_t *decoder, vlc_tick_t avg,
+                          vlc_tick_t last, void *userdata)
+{
+    (void) decoder;
+
+    es_out_id_t *id = userdata;
+    es_out_t *out = id->out;
+    es_out_sys_t *p_sys = container_of(out, es_out_sys_t, out);
+
+    if (!p_sys->p_input)
+        return;
+
+    struct input_stats *stats = input_priv(p_sys->p_input)->stats;
+    if (!stats)
+        return;
+
+    atomic_store_explicit(&stats->decode_latency, avg,
+                          memory_order_relaxed);
+
+    /* One bucket per power of two of the block decode time, in µs */
+    unsigned bucket = 0;
+    if (last > 1)
+        bucket = (8 * sizeof (unsigned long long) - 1)
+               - vlc_clzll((unsigned long long)last);
+    if (bucket >= INPUT_STATS_LATENCY_BUCKETS)
+        bucket = INPUT_STATS_LATENCY_BUCKETS - 1;
+    atomic_fetch_add_explicit(&stats->decode_latency_histogram[bucket], 1,
+                              memory_order_relaxed);
+}
+
 static void
 decoder_on_new_audio_stats(vlc_input_decoder_t *decoder, unsigned decoded, unsigned lost,
                            unsigned played, void *userdata)
@@ -416,6 +455,7 @@ static const struct vlc_input_decoder_callbacks decoder_cbs = {
     .on_thumbnail_ready = decoder_on_thumbnail_ready,
     .on_new_video_stats = decoder_on_new_video_stats,
     .on_new_audio_stats = decoder_on_new_audio_stats,
+    .on_decode_latency = decoder_on_decode_latency,
     .get_attachments = decoder_get_attachments,
 };
 
@@ -494,6 +534,7 @@ es_out_t *input_EsOutNew( input_thread_t *p_input, input_source_t *main_source,
     vlc_mutex_init( &p_sys->lock );
     p_sys->p_input = p_input;
     p_sys->main_source = main_source;
+    p_sys->tracer = vlc_object_get_tracer( VLC_OBJECT( p_input ) );
 
     p_sys->b_active = false;
     p_sys->i_mode   = ES_OUT_MODE_NONE;
@@ -525,6 +566,8 @@ es_out_t *input_EsOutNew( input_thread_t *p_input, input_source_t *main_source,
             break;
     }
 
+    p_sys->i_captions_type = var_InheritInteger( p_input, "captions" );
+
     p_sys->i_pause_date = -1;
 
     p_sys->rate = rate;
@@ -652,6 +695,7 @@ static void EsOutTerminate( es_out_t *out )
     }
 
     p_sys->p_pgrm = NULL;
+    p_sys->p_pgrm_cache = NULL;
 
     input_item_SetEpgOffline( input_priv(p_sys->p_input)->p_item );
     input_SendEventMetaEpg( p_sys->p_input );
@@ -1373,7 +1417,7 @@ static es_out_pgrm_t *EsOutProgramAdd( es_out_t *out, input_source_t *source, in
 
     p_pgrm->p_master_clock = NULL;
     p_pgrm->p_input_clock = input_clock_New( p_sys->rate );
-    p_pgrm->p_main_clock = vlc_clock_main_New();
+    p_pgrm->p_main_clock = vlc_clock_main_New( p_sys->tracer );
     if( !p_pgrm->p_input_clock || !p_pgrm->p_main_clock )
     {
         if( p_pgrm->p_input_clock )
@@ -1413,11 +1457,19 @@ static es_out_pgrm_t *EsOutProgramSearch( es_out_t *p_out, input_source_t *sourc
                                           int i_group )
 {
     es_out_sys_t *p_sys = container_of(p_out, es_out_sys_t, out);
-    es_out_pgrm_t *pgrm;
+    es_out_pgrm_t *pgrm = p_sys->p_pgrm_cache;
+
+    /* PCR, PSI and meta updates for a program come in bursts: check the
+     * previously found program before walking the list */
+    if (pgrm != NULL && pgrm->i_id == i_group && pgrm->source == source)
+        return pgrm;
 
     vlc_list_foreach(pgrm, &p_sys->programs, node)
         if (pgrm->i_id == i_group && pgrm->source == source)
+        {
+            p_sys->p_pgrm_cache = pgrm;
             return pgrm;
+        }
 
     return NULL;
 }
@@ -1467,6 +1519,9 @@ static int EsOutProgramDel( es_out_t *out, input_source_t *source, int i_group )
 
     vlc_list_remove(&p_pgrm->node);
 
+    if( p_sys->p_pgrm_cache == p_pgrm )
+        p_sys->p_pgrm_cache = NULL;
+
     /* If program is selected we need to unselect it */
     if( p_sys->p_pgrm == p_pgrm )
         p_sys->p_pgrm = NULL;
@@ -2734,6 +2789,12 @@ static int EsOutSend( es_out_t *out, es_out_id_t *es, block_t *p_block )
                                       memory_order_relaxed);
     }
 
+    vlc_tracer_Trace( p_sys->tracer,
+                      VLC_TRACE( "event", "demux_send" ),
+                      VLC_TRACE( "id", vlc_es_id_GetStrId( &es->id ) ),
+                      VLC_TRACE_TICK( "dts", p_block->i_dts ),
+                      VLC_TRACE_TICK( "pts", p_block->i_pts ) );
+
     vlc_mutex_lock( &p_sys->lock );
 
     /* Mark preroll blocks */
@@ -2796,7 +2857,7 @@ static int EsOutSend( es_out_t *out, es_out_id_t *es, block_t *p_block )
     decoder_cc_desc_t desc;
 
     vlc_input_decoder_GetCcDesc( es->p_dec, &desc );
-    if( var_InheritInteger( p_input, "captions" ) == 708 )
+    if( p_sys->i_captions_type == 708 )
         EsOutCreateCCChannels( out, VLC_CODEC_CEA708, desc.i_708_channels,
                                _("DTVCC Closed captions %u"), es );
     EsOutCreateCCChannels( out, VLC_CODEC_CEA608, desc.i_608_channels,
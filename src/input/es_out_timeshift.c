@@ -35,6 +35,7 @@
 #  include <direct.h>
 #endif
 #include <sys/stat.h>
+#include <fcntl.h>
 #include <unistd.h>
 
 #include <vlc_common.h>
@@ -199,6 +200,7 @@ struct ts_storage_t
 #endif
     size_t  i_file_max; /* Max size in bytes */
     int64_t i_file_size;/* Current size in bytes */
+    int64_t i_file_rpos;/* Next sequential read offset (-1 if unknown) */
     FILE    *p_filew;   /* FILE handle for data writing */
     FILE    *p_filer;   /* FILE handle for data reading */
 
@@ -1199,6 +1201,9 @@ static void *TsRun( void *p_data )
  *****************************************************************************/
 #define MAX_COMMAND_SIZE sizeof(ts_cmd_t)
 #define TS_STORAGE_COMMAND_PREALLOC 30000
+/* Spool block data to disk in large writes: the stdio default buffer leads
+ * to many small writes and write amplification on flash storage */
+#define TS_STORAGE_FILE_BUFFERING (256 * 1024)
 
 static const size_t TsStorageSizeofCommand[] =
 {
@@ -1223,6 +1228,13 @@ static ts_storage_t *TsStorageNew( const char *psz_tmp_path, int64_t i_tmp_size_
         return NULL;
     }
 
+#ifdef HAVE_POSIX_FALLOCATE
+    /* Reserve the whole segment up front; allocating the extents once avoids
+     * per-write metadata updates and file fragmentation. Failure is harmless:
+     * the file then simply grows on demand as before. */
+    posix_fallocate( fd, 0, i_tmp_size_max );
+#endif
+
     p_storage->p_filew = fdopen( fd, "w+b" );
     if( p_storage->p_filew == NULL )
     {
@@ -1239,6 +1251,9 @@ static ts_storage_t *TsStorageNew( const char *psz_tmp_path, int64_t i_tmp_size_
         goto error;
     }
 
+    setvbuf( p_storage->p_filew, NULL, _IOFBF, TS_STORAGE_FILE_BUFFERING );
+    setvbuf( p_storage->p_filer, NULL, _IOFBF, TS_STORAGE_FILE_BUFFERING );
+
 #ifndef _WIN32
     vlc_unlink( psz_file );
     free( psz_file );
@@ -1250,6 +1265,7 @@ static ts_storage_t *TsStorageNew( const char *psz_tmp_path, int64_t i_tmp_size_
     /* */
     p_storage->i_file_max = i_tmp_size_max;
     p_storage->i_file_size = 0;
+    p_storage->i_file_rpos = 0;
 
     /* */
     p_storage->p_cmd_buf = vlc_alloc( TS_STORAGE_COMMAND_PREALLOC, MAX_COMMAND_SIZE );
@@ -1293,6 +1309,10 @@ static void TsStorageDelete( ts_storage_t *p_storage )
 
 static void TsStoragePack( ts_storage_t *p_storage )
 {
+    /* The segment will not be written to anymore: commit buffered data so
+     * that the reader can reach it once it catches up with this segment */
+    fflush( p_storage->p_filew );
+
     /* Try to release a bit of memory */
     if( (size_t)(p_storage->p_cmd_w - p_storage->p_cmd_buf) == p_storage->i_cmd_buf )
         return;
@@ -1375,8 +1395,11 @@ static void TsStoragePopCmd( ts_storage_t *p_storage, ts_cmd_t *p_cmd, bool b_fl
     {
         block_t block;
 
+        /* Commands are popped in push order, so reads are sequential and the
+         * seek can usually be elided (it would discard the read buffer) */
         if( !b_flush &&
-            !fseek( p_storage->p_filer, p_cmd->send.i_offset, SEEK_SET ) &&
+            ( p_cmd->send.i_offset == p_storage->i_file_rpos ||
+              !fseek( p_storage->p_filer, p_cmd->send.i_offset, SEEK_SET ) ) &&
             fread( &block, sizeof(block), 1, p_storage->p_filer ) == 1 )
         {
             block_t *p_block = block_Alloc( block.i_buffer );
@@ -1389,11 +1412,14 @@ static void TsStoragePopCmd( ts_storage_t *p_storage, ts_cmd_t *p_cmd, bool b_fl
                 p_block->i_nb_samples = block.i_nb_samples;
                 p_block->i_buffer = fread( p_block->p_buffer, 1, block.i_buffer, p_storage->p_filer );
             }
+            p_storage->i_file_rpos = p_cmd->send.i_offset + sizeof(block)
+                                   + ( p_block ? (int64_t)p_block->i_buffer : 0 );
             p_cmd->send.p_block = p_block;
         }
         else
         {
             //perror( "TsStoragePopCmd" );
+            p_storage->i_file_rpos = -1; /* force a seek on the next pop */
             p_cmd->send.p_block = block_Alloc( 1 );
         }
     }
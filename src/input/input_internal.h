@@ -23,6 +23,7 @@
 #ifndef LIBVLC_INPUT_INTERNAL_H
 #define LIBVLC_INPUT_INTERNAL_H 1
 
+#include <stdalign.h>
 #include <stddef.h>
 #include <stdatomic.h>
 
@@ -709,27 +710,46 @@ void vlc_audio_replay_gain_MergeFromMeta( audio_replay_gain_t *p_dst,
 /* stats.c */
 typedef struct input_rate_t
 {
-    vlc_mutex_t lock;
-    uintmax_t updates;
-    uintmax_t value;
+    /* There is a single writer per counter, so the fields are published with
+     * a sequence counter instead of a lock: input_stats_Compute() can then
+     * read a consistent snapshot without ever blocking the writing thread.
+     * The sequence is odd while an update is in progress. */
+    atomic_uint seq;
+    atomic_uintmax_t updates;
+    atomic_uintmax_t value;
     struct
     {
-        uintmax_t  value;
-        vlc_tick_t date;
+        atomic_uintmax_t value;
+        _Atomic vlc_tick_t date;
     } samples[2];
 } input_rate_t;
 
 struct input_stats {
-    input_rate_t input_bitrate;
-    input_rate_t demux_bitrate;
+    /* The counters are grouped by writing thread and each group starts on
+     * its own (assumed) cache line: each decoder accumulates its counters
+     * per ES and flushes them concurrently with the other decoders, packing
+     * the atomics together would make them false-share. */
+
+    /* access/stream thread */
+    alignas(64) input_rate_t input_bitrate;
+
+    /* demux */
+    alignas(64) input_rate_t demux_bitrate;
     atomic_uintmax_t demux_corrupted;
     atomic_uintmax_t demux_discontinuity;
-    atomic_uintmax_t decoded_audio;
-    atomic_uintmax_t decoded_video;
+
+    /* audio decoder */
+    alignas(64) atomic_uintmax_t decoded_audio;
     atomic_uintmax_t played_abuffers;
     atomic_uintmax_t lost_abuffers;
+
+    /* video decoder */
+    alignas(64) atomic_uintmax_t decoded_video;
     atomic_uintmax_t displayed_pictures;
     atomic_uintmax_t lost_pictures;
+    atomic_int_least64_t decode_latency; /**< average pf_decode() wall time */
+    /** log2(µs) distribution of the per-block decode times */
+    atomic_uintmax_t decode_latency_histogram[INPUT_STATS_LATENCY_BUCKETS];
 };
 
 struct input_stats *input_stats_Create(void);
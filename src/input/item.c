@@ -913,34 +913,36 @@ static int InputItemAddInfo( input_item_t *p_i,
 
 void input_item_SetEpg( input_item_t *p_item, const vlc_epg_t *p_update, bool b_current_source )
 {
-    vlc_epg_t *p_epg = vlc_epg_Duplicate( p_update );
-    if( !p_epg )
-        return;
-
     vlc_mutex_lock( &p_item->lock );
 
     /* */
-    vlc_epg_t **pp_epg = NULL;
+    vlc_epg_t *p_epg = NULL;
     for( int i = 0; i < p_item->i_epg; i++ )
     {
         if( p_item->pp_epg[i]->i_source_id == p_update->i_source_id &&
             p_item->pp_epg[i]->i_id == p_update->i_id )
         {
-            pp_epg = &p_item->pp_epg[i];
+            p_epg = p_item->pp_epg[i];
             break;
         }
     }
 
-    /* replace with new version */
-    if( pp_epg )
+    if( p_epg )
     {
-        vlc_epg_Delete( *pp_epg );
-        if( *pp_epg == p_item->p_epg_table ) /* current table can have changed */
-            p_item->p_epg_table = NULL;
-        *pp_epg = p_epg;
+        /* Periodic refresh of a known table: update in place, reusing
+         * the unchanged events instead of duplicating the whole table */
+        vlc_epg_Merge( p_epg, p_update );
+        if( p_item->p_epg_table == p_epg && !p_epg->b_present )
+            p_item->p_epg_table = NULL; /* current table can have changed */
     }
     else
     {
+        p_epg = vlc_epg_Duplicate( p_update );
+        if( !p_epg )
+        {
+            vlc_mutex_unlock( &p_item->lock );
+            return;
+        }
         TAB_APPEND( p_item->i_epg, p_item->pp_epg, p_epg );
     }
 
@@ -45,6 +45,73 @@ struct vlc_meta_t
     int i_status;
 };
 
+/*
+ * Interned meta strings
+ *
+ * Artist, album, genre and the like repeat across most of a library, so the
+ * fixed-table values are shared through a process-wide refcounted pool
+ * instead of being duplicated for every item.
+ */
+struct meta_intern_entry
+{
+    uintptr_t refs;
+    char str[];
+};
+
+static struct
+{
+    vlc_mutex_t lock;
+    vlc_dictionary_t pool;
+    bool initialized;
+} meta_intern = { VLC_STATIC_MUTEX, { 0, NULL }, false };
+
+static char *vlc_meta_InternString( const char *psz_val )
+{
+    struct meta_intern_entry *e;
+
+    vlc_mutex_lock( &meta_intern.lock );
+    if( unlikely(!meta_intern.initialized) )
+    {
+        vlc_dictionary_init( &meta_intern.pool, 0 );
+        meta_intern.initialized = true;
+    }
+
+    e = vlc_dictionary_value_for_key( &meta_intern.pool, psz_val );
+    if( e != kVLCDictionaryNotFound )
+        e->refs++;
+    else
+    {
+        e = malloc( sizeof( *e ) + strlen( psz_val ) + 1 );
+        if( likely(e != NULL) )
+        {
+            e->refs = 1;
+            strcpy( e->str, psz_val );
+            vlc_dictionary_insert( &meta_intern.pool, psz_val, e );
+        }
+    }
+    vlc_mutex_unlock( &meta_intern.lock );
+
+    return e != NULL ? e->str : NULL;
+}
+
+static void vlc_meta_ReleaseString( char *psz_val )
+{
+    if( psz_val == NULL )
+        return;
+
+    struct meta_intern_entry *e = (struct meta_intern_entry *)
+        (psz_val - offsetof( struct meta_intern_entry, str ));
+
+    vlc_mutex_lock( &meta_intern.lock );
+    if( --e->refs == 0 )
+    {
+        vlc_dictionary_remove_value_for_key( &meta_intern.pool, e->str,
+                                             NULL, NULL );
+        free( e );
+    }
+    vlc_mutex_unlock( &meta_intern.lock );
+}
+
 /* FIXME bad name convention */
 const char * vlc_meta_TypeToLocalizedString( vlc_meta_type_t meta_type )
 {
@@ -108,7 +175,7 @@ static void vlc_meta_FreeExtraKey( void *p_data, void *p_obj )
 void vlc_meta_Delete( vlc_meta_t *m )
 {
     for( int i = 0; i < VLC_META_TYPE_COUNT ; i++ )
-        free( m->ppsz_meta[i] );
+        vlc_meta_ReleaseString( m->ppsz_meta[i] );
     vlc_dictionary_clear( &m->extra_tags, vlc_meta_FreeExtraKey, NULL );
     free( m );
 }
@@ -121,9 +188,9 @@ void vlc_meta_Delete( vlc_meta_t *m )
 
 void vlc_meta_Set( vlc_meta_t *p_meta, vlc_meta_type_t meta_type, const char *psz_val )
 {
-    free( p_meta->ppsz_meta[meta_type] );
+    vlc_meta_ReleaseString( p_meta->ppsz_meta[meta_type] );
     assert( psz_val == NULL || IsUTF8( psz_val ) );
-    p_meta->ppsz_meta[meta_type] = psz_val ? strdup( psz_val ) : NULL;
+    p_meta->ppsz_meta[meta_type] = psz_val ? vlc_meta_InternString( psz_val ) : NULL;
 }
 
 const char *vlc_meta_Get( const vlc_meta_t *p_meta, vlc_meta_type_t meta_type )
@@ -181,8 +248,8 @@ void vlc_meta_Merge( vlc_meta_t *dst, const vlc_meta_t *src )
     {
         if( src->ppsz_meta[i] )
         {
-            free( dst->ppsz_meta[i] );
-            dst->ppsz_meta[i] = strdup( src->ppsz_meta[i] );
+            vlc_meta_ReleaseString( dst->ppsz_meta[i] );
+            dst->ppsz_meta[i] = vlc_meta_InternString( src->ppsz_meta[i] );
         }
     }
 
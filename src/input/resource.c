@@ -61,6 +61,12 @@ struct input_resource_t
     vout_thread_t   *p_vout_free;
     vout_thread_t   *p_vout_dummy;
 
+    /* Stopped secondary vouts kept warm for reuse, so that their window and
+     * decoder device survive across media changes (protected by lock) */
+    vout_thread_t   **pp_vout_warm;
+    int             i_vout_warm;
+    int             i_vout_pool; /**< total stopped vouts kept for reuse */
+
     /* This lock is used to protect vout resources access (for hold)
      * It is a special case because of embed video (possible deadlock
      * between vout window request and vout holds in some(qt) interface)
@@ -155,6 +161,10 @@ static void DestroyVout( input_resource_t *p_resource )
         vout_Close( p_resource->p_vout_free );
         p_resource->p_vout_free = NULL;
     }
+
+    for( int i = 0; i < p_resource->i_vout_warm; i++ )
+        vout_Close( p_resource->pp_vout_warm[i] );
+    TAB_CLEAN( p_resource->i_vout_warm, p_resource->pp_vout_warm );
 }
 
 static void DisplayVoutTitle( input_resource_t *p_resource,
@@ -284,6 +294,8 @@ input_resource_t *input_resource_New( vlc_object_t *p_parent )
 
     vlc_atomic_rc_init( &p_resource->rc );
     p_resource->p_parent = p_parent;
+    TAB_INIT( p_resource->i_vout_warm, p_resource->pp_vout_warm );
+    p_resource->i_vout_pool = var_InheritInteger( p_parent, "vout-pool-size" );
     vlc_mutex_init( &p_resource->lock );
     vlc_mutex_init( &p_resource->lock_hold );
     return p_resource;
@@ -322,6 +334,18 @@ void input_resource_SetInput( input_resource_t *p_resource, input_thread_t *p_in
     vlc_mutex_unlock( &p_resource->lock );
 }
 
+void input_resource_ResetInput( input_resource_t *p_resource, input_thread_t *p_input )
+{
+    vlc_mutex_lock( &p_resource->lock );
+
+    /* No vout assertion here: with overlapped media switching, the next
+     * input may already be using a vout when the previous one detaches */
+    if( p_resource->p_input == p_input )
+        p_resource->p_input = NULL;
+
+    vlc_mutex_unlock( &p_resource->lock );
+}
+
 static void input_resource_PutVoutLocked(input_resource_t *p_resource,
                                          vout_thread_t *vout)
 {
@@ -339,7 +363,6 @@ static void input_resource_PutVoutLocked(input_resource_t *p_resource,
     }
     else
     {
-        msg_Dbg(p_resource->p_parent, "destroying vout (already one saved or active)");
 #ifndef NDEBUG
         {
             int index;
@@ -351,7 +374,17 @@ static void input_resource_PutVoutLocked(input_resource_t *p_resource,
         TAB_REMOVE(p_resource->i_vout, p_resource->pp_vout, vout);
         vlc_mutex_unlock(&p_resource->lock_hold);
         vout_Stop(vout);
-        vout_Close(vout);
+
+        if (p_resource->i_vout_warm < p_resource->i_vout_pool - 1)
+        {
+            msg_Dbg(p_resource->p_parent, "saving a warm vout");
+            TAB_APPEND(p_resource->i_vout_warm, p_resource->pp_vout_warm, vout);
+        }
+        else
+        {
+            msg_Dbg(p_resource->p_parent, "destroying vout (already one saved or active)");
+            vout_Close(vout);
+        }
     }
 }
 
@@ -375,7 +408,28 @@ vout_thread_t *input_resource_GetVoutDecoderDevice(input_resource_t *p_resource,
         cfg_vout = p_resource->p_vout_free;
         p_resource->p_vout_free = NULL;
 
-        if (cfg_vout == NULL) {
+        if (cfg_vout != NULL)
+        {
+            /* The free vout is always the first one */
+            *order = VLC_VOUT_ORDER_PRIMARY;
+            msg_Dbg(p_resource->p_parent, "trying to reuse free vout");
+        }
+        else if (p_resource->i_vout > 0 && p_resource->i_vout_warm > 0)
+        {
+            /* Warm vouts were created as secondary vouts: they lack the
+             * pre-configuration inherited from the dummy vout, so they are
+             * only reused for secondary requests. */
+            cfg_vout = vout =
+                p_resource->pp_vout_warm[--p_resource->i_vout_warm];
+            msg_Dbg(p_resource->p_parent, "trying to reuse warm vout");
+
+            vlc_mutex_lock(&p_resource->lock_hold);
+            *order = VLC_VOUT_ORDER_SECONDARY;
+            TAB_APPEND(p_resource->i_vout, p_resource->pp_vout, vout);
+            vlc_mutex_unlock(&p_resource->lock_hold);
+        }
+        else
+        {
             /* Use the dummy vout as the parent of the future main vout. This
              * will allow the future vout to inherit all parameters
              * pre-configured on this dummy vout. */
@@ -390,11 +444,6 @@ vout_thread_t *input_resource_GetVoutDecoderDevice(input_resource_t *p_resource,
                                              : VLC_VOUT_ORDER_SECONDARY;
             TAB_APPEND(p_resource->i_vout, p_resource->pp_vout, vout);
             vlc_mutex_unlock(&p_resource->lock_hold);
-        } else
-        {
-            /* The free vout is always the first one */
-            *order = VLC_VOUT_ORDER_PRIMARY;
-            msg_Dbg(p_resource->p_parent, "trying to reuse free vout");
         }
     }
     else
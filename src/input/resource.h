@@ -32,6 +32,13 @@
  */
 void input_resource_SetInput( input_resource_t *, input_thread_t * );
 
+/**
+ * This function clears the associated input, but only if it is still the
+ * given one: with overlapped media switching, a new input may already have
+ * registered itself by the time the previous one is torn down.
+ */
+void input_resource_ResetInput( input_resource_t *, input_thread_t * );
+
 /**
  * This function handles sout request.
  */
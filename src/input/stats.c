@@ -35,20 +35,47 @@
  */
 static void input_rate_Init(input_rate_t *rate)
 {
-    vlc_mutex_init(&rate->lock);
-    rate->updates = 0;
-    rate->value = 0;
-    rate->samples[0].date = VLC_TICK_INVALID;
-    rate->samples[1].date = VLC_TICK_INVALID;
+    atomic_init(&rate->seq, 0);
+    atomic_init(&rate->updates, 0);
+    atomic_init(&rate->value, 0);
+    atomic_init(&rate->samples[0].value, 0);
+    atomic_init(&rate->samples[0].date, VLC_TICK_INVALID);
+    atomic_init(&rate->samples[1].value, 0);
+    atomic_init(&rate->samples[1].date, VLC_TICK_INVALID);
 }
 
-static float stats_GetRate(const input_rate_t *rate)
+/* Read a consistent snapshot of a rate counter without blocking the writing
+ * thread: retry while an update is in progress (the critical section of
+ * input_rate_Add() is a handful of stores). */
+static void input_rate_Read(input_rate_t *rate, uintmax_t *restrict updates,
+                            uintmax_t *restrict value, float *restrict rate_out)
 {
-    if (rate->samples[1].date == VLC_TICK_INVALID)
-        return 0.;
+    uintmax_t values[2];
+    vlc_tick_t dates[2];
+    unsigned seq;
 
-    return (rate->samples[0].value - rate->samples[1].value)
-        / (float)(rate->samples[0].date - rate->samples[1].date);
+    do
+    {
+        while ((seq = atomic_load_explicit(&rate->seq,
+                                           memory_order_acquire)) & 1);
+
+        *updates = atomic_load_explicit(&rate->updates, memory_order_relaxed);
+        *value = atomic_load_explicit(&rate->value, memory_order_relaxed);
+        for (int i = 0; i < 2; i++)
+        {
+            values[i] = atomic_load_explicit(&rate->samples[i].value,
+                                             memory_order_relaxed);
+            dates[i] = atomic_load_explicit(&rate->samples[i].date,
+                                            memory_order_relaxed);
+        }
+        atomic_thread_fence(memory_order_acquire);
+    }
+    while (atomic_load_explicit(&rate->seq, memory_order_relaxed) != seq);
+
+    if (dates[1] == VLC_TICK_INVALID)
+        *rate_out = 0.;
+    else
+        *rate_out = (values[0] - values[1]) / (float)(dates[0] - dates[1]);
 }
 
 struct input_stats *input_stats_Create(void)
@@ -67,6 +94,9 @@ struct input_stats *input_stats_Create(void)
     atomic_init(&stats->lost_abuffers, 0);
     atomic_init(&stats->displayed_pictures, 0);
     atomic_init(&stats->lost_pictures, 0);
+    atomic_init(&stats->decode_latency, 0);
+    for (size_t i = 0; i < ARRAY_SIZE(stats->decode_latency_histogram); i++)
+        atomic_init(&stats->decode_latency_histogram[i], 0);
     return stats;
 }
 
@@ -77,17 +107,17 @@ void input_stats_Destroy(struct input_stats *stats)
 
 void input_stats_Compute(struct input_stats *stats, input_stats_t *st)
 {
+    uintmax_t updates, value;
+
     /* Input */
-    vlc_mutex_lock(&stats->input_bitrate.lock);
-    st->i_read_packets = stats->input_bitrate.updates;
-    st->i_read_bytes = stats->input_bitrate.value;
-    st->f_input_bitrate = stats_GetRate(&stats->input_bitrate);
-    vlc_mutex_unlock(&stats->input_bitrate.lock);
-
-    vlc_mutex_lock(&stats->demux_bitrate.lock);
-    st->i_demux_read_bytes = stats->demux_bitrate.value;
-    st->f_demux_bitrate = stats_GetRate(&stats->demux_bitrate);
-    vlc_mutex_unlock(&stats->demux_bitrate.lock);
+    input_rate_Read(&stats->input_bitrate, &updates, &value,
+                    &st->f_input_bitrate);
+    st->i_read_packets = updates;
+    st->i_read_bytes = value;
+
+    input_rate_Read(&stats->demux_bitrate, &updates, &value,
+                    &st->f_demux_bitrate);
+    st->i_demux_read_bytes = value;
     st->i_demux_corrupted = atomic_load_explicit(&stats->demux_corrupted,
                                                  memory_order_relaxed);
     st->i_demux_discontinuity = atomic_load_explicit(
@@ -108,6 +138,11 @@ void input_stats_Compute(struct input_stats *stats, input_stats_t *st)
                                                     memory_order_relaxed);
     st->i_lost_pictures = atomic_load_explicit(&stats->lost_pictures,
                                                memory_order_relaxed);
+    st->i_decode_latency = atomic_load_explicit(&stats->decode_latency,
+                                                memory_order_relaxed);
+    for (size_t i = 0; i < ARRAY_SIZE(stats->decode_latency_histogram); i++)
+        st->pi_decode_latency_histogram[i] = atomic_load_explicit(
+                &stats->decode_latency_histogram[i], memory_order_relaxed);
 }
 
 /** Update a counter element with new values
@@ -117,23 +152,36 @@ void input_stats_Compute(struct input_stats *stats, input_stats_t *st)
  */
 void input_rate_Add(input_rate_t *counter, uintmax_t val)
 {
-    vlc_mutex_lock(&counter->lock);
-    counter->updates++;
-    counter->value += val;
+    /* Each counter has a single writing thread, so plain loads and stores
+     * are sufficient. The sequence counter is odd while the update is in
+     * progress so that input_rate_Read() never sees a torn sample pair. */
+    unsigned seq = atomic_load_explicit(&counter->seq, memory_order_relaxed);
+    atomic_store(&counter->seq, seq + 1);
+
+    uintmax_t updates = atomic_load_explicit(&counter->updates,
+                                             memory_order_relaxed) + 1;
+    uintmax_t value = atomic_load_explicit(&counter->value,
+                                           memory_order_relaxed) + val;
+    atomic_store_explicit(&counter->updates, updates, memory_order_relaxed);
+    atomic_store_explicit(&counter->value, value, memory_order_relaxed);
 
     /* Ignore samples within a second of another */
     vlc_tick_t now = vlc_tick_now();
-    if (counter->samples[0].date != VLC_TICK_INVALID
-     && (now - counter->samples[0].date) < VLC_TICK_FROM_SEC(1))
+    vlc_tick_t last = atomic_load_explicit(&counter->samples[0].date,
+                                           memory_order_relaxed);
+    if (last == VLC_TICK_INVALID || (now - last) >= VLC_TICK_FROM_SEC(1))
     {
-        vlc_mutex_unlock(&counter->lock);
-        return;
+        atomic_store_explicit(&counter->samples[1].value,
+                atomic_load_explicit(&counter->samples[0].value,
+                                     memory_order_relaxed),
+                memory_order_relaxed);
+        atomic_store_explicit(&counter->samples[1].date, last,
+                              memory_order_relaxed);
+        atomic_store_explicit(&counter->samples[0].value, value,
+                              memory_order_relaxed);
+        atomic_store_explicit(&counter->samples[0].date, now,
+                              memory_order_relaxed);
     }
 
-    memcpy(counter->samples + 1, counter->samples,
-           sizeof (counter->samples[0]));
-
-    counter->samples[0].value = counter->value;
-    counter->samples[0].date = now;
-    vlc_mutex_unlock(&counter->lock);
+    atomic_store(&counter->seq, seq + 2);
 }
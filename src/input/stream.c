@@ -81,6 +81,7 @@ stream_t *vlc_stream_CustomNew(vlc_object_t *parent,
     s->pf_read = NULL;
     s->pf_block = NULL;
     s->pf_readdir = NULL;
+    s->b_readdir_incremental = false;
     s->pf_seek = NULL;
     s->pf_control = NULL;
     s->p_sys = NULL;
@@ -594,6 +595,43 @@ block_t *vlc_stream_ReadBlock(stream_t *s)
     return block;
 }
 
+block_t *vlc_stream_GetBlocks(stream_t *s, size_t max)
+{
+    stream_priv_t *priv = (stream_priv_t *)s;
+    block_t *chain = NULL, **pp = &chain;
+    size_t total = 0;
+
+    /* First drain whatever is already buffered, copy-free. */
+    while (total < max)
+    {
+        block_t *block;
+
+        if (priv->peek != NULL)
+        {
+            block = priv->peek;
+            priv->peek = NULL;
+        }
+        else if (priv->block != NULL)
+        {
+            block = priv->block;
+            priv->block = NULL;
+        }
+        else
+            break;
+
+        priv->offset += block->i_buffer;
+        total += block->i_buffer;
+        *pp = block;
+        pp = &block->p_next;
+    }
+
+    /* Then, and only if nothing was buffered, wait for fresh data once. */
+    if (chain == NULL)
+        chain = vlc_stream_ReadBlock(s);
+
+    return chain;
+}
+
 uint64_t vlc_stream_Tell(const stream_t *s)
 {
     const stream_priv_t *priv = (const stream_priv_t *)s;
@@ -733,6 +771,22 @@ block_t *vlc_stream_Block( stream_t *s, size_t size )
 }
 
 int vlc_stream_ReadDir( stream_t *s, input_item_node_t *p_node )
+{
+    int ret, i_children;
+
+    assert(s->pf_readdir != NULL);
+    /* Drain incremental directories so the whole listing is returned */
+    do
+    {
+        i_children = p_node->i_children;
+        ret = s->pf_readdir( s, p_node );
+    }
+    while( s->b_readdir_incremental && ret == VLC_SUCCESS
+        && p_node->i_children > i_children );
+    return ret;
+}
+
+int vlc_stream_ReadDirPartial( stream_t *s, input_item_node_t *p_node )
 {
     assert(s->pf_readdir != NULL);
     return s->pf_readdir( s, p_node );
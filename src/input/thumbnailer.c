@@ -55,6 +55,10 @@ typedef struct vlc_thumbnailer_params_t
     vlc_tick_t timeout;
     vlc_thumbnailer_cb cb;
     void* user_data;
+    /* Batch request (RequestByTimes): seek points, owned by the request */
+    vlc_tick_t* times;
+    size_t count;
+    vlc_thumbnailer_seq_cb seq_cb;
 } vlc_thumbnailer_params_t;
 
 struct vlc_thumbnailer_request_t
@@ -63,6 +67,8 @@ struct vlc_thumbnailer_request_t
     input_thread_t *input_thread;
 
     vlc_thumbnailer_params_t params;
+    /* Next timestamp to be generated for a batch request */
+    size_t index;
 
     vlc_mutex_t lock;
     bool done;
@@ -81,6 +87,51 @@ on_thumbnailer_input_event( input_thread_t *input,
     vlc_thumbnailer_request_t* request = userdata;
     picture_t *pic = NULL;
 
+    if ( request->params.count > 0 )
+    {
+        /*
+         * Batch request: deliver the picture and seek to the next timestamp,
+         * reusing the same input thread and decoder, instead of paying a full
+         * pipeline setup per thumbnail.
+         */
+        if ( event->type == INPUT_EVENT_THUMBNAIL_READY )
+            pic = event->thumbnail;
+
+        vlc_mutex_lock( &request->lock );
+        if ( request->params.seq_cb != NULL )
+        {
+            if ( pic != NULL )
+            {
+                request->params.seq_cb( request->params.user_data,
+                                        request->index++, pic );
+                if ( request->index < request->params.count )
+                {
+                    /* A seek resets the decoder "first picture" state, so the
+                     * next displayed date will yield a new thumbnail event */
+                    input_SetTime( request->input_thread,
+                                   request->params.times[request->index],
+                                   request->params.fast_seek );
+                    vlc_mutex_unlock( &request->lock );
+                    return;
+                }
+            }
+            else
+            {
+                /* Error or end of stream: fail the remaining timestamps */
+                while ( request->index < request->params.count )
+                    request->params.seq_cb( request->params.user_data,
+                                            request->index++, NULL );
+            }
+            request->params.seq_cb = NULL;
+        }
+        request->done = true;
+        vlc_mutex_unlock( &request->lock );
+        if ( pic != NULL )
+            input_Stop( request->input_thread );
+        background_worker_RequestProbe( request->thumbnailer->worker );
+        return;
+    }
+
     if ( event->type == INPUT_EVENT_THUMBNAIL_READY )
     {
         /*
@@ -117,9 +168,26 @@ static void thumbnailer_request_Release( void* data )
         input_Close( request->input_thread );
 
     input_item_Release( request->params.input_item );
+    free( request->params.times );
     free( request );
 }
 
+static void thumbnailer_request_Fail( vlc_thumbnailer_request_t* request )
+{
+    if ( request->params.seq_cb != NULL )
+    {
+        while ( request->index < request->params.count )
+            request->params.seq_cb( request->params.user_data,
+                                    request->index++, NULL );
+        request->params.seq_cb = NULL;
+    }
+    else if ( request->params.cb != NULL )
+    {
+        request->params.cb( request->params.user_data, NULL );
+        request->params.cb = NULL;
+    }
+}
+
 static int thumbnailer_request_Start( void* owner, void* entity, void** out )
 {
     vlc_thumbnailer_t* thumbnailer = owner;
@@ -130,10 +198,15 @@ static int thumbnailer_request_Start( void* owner, void* entity, void** out )
                                      request->params.input_item );
     if ( unlikely( input == NULL ) )
     {
-        request->params.cb( request->params.user_data, NULL );
+        thumbnailer_request_Fail( request );
         return VLC_EGENERIC;
     }
-    if ( request->params.type == VLC_THUMBNAILER_SEEK_TIME )
+    if ( request->params.count > 0 )
+    {
+        input_SetTime( input, request->params.times[0],
+                       request->params.fast_seek );
+    }
+    else if ( request->params.type == VLC_THUMBNAILER_SEEK_TIME )
     {
         input_SetTime( input, request->params.time,
                        request->params.fast_seek );
@@ -146,7 +219,7 @@ static int thumbnailer_request_Start( void* owner, void* entity, void** out )
     }
     if ( input_Start( input ) != VLC_SUCCESS )
     {
-        request->params.cb( request->params.user_data, NULL );
+        thumbnailer_request_Fail( request );
         return VLC_EGENERIC;
     }
     *out = request;
@@ -161,13 +234,10 @@ static void thumbnailer_request_Stop( void* owner, void* handle )
     vlc_mutex_lock( &request->lock );
     /*
      * If the callback hasn't been invoked yet, we assume a timeout and
-     * signal it back to the user
+     * signal it back to the user. Batch requests time out as a whole: all
+     * the timestamps left to generate are failed.
      */
-    if ( request->params.cb != NULL )
-    {
-        request->params.cb( request->params.user_data, NULL );
-        request->params.cb = NULL;
-    }
+    thumbnailer_request_Fail( request );
     vlc_mutex_unlock( &request->lock );
     assert( request->input_thread != NULL );
     input_Stop( request->input_thread );
@@ -189,10 +259,14 @@ thumbnailer_RequestCommon( vlc_thumbnailer_t* thumbnailer,
 {
     vlc_thumbnailer_request_t *request = malloc( sizeof( *request ) );
     if ( unlikely( request == NULL ) )
+    {
+        free( params->times );
         return NULL;
+    }
     request->thumbnailer = thumbnailer;
     request->input_thread = NULL;
     request->params = *(vlc_thumbnailer_params_t*)params;
+    request->index = 0;
     request->done = false;
     input_item_Hold( request->params.input_item );
     vlc_mutex_init( &request->lock );
@@ -245,12 +319,40 @@ vlc_thumbnailer_RequestByPos( vlc_thumbnailer_t *thumbnailer,
         });
 }
 
+vlc_thumbnailer_request_t*
+vlc_thumbnailer_RequestByTimes( vlc_thumbnailer_t *thumbnailer,
+                                const vlc_tick_t *times, size_t count,
+                                enum vlc_thumbnailer_seek_speed speed,
+                                input_item_t *input_item, vlc_tick_t timeout,
+                                vlc_thumbnailer_seq_cb cb, void* user_data )
+{
+    assert( count > 0 );
+
+    vlc_tick_t *times_copy = vlc_alloc( count, sizeof( *times_copy ) );
+    if ( unlikely( times_copy == NULL ) )
+        return NULL;
+    memcpy( times_copy, times, count * sizeof( *times_copy ) );
+
+    return thumbnailer_RequestCommon( thumbnailer,
+            &(const vlc_thumbnailer_params_t){
+                .type = VLC_THUMBNAILER_SEEK_TIME,
+                .fast_seek = speed == VLC_THUMBNAILER_SEEK_FAST,
+                .input_item = input_item,
+                .timeout = timeout,
+                .times = times_copy,
+                .count = count,
+                .seq_cb = cb,
+                .user_data = user_data,
+        });
+}
+
 void vlc_thumbnailer_Cancel( vlc_thumbnailer_t* thumbnailer,
                              vlc_thumbnailer_request_t* req )
 {
     vlc_mutex_lock( &req->lock );
     /* Ensure we won't invoke the callback if the input was running. */
     req->params.cb = NULL;
+    req->params.seq_cb = NULL;
     vlc_mutex_unlock( &req->lock );
     background_worker_Cancel( thumbnailer->worker, req );
 }
@@ -143,6 +143,7 @@ vlm_t *vlm_New( libvlc_int_t *libvlc, const char *psz_vlmconf )
     p_vlm->exiting = false;
     p_vlm->i_id = 1;
     TAB_INIT( p_vlm->i_media, p_vlm->media );
+    vlc_dictionary_init( &p_vlm->media_by_name, 0 );
     TAB_INIT( p_vlm->i_schedule, p_vlm->schedule );
     var_Create( p_vlm, "intf-event", VLC_VAR_ADDRESS );
 
@@ -202,6 +203,7 @@ void vlm_Delete( vlm_t *p_vlm )
     vlc_mutex_lock( &p_vlm->lock );
     vlm_ControlInternal( p_vlm, VLM_CLEAR_MEDIAS );
     TAB_CLEAN( p_vlm->i_media, p_vlm->media );
+    vlc_dictionary_clear( &p_vlm->media_by_name, NULL, NULL );
 
     vlm_ControlInternal( p_vlm, VLM_CLEAR_SCHEDULES );
     TAB_CLEAN( p_vlm->i_schedule, p_vlm->schedule );
@@ -395,21 +397,28 @@ typedef struct
 /* */
 static vlm_media_sys_t *vlm_ControlMediaGetById( vlm_t *p_vlm, int64_t id )
 {
-    for( int i = 0; i < p_vlm->i_media; i++ )
+    /* Ids grow monotonically and deletions keep the insertion order, so
+     * the media table is sorted by id */
+    int i_lower = 0;
+    int i_upper = p_vlm->i_media - 1;
+
+    while( i_lower <= i_upper )
     {
-        if( p_vlm->media[i]->cfg.id == id )
-            return p_vlm->media[i];
+        const int i_mid = ( i_lower + i_upper ) / 2;
+        vlm_media_sys_t *p_media = p_vlm->media[i_mid];
+
+        if( p_media->cfg.id == id )
+            return p_media;
+        if( p_media->cfg.id < id )
+            i_lower = i_mid + 1;
+        else
+            i_upper = i_mid - 1;
     }
     return NULL;
 }
 static vlm_media_sys_t *vlm_ControlMediaGetByName( vlm_t *p_vlm, const char *psz_name )
 {
-    for( int i = 0; i < p_vlm->i_media; i++ )
-    {
-        if( !strcmp( p_vlm->media[i]->cfg.psz_name, psz_name ) )
-            return p_vlm->media[i];
-    }
-    return NULL;
+    return vlc_dictionary_value_for_key( &p_vlm->media_by_name, psz_name );
 }
 static int vlm_MediaDescriptionCheck( vlm_t *p_vlm, vlm_media_t *p_cfg )
 {
@@ -453,8 +462,13 @@ static int vlm_ControlMediaChange( vlm_t *p_vlm, vlm_media_t *p_cfg )
         /* TODO check what are the changes being done (stop instance if needed) */
     }
 
+    /* The media can be renamed by the new configuration */
+    vlc_dictionary_remove_value_for_key( &p_vlm->media_by_name,
+                                         p_media->cfg.psz_name, NULL, NULL );
     vlm_media_Clean( &p_media->cfg );
     vlm_media_Copy( &p_media->cfg, p_cfg );
+    vlc_dictionary_insert( &p_vlm->media_by_name, p_media->cfg.psz_name,
+                           p_media );
 
     return vlm_OnMediaUpdate( p_vlm, p_media );
 }
@@ -498,6 +512,8 @@ static int vlm_ControlMediaAdd( vlm_t *p_vlm, vlm_media_t *p_cfg, int64_t *p_id
 
     /* */
     TAB_APPEND( p_vlm->i_media, p_vlm->media, p_media );
+    vlc_dictionary_insert( &p_vlm->media_by_name, p_media->cfg.psz_name,
+                           p_media );
 
     if( p_id )
         *p_id = p_media->cfg.id;
@@ -520,6 +536,8 @@ static int vlm_ControlMediaDel( vlm_t *p_vlm, int64_t id )
     /* */
     vlm_SendEventMediaRemoved( p_vlm, id, p_media->cfg.psz_name );
 
+    vlc_dictionary_remove_value_for_key( &p_vlm->media_by_name,
+                                         p_media->cfg.psz_name, NULL, NULL );
     vlm_media_Clean( &p_media->cfg );
 
     TAB_REMOVE( p_vlm->i_media, p_vlm->media, p_media );
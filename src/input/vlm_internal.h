@@ -90,9 +90,11 @@ struct vlm_t
     /* */
     int64_t        i_id;
 
-    /* Media list */
+    /* Media list, sorted by id */
     int                i_media;
     vlm_media_sys_t    **media;
+    /* Name to vlm_media_sys_t * index of the media list */
+    vlc_dictionary_t   media_by_name;
 
     /* Schedule list */
     int            i_schedule;
@@ -89,6 +89,17 @@ static const char *const ppsz_snap_formats[] =
     "This is the verbosity level (0=only errors and " \
     "standard messages, 1=warnings, 2=debug).")
 
+#define TRACER_TEXT N_("Tracer module")
+#define TRACER_LONGTEXT N_( \
+    "Record timestamped trace events from the playback pipeline with the " \
+    "given tracer module. Tracing is disabled when no module is set." )
+
+#define LOG_ASYNC_TEXT N_("Asynchronous logging")
+#define LOG_ASYNC_LONGTEXT N_( \
+    "Queue log messages and write them out from a dedicated low-priority " \
+    "thread, so that logging does not slow down the threads producing the " \
+    "messages. Messages can be lost if the queue overflows." )
+
 #define OPEN_TEXT N_("Default stream")
 #define OPEN_LONGTEXT N_( \
     "This stream will always be opened at VLC startup." )
@@ -131,6 +142,19 @@ static const char *const ppsz_snap_formats[] =
     "This may result on audio not working if the output can't adapt to the " \
     "input format.")
 
+#define AUDIO_DRIFT_TRIM_TEXT N_("Correct clock drift without resampling")
+#define AUDIO_DRIFT_TRIM_LONGTEXT N_( \
+    "Compensate the drift between the playback clock and the audio device " \
+    "clock by dropping or inserting a few samples at block boundaries " \
+    "instead of engaging the resampler. This saves CPU on outputs whose " \
+    "device clock reporting is accurate.")
+
+#define GAPLESS_AUDIO_TEXT N_("Gapless audio output")
+#define GAPLESS_AUDIO_LONGTEXT N_( \
+    "Keep the audio output stream running when playback moves to the next " \
+    "item, and reuse it without restarting the audio device when the audio " \
+    "format is identical.")
+
 #define AUDIO_TEXT N_("Enable audio")
 #define AUDIO_LONGTEXT N_( \
     "You can completely disable the audio output. The audio " \
@@ -259,6 +283,12 @@ static const char *const ppsz_replay_gain_mode_text[] = {
     "This is the the video output method used by VLC. " \
     "The default behavior is to automatically select the best method available.")
 
+#define VOUT_POOL_SIZE_TEXT N_("Video output pool size")
+#define VOUT_POOL_SIZE_LONGTEXT N_( \
+    "Total number of stopped video outputs kept warm for reuse across media " \
+    "changes. Keeping more than one avoids closing and reopening windows " \
+    "when playing items with several video tracks back to back.")
+
 #define VIDEO_TEXT N_("Enable video")
 #define VIDEO_LONGTEXT N_( \
     "You can completely disable the video output. The video " \
@@ -401,6 +431,12 @@ static const char *const screensaver_texts[] = {
     "picture quality, for instance deinterlacing, or distort " \
     "the video.")
 
+#define PIPELINED_FILTERS_TEXT N_("Pipelined video filters")
+#define PIPELINED_FILTERS_LONGTEXT N_( \
+    "Run each video filter of a chain on its own thread so that the " \
+    "filters overlap across CPU cores. This lowers the per-frame filtering " \
+    "time of long chains at the cost of a few pictures of extra latency.")
+
 #define SNAP_PATH_TEXT N_("Video snapshot directory (or filename)")
 #define SNAP_PATH_LONGTEXT N_( \
     "Directory where the video snapshots will be stored.")
@@ -433,6 +469,12 @@ static const char *const screensaver_texts[] = {
     "it will keep the original height (-1). Using 0 will scale the height " \
     "to keep the aspect ratio." )
 
+#define IMAGE_ENCODER_TEXT N_("Preferred image encoder list")
+#define IMAGE_ENCODER_LONGTEXT N_( \
+    "List of encoders that VLC will use in priority to encode images " \
+    "(for snapshots and thumbnails). Hardware encoders can be selected " \
+    "here. \"Any\" lets VLC pick the first suitable one." )
+
 #define CROP_TEXT N_("Video cropping")
 #define CROP_LONGTEXT N_( \
     "This forces the cropping of the source video. " \
@@ -490,6 +532,12 @@ static const char *const screensaver_texts[] = {
     "This drops frames that are late (arrive to the video output after " \
     "their intended display date)." )
 
+#define VOUT_PIPELINE_TEXT N_("Pipelined video rendering")
+#define VOUT_PIPELINE_LONGTEXT N_( \
+    "Render and prepare each frame as soon as the previous one has been " \
+    "displayed instead of right before its display deadline. This trades " \
+    "one frame of latency for immunity to rendering time jitter." )
+
 #define QUIET_SYNCHRO_TEXT N_("Quiet synchro")
 #define QUIET_SYNCHRO_LONGTEXT N_( \
     "This avoids flooding the message log with debug output from the " \
@@ -686,6 +734,13 @@ static const char *const ppsz_prefres[] = {
 #define INPUT_FAST_SEEK_LONGTEXT N_( \
     "Favor speed over precision while seeking" )
 
+#define FAST_MEDIA_SWITCH_TEXT N_("Fast media switching")
+#define FAST_MEDIA_SWITCH_LONGTEXT N_( \
+    "When changing media during playback, open the next media while the " \
+    "previous one is still being torn down, keeping the outputs alive for " \
+    "reuse. This lowers the switch latency at the cost of transiently " \
+    "higher resource usage." )
+
 #define INPUT_RATE_TEXT N_("Playback speed")
 #define INPUT_RATE_LONGTEXT N_( \
     "This defines the playback speed (nominal speed is 1.0)." )
@@ -722,6 +777,16 @@ static const char *const ppsz_prefres[] = {
     "When possible, the input stream will be recorded instead of using " \
     "the stream output module" )
 
+#define INPUT_RECORD_SEGMENT_SIZE_TEXT N_("Record segment size")
+#define INPUT_RECORD_SEGMENT_SIZE_LONGTEXT N_( \
+    "Start a new record file once the current one exceeds this size, " \
+    "in MiB. 0 means a single file of unbounded size." )
+
+#define INPUT_RECORD_SEGMENT_TIME_TEXT N_("Record segment duration")
+#define INPUT_RECORD_SEGMENT_TIME_LONGTEXT N_( \
+    "Start a new record file once the current one covers this duration, " \
+    "in seconds. 0 means a single file of unbounded duration." )
+
 #define INPUT_TIMESHIFT_PATH_TEXT N_("Timeshift directory")
 #define INPUT_TIMESHIFT_PATH_LONGTEXT N_( \
     "Directory used to store the timeshift temporary files." )
@@ -1606,6 +1671,8 @@ vlc_module_begin ()
 
     add_bool( "audio-time-stretch", true,
               AUDIO_TIME_STRETCH_TEXT, AUDIO_TIME_STRETCH_LONGTEXT, false )
+    add_bool( "gapless-audio", false, GAPLESS_AUDIO_TEXT,
+              GAPLESS_AUDIO_LONGTEXT, true )
 
     set_subcategory( SUBCAT_AUDIO_AOUT )
     add_module("aout", "audio output", NULL, AOUT_TEXT, AOUT_LONGTEXT)
@@ -1625,6 +1692,8 @@ vlc_module_begin ()
     set_subcategory( SUBCAT_AUDIO_RESAMPLER )
     add_module("audio-resampler", "audio resampler", NULL,
                AUDIO_RESAMPLER_TEXT, AUDIO_RESAMPLER_LONGTEXT)
+    add_bool( "audio-drift-trim", false, AUDIO_DRIFT_TRIM_TEXT,
+              AUDIO_DRIFT_TRIM_LONGTEXT, true )
 
 
 /* Video options */
@@ -1645,6 +1714,8 @@ vlc_module_begin ()
         change_private ()
     add_bool( "drop-late-frames", 1, DROP_LATE_FRAMES_TEXT,
               DROP_LATE_FRAMES_LONGTEXT, true )
+    add_bool( "vout-pipeline", 0, VOUT_PIPELINE_TEXT,
+              VOUT_PIPELINE_LONGTEXT, true )
     /* Used in vout_synchro */
     add_bool( "skip-frames", 1, SKIP_FRAMES_TEXT,
               SKIP_FRAMES_LONGTEXT, true )
@@ -1691,6 +1762,8 @@ vlc_module_begin ()
                  SNAP_WIDTH_LONGTEXT, true )
     add_integer( "snapshot-height", -1, SNAP_HEIGHT_TEXT,
                  SNAP_HEIGHT_LONGTEXT, true )
+    add_module( "image-encoder", "encoder", NULL,
+                IMAGE_ENCODER_TEXT, IMAGE_ENCODER_LONGTEXT )
 
     set_section( N_("Window properties" ), NULL )
     add_integer( "width", -1, WIDTH_TEXT, WIDTH_LONGTEXT, true )
@@ -1738,10 +1811,14 @@ vlc_module_begin ()
     set_subcategory( SUBCAT_VIDEO_VOUT )
     add_module("vout", "vout display", NULL, VOUT_TEXT, VOUT_LONGTEXT)
         change_short('V')
+    add_integer( "vout-pool-size", 1,
+                 VOUT_POOL_SIZE_TEXT, VOUT_POOL_SIZE_LONGTEXT, true )
 
     set_subcategory( SUBCAT_VIDEO_VFILTER )
     add_module_list("video-filter", "video filter", NULL,
                     VIDEO_FILTER_TEXT, VIDEO_FILTER_LONGTEXT)
+    add_bool( "pipelined-filters", false,
+              PIPELINED_FILTERS_TEXT, PIPELINED_FILTERS_LONGTEXT, true )
 
 #if 0
     add_string( "pixel-ratio", "1", PIXEL_RATIO_TEXT, PIXEL_RATIO_TEXT )
@@ -1863,6 +1940,8 @@ vlc_module_begin ()
     add_bool( "input-fast-seek", false,
               INPUT_FAST_SEEK_TEXT, INPUT_FAST_SEEK_LONGTEXT, false )
         change_safe ()
+    add_bool( "fast-media-switch", false,
+              FAST_MEDIA_SWITCH_TEXT, FAST_MEDIA_SWITCH_LONGTEXT, true )
     add_float( "rate", 1.,
                INPUT_RATE_TEXT, INPUT_RATE_LONGTEXT, false )
 
@@ -2023,6 +2102,12 @@ vlc_module_begin ()
                   INPUT_RECORD_PATH_TEXT, INPUT_RECORD_PATH_LONGTEXT)
     add_bool( "input-record-native", true, INPUT_RECORD_NATIVE_TEXT,
               INPUT_RECORD_NATIVE_LONGTEXT, true )
+    add_integer( "input-record-segment-size", 0,
+                 INPUT_RECORD_SEGMENT_SIZE_TEXT,
+                 INPUT_RECORD_SEGMENT_SIZE_LONGTEXT, true )
+    add_integer( "input-record-segment-time", 0,
+                 INPUT_RECORD_SEGMENT_TIME_TEXT,
+                 INPUT_RECORD_SEGMENT_TIME_LONGTEXT, true )
 
     add_directory("input-timeshift-path", NULL,
                   INPUT_TIMESHIFT_PATH_TEXT, INPUT_TIMESHIFT_PATH_LONGTEXT)
@@ -2246,6 +2331,8 @@ vlc_module_begin ()
                  false )
         change_short('v')
         change_volatile ()
+    add_bool( "log-async", false, LOG_ASYNC_TEXT, LOG_ASYNC_LONGTEXT, true )
+    add_module( "tracer", "tracer", NULL, TRACER_TEXT, TRACER_LONGTEXT )
     add_obsolete_string( "verbose-objects" ) /* since 2.1.0 */
 #if !defined(_WIN32) && !defined(__OS2__)
     add_obsolete_bool( "daemon" ) /* since 4.0.0 */
@@ -63,6 +63,7 @@
 #include <vlc_modules.h>
 #include <vlc_media_library.h>
 #include <vlc_thumbnailer.h>
+#include <vlc_tracer.h>
 
 #include "libvlc.h"
 
@@ -94,6 +95,7 @@ libvlc_int_t * libvlc_InternalCreate( void )
     priv->interfaces = NULL;
     priv->main_playlist = NULL;
     priv->p_vlm = NULL;
+    priv->tracer = NULL;
     priv->media_source_provider = NULL;
 
     vlc_ExitInit( &priv->exit );
@@ -180,6 +182,16 @@ int libvlc_InternalInit( libvlc_int_t *p_libvlc, int i_argc,
 
     vlc_LogInit(p_libvlc);
 
+    char *tracer_name = var_InheritString(p_libvlc, "tracer");
+    if (tracer_name != NULL)
+    {
+        priv->tracer = vlc_tracer_Create(VLC_OBJECT(p_libvlc), tracer_name);
+        if (priv->tracer == NULL)
+            msg_Warn(p_libvlc, "cannot load tracer module \"%s\"",
+                     tracer_name);
+        free(tracer_name);
+    }
+
     /*
      * Support for gettext
      */
@@ -391,6 +403,9 @@ void libvlc_InternalCleanup( libvlc_int_t *p_libvlc )
     if( !var_InheritBool( p_libvlc, "ignore-config" ) )
         config_AutoSaveConfigFile( VLC_OBJECT(p_libvlc) );
 
+    if( priv->tracer != NULL )
+        vlc_tracer_Destroy( priv->tracer );
+
     vlc_LogDestroy(p_libvlc->obj.logger);
     /* Free module bank. It is refcounted, so we call this each time  */
     module_EndBank (true);
@@ -54,6 +54,22 @@ void vlc_threads_setup (libvlc_int_t *);
 void vlc_trace (const char *fn, const char *file, unsigned line);
 #define vlc_backtrace() vlc_trace(__func__, __FILE__, __LINE__)
 
+/* Mutex contention profile dump. Only collects data when the core was built
+ * with -DLIBVLC_PROFILE_LOCKS and VLC_MUTEX_PROFILE is set in the
+ * environment; also dumped to stderr at process exit. */
+void vlc_mutex_profile_Dump(FILE *);
+
+/*
+ * Name resolution
+ */
+struct addrinfo;
+
+/* Platform-specific interruptible resolver back-end, wrapped by the caching
+ * vlc_getaddrinfo_i11e() front-end in network/getaddrinfo.c */
+int vlc_getaddrinfo_resolve(const char *node, unsigned port,
+                            const struct addrinfo *hints,
+                            struct addrinfo **res);
+
 /*
  * Logging
  */
@@ -194,6 +210,7 @@ typedef struct libvlc_priv_t
     vlc_actions_t *actions; ///< Hotkeys handler
     struct vlc_medialibrary_t *p_media_library; ///< Media library instance
     struct vlc_thumbnailer_t *p_thumbnailer; ///< Lazily instantiated media thumbnailer
+    struct vlc_tracer *tracer; ///< Event tracer (or NULL when disabled)
 
     /* Exit callback */
     vlc_exit_t       exit;
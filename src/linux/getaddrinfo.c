@@ -31,12 +31,14 @@
 #include <vlc_interrupt.h>
 #include <vlc_network.h>
 
+#include "libvlc.h"
+
 static void vlc_getaddrinfo_notify(union sigval val)
 {
     vlc_sem_post(val.sival_ptr);
 }
 
-int vlc_getaddrinfo_i11e(const char *name, unsigned port,
+int vlc_getaddrinfo_resolve(const char *name, unsigned port,
                          const struct addrinfo *hints,
                          struct addrinfo **res)
 {
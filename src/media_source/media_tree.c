@@ -351,8 +351,10 @@ vlc_media_tree_Preparse(vlc_media_tree_t *tree, libvlc_int_t *libvlc,
     VLC_UNUSED(input_preparser_callbacks);
 #else
     media->i_preparse_depth = 1;
+    /* The user is browsing the tree, bypass pending background requests */
     vlc_MetadataRequest(libvlc, media, META_REQUEST_OPTION_SCOPE_ANY |
-                        META_REQUEST_OPTION_DO_INTERACT,
+                        META_REQUEST_OPTION_DO_INTERACT |
+                        META_REQUEST_OPTION_PRIORITY,
                         &input_preparser_callbacks, tree, 0, id);
 #endif
 }
@@ -33,15 +33,17 @@ struct task {
     void* id; /**< id associated with entity */
     void* entity; /**< the entity to process */
     vlc_tick_t timeout; /**< timeout duration in vlc_tick_t */
+    vlc_tick_t deadline; /**< absolute deadline set at push time, 0 if none */
+    bool priority; /**< queued ahead of normal-priority tasks */
 };
 
 struct background_worker;
 
 struct background_thread {
-    struct background_worker *owner;
     vlc_cond_t probe_cancel_wait; /**< wait for probe request or cancelation */
     bool probe; /**< true if a probe is requested */
     bool cancel; /**< true if a cancel is requested */
+    struct background_worker *worker; /**< worker of the current task */
     struct task *task; /**< current task */
     struct vlc_list node;
 };
@@ -50,21 +52,36 @@ struct background_worker {
     void* owner;
     struct background_worker_config conf;
 
-    vlc_mutex_t lock;
-
     int uncompleted; /**< number of tasks requested but not completed */
-    int nthreads; /**< number of threads in the threads list */
-    struct vlc_list threads; /**< list of active background_thread instances */
-
+    int nrunning; /**< number of tasks of this worker currently on a thread */
     struct vlc_list queue; /**< queue of tasks */
-    vlc_cond_t queue_wait; /**< wait for the queue to be non-empty */
+    struct vlc_list node; /**< node in the executor worker list */
+};
 
-    vlc_cond_t nothreads_wait; /**< wait for nthreads == 0 */
-    bool closing; /**< true if background worker deletion is requested */
+/* All background workers of the process share one pool of threads: the
+ * preparser, fetcher and thumbnailer queues are empty most of the time, and
+ * giving each worker instance private threads multiplies idle threads by the
+ * number of libvlc instances. Threads take tasks from whichever worker has
+ * runnable work, and exit after a few seconds without any. Per-worker
+ * concurrency is still bounded by the worker configuration. */
+static struct background_executor {
+    vlc_mutex_t lock;
+    vlc_cond_t queue_wait; /**< wait for a runnable task */
+    vlc_cond_t completion_wait; /**< wait for task completion or thread exit */
+    struct vlc_list workers; /**< list of registered background_worker */
+    struct vlc_list threads; /**< list of active background_thread instances */
+    unsigned nthreads; /**< number of threads in the threads list */
+    unsigned idle; /**< number of threads waiting for work */
+} executor = {
+    .lock = VLC_STATIC_MUTEX,
+    .queue_wait = VLC_STATIC_COND,
+    .completion_wait = VLC_STATIC_COND,
+    .workers = VLC_LIST_INITIALIZER(&executor.workers),
+    .threads = VLC_LIST_INITIALIZER(&executor.threads),
 };
 
 static struct task *task_Create(struct background_worker *worker, void *id,
-                                void *entity, int timeout)
+                                void *entity, int timeout, int flags)
 {
     struct task *task = malloc(sizeof(*task));
     if (unlikely(!task))
@@ -73,6 +90,9 @@ static struct task *task_Create(struct background_worker *worker, void *id,
     task->id = id;
     task->entity = entity;
     task->timeout = timeout < 0 ? worker->conf.default_timeout : VLC_TICK_FROM_MS(timeout);
+    task->deadline = (flags & BACKGROUND_WORKER_PUSH_DEADLINE) && task->timeout > 0
+                   ? vlc_tick_now() + task->timeout : 0;
+    task->priority = flags & BACKGROUND_WORKER_PUSH_PRIORITY;
     worker->conf.pf_hold(task->entity);
     return task;
 }
@@ -83,50 +103,92 @@ static void task_Destroy(struct background_worker *worker, struct task *task)
     free(task);
 }
 
-static struct task *QueueTake(struct background_worker *worker, int timeout_ms)
+/**
+ * Takes the next runnable task of any registered worker.
+ *
+ * A task is runnable if its worker has not reached its concurrency limit.
+ * The serviced worker is rotated to the list tail, so that no worker can
+ * starve the others.
+ */
+static struct task *ExecutorTake(struct background_worker **restrict wp,
+                                 int timeout_ms)
 {
-    vlc_mutex_assert(&worker->lock);
+    vlc_mutex_assert(&executor.lock);
 
     vlc_tick_t deadline = vlc_tick_now() + VLC_TICK_FROM_MS(timeout_ms);
-    bool timeout = false;
-    while (!timeout && !worker->closing && vlc_list_is_empty(&worker->queue))
-        timeout = vlc_cond_timedwait(&worker->queue_wait,
-                                     &worker->lock, deadline) != 0;
 
-    if (worker->closing || timeout)
-        return NULL;
+    for (;;)
+    {
+        struct background_worker *worker;
+        vlc_list_foreach(worker, &executor.workers, node)
+        {
+            if (worker->nrunning >= worker->conf.max_threads)
+                continue;
 
-    struct task *task = vlc_list_first_entry_or_null(&worker->queue,
-                                                     struct task, node);
-    assert(task);
-    vlc_list_remove(&task->node);
+            struct task *task = vlc_list_first_entry_or_null(&worker->queue,
+                                                             struct task, node);
+            if (!task)
+                continue;
 
-    return task;
+            vlc_list_remove(&task->node);
+            worker->nrunning++;
+
+            vlc_list_remove(&worker->node);
+            vlc_list_append(&worker->node, &executor.workers);
+
+            *wp = worker;
+            return task;
+        }
+
+        if (vlc_list_is_empty(&executor.workers))
+            return NULL; /* about to unload: terminate promptly */
+
+        executor.idle++;
+        bool timeout = vlc_cond_timedwait(&executor.queue_wait,
+                                          &executor.lock, deadline) != 0;
+        executor.idle--;
+        if (timeout)
+            return NULL;
+    }
 }
 
 static void QueuePush(struct background_worker *worker, struct task *task)
 {
-    vlc_mutex_assert(&worker->lock);
+    vlc_mutex_assert(&executor.lock);
+    if (task->priority)
+    {
+        /* insert after the last queued priority task, if any */
+        struct task *it;
+        vlc_list_foreach(it, &worker->queue, node)
+            if (!it->priority)
+            {
+                vlc_list_add_before(&task->node, &it->node);
+                vlc_cond_signal(&executor.queue_wait);
+                return;
+            }
+    }
     vlc_list_append(&task->node, &worker->queue);
-    vlc_cond_signal(&worker->queue_wait);
+    vlc_cond_signal(&executor.queue_wait);
 }
 
 static void QueueRemoveAll(struct background_worker *worker, void *id)
 {
-    vlc_mutex_assert(&worker->lock);
+    vlc_mutex_assert(&executor.lock);
     struct task *task;
     vlc_list_foreach(task, &worker->queue, node)
     {
         if (!id || task->id == id)
         {
             vlc_list_remove(&task->node);
+            worker->uncompleted--;
+            assert(worker->uncompleted >= 0);
             task_Destroy(worker, task);
         }
     }
+    vlc_cond_broadcast(&executor.completion_wait);
 }
 
-static struct background_thread *
-background_thread_Create(struct background_worker *owner)
+static struct background_thread *background_thread_Create(void)
 {
     struct background_thread *thread = malloc(sizeof(*thread));
     if (!thread)
@@ -136,7 +198,7 @@ background_thread_Create(struct background_worker *owner)
     thread->probe = false;
     thread->cancel = false;
     thread->task = NULL;
-    thread->owner = owner;
+    thread->worker = NULL;
     return thread;
 }
 
@@ -155,14 +217,13 @@ static struct background_worker *background_worker_Create(void *owner,
     worker->conf = *conf;
     worker->owner = owner;
 
-    vlc_mutex_init(&worker->lock);
     worker->uncompleted = 0;
-    worker->nthreads = 0;
-    vlc_list_init(&worker->threads);
+    worker->nrunning = 0;
     vlc_list_init(&worker->queue);
-    vlc_cond_init(&worker->queue_wait);
-    vlc_cond_init(&worker->nothreads_wait);
-    worker->closing = false;
+
+    vlc_mutex_lock(&executor.lock);
+    vlc_list_append(&worker->node, &executor.workers);
+    vlc_mutex_unlock(&executor.lock);
     return worker;
 }
 
@@ -173,30 +234,39 @@ static void background_worker_Destroy(struct background_worker *worker)
 
 static void TerminateTask(struct background_thread *thread, struct task *task)
 {
-    struct background_worker *worker = thread->owner;
+    struct background_worker *worker = thread->worker;
 
-    vlc_mutex_lock(&worker->lock);
+    vlc_mutex_lock(&executor.lock);
     thread->task = NULL;
+    thread->worker = NULL;
+    worker->nrunning--;
+    assert(worker->nrunning >= 0);
+    /* a concurrency slot freed up: a queued task of this worker may now run */
+    if (!vlc_list_is_empty(&worker->queue))
+        vlc_cond_signal(&executor.queue_wait);
+    vlc_mutex_unlock(&executor.lock);
+
+    /* The entity is released before the completion is accounted, as the
+     * worker only stays valid until its last task completed (see
+     * background_worker_Delete()). */
+    task_Destroy(worker, task);
+
+    vlc_mutex_lock(&executor.lock);
     worker->uncompleted--;
     assert(worker->uncompleted >= 0);
-    vlc_mutex_unlock(&worker->lock);
-
-    task_Destroy(worker, task);
+    vlc_cond_broadcast(&executor.completion_wait);
+    vlc_mutex_unlock(&executor.lock);
 }
 
 static void RemoveThread(struct background_thread *thread)
 {
-    struct background_worker *worker = thread->owner;
-
-    vlc_mutex_lock(&worker->lock);
+    vlc_mutex_lock(&executor.lock);
 
     vlc_list_remove(&thread->node);
-    worker->nthreads--;
-    assert(worker->nthreads >= 0);
-    if (!worker->nthreads)
-        vlc_cond_signal(&worker->nothreads_wait);
+    executor.nthreads--;
+    vlc_cond_broadcast(&executor.completion_wait);
 
-    vlc_mutex_unlock(&worker->lock);
+    vlc_mutex_unlock(&executor.lock);
 
     background_thread_Destroy(thread);
 }
@@ -204,28 +274,32 @@ static void RemoveThread(struct background_thread *thread)
 static void* Thread( void* data )
 {
     struct background_thread *thread = data;
-    struct background_worker *worker = thread->owner;
 
     for (;;)
     {
-        vlc_mutex_lock(&worker->lock);
-        struct task *task = QueueTake(worker, 5000);
+        struct background_worker *worker;
+
+        vlc_mutex_lock(&executor.lock);
+        struct task *task = ExecutorTake(&worker, 5000);
         if (!task)
         {
-            vlc_mutex_unlock(&worker->lock);
+            vlc_mutex_unlock(&executor.lock);
             /* terminate this thread */
             break;
         }
 
+        thread->worker = worker;
         thread->task = task;
         thread->cancel = false;
         thread->probe = false;
         vlc_tick_t deadline;
-        if (task->timeout > 0)
+        if (task->deadline != 0)
+            deadline = task->deadline; /* counting from the push */
+        else if (task->timeout > 0)
             deadline = vlc_tick_now() + task->timeout;
         else
             deadline = INT64_MAX; /* no deadline */
-        vlc_mutex_unlock(&worker->lock);
+        vlc_mutex_unlock(&executor.lock);
 
         void *handle;
         if (worker->conf.pf_start(worker->owner, task->entity, &handle))
@@ -236,17 +310,17 @@ static void* Thread( void* data )
 
         for (;;)
         {
-            vlc_mutex_lock(&worker->lock);
+            vlc_mutex_lock(&executor.lock);
             bool timeout = false;
             while (!timeout && !thread->probe && !thread->cancel)
                 /* any non-zero return value means timeout */
                 timeout = vlc_cond_timedwait(&thread->probe_cancel_wait,
-                                             &worker->lock, deadline) != 0;
+                                             &executor.lock, deadline) != 0;
 
             bool cancel = thread->cancel;
             thread->cancel = false;
             thread->probe = false;
-            vlc_mutex_unlock(&worker->lock);
+            vlc_mutex_unlock(&executor.lock);
 
             if (timeout || cancel
                     || worker->conf.pf_probe(worker->owner, handle))
@@ -263,11 +337,11 @@ static void* Thread( void* data )
     return NULL;
 }
 
-static bool SpawnThread(struct background_worker *worker)
+static bool SpawnThread(void)
 {
-    vlc_mutex_assert(&worker->lock);
+    vlc_mutex_assert(&executor.lock);
 
-    struct background_thread *thread = background_thread_Create(worker);
+    struct background_thread *thread = background_thread_Create();
     if (!thread)
         return false;
 
@@ -276,12 +350,24 @@ static bool SpawnThread(struct background_worker *worker)
         free(thread);
         return false;
     }
-    worker->nthreads++;
-    vlc_list_append(&thread->node, &worker->threads);
+    executor.nthreads++;
+    vlc_list_append(&thread->node, &executor.threads);
 
     return true;
 }
 
+/**
+ * Spawns a thread if the task just queued by `worker` could not be picked up
+ * by an idle thread, within the concurrency limit of the worker.
+ */
+static void ScheduleLocked(struct background_worker *worker)
+{
+    vlc_mutex_assert(&executor.lock);
+
+    if (executor.idle == 0 && worker->nrunning < worker->conf.max_threads)
+        SpawnThread();
+}
+
 struct background_worker* background_worker_New( void* owner,
     struct background_worker_config* conf )
 {
@@ -291,31 +377,75 @@ struct background_worker* background_worker_New( void* owner,
 int background_worker_Push( struct background_worker* worker, void* entity,
                         void* id, int timeout )
 {
-    struct task *task = task_Create(worker, id, entity, timeout);
+    return background_worker_PushEx(worker, entity, id, timeout, 0);
+}
+
+int background_worker_PushEx( struct background_worker* worker, void* entity,
+                              void* id, int timeout, int flags )
+{
+    struct task *task = task_Create(worker, id, entity, timeout, flags);
     if (unlikely(!task))
         return VLC_ENOMEM;
 
-    vlc_mutex_lock(&worker->lock);
+    vlc_mutex_lock(&executor.lock);
     QueuePush(worker, task);
-    if (++worker->uncompleted > worker->nthreads
-            && worker->nthreads < worker->conf.max_threads)
-        SpawnThread(worker);
-    vlc_mutex_unlock(&worker->lock);
+    worker->uncompleted++;
+    ScheduleLocked(worker);
+    vlc_mutex_unlock(&executor.lock);
+
+    return VLC_SUCCESS;
+}
+
+int background_worker_PushBatch( struct background_worker* worker,
+    void* const* entities, size_t count, void* id, int timeout, int flags )
+{
+    struct task **tasks = vlc_alloc(count, sizeof(*tasks));
+    if (unlikely(!tasks))
+        return VLC_ENOMEM;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        tasks[i] = task_Create(worker, id, entities[i], timeout, flags);
+        if (unlikely(!tasks[i]))
+        {
+            while (i > 0)
+                task_Destroy(worker, tasks[--i]);
+            free(tasks);
+            return VLC_ENOMEM;
+        }
+    }
 
+    vlc_mutex_lock(&executor.lock);
+    for (size_t i = 0; i < count; i++)
+        QueuePush(worker, tasks[i]);
+    worker->uncompleted += count;
+
+    size_t slots = worker->nrunning < worker->conf.max_threads
+                 ? (size_t)(worker->conf.max_threads - worker->nrunning) : 0;
+    if (count < slots)
+        slots = count;
+    for (size_t i = executor.idle; i < slots; i++)
+        if (!SpawnThread())
+            break;
+    vlc_mutex_unlock(&executor.lock);
+
+    free(tasks);
     return VLC_SUCCESS;
 }
 
 static void BackgroundWorkerCancelLocked(struct background_worker *worker,
                                          void *id)
 {
-    vlc_mutex_assert(&worker->lock);
+    vlc_mutex_assert(&executor.lock);
 
     QueueRemoveAll(worker, id);
 
     struct background_thread *thread;
-    vlc_list_foreach(thread, &worker->threads, node)
+    vlc_list_foreach(thread, &executor.threads, node)
     {
-        if (!id || (thread->task && thread->task->id == id && !thread->cancel))
+        if (thread->worker == worker
+         && (!id || (thread->task && thread->task->id == id))
+         && !thread->cancel)
         {
             thread->cancel = true;
             vlc_cond_signal(&thread->probe_cancel_wait);
@@ -325,38 +455,48 @@ static void BackgroundWorkerCancelLocked(struct background_worker *worker,
 
 void background_worker_Cancel( struct background_worker* worker, void* id )
 {
-    vlc_mutex_lock(&worker->lock);
+    vlc_mutex_lock(&executor.lock);
     BackgroundWorkerCancelLocked(worker, id);
-    vlc_mutex_unlock(&worker->lock);
+    vlc_mutex_unlock(&executor.lock);
 }
 
 void background_worker_RequestProbe( struct background_worker* worker )
 {
-    vlc_mutex_lock(&worker->lock);
+    vlc_mutex_lock(&executor.lock);
 
     struct background_thread *thread;
-    vlc_list_foreach(thread, &worker->threads, node)
+    vlc_list_foreach(thread, &executor.threads, node)
     {
+        if (thread->worker != worker)
+            continue;
         thread->probe = true;
         vlc_cond_signal(&thread->probe_cancel_wait);
     }
 
-    vlc_mutex_unlock(&worker->lock);
+    vlc_mutex_unlock(&executor.lock);
 }
 
 void background_worker_Delete( struct background_worker* worker )
 {
-    vlc_mutex_lock(&worker->lock);
+    vlc_mutex_lock(&executor.lock);
 
-    worker->closing = true;
     BackgroundWorkerCancelLocked(worker, NULL);
-    /* closing is now true, this will wake up any QueueTake() */
-    vlc_cond_broadcast(&worker->queue_wait);
 
-    while (worker->nthreads)
-        vlc_cond_wait(&worker->nothreads_wait, &worker->lock);
+    while (worker->uncompleted > 0)
+        vlc_cond_wait(&executor.completion_wait, &executor.lock);
+
+    vlc_list_remove(&worker->node);
+
+    if (vlc_list_is_empty(&executor.workers))
+    {
+        /* The last worker is gone: wait for the threads to terminate, so that
+         * no detached thread outlives the library mapping. */
+        vlc_cond_broadcast(&executor.queue_wait);
+        while (executor.nthreads > 0)
+            vlc_cond_wait(&executor.completion_wait, &executor.lock);
+    }
 
-    vlc_mutex_unlock(&worker->lock);
+    vlc_mutex_unlock(&executor.lock);
 
     /* no threads use the worker anymore, we can destroy it */
     background_worker_Destroy(worker);
@@ -121,6 +121,25 @@ struct background_worker_config {
     void( *pf_stop )( void* owner, void* handle );
 };
 
+/**
+ * Flags for \ref background_worker_PushEx and \ref background_worker_PushBatch
+ **/
+enum background_worker_push_flags {
+    /**
+     * Queue the entity ahead of already queued normal-priority entities.
+     * Entities pushed with this flag are processed in FIFO order between
+     * themselves, but before any entity pushed without it.
+     **/
+    BACKGROUND_WORKER_PUSH_PRIORITY = 0x1,
+
+    /**
+     * Make the timeout count from the push rather than from the start of the
+     * task, so that entities spending too long in the queue are cancelled
+     * shortly after they get scheduled. Ignored if the entity has no timeout.
+     **/
+    BACKGROUND_WORKER_PUSH_DEADLINE = 0x2,
+};
+
 /**
  * Create a background-worker
  *
@@ -171,6 +190,48 @@ void background_worker_RequestProbe( struct background_worker* worker );
 int background_worker_Push( struct background_worker* worker, void* entity,
     void* id, int timeout );
 
+/**
+ * Push an entity into the background-worker with extra options
+ *
+ * This function behaves like \ref background_worker_Push, with the scheduling
+ * of the entity refined by `flags`.
+ *
+ * \param worker the background-worker
+ * \param entity the entity which is to be queued
+ * \param id a value suitable for identifying the entity, or `NULL`
+ * \param timeout the timeout of the entity in milliseconds, `0` denotes no
+ *                timeout, a negative value will use the default timeout
+ *                associated with the background-worker.
+ * \param flags a combination of \ref background_worker_push_flags values
+ * \return VLC_SUCCESS if the entity was successfully queued, an error-code on
+ *         failure.
+ **/
+int background_worker_PushEx( struct background_worker* worker, void* entity,
+    void* id, int timeout, int flags );
+
+/**
+ * Push a batch of entities into the background-worker
+ *
+ * This function is equivalent to calling \ref background_worker_PushEx for
+ * each entity of the array, except that the queue is locked only once, which
+ * is noticeably cheaper when submitting thousands of entities at once.
+ *
+ * Either every entity is queued, or none is.
+ *
+ * \param worker the background-worker
+ * \param entities the entities which are to be queued
+ * \param count the number of entities in `entities`
+ * \param id a value suitable for identifying the entities, or `NULL`
+ * \param timeout the timeout of each entity in milliseconds, `0` denotes no
+ *                timeout, a negative value will use the default timeout
+ *                associated with the background-worker.
+ * \param flags a combination of \ref background_worker_push_flags values
+ * \return VLC_SUCCESS if the entities were successfully queued, an error-code
+ *         on failure.
+ **/
+int background_worker_PushBatch( struct background_worker* worker,
+    void* const* entities, size_t count, void* id, int timeout, int flags );
+
 /**
  * Remove entities from the background-worker
  *
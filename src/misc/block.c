@@ -87,6 +87,88 @@ static const struct vlc_block_callbacks block_generic_cbs =
     block_generic_Release,
 };
 
+/*
+ * Per-thread recycling cache for small data blocks.
+ *
+ * Demuxers and packetizers allocate and release small blocks (e.g. 188 bytes
+ * TS packets) at very high rates; going through malloc()/free() for each of
+ * them is measurably slow. Small allocations are rounded up to one of a few
+ * size classes, and released blocks are kept on a per-thread free list for
+ * reuse instead of being freed. The cache is thread-local, so neither path
+ * takes any lock; blocks may be released from any thread and simply land in
+ * the releasing thread's cache.
+ */
+
+/** Size classes (maximum payload bytes per class). */
+static const size_t block_pool_sizes[] = { 256, 512, 1024, 2048 };
+#define BLOCK_POOL_CLASSES ARRAY_SIZE(block_pool_sizes)
+/** Maximum cached blocks per class and per thread. */
+#define BLOCK_POOL_DEPTH   32
+
+struct block_pool
+{
+    block_t *free_list[BLOCK_POOL_CLASSES];
+    unsigned depth[BLOCK_POOL_CLASSES];
+};
+
+static vlc_threadvar_t block_pool_key;
+static bool block_pool_usable = false;
+
+static void block_pool_Destroy(void *data)
+{
+    struct block_pool *pool = data;
+
+    for (size_t i = 0; i < BLOCK_POOL_CLASSES; i++)
+        for (block_t *b = pool->free_list[i], *next; b != NULL; b = next)
+        {
+            next = b->p_next;
+            free(b);
+        }
+    free(pool);
+}
+
+static void block_pool_CreateKey(void)
+{
+    block_pool_usable =
+        vlc_threadvar_create(&block_pool_key, block_pool_Destroy) == 0;
+}
+
+static struct block_pool *block_pool_Get(void)
+{
+    static vlc_once_t once = VLC_STATIC_ONCE;
+
+    vlc_once(&once, block_pool_CreateKey);
+    if (unlikely(!block_pool_usable))
+        return NULL;
+
+    struct block_pool *pool = vlc_threadvar_get(block_pool_key);
+    if (unlikely(pool == NULL))
+    {
+        pool = calloc(1, sizeof (*pool));
+        if (pool != NULL && vlc_threadvar_set(block_pool_key, pool))
+        {
+            free(pool);
+            pool = NULL;
+        }
+    }
+    return pool;
+}
+
+static ssize_t block_pool_Class(size_t size)
+{
+    for (size_t i = 0; i < BLOCK_POOL_CLASSES; i++)
+        if (size <= block_pool_sizes[i])
+            return i;
+    return -1;
+}
+
+static void block_pool_Release(block_t *block);
+
+static const struct vlc_block_callbacks block_pool_cbs =
+{
+    block_pool_Release,
+};
+
 static void BlockMetaCopy( block_t *restrict out, const block_t *in )
 {
     out->p_next    = in->p_next;
@@ -105,8 +187,51 @@ static void BlockMetaCopy( block_t *restrict out, const block_t *in )
 /** Initial reserved header and footer size. */
 #define BLOCK_PADDING      32
 
+static block_t *block_InitInline(block_t *b, size_t capacity, size_t size,
+                                 const struct vlc_block_callbacks *cbs)
+{
+    block_Init(b, cbs, b + 1, capacity);
+    static_assert ((BLOCK_PADDING % BLOCK_ALIGN) == 0,
+                   "BLOCK_PADDING must be a multiple of BLOCK_ALIGN");
+    b->p_buffer += BLOCK_PADDING + BLOCK_ALIGN - 1;
+    b->p_buffer = (void *)(((uintptr_t)b->p_buffer) & ~(BLOCK_ALIGN - 1));
+    b->i_buffer = size;
+    return b;
+}
+
 block_t *block_Alloc (size_t size)
 {
+    ssize_t cls = block_pool_Class(size);
+
+    if (cls >= 0)
+    {
+        struct block_pool *pool = block_pool_Get();
+
+        if (likely(pool != NULL))
+        {
+            block_t *b = pool->free_list[cls];
+
+            if (b != NULL)
+            {   /* Cache hit: recycle without calling malloc() */
+                pool->free_list[cls] = b->p_next;
+                pool->depth[cls]--;
+                return block_InitInline(b, b->i_size, size, &block_pool_cbs);
+            }
+
+            /* Cache miss: allocate the full class size so that the block can
+             * be recycled for any request of the same class later on. */
+            const size_t alloc = sizeof (block_t) + BLOCK_ALIGN
+                               + (2 * BLOCK_PADDING) + block_pool_sizes[cls];
+
+            b = malloc (alloc);
+            if (unlikely(b == NULL))
+                return NULL;
+            return block_InitInline(b, alloc - sizeof (*b), size,
+                                    &block_pool_cbs);
+        }
+        /* No per-thread cache: fall through to the plain path */
+    }
+
     if (unlikely(size >> 27))
     {
         errno = ENOBUFS;
@@ -123,13 +248,30 @@ block_t *block_Alloc (size_t size)
     if (unlikely(b == NULL))
         return NULL;
 
-    block_Init(b, &block_generic_cbs, b + 1, alloc - sizeof (*b));
-    static_assert ((BLOCK_PADDING % BLOCK_ALIGN) == 0,
-                   "BLOCK_PADDING must be a multiple of BLOCK_ALIGN");
-    b->p_buffer += BLOCK_PADDING + BLOCK_ALIGN - 1;
-    b->p_buffer = (void *)(((uintptr_t)b->p_buffer) & ~(BLOCK_ALIGN - 1));
-    b->i_buffer = size;
-    return b;
+    return block_InitInline(b, alloc - sizeof (*b), size, &block_generic_cbs);
+}
+
+static void block_pool_Release(block_t *block)
+{
+    assert (block->p_start == (unsigned char *)(block + 1));
+
+    /* Recover the size class from the (fixed per class) buffer capacity. */
+    const size_t overhead = BLOCK_ALIGN + (2 * BLOCK_PADDING);
+    struct block_pool *pool = block_pool_Get();
+
+    if (likely(pool != NULL))
+        for (size_t i = 0; i < BLOCK_POOL_CLASSES; i++)
+            if (block->i_size == overhead + block_pool_sizes[i])
+            {
+                if (pool->depth[i] >= BLOCK_POOL_DEPTH)
+                    break; /* cache full */
+                block->p_next = pool->free_list[i];
+                pool->free_list[i] = block;
+                pool->depth[i]++;
+                return;
+            }
+
+    free (block);
 }
 
 void block_Release(block_t *block)
@@ -138,6 +138,21 @@ VLC_WEAK unsigned vlc_CPU_raw(void)
                   : "=a" (i_eax), "=b" (i_ebx), "=c" (i_ecx), "=d" (i_edx) \
                   : "a" (reg) \
                   : "cc");
+# endif
+# if defined (__i386__) && defined (__PIC__)
+#  define cpuid_count(reg, count) \
+    asm volatile ("xchgl %%ebx,%1\n\t" \
+                  "cpuid\n\t" \
+                  "xchgl %%ebx,%1\n\t" \
+                  : "=a" (i_eax), "=r" (i_ebx), "=c" (i_ecx), "=d" (i_edx) \
+                  : "a" (reg), "c" (count) \
+                  : "cc");
+# else
+#  define cpuid_count(reg, count) \
+    asm volatile ("cpuid\n\t" \
+                  : "=a" (i_eax), "=b" (i_ebx), "=c" (i_ecx), "=d" (i_edx) \
+                  : "a" (reg), "c" (count) \
+                  : "cc");
 # endif
      /* Check if the OS really supports the requested instructions */
 # if defined (__i386__) && !defined (__i486__) && !defined (__i586__) \
@@ -205,6 +220,26 @@ VLC_WEAK unsigned vlc_CPU_raw(void)
             i_capabilities |= VLC_CPU_SSE4_2;
     }
 
+    /* AVX and wider need OS support for the extended context (OSXSAVE and
+     * the matching XCR0 state bits) in addition to the CPU feature flag */
+    if ((i_ecx & 0x18000000) == 0x18000000)
+    {
+        unsigned xcr0_lo, xcr0_hi;
+        asm volatile ("xgetbv" : "=a" (xcr0_lo), "=d" (xcr0_hi) : "c" (0));
+
+        if ((xcr0_lo & 0x6) == 0x6) /* XMM and YMM state */
+        {
+            i_capabilities |= VLC_CPU_AVX;
+
+            cpuid_count( 0x00000007, 0 );
+            if (i_ebx & 0x00000020)
+                i_capabilities |= VLC_CPU_AVX2;
+            if ((i_ebx & 0x00010000) /* AVX512F */
+             && (xcr0_lo & 0xe6) == 0xe6) /* + opmask and ZMM state */
+                i_capabilities |= VLC_CPU_AVX512;
+        }
+    }
+
     /* test for additional capabilities */
     cpuid( 0x80000000 );
 
@@ -291,6 +326,8 @@ void vlc_CPU_dump (vlc_object_t *obj)
         vlc_memstream_puts(&stream, "AVX ");
     if (vlc_CPU_AVX2())
         vlc_memstream_puts(&stream, "AVX2 ");
+    if (vlc_CPU_AVX512())
+        vlc_memstream_puts(&stream, "AVX-512 ");
     if (vlc_CPU_3dNOW())
         vlc_memstream_puts(&stream, "3DNow! ");
     if (vlc_CPU_XOP())
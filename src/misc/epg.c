@@ -118,7 +118,9 @@ static void vlc_epg_Init( vlc_epg_t *p_epg, uint32_t i_id, uint16_t i_source_id
     p_epg->psz_name = NULL;
     p_epg->p_current = NULL;
     p_epg->b_present = false;
-    TAB_INIT( p_epg->i_event, p_epg->pp_event );
+    p_epg->i_event = 0;
+    p_epg->pp_event = NULL;
+    p_epg->i_event_capacity = 0;
 }
 
 static void vlc_epg_Clean( vlc_epg_t *p_epg )
@@ -126,10 +128,33 @@ static void vlc_epg_Clean( vlc_epg_t *p_epg )
     size_t i;
     for( i = 0; i < p_epg->i_event; i++ )
         vlc_epg_event_Delete( p_epg->pp_event[i] );
-    TAB_CLEAN( p_epg->i_event, p_epg->pp_event );
+    free( p_epg->pp_event );
+    p_epg->i_event = 0;
+    p_epg->pp_event = NULL;
+    p_epg->i_event_capacity = 0;
     free( p_epg->psz_name );
 }
 
+/* Grows the event table geometrically: a full DVB EIT table carries
+ * thousands of events and they are appended one at a time */
+static bool vlc_epg_Reserve( vlc_epg_t *p_epg, size_t i_count )
+{
+    if( i_count <= p_epg->i_event_capacity )
+        return true;
+
+    size_t i_capacity = p_epg->i_event_capacity ? p_epg->i_event_capacity : 16;
+    while( i_capacity < i_count )
+        i_capacity *= 2;
+
+    vlc_epg_event_t **pp_event = realloc( p_epg->pp_event,
+                                          i_capacity * sizeof(*pp_event) );
+    if( !pp_event )
+        return false;
+    p_epg->pp_event = pp_event;
+    p_epg->i_event_capacity = i_capacity;
+    return true;
+}
+
 bool vlc_epg_AddEvent( vlc_epg_t *p_epg, vlc_epg_event_t *p_evt )
 {
     ssize_t i_pos = -1;
@@ -176,13 +201,18 @@ bool vlc_epg_AddEvent( vlc_epg_t *p_epg, vlc_epg_event_t *p_evt )
             p_epg->pp_event[i_pos] = p_evt;
             return true;
         }
-        else
-        {
-            TAB_INSERT( p_epg->i_event, p_epg->pp_event, p_evt, i_pos );
-        }
     }
+
+    if( !vlc_epg_Reserve( p_epg, p_epg->i_event + 1 ) )
+        return false;
+
+    if( i_pos != -1 )
+        memmove( &p_epg->pp_event[i_pos + 1], &p_epg->pp_event[i_pos],
+                 ( p_epg->i_event - i_pos ) * sizeof(*p_epg->pp_event) );
     else
-        TAB_APPEND( p_epg->i_event, p_epg->pp_event, p_evt );
+        i_pos = p_epg->i_event;
+    p_epg->pp_event[i_pos] = p_evt;
+    p_epg->i_event++;
 
     return true;
 }
@@ -203,19 +233,25 @@ void vlc_epg_Delete( vlc_epg_t *p_epg )
 
 void vlc_epg_SetCurrent( vlc_epg_t *p_epg, int64_t i_start )
 {
-    size_t i;
     p_epg->p_current = NULL;
-    if( i_start < 0 )
+    if( i_start < 0 || p_epg->i_event == 0 )
         return;
 
-    for( i = 0; i < p_epg->i_event; i++ )
+    /* Do bisect search, the table is sorted by start time */
+    size_t i_lower = 0;
+    size_t i_upper = p_epg->i_event - 1;
+
+    while( i_lower < i_upper )
     {
-        if( p_epg->pp_event[i]->i_start == i_start )
-        {
-            p_epg->p_current = p_epg->pp_event[i];
-            break;
-        }
+        size_t i_split = ( i_lower + i_upper ) / 2;
+        if( p_epg->pp_event[i_split]->i_start < i_start )
+            i_lower = i_split + 1;
+        else
+            i_upper = i_split;
     }
+
+    if( p_epg->pp_event[i_lower]->i_start == i_start )
+        p_epg->p_current = p_epg->pp_event[i_lower];
 }
 
 vlc_epg_t * vlc_epg_Duplicate( const vlc_epg_t *p_src )
@@ -225,6 +261,8 @@ vlc_epg_t * vlc_epg_Duplicate( const vlc_epg_t *p_src )
     {
         p_epg->psz_name = ( p_src->psz_name ) ? strdup( p_src->psz_name ) : NULL;
         p_epg->b_present = p_src->b_present;
+        if( p_src->i_event && !vlc_epg_Reserve( p_epg, p_src->i_event ) )
+            return p_epg;
         for( size_t i=0; i<p_src->i_event; i++ )
         {
             vlc_epg_event_t *p_dup = vlc_epg_event_Duplicate( p_src->pp_event[i] );
@@ -232,9 +270,95 @@ vlc_epg_t * vlc_epg_Duplicate( const vlc_epg_t *p_src )
             {
                 if( p_src->p_current == p_src->pp_event[i] )
                     p_epg->p_current = p_dup;
-                TAB_APPEND( p_epg->i_event, p_epg->pp_event, p_dup );
+                p_epg->pp_event[p_epg->i_event++] = p_dup;
             }
         }
     }
     return p_epg;
 }
+
+static bool vlc_epg_str_Equals( const char *psz_a, const char *psz_b )
+{
+    if( !psz_a || !psz_b )
+        return psz_a == psz_b;
+    return !strcmp( psz_a, psz_b );
+}
+
+static bool vlc_epg_event_Equals( const vlc_epg_event_t *p_a,
+                                  const vlc_epg_event_t *p_b )
+{
+    if( p_a->i_id != p_b->i_id ||
+        p_a->i_start != p_b->i_start ||
+        p_a->i_duration != p_b->i_duration ||
+        p_a->i_rating != p_b->i_rating ||
+        p_a->i_description_items != p_b->i_description_items )
+        return false;
+    if( !vlc_epg_str_Equals( p_a->psz_name, p_b->psz_name ) ||
+        !vlc_epg_str_Equals( p_a->psz_short_description, p_b->psz_short_description ) ||
+        !vlc_epg_str_Equals( p_a->psz_description, p_b->psz_description ) )
+        return false;
+    for( int i = 0; i < p_a->i_description_items; i++ )
+    {
+        if( !vlc_epg_str_Equals( p_a->description_items[i].psz_key,
+                                 p_b->description_items[i].psz_key ) ||
+            !vlc_epg_str_Equals( p_a->description_items[i].psz_value,
+                                 p_b->description_items[i].psz_value ) )
+            return false;
+    }
+    return true;
+}
+
+void vlc_epg_Merge( vlc_epg_t *p_dst, const vlc_epg_t *p_src )
+{
+    vlc_epg_event_t **pp_event = NULL;
+    if( p_src->i_event &&
+        !(pp_event = malloc( p_src->i_event * sizeof(*pp_event) )) )
+        return; /* Keep the previous table on allocation failure */
+
+    /* Both tables are sorted by start time, so walk them in lockstep:
+     * events carried unchanged by the refresh keep their allocation,
+     * the others are duplicated or dropped */
+    size_t i_event = 0;
+    size_t i_old = 0;
+    p_dst->p_current = NULL;
+    for( size_t i = 0; i < p_src->i_event; i++ )
+    {
+        const vlc_epg_event_t *p_evt = p_src->pp_event[i];
+        vlc_epg_event_t *p_new;
+
+        while( i_old < p_dst->i_event &&
+               p_dst->pp_event[i_old]->i_start < p_evt->i_start )
+            vlc_epg_event_Delete( p_dst->pp_event[i_old++] );
+
+        if( i_old < p_dst->i_event &&
+            vlc_epg_event_Equals( p_dst->pp_event[i_old], p_evt ) )
+        {
+            p_new = p_dst->pp_event[i_old++];
+        }
+        else
+        {
+            p_new = vlc_epg_event_Duplicate( p_evt );
+            if( !p_new )
+                continue;
+        }
+
+        if( p_src->p_current == p_evt )
+            p_dst->p_current = p_new;
+        pp_event[i_event++] = p_new;
+    }
+
+    while( i_old < p_dst->i_event )
+        vlc_epg_event_Delete( p_dst->pp_event[i_old++] );
+    free( p_dst->pp_event );
+
+    p_dst->pp_event = pp_event;
+    p_dst->i_event = i_event;
+    p_dst->i_event_capacity = p_src->i_event;
+
+    p_dst->b_present = p_src->b_present;
+    if( !vlc_epg_str_Equals( p_dst->psz_name, p_src->psz_name ) )
+    {
+        free( p_dst->psz_name );
+        p_dst->psz_name = p_src->psz_name ? strdup( p_src->psz_name ) : NULL;
+    }
+}
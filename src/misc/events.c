@@ -49,8 +49,20 @@ typedef struct vlc_event_listener_t
 {
     void *               p_user_data;
     vlc_event_callback_t pf_callback;
+    bool                 b_detached; /* reclamation deferred while walked */
 } vlc_event_listener_t;
 
+/* Stack-allocated record of one thread currently dispatching callbacks.
+ * While at least one walker is active, the listener arrays are never
+ * shrunk: detached listeners are only marked, and reclaimed by the last
+ * walker leaving. This allows dropping the lock around each callback
+ * invocation, so slow listeners do not backpressure event producers. */
+struct vlc_event_walker
+{
+    unsigned long thread;
+    struct vlc_event_walker *next;
+};
+
 /*****************************************************************************
  *
  *****************************************************************************/
@@ -65,9 +77,9 @@ typedef struct vlc_event_listener_t
 void vlc_event_manager_init( vlc_event_manager_t * p_em, void * p_obj )
 {
     p_em->p_obj = p_obj;
-    /* This is an unsafe work-around for a long-standing playlist bug.
-     * Do not rely on this. */
-    vlc_mutex_init_recursive( &p_em->lock );
+    vlc_mutex_init( &p_em->lock );
+    vlc_cond_init( &p_em->wait );
+    p_em->walkers = NULL;
 
     for( size_t i = 0; i < ARRAY_SIZE(p_em->events); i++ )
        ARRAY_INIT( p_em->events[i].listeners );
@@ -80,6 +92,8 @@ void vlc_event_manager_fini( vlc_event_manager_t * p_em )
 {
     struct vlc_event_listener_t * listener;
 
+    assert( p_em->walkers == NULL );
+
     for( size_t i = 0; i < ARRAY_SIZE(p_em->events); i++ )
     {
         struct vlc_event_listeners_group_t *slot = p_em->events + i;
@@ -91,6 +105,35 @@ void vlc_event_manager_fini( vlc_event_manager_t * p_em )
     }
 }
 
+static bool vlc_event_walking( vlc_event_manager_t * p_em )
+{
+    unsigned long self = vlc_thread_id();
+
+    for( struct vlc_event_walker *w = p_em->walkers; w != NULL; w = w->next )
+        if( w->thread == self )
+            return true;
+    return false;
+}
+
+static void vlc_event_reclaim( vlc_event_manager_t * p_em )
+{
+    for( size_t i = 0; i < ARRAY_SIZE(p_em->events); i++ )
+    {
+        struct vlc_event_listeners_group_t *slot = p_em->events + i;
+
+        for( int j = slot->listeners.i_size; j-- > 0; )
+        {
+            struct vlc_event_listener_t *listener = slot->listeners.p_elems[j];
+
+            if( listener->b_detached )
+            {
+                ARRAY_REMOVE( slot->listeners, j );
+                free( listener );
+            }
+        }
+    }
+}
+
 /**
  * Send an event to the listener attached to this p_em.
  */
@@ -98,16 +141,39 @@ void vlc_event_send( vlc_event_manager_t * p_em,
                      vlc_event_t * p_event )
 {
     vlc_event_listeners_group_t *slot = &p_em->events[p_event->type];
-    vlc_event_listener_t * listener;
+    struct vlc_event_walker walker = { .thread = vlc_thread_id(), };
 
     /* Fill event with the sending object now */
     p_event->p_obj = p_em->p_obj;
 
     vlc_mutex_lock( &p_em->lock ) ;
+    walker.next = p_em->walkers;
+    p_em->walkers = &walker;
 
-    ARRAY_FOREACH( listener, slot->listeners )
+    for( int i = 0; i < slot->listeners.i_size; i++ )
+    {
+        vlc_event_listener_t *listener = slot->listeners.p_elems[i];
+
+        if( listener->b_detached )
+            continue;
+
+        /* The lock is released while the callback runs: a slow listener
+         * stalls neither other producers nor attach/detach. */
+        vlc_mutex_unlock( &p_em->lock );
         listener->pf_callback( p_event, listener->p_user_data );
+        vlc_mutex_lock( &p_em->lock );
+    }
 
+    struct vlc_event_walker **pp = &p_em->walkers;
+    while( *pp != &walker )
+        pp = &(*pp)->next;
+    *pp = walker.next;
+
+    if( p_em->walkers == NULL )
+    {   /* Last walker out: the grace period is over */
+        vlc_event_reclaim( p_em );
+        vlc_cond_broadcast( &p_em->wait );
+    }
     vlc_mutex_unlock( &p_em->lock );
 }
 
@@ -129,6 +195,7 @@ int vlc_event_attach( vlc_event_manager_t * p_em,
 
     listener->p_user_data = p_user_data;
     listener->pf_callback = pf_callback;
+    listener->b_detached = false;
 
     vlc_mutex_lock( &p_em->lock );
     ARRAY_APPEND( slot->listeners, listener );
@@ -152,13 +219,31 @@ void vlc_event_detach( vlc_event_manager_t *p_em,
     for (int i = 0; i < slot->listeners.i_size; ++i)
     {
         struct vlc_event_listener_t *listener = slot->listeners.p_elems[i];
-        if( listener->pf_callback == pf_callback &&
+        if( !listener->b_detached &&
+            listener->pf_callback == pf_callback &&
             listener->p_user_data == p_user_data )
         {
             /* that's our listener */
-            ARRAY_REMOVE( slot->listeners, i );
-            vlc_mutex_unlock( &p_em->lock );
-            free( listener );
+            listener->b_detached = true;
+
+            if( p_em->walkers == NULL )
+            {
+                ARRAY_REMOVE( slot->listeners, i );
+                vlc_mutex_unlock( &p_em->lock );
+                free( listener );
+            }
+            else if( vlc_event_walking( p_em ) )
+                /* Called back from a dispatch on this very thread: waiting
+                 * would deadlock. The last walker reclaims the listener. */
+                vlc_mutex_unlock( &p_em->lock );
+            else
+            {
+                /* Wait out the dispatches which may still be running the
+                 * callback, so the caller can release its resources. */
+                while( p_em->walkers != NULL )
+                    vlc_cond_wait( &p_em->wait, &p_em->lock );
+                vlc_mutex_unlock( &p_em->lock );
+            }
             return;
         }
     }
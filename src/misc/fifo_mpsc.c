@@ -0,0 +1,184 @@
+/*****************************************************************************
+ * fifo_mpsc.c: lock-free multiple-producer single-consumer block FIFO
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#include <vlc_common.h>
+#include <vlc_block.h>
+#include "libvlc.h"
+
+/**
+ * Lock-free MPSC block queue.
+ *
+ * Producers push (chains of) blocks onto an atomic inbox stack with a single
+ * atomic exchange, i.e. one synchronisation point regardless of the chain
+ * length. The single consumer grabs the whole inbox at once, reverses it back
+ * into queue order and consumes from a private list without any further
+ * synchronisation. There is no mutex on either path; the consumer only ever
+ * sleeps on a futex-like wait when the queue is fully drained.
+ */
+struct vlc_fifo_mpsc
+{
+    block_t *_Atomic inbox; /**< LIFO of pending blocks (producers) */
+    atomic_uint sequence; /**< bumped on every publication (wake-up word) */
+    atomic_size_t depth; /**< approximate queued block count */
+    atomic_size_t bytes; /**< approximate queued payload bytes */
+    block_t *ready; /**< consumed inbox in queue order (consumer only) */
+};
+
+vlc_fifo_mpsc_t *vlc_fifo_mpsc_New(void)
+{
+    vlc_fifo_mpsc_t *fifo = malloc(sizeof (*fifo));
+
+    if (likely(fifo != NULL)) {
+        atomic_init(&fifo->inbox, NULL);
+        atomic_init(&fifo->sequence, 0);
+        atomic_init(&fifo->depth, 0);
+        atomic_init(&fifo->bytes, 0);
+        fifo->ready = NULL;
+    }
+
+    return fifo;
+}
+
+void vlc_fifo_mpsc_Release(vlc_fifo_mpsc_t *fifo)
+{
+    block_ChainRelease(atomic_load_explicit(&fifo->inbox,
+                                            memory_order_relaxed));
+    block_ChainRelease(fifo->ready);
+    free(fifo);
+}
+
+void vlc_fifo_mpsc_Put(vlc_fifo_mpsc_t *fifo, block_t *block)
+{
+    block_t *tail = block;
+    size_t count = 1, size = block->i_buffer;
+
+    while (tail->p_next != NULL) {
+        tail = tail->p_next;
+        count++;
+        size += tail->i_buffer;
+    }
+
+    /* Push the whole chain with a single synchronisation point. */
+    block_t *head = atomic_load_explicit(&fifo->inbox, memory_order_relaxed);
+    do
+        tail->p_next = head;
+    while (!atomic_compare_exchange_weak_explicit(&fifo->inbox, &head, block,
+                                                  memory_order_release,
+                                                  memory_order_relaxed));
+
+    atomic_fetch_add_explicit(&fifo->depth, count, memory_order_relaxed);
+    atomic_fetch_add_explicit(&fifo->bytes, size, memory_order_relaxed);
+    atomic_fetch_add_explicit(&fifo->sequence, 1, memory_order_release);
+    vlc_atomic_notify_one(&fifo->sequence);
+}
+
+/* Grab the inbox and splice it, in queue order, after the ready list
+ * (consumer thread only). */
+static bool vlc_fifo_mpsc_Refill(vlc_fifo_mpsc_t *fifo)
+{
+    block_t *grabbed = atomic_exchange_explicit(&fifo->inbox, NULL,
+                                                memory_order_acquire);
+    if (grabbed == NULL)
+        return fifo->ready != NULL;
+
+    /* The inbox is in reverse insertion order: reverse it back. */
+    block_t *ordered = NULL;
+
+    while (grabbed != NULL) {
+        block_t *next = grabbed->p_next;
+
+        grabbed->p_next = ordered;
+        ordered = grabbed;
+        grabbed = next;
+    }
+
+    if (fifo->ready == NULL)
+        fifo->ready = ordered;
+    else {
+        block_t *tail = fifo->ready;
+
+        while (tail->p_next != NULL)
+            tail = tail->p_next;
+        tail->p_next = ordered;
+    }
+
+    return true;
+}
+
+block_t *vlc_fifo_mpsc_Get(vlc_fifo_mpsc_t *fifo)
+{
+    for (;;) {
+        unsigned seq = atomic_load_explicit(&fifo->sequence,
+                                            memory_order_acquire);
+
+        if (vlc_fifo_mpsc_Refill(fifo)) {
+            block_t *block = fifo->ready;
+
+            fifo->ready = block->p_next;
+            block->p_next = NULL;
+            atomic_fetch_sub_explicit(&fifo->depth, 1, memory_order_relaxed);
+            atomic_fetch_sub_explicit(&fifo->bytes, block->i_buffer,
+                                      memory_order_relaxed);
+            return block;
+        }
+
+        /* Any publication after the sequence load above changes the value
+         * and aborts (or wakes up) the wait, so no wake-up can be missed. */
+        vlc_atomic_wait(&fifo->sequence, seq);
+    }
+}
+
+block_t *vlc_fifo_mpsc_GetAll(vlc_fifo_mpsc_t *fifo)
+{
+    if (!vlc_fifo_mpsc_Refill(fifo))
+        return NULL;
+
+    block_t *chain = fifo->ready;
+    size_t count = 0, size = 0;
+
+    fifo->ready = NULL;
+
+    for (block_t *b = chain; b != NULL; b = b->p_next) {
+        count++;
+        size += b->i_buffer;
+    }
+
+    atomic_fetch_sub_explicit(&fifo->depth, count, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&fifo->bytes, size, memory_order_relaxed);
+    return chain;
+}
+
+size_t vlc_fifo_mpsc_GetCount(const vlc_fifo_mpsc_t *fifo)
+{
+    return atomic_load_explicit(&fifo->depth, memory_order_relaxed);
+}
+
+size_t vlc_fifo_mpsc_GetBytes(const vlc_fifo_mpsc_t *fifo)
+{
+    return atomic_load_explicit(&fifo->bytes, memory_order_relaxed);
+}
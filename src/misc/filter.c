@@ -176,6 +176,151 @@ void filter_DeleteBlend( vlc_blender_t *p_blend )
     vlc_object_delete(p_blend);
 }
 
+/* */
+
+/* Beyond a few bands the synchronization overhead dwarfs the gain */
+#define SLICER_MAX_THREADS 7
+
+struct filter_slicer_t
+{
+    vlc_mutex_t lock;
+    vlc_cond_t wait; /* signals a new run to the workers */
+    vlc_cond_t done; /* signals band/run completion to the submitter */
+
+    bool exit;
+    unsigned generation;
+
+    /* Run in progress, owned by the submitter until all bands are done */
+    filter_slice_cb cb;
+    void *opaque;
+    unsigned bands;
+    unsigned next; /* next band to process */
+    unsigned busy; /* workers still processing a band */
+
+    unsigned threads;
+    vlc_thread_t thread[];
+};
+
+/* Process bands until the current run has none left.
+ * The slicer lock must be held. */
+static void SlicerWork( filter_slicer_t *s )
+{
+    while( s->next < s->bands )
+    {
+        unsigned band = s->next++;
+        unsigned bands = s->bands;
+        filter_slice_cb cb = s->cb;
+        void *opaque = s->opaque;
+
+        s->busy++;
+        vlc_mutex_unlock( &s->lock );
+        cb( opaque, band, bands );
+        vlc_mutex_lock( &s->lock );
+        s->busy--;
+    }
+    if( s->busy == 0 )
+        vlc_cond_signal( &s->done );
+}
+
+static void *SlicerThread( void *opaque )
+{
+    filter_slicer_t *s = opaque;
+    unsigned generation = 0;
+
+    vlc_mutex_lock( &s->lock );
+    while( !s->exit )
+    {
+        if( s->generation == generation )
+        {
+            vlc_cond_wait( &s->wait, &s->lock );
+            continue;
+        }
+        generation = s->generation;
+        SlicerWork( s );
+    }
+    vlc_mutex_unlock( &s->lock );
+    return NULL;
+}
+
+filter_slicer_t *filter_NewSlicer( filter_t *p_filter )
+{
+    unsigned count = vlc_GetCPUCount();
+
+    count = ( count > 1 ) ? count - 1 : 0; /* the submitter works too */
+    if( count > SLICER_MAX_THREADS )
+        count = SLICER_MAX_THREADS;
+
+    filter_slicer_t *s = malloc( sizeof (*s)
+                               + count * sizeof (vlc_thread_t) );
+    if( unlikely(s == NULL) )
+        return NULL;
+
+    vlc_mutex_init( &s->lock );
+    vlc_cond_init( &s->wait );
+    vlc_cond_init( &s->done );
+    s->exit = false;
+    s->generation = 0;
+    s->bands = 0;
+    s->next = 0;
+    s->busy = 0;
+    s->threads = 0;
+
+    for( unsigned i = 0; i < count; i++ )
+    {
+        if( vlc_clone( &s->thread[s->threads], SlicerThread, s,
+                       VLC_THREAD_PRIORITY_VIDEO ) )
+            break;
+        s->threads++;
+    }
+    msg_Dbg( p_filter, "slicing over %u thread(s)", s->threads + 1 );
+    return s;
+}
+
+unsigned filter_SlicerBands( const filter_slicer_t *s )
+{
+    return ( s != NULL ) ? s->threads + 1 : 1;
+}
+
+void filter_SlicerRun( filter_slicer_t *s, filter_slice_cb cb,
+                       void *opaque, unsigned bands )
+{
+    if( s == NULL || s->threads == 0 || bands <= 1 )
+    {
+        for( unsigned i = 0; i < bands; i++ )
+            cb( opaque, i, bands );
+        return;
+    }
+
+    vlc_mutex_lock( &s->lock );
+    s->cb = cb;
+    s->opaque = opaque;
+    s->bands = bands;
+    s->next = 0;
+    s->generation++;
+    vlc_cond_broadcast( &s->wait );
+
+    SlicerWork( s );
+    while( s->busy > 0 )
+        vlc_cond_wait( &s->done, &s->lock );
+    s->bands = 0;
+    vlc_mutex_unlock( &s->lock );
+}
+
+void filter_DeleteSlicer( filter_slicer_t *s )
+{
+    if( s == NULL )
+        return;
+
+    vlc_mutex_lock( &s->lock );
+    s->exit = true;
+    vlc_cond_broadcast( &s->wait );
+    vlc_mutex_unlock( &s->lock );
+
+    for( unsigned i = 0; i < s->threads; i++ )
+        vlc_join( s->thread[i], NULL );
+    free( s );
+}
+
 /* */
 #include <vlc_video_splitter.h>
 
@@ -32,6 +32,9 @@
 #include <libvlc.h>
 #include <assert.h>
 
+/** Depth of the bounded picture queue feeding each pipelined stage */
+#define PIPELINE_QUEUE_SIZE 3
+
 typedef struct chained_filter_t
 {
     /* Public part of the filter structure */
@@ -40,6 +43,16 @@ typedef struct chained_filter_t
     struct chained_filter_t *prev, *next;
     vlc_mouse_t *mouse;
     picture_t *pending;
+
+    /* Pipelined execution (one worker per stage, see PipelineThread) */
+    vlc_thread_t thread;
+    bool threaded;
+    vlc_mutex_t lock;
+    vlc_cond_t wait_data; /**< Signalled when the queue gains a picture */
+    vlc_cond_t wait_room; /**< Signalled when the queue loses a picture */
+    picture_t *queue, **queue_end; /**< Bounded input queue (FIFO) */
+    unsigned depth;
+    bool exit;
 } chained_filter_t;
 
 /* */
@@ -56,12 +69,21 @@ struct filter_chain_t
     bool b_allow_fmt_out_change; /**< Each filter can change the output */
     const char *filter_cap; /**< Filter modules capability */
     const char *conv_cap; /**< Converter modules capability */
+
+    bool pipelined; /**< Pipelined execution was requested */
+    bool pipeline_running; /**< Stage workers are up */
+    vlc_mutex_t out_lock;
+    vlc_cond_t out_wait_room;
+    picture_t *out_queue, **out_queue_end; /**< Filtered pictures (FIFO) */
+    unsigned out_depth;
+    bool out_exit;
 };
 
 /**
  * Local prototypes
  */
 static void FilterDeletePictures( picture_t * );
+static void PipelineStop( filter_chain_t * );
 
 static filter_chain_t *filter_chain_NewInner( vlc_object_t *obj,
     const char *cap, const char *conv_cap, bool fmt_out_change,
@@ -83,6 +105,14 @@ static filter_chain_t *filter_chain_NewInner( vlc_object_t *obj,
     chain->b_allow_fmt_out_change = fmt_out_change;
     chain->filter_cap = cap;
     chain->conv_cap = conv_cap;
+    chain->pipelined = false;
+    chain->pipeline_running = false;
+    vlc_mutex_init( &chain->out_lock );
+    vlc_cond_init( &chain->out_wait_room );
+    chain->out_queue = NULL;
+    chain->out_queue_end = &chain->out_queue;
+    chain->out_depth = 0;
+    chain->out_exit = false;
     return chain;
 }
 
@@ -157,6 +187,8 @@ filter_chain_t *filter_chain_NewVideo( vlc_object_t *obj, bool allow_change,
     }
     else
         chain->parent_video_owner = (filter_owner_t){};
+
+    chain->pipelined = var_InheritBool( obj, "pipelined-filters" );
     return chain;
 }
 
@@ -205,6 +237,9 @@ static filter_t *filter_chain_AppendInner( filter_chain_t *chain,
     const char *name, const char *capability, config_chain_t *cfg,
     const es_format_t *fmt_out )
 {
+    /* The chain topology is about to change: quiesce the stage workers */
+    PipelineStop( chain );
+
     chained_filter_t *chained =
         vlc_custom_create( chain->obj, sizeof(*chained), "filter" );
     if( unlikely(chained == NULL) )
@@ -276,6 +311,15 @@ static filter_t *filter_chain_AppendInner( filter_chain_t *chain,
     chained->mouse = mouse;
     chained->pending = NULL;
 
+    chained->threaded = false;
+    vlc_mutex_init( &chained->lock );
+    vlc_cond_init( &chained->wait_data );
+    vlc_cond_init( &chained->wait_room );
+    chained->queue = NULL;
+    chained->queue_end = &chained->queue;
+    chained->depth = 0;
+    chained->exit = false;
+
     msg_Dbg( chain->obj, "Filter '%s' (%p) appended to chain",
              (name != NULL) ? name : module_get_name(filter->p_module, false),
              (void *)filter );
@@ -311,6 +355,8 @@ void filter_chain_DeleteFilter( filter_chain_t *chain, filter_t *filter )
 {
     chained_filter_t *chained = (chained_filter_t *)filter;
 
+    PipelineStop( chain );
+
     /* Remove it from the chain */
     if( chained->prev != NULL )
         chained->prev->next = chained->next;
@@ -422,6 +468,197 @@ vlc_video_context *filter_chain_GetVideoCtxOut(const filter_chain_t *p_chain)
     return p_chain->vctx_in;
 }
 
+/*****************************************************************************
+ * Pipelined execution
+ *****************************************************************************
+ * When "pipelined-filters" is set and the chain holds at least two filters,
+ * every filter runs on its own worker thread with a bounded FIFO of pictures
+ * between consecutive stages, so a chain like deinterlace→scale→adjust
+ * overlaps across CPU cores instead of running serially on the caller
+ * thread. Each stage is a single thread consuming its queue in order, so
+ * pictures leave the chain in their arrival (date) order. The pipeline is
+ * torn down whenever the chain topology changes or the chain is flushed,
+ * and filter_chain_VideoFilter() keeps its contract: it may simply return
+ * NULL for the first few pictures while the pipeline fills up.
+ *****************************************************************************/
+
+static void PipelineStagePush( chained_filter_t *f, picture_t *pic )
+{
+    vlc_mutex_lock( &f->lock );
+    while( f->depth >= PIPELINE_QUEUE_SIZE && !f->exit )
+        vlc_cond_wait( &f->wait_room, &f->lock );
+    if( f->exit )
+    {
+        vlc_mutex_unlock( &f->lock );
+        picture_Release( pic );
+        return;
+    }
+    pic->p_next = NULL;
+    *f->queue_end = pic;
+    f->queue_end = &pic->p_next;
+    f->depth++;
+    vlc_cond_signal( &f->wait_data );
+    vlc_mutex_unlock( &f->lock );
+}
+
+static void PipelineOutputPush( filter_chain_t *chain, picture_t *pic )
+{
+    vlc_mutex_lock( &chain->out_lock );
+    while( chain->out_depth >= PIPELINE_QUEUE_SIZE && !chain->out_exit )
+        vlc_cond_wait( &chain->out_wait_room, &chain->out_lock );
+    if( chain->out_exit )
+    {
+        vlc_mutex_unlock( &chain->out_lock );
+        picture_Release( pic );
+        return;
+    }
+    pic->p_next = NULL;
+    *chain->out_queue_end = pic;
+    chain->out_queue_end = &pic->p_next;
+    chain->out_depth++;
+    vlc_mutex_unlock( &chain->out_lock );
+}
+
+static picture_t *PipelineOutputPop( filter_chain_t *chain )
+{
+    vlc_mutex_lock( &chain->out_lock );
+    picture_t *pic = chain->out_queue;
+    if( pic != NULL )
+    {
+        chain->out_queue = pic->p_next;
+        if( chain->out_queue == NULL )
+            chain->out_queue_end = &chain->out_queue;
+        chain->out_depth--;
+        pic->p_next = NULL;
+        vlc_cond_signal( &chain->out_wait_room );
+    }
+    vlc_mutex_unlock( &chain->out_lock );
+    return pic;
+}
+
+static void *PipelineThread( void *data )
+{
+    chained_filter_t *f = data;
+    filter_chain_t *chain = f->filter.owner.sys;
+
+    for( ;; )
+    {
+        vlc_mutex_lock( &f->lock );
+        while( f->queue == NULL && !f->exit )
+            vlc_cond_wait( &f->wait_data, &f->lock );
+        if( f->queue == NULL )
+        {
+            vlc_mutex_unlock( &f->lock );
+            break;
+        }
+        picture_t *pic = f->queue;
+        f->queue = pic->p_next;
+        if( f->queue == NULL )
+            f->queue_end = &f->queue;
+        f->depth--;
+        vlc_cond_signal( &f->wait_room );
+        vlc_mutex_unlock( &f->lock );
+
+        pic->p_next = NULL;
+        int canc = vlc_savecancel();
+        pic = f->filter.pf_video_filter( &f->filter, pic );
+        vlc_restorecancel( canc );
+
+        /* Forward every output picture downstream, in order */
+        while( pic != NULL )
+        {
+            picture_t *next = pic->p_next;
+            pic->p_next = NULL;
+            if( f->next != NULL )
+                PipelineStagePush( f->next, pic );
+            else
+                PipelineOutputPush( chain, pic );
+            pic = next;
+        }
+    }
+    return NULL;
+}
+
+static bool PipelineStart( filter_chain_t *chain )
+{
+    assert( !chain->pipeline_running );
+
+    /* A single filter has nothing to overlap with */
+    if( chain->first == NULL || chain->first == chain->last )
+        return false;
+
+    for( chained_filter_t *f = chain->first; f != NULL; f = f->next )
+    {
+        /* Mouse events and GPU filters need the caller thread */
+        if( f->filter.pf_video_mouse != NULL || f->filter.vctx_out != NULL )
+        {
+            msg_Dbg( chain->obj, "filter '%s' not eligible, "
+                     "keeping the chain serial",
+                     module_get_name( f->filter.p_module, false ) );
+            return false;
+        }
+    }
+
+    for( chained_filter_t *f = chain->first; f != NULL; f = f->next )
+    {
+        f->exit = false;
+        if( vlc_clone( &f->thread, PipelineThread, f,
+                       VLC_THREAD_PRIORITY_VIDEO ) )
+        {
+            chain->pipeline_running = true; /* so PipelineStop() joins */
+            PipelineStop( chain );
+            msg_Warn( chain->obj, "cannot spawn filter workers, "
+                      "keeping the chain serial" );
+            return false;
+        }
+        f->threaded = true;
+    }
+
+    chain->out_exit = false;
+    chain->pipeline_running = true;
+    msg_Dbg( chain->obj, "running the filter chain pipelined" );
+    return true;
+}
+
+static void PipelineStop( filter_chain_t *chain )
+{
+    if( !chain->pipeline_running )
+        return;
+
+    for( chained_filter_t *f = chain->first; f != NULL; f = f->next )
+    {
+        vlc_mutex_lock( &f->lock );
+        f->exit = true;
+        vlc_cond_broadcast( &f->wait_data );
+        vlc_cond_broadcast( &f->wait_room );
+        vlc_mutex_unlock( &f->lock );
+    }
+    vlc_mutex_lock( &chain->out_lock );
+    chain->out_exit = true;
+    vlc_cond_broadcast( &chain->out_wait_room );
+    vlc_mutex_unlock( &chain->out_lock );
+
+    for( chained_filter_t *f = chain->first; f != NULL; f = f->next )
+    {
+        if( f->threaded )
+        {
+            vlc_join( f->thread, NULL );
+            f->threaded = false;
+        }
+        FilterDeletePictures( f->queue );
+        f->queue = NULL;
+        f->queue_end = &f->queue;
+        f->depth = 0;
+        f->exit = false;
+    }
+
+    FilterDeletePictures( chain->out_queue );
+    chain->out_queue = NULL;
+    chain->out_queue_end = &chain->out_queue;
+    chain->out_depth = 0;
+    chain->pipeline_running = false;
+}
+
 static picture_t *FilterChainVideoFilter( chained_filter_t *f, picture_t *p_pic )
 {
     for( ; f != NULL; f = f->next )
@@ -443,6 +680,20 @@ static picture_t *FilterChainVideoFilter( chained_filter_t *f, picture_t *p_pic
 
 picture_t *filter_chain_VideoFilter( filter_chain_t *p_chain, picture_t *p_pic )
 {
+    if( p_chain->pipelined )
+    {
+        if( !p_chain->pipeline_running && p_pic != NULL
+         && !PipelineStart( p_chain ) )
+            p_chain->pipelined = false; /* chain not eligible, stay serial */
+
+        if( p_chain->pipeline_running )
+        {
+            if( p_pic != NULL )
+                PipelineStagePush( p_chain->first, p_pic );
+            return PipelineOutputPop( p_chain );
+        }
+    }
+
     if( p_pic )
     {
         p_pic = FilterChainVideoFilter( p_chain->first, p_pic );
@@ -466,6 +717,9 @@ picture_t *filter_chain_VideoFilter( filter_chain_t *p_chain, picture_t *p_pic )
 
 void filter_chain_VideoFlush( filter_chain_t *p_chain )
 {
+    /* Drop in-flight pictures; the workers are restarted on the next run */
+    PipelineStop( p_chain );
+
     for( chained_filter_t *f = p_chain->first; f != NULL; f = f->next )
     {
         filter_t *p_filter = &f->filter;
@@ -753,8 +753,9 @@ static encoder_t *CreateEncoder( vlc_object_t *p_this, const video_format_t *fmt
     p_enc->fmt_out.video.i_width = p_enc->fmt_in.video.i_width;
     p_enc->fmt_out.video.i_height = p_enc->fmt_in.video.i_height;
 
-    /* Find a suitable decoder module */
-    p_enc->p_module = module_need( p_enc, "encoder", NULL, false );
+    /* Find a suitable encoder module; "image-encoder" lets hardware
+     * capable modules (VAAPI, NVJPEG, ...) claim the job */
+    p_enc->p_module = module_need_var( p_enc, "encoder", "image-encoder" );
     if( !p_enc->p_module )
     {
         msg_Err( p_enc, "no suitable encoder module for fourcc `%4.4s'.\n"
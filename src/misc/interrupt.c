@@ -54,6 +54,9 @@ void vlc_interrupt_init(vlc_interrupt_t *ctx)
     ctx->interrupted = false;
     atomic_init(&ctx->killed, false);
     ctx->callback = NULL;
+#ifndef _WIN32
+    ctx->wakefd[0] = ctx->wakefd[1] = -1;
+#endif
 }
 
 vlc_interrupt_t *vlc_interrupt_create(void)
@@ -71,6 +74,14 @@ vlc_interrupt_t *vlc_interrupt_create(void)
 void vlc_interrupt_deinit(vlc_interrupt_t *ctx)
 {
     assert(ctx->callback == NULL);
+#ifndef _WIN32
+    if (ctx->wakefd[0] != -1)
+    {
+        if (ctx->wakefd[1] != ctx->wakefd[0])
+            vlc_close(ctx->wakefd[1]);
+        vlc_close(ctx->wakefd[0]);
+    }
+#endif
 }
 
 void vlc_interrupt_destroy(vlc_interrupt_t *ctx)
@@ -279,6 +290,8 @@ int vlc_interrupt_forward_stop(void *const data[2])
 }
 
 #ifndef _WIN32
+# include <fcntl.h>
+
 static void vlc_poll_i11e_wake(void *opaque)
 {
     uint64_t value = 1;
@@ -290,35 +303,71 @@ static void vlc_poll_i11e_wake(void *opaque)
     vlc_restorecancel(canc);
 }
 
+/**
+ * Lazily creates the wake-up descriptors of an interruption context.
+ *
+ * Creating and destroying a descriptor pair on every single wait used to
+ * dominate the system call profile with many concurrent interruptible waits.
+ * The descriptors are instead kept until the context is destroyed, so that
+ * arming a wait boils down to registering the interrupt callback.
+ */
+static int vlc_poll_i11e_wakefd(vlc_interrupt_t *ctx)
+{
+    int *fd = ctx->wakefd;
+    int ret = 0;
+    int canc;
+
+    if (fd[0] != -1)
+        return 0;
+
+    canc = vlc_savecancel();
+# if defined (HAVE_EVENTFD) && defined (EFD_CLOEXEC)
+    fd[0] = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (fd[0] != -1)
+        fd[1] = fd[0];
+    else
+# endif
+    if (vlc_pipe(fd) == 0)
+        fcntl(fd[0], F_SETFL, fcntl(fd[0], F_GETFL) | O_NONBLOCK);
+    else
+    {
+        fd[0] = fd[1] = -1;
+        ret = -1;
+    }
+    vlc_restorecancel(canc);
+    return ret;
+}
+
+/**
+ * Discards any pending wake-up token, so that a wake-up delivered after the
+ * wait already ended does not spuriously interrupt the next wait.
+ */
+static void vlc_poll_i11e_drain(int *fd)
+{
+    uint64_t dummy;
+
+    if (fd[1] == fd[0])
+        read(fd[0], &dummy, sizeof (dummy));
+    else
+        while (read(fd[0], &dummy, sizeof (dummy)) > 0);
+}
+
 static void vlc_poll_i11e_cleanup(void *opaque)
 {
     vlc_interrupt_t *ctx = opaque;
-    int *fd = ctx->data;
 
     vlc_interrupt_finish(ctx);
-    if (fd[1] != fd[0])
-        vlc_close(fd[1]);
-    vlc_close(fd[0]);
+    vlc_poll_i11e_drain(ctx->wakefd);
 }
 
 static int vlc_poll_i11e_inner(struct pollfd *restrict fds, unsigned nfds,
                                int timeout, vlc_interrupt_t *ctx,
                                struct pollfd *restrict ufd)
 {
-    int fd[2];
+    int *fd = ctx->wakefd;
     int ret = -1;
-    int canc;
 
-    /* TODO: cache this */
-# if defined (HAVE_EVENTFD) && defined (EFD_CLOEXEC)
-    canc = vlc_savecancel();
-    fd[0] = eventfd(0, EFD_CLOEXEC);
-    vlc_restorecancel(canc);
-    if (fd[0] != -1)
-        fd[1] = fd[0];
-    else
-# endif
-    if (vlc_pipe(fd))
+    if (vlc_poll_i11e_wakefd(ctx))
     {
         vlc_testcancel();
         errno = ENOMEM;
@@ -343,24 +392,18 @@ static int vlc_poll_i11e_inner(struct pollfd *restrict fds, unsigned nfds,
 
     if (ret > 0 && ufd[nfds].revents)
     {
-        uint64_t dummy;
-
-        read(fd[0], &dummy, sizeof (dummy));
+        vlc_poll_i11e_drain(fd);
         ret--;
     }
     vlc_cleanup_pop();
 
     if (vlc_interrupt_finish(ctx))
     {
+        /* The callback may have fired after poll() returned. */
+        vlc_poll_i11e_drain(fd);
         errno = EINTR;
         ret = -1;
     }
-
-    canc = vlc_savecancel();
-    if (fd[1] != fd[0])
-        vlc_close(fd[1]);
-    vlc_close(fd[0]);
-    vlc_restorecancel(canc);
     return ret;
 }
 
@@ -392,7 +435,6 @@ int vlc_poll_i11e(struct pollfd *fds, unsigned nfds, int timeout)
     return ret;
 }
 
-# include <fcntl.h>
 # include <sys/uio.h>
 # ifdef HAVE_SYS_SOCKET_H
 #  include <sys/socket.h>
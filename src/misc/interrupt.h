@@ -36,5 +36,8 @@ struct vlc_interrupt
     atomic_bool killed;
     void (*callback)(void *);
     void *data;
+#ifndef _WIN32
+    int wakefd[2]; /**< Cached wake-up descriptors for vlc_poll_i11e() */
+#endif
 };
 #endif
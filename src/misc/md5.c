@@ -41,6 +41,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <stdatomic.h>
 
 #include <vlc_common.h>
 #include <vlc_hash.h>
@@ -351,3 +352,140 @@ void vlc_hash_md5_Finish(vlc_hash_md5_t *ctx, void *output, size_t size)
     md5_final(&ctx->priv);
     memcpy(output, ctx->priv.buf, VLC_HASH_MD5_DIGEST_SIZE);
 }
+
+/*
+ * MD5 tree hash: the input is cut into VLC_HASH_MD5_TREE_CHUNK_SIZE chunks,
+ * each chunk digest is fed in order into a root MD5 context, and the tree
+ * digest is the root digest. The streaming context below and the
+ * multi-threaded one-shot helper compute the exact same value.
+ */
+
+static void md5_tree_fold(vlc_hash_md5_tree_t *ctx)
+{
+    unsigned char digest[VLC_HASH_MD5_DIGEST_SIZE];
+
+    vlc_hash_md5_Finish(&ctx->priv.leaf, digest, sizeof (digest));
+    vlc_hash_md5_Update(&ctx->priv.root, digest, sizeof (digest));
+    vlc_hash_md5_Init(&ctx->priv.leaf);
+    ctx->priv.leaf_fill = 0;
+}
+
+void vlc_hash_md5_tree_Init(vlc_hash_md5_tree_t *ctx)
+{
+    vlc_hash_md5_Init(&ctx->priv.root);
+    vlc_hash_md5_Init(&ctx->priv.leaf);
+    ctx->priv.leaf_fill = 0;
+}
+
+void vlc_hash_md5_tree_Update(vlc_hash_md5_tree_t *ctx,
+                              const void *data, size_t size)
+{
+    const unsigned char *in = data;
+
+    while (size > 0)
+    {
+        size_t room = VLC_HASH_MD5_TREE_CHUNK_SIZE - ctx->priv.leaf_fill;
+        size_t take = (size < room) ? size : room;
+
+        vlc_hash_md5_Update(&ctx->priv.leaf, in, take);
+        ctx->priv.leaf_fill += take;
+        in += take;
+        size -= take;
+
+        if (ctx->priv.leaf_fill == VLC_HASH_MD5_TREE_CHUNK_SIZE)
+            md5_tree_fold(ctx);
+    }
+}
+
+void vlc_hash_md5_tree_Finish(vlc_hash_md5_tree_t *ctx,
+                              void *output, size_t size)
+{
+    if (ctx->priv.leaf_fill > 0)
+        md5_tree_fold(ctx);
+    vlc_hash_md5_Finish(&ctx->priv.root, output, size);
+}
+
+struct md5_tree_job
+{
+    const unsigned char *base;
+    size_t total;
+    size_t chunks;
+    unsigned char *digests;
+    atomic_size_t next;
+};
+
+static void md5_tree_work(struct md5_tree_job *job)
+{
+    size_t i;
+
+    while ((i = atomic_fetch_add_explicit(&job->next, 1,
+                                          memory_order_relaxed)) < job->chunks)
+    {
+        size_t offset = i * (size_t)VLC_HASH_MD5_TREE_CHUNK_SIZE;
+        size_t length = job->total - offset;
+        vlc_hash_md5_t leaf;
+
+        if (length > VLC_HASH_MD5_TREE_CHUNK_SIZE)
+            length = VLC_HASH_MD5_TREE_CHUNK_SIZE;
+
+        vlc_hash_md5_Init(&leaf);
+        vlc_hash_md5_Update(&leaf, job->base + offset, length);
+        vlc_hash_md5_Finish(&leaf, job->digests + i * VLC_HASH_MD5_DIGEST_SIZE,
+                            VLC_HASH_MD5_DIGEST_SIZE);
+    }
+}
+
+static void *md5_tree_thread(void *data)
+{
+    md5_tree_work(data);
+    return NULL;
+}
+
+void vlc_hash_md5_tree_Compute(void *output, size_t size,
+                               const void *data, size_t data_size)
+{
+    size_t chunks = data_size / VLC_HASH_MD5_TREE_CHUNK_SIZE
+                  + (data_size % VLC_HASH_MD5_TREE_CHUNK_SIZE != 0);
+    unsigned char *digests = (chunks > 0)
+        ? vlc_alloc(chunks, VLC_HASH_MD5_DIGEST_SIZE) : NULL;
+
+    if (chunks > 0 && unlikely(digests == NULL))
+    {   /* Out of memory: fall back to the streaming single-thread path */
+        vlc_hash_md5_tree_t ctx;
+
+        vlc_hash_md5_tree_Init(&ctx);
+        vlc_hash_md5_tree_Update(&ctx, data, data_size);
+        vlc_hash_md5_tree_Finish(&ctx, output, size);
+        return;
+    }
+
+    struct md5_tree_job job = { data, data_size, chunks, digests, 0 };
+
+    unsigned workers = vlc_GetCPUCount();
+    if (workers > chunks)
+        workers = chunks;
+
+    /* The calling thread is one of the workers; threads that cannot be
+     * spawned merely leave their chunks to the others. */
+    vlc_thread_t *threads = (workers > 1)
+        ? vlc_alloc(workers - 1, sizeof (*threads)) : NULL;
+    unsigned spawned = 0;
+
+    if (threads != NULL)
+        while (spawned < workers - 1
+            && vlc_clone(threads + spawned, md5_tree_thread, &job,
+                         VLC_THREAD_PRIORITY_LOW) == 0)
+            spawned++;
+
+    md5_tree_work(&job);
+
+    for (unsigned i = 0; i < spawned; i++)
+        vlc_join(threads[i], NULL);
+    free(threads);
+
+    vlc_hash_md5_t root;
+    vlc_hash_md5_Init(&root);
+    vlc_hash_md5_Update(&root, digests, chunks * VLC_HASH_MD5_DIGEST_SIZE);
+    vlc_hash_md5_Finish(&root, output, size);
+    free(digests);
+}
@@ -439,6 +439,176 @@ static struct vlc_logger *vlc_LogModuleCreate(vlc_object_t *parent)
     return &module->frontend;
 }
 
+/**
+ * Asynchronous message log.
+ *
+ * A message log that decouples the threads producing messages from the log
+ * sink: messages are captured and queued on the calling thread, while the
+ * sink (typically performing console or file I/O) runs on a dedicated
+ * low-priority thread. This keeps the timing impact of debug-level logging
+ * on the producing threads to a minimum. The message text is still formatted
+ * on the calling thread, as the variable argument list cannot outlive the
+ * call. If the queue overflows, messages are dropped rather than blocking
+ * the producers; the drops are accounted for in the log itself.
+ */
+typedef struct vlc_log_async_entry
+{
+    struct vlc_log_async_entry *next;
+    int type;
+    vlc_log_t meta;
+    char *msg;
+} vlc_log_async_entry_t;
+
+/* Maximum number of queued messages before dropping */
+#define VLC_LOG_ASYNC_QUEUE_MAX 4096
+
+struct vlc_logger_async {
+    vlc_mutex_t lock;
+    vlc_cond_t wait;
+    vlc_log_async_entry_t *head;
+    vlc_log_async_entry_t **tailp;
+    size_t depth;
+    size_t dropped;
+    bool closing;
+    vlc_thread_t thread;
+    vlc_logger_t *sink;
+    struct vlc_logger logger;
+};
+
+static void vlc_LogAsyncEntryDelete(vlc_log_async_entry_t *entry)
+{
+    free(entry->msg);
+    free((char *)entry->meta.psz_header);
+    free(entry);
+}
+
+static void *vlc_LogAsyncThread(void *opaque)
+{
+    struct vlc_logger_async *async = opaque;
+
+    vlc_mutex_lock(&async->lock);
+    for (;;)
+    {
+        while (async->head == NULL && !async->closing)
+            vlc_cond_wait(&async->wait, &async->lock);
+
+        if (async->head == NULL)
+            break; /* closing, and the queue is drained */
+
+        vlc_log_async_entry_t *entry = async->head;
+        async->head = entry->next;
+        if (async->head == NULL)
+            async->tailp = &async->head;
+        async->depth--;
+
+        size_t dropped = async->dropped;
+        async->dropped = 0;
+        vlc_mutex_unlock(&async->lock);
+
+        if (dropped > 0)
+            vlc_LogCallback(async->sink, VLC_MSG_WARN, &entry->meta,
+                            "message queue overflow: %zu messages lost",
+                            dropped);
+        vlc_LogCallback(async->sink, entry->type, &entry->meta, "%s",
+                        (entry->msg != NULL) ? entry->msg : "message lost");
+        vlc_LogAsyncEntryDelete(entry);
+
+        vlc_mutex_lock(&async->lock);
+    }
+    vlc_mutex_unlock(&async->lock);
+    return NULL;
+}
+
+static void vlc_vaLogAsync(void *d, int type, const vlc_log_t *item,
+                           const char *format, va_list ap)
+{
+    struct vlc_logger *logger = d;
+    struct vlc_logger_async *async =
+        container_of(logger, struct vlc_logger_async, logger);
+
+    vlc_log_async_entry_t *entry = malloc(sizeof (*entry));
+    if (unlikely(entry == NULL))
+        return;
+
+    entry->next = NULL;
+    entry->type = type;
+    entry->meta.i_object_id = item->i_object_id;
+    /* NOTE: Object types MUST be static constant - no need to copy them. */
+    entry->meta.psz_object_type = item->psz_object_type;
+    entry->meta.psz_module = item->psz_module; /* Ditto. */
+    entry->meta.psz_header = item->psz_header ? strdup(item->psz_header)
+                                              : NULL;
+    entry->meta.file = item->file;
+    entry->meta.line = item->line;
+    entry->meta.func = item->func;
+    entry->meta.tid = item->tid;
+
+    if (vasprintf(&entry->msg, format, ap) == -1)
+        entry->msg = NULL;
+
+    vlc_mutex_lock(&async->lock);
+    if (async->depth >= VLC_LOG_ASYNC_QUEUE_MAX || async->closing)
+    {   /* Dropping messages beats stalling the producers behind slow I/O */
+        async->dropped++;
+        vlc_mutex_unlock(&async->lock);
+        vlc_LogAsyncEntryDelete(entry);
+        return;
+    }
+
+    *(async->tailp) = entry;
+    async->tailp = &entry->next;
+    if (async->depth++ == 0)
+        vlc_cond_signal(&async->wait);
+    vlc_mutex_unlock(&async->lock);
+}
+
+static void vlc_LogAsyncClose(void *d)
+{
+    struct vlc_logger *logger = d;
+    struct vlc_logger_async *async =
+        container_of(logger, struct vlc_logger_async, logger);
+    vlc_logger_t *sink = async->sink;
+
+    vlc_mutex_lock(&async->lock);
+    async->closing = true;
+    vlc_cond_signal(&async->wait);
+    vlc_mutex_unlock(&async->lock);
+    vlc_join(async->thread, NULL);
+
+    sink->ops->destroy(sink);
+    free(async);
+}
+
+static const struct vlc_logger_operations async_ops = {
+    vlc_vaLogAsync,
+    vlc_LogAsyncClose,
+};
+
+static struct vlc_logger *vlc_LogAsyncCreate(vlc_logger_t *sink)
+{
+    struct vlc_logger_async *async = malloc(sizeof (*async));
+    if (unlikely(async == NULL))
+        return NULL;
+
+    async->logger.ops = &async_ops;
+    vlc_mutex_init(&async->lock);
+    vlc_cond_init(&async->wait);
+    async->head = NULL;
+    async->tailp = &async->head;
+    async->depth = 0;
+    async->dropped = 0;
+    async->closing = false;
+    async->sink = sink;
+
+    if (vlc_clone(&async->thread, vlc_LogAsyncThread, async,
+                  VLC_THREAD_PRIORITY_LOW))
+    {
+        free(async);
+        return NULL;
+    }
+    return &async->logger;
+}
+
 /**
  * Initializes the messages logging subsystem and drain the early messages to
  * the configured log.
@@ -448,6 +618,13 @@ void vlc_LogInit(libvlc_int_t *vlc)
     struct vlc_logger *logger = vlc_LogModuleCreate(VLC_OBJECT(vlc));
     if (logger == NULL)
         logger = &discard_log;
+    else if (var_InheritBool(vlc, "log-async"))
+    {
+        /* Decouple the producers from the log sink */
+        struct vlc_logger *async = vlc_LogAsyncCreate(logger);
+        if (async != NULL)
+            logger = async;
+    }
 
     vlc_LogSwitch(vlc->obj.logger, logger);
 }
@@ -66,12 +66,39 @@ char *secstotimestr( char *psz_buffer, int32_t i_seconds )
  * Date management (internal and external)
  */
 
+static void date_ResetInc( date_t *p_date )
+{
+    p_date->i_inc_count = 0;
+    p_date->i_inc_rem = 0;
+    p_date->i_inc_quot = 0;
+}
+
+/*
+ * Converts a sample count into a tick quotient and remainder, reusing the
+ * cached division when the count matches the previous call. Audio and demux
+ * paths step by the same number of samples for every block, so the division
+ * typically only runs when the stream format changes.
+ */
+static void date_UpdateInc( date_t *p_date, uint32_t i_nb_samples )
+{
+    if( i_nb_samples == p_date->i_inc_count )
+        return;
+
+    vlc_tick_t i_dividend = (vlc_tick_t)i_nb_samples * CLOCK_FREQ * p_date->i_divider_den;
+    lldiv_t d = lldiv( i_dividend, p_date->i_divider_num );
+
+    p_date->i_inc_count = i_nb_samples;
+    p_date->i_inc_rem = (uint32_t)d.rem;
+    p_date->i_inc_quot = d.quot;
+}
+
 void date_Init( date_t *p_date, uint32_t i_divider_n, uint32_t i_divider_d )
 {
     p_date->date = VLC_TICK_INVALID;
     p_date->i_divider_num = i_divider_n;
     p_date->i_divider_den = i_divider_d;
     p_date->i_remainder = 0;
+    date_ResetInc( p_date );
 }
 
 void date_Change( date_t *p_date, uint32_t i_divider_n, uint32_t i_divider_d )
@@ -81,6 +108,7 @@ void date_Change( date_t *p_date, uint32_t i_divider_n, uint32_t i_divider_d )
     p_date->i_remainder = p_date->i_remainder * i_divider_n / p_date->i_divider_num;
     p_date->i_divider_num = i_divider_n;
     p_date->i_divider_den = i_divider_d;
+    date_ResetInc( p_date );
 }
 
 vlc_tick_t date_Increment( date_t *p_date, uint32_t i_nb_samples )
@@ -88,11 +116,10 @@ vlc_tick_t date_Increment( date_t *p_date, uint32_t i_nb_samples )
     if(unlikely(p_date->date == VLC_TICK_INVALID))
         return VLC_TICK_INVALID;
     assert( p_date->i_divider_num != 0 );
-    vlc_tick_t i_dividend = i_nb_samples * CLOCK_FREQ * p_date->i_divider_den;
-    lldiv_t d = lldiv( i_dividend, p_date->i_divider_num );
+    date_UpdateInc( p_date, i_nb_samples );
 
-    p_date->date += d.quot;
-    p_date->i_remainder += (int)d.rem;
+    p_date->date += p_date->i_inc_quot;
+    p_date->i_remainder += p_date->i_inc_rem;
 
     if( p_date->i_remainder >= p_date->i_divider_num )
     {
@@ -109,9 +136,10 @@ vlc_tick_t date_Decrement( date_t *p_date, uint32_t i_nb_samples )
 {
     if(unlikely(p_date->date == VLC_TICK_INVALID))
         return VLC_TICK_INVALID;
-    vlc_tick_t i_dividend = (vlc_tick_t)i_nb_samples * CLOCK_FREQ * p_date->i_divider_den;
-    p_date->date -= i_dividend / p_date->i_divider_num;
-    unsigned i_rem_adjust = i_dividend % p_date->i_divider_num;
+    date_UpdateInc( p_date, i_nb_samples );
+
+    p_date->date -= p_date->i_inc_quot;
+    unsigned i_rem_adjust = p_date->i_inc_rem;
 
     if( p_date->i_remainder < i_rem_adjust )
     {
@@ -349,6 +349,179 @@ void picture_Destroy(picture_t *picture)
     free(priv);
 }
 
+/*****************************************************************************
+ * Picture copy engine
+ *****************************************************************************
+ * Large plane copies are memory-bandwidth bound: split them across a small
+ * process-wide worker pool, and bypass the caches with non-temporal stores
+ * since a plane bigger than the last-level cache would only evict useful
+ * data.  The workers are created on first use and last for the whole
+ * process.
+ *****************************************************************************/
+
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
+/* Minimum plane size before a copy is handed to the worker pool */
+#define COPY_ENGINE_THRESHOLD (2u << 20)
+/* Lines are handed out in chunks to balance the load between workers */
+#define COPY_ENGINE_CHUNK_LINES 64
+/* Beyond a few threads, the memory bus is saturated anyway */
+#define COPY_ENGINE_MAX_THREADS 3 /* plus the submitting thread */
+
+static void CopyLine( uint8_t *dst, const uint8_t *src, size_t size )
+{
+#ifdef __SSE2__
+    size_t head = -(uintptr_t)dst & 15;
+
+    if( size >= head + 64 )
+    {
+        memcpy( dst, src, head );
+        dst += head;
+        src += head;
+        size -= head;
+
+        while( size >= 16 )
+        {
+            _mm_stream_si128( (__m128i *)dst,
+                              _mm_loadu_si128( (const __m128i *)src ) );
+            dst += 16;
+            src += 16;
+            size -= 16;
+        }
+    }
+#endif
+    memcpy( dst, src, size );
+}
+
+static struct copy_engine
+{
+    vlc_mutex_t lock;
+    vlc_cond_t wait; /* signals a new job to the workers */
+    vlc_cond_t done; /* signals chunk/job completion to the submitters */
+    unsigned threads;
+
+    /* Job in progress, owned by the submitter until all lines are copied */
+    bool active;
+    unsigned generation;
+    uint8_t *dst;
+    const uint8_t *src;
+    int dst_pitch, src_pitch;
+    size_t width;
+    unsigned lines, next_line;
+    unsigned busy; /* workers still copying a chunk */
+} copy_engine = {
+    .lock = VLC_STATIC_MUTEX,
+    .wait = VLC_STATIC_COND,
+    .done = VLC_STATIC_COND,
+};
+
+/* Copy chunks of lines until the current job runs out of them.
+ * The engine lock must be held. */
+static void CopyEngineWork( struct copy_engine *e )
+{
+    while( e->next_line < e->lines )
+    {
+        unsigned line = e->next_line;
+        unsigned count = __MIN( COPY_ENGINE_CHUNK_LINES, e->lines - line );
+        const uint8_t *src = e->src + (size_t)line * e->src_pitch;
+        uint8_t *dst = e->dst + (size_t)line * e->dst_pitch;
+        int src_pitch = e->src_pitch, dst_pitch = e->dst_pitch;
+        size_t width = e->width;
+
+        e->next_line = line + count;
+        e->busy++;
+        vlc_mutex_unlock( &e->lock );
+
+        for( unsigned i = 0; i < count; i++ )
+        {
+            CopyLine( dst, src, width );
+            src += src_pitch;
+            dst += dst_pitch;
+        }
+#ifdef __SSE2__
+        /* Make the streaming stores visible to the submitting thread */
+        _mm_sfence();
+#endif
+
+        vlc_mutex_lock( &e->lock );
+        e->busy--;
+    }
+    if( e->busy == 0 )
+        vlc_cond_broadcast( &e->done );
+}
+
+static void *CopyEngineThread( void *opaque )
+{
+    struct copy_engine *e = opaque;
+    unsigned generation = 0;
+
+    vlc_mutex_lock( &e->lock );
+    for( ;; )
+    {
+        while( e->generation == generation )
+            vlc_cond_wait( &e->wait, &e->lock );
+        generation = e->generation;
+        CopyEngineWork( e );
+    }
+    vlc_assert_unreachable();
+}
+
+static void CopyEngineInit( void )
+{
+    struct copy_engine *e = &copy_engine;
+    unsigned count = vlc_GetCPUCount();
+
+    count = ( count > 1 ) ? count - 1 : 0; /* the submitter copies too */
+    if( count > COPY_ENGINE_MAX_THREADS )
+        count = COPY_ENGINE_MAX_THREADS;
+
+    for( unsigned i = 0; i < count; i++ )
+    {
+        /* The workers are never joined; they last for the whole process */
+        vlc_thread_t th;
+        if( vlc_clone( &th, CopyEngineThread, e, VLC_THREAD_PRIORITY_VIDEO ) )
+            break;
+        e->threads++;
+    }
+}
+
+static bool CopyEngineRun( plane_t *restrict p_dst, const plane_t *p_src,
+                           size_t i_width, unsigned i_height )
+{
+    static vlc_once_t once = VLC_STATIC_ONCE;
+    struct copy_engine *e = &copy_engine;
+
+    vlc_once( &once, CopyEngineInit );
+    if( e->threads == 0 )
+        return false;
+
+    vlc_mutex_lock( &e->lock );
+    while( e->active )
+        vlc_cond_wait( &e->done, &e->lock );
+
+    e->active = true;
+    e->generation++;
+    e->dst = p_dst->p_pixels;
+    e->src = p_src->p_pixels;
+    e->dst_pitch = p_dst->i_pitch;
+    e->src_pitch = p_src->i_pitch;
+    e->width = i_width;
+    e->lines = i_height;
+    e->next_line = 0;
+    vlc_cond_broadcast( &e->wait );
+
+    CopyEngineWork( e );
+    while( e->busy > 0 )
+        vlc_cond_wait( &e->done, &e->lock );
+
+    e->active = false;
+    vlc_cond_broadcast( &e->done ); /* wake up a queued submitter */
+    vlc_mutex_unlock( &e->lock );
+    return true;
+}
+
 /*****************************************************************************
  *
  *****************************************************************************/
@@ -367,6 +540,10 @@ void plane_CopyPixels( plane_t *p_dst, const plane_t *p_src )
         p_src->i_pitch < 2*p_src->i_visible_pitch )
     {
         /* There are margins, but with the same width : perfect ! */
+        if( (size_t)p_src->i_pitch * i_height >= COPY_ENGINE_THRESHOLD &&
+            CopyEngineRun( p_dst, p_src, p_src->i_pitch, i_height ) )
+            return;
+
         memcpy( p_dst->p_pixels, p_src->p_pixels,
                     p_src->i_pitch * i_height );
     }
@@ -379,6 +556,10 @@ void plane_CopyPixels( plane_t *p_dst, const plane_t *p_src )
         assert( p_in );
         assert( p_out );
 
+        if( (size_t)i_width * i_height >= COPY_ENGINE_THRESHOLD &&
+            CopyEngineRun( p_dst, p_src, i_width, i_height ) )
+            return;
+
         for( int i_line = i_height; i_line--; )
         {
             memcpy( p_out, p_in, i_width );
@@ -29,6 +29,9 @@
 #include <limits.h>
 #include <stdatomic.h>
 #include <stdlib.h>
+#ifdef __linux__
+# include <sys/mman.h>
+#endif
 
 #include <vlc_common.h>
 #include <vlc_picture_pool.h>
@@ -120,9 +123,122 @@ picture_pool_t *picture_pool_New(unsigned count, picture_t *const *tab)
     return pool;
 }
 
+/*** Arena-backed pools ***/
+
+/* All planes of all pictures of a pool share a single 64-byte-aligned
+ * allocation, instead of one scattered heap buffer per picture. This keeps
+ * a whole pool in as few contiguous mappings (and TLB entries) as possible,
+ * which matters for large formats where each picture spans megabytes. */
+struct picture_pool_arena {
+    atomic_uint refs;
+    size_t      size;
+    void       *base;
+};
+
+static void picture_pool_ArenaDestroy(struct picture_pool_arena *arena)
+{
+    if (atomic_fetch_sub_explicit(&arena->refs, 1, memory_order_release) != 1)
+        return;
+
+    atomic_thread_fence(memory_order_acquire);
+    aligned_free(arena->base);
+    free(arena);
+}
+
+static void picture_pool_ArenaPictureDestroy(picture_t *picture)
+{
+    picture_pool_ArenaDestroy(picture->p_sys);
+}
+
+static picture_pool_t *picture_pool_NewArena(const video_format_t *fmt,
+                                             unsigned count)
+{
+    picture_t tmpl;
+    size_t plane_sizes[PICTURE_PLANE_MAX];
+    size_t pic_size = 0;
+
+    memset(&tmpl, 0, sizeof (tmpl));
+    if (picture_Setup(&tmpl, fmt) || tmpl.i_planes == 0)
+        return NULL;
+
+    for (int i = 0; i < tmpl.i_planes; i++)
+    {
+        const plane_t *p = &tmpl.p[i];
+
+        if (unlikely(mul_overflow(p->i_pitch, p->i_lines, &plane_sizes[i]))
+         || unlikely(add_overflow(pic_size, plane_sizes[i], &pic_size)))
+            return NULL;
+    }
+
+    /* Keep every picture of the arena cache-line-aligned */
+    if (unlikely(add_overflow(pic_size, (-pic_size) & 63, &pic_size)))
+        return NULL;
+
+    size_t total;
+    if (unlikely(mul_overflow(pic_size, count, &total)))
+        return NULL;
+
+    struct picture_pool_arena *arena = malloc(sizeof (*arena));
+    if (unlikely(arena == NULL))
+        return NULL;
+
+    arena->base = aligned_alloc(64, total);
+    if (unlikely(arena->base == NULL)) {
+        free(arena);
+        return NULL;
+    }
+    arena->size = total;
+    atomic_init(&arena->refs, count);
+#if defined (__linux__) && defined (MADV_HUGEPAGE)
+    /* Best effort: back big arenas with huge pages to cut TLB pressure */
+    madvise(arena->base, total, MADV_HUGEPAGE);
+#endif
+
+    picture_t *picture[count ? count : 1];
+    unsigned i;
+
+    for (i = 0; i < count; i++) {
+        picture_resource_t res = {
+            .p_sys = arena,
+            .pf_destroy = picture_pool_ArenaPictureDestroy,
+        };
+        unsigned char *buf = (unsigned char *)arena->base + i * pic_size;
+
+        for (int j = 0; j < tmpl.i_planes; j++) {
+            res.p[j].p_pixels = buf;
+            res.p[j].i_lines = tmpl.p[j].i_lines;
+            res.p[j].i_pitch = tmpl.p[j].i_pitch;
+            buf += plane_sizes[j];
+        }
+
+        picture[i] = picture_NewFromResource(fmt, &res);
+        if (picture[i] == NULL)
+            goto error;
+    }
+
+    picture_pool_t *pool = picture_pool_New(count, picture);
+    if (!pool)
+        goto error;
+
+    return pool;
+
+error:
+    while (i > 0)
+        picture_Release(picture[--i]);
+    /* unreferenced arena slots */
+    for (unsigned j = i; j < count; j++)
+        picture_pool_ArenaDestroy(arena);
+    return NULL;
+}
+
 picture_pool_t *picture_pool_NewFromFormat(const video_format_t *fmt,
                                            unsigned count)
 {
+    picture_pool_t *pool = picture_pool_NewArena(fmt, count);
+    if (pool != NULL)
+        return pool;
+
+    /* Opaque formats and other planeless cases: regular per-picture path */
     picture_t *picture[count ? count : 1];
     unsigned i;
 
@@ -132,7 +248,7 @@ picture_pool_t *picture_pool_NewFromFormat(const video_format_t *fmt,
             goto error;
     }
 
-    picture_pool_t *pool = picture_pool_New(count, picture);
+    pool = picture_pool_New(count, picture);
     if (!pool)
         goto error;
 
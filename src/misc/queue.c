@@ -77,7 +77,7 @@ void vlc_queue_Init(vlc_queue_t *q, ptrdiff_t next_offset)
     vlc_cond_init(&q->wait);
 }
 
-void vlc_queue_EnqueueUnlocked(vlc_queue_t *q, void *entry)
+static void vlc_queue_LinkUnlocked(vlc_queue_t *q, void *entry)
 {
     struct vlc_queue_entry **lastp;
     const ptrdiff_t offset = q->next_offset;
@@ -90,6 +90,11 @@ void vlc_queue_EnqueueUnlocked(vlc_queue_t *q, void *entry)
         lastp = next_p(entry, offset);
 
     q->lastp = lastp;
+}
+
+void vlc_queue_EnqueueUnlocked(vlc_queue_t *q, void *entry)
+{
+    vlc_queue_LinkUnlocked(q, entry);
     vlc_queue_Signal(q);
 }
 
@@ -128,7 +133,16 @@ void *vlc_queue_DequeueAllUnlocked(vlc_queue_t *q)
 void vlc_queue_Enqueue(vlc_queue_t *q, void *entry)
 {
     vlc_queue_Lock(q);
-    vlc_queue_EnqueueUnlocked(q, entry);
+
+    /* The high-level consumers only ever wait while the queue is empty, so
+     * the wake-up can be elided unless the queue becomes non-empty. Waiters
+     * with other predicates must use the low-level functions. */
+    const bool wake = vlc_queue_IsEmpty(q) && entry != NULL;
+
+    vlc_queue_LinkUnlocked(q, entry);
+
+    if (wake)
+        vlc_queue_Signal(q);
     vlc_queue_Unlock(q);
 }
 
@@ -143,6 +157,11 @@ void *vlc_queue_Dequeue(vlc_queue_t *q)
         vlc_queue_Wait(q);
 
     entry = vlc_queue_DequeueUnlocked(q);
+
+    /* Producers only signal the empty to non-empty transition. Relay the
+     * wake-up to any other consumer if entries remain. */
+    if (!vlc_queue_IsEmpty(q))
+        vlc_queue_Signal(q);
     vlc_queue_Unlock(q);
 
     return entry;
@@ -23,6 +23,8 @@
 # include <config.h>
 #endif
 
+#include <string.h>
+
 #include <vlc_common.h>
 #include <vlc_sort.h>
 
@@ -56,3 +58,202 @@ VLC_WEAK void vlc_qsort(void *base, size_t nmemb, size_t size,
     state.compar = saved_compar;
     state.arg = saved_arg;
 }
+
+/*
+ * Stable, optionally parallel, merge sort.
+ */
+
+/** Do not bother spawning threads below this element count */
+#define MERGESORT_PARALLEL_THRESHOLD 8192
+/** Upper bound on worker threads (including the calling thread) */
+#define MERGESORT_MAX_WORKERS 8
+
+struct msort_ctx
+{
+    size_t size;
+    int (*compar)(const void *, const void *, void *);
+    void *arg;
+};
+
+static void merge_runs(const struct msort_ctx *ctx, unsigned char *dst,
+                       const unsigned char *a, size_t na,
+                       const unsigned char *b, size_t nb)
+{
+    const size_t size = ctx->size;
+
+    while (na > 0 && nb > 0)
+    {
+        /* take from a on ties to keep the sort stable */
+        if (ctx->compar(a, b, ctx->arg) <= 0)
+        {
+            memcpy(dst, a, size);
+            a += size;
+            na--;
+        }
+        else
+        {
+            memcpy(dst, b, size);
+            b += size;
+            nb--;
+        }
+        dst += size;
+    }
+    memcpy(dst, a, na * size);
+    memcpy(dst + na * size, b, nb * size);
+}
+
+/** Bottom-up merge sort; the result always ends up in base. */
+static void msort_run(const struct msort_ctx *ctx, unsigned char *base,
+                      unsigned char *tmp, size_t nmemb)
+{
+    const size_t size = ctx->size;
+    unsigned char *src = base, *dst = tmp;
+
+    for (size_t width = 1; width < nmemb; width *= 2)
+    {
+        for (size_t off = 0; off < nmemb; off += 2 * width)
+        {
+            size_t na = __MIN(width, nmemb - off);
+            size_t nb = (off + width < nmemb)
+                      ? __MIN(width, nmemb - off - width) : 0;
+            merge_runs(ctx, dst + off * size, src + off * size, na,
+                       src + (off + width) * size, nb);
+        }
+
+        unsigned char *swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != base)
+        memcpy(base, src, nmemb * size);
+}
+
+struct msort_task
+{
+    const struct msort_ctx *ctx;
+    vlc_thread_t thread;
+    bool joinable;
+
+    /* chunk sorting phase */
+    unsigned char *base, *tmp;
+    size_t nmemb;
+
+    /* merge phase */
+    unsigned char *dst;
+    const unsigned char *a, *b;
+    size_t na, nb;
+};
+
+static void *SortChunkThread(void *data)
+{
+    struct msort_task *task = data;
+
+    msort_run(task->ctx, task->base, task->tmp, task->nmemb);
+    return NULL;
+}
+
+static void *MergeThread(void *data)
+{
+    struct msort_task *task = data;
+
+    merge_runs(task->ctx, task->dst, task->a, task->na, task->b, task->nb);
+    return NULL;
+}
+
+/** Runs tasks[0] inline and the others on worker threads, then joins. */
+static void msort_run_tasks(struct msort_task tasks[], size_t count,
+                            void *(*routine)(void *))
+{
+    for (size_t i = 1; i < count; ++i)
+        tasks[i].joinable = vlc_clone(&tasks[i].thread, routine, &tasks[i],
+                                      VLC_THREAD_PRIORITY_LOW) == 0;
+
+    routine(&tasks[0]);
+
+    for (size_t i = 1; i < count; ++i)
+        if (tasks[i].joinable)
+            vlc_join(tasks[i].thread, NULL);
+        else
+            routine(&tasks[i]); /* thread creation failed: degrade */
+}
+
+void vlc_mergesort(void *base, size_t nmemb, size_t size,
+                   int (*compar)(const void *, const void *, void *),
+                   void *arg)
+{
+    struct msort_ctx ctx = { size, compar, arg };
+
+    if (nmemb < 2)
+        return;
+
+    unsigned char *tmp = malloc(nmemb * size);
+    if (unlikely(tmp == NULL))
+    {
+        /* like the C libraries, degrade to an unstable in-place sort */
+        vlc_qsort(base, nmemb, size, compar, arg);
+        return;
+    }
+
+    size_t workers = 1;
+    if (nmemb >= MERGESORT_PARALLEL_THRESHOLD)
+        workers = __MIN(__MIN(vlc_GetCPUCount(), MERGESORT_MAX_WORKERS),
+                        nmemb / (MERGESORT_PARALLEL_THRESHOLD / 2));
+
+    if (workers < 2)
+    {
+        msort_run(&ctx, base, tmp, nmemb);
+        free(tmp);
+        return;
+    }
+
+    struct msort_task *tasks = vlc_alloc(workers, sizeof (*tasks));
+    if (unlikely(tasks == NULL))
+    {
+        msort_run(&ctx, base, tmp, nmemb);
+        free(tmp);
+        return;
+    }
+
+    /* sort one chunk per worker */
+    const size_t chunk = (nmemb + workers - 1) / workers;
+    size_t count = 0;
+    for (size_t off = 0; off < nmemb; off += chunk, ++count)
+    {
+        struct msort_task *t = &tasks[count];
+        t->ctx = &ctx;
+        t->base = (unsigned char *)base + off * size;
+        t->tmp = tmp + off * size;
+        t->nmemb = __MIN(chunk, nmemb - off);
+    }
+    msort_run_tasks(tasks, count, SortChunkThread);
+
+    /* merge the sorted chunks pairwise, ping-ponging between the buffers */
+    unsigned char *src = base, *dst = tmp;
+    for (size_t width = chunk; width < nmemb; width *= 2)
+    {
+        count = 0;
+        for (size_t off = 0; off < nmemb; off += 2 * width, ++count)
+        {
+            struct msort_task *t = &tasks[count];
+            t->ctx = &ctx;
+            t->dst = dst + off * size;
+            t->a = src + off * size;
+            t->na = __MIN(width, nmemb - off);
+            t->b = src + (off + width) * size;
+            t->nb = (off + width < nmemb)
+                  ? __MIN(width, nmemb - off - width) : 0;
+        }
+        msort_run_tasks(tasks, count, MergeThread);
+
+        unsigned char *swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != base)
+        memcpy(base, src, nmemb * size);
+
+    free(tasks);
+    free(tmp);
+}
@@ -38,6 +38,177 @@ static_assert (sizeof (atomic_uint) <= sizeof (struct vlc_suuint),
 static_assert (alignof (atomic_uint) <= alignof (struct vlc_suuint),
                "Alignment mismatch");
 
+/*** Mutex contention profiling (opt-in) ***/
+
+#ifdef LIBVLC_PROFILE_LOCKS
+/*
+ * Built with -DLIBVLC_PROFILE_LOCKS (GCC or Clang required) and enabled at
+ * run time by setting VLC_MUTEX_PROFILE in the environment, every contended
+ * vlc_mutex_lock() call site gets its contention count, total wait time and
+ * total (contended) hold time recorded. Samples are aggregated in
+ * thread-local tables, so the hot path takes no lock and dirties no shared
+ * cache line; the tables are only walked by the process exit dump. Per-thread
+ * tables are kept until process exit on purpose, so that the dump covers
+ * threads which have already terminated.
+ */
+# include <stdio.h>
+# include <inttypes.h>
+
+# define VLC_LOCK_PROFILE_SITES 256 /* power of two */
+# define VLC_LOCK_PROFILE_HELD   16
+
+struct vlc_lock_site
+{
+    const void *callsite; /* return address of vlc_mutex_lock() */
+    uint64_t contended; /* acquisitions which could not take the fast path */
+    vlc_tick_t waited; /* total time spent waiting for the lock */
+    vlc_tick_t held; /* total hold time of contended acquisitions */
+};
+
+struct vlc_lock_profile
+{
+    struct vlc_lock_site sites[VLC_LOCK_PROFILE_SITES];
+    struct
+    {
+        const vlc_mutex_t *mutex;
+        struct vlc_lock_site *site;
+        vlc_tick_t since;
+    } held[VLC_LOCK_PROFILE_HELD];
+    struct vlc_lock_profile *next; /* global list, walked by the dump */
+};
+
+static _Thread_local struct vlc_lock_profile *vlc_lock_profile;
+static struct vlc_lock_profile *_Atomic vlc_lock_profiles = NULL;
+
+static bool vlc_lock_profile_enabled(void)
+{
+    static atomic_int enabled = ATOMIC_VAR_INIT(-1);
+    int e = atomic_load_explicit(&enabled, memory_order_relaxed);
+
+    if (unlikely(e < 0))
+    {
+        e = getenv("VLC_MUTEX_PROFILE") != NULL;
+        atomic_store_explicit(&enabled, e, memory_order_relaxed);
+    }
+    return e != 0;
+}
+
+static struct vlc_lock_profile *vlc_lock_profile_get(void)
+{
+    struct vlc_lock_profile *profile = vlc_lock_profile;
+
+    if (unlikely(profile == NULL))
+    {
+        profile = calloc(1, sizeof (*profile));
+        if (unlikely(profile == NULL))
+            return NULL;
+
+        vlc_lock_profile = profile;
+        profile->next = atomic_load_explicit(&vlc_lock_profiles,
+                                             memory_order_relaxed);
+        while (!atomic_compare_exchange_weak_explicit(&vlc_lock_profiles,
+                                                      &profile->next, profile,
+                                                      memory_order_release,
+                                                      memory_order_relaxed));
+    }
+    return profile;
+}
+
+static struct vlc_lock_site *
+vlc_lock_profile_site(struct vlc_lock_profile *profile, const void *callsite)
+{
+    size_t slot = ((uintptr_t)callsite >> 4)
+                & (VLC_LOCK_PROFILE_SITES - 1);
+
+    for (size_t i = 0; i < VLC_LOCK_PROFILE_SITES; i++)
+    {
+        struct vlc_lock_site *site =
+            profile->sites + ((slot + i) & (VLC_LOCK_PROFILE_SITES - 1));
+
+        if (site->callsite == callsite)
+            return site;
+        if (site->callsite == NULL)
+        {
+            site->callsite = callsite;
+            return site;
+        }
+    }
+    return NULL; /* table full: drop the sample */
+}
+
+static void vlc_lock_profile_waited(const void *callsite, vlc_mutex_t *mtx,
+                                    vlc_tick_t start, vlc_tick_t acquired)
+{
+    struct vlc_lock_profile *profile = vlc_lock_profile_get();
+    if (unlikely(profile == NULL))
+        return;
+
+    struct vlc_lock_site *site = vlc_lock_profile_site(profile, callsite);
+    if (unlikely(site == NULL))
+        return;
+
+    site->contended++;
+    site->waited += acquired - start;
+
+    for (size_t i = 0; i < VLC_LOCK_PROFILE_HELD; i++)
+        if (profile->held[i].mutex == NULL)
+        {
+            profile->held[i].mutex = mtx;
+            profile->held[i].site = site;
+            profile->held[i].since = acquired;
+            break;
+        }
+}
+
+static void vlc_lock_profile_released(vlc_mutex_t *mtx)
+{
+    struct vlc_lock_profile *profile = vlc_lock_profile;
+    if (likely(profile == NULL))
+        return;
+
+    for (size_t i = 0; i < VLC_LOCK_PROFILE_HELD; i++)
+        if (profile->held[i].mutex == mtx)
+        {
+            profile->held[i].site->held += vlc_tick_now()
+                                         - profile->held[i].since;
+            profile->held[i].mutex = NULL;
+            return;
+        }
+}
+
+void vlc_mutex_profile_Dump(FILE *stream)
+{
+    /* Counters from still-running threads are read without synchronization;
+     * the dump is a monotonic snapshot, not an exact cut. */
+    for (const struct vlc_lock_profile *profile =
+             atomic_load_explicit(&vlc_lock_profiles, memory_order_acquire);
+         profile != NULL; profile = profile->next)
+        for (size_t i = 0; i < VLC_LOCK_PROFILE_SITES; i++)
+        {
+            const struct vlc_lock_site *site = profile->sites + i;
+
+            if (site->callsite == NULL)
+                continue;
+            fprintf(stream, "lock site %p: %13"PRIu64" contended, "
+                    "%"PRId64" us waited, %"PRId64" us held\n",
+                    site->callsite, site->contended,
+                    US_FROM_VLC_TICK(site->waited),
+                    US_FROM_VLC_TICK(site->held));
+        }
+}
+
+__attribute__((destructor))
+static void vlc_lock_profile_exit(void)
+{
+    if (vlc_lock_profile_enabled())
+        vlc_mutex_profile_Dump(stderr);
+}
+#else
+# define vlc_lock_profile_enabled() (false)
+# define vlc_lock_profile_waited(callsite, mtx, start, acquired) ((void)0)
+# define vlc_lock_profile_released(mtx) ((void)0)
+#endif
+
 /*** Global locks ***/
 
 void vlc_global_mutex (unsigned n, bool acquire)
@@ -155,6 +326,33 @@ bool vlc_mutex_held(const vlc_mutex_t *mtx)
                                                memory_order_relaxed);
 }
 
+/* Number of times the lock owner is given a chance to leave a short critical
+ * section before the acquirer goes to kernel sleep. Zero on uniprocessors,
+ * where spinning can only delay the owner. */
+#define VLC_MUTEX_SPIN 64
+
+static void vlc_mutex_cpu_relax(void)
+{
+#if defined (__i386__) || defined (__x86_64__)
+    __asm__ volatile ("pause" ::: "memory");
+#elif defined (__aarch64__)
+    __asm__ volatile ("yield" ::: "memory");
+#endif
+}
+
+static unsigned vlc_mutex_spin_limit(void)
+{
+    static atomic_uint limit = ATOMIC_VAR_INIT(UINT_MAX);
+    unsigned spin = atomic_load_explicit(&limit, memory_order_relaxed);
+
+    if (unlikely(spin == UINT_MAX))
+    {
+        spin = (vlc_GetCPUCount() > 1) ? VLC_MUTEX_SPIN : 0;
+        atomic_store_explicit(&limit, spin, memory_order_relaxed);
+    }
+    return spin;
+}
+
 void vlc_mutex_lock(vlc_mutex_t *mtx)
 {
     unsigned value;
@@ -170,10 +368,43 @@ void vlc_mutex_lock(vlc_mutex_t *mtx)
 
     int canc = vlc_savecancel(); /* locking is never a cancellation point */
 
-    while ((value = atomic_exchange_explicit(&mtx->value, 2,
-                                             memory_order_acquire)) != 0)
-        vlc_atomic_wait(&mtx->value, 2);
+    /* Adaptive spin: short critical sections (FIFOs, picture pools...) are
+     * usually released within a few dozen cycles, much less than a futex
+     * round trip. Only spin while the lock looks uncontended: once waiters
+     * are queued in the kernel, barging past them is counter-productive. */
+    for (unsigned spin = vlc_mutex_spin_limit(); spin > 0; spin--)
+    {
+        value = atomic_load_explicit(&mtx->value, memory_order_relaxed);
+        if (value == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(&mtx->value, &value, 1,
+                                                      memory_order_acquire,
+                                                      memory_order_relaxed))
+                goto locked;
+        }
+        else if (value == 2)
+            break;
+        vlc_mutex_cpu_relax();
+    }
+
+    if (unlikely(vlc_lock_profile_enabled()))
+    {
+#ifdef LIBVLC_PROFILE_LOCKS
+        const void *callsite = __builtin_return_address(0);
+        vlc_tick_t start = vlc_tick_now();
+#endif
+        while ((value = atomic_exchange_explicit(&mtx->value, 2,
+                                                 memory_order_acquire)) != 0)
+            vlc_atomic_wait(&mtx->value, 2);
+
+        vlc_lock_profile_waited(callsite, mtx, start, vlc_tick_now());
+    }
+    else
+        while ((value = atomic_exchange_explicit(&mtx->value, 2,
+                                                 memory_order_acquire)) != 0)
+            vlc_atomic_wait(&mtx->value, 2);
 
+locked:
     vlc_restorecancel(canc);
     atomic_store_explicit(&mtx->owner, THREAD_SELF, memory_order_relaxed);
 }
@@ -222,6 +453,7 @@ void vlc_mutex_unlock(vlc_mutex_t *mtx)
         return;
     }
 
+    vlc_lock_profile_released(mtx);
     atomic_store_explicit(&mtx->owner, NULL, memory_order_relaxed);
 
     switch (atomic_exchange_explicit(&mtx->value, 0, memory_order_release)) {
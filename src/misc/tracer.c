@@ -0,0 +1,99 @@
+/*****************************************************************************
+ * tracer.c: tracing interface
+ *****************************************************************************
+ * Copyright (C) 2021 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdarg.h>
+
+#include <vlc_common.h>
+#include <vlc_modules.h>
+#include <vlc_tracer.h>
+#include "libvlc.h"
+
+struct vlc_tracer
+{
+    const struct vlc_tracer_operations *ops;
+    void *opaque;
+};
+
+struct vlc_tracer_module
+{
+    struct vlc_object_t obj;
+    struct vlc_tracer tracer;
+};
+
+void (vlc_tracer_Trace)(struct vlc_tracer *tracer, ...)
+{
+    assert(tracer->ops->trace != NULL);
+    vlc_tick_t ts = vlc_tick_now();
+
+    va_list entries;
+    va_start(entries, tracer);
+    tracer->ops->trace(tracer->opaque, ts, entries);
+    va_end(entries);
+}
+
+static int vlc_tracer_load(void *func, bool forced, va_list ap)
+{
+    const struct vlc_tracer_operations *(*activate)(vlc_object_t *,
+                                                    void **) = func;
+    struct vlc_tracer_module *module = va_arg(ap, struct vlc_tracer_module *);
+
+    (void) forced;
+    module->tracer.ops = activate(VLC_OBJECT(module),
+                                  &module->tracer.opaque);
+    return (module->tracer.ops != NULL) ? VLC_SUCCESS : VLC_EGENERIC;
+}
+
+struct vlc_tracer *vlc_tracer_Create(vlc_object_t *parent, const char *name)
+{
+    struct vlc_tracer_module *module;
+
+    module = vlc_custom_create(parent, sizeof (*module), "tracer");
+    if (unlikely(module == NULL))
+        return NULL;
+
+    if (vlc_module_load(VLC_OBJECT(module), "tracer", name, false,
+                        vlc_tracer_load, module) == NULL) {
+        vlc_object_delete(VLC_OBJECT(module));
+        return NULL;
+    }
+    return &module->tracer;
+}
+
+void vlc_tracer_Destroy(struct vlc_tracer *tracer)
+{
+    struct vlc_tracer_module *module =
+        container_of(tracer, struct vlc_tracer_module, tracer);
+
+    if (tracer->ops->destroy != NULL)
+        tracer->ops->destroy(tracer->opaque);
+
+    vlc_object_delete(VLC_OBJECT(module));
+}
+
+struct vlc_tracer *vlc_object_get_tracer(vlc_object_t *obj)
+{
+    libvlc_priv_t *priv = libvlc_priv(vlc_object_instance(obj));
+
+    return priv->tracer;
+}
@@ -535,6 +535,7 @@ static void* update_DownloadReal( void *obj )
 
     FILE *p_file = NULL;
     stream_t *p_stream = NULL;
+    hash_stream_t *p_hs = NULL;
     void* p_buffer = NULL;
     int i_read;
     int canc;
@@ -558,6 +559,48 @@ static void* update_DownloadReal( void *obj )
     if( vlc_stream_GetSize( p_stream, &l_size ) || l_size == 0 )
         goto end;
 
+    /* Fetch and sanity-check the signature first: it selects the digest
+     * algorithm, so the payload can then be hashed while it downloads
+     * instead of being re-read from disk afterwards.  It also fails fast
+     * before transferring megabytes for nothing. */
+    signature_packet_t sign;
+    if( download_signature( VLC_OBJECT( p_udt ), &sign,
+            p_update->release.psz_url ) != VLC_SUCCESS )
+    {
+        dialog_FatalWait( p_udt, _("File could not be verified"),
+            _("It was not possible to download a cryptographic signature for "
+              "the downloaded file \"%s\". Thus, it was deleted."),
+            p_update->release.psz_url );
+        msg_Err( p_udt, "Couldn't download signature of downloaded file" );
+        goto end;
+    }
+
+    if( memcmp( sign.issuer_longid, p_update->p_pkey->longid, 8 ) )
+    {
+        msg_Err( p_udt, "Invalid signature issuer" );
+        dialog_FatalWait( p_udt, _("Invalid signature"),
+            _("The cryptographic signature for the downloaded file \"%s\" was "
+              "invalid and could not be used to securely verify it. Thus, the "
+              "file was deleted."),
+            p_update->release.psz_url );
+        goto end;
+    }
+
+    if( sign.type != BINARY_SIGNATURE )
+    {
+        msg_Err( p_udt, "Invalid signature type" );
+        dialog_FatalWait( p_udt, _("Invalid signature"),
+            _("The cryptographic signature for the downloaded file \"%s\" was "
+              "invalid and could not be used to securely verify it. Thus, the "
+              "file was deleted."),
+            p_update->release.psz_url );
+        goto end;
+    }
+
+    p_hs = hash_stream_Open( &sign );
+    if( !p_hs )
+        goto end;
+
     /* Get the file name and open it*/
     psz_tmpdestfile = strrchr( p_update->release.psz_url, '/' );
     if( !psz_tmpdestfile )
@@ -608,6 +651,7 @@ static void* update_DownloadReal( void *obj )
             msg_Err( p_udt, "Failed to write into %s", psz_destfile );
             break;
         }
+        hash_stream_Write( p_hs, p_buffer, i_read );
 
         l_downloaded += i_read;
         psz_downloaded = size_str( l_downloaded );
@@ -637,45 +681,8 @@ static void* update_DownloadReal( void *obj )
         goto end;
     }
 
-    signature_packet_t sign;
-    if( download_signature( VLC_OBJECT( p_udt ), &sign,
-            p_update->release.psz_url ) != VLC_SUCCESS )
-    {
-        vlc_unlink( psz_destfile );
-
-        dialog_FatalWait( p_udt, _("File could not be verified"),
-            _("It was not possible to download a cryptographic signature for "
-              "the downloaded file \"%s\". Thus, it was deleted."),
-            psz_destfile );
-        msg_Err( p_udt, "Couldn't download signature of downloaded file" );
-        goto end;
-    }
-
-    if( memcmp( sign.issuer_longid, p_update->p_pkey->longid, 8 ) )
-    {
-        vlc_unlink( psz_destfile );
-        msg_Err( p_udt, "Invalid signature issuer" );
-        dialog_FatalWait( p_udt, _("Invalid signature"),
-            _("The cryptographic signature for the downloaded file \"%s\" was "
-              "invalid and could not be used to securely verify it. Thus, the "
-              "file was deleted."),
-            psz_destfile );
-        goto end;
-    }
-
-    if( sign.type != BINARY_SIGNATURE )
-    {
-        vlc_unlink( psz_destfile );
-        msg_Err( p_udt, "Invalid signature type" );
-        dialog_FatalWait( p_udt, _("Invalid signature"),
-            _("The cryptographic signature for the downloaded file \"%s\" was "
-              "invalid and could not be used to securely verify it. Thus, the "
-              "file was deleted."),
-            psz_destfile );
-        goto end;
-    }
-
-    uint8_t *p_hash = hash_from_file( psz_destfile, &sign );
+    uint8_t *p_hash = hash_stream_Finish( p_hs, &sign );
+    p_hs = NULL;
     if( !p_hash )
     {
         msg_Err( p_udt, "Unable to hash %s", psz_destfile );
@@ -741,6 +748,8 @@ end:
         vlc_stream_Delete( p_stream );
     if( p_file )
         fclose( p_file );
+    if( p_hs )
+        hash_stream_Abort( p_hs );
     free( psz_destdir );
     free( psz_destfile );
     free( p_buffer );
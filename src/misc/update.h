@@ -213,6 +213,26 @@ uint8_t *
 hash_from_file(
         const char *psz_file, signature_packet_t *p_sig );
 
+/*
+ * incremental flavour of hash_from_file(): hash the data while it is being
+ * downloaded (or demuxed) instead of re-reading the file afterwards.
+ * The signature must be known up front since it selects the digest.
+ */
+typedef struct hash_stream_t hash_stream_t;
+
+hash_stream_t *
+hash_stream_Open( signature_packet_t *p_sig );
+
+void
+hash_stream_Write( hash_stream_t *, const void *, size_t );
+
+/* consumes the stream, returns the final hash as hash_from_file() would */
+uint8_t *
+hash_stream_Finish( hash_stream_t *, signature_packet_t *p_sig );
+
+void
+hash_stream_Abort( hash_stream_t * );
+
 /*
  * return a hash of a public key
  */
@@ -839,6 +839,50 @@ uint8_t *hash_from_file( const char *psz_file, signature_packet_t *p_sig )
 }
 
 
+/*
+ * Incremental file hashing, so a download can be hashed as it streams in
+ * instead of being re-read from disk once complete
+ */
+struct hash_stream_t
+{
+    gcry_md_hd_t hd;
+};
+
+hash_stream_t *hash_stream_Open( signature_packet_t *p_sig )
+{
+    hash_stream_t *p_hs = malloc( sizeof (*p_hs) );
+    if( !p_hs )
+        return NULL;
+
+    if( gcry_md_open( &p_hs->hd, p_sig->digest_algo, 0 ) )
+    {
+        free( p_hs );
+        return NULL;
+    }
+
+    return p_hs;
+}
+
+void hash_stream_Write( hash_stream_t *p_hs, const void *p_data,
+                        size_t i_data )
+{
+    gcry_md_write( p_hs->hd, p_data, i_data );
+}
+
+uint8_t *hash_stream_Finish( hash_stream_t *p_hs, signature_packet_t *p_sig )
+{
+    gcry_md_hd_t hd = p_hs->hd;
+    free( p_hs );
+    return hash_finish( hd, p_sig ); /* closes hd */
+}
+
+void hash_stream_Abort( hash_stream_t *p_hs )
+{
+    gcry_md_close( p_hs->hd );
+    free( p_hs );
+}
+
+
 /*
  * Generate a hash on a public key, to verify a signature made on that hash
  * Note that we need the signature (v4) to compute the hash
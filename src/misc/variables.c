@@ -27,9 +27,6 @@
 # include "config.h"
 #endif
 
-#ifdef HAVE_SEARCH_H
-# include <search.h>
-#endif
 #include <assert.h>
 #include <float.h>
 #include <math.h>
@@ -67,7 +64,8 @@ typedef struct variable_ops_t
  */
 struct variable_t
 {
-    char *       psz_name; /**< The variable unique name (must be first) */
+    char *       psz_name; /**< The variable unique name */
+    uint32_t     i_hash;   /**< Hash of psz_name, see VarHash() */
 
     /** The variable's exported value */
     vlc_value_t  val;
@@ -136,22 +134,121 @@ int_ops    = { CmpInt,     DupDummy,  FreeDummy,  },
 string_ops = { CmpString,  DupString, FreeString, },
 coords_ops = { NULL,       DupDummy,  FreeDummy,  };
 
-static int varcmp( const void *a, const void *b )
+/**
+ * Per-object table of variables.
+ *
+ * Variables are kept in an open addressing hash table with linear probing,
+ * protected by the object variable lock. The name hash of each variable is
+ * computed once at creation time, so that probing mostly compares integers
+ * instead of walking a tree of string comparisons.
+ */
+typedef struct vlc_var_table
+{
+    variable_t **pp_slots; /**< Power-of-two sized bucket array */
+    size_t       i_size;   /**< Number of allocated buckets */
+    size_t       i_count;  /**< Number of live variables */
+} vlc_var_table_t;
+
+#define VAR_TABLE_MIN_SIZE 16
+
+/** 32-bits Fowler/Noll/Vo FNV-1a hash of a variable name */
+static uint32_t VarHash( const char *psz_name )
+{
+    uint32_t i_hash = UINT32_C(2166136261);
+
+    while( *psz_name != '\0' )
+    {
+        i_hash ^= (unsigned char)*(psz_name++);
+        i_hash *= UINT32_C(16777619);
+    }
+    return i_hash;
+}
+
+/** Finds the bucket of a variable (or NULL if the name is absent) */
+static variable_t **VarTableFind( vlc_var_table_t *p_table,
+                                  const char *psz_name, uint32_t i_hash )
+{
+    size_t i_mask = p_table->i_size - 1;
+
+    for( size_t i = i_hash & i_mask; p_table->pp_slots[i] != NULL;
+         i = (i + 1) & i_mask )
+    {
+        variable_t *p_var = p_table->pp_slots[i];
+
+        if( p_var->i_hash == i_hash && !strcmp( p_var->psz_name, psz_name ) )
+            return &p_table->pp_slots[i];
+    }
+    return NULL;
+}
+
+/** Inserts a variable. There must be a free bucket and no duplicate. */
+static void VarTableInsert( vlc_var_table_t *p_table, variable_t *p_var )
+{
+    size_t i_mask = p_table->i_size - 1;
+    size_t i = p_var->i_hash & i_mask;
+
+    while( p_table->pp_slots[i] != NULL )
+        i = (i + 1) & i_mask;
+    p_table->pp_slots[i] = p_var;
+    p_table->i_count++;
+}
+
+/** Doubles the bucket count of a table */
+static int VarTableGrow( vlc_var_table_t *p_table )
 {
-    const variable_t *va = a, *vb = b;
+    variable_t **pp_old = p_table->pp_slots;
+    size_t i_oldsize = p_table->i_size;
+    variable_t **pp_slots = calloc( i_oldsize * 2, sizeof( *pp_slots ) );
 
-    /* psz_name must be first */
-    assert( va == (const void *)&va->psz_name );
-    return strcmp( va->psz_name, vb->psz_name );
+    if( unlikely(pp_slots == NULL) )
+        return VLC_ENOMEM;
+
+    p_table->pp_slots = pp_slots;
+    p_table->i_size = i_oldsize * 2;
+    p_table->i_count = 0;
+
+    for( size_t i = 0; i < i_oldsize; i++ )
+        if( pp_old[i] != NULL )
+            VarTableInsert( p_table, pp_old[i] );
+    free( pp_old );
+    return VLC_SUCCESS;
+}
+
+/** Removes a variable from its bucket (without destroying it) */
+static void VarTableRemove( vlc_var_table_t *p_table, variable_t **pp_slot )
+{
+    size_t i_mask = p_table->i_size - 1;
+    size_t j = pp_slot - p_table->pp_slots;
+
+    p_table->pp_slots[j] = NULL;
+    p_table->i_count--;
+
+    /* Shift back any following entry that the freed bucket would otherwise
+     * disconnect from its home bucket (no tombstones with linear probing) */
+    for( size_t i = (j + 1) & i_mask; p_table->pp_slots[i] != NULL;
+         i = (i + 1) & i_mask )
+    {
+        size_t home = p_table->pp_slots[i]->i_hash & i_mask;
+
+        /* The entry may stay if its home lies in the cyclic range ]j, i] */
+        if( (i >= j) ? (home > j && home <= i) : (home > j || home <= i) )
+            continue;
+
+        p_table->pp_slots[j] = p_table->pp_slots[i];
+        p_table->pp_slots[i] = NULL;
+        j = i;
+    }
 }
 
 static variable_t *Lookup( vlc_object_t *obj, const char *psz_name )
 {
     vlc_object_internals_t *priv = vlc_internals( obj );
-    void **pp_var;
+    variable_t **pp_var;
 
     vlc_mutex_lock(&priv->var_lock);
-    pp_var = tfind( &psz_name, &priv->var_root, varcmp );
+    if (priv->var_table == NULL)
+        return NULL;
+    pp_var = VarTableFind(priv->var_table, psz_name, VarHash(psz_name));
     return (pp_var != NULL) ? *pp_var : NULL;
 }
 
@@ -295,6 +392,7 @@ int (var_Create)( vlc_object_t *p_this, const char *psz_name, int i_type )
         return VLC_ENOMEM;
 
     p_var->psz_name = strdup( psz_name );
+    p_var->i_hash = VarHash( psz_name );
     p_var->psz_text = NULL;
 
     p_var->i_type = i_type & ~VLC_VAR_DOINHERIT;
@@ -352,23 +450,56 @@ int (var_Create)( vlc_object_t *p_this, const char *psz_name, int i_type )
         var_Inherit(p_this, psz_name, i_type, &p_var->val);
 
     vlc_object_internals_t *p_priv = vlc_internals( p_this );
-    void **pp_var;
-    variable_t *p_oldvar;
+    vlc_var_table_t *p_table;
+    variable_t **pp_var;
     int ret = VLC_SUCCESS;
 
     vlc_mutex_lock( &p_priv->var_lock );
 
-    pp_var = tsearch( p_var, &p_priv->var_root, varcmp );
-    if( unlikely(pp_var == NULL) )
-        ret = VLC_ENOMEM;
-    else if( (p_oldvar = *pp_var) == p_var ) /* Variable create */
-        p_var = NULL; /* Variable created */
-    else /* Variable already exists */
+    p_table = p_priv->var_table;
+    if( p_table == NULL ) /* First variable of the object */
     {
+        p_table = malloc( sizeof( *p_table ) );
+        if( likely(p_table != NULL) )
+        {
+            p_table->pp_slots = calloc( VAR_TABLE_MIN_SIZE,
+                                        sizeof( *p_table->pp_slots ) );
+            if( unlikely(p_table->pp_slots == NULL) )
+            {
+                free( p_table );
+                p_table = NULL;
+            }
+            else
+            {
+                p_table->i_size = VAR_TABLE_MIN_SIZE;
+                p_table->i_count = 0;
+                p_priv->var_table = p_table;
+            }
+        }
+    }
+
+    if( unlikely(p_table == NULL) )
+        ret = VLC_ENOMEM;
+    else if( (pp_var = VarTableFind( p_table, psz_name,
+                                     p_var->i_hash )) != NULL )
+    {   /* Variable already exists */
+        variable_t *p_oldvar = *pp_var;
+
         assert (((i_type ^ p_oldvar->i_type) & VLC_VAR_CLASS) == 0);
         p_oldvar->i_usage++;
         p_oldvar->i_type |= i_type & VLC_VAR_ISCOMMAND;
     }
+    else
+    {   /* Keep the load factor below 3/4 so that probe sequences are short */
+        if( p_table->i_count * 4 >= p_table->i_size * 3
+         && VarTableGrow( p_table ) )
+            ret = VLC_ENOMEM;
+        else
+        {
+            VarTableInsert( p_table, p_var );
+            p_var = NULL; /* Variable created */
+        }
+    }
     vlc_mutex_unlock( &p_priv->var_lock );
 
     /* If we did not need to create a new variable, free everything... */
@@ -379,43 +510,47 @@ int (var_Create)( vlc_object_t *p_this, const char *psz_name, int i_type )
 
 void (var_Destroy)(vlc_object_t *p_this, const char *psz_name)
 {
-    variable_t *p_var;
+    variable_t *p_var = NULL;
+    variable_t **pp_var;
 
     assert( p_this );
 
     vlc_object_internals_t *p_priv = vlc_internals( p_this );
 
-    p_var = Lookup( p_this, psz_name );
-    if( p_var == NULL )
+    vlc_mutex_lock( &p_priv->var_lock );
+    pp_var = (p_priv->var_table != NULL)
+        ? VarTableFind( p_priv->var_table, psz_name, VarHash( psz_name ) )
+        : NULL;
+    if( pp_var == NULL )
         msg_Dbg( p_this, "attempt to destroy nonexistent variable \"%s\"",
                  psz_name );
-    else if( --p_var->i_usage == 0 )
+    else if( --(*pp_var)->i_usage == 0 )
     {
+        p_var = *pp_var;
         assert(!p_var->b_incallback);
-        tdelete( p_var, &p_priv->var_root, varcmp );
+        VarTableRemove( p_priv->var_table, pp_var );
     }
     else
-    {
-        assert(p_var->i_usage != -1u);
-        p_var = NULL;
-    }
+        assert((*pp_var)->i_usage != -1u);
     vlc_mutex_unlock( &p_priv->var_lock );
 
     if( p_var != NULL )
         Destroy( p_var );
 }
 
-static void CleanupVar( void *var )
-{
-    Destroy( var );
-}
-
 void var_DestroyAll( vlc_object_t *obj )
 {
     vlc_object_internals_t *priv = vlc_internals( obj );
+    vlc_var_table_t *table = priv->var_table;
 
-    tdestroy( priv->var_root, CleanupVar );
-    priv->var_root = NULL;
+    if (table == NULL)
+        return;
+    for (size_t i = 0; i < table->i_size; i++)
+        if (table->pp_slots[i] != NULL)
+            Destroy(table->pp_slots[i]);
+    free(table->pp_slots);
+    free(table);
+    priv->var_table = NULL;
 }
 
 int (var_Change)(vlc_object_t *p_this, const char *psz_name, int i_action, ...)
@@ -1135,21 +1270,6 @@ error:
     return VLC_EGENERIC;
 }
 
-static thread_local void *twalk_ctx;
-
-static void TwalkGetNames(const void *data, const VISIT which, const int depth)
-{
-    if (which != postorder && which != leaf)
-        return;
-    (void) depth;
-
-    const variable_t *var = *(const variable_t **)data;
-    DECL_ARRAY(char *) *names = twalk_ctx;
-    char *dup = strdup(var->psz_name);
-    if (dup != NULL)
-        ARRAY_APPEND(*names, dup);
-}
-
 char **var_GetAllNames(vlc_object_t *obj)
 {
     vlc_object_internals_t *priv = vlc_internals(obj);
@@ -1157,9 +1277,19 @@ char **var_GetAllNames(vlc_object_t *obj)
     DECL_ARRAY(char *) names;
     ARRAY_INIT(names);
 
-    twalk_ctx = &names;
     vlc_mutex_lock(&priv->var_lock);
-    twalk(priv->var_root, TwalkGetNames);
+    if (priv->var_table != NULL)
+        for (size_t i = 0; i < priv->var_table->i_size; i++)
+        {
+            const variable_t *var = priv->var_table->pp_slots[i];
+
+            if (var == NULL)
+                continue;
+
+            char *dup = strdup(var->psz_name);
+            if (dup != NULL)
+                ARRAY_APPEND(names, dup);
+        }
     vlc_mutex_unlock(&priv->var_lock);
 
     if (names.i_size == 0)
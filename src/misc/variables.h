@@ -26,6 +26,7 @@
 # include <vlc_list.h>
 
 struct vlc_res;
+struct vlc_var_table;
 
 /**
  * Private LibVLC data for each object.
@@ -38,7 +39,7 @@ struct vlc_object_internals
     const char *typename; /**< Object type human-readable name */
 
     /* Object variables */
-    void           *var_root;
+    struct vlc_var_table *var_table;
     vlc_mutex_t     var_lock;
     vlc_cond_t      var_wait;
 
@@ -322,6 +322,15 @@ static int AllocatePluginFile (module_bank_t *bank, const char *abspath,
             vlc_plugin_destroy(plugin);
             plugin = NULL;
         }
+
+        /* Decode the cached module descriptors, now that the entry is known
+         * to match the plug-in on disk */
+        if (plugin != NULL && vlc_cache_decode(plugin))
+        {
+            msg_Err(bank->obj, "corrupted plugins cache: %s", plugin->abspath);
+            vlc_plugin_destroy(plugin);
+            plugin = NULL;
+        }
     }
 
     if (plugin == NULL)
@@ -468,7 +477,7 @@ static void AllocatePluginPath(vlc_object_t *obj, const char *path,
         vlc_plugin_t *plugin = bank.cache;
 
         bank.cache = plugin->next;
-        if (mode & CACHE_SCAN_DIR)
+        if ((mode & CACHE_SCAN_DIR) || vlc_cache_decode(plugin))
             vlc_plugin_destroy(plugin);
         else
             vlc_plugin_store(plugin);
@@ -788,14 +797,16 @@ module_t **module_list_get (size_t *n)
 }
 
 /**
- * Builds a sorted list of all VLC modules with a given capability.
+ * Looks up the sorted list of all VLC modules with a given capability.
  * The list is sorted from the highest module score to the lowest.
  * @param list pointer to the table of modules [OUT]
  * @param name name of capability of modules to look for
  * @return the number of matching found, or -1 on error (*list is then NULL).
- * @note *list must be freed with module_list_free().
+ * @note *list is owned by the module bank; it must neither be modified nor
+ * freed by the caller. This keeps the lookup allocation-free on the module
+ * probing fast path.
  */
-ssize_t module_list_cap (module_t ***restrict list, const char *name)
+ssize_t module_list_cap (module_t *const **restrict list, const char *name)
 {
     const void **cp = tfind(&name, &modules.caps_tree, vlc_modcap_cmp);
     if (cp == NULL)
@@ -805,12 +816,7 @@ ssize_t module_list_cap (module_t ***restrict list, const char *name)
     }
 
     const vlc_modcap_t *cap = *cp;
-    size_t n = cap->modc;
-    module_t **tab = vlc_alloc (n, sizeof (*tab));
-    *list = tab;
-    if (unlikely(tab == NULL))
-        return -1;
 
-    memcpy(tab, cap->modv, sizeof (*tab) * n);
-    return n;
+    *list = cap->modv;
+    return cap->modc;
 }
@@ -56,7 +56,7 @@
 #ifdef HAVE_DYNAMIC_PLUGINS
 /* Sub-version number
  * (only used to avoid breakage in dev version when cache structure changes) */
-#define CACHE_SUBVERSION_NUM 36
+#define CACHE_SUBVERSION_NUM 37
 
 /* Cache filename */
 #define CACHE_NAME "plugins.dat"
@@ -318,18 +318,10 @@ static vlc_plugin_t *vlc_cache_load_plugin(block_t *file)
     if (unlikely(plugin == NULL))
         return NULL;
 
-    uint32_t modules;
-    LOAD_IMMEDIATE(modules);
-
-    for (size_t i = 0; i < modules; i++)
-        if (vlc_cache_load_module(plugin, file))
-            goto error;
-
-    if (vlc_cache_load_plugin_config(plugin, file))
-        goto error;
-
-    LOAD_STRING(plugin->textdomain);
-
+    /* Each entry starts with its validation key and the byte length of the
+     * descriptors, so that loading the cache only indexes the entries. The
+     * descriptors of a plug-in are decoded on demand by vlc_cache_decode(),
+     * and the pages backing stale or removed plug-ins are never touched. */
     const char *path;
     LOAD_STRING(path);
     if (path == NULL)
@@ -343,8 +335,15 @@ static vlc_plugin_t *vlc_cache_load_plugin(block_t *file)
     LOAD_IMMEDIATE(plugin->mtime);
     LOAD_IMMEDIATE(plugin->size);
 
-    if (plugin->textdomain != NULL)
-        vlc_bindtextdomain(plugin->textdomain);
+    uint32_t payload;
+    LOAD_IMMEDIATE(payload);
+    if (file->i_buffer < payload)
+        goto error;
+
+    plugin->cache_payload = file->p_buffer;
+    plugin->cache_payload_size = payload;
+    file->p_buffer += payload;
+    file->i_buffer -= payload;
 
     return plugin;
 
@@ -353,6 +352,48 @@ error:
     return NULL;
 }
 
+/**
+ * Decodes the cached module descriptors of a plug-in.
+ *
+ * vlc_cache_load() only indexes the cache entries. This function performs the
+ * deferred decoding of the module and configuration descriptors of one entry,
+ * once the plug-in is known to (still) exist with matching file metadata.
+ */
+int vlc_cache_decode(vlc_plugin_t *plugin)
+{
+    if (plugin->cache_payload == NULL)
+        return 0; /* already decoded (or not loaded from the cache) */
+
+    block_t payload;
+
+    memset(&payload, 0, sizeof (payload));
+    payload.p_buffer = (uint8_t *)plugin->cache_payload;
+    payload.i_buffer = plugin->cache_payload_size;
+    plugin->cache_payload = NULL;
+    plugin->cache_payload_size = 0;
+
+    block_t *file = &payload;
+    uint32_t modules;
+    LOAD_IMMEDIATE(modules);
+
+    for (size_t i = 0; i < modules; i++)
+        if (vlc_cache_load_module(plugin, file))
+            goto error;
+
+    if (vlc_cache_load_plugin_config(plugin, file))
+        goto error;
+
+    LOAD_STRING(plugin->textdomain);
+
+    if (plugin->textdomain != NULL)
+        vlc_bindtextdomain(plugin->textdomain);
+
+    return 0;
+
+error:
+    return -1;
+}
+
 /**
  * Loads a plugins cache file.
  *
@@ -611,6 +652,19 @@ static int CacheSaveBank(FILE *file, vlc_plugin_t *const *cache, size_t n)
         const vlc_plugin_t *plugin = cache[i];
         uint32_t count = plugin->modules_count;
 
+        /* Validation key first, then the length of the descriptors, so that
+         * loading the cache can index the entries without decoding them */
+        SAVE_STRING(plugin->path);
+        SAVE_FLAG(plugin->unloadable);
+        SAVE_IMMEDIATE(plugin->mtime);
+        SAVE_IMMEDIATE(plugin->size);
+
+        uint32_t payload = 0;
+        long lenpos = ftell(file);
+        if (lenpos == -1)
+            goto error;
+        SAVE_IMMEDIATE(payload);
+
         SAVE_IMMEDIATE(count);
 
         for (module_t *module = plugin->module;
@@ -623,12 +677,17 @@ static int CacheSaveBank(FILE *file, vlc_plugin_t *const *cache, size_t n)
         if (CacheSaveModuleConfig(file, plugin))
             goto error;
 
-        /* Save common info */
         SAVE_STRING(plugin->textdomain);
-        SAVE_STRING(plugin->path);
-        SAVE_FLAG(plugin->unloadable);
-        SAVE_IMMEDIATE(plugin->mtime);
-        SAVE_IMMEDIATE(plugin->size);
+
+        /* Back-patch the descriptors length */
+        long endpos = ftell(file);
+        if (endpos == -1)
+            goto error;
+        payload = endpos - (lenpos + sizeof (payload));
+        if (fseek(file, lenpos, SEEK_SET)
+         || fwrite(&payload, sizeof (payload), 1, file) != 1
+         || fseek(file, endpos, SEEK_SET))
+            goto error;
     }
 
     if (fflush (file)) /* flush libc buffers */
@@ -109,6 +109,8 @@ vlc_plugin_t *vlc_plugin_create(void)
     atomic_init(&plugin->handle, 0);
     plugin->abspath = NULL;
     plugin->path = NULL;
+    plugin->cache_payload = NULL;
+    plugin->cache_payload_size = 0;
 #endif
     plugin->module = NULL;
 
@@ -153,22 +153,23 @@ module_t *(vlc_module_load)(struct vlc_logger *log, const char *capability,
     if (name == NULL || name[0] == '\0')
         name = "any";
 
-    /* Find matching modules */
-    module_t **mods;
+    /* Find matching modules (the table is owned by the module bank) */
+    module_t *const *mods;
     ssize_t total = module_list_cap (&mods, capability);
 
     vlc_debug(log, "looking for %s module matching \"%s\": %zd candidates",
               capability, name, total);
     if (total <= 0)
     {
-        module_list_free (mods);
         vlc_debug(log, "no %s modules", capability);
         return NULL;
     }
 
     module_t *module = NULL;
+    bool tried[total]; /* at most a few hundred candidates */
     va_list args;
 
+    memset (tried, 0, sizeof (tried));
     va_start(args, probe);
     while (*name)
     {
@@ -185,11 +186,11 @@ module_t *(vlc_module_load)(struct vlc_logger *log, const char *capability,
         for (ssize_t i = 0; i < total; i++)
         {
             module_t *cand = mods[i];
-            if (cand == NULL)
+            if (tried[i])
                 continue; // module failed in previous iteration
             if (!module_match_name(cand, shortcut, slen))
                 continue;
-            mods[i] = NULL; // only try each module once at most...
+            tried[i] = true; // only try each module once at most...
 
             int ret = module_load(log, cand, probe, force, args);
             switch (ret)
@@ -209,7 +210,7 @@ module_t *(vlc_module_load)(struct vlc_logger *log, const char *capability,
         for (ssize_t i = 0; i < total; i++)
         {
             module_t *cand = mods[i];
-            if (cand == NULL || module_get_score (cand) <= 0)
+            if (tried[i] || module_get_score (cand) <= 0)
                 continue;
 
             int ret = module_load(log, cand, probe, false, args);
@@ -225,7 +226,6 @@ module_t *(vlc_module_load)(struct vlc_logger *log, const char *capability,
     }
 done:
     va_end (args);
-    module_list_free (mods);
 
     if (module != NULL)
         vlc_debug(log, "using %s module \"%s\"", capability,
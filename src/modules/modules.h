@@ -53,6 +53,10 @@ typedef struct vlc_plugin_t
     char *path; /**< Relative path (within plug-in directory) */
     int64_t mtime; /**< Last modification time */
     uint64_t size; /**< File size */
+
+    /** Not-yet-decoded cached descriptors (or NULL), see vlc_cache_decode() */
+    const void *cache_payload;
+    size_t cache_payload_size; /**< Byte length of cache_payload */
 #endif
 } vlc_plugin_t;
 
@@ -113,7 +117,7 @@ void module_EndBank (bool);
 int module_Map(struct vlc_logger *, vlc_plugin_t *);
 void *module_Symbol(struct vlc_logger *, vlc_plugin_t *, const char *name);
 
-ssize_t module_list_cap (module_t ***, const char *);
+ssize_t module_list_cap (module_t *const **, const char *);
 
 int vlc_bindtextdomain (const char *);
 
@@ -164,6 +168,7 @@ char *vlc_dlerror(void) VLC_USED;
 /* Plugins cache */
 vlc_plugin_t *vlc_cache_load(vlc_object_t *, const char *, block_t **);
 vlc_plugin_t *vlc_cache_lookup(vlc_plugin_t **, const char *relpath);
+int vlc_cache_decode(vlc_plugin_t *);
 
 void CacheSave(vlc_object_t *, const char *, vlc_plugin_t *const *, size_t);
 
@@ -36,6 +36,8 @@
 #include <sys/types.h>
 #include <vlc_network.h>
 
+#include "libvlc.h"
+
 int vlc_getnameinfo( const struct sockaddr *sa, int salen,
                      char *host, int hostlen, int *portnum, int flags )
 {
@@ -122,10 +124,199 @@ int vlc_getaddrinfo (const char *node, unsigned port,
 #if defined (_WIN32) || defined (__OS2__) \
  || defined (__ANDROID__) || defined (__APPLE__) \
  || defined (__native_client__)
-#warning vlc_getaddrinfo_i11e() not implemented!
+#warning vlc_getaddrinfo_resolve() not interruptible!
+int vlc_getaddrinfo_resolve(const char *node, unsigned port,
+                            const struct addrinfo *hints,
+                            struct addrinfo **res)
+{
+    return vlc_getaddrinfo(node, port, hints, res);
+}
+#endif
+
+#ifdef __GLIBC__
+/*
+ * Small positive/negative resolution cache in front of the resolver
+ * back-end, so that reconnecting to a recently used host (adaptive
+ * streaming, channel change) does not stall on a slow resolver.
+ *
+ * The C library does not expose the DNS record time-to-live, so entries
+ * expire after a fixed conservative delay instead.
+ *
+ * The returned address lists are laid out exactly like the C library ones
+ * (one allocation per entry holding the socket address, the canonical name
+ * allocated separately) so that callers can keep freeing them with
+ * freeaddrinfo(). This matches glibc only, hence the guard above.
+ */
+#define DNS_CACHE_SIZE          32
+#define DNS_CACHE_TTL           VLC_TICK_FROM_SEC(60)
+#define DNS_CACHE_NEGATIVE_TTL  VLC_TICK_FROM_SEC(5)
+
+struct dns_cache_entry
+{
+    char *node;
+    unsigned port;
+    int family;
+    int socktype;
+    int protocol;
+    int flags;
+    int error;
+    struct addrinfo *list;
+    vlc_tick_t expiry;
+};
+
+static vlc_mutex_t dns_cache_lock = VLC_STATIC_MUTEX;
+static struct dns_cache_entry dns_cache[DNS_CACHE_SIZE];
+
+static void vlc_freeaddrinfo_copy(struct addrinfo *ai)
+{
+    while (ai != NULL)
+    {
+        struct addrinfo *next = ai->ai_next;
+
+        free(ai->ai_canonname);
+        free(ai);
+        ai = next;
+    }
+}
+
+static struct addrinfo *vlc_copyaddrinfo(const struct addrinfo *ai)
+{
+    struct addrinfo *head = NULL, **pp = &head;
+
+    for (; ai != NULL; ai = ai->ai_next)
+    {
+        struct addrinfo *copy = malloc(sizeof (*copy) + ai->ai_addrlen);
+        if (unlikely(copy == NULL))
+            goto error;
+
+        *copy = *ai;
+        copy->ai_addr = (struct sockaddr *)(copy + 1);
+        memcpy(copy->ai_addr, ai->ai_addr, ai->ai_addrlen);
+        copy->ai_canonname = NULL;
+        copy->ai_next = NULL;
+
+        if (ai->ai_canonname != NULL)
+        {
+            copy->ai_canonname = strdup(ai->ai_canonname);
+            if (unlikely(copy->ai_canonname == NULL))
+            {
+                free(copy);
+                goto error;
+            }
+        }
+
+        *pp = copy;
+        pp = &copy->ai_next;
+    }
+    return head;
+
+error:
+    vlc_freeaddrinfo_copy(head);
+    return NULL;
+}
+
+static struct dns_cache_entry *vlc_dns_cache_find(const char *node,
+                                                  unsigned port,
+                                                  const struct addrinfo *hints)
+{
+    for (size_t i = 0; i < DNS_CACHE_SIZE; i++)
+    {
+        struct dns_cache_entry *entry = dns_cache + i;
+
+        if (entry->node != NULL && entry->port == port
+         && entry->family == hints->ai_family
+         && entry->socktype == hints->ai_socktype
+         && entry->protocol == hints->ai_protocol
+         && entry->flags == hints->ai_flags
+         && !strcasecmp(entry->node, node))
+            return entry;
+    }
+    return NULL;
+}
+
 int vlc_getaddrinfo_i11e(const char *node, unsigned port,
                          const struct addrinfo *hints, struct addrinfo **res)
 {
-    return vlc_getaddrinfo(node, port, hints, res);
+    static const struct addrinfo nohints = { .ai_family = AF_UNSPEC };
+
+    if (hints == NULL)
+        hints = &nohints;
+
+    /* Numeric look-ups never hit the wire; do not waste cache slots. */
+    if (node == NULL || (hints->ai_flags & AI_NUMERICHOST))
+        return vlc_getaddrinfo_resolve(node, port, hints, res);
+
+    vlc_mutex_lock(&dns_cache_lock);
+    struct dns_cache_entry *entry = vlc_dns_cache_find(node, port, hints);
+    if (entry != NULL && vlc_tick_now() < entry->expiry)
+    {
+        int error = entry->error;
+        struct addrinfo *list =
+            (error == 0) ? vlc_copyaddrinfo(entry->list) : NULL;
+        vlc_mutex_unlock(&dns_cache_lock);
+
+        if (error != 0)
+            return error;
+        if (likely(list != NULL))
+        {
+            *res = list;
+            return 0;
+        }
+        /* Out of memory while copying: resolve anew. */
+    }
+    else
+        vlc_mutex_unlock(&dns_cache_lock);
+
+    int error = vlc_getaddrinfo_resolve(node, port, hints, res);
+    /* Only name look-up failures are worth remembering; transient resolver
+     * errors (EAI_AGAIN, EAI_SYSTEM...) must be retried right away. */
+    if (error != 0 && error != EAI_NONAME)
+        return error;
+
+    struct addrinfo *list = (error == 0) ? vlc_copyaddrinfo(*res) : NULL;
+    if (error == 0 && unlikely(list == NULL))
+        return error; /* out of memory: skip caching */
+
+    vlc_mutex_lock(&dns_cache_lock);
+    entry = vlc_dns_cache_find(node, port, hints);
+    if (entry == NULL)
+    {
+        /* Evict the entry closest to expiry */
+        entry = dns_cache;
+        for (size_t i = 1; i < DNS_CACHE_SIZE; i++)
+            if (dns_cache[i].node == NULL
+             || (entry->node != NULL && dns_cache[i].expiry < entry->expiry))
+                entry = dns_cache + i;
+
+        free(entry->node);
+        entry->node = strdup(node);
+    }
+
+    vlc_freeaddrinfo_copy(entry->list);
+    if (likely(entry->node != NULL))
+    {
+        entry->port = port;
+        entry->family = hints->ai_family;
+        entry->socktype = hints->ai_socktype;
+        entry->protocol = hints->ai_protocol;
+        entry->flags = hints->ai_flags;
+        entry->error = error;
+        entry->list = list;
+        entry->expiry = vlc_tick_now()
+            + ((error == 0) ? DNS_CACHE_TTL : DNS_CACHE_NEGATIVE_TTL);
+    }
+    else
+    {
+        entry->list = NULL;
+        vlc_freeaddrinfo_copy(list);
+    }
+    vlc_mutex_unlock(&dns_cache_lock);
+    return error;
+}
+#else
+int vlc_getaddrinfo_i11e(const char *node, unsigned port,
+                         const struct addrinfo *hints, struct addrinfo **res)
+{
+    return vlc_getaddrinfo_resolve(node, port, hints, res);
 }
 #endif
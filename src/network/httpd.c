@@ -65,7 +65,9 @@
 /* We need HUGE buffer otherwise TCP throughput is very limited */
 #define HTTPD_CL_BUFSIZE 1000000
 #else
-#define HTTPD_CL_BUFSIZE 10000
+/* Large chunks keep the system call and wake-up count per client low when
+ * many clients stream concurrently */
+#define HTTPD_CL_BUFSIZE 65536
 #endif
 
 static void httpd_ClientDestroy(httpd_client_t *cl);
@@ -97,6 +99,11 @@ struct httpd_host_t
     size_t client_count;
     struct vlc_list clients;
 
+    /* poll() set, kept between loop iterations and grown on demand so that
+     * it is not reallocated for each loop with hundreds of clients */
+    struct pollfd *ufd;
+    size_t ufd_alloc;
+
     /* TLS data */
     vlc_tls_server_t *p_tls;
 };
@@ -969,6 +976,8 @@ static httpd_host_t *httpd_HostCreate(vlc_object_t *p_this,
     vlc_list_init(&host->urls);
     host->client_count = 0;
     vlc_list_init(&host->clients);
+    host->ufd = NULL;
+    host->ufd_alloc = 0;
     host->p_tls    = p_tls;
 
     /* create the thread */
@@ -1024,6 +1033,7 @@ void httpd_HostDelete(httpd_host_t *host)
     assert(vlc_list_is_empty(&host->urls));
     vlc_tls_ServerDelete(host->p_tls);
     net_ListenClose(host->fds);
+    free(host->ufd);
     vlc_object_delete(host);
     vlc_mutex_unlock(&httpd.mutex);
 }
@@ -1202,7 +1212,8 @@ static void httpd_ClientInit(httpd_client_t *cl, vlc_tick_t now)
     cl->i_activity_timeout = VLC_TICK_FROM_SEC(10);
     cl->i_buffer_size = HTTPD_CL_BUFSIZE;
     cl->i_buffer = 0;
-    cl->p_buffer = xmalloc(cl->i_buffer_size);
+    // Allocate an extra byte for the null terminating byte
+    cl->p_buffer = xmalloc(cl->i_buffer_size + 1);
     cl->i_keyframe_wait_to_pass = -1;
     cl->b_stream_mode = false;
 
@@ -1286,6 +1297,7 @@ msg_type[] =
 static void httpd_ClientRecv(httpd_client_t *cl)
 {
     int i_len;
+    int i_pending = 0; /* header bytes received ahead, already in p_buffer */
 
     /* ignore leading whites */
     if (cl->query.i_proto == HTTPD_PROTO_NONE && cl->i_buffer == 0) {
@@ -1342,11 +1354,18 @@ static void httpd_ClientRecv(httpd_client_t *cl)
             cl->i_buffer_size += 1024;
         }
 
-        i_len = httpd_NetRecv (cl, &cl->p_buffer[cl->i_buffer], 1);
-        if (i_len <= 0)
-            break;
+        if (i_pending == 0) {
+            /* Read a whole chunk rather than one byte per call: the
+             * per-byte system calls dominate with hundreds of clients */
+            i_len = httpd_NetRecv (cl, &cl->p_buffer[cl->i_buffer],
+                                    cl->i_buffer_size - cl->i_buffer);
+            if (i_len <= 0)
+                break;
+            i_pending = i_len;
+        }
 
         cl->i_buffer++;
+        i_pending--;
 
         if ((cl->query.i_proto == HTTPD_PROTO_HTTP0)
                 && (cl->p_buffer[cl->i_buffer - 1] == '\n'))
@@ -1408,6 +1427,9 @@ static void httpd_ClientRecv(httpd_client_t *cl)
             char *p;
 
             /* we have finished the header so parse it and set i_body */
+            /* With batched reads, the byte overwritten by the terminating
+             * nul may be the first byte of the body: save it */
+            uint8_t c_next = cl->p_buffer[cl->i_buffer];
             cl->p_buffer[cl->i_buffer] = '\0';
 
             if (cl->query.i_type == HTTPD_MSG_ANSWER) {
@@ -1513,6 +1535,7 @@ static void httpd_ClientRecv(httpd_client_t *cl)
                     }
                 }
             }
+            cl->p_buffer[cl->i_buffer] = c_next;
             if (cl->query.i_body > 0) {
                 /* TODO Mhh, handle the case where the client only
                  * sends a request and closes the connection to
@@ -1521,7 +1544,18 @@ static void httpd_ClientRecv(httpd_client_t *cl)
                     cl->query.p_body = malloc(cl->query.i_body);
                 else
                     cl->query.p_body = NULL;
-                cl->i_buffer = 0;
+                if (cl->query.p_body != NULL && i_pending > 0) {
+                    /* The last chunk went past the header and already
+                     * contains the beginning of the body */
+                    if (i_pending > cl->query.i_body)
+                        i_pending = cl->query.i_body;
+                    memcpy(cl->query.p_body, &cl->p_buffer[cl->i_buffer],
+                            i_pending);
+                    cl->i_buffer = i_pending;
+                    if (cl->i_buffer >= cl->query.i_body)
+                        cl->i_state = HTTPD_CLIENT_RECEIVE_DONE;
+                } else
+                    cl->i_buffer = 0;
                 if (!cl->query.p_body) {
                     switch (cl->query.i_proto) {
                         case HTTPD_PROTO_HTTP: {
@@ -1698,8 +1732,14 @@ auth_failed:
 
 static void httpdLoop(httpd_host_t *host)
 {
-    struct pollfd ufd[host->nfd + host->client_count];
+    size_t ufd_count = host->nfd + host->client_count;
+    struct pollfd *ufd = host->ufd;
     unsigned nfd;
+
+    if (host->ufd_alloc < ufd_count) {
+        ufd = host->ufd = xrealloc(host->ufd, ufd_count * sizeof (*ufd));
+        host->ufd_alloc = ufd_count;
+    }
     for (nfd = 0; nfd < host->nfd; nfd++) {
         ufd[nfd].fd = host->fds[nfd];
         ufd[nfd].events = POLLIN;
@@ -1725,7 +1765,7 @@ static void httpdLoop(httpd_host_t *host)
         }
 
         struct pollfd *pufd = ufd + nfd;
-        assert (pufd < ufd + ARRAY_SIZE (ufd));
+        assert (pufd < ufd + ufd_count);
 
         pufd->events = pufd->revents = 0;
 
@@ -1975,7 +2015,7 @@ static void httpdLoop(httpd_host_t *host)
     vlc_list_foreach(cl, &host->clients, node) {
         const struct pollfd *pufd = &ufd[nfd];
 
-        assert(pufd < &ufd[ARRAY_SIZE(ufd)]);
+        assert(pufd < &ufd[ufd_count]);
 
         if (vlc_tls_GetFD(cl->sock) != pufd->fd)
             continue; // we were not waiting for this client
@@ -112,6 +112,10 @@ int net_Socket (vlc_object_t *p_this, int family, int socktype,
     return fd;
 }
 
+/* Delay before a concurrent connection attempt to the next address is
+ * started while earlier attempts are still pending (RFC 8305 §5). */
+#define NET_CONNECT_STAGGER VLC_TICK_FROM_MS(250)
+
 int (net_Connect)(vlc_object_t *obj, const char *host, int serv,
                   int type, int proto)
 {
@@ -133,57 +137,125 @@ int (net_Connect)(vlc_object_t *obj, const char *host, int serv,
     vlc_tick_t timeout = VLC_TICK_FROM_MS(var_InheritInteger(obj,
                                                              "ipv4-timeout"));
 
+    size_t count = 0;
     for (struct addrinfo *ptr = res; ptr != NULL; ptr = ptr->ai_next)
+        count++;
+
+    /* Interleave the address families ("happy eyeballs", RFC 8305), so a
+     * black-holed path for one family costs one stagger interval rather
+     * than a full connection timeout before the other family is tried. */
+    const struct addrinfo **order = vlc_alloc(count, sizeof (*order));
+    if (unlikely(order == NULL))
     {
-        int fd = net_Socket(obj, ptr->ai_family,
-                            ptr->ai_socktype, ptr->ai_protocol);
-        if (fd == -1)
+        freeaddrinfo(res);
+        return -1;
+    }
+
+    const int primary = res->ai_family;
+    size_t nprim = 0;
+    for (const struct addrinfo *ptr = res; ptr != NULL; ptr = ptr->ai_next)
+        if (ptr->ai_family == primary)
+            nprim++;
+
+    /* primary[0] other[0] primary[1] other[1] ..., leftovers at the end */
+    const size_t m = (nprim < count - nprim) ? nprim : count - nprim;
+    size_t ip = 0, io = 0;
+    for (const struct addrinfo *ptr = res; ptr != NULL; ptr = ptr->ai_next)
+        if (ptr->ai_family == primary)
         {
-            msg_Dbg(obj, "socket error: %s", vlc_strerror_c(net_errno));
-            continue;
+            order[(ip < m) ? (2 * ip) : (m + ip)] = ptr;
+            ip++;
+        }
+        else
+        {
+            order[(io < m) ? (2 * io + 1) : (m + io)] = ptr;
+            io++;
         }
 
-        if (connect(fd, ptr->ai_addr, ptr->ai_addrlen))
+    int fds[count ? count : 1];
+    size_t started = 0, pending = 0;
+    vlc_tick_t last_start = 0;
+    const vlc_tick_t deadline = vlc_tick_now() + timeout;
+
+    while (ret == -1)
+    {
+        vlc_tick_t now = vlc_tick_now();
+
+        /* Start the next attempt if none is pending, or if the pending
+         * ones have not completed within the stagger interval. */
+        while (started < count
+            && (pending == 0 || now >= last_start + NET_CONNECT_STAGGER))
         {
+            const struct addrinfo *ptr = order[started++];
+            int fd = net_Socket(obj, ptr->ai_family,
+                                ptr->ai_socktype, ptr->ai_protocol);
+            if (fd == -1)
+            {
+                msg_Dbg(obj, "socket error: %s", vlc_strerror_c(net_errno));
+                continue;
+            }
+
+            if (connect(fd, ptr->ai_addr, ptr->ai_addrlen) == 0)
+            {
+                ret = fd; /* success! */
+                break;
+            }
+
             if (net_errno != EINPROGRESS && errno != EINTR)
             {
                 msg_Err(obj, "connection failed: %s",
                         vlc_strerror_c(net_errno));
-                goto next_ai;
+                net_Close(fd);
+                continue;
             }
 
-            struct pollfd ufd;
-            vlc_tick_t deadline = VLC_TICK_INVALID;
+            fds[pending++] = fd;
+            last_start = now;
+        }
 
-            ufd.fd = fd;
-            ufd.events = POLLOUT;
-            deadline = vlc_tick_now() + timeout;
+        if (ret != -1 || pending == 0)
+            break; /* connected, or no candidates left */
 
-            do
-            {
-                vlc_tick_t now = vlc_tick_now();
+        if (now >= deadline)
+        {
+            msg_Warn(obj, "connection timed out");
+            break;
+        }
 
-                if (vlc_killed())
-                    goto next_ai;
+        vlc_tick_t limit = deadline;
+        if (started < count && last_start + NET_CONNECT_STAGGER < limit)
+            limit = last_start + NET_CONNECT_STAGGER;
+        if (limit < now)
+            limit = now;
 
-                if (now > deadline)
-                    now = deadline;
+        struct pollfd ufd[pending];
+        for (size_t i = 0; i < pending; i++)
+        {
+            ufd[i].fd = fds[i];
+            ufd[i].events = POLLOUT;
+        }
 
-                val = vlc_poll_i11e(&ufd, 1, MS_FROM_VLC_TICK(deadline - now));
-            }
-            while (val == -1 && errno == EINTR);
+        val = vlc_poll_i11e(ufd, pending, MS_FROM_VLC_TICK(limit - now));
+        if (val == -1)
+        {
+            if (vlc_killed())
+                break;
+            if (errno == EINTR)
+                continue;
+            msg_Err(obj, "polling error: %s", vlc_strerror_c(net_errno));
+            break;
+        }
+        if (val == 0)
+            continue; /* stagger interval or timeout elapsed */
 
-            switch (val)
-            {
-                 case -1: /* error */
-                     msg_Err(obj, "polling error: %s",
-                             vlc_strerror_c(net_errno));
-                     goto next_ai;
-
-                 case 0: /* timeout */
-                     msg_Warn(obj, "connection timed out");
-                     goto next_ai;
-            }
+        /* Backward, so discarding an entry only moves already-visited
+         * tail entries and the poll results stay in sync. */
+        for (size_t i = pending; i-- > 0;)
+        {
+            if (ufd[i].revents == 0)
+                continue;
+
+            int fd = fds[i];
 
             /* There is NO WAY around checking SO_ERROR.
              * Don't ifdef it out!!! */
@@ -191,18 +263,25 @@ int (net_Connect)(vlc_object_t *obj, const char *host, int serv,
                            &(socklen_t){ sizeof (val) }) || val)
             {
                 msg_Err(obj, "connection failed: %s", vlc_strerror_c(val));
-                goto next_ai;
+                net_Close(fd);
+                fds[i] = fds[--pending];
+                continue;
             }
+
+            ret = fd; /* success! */
+            break;
         }
+    }
 
-        msg_Dbg(obj, "connection succeeded (socket = %d)", fd);
-        ret = fd; /* success! */
-        break;
+    /* Close whatever attempts lost the race */
+    for (size_t i = 0; i < pending; i++)
+        if (fds[i] != ret)
+            net_Close(fds[i]);
 
-next_ai: /* failure */
-        net_Close(fd);
-    }
+    if (ret != -1)
+        msg_Dbg(obj, "connection succeeded (socket = %d)", ret);
 
+    free(order);
     freeaddrinfo(res);
     return ret;
 }
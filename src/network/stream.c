@@ -227,6 +227,11 @@ static const struct vlc_tls_operations vlc_tls_socket_ops =
     vlc_tls_SocketClose,
 };
 
+bool vlc_tls_SocketIsRaw(vlc_tls_t *tls)
+{
+    return tls->ops == &vlc_tls_socket_ops;
+}
+
 static vlc_tls_t *vlc_tls_SocketAlloc(int fd,
                                       const struct sockaddr *restrict peer,
                                       socklen_t peerlen)
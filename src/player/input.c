@@ -93,6 +93,8 @@ vlc_player_input_UpdateTime(struct vlc_player_input *input)
 int
 vlc_player_input_Start(struct vlc_player_input *input)
 {
+    input->start_date = vlc_tick_now();
+
     int ret = input_Start(input->thread);
     if (ret != VLC_SUCCESS)
         return ret;
@@ -153,7 +155,11 @@ vlc_player_input_HandleState(struct vlc_player_input *input,
                 vlc_player_SendEvent(player, on_titles_changed, NULL);
             }
 
-            vlc_player_ResetTimer(player);
+            /* With fast media switching, the next input may already be
+             * playing when the previous one reaches this state: don't reset
+             * its timers. */
+            if (player->input == NULL)
+                vlc_player_ResetTimer(player);
 
             if (input->error != VLC_PLAYER_ERROR_NONE)
                 player->error_count++;
@@ -171,12 +177,16 @@ vlc_player_input_HandleState(struct vlc_player_input *input,
             {
                 case VLC_PLAYER_MEDIA_STOPPED_EXIT:
                     if (player->input && player->started)
-                        vlc_player_input_Start(player->input);
+                    {
+                        if (!player->input->started)
+                            vlc_player_input_Start(player->input);
+                    }
                     else
                         libvlc_Quit(vlc_object_instance(player));
                     break;
                 case VLC_PLAYER_MEDIA_STOPPED_CONTINUE:
-                    if (player->input && player->started)
+                    if (player->input && player->started
+                     && !player->input->started)
                         vlc_player_input_Start(player->input);
                     break;
                 default:
@@ -195,7 +205,10 @@ vlc_player_input_HandleState(struct vlc_player_input *input,
             if (input == player->input)
                 player->input = NULL;
 
-            if (player->started)
+            /* With fast media switching, the next input is already active
+             * (player->input): the next media was consumed when the switch
+             * was requested, so don't query the provider again. */
+            if (player->started && player->input == NULL)
             {
                 vlc_player_PrepareNextMedia(player);
                 if (!player->next_media)
@@ -205,6 +218,13 @@ vlc_player_input_HandleState(struct vlc_player_input *input,
             break;
         case VLC_PLAYER_STATE_PLAYING:
             input->pause_date = VLC_TICK_INVALID;
+            if (!input->playing_reported)
+            {
+                input->playing_reported = true;
+                if (input->start_date != VLC_TICK_INVALID)
+                    vlc_player_SendEvent(player, on_playback_latency_changed,
+                                         vlc_tick_now() - input->start_date);
+            }
             /* fallthrough */
         case VLC_PLAYER_STATE_STARTED:
             if (player->started &&
@@ -835,6 +855,8 @@ vlc_player_input_New(vlc_player_t *player, input_item_t *item)
 
     input->player = player;
     input->started = false;
+    input->start_date = VLC_TICK_INVALID;
+    input->playing_reported = false;
 
     input->state = VLC_PLAYER_STATE_STOPPED;
     input->error = VLC_PLAYER_ERROR_NONE;
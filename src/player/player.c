@@ -1041,6 +1041,18 @@ vlc_player_SetCurrentMedia(vlc_player_t *player, input_item_t *media)
     assert(media == player->next_media);
     if (!vlc_player_destructor_IsEmpty(player))
     {
+        if (player->fast_switch && player->started && player->next_media)
+        {
+            /* Open and start the next media right away, while the destructor
+             * thread is still stopping the previous input: the open (network
+             * access, demux probing) then overlaps the teardown, and the
+             * outputs stay alive for reuse. Outputs that the previous input
+             * does not release in time are simply recreated. */
+            int ret = vlc_player_OpenNextMedia(player);
+            if (ret == VLC_SUCCESS && player->input != NULL)
+                ret = vlc_player_input_Start(player->input);
+            return ret;
+        }
         /* This media will be opened when the input is finally stopped */
         return VLC_SUCCESS;
     }
@@ -1269,6 +1281,36 @@ vlc_player_NextVideoFrame(vlc_player_t *player)
         vlc_player_osd_Message(player, _("Next frame"));
 }
 
+void
+vlc_player_PreviousVideoFrame(vlc_player_t *player)
+{
+    struct vlc_player_input *input = vlc_player_get_input_locked(player);
+    if (!input)
+        return;
+
+    vlc_tick_t time = vlc_player_GetTime(player);
+    if (time == VLC_TICK_INVALID)
+        return;
+
+    /* One frame of the selected video track, or a PAL frame if the frame
+     * rate is unknown */
+    vlc_tick_t frame_duration = VLC_TICK_FROM_MS(40);
+    const struct vlc_player_track *track =
+        vlc_player_GetSelectedTrack(player, VIDEO_ES);
+    if (track != NULL && track->fmt.video.i_frame_rate != 0
+     && track->fmt.video.i_frame_rate_base != 0)
+        frame_duration = vlc_tick_from_samples(track->fmt.video.i_frame_rate_base,
+                                               track->fmt.video.i_frame_rate);
+
+    /* Decoders cannot run backward: pause, then seek precisely to the
+     * previous frame. The demuxer lands on the previous keyframe and the
+     * decoders roll forward up to the target without displaying. */
+    vlc_player_SetPause(player, true);
+    vlc_player_SeekByTime(player, __MAX(time - frame_duration, 0),
+                          VLC_PLAYER_SEEK_PRECISE, VLC_PLAYER_WHENCE_ABSOLUTE);
+    vlc_player_osd_Message(player, _("Previous frame"));
+}
+
 enum vlc_player_state
 vlc_player_GetState(vlc_player_t *player)
 {
@@ -1940,6 +1982,7 @@ vlc_player_New(vlc_object_t *parent, enum vlc_player_lock_type lock_type,
     vlc_list_init(&player->destructor.joinable_inputs);
     player->media_stopped_action = VLC_PLAYER_MEDIA_STOPPED_CONTINUE;
     player->start_paused = false;
+    player->fast_switch = var_InheritBool(parent, "fast-media-switch");
     player->pause_on_cork = false;
     player->corked = false;
     player->renderer = NULL;
@@ -59,6 +59,10 @@ struct vlc_player_input
     vlc_player_t *player;
     bool started;
 
+    /* Date of the input_Start() request, to report the first-frame latency */
+    vlc_tick_t start_date;
+    bool playing_reported;
+
     enum vlc_player_state state;
     enum vlc_player_error error;
     float rate;
@@ -203,6 +207,20 @@ struct vlc_player_timer
     struct vlc_player_timer_source sources[VLC_PLAYER_TIMER_TYPE_COUNT];
 #define best_source sources[VLC_PLAYER_TIMER_TYPE_BEST]
 #define smpte_source sources[VLC_PLAYER_TIMER_TYPE_SMPTE]
+
+    /* Copy of the best source point, published with a sequence counter so
+     * that vlc_player_GetTimerPoint() can interpolate without taking any
+     * lock. Written with the timer lock held, the counter is odd while a
+     * write is in progress. */
+    struct
+    {
+        atomic_uint seq;
+        _Atomic float position;
+        _Atomic double rate;
+        _Atomic vlc_tick_t ts;
+        _Atomic vlc_tick_t length;
+        _Atomic vlc_tick_t system_date;
+    } snapshot;
 };
 
 struct vlc_player_t
@@ -215,6 +233,7 @@ struct vlc_player_t
 
     enum vlc_player_media_stopped_action media_stopped_action;
     bool start_paused;
+    bool fast_switch;
 
     const struct vlc_player_media_provider *media_provider;
     void *media_provider_data;
@@ -449,10 +468,6 @@ vlc_player_UpdateTimer(vlc_player_t *player, vlc_es_id_t *es_source,
 void
 vlc_player_RemoveTimerSource(vlc_player_t *player, vlc_es_id_t *es_source);
 
-int
-vlc_player_GetTimerPoint(vlc_player_t *player, vlc_tick_t system_now,
-                         vlc_tick_t *out_ts, float *out_pos);
-
 /*
  * player_vout.c
  */
@@ -41,6 +41,24 @@ vlc_player_ResetTimer(vlc_player_t *player)
     vlc_mutex_unlock(&player->timer.lock);
 }
 
+static void
+vlc_player_PublishTimerPoint(vlc_player_t *player,
+                             const struct vlc_player_timer_point *point)
+{
+    vlc_mutex_assert(&player->timer.lock);
+
+    unsigned seq = atomic_load_explicit(&player->timer.snapshot.seq,
+                                        memory_order_relaxed);
+    /* Odd sequence: write in progress, readers will retry with the lock */
+    atomic_store(&player->timer.snapshot.seq, seq + 1);
+    atomic_store(&player->timer.snapshot.position, point->position);
+    atomic_store(&player->timer.snapshot.rate, point->rate);
+    atomic_store(&player->timer.snapshot.ts, point->ts);
+    atomic_store(&player->timer.snapshot.length, point->length);
+    atomic_store(&player->timer.snapshot.system_date, point->system_date);
+    atomic_store(&player->timer.snapshot.seq, seq + 2);
+}
+
 static void
 vlc_player_SendTimerSourceUpdates(vlc_player_t *player,
                                   struct vlc_player_timer_source *source,
@@ -195,7 +213,10 @@ vlc_player_UpdateTimerState(vlc_player_t *player, vlc_es_id_t *es_source,
                 source->point.system_date = VLC_TICK_INVALID;
                 /* signal discontinuity only on best source */
                 if (i == VLC_PLAYER_TIMER_TYPE_BEST)
+                {
+                    vlc_player_PublishTimerPoint(player, &source->point);
                     signal_discontinuity = true;
+                }
             }
         }
         if (!signal_discontinuity)
@@ -328,6 +349,7 @@ vlc_player_UpdateTimer(vlc_player_t *player, vlc_es_id_t *es_source,
         {
             vlc_player_UpdateTimerSource(player, source, point->rate, point->ts,
                                          point->system_date);
+            vlc_player_PublishTimerPoint(player, &source->point);
 
             if (!vlc_list_is_empty(&source->listeners))
                 vlc_player_SendTimerSourceUpdates(player, source, force_update,
@@ -390,6 +412,29 @@ int
 vlc_player_GetTimerPoint(vlc_player_t *player, vlc_tick_t system_now,
                          vlc_tick_t *out_ts, float *out_pos)
 {
+    struct vlc_player_timer_point point;
+
+    /* Lock-free fast path: copy the published snapshot of the best source
+     * point and validate it with the sequence counter */
+    unsigned seq = atomic_load(&player->timer.snapshot.seq);
+    if (!(seq & 1))
+    {
+        point.position = atomic_load(&player->timer.snapshot.position);
+        point.rate = atomic_load(&player->timer.snapshot.rate);
+        point.ts = atomic_load(&player->timer.snapshot.ts);
+        point.length = atomic_load(&player->timer.snapshot.length);
+        point.system_date = atomic_load(&player->timer.snapshot.system_date);
+
+        if (atomic_load(&player->timer.snapshot.seq) == seq)
+        {
+            if (point.system_date == VLC_TICK_INVALID)
+                return VLC_EGENERIC;
+            return vlc_player_timer_point_Interpolate(&point, system_now,
+                                                      out_ts, out_pos);
+        }
+    }
+
+    /* The snapshot was being written: fall back to the locked read */
     vlc_mutex_lock(&player->timer.lock);
     if (player->timer.best_source.point.system_date == VLC_TICK_INVALID)
     {
@@ -523,6 +568,13 @@ vlc_player_InitTimer(vlc_player_t *player)
 {
     vlc_mutex_init(&player->timer.lock);
 
+    atomic_init(&player->timer.snapshot.seq, 0);
+    atomic_init(&player->timer.snapshot.position, 0.f);
+    atomic_init(&player->timer.snapshot.rate, 1.);
+    atomic_init(&player->timer.snapshot.ts, VLC_TICK_INVALID);
+    atomic_init(&player->timer.snapshot.length, VLC_TICK_INVALID);
+    atomic_init(&player->timer.snapshot.system_date, VLC_TICK_INVALID);
+
     for (size_t i = 0; i < VLC_PLAYER_TIMER_TYPE_COUNT; ++i)
     {
         vlc_list_init(&player->timer.sources[i].listeners);
@@ -37,6 +37,36 @@ vlc_playlist_ClearItems(vlc_playlist_t *playlist)
     vlc_vector_foreach(item, &playlist->items)
         vlc_playlist_item_Release(item);
     vlc_vector_clear(&playlist->items);
+    vlc_playlist_media_index_Destroy(&playlist->media_index);
+}
+
+void
+vlc_playlist_UpdateItemsIndex(vlc_playlist_t *playlist, size_t from, size_t to)
+{
+    for (size_t i = from; i < to; ++i)
+        playlist->items.data[i]->index = i;
+}
+
+/* Reference new items in the media index and update the index of the items
+ * they shifted */
+static int
+vlc_playlist_ItemsIndex(vlc_playlist_t *playlist, size_t index, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        int ret = vlc_playlist_media_index_Add(&playlist->media_index,
+                                               playlist->items.data[index + i]);
+        if (unlikely(ret != VLC_SUCCESS))
+        {
+            while (i)
+                vlc_playlist_media_index_Remove(
+                        &playlist->media_index,
+                        playlist->items.data[index + --i]);
+            return ret;
+        }
+    }
+    vlc_playlist_UpdateItemsIndex(playlist, index, playlist->items.size);
+    return VLC_SUCCESS;
 }
 
 static void
@@ -197,9 +227,12 @@ vlc_playlist_IndexOf(vlc_playlist_t *playlist, const vlc_playlist_item_t *item)
 {
     vlc_playlist_AssertLocked(playlist);
 
-    ssize_t index;
-    vlc_vector_index_of(&playlist->items, item, &index);
-    return index;
+    /* The index stored in the item is exact as long as the item belongs to
+     * the playlist; a removed item never matches the slot it points to */
+    size_t index = item->index;
+    if (index < playlist->items.size && playlist->items.data[index] == item)
+        return index;
+    return -1;
 }
 
 ssize_t
@@ -207,11 +240,9 @@ vlc_playlist_IndexOfMedia(vlc_playlist_t *playlist, const input_item_t *media)
 {
     vlc_playlist_AssertLocked(playlist);
 
-    playlist_item_vector_t *items = &playlist->items;
-    for (size_t i = 0; i < items->size; ++i)
-        if (items->data[i]->media == media)
-            return i;
-    return -1;
+    vlc_playlist_item_t *item =
+            vlc_playlist_media_index_Find(&playlist->media_index, media);
+    return item ? (ssize_t) item->index : -1;
 }
 
 ssize_t
@@ -282,6 +313,15 @@ vlc_playlist_Insert(vlc_playlist_t *playlist, size_t index,
         return ret;
     }
 
+    ret = vlc_playlist_ItemsIndex(playlist, index, count);
+    if (ret != VLC_SUCCESS)
+    {
+        for (size_t i = 0; i < count; ++i)
+            vlc_playlist_item_Release(playlist->items.data[index + i]);
+        vlc_vector_remove_slice(&playlist->items, index, count);
+        return ret;
+    }
+
     vlc_playlist_ItemsInserted(playlist, index, count);
     vlc_player_InvalidateNextMedia(playlist->player);
 
@@ -298,6 +338,12 @@ vlc_playlist_Move(vlc_playlist_t *playlist, size_t index, size_t count,
 
     vlc_vector_move_slice(&playlist->items, index, count, target);
 
+    /* only the items between the source and the target have moved */
+    if (index < target)
+        vlc_playlist_UpdateItemsIndex(playlist, index, target + count);
+    else
+        vlc_playlist_UpdateItemsIndex(playlist, target, index + count);
+
     vlc_playlist_ItemsMoved(playlist, index, count, target);
     vlc_player_InvalidateNextMedia(playlist->player);
 }
@@ -311,9 +357,14 @@ vlc_playlist_Remove(vlc_playlist_t *playlist, size_t index, size_t count)
     vlc_playlist_ItemsRemoving(playlist, index, count);
 
     for (size_t i = 0; i < count; ++i)
-        vlc_playlist_item_Release(playlist->items.data[index + i]);
+    {
+        vlc_playlist_item_t *item = playlist->items.data[index + i];
+        vlc_playlist_media_index_Remove(&playlist->media_index, item);
+        vlc_playlist_item_Release(item);
+    }
 
     vlc_vector_remove_slice(&playlist->items, index, count);
+    vlc_playlist_UpdateItemsIndex(playlist, index, playlist->items.size);
 
     bool current_media_changed = vlc_playlist_ItemsRemoved(playlist, index,
                                                            count);
@@ -335,6 +386,16 @@ vlc_playlist_Replace(vlc_playlist_t *playlist, size_t index,
     if (!item)
         return VLC_ENOMEM;
 
+    item->index = index;
+    if (vlc_playlist_media_index_Add(&playlist->media_index, item)
+            != VLC_SUCCESS)
+    {
+        vlc_playlist_item_Release(item);
+        return VLC_ENOMEM;
+    }
+    vlc_playlist_media_index_Remove(&playlist->media_index,
+                                    playlist->items.data[index]);
+
     if (playlist->order == VLC_PLAYLIST_PLAYBACK_ORDER_RANDOM)
     {
         randomizer_Remove(&playlist->randomizer,
@@ -379,6 +440,15 @@ vlc_playlist_Expand(vlc_playlist_t *playlist, size_t index,
                 vlc_vector_remove_slice(&playlist->items, index + 1, count - 1);
                 return ret;
             }
+
+            ret = vlc_playlist_ItemsIndex(playlist, index + 1, count - 1);
+            if (ret != VLC_SUCCESS)
+            {
+                for (size_t i = 0; i < count - 1; ++i)
+                    vlc_playlist_item_Release(playlist->items.data[index + 1 + i]);
+                vlc_vector_remove_slice(&playlist->items, index + 1, count - 1);
+                return ret;
+            }
             vlc_playlist_ItemsInserted(playlist, index + 1, count - 1);
         }
 
@@ -28,6 +28,11 @@ typedef struct input_item_t input_item_t;
 void
 vlc_playlist_ClearItems(vlc_playlist_t *playlist);
 
+/* refresh the position stored in the items, called by every operation
+ * reordering the items (see also sort.c and shuffle.c) */
+void
+vlc_playlist_UpdateItemsIndex(vlc_playlist_t *playlist, size_t from, size_t to);
+
 /* expand an item (replace it by the given media array) */
 int
 vlc_playlist_Expand(vlc_playlist_t *playlist, size_t index,
@@ -0,0 +1,160 @@
+/*****************************************************************************
+ * playlist/index.c
+ *****************************************************************************
+ * Copyright (C) 2018 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "index.h"
+
+#include <vlc_playlist.h>
+#include <vlc_input_item.h>
+
+#define VLC_PLAYLIST_MEDIA_INDEX_MIN_CAPACITY 16
+
+static size_t
+vlc_playlist_media_index_Hash(const input_item_t *media)
+{
+    /* Fibonacci hashing, to spread out the consecutive addresses returned by
+     * the allocator */
+    uint64_t v = (uintptr_t) media;
+    v ^= v >> 33;
+    v *= UINT64_C(0x9E3779B97F4A7C15);
+    v ^= v >> 29;
+    return (size_t) v;
+}
+
+void
+vlc_playlist_media_index_Init(struct vlc_playlist_media_index *index)
+{
+    index->entries = NULL;
+    index->size = 0;
+    index->occupied = 0;
+    index->mask = 0;
+}
+
+void
+vlc_playlist_media_index_Destroy(struct vlc_playlist_media_index *index)
+{
+    free(index->entries);
+    vlc_playlist_media_index_Init(index);
+}
+
+static int
+vlc_playlist_media_index_Rehash(struct vlc_playlist_media_index *index,
+                                size_t capacity)
+{
+    assert((capacity & (capacity - 1)) == 0); /* power of two */
+    assert(capacity > index->size);
+
+    struct vlc_playlist_media_index_entry *entries =
+            calloc(capacity, sizeof(*entries));
+    if (unlikely(!entries))
+        return VLC_ENOMEM;
+
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i <= index->mask && index->entries; ++i)
+    {
+        struct vlc_playlist_media_index_entry *entry = &index->entries[i];
+        if (!entry->item)
+            continue; /* free entry or tombstone */
+
+        size_t slot = vlc_playlist_media_index_Hash(entry->media) & mask;
+        while (entries[slot].media)
+            slot = (slot + 1) & mask;
+        entries[slot] = *entry;
+    }
+
+    free(index->entries);
+    index->entries = entries;
+    index->occupied = index->size;
+    index->mask = mask;
+    return VLC_SUCCESS;
+}
+
+int
+vlc_playlist_media_index_Add(struct vlc_playlist_media_index *index,
+                             vlc_playlist_item_t *item)
+{
+    /* Keep the load factor (including tombstones) below 3/4 */
+    size_t capacity = index->mask + (index->entries ? 1 : 0);
+    if ((index->occupied + 1) * 4 > capacity * 3)
+    {
+        size_t new_capacity = capacity < VLC_PLAYLIST_MEDIA_INDEX_MIN_CAPACITY
+                            ? VLC_PLAYLIST_MEDIA_INDEX_MIN_CAPACITY
+                            : capacity * 2;
+        /* If most entries are tombstones, rehashing at the same capacity is
+         * sufficient to make room */
+        if ((index->size + 1) * 2 <= capacity)
+            new_capacity = capacity;
+        int ret = vlc_playlist_media_index_Rehash(index, new_capacity);
+        if (unlikely(ret != VLC_SUCCESS))
+            return ret;
+    }
+
+    size_t slot = vlc_playlist_media_index_Hash(item->media) & index->mask;
+    while (index->entries[slot].item)
+        slot = (slot + 1) & index->mask;
+
+    if (!index->entries[slot].media)
+        index->occupied++;
+    index->entries[slot].media = item->media;
+    index->entries[slot].item = item;
+    index->size++;
+    return VLC_SUCCESS;
+}
+
+void
+vlc_playlist_media_index_Remove(struct vlc_playlist_media_index *index,
+                                vlc_playlist_item_t *item)
+{
+    size_t slot = vlc_playlist_media_index_Hash(item->media) & index->mask;
+    while (index->entries[slot].item != item)
+    {
+        assert(index->entries[slot].media); /* the item must be referenced */
+        slot = (slot + 1) & index->mask;
+    }
+
+    /* Leave a tombstone, the entry may be in the middle of a probe sequence */
+    index->entries[slot].item = NULL;
+    index->size--;
+}
+
+vlc_playlist_item_t *
+vlc_playlist_media_index_Find(const struct vlc_playlist_media_index *index,
+                              const input_item_t *media)
+{
+    if (!index->entries)
+        return NULL;
+
+    /* On duplicate media, return the item with the lowest position, matching
+     * the linear scan behavior */
+    vlc_playlist_item_t *found = NULL;
+    size_t slot = vlc_playlist_media_index_Hash(media) & index->mask;
+    while (index->entries[slot].media)
+    {
+        vlc_playlist_item_t *item = index->entries[slot].item;
+        if (item && item->media == media
+         && (!found || item->index < found->index))
+            found = item;
+        slot = (slot + 1) & index->mask;
+    }
+    return found;
+}
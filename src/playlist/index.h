@@ -0,0 +1,81 @@
+/*****************************************************************************
+ * playlist/index.h
+ *****************************************************************************
+ * Copyright (C) 2018 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_PLAYLIST_INDEX_H
+#define VLC_PLAYLIST_INDEX_H
+
+#include <vlc_common.h>
+#include "item.h"
+
+/**
+ * Hash index from media to playlist items.
+ *
+ * The playlist content is stored in a vector, so finding the item holding a
+ * given media would require a linear scan. Callbacks reacting to media
+ * events (preparsing, player notifications) need that lookup for every
+ * event, which does not scale to very large playlists.
+ *
+ * This index maps a media to the items referencing it, in expected constant
+ * time. It is an open addressing hash table with linear probing; a media may
+ * be referenced by several playlist items, in that case it appears in
+ * several entries.
+ *
+ * All functions must be called with the playlist locked.
+ */
+
+struct vlc_playlist_media_index_entry
+{
+    /* NULL if the entry is free, the key otherwise (a tombstone if item is
+     * NULL) */
+    const input_item_t *media;
+    /* NULL if the entry is a tombstone left by a removal */
+    vlc_playlist_item_t *item;
+};
+
+struct vlc_playlist_media_index
+{
+    struct vlc_playlist_media_index_entry *entries;
+    size_t size; /* number of items referenced */
+    size_t occupied; /* referenced items plus tombstones */
+    size_t mask; /* capacity - 1, the capacity is a power of two */
+};
+
+void
+vlc_playlist_media_index_Init(struct vlc_playlist_media_index *index);
+
+void
+vlc_playlist_media_index_Destroy(struct vlc_playlist_media_index *index);
+
+/* Reference an item; its media is the key */
+int
+vlc_playlist_media_index_Add(struct vlc_playlist_media_index *index,
+                             vlc_playlist_item_t *item);
+
+/* Remove one reference added by vlc_playlist_media_index_Add() */
+void
+vlc_playlist_media_index_Remove(struct vlc_playlist_media_index *index,
+                                vlc_playlist_item_t *item);
+
+/* Find the item referencing media with the lowest playlist position */
+vlc_playlist_item_t *
+vlc_playlist_media_index_Find(const struct vlc_playlist_media_index *index,
+                              const input_item_t *media);
+
+#endif
@@ -30,6 +30,13 @@ struct vlc_playlist_item
 {
     input_item_t *media;
     uint64_t id;
+    /* Position in the playlist, updated by every content operation (see
+     * content.c), so that vlc_playlist_IndexOf() needs no linear scan. It is
+     * stale once the item has been removed from the playlist. */
+    size_t index;
+    /* Position in the randomizer vector (see randomizer.c), only meaningful
+     * while the item belongs to a randomizer */
+    size_t rand_index;
     vlc_atomic_rc_t rc;
 };
 
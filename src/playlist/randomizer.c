@@ -32,6 +32,16 @@
 #include <vlc_rand.h>
 #include "randomizer.h"
 
+#ifdef TEST_RANDOMIZER
+/* fake structure to simplify tests */
+struct vlc_playlist_item {
+    size_t index;
+    size_t rand_index;
+};
+#else
+# include "item.h"
+#endif
+
 /**
  * \addtogroup playlist_randomizer Playlist randomizer helper
  * \ingroup playlist
@@ -283,12 +293,24 @@ randomizer_SetLoop(struct randomizer *r, bool loop)
     r->loop = loop;
 }
 
+/* Refresh the position stored in the items after a range has been shifted */
+static inline void
+randomizer_UpdateIndexes(struct randomizer *r, size_t from, size_t to)
+{
+    for (size_t i = from; i < to; ++i)
+        r->items.data[i]->rand_index = i;
+}
+
 static inline ssize_t
 randomizer_IndexOf(struct randomizer *r, const vlc_playlist_item_t *item)
 {
-    ssize_t index;
-    vlc_vector_index_of(&r->items, item, &index);
-    return index;
+    /* The items store their own position, maintained by every operation
+     * moving them in the vector, so that selections and removals need no
+     * linear scan even on giant playlists */
+    size_t index = item->rand_index;
+    if (index < r->items.size && r->items.data[index] == item)
+        return index;
+    return -1;
 }
 
 bool
@@ -312,6 +334,8 @@ swap_items(struct randomizer *r, int i, int j)
     vlc_playlist_item_t *item = r->items.data[i];
     r->items.data[i] = r->items.data[j];
     r->items.data[j] = item;
+    r->items.data[i]->rand_index = i;
+    item->rand_index = j;
 }
 
 static inline void
@@ -425,6 +449,8 @@ randomizer_Add(struct randomizer *r, vlc_playlist_item_t *items[], size_t count)
 {
     if (!vlc_vector_insert_all(&r->items, r->history, items, count))
         return false;
+    /* the new items and the shifted history tail changed position */
+    randomizer_UpdateIndexes(r, r->history, r->items.size);
     /* the insertion shifted history (and possibly next) */
     if (r->next > r->history)
         r->next += count;
@@ -443,6 +469,7 @@ randomizer_SelectIndex(struct randomizer *r, size_t index)
             memmove(&r->items.data[r->history + 1],
                     &r->items.data[r->history],
                     (index - r->history) * sizeof(selected));
+            randomizer_UpdateIndexes(r, r->history + 1, index + 1);
             index = r->history;
         }
         r->history = (r->history + 1) % r->items.size;
@@ -452,6 +479,8 @@ randomizer_SelectIndex(struct randomizer *r, size_t index)
     {
         r->items.data[index] = r->items.data[r->head];
         r->items.data[r->head] = selected;
+        r->items.data[index]->rand_index = index;
+        selected->rand_index = r->head;
         r->head++;
     }
     else if (index < r->items.size - 1)
@@ -460,6 +489,7 @@ randomizer_SelectIndex(struct randomizer *r, size_t index)
                 &r->items.data[index + 1],
                 (r->head - index - 1) * sizeof(selected));
         r->items.data[r->head - 1] = selected;
+        randomizer_UpdateIndexes(r, index, r->head);
     }
 
     r->next = r->head;
@@ -494,6 +524,7 @@ randomizer_RemoveAt(struct randomizer *r, size_t index)
                 &r->items.data[index + 1],
                 (r->head - index - 1) * sizeof(*r->items.data));
         r->head--;
+        randomizer_UpdateIndexes(r, index, r->head);
         index = r->head; /* the new index to remove */
     }
 
@@ -501,6 +532,7 @@ randomizer_RemoveAt(struct randomizer *r, size_t index)
     {
         /* this part is unordered, no need to shift all items */
         r->items.data[index] = r->items.data[r->history - 1];
+        r->items.data[index]->rand_index = index;
         index = r->history - 1;
         r->history--;
     }
@@ -511,6 +543,7 @@ randomizer_RemoveAt(struct randomizer *r, size_t index)
         memmove(&r->items.data[index],
                 &r->items.data[index + 1],
                 (r->items.size - index - 1) * sizeof(*r->items.data));
+        randomizer_UpdateIndexes(r, index, r->items.size - 1);
     }
 
     r->items.size--;
@@ -546,11 +579,6 @@ randomizer_Clear(struct randomizer *r)
 #ifndef DOC
 #ifdef TEST_RANDOMIZER
 
-/* fake structure to simplify tests */
-struct vlc_playlist_item {
-    size_t index;
-};
-
 static void
 ArrayInit(vlc_playlist_item_t *array[], size_t len)
 {
@@ -1190,6 +1218,46 @@ test_loop_respect_not_same_before_impossible(void)
     #undef SIZE
 }
 
+/* the position stored in the items must stay exact through determinations,
+ * selections and removals, so that randomizer_IndexOf() needs no scan */
+static void
+test_index_consistency(void)
+{
+    struct randomizer randomizer;
+    randomizer_Init(&randomizer);
+    randomizer_SetLoop(&randomizer, true);
+
+    #define SIZE 100
+    vlc_playlist_item_t *items[SIZE];
+    ArrayInit(items, SIZE);
+
+    bool ok = randomizer_Add(&randomizer, items, SIZE);
+    assert(ok);
+
+    for (int i = 0; i < 50; ++i)
+    {
+        assert(randomizer_HasNext(&randomizer));
+        randomizer_Next(&randomizer);
+    }
+
+    /* force the selection of an item in the history part */
+    randomizer_Select(&randomizer, randomizer.items.data[70]);
+
+    vlc_playlist_item_t *to_remove[10];
+    /* remove items already selected and others */
+    memcpy(to_remove, &randomizer.items.data[20], 5 * sizeof(*to_remove));
+    memcpy(&to_remove[5], &randomizer.items.data[60], 5 * sizeof(*to_remove));
+    randomizer_Remove(&randomizer, to_remove, 10);
+
+    for (size_t i = 0; i < randomizer.items.size; ++i)
+        assert(randomizer_IndexOf(&randomizer, randomizer.items.data[i])
+                == (ssize_t) i);
+
+    ArrayDestroy(items, SIZE);
+    randomizer_Destroy(&randomizer);
+    #undef SIZE
+}
+
 static void
 test_has_prev_next_empty(void)
 {
@@ -1224,6 +1292,7 @@ int main(void)
     test_prev_across_reshuffle_loops();
     test_loop_respect_not_same_before();
     test_loop_respect_not_same_before_impossible();
+    test_index_consistency();
     test_has_prev_next_empty();
 }
 
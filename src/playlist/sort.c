@@ -22,17 +22,29 @@
 # include "config.h"
 #endif
 
+#include <stdatomic.h>
+
 #include <vlc_common.h>
 #include <vlc_rand.h>
 #include <vlc_sort.h>
+#include "content.h"
 #include "control.h"
 #include "item.h"
 #include "notify.h"
 #include "playlist.h"
 
+/** Do not spawn extraction threads below this item count */
+#define SORT_PARALLEL_THRESHOLD 4096
+/** Upper bound on extraction threads (including the calling thread) */
+#define SORT_MAX_WORKERS 8
+
 /**
  * Struct containing a copy of (parsed) media metadata, used for sorting
  * without locking all the items.
+ *
+ * The metadata of all items is extracted once into a flat array of these
+ * (decorate-sort-undecorate), so sorting never calls a meta getter nor
+ * takes a media lock per comparison.
  */
 struct vlc_playlist_item_meta {
     vlc_playlist_item_t *item;
@@ -187,16 +199,12 @@ vlc_playlist_item_meta_InitFields(struct vlc_playlist_item_meta *meta,
     return VLC_SUCCESS;
 }
 
-static struct vlc_playlist_item_meta *
-vlc_playlist_item_meta_New(vlc_playlist_item_t *item,
-                           const struct vlc_playlist_sort_criterion criteria[],
-                           size_t count)
+static int
+vlc_playlist_item_meta_Init(struct vlc_playlist_item_meta *meta,
+                            vlc_playlist_item_t *item,
+                            const struct vlc_playlist_sort_criterion criteria[],
+                            size_t count)
 {
-    /* assume that NULL representation is all-zeros */
-    struct vlc_playlist_item_meta *meta = calloc(1, sizeof(*meta));
-    if (unlikely(!meta))
-        return NULL;
-
     meta->item = item;
 
     vlc_mutex_lock(&item->media->lock);
@@ -204,19 +212,10 @@ vlc_playlist_item_meta_New(vlc_playlist_item_t *item,
     vlc_mutex_unlock(&item->media->lock);
 
     if (unlikely(ret != VLC_SUCCESS))
-    {
-        free(meta);
-        return NULL;
-    }
+        /* the fields were already freed: make destroying them again safe */
+        memset(meta, 0, sizeof(*meta));
 
-    return meta;
-}
-
-static void
-vlc_playlist_item_meta_Delete(struct vlc_playlist_item_meta *meta)
-{
-    vlc_playlist_item_meta_DestroyFields(meta);
-    free(meta);
+    return ret;
 }
 
 static inline int
@@ -301,10 +300,8 @@ static int
 compare_meta(const void *lhs, const void *rhs, void *userdata)
 {
     struct sort_request *req = userdata;
-    const struct vlc_playlist_item_meta *a =
-            *(const struct vlc_playlist_item_meta **) lhs;
-    const struct vlc_playlist_item_meta *b =
-            *(const struct vlc_playlist_item_meta **) rhs;
+    const struct vlc_playlist_item_meta *a = lhs;
+    const struct vlc_playlist_item_meta *b = rhs;
 
     for (size_t i = 0; i < req->count; ++i)
     {
@@ -322,37 +319,91 @@ compare_meta(const void *lhs, const void *rhs, void *userdata)
 }
 
 static void
-vlc_playlist_DeleteMetaArray(struct vlc_playlist_item_meta *array[],
+vlc_playlist_DeleteMetaArray(struct vlc_playlist_item_meta *array,
                              size_t count)
 {
     for (size_t i = 0; i < count; ++i)
-        vlc_playlist_item_meta_Delete(array[i]);
+        vlc_playlist_item_meta_DestroyFields(&array[i]);
     free(array);
 }
 
-static struct vlc_playlist_item_meta **
+/* context for the parallel meta extraction */
+struct meta_extract_job
+{
+    vlc_playlist_item_t *const *items;
+    struct vlc_playlist_item_meta *array;
+    size_t total;
+    const struct vlc_playlist_sort_criterion *criteria;
+    size_t count;
+    atomic_size_t next;
+    atomic_bool failed;
+};
+
+static void
+vlc_playlist_ExtractMeta(struct meta_extract_job *job)
+{
+    size_t i;
+    while ((i = atomic_fetch_add_explicit(&job->next, 1,
+                                          memory_order_relaxed)) < job->total
+        && !atomic_load_explicit(&job->failed, memory_order_relaxed))
+    {
+        if (unlikely(vlc_playlist_item_meta_Init(&job->array[i], job->items[i],
+                                                 job->criteria, job->count)
+                        != VLC_SUCCESS))
+            atomic_store_explicit(&job->failed, true, memory_order_relaxed);
+    }
+}
+
+static void *
+ExtractMetaThread(void *data)
+{
+    vlc_playlist_ExtractMeta(data);
+    return NULL;
+}
+
+static struct vlc_playlist_item_meta *
 vlc_playlist_NewMetaArray(vlc_playlist_t *playlist,
         const struct vlc_playlist_sort_criterion criteria[], size_t count)
 {
-    struct vlc_playlist_item_meta **array =
-            vlc_alloc(playlist->items.size, sizeof(*array));
+    size_t size = playlist->items.size;
 
+    /* assume that NULL representation is all-zeros */
+    struct vlc_playlist_item_meta *array = calloc(size, sizeof(*array));
     if (unlikely(!array))
         return NULL;
 
-    size_t i;
-    for (i = 0; i < playlist->items.size; ++i)
-    {
-        array[i] = vlc_playlist_item_meta_New(playlist->items.data[i],
-                                              criteria, count);
-        if (unlikely(!array[i]))
-            break;
-    }
-
-    if (i < playlist->items.size)
+    struct meta_extract_job job = {
+        .items = playlist->items.data,
+        .array = array,
+        .total = size,
+        .criteria = criteria,
+        .count = count,
+    };
+    atomic_init(&job.next, 0);
+    atomic_init(&job.failed, false);
+
+    /* each item only needs its own media lock, so the copies can be
+     * extracted concurrently */
+    size_t workers = 1;
+    if (size >= SORT_PARALLEL_THRESHOLD)
+        workers = __MIN(vlc_GetCPUCount(), SORT_MAX_WORKERS);
+
+    vlc_thread_t threads[SORT_MAX_WORKERS];
+    size_t spawned = 0;
+    for (size_t i = 1; i < workers; ++i)
+        if (vlc_clone(&threads[spawned], ExtractMetaThread, &job,
+                      VLC_THREAD_PRIORITY_LOW) == 0)
+            spawned++;
+
+    vlc_playlist_ExtractMeta(&job);
+
+    for (size_t i = 0; i < spawned; ++i)
+        vlc_join(threads[i], NULL);
+
+    if (unlikely(atomic_load(&job.failed)))
     {
         /* allocation failure */
-        vlc_playlist_DeleteMetaArray(array, i);
+        vlc_playlist_DeleteMetaArray(array, size);
         return NULL;
     }
 
@@ -371,18 +422,20 @@ vlc_playlist_Sort(vlc_playlist_t *playlist,
                                  ? playlist->items.data[playlist->current]
                                  : NULL;
 
-    struct vlc_playlist_item_meta **array =
+    struct vlc_playlist_item_meta *array =
         vlc_playlist_NewMetaArray(playlist, criteria, count);
     if (unlikely(!array))
         return VLC_ENOMEM;
 
     struct sort_request req = { criteria, count };
 
-    vlc_qsort(array, playlist->items.size, sizeof(*array), compare_meta, &req);
+    vlc_mergesort(array, playlist->items.size, sizeof(*array), compare_meta,
+                  &req);
 
     /* apply the sorting result to the playlist */
     for (size_t i = 0; i < playlist->items.size; ++i)
-        playlist->items.data[i] = array[i]->item;
+        playlist->items.data[i] = array[i].item;
+    vlc_playlist_UpdateItemsIndex(playlist, 0, playlist->items.size);
 
     vlc_playlist_DeleteMetaArray(array, playlist->items.size);
 
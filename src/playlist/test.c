@@ -1061,6 +1061,18 @@ test_index_of(void)
     assert(vlc_playlist_IndexOf(playlist, item) == -1);
     vlc_playlist_item_Release(item);
 
+    /* the index must stay exact after the items are reordered */
+    vlc_playlist_Move(playlist, 0, 3, 5);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[0]) == 5);
+    assert(vlc_playlist_IndexOf(playlist, vlc_playlist_Get(playlist, 2)) == 2);
+
+    /* on duplicate media, the first occurrence is returned */
+    ret = vlc_playlist_AppendOne(playlist, media[3]);
+    assert(ret == VLC_SUCCESS);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[3]) == 0);
+    vlc_playlist_RemoveOne(playlist, 0);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[3]) == 7);
+
     DestroyMediaArray(media, 10);
     vlc_playlist_Delete(playlist);
 }
@@ -30,6 +30,8 @@
 #include <vlc_interrupt.h>
 #include <vlc_network.h>
 
+#include "libvlc.h"
+
 struct vlc_gai_req
 {
     const char *name;
@@ -50,7 +52,7 @@ static void *vlc_gai_thread(void *data)
     return NULL;
 }
 
-int vlc_getaddrinfo_i11e(const char *name, unsigned port,
+int vlc_getaddrinfo_resolve(const char *name, unsigned port,
                          const struct addrinfo *hints,
                          struct addrinfo **res)
 {
@@ -27,6 +27,7 @@
 
 #include <sys/stat.h>
 #include <errno.h>
+#include <time.h>
 
 #include <vlc_common.h>
 #include <vlc_input_item.h>
@@ -285,6 +286,70 @@ int input_FindArtInCacheUsingItemUID( input_item_t *p_item )
     return VLC_EGENERIC;
 }
 
+/* Name of the marker dropped in the art cache directory when a search
+ * failed. It must not start with "art" or input_FindArtInCache() would pick
+ * it up as artwork. */
+#define ART_NOT_FOUND_MARKER ".notfound"
+/* Retry a failed art search once the marker is older than this (seconds) */
+#define ART_NOT_FOUND_TTL (7 * 24 * 60 * 60)
+
+static char *ArtNotFoundPath( input_item_t *p_item )
+{
+    char *psz_path = ArtCachePath( p_item );
+    char *psz_file = NULL;
+
+    if( psz_path )
+    {
+        if( asprintf( &psz_file, "%s" DIR_SEP ART_NOT_FOUND_MARKER,
+                      psz_path ) < 0 )
+            psz_file = NULL;
+        free( psz_path );
+    }
+    return psz_file;
+}
+
+int input_FindArtNotFoundInCache( input_item_t *p_item )
+{
+    char *psz_file = ArtNotFoundPath( p_item );
+
+    if( !psz_file )
+        return VLC_EGENERIC;
+
+    int i_ret = VLC_EGENERIC;
+    struct stat st;
+    if( !vlc_stat( psz_file, &st ) )
+    {
+        if( time( NULL ) < st.st_mtime + ART_NOT_FOUND_TTL )
+            i_ret = VLC_SUCCESS;
+        else
+            vlc_unlink( psz_file ); /* stale marker, retry the search */
+    }
+
+    free( psz_file );
+    return i_ret;
+}
+
+void input_SaveArtNotFound( input_item_t *p_item )
+{
+    char *psz_path = ArtCachePath( p_item );
+
+    if( !psz_path )
+        return;
+
+    ArtCacheCreateDir( psz_path );
+
+    char *psz_file;
+    if( asprintf( &psz_file, "%s" DIR_SEP ART_NOT_FOUND_MARKER,
+                  psz_path ) >= 0 )
+    {
+        FILE *f = vlc_fopen( psz_file, "wb" );
+        if( f )
+            fclose( f );
+        free( psz_file );
+    }
+    free( psz_path );
+}
+
 /* */
 int input_SaveArt( vlc_object_t *obj, input_item_t *p_item,
                    const void *data, size_t length, const char *psz_type )
@@ -328,6 +393,14 @@ int input_SaveArt( vlc_object_t *obj, input_item_t *p_item,
     }
     free( psz_uri );
 
+    /* the search is not a failure anymore, drop the marker if any */
+    char *psz_notfound = ArtNotFoundPath( p_item );
+    if( psz_notfound )
+    {
+        vlc_unlink( psz_notfound );
+        free( psz_notfound );
+    }
+
     /* save uid info */
     char *uid = input_item_GetInfo( p_item, "uid", "md5" );
     if ( ! *uid )
@@ -30,5 +30,11 @@ int input_FindArtInCacheUsingItemUID( input_item_t * );
 int input_SaveArt( vlc_object_t *, input_item_t *,
                    const void *, size_t, const char *psz_type );
 
+/* Negative result cache: remember on disk that an art search failed, so that
+ * rescanning a library does not repeat the same (network) searches. Stale
+ * markers are dropped so that a failed search is eventually retried. */
+int input_FindArtNotFoundInCache( input_item_t * );
+void input_SaveArtNotFound( input_item_t * );
+
 #endif
 
@@ -45,6 +45,7 @@ struct input_fetcher_t {
     struct background_worker* downloader;
 
     vlc_dictionary_t album_cache;
+    vlc_dictionary_t downloads; /**< in-flight art downloads, by URL */
     vlc_object_t* owner;
     vlc_mutex_t lock;
 };
@@ -222,9 +223,87 @@ static void NotifyArtFetchEnded( struct fetcher_request* req, bool fetched )
         req->cbs->on_art_fetch_ended(req->item, fetched, req->userdata);
 }
 
+static void RequestHold( void* req_ );
+static void RequestRelease( void* req_ );
+
+/* Try to register the download of the given URL. Returns true if this thread
+ * shall perform the download itself, false if an identical download is
+ * already in flight and the request was queued behind it, to be completed by
+ * the downloading thread. */
+static bool CoalesceDownload( input_fetcher_t* fetcher,
+    struct fetcher_request* req, const char* psz_arturl )
+{
+    bool b_queued = false;
+
+    vlc_mutex_lock( &fetcher->lock );
+    vlc_array_t* waiters = vlc_dictionary_value_for_key( &fetcher->downloads,
+                                                         psz_arturl );
+    if( waiters )
+    {
+        RequestHold( req );
+        if( vlc_array_append( waiters, req ) == 0 )
+            b_queued = true;
+        else
+            RequestRelease( req ); /* keep going, download it once more */
+    }
+    else
+    {
+        waiters = malloc( sizeof( *waiters ) );
+        if( likely( waiters ) )
+        {
+            vlc_array_init( waiters );
+            vlc_dictionary_insert( &fetcher->downloads, psz_arturl, waiters );
+        }
+        /* on allocation failure, simply do not coalesce */
+    }
+    vlc_mutex_unlock( &fetcher->lock );
+
+    return !b_queued;
+}
+
+/* Complete the requests that were coalesced behind the download of the given
+ * URL. data is NULL if the download failed. */
+static void FinishDownload( input_fetcher_t* fetcher, const char* psz_arturl,
+                            const void* data, size_t length )
+{
+    vlc_mutex_lock( &fetcher->lock );
+    vlc_array_t* waiters = vlc_dictionary_value_for_key( &fetcher->downloads,
+                                                         psz_arturl );
+    if( waiters )
+        vlc_dictionary_remove_value_for_key( &fetcher->downloads, psz_arturl,
+                                             NULL, NULL );
+    vlc_mutex_unlock( &fetcher->lock );
+
+    if( !waiters )
+        return;
+
+    for( size_t i = 0; i < vlc_array_count( waiters ); ++i )
+    {
+        struct fetcher_request* waiter = vlc_array_item_at_index( waiters, i );
+        bool fetched = false;
+
+        if( data && !input_SaveArt( fetcher->owner, waiter->item, data,
+                                    length, NULL ) )
+        {
+            AddAlbumCache( fetcher, waiter->item, true );
+            var_SetAddress( fetcher->owner, "item-change", waiter->item );
+            input_item_SetArtFetched( waiter->item, true );
+            fetched = true;
+        }
+
+        NotifyArtFetchEnded( waiter, fetched );
+        RequestRelease( waiter );
+    }
+
+    vlc_array_clear( waiters );
+    free( waiters );
+}
+
 static void Downloader( input_fetcher_t* fetcher,
     struct fetcher_request* req )
 {
+    bool b_download_owner = false;
+
     ReadAlbumCache( fetcher, req->item );
 
     char *psz_arturl = input_item_GetArtURL( req->item );
@@ -235,6 +314,15 @@ static void Downloader( input_fetcher_t* fetcher,
         !strncasecmp( psz_arturl, "attachment://", 13 ) )
         goto out; /* no fetch required */
 
+    /* Every track of an album typically carries the same cover URL: fetch
+     * it only once and share the result with the coalesced requests. */
+    if( !CoalesceDownload( fetcher, req, psz_arturl ) )
+    {
+        free( psz_arturl );
+        return; /* completed by the thread downloading the same URL */
+    }
+    b_download_owner = true;
+
     stream_t* source = vlc_stream_NewURL( fetcher->owner, psz_arturl );
 
     if( !source )
@@ -269,8 +357,10 @@ static void Downloader( input_fetcher_t* fetcher,
     input_SaveArt( fetcher->owner, req->item, output_stream.ptr,
                    output_stream.length, NULL );
 
-    free( output_stream.ptr );
     AddAlbumCache( fetcher, req->item, true );
+    FinishDownload( fetcher, psz_arturl, output_stream.ptr,
+                    output_stream.length );
+    free( output_stream.ptr );
 
 out:
     if( psz_arturl )
@@ -284,6 +374,8 @@ out:
     return;
 
 error:
+    if( b_download_owner )
+        FinishDownload( fetcher, psz_arturl, NULL, 0 );
     FREENULL( psz_arturl );
     goto out;
 }
@@ -296,6 +388,15 @@ static void SearchLocal( input_fetcher_t* fetcher, struct fetcher_request* req )
     if( var_InheritBool( fetcher->owner, "metadata-network-access" ) ||
         req->options & META_REQUEST_OPTION_FETCH_NETWORK )
     {
+        /* A previous network search for this album already failed, do not
+         * query the art providers again for every single track. */
+        if( input_FindArtNotFoundInCache( req->item ) == VLC_SUCCESS )
+        {
+            input_item_SetArtNotFound( req->item, true );
+            NotifyArtFetchEnded(req, false);
+            return;
+        }
+
         if( background_worker_Push( fetcher->network, req, NULL, 0 ) )
             NotifyArtFetchEnded(req, false);
     }
@@ -310,6 +411,7 @@ static void SearchNetwork( input_fetcher_t* fetcher, struct fetcher_request* req
 {
     if( SearchByScope( fetcher, req, FETCHER_SCOPE_NETWORK ) )
     {
+        input_SaveArtNotFound( req->item );
         input_item_SetArtNotFound( req->item, true );
         NotifyArtFetchEnded(req, false);
     }
@@ -443,6 +545,7 @@ input_fetcher_t* input_fetcher_New( vlc_object_t* owner )
 
     vlc_mutex_init( &fetcher->lock );
     vlc_dictionary_init( &fetcher->album_cache, 0 );
+    vlc_dictionary_init( &fetcher->downloads, 0 );
 
     return fetcher;
 }
@@ -481,5 +584,7 @@ void input_fetcher_Delete( input_fetcher_t* fetcher )
     background_worker_Delete( fetcher->downloader );
 
     vlc_dictionary_clear( &fetcher->album_cache, FreeCacheEntry, NULL );
+    /* the workers are gone, no download can still be in flight */
+    vlc_dictionary_clear( &fetcher->downloads, NULL, NULL );
     free( fetcher );
 }
@@ -257,14 +257,11 @@ input_preparser_t* input_preparser_New( vlc_object_t *parent )
     return preparser;
 }
 
-void input_preparser_Push( input_preparser_t *preparser,
-    input_item_t *item, input_item_meta_request_option_t i_options,
-    const input_preparser_callbacks_t *cbs, void *cbs_userdata,
-    int timeout, void *id )
+/* Check that the item can be preparsed with the given options, and mark it
+ * interactive if requested. Returns false if the item shall be skipped. */
+static bool PreparserCheckItem( input_item_t *item,
+                                input_item_meta_request_option_t i_options )
 {
-    if( atomic_load( &preparser->deactivated ) )
-        return;
-
     vlc_mutex_lock( &item->lock );
     enum input_item_type_e i_type = item->i_type;
     int b_net = item->b_net;
@@ -278,25 +275,96 @@ void input_preparser_Push( input_preparser_t *preparser,
         case ITEM_TYPE_FILE:
         case ITEM_TYPE_DIRECTORY:
         case ITEM_TYPE_PLAYLIST:
-            if( !b_net || i_options & META_REQUEST_OPTION_SCOPE_NETWORK )
-                break;
-            /* fallthrough */
+            return !b_net || i_options & META_REQUEST_OPTION_SCOPE_NETWORK;
         default:
-            if (cbs && cbs->on_preparse_ended)
-                cbs->on_preparse_ended(item, ITEM_PREPARSE_SKIPPED, cbs_userdata);
-            return;
+            return false;
+    }
+}
+
+static int PreparserPushFlags( input_item_meta_request_option_t i_options )
+{
+    int flags = 0;
+    if( i_options & META_REQUEST_OPTION_PRIORITY )
+        flags |= BACKGROUND_WORKER_PUSH_PRIORITY;
+    if( i_options & META_REQUEST_OPTION_DEADLINE )
+        flags |= BACKGROUND_WORKER_PUSH_DEADLINE;
+    return flags;
+}
+
+void input_preparser_Push( input_preparser_t *preparser,
+    input_item_t *item, input_item_meta_request_option_t i_options,
+    const input_preparser_callbacks_t *cbs, void *cbs_userdata,
+    int timeout, void *id )
+{
+    if( atomic_load( &preparser->deactivated ) )
+        return;
+
+    if( !PreparserCheckItem( item, i_options ) )
+    {
+        if (cbs && cbs->on_preparse_ended)
+            cbs->on_preparse_ended(item, ITEM_PREPARSE_SKIPPED, cbs_userdata);
+        return;
     }
 
     struct input_preparser_req_t *req = ReqCreate(item, i_options,
                                                   cbs, cbs_userdata);
 
-    if (background_worker_Push(preparser->worker, req, id, timeout))
+    if (background_worker_PushEx(preparser->worker, req, id, timeout,
+                                 PreparserPushFlags(i_options)))
         if (req->cbs && cbs->on_preparse_ended)
             cbs->on_preparse_ended(item, ITEM_PREPARSE_FAILED, cbs_userdata);
 
     ReqRelease(req);
 }
 
+void input_preparser_PushBatch( input_preparser_t *preparser,
+    input_item_t *const *items, size_t i_count,
+    input_item_meta_request_option_t i_options,
+    const input_preparser_callbacks_t *cbs, void *cbs_userdata,
+    int timeout, void *id )
+{
+    if( atomic_load( &preparser->deactivated ) || i_count == 0 )
+        return;
+
+    input_preparser_req_t **reqs = vlc_alloc( i_count, sizeof( *reqs ) );
+    if( unlikely( !reqs ) )
+        return;
+
+    size_t i_reqs = 0;
+    for( size_t i = 0; i < i_count; i++ )
+    {
+        input_item_t *item = items[i];
+        if( !PreparserCheckItem( item, i_options ) )
+        {
+            if (cbs && cbs->on_preparse_ended)
+                cbs->on_preparse_ended(item, ITEM_PREPARSE_SKIPPED, cbs_userdata);
+            continue;
+        }
+
+        input_preparser_req_t *req = ReqCreate(item, i_options,
+                                               cbs, cbs_userdata);
+        if( likely( req ) )
+            reqs[i_reqs++] = req;
+        else if (cbs && cbs->on_preparse_ended)
+            cbs->on_preparse_ended(item, ITEM_PREPARSE_FAILED, cbs_userdata);
+    }
+
+    if( i_reqs > 0 )
+    {
+        if (background_worker_PushBatch(preparser->worker, (void *const *)reqs,
+                                        i_reqs, id, timeout,
+                                        PreparserPushFlags(i_options)))
+            for( size_t i = 0; i < i_reqs; i++ )
+                if (cbs && cbs->on_preparse_ended)
+                    cbs->on_preparse_ended(reqs[i]->item, ITEM_PREPARSE_FAILED,
+                                           cbs_userdata);
+
+        for( size_t i = 0; i < i_reqs; i++ )
+            ReqRelease( reqs[i] );
+    }
+    free( reqs );
+}
+
 void input_preparser_fetcher_Push( input_preparser_t *preparser,
     input_item_t *item, input_item_meta_request_option_t options,
     const input_fetcher_callbacks_t *cbs, void *cbs_userdata )
@@ -57,6 +57,26 @@ void input_preparser_Push( input_preparser_t *, input_item_t *,
                            void *cbs_userdata,
                            int timeout, void *id );
 
+/**
+ * This function enqueues a batch of items to be preparsed.
+ *
+ * It is equivalent to calling input_preparser_Push() on every item of the
+ * array with the same options, but the preparse queue is locked only once,
+ * which is noticeably cheaper when importing a large media library.
+ *
+ * @param items array of items to preparse
+ * @param count number of items in the array
+ * @param timeout maximum time allowed to preparse each item, with the same
+ * semantic as for input_preparser_Push()
+ * @param id unique id provided by the caller, shared by the whole batch
+ */
+void input_preparser_PushBatch( input_preparser_t *,
+                                input_item_t *const *items, size_t count,
+                                input_item_meta_request_option_t,
+                                const input_preparser_callbacks_t *cbs,
+                                void *cbs_userdata,
+                                int timeout, void *id );
+
 void input_preparser_fetcher_Push( input_preparser_t *, input_item_t *,
                                    input_item_meta_request_option_t,
                                    const input_fetcher_callbacks_t *cbs,
@@ -163,6 +163,27 @@ bool sout_instance_ControlsPace( sout_instance_t *sout )
 /*****************************************************************************
  * Packetizer/Input
  *****************************************************************************/
+
+/**
+ * Checks whether an already-packetized ES can be forwarded as-is.
+ *
+ * The stream chain (ultimately the muxer) is queried; unless every element
+ * explicitly accepts the format without re-packetization, a full parsing
+ * packetizer must be used.
+ */
+bool sout_InputCanPassthrough( sout_instance_t *p_sout,
+                               const es_format_t *p_fmt )
+{
+    bool b;
+
+    vlc_mutex_lock( &p_sout->lock );
+    if( sout_StreamControl( p_sout->p_stream, SOUT_STREAM_CAN_PASSTHROUGH,
+                            p_fmt, &b ) != VLC_SUCCESS )
+        b = false;
+    vlc_mutex_unlock( &p_sout->lock );
+    return b;
+}
+
 sout_packetizer_input_t *sout_InputNew( sout_instance_t *p_sout,
                                         const es_format_t *p_fmt )
 {
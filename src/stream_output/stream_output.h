@@ -46,6 +46,7 @@ void sout_DeleteInstance( sout_instance_t * );
 
 bool sout_instance_ControlsPace( sout_instance_t *sout );
 
+bool sout_InputCanPassthrough( sout_instance_t *, const es_format_t * );
 sout_packetizer_input_t *sout_InputNew( sout_instance_t *, const es_format_t * );
 int sout_InputDelete( sout_packetizer_input_t * );
 int sout_InputSendBuffer( sout_packetizer_input_t *, block_t* );
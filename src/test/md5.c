@@ -24,6 +24,7 @@
 # include <config.h>
 #endif
 
+#include <assert.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -71,9 +72,67 @@ static void test_vlc_hash_md5()
     }
 }
 
+static void test_vlc_hash_md5_tree()
+{
+    /* Streaming tree digests must match the one-shot (threaded) helper,
+     * in particular around the chunk boundaries. */
+    static const size_t sizes[] =
+    {
+        0, 1, 4242,
+        VLC_HASH_MD5_TREE_CHUNK_SIZE - 1,
+        VLC_HASH_MD5_TREE_CHUNK_SIZE,
+        VLC_HASH_MD5_TREE_CHUNK_SIZE + 1,
+        3 * VLC_HASH_MD5_TREE_CHUNK_SIZE + 123,
+    };
+    size_t i_max = sizes[ARRAY_SIZE(sizes) - 1];
+    unsigned char *p_buf = malloc( i_max );
+    assert( p_buf );
+
+    for( size_t i = 0; i < i_max; i++ )
+        p_buf[i] = i * 2654435761u >> 24;
+
+    for( size_t i = 0; i < ARRAY_SIZE(sizes); i++ )
+    {
+        unsigned char p_streamed[VLC_HASH_MD5_DIGEST_SIZE];
+        unsigned char p_oneshot[VLC_HASH_MD5_DIGEST_SIZE];
+        vlc_hash_md5_tree_t tree;
+
+        vlc_hash_md5_tree_Init( &tree );
+        /* Split the update on an odd boundary to exercise refill */
+        vlc_hash_md5_tree_Update( &tree, p_buf, sizes[i] / 3 );
+        vlc_hash_md5_tree_Update( &tree, p_buf + sizes[i] / 3,
+                                  sizes[i] - sizes[i] / 3 );
+        vlc_hash_md5_tree_Finish( &tree, p_streamed, sizeof( p_streamed ) );
+
+        vlc_hash_md5_tree_Compute( p_oneshot, sizeof( p_oneshot ),
+                                   p_buf, sizes[i] );
+
+        assert( !memcmp( p_streamed, p_oneshot, sizeof( p_streamed ) ) );
+    }
+
+    /* A single short chunk: tree digest is MD5 of the chunk MD5 digest */
+    unsigned char p_leaf[VLC_HASH_MD5_DIGEST_SIZE];
+    unsigned char p_expect[VLC_HASH_MD5_DIGEST_SIZE];
+    unsigned char p_tree[VLC_HASH_MD5_DIGEST_SIZE];
+    vlc_hash_md5_t md5;
+
+    vlc_hash_md5_Init( &md5 );
+    vlc_hash_md5_Update( &md5, "abc", 3 );
+    vlc_hash_md5_Finish( &md5, p_leaf, sizeof( p_leaf ) );
+    vlc_hash_md5_Init( &md5 );
+    vlc_hash_md5_Update( &md5, p_leaf, sizeof( p_leaf ) );
+    vlc_hash_md5_Finish( &md5, p_expect, sizeof( p_expect ) );
+
+    vlc_hash_md5_tree_Compute( p_tree, sizeof( p_tree ), "abc", 3 );
+    assert( !memcmp( p_tree, p_expect, sizeof( p_tree ) ) );
+
+    free( p_buf );
+}
+
 int main( void )
 {
     test_vlc_hash_md5();
+    test_vlc_hash_md5_tree();
 
     return 0;
 }
@@ -43,21 +43,36 @@
 #include "libvlc.h"
 #include <vlc_charset.h>
 
+/* Creating a locale on every call is too expensive for functions that
+ * metadata and playlist parsers invoke per value. The C numeric locale is
+ * immutable, so one instance is kept for the whole process lifetime. */
+static locale_t us_locale;
+
+static void us_locale_init( void )
+{
+    us_locale = newlocale (LC_NUMERIC_MASK, "C", NULL);
+}
+
+static locale_t us_locale_get( void )
+{
+    static vlc_once_t once = VLC_STATIC_ONCE;
+
+    vlc_once (&once, us_locale_init);
+    return us_locale;
+}
+
 /**
  * us_strtod() has the same prototype as ANSI C strtod() but it uses the
  * POSIX/C decimal format, regardless of the current numeric locale.
  */
 double us_strtod( const char *str, char **end )
 {
-    locale_t loc = newlocale (LC_NUMERIC_MASK, "C", NULL);
+    locale_t loc = us_locale_get ();
     locale_t oldloc = uselocale (loc);
     double res = strtod (str, end);
 
     if (loc != (locale_t)0)
-    {
         uselocale (oldloc);
-        freelocale (loc);
-    }
     return res;
 }
 
@@ -68,15 +83,12 @@ double us_strtod( const char *str, char **end )
  */
 float us_strtof( const char *str, char **end )
 {
-    locale_t loc = newlocale (LC_NUMERIC_MASK, "C", NULL);
+    locale_t loc = us_locale_get ();
     locale_t oldloc = uselocale (loc);
     float res = strtof (str, end);
 
     if (loc != (locale_t)0)
-    {
         uselocale (oldloc);
-        freelocale (loc);
-    }
     return res;
 }
 
@@ -97,16 +109,13 @@ double us_atof( const char *str )
  */
 int us_vasprintf( char **ret, const char *format, va_list ap )
 {
-    locale_t loc = newlocale( LC_NUMERIC_MASK, "C", NULL );
+    locale_t loc = us_locale_get();
     locale_t oldloc = uselocale( loc );
 
     int i_rc = vasprintf( ret, format, ap );
 
     if ( loc != (locale_t)0 )
-    {
         uselocale( oldloc );
-        freelocale( loc );
-    }
 
     return i_rc;
 }
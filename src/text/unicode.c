@@ -38,6 +38,8 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <stdlib.h>
+#include <string.h>
+#include <strings.h>
 #include <sys/types.h>
 #if defined(_WIN32)
 #  include <io.h>
@@ -228,6 +230,134 @@ char *vlc_strcasestr (const char *haystack, const char *needle)
     return NULL;
 }
 
+/**
+ * Checks whether a character encoding is a strict superset of ASCII, i.e.
+ * whether bytes 0x00-0x7F denote the corresponding ASCII characters.
+ */
+static bool IsASCIISuperset(const char *charset)
+{
+    static const char names[][9] = { "ASCII", "US-ASCII", "UTF-8", "UTF8" };
+
+    for (size_t i = 0; i < ARRAY_SIZE(names); i++)
+        if (!strcasecmp(charset, names[i]))
+            return true;
+    return !strncasecmp(charset, "ISO-8859-", 9)
+        || !strncasecmp(charset, "ISO8859-", 8)
+        || !strncasecmp(charset, "WINDOWS-125", 11)
+        || !strncasecmp(charset, "CP125", 5);
+}
+
+/**
+ * Checks whether a memory block contains only ASCII bytes, a machine word at
+ * a time rather than byte-wise.
+ */
+static bool IsASCIIBuf(const char *buf, size_t length)
+{
+    uint64_t bits;
+
+    while (length >= sizeof (bits))
+    {
+        memcpy(&bits, buf, sizeof (bits));
+        if (bits & UINT64_C(0x8080808080808080))
+            return false;
+        buf += sizeof (bits);
+        length -= sizeof (bits);
+    }
+    while (length-- > 0)
+        if (*(buf++) & 0x80)
+            return false;
+    return true;
+}
+
+/* Opening an iconv descriptor entails a character set database lookup, while
+ * metadata scans convert thousands of short strings one at a time. Keep the
+ * last few descriptors around rather than reopening them on every call. */
+#define ICONV_CACHE_SIZE 4
+#define ICONV_NAME_MAX   32
+
+static struct iconv_cache_entry
+{
+    char        to[ICONV_NAME_MAX];
+    char        from[ICONV_NAME_MAX];
+    vlc_iconv_t handle;
+    bool        busy;
+} iconv_cache[ICONV_CACHE_SIZE];
+
+static vlc_mutex_t iconv_cache_lock = VLC_STATIC_MUTEX;
+
+static vlc_iconv_t iconv_cache_get(const char *tocode, const char *fromcode)
+{
+    if (strlen(tocode) >= ICONV_NAME_MAX || strlen(fromcode) >= ICONV_NAME_MAX)
+        return vlc_iconv_open(tocode, fromcode);
+
+    vlc_mutex_lock(&iconv_cache_lock);
+    for (size_t i = 0; i < ICONV_CACHE_SIZE; i++)
+    {
+        struct iconv_cache_entry *entry = iconv_cache + i;
+
+        if (entry->handle != NULL && !entry->busy
+         && !strcasecmp(entry->to, tocode)
+         && !strcasecmp(entry->from, fromcode))
+        {
+            entry->busy = true;
+            vlc_mutex_unlock(&iconv_cache_lock);
+            return entry->handle;
+        }
+    }
+    vlc_mutex_unlock(&iconv_cache_lock);
+
+    return vlc_iconv_open(tocode, fromcode);
+}
+
+static void iconv_cache_put(const char *tocode, const char *fromcode,
+                            vlc_iconv_t handle)
+{
+    struct iconv_cache_entry *spare = NULL;
+
+    /* Reset the conversion state for the next user */
+    if (vlc_iconv(handle, NULL, NULL, NULL, NULL) == VLC_ICONV_ERR)
+    {
+        vlc_iconv_close(handle);
+        return;
+    }
+
+    if (strlen(tocode) >= ICONV_NAME_MAX || strlen(fromcode) >= ICONV_NAME_MAX)
+    {
+        vlc_iconv_close(handle);
+        return;
+    }
+
+    vlc_mutex_lock(&iconv_cache_lock);
+    for (size_t i = 0; i < ICONV_CACHE_SIZE; i++)
+    {
+        struct iconv_cache_entry *entry = iconv_cache + i;
+
+        if (entry->handle == handle)
+        {   /* Cache hit in iconv_cache_get(): just release the entry. */
+            entry->busy = false;
+            vlc_mutex_unlock(&iconv_cache_lock);
+            return;
+        }
+        if (spare == NULL && !entry->busy)
+            spare = entry;
+    }
+
+    if (spare == NULL)
+    {   /* All entries in use by other threads */
+        vlc_mutex_unlock(&iconv_cache_lock);
+        vlc_iconv_close(handle);
+        return;
+    }
+
+    if (spare->handle != NULL)
+        vlc_iconv_close(spare->handle);
+    strcpy(spare->to, tocode);
+    strcpy(spare->from, fromcode);
+    spare->handle = handle;
+    spare->busy = false;
+    vlc_mutex_unlock(&iconv_cache_lock);
+}
+
 /**
  * Converts a string from the given character encoding to utf-8.
  *
@@ -236,7 +366,18 @@ char *vlc_strcasestr (const char *haystack, const char *needle)
  */
 char *FromCharset(const char *charset, const void *data, size_t data_size)
 {
-    vlc_iconv_t handle = vlc_iconv_open ("UTF-8", charset);
+    if (IsASCIISuperset(charset) && IsASCIIBuf(data, data_size))
+    {   /* ASCII is invariant under any of these conversions */
+        char *out = malloc(data_size + 1);
+        if (likely(out != NULL))
+        {
+            memcpy(out, data, data_size);
+            out[data_size] = '\0';
+        }
+        return out;
+    }
+
+    vlc_iconv_t handle = iconv_cache_get ("UTF-8", charset);
     if (handle == (vlc_iconv_t)(-1))
         return NULL;
 
@@ -260,7 +401,7 @@ char *FromCharset(const char *charset, const void *data, size_t data_size)
         if (errno != E2BIG)
             break;
     }
-    vlc_iconv_close(handle);
+    iconv_cache_put("UTF-8", charset, handle);
     return out;
 }
 
@@ -278,11 +419,23 @@ char *FromCharset(const char *charset, const void *data, size_t data_size)
  */
 void *ToCharset(const char *charset, const char *in, size_t *outsize)
 {
-    vlc_iconv_t hd = vlc_iconv_open (charset, "UTF-8");
+    const size_t inlen = strlen (in);
+
+    if (IsASCIISuperset(charset) && IsASCIIBuf(in, inlen))
+    {   /* ASCII is invariant under any of these conversions */
+        char *out = malloc(inlen + 1);
+        if (likely(out != NULL))
+        {
+            memcpy(out, in, inlen + 1);
+            *outsize = inlen;
+        }
+        return out;
+    }
+
+    vlc_iconv_t hd = iconv_cache_get (charset, "UTF-8");
     if (hd == (vlc_iconv_t)(-1))
         return NULL;
 
-    const size_t inlen = strlen (in);
     void *res;
 
     for (unsigned mul = 4; mul < 16; mul++)
@@ -313,7 +466,7 @@ void *ToCharset(const char *charset, const char *in, size_t *outsize)
         if (errno != E2BIG) /* conversion failure */
             break;
     }
-    vlc_iconv_close (hd);
+    iconv_cache_put (charset, "UTF-8", hd);
     return res;
 }
 
@@ -81,8 +81,13 @@ void vout_control_Push(vout_control_t *ctrl, vout_control_cmd_t *cmd)
 {
     vlc_mutex_lock(&ctrl->lock);
     if (!ctrl->is_dead) {
+        /* The vout thread only waits when it has no commands left, so a
+         * wake-up is only needed when the queue becomes non-empty. */
+        const bool wake = ctrl->cmd.i_size == 0;
+
         ARRAY_APPEND(ctrl->cmd, *cmd);
-        vlc_cond_signal(&ctrl->wait_request);
+        if (wake)
+            vlc_cond_signal(&ctrl->wait_request);
     } else {
         vout_control_cmd_Clean(cmd);
     }
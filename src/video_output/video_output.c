@@ -48,6 +48,7 @@
 #include <vlc_image.h>
 #include <vlc_plugin.h>
 #include <vlc_codec.h>
+#include <vlc_tracer.h>
 
 #include <libvlc.h>
 #include "vout_internal.h"
@@ -71,6 +72,9 @@
 /* Better be in advance when awakening than late... */
 #define VOUT_MWAIT_TOLERANCE VLC_TICK_FROM_MS(4)
 
+static void SpuLookaheadInvalidate(vout_thread_sys_t *sys);
+static void ThreadDiscardPrepared(vout_thread_t *vout);
+
 /* */
 static bool VoutCheckFormat(const video_format_t *src)
 {
@@ -262,9 +266,10 @@ void vout_PutSubpicture( vout_thread_t *vout, subpicture_t *subpic )
     vout_thread_sys_t *sys = vout->p;
     assert(!sys->dummy);
 
-    if (sys->spu != NULL)
+    if (sys->spu != NULL) {
         spu_PutSubpicture(sys->spu, subpic);
-    else
+        SpuLookaheadInvalidate(sys);
+    } else
         subpicture_Delete(subpic);
 }
 
@@ -303,16 +308,20 @@ void vout_FlushSubpictureChannel( vout_thread_t *vout, size_t channel )
 {
     vout_thread_sys_t *sys = vout->p;
     assert(!sys->dummy);
-    if (sys->spu)
+    if (sys->spu) {
         spu_ClearChannel(sys->spu, channel);
+        SpuLookaheadInvalidate(sys);
+    }
 }
 
 void vout_SetSpuHighlight( vout_thread_t *vout,
                         const vlc_spu_highlight_t *spu_hl )
 {
     assert(!vout->p->dummy);
-    if (vout->p->spu)
+    if (vout->p->spu) {
         spu_SetHighlight(vout->p->spu, spu_hl);
+        SpuLookaheadInvalidate(vout->p);
+    }
 }
 
 /**
@@ -601,23 +610,29 @@ void vout_ControlChangeFilters(vout_thread_t *vout, const char *filters)
 void vout_ControlChangeSubSources(vout_thread_t *vout, const char *filters)
 {
     assert(!vout->p->dummy);
-    if (likely(vout->p->spu != NULL))
+    if (likely(vout->p->spu != NULL)) {
         spu_ChangeSources(vout->p->spu, filters);
+        SpuLookaheadInvalidate(vout->p);
+    }
 }
 
 void vout_ControlChangeSubFilters(vout_thread_t *vout, const char *filters)
 {
     assert(!vout->p->dummy);
-    if (likely(vout->p->spu != NULL))
+    if (likely(vout->p->spu != NULL)) {
         spu_ChangeFilters(vout->p->spu, filters);
+        SpuLookaheadInvalidate(vout->p);
+    }
 }
 
 void vout_ChangeSpuChannelMargin(vout_thread_t *vout,
                                  enum vlc_vout_order order, int margin)
 {
     assert(!vout->p->dummy);
-    if (likely(vout->p->spu != NULL))
+    if (likely(vout->p->spu != NULL)) {
         spu_ChangeChannelOrderMargin(vout->p->spu, order, margin);
+        SpuLookaheadInvalidate(vout->p);
+    }
 }
 
 void vout_ChangeViewpoint(vout_thread_t *vout,
@@ -755,6 +770,9 @@ static void ThreadChangeFilters(vout_thread_t *vout,
                                 const bool *new_deinterlace,
                                 bool is_locked)
 {
+    /* The pipelined frame was rendered with the previous chains */
+    ThreadDiscardPrepared(vout);
+
     ThreadFilterFlush(vout, is_locked);
     ThreadDelAllFilterCallbacks(vout);
 
@@ -919,6 +937,10 @@ static int ThreadDisplayPreparePicture(vout_thread_t *vout, bool reuse,
                         late_threshold = VOUT_DISPLAY_LATE_THRESHOLD;
                     if (late > late_threshold) {
                         msg_Warn(vout, "picture is too late to be displayed (missing %"PRId64" ms)", MS_FROM_VLC_TICK(late));
+                        vlc_tracer_Trace(sys->tracer,
+                                         VLC_TRACE("event", "vout_dropped"),
+                                         VLC_TRACE_TICK("pts", decoded->date),
+                                         VLC_TRACE_TICK("late", late));
                         picture_Release(decoded);
                         vout_statistic_AddLost(&vout->p->statistic, 1);
                         continue;
@@ -1032,11 +1054,324 @@ static picture_t *ConvertRGB32AndBlend(vout_thread_t *vout, picture_t *pic,
     return NULL;
 }
 
-static int ThreadDisplayRenderPicture(vout_thread_t *vout, bool is_forced)
+/* A lookahead composition is reused when the actual render date ends up
+ * within this distance of the predicted one. Subtitle cues are much
+ * coarser than that. */
+#define SPU_LOOKAHEAD_DATE_TOLERANCE VLC_TICK_FROM_MS(20)
+
+static void SpuChromaListCopy(vlc_fourcc_t dst[VOUT_MAX_SUBPICTURE_CHROMAS + 1],
+                              const vlc_fourcc_t *src)
+{
+    size_t count = 0;
+    if (src != NULL)
+        for (; count < VOUT_MAX_SUBPICTURE_CHROMAS && src[count] != 0; count++)
+            dst[count] = src[count];
+    memset(&dst[count], 0,
+           (VOUT_MAX_SUBPICTURE_CHROMAS + 1 - count) * sizeof (*dst));
+}
+
+static void SpuRenderParamsInit(struct vout_spu_render_params *params)
+{
+    memset(params, 0, sizeof (*params));
+    video_format_Init(&params->fmt_dst, 0);
+    video_format_Init(&params->fmt_src, 0);
+}
+
+static void SpuRenderParamsClean(struct vout_spu_render_params *params)
+{
+    video_format_Clean(&params->fmt_dst);
+    video_format_Clean(&params->fmt_src);
+}
+
+static void SpuRenderParamsCopy(struct vout_spu_render_params *dst,
+                                const struct vout_spu_render_params *src)
 {
+    memcpy(dst->chromas, src->chromas, sizeof (dst->chromas));
+    video_format_Clean(&dst->fmt_dst);
+    video_format_Copy(&dst->fmt_dst, &src->fmt_dst);
+    video_format_Clean(&dst->fmt_src);
+    video_format_Copy(&dst->fmt_src, &src->fmt_src);
+    dst->system_now = src->system_now;
+    dst->render_date = src->render_date;
+    dst->ignore_osd = src->ignore_osd;
+    dst->external_scale = src->external_scale;
+}
+
+static void SpuRenderParamsSet(struct vout_spu_render_params *params,
+                               const vlc_fourcc_t chromas[VOUT_MAX_SUBPICTURE_CHROMAS + 1],
+                               const video_format_t *fmt_dst,
+                               const video_format_t *fmt_src,
+                               vlc_tick_t system_now, vlc_tick_t render_date,
+                               bool ignore_osd, bool external_scale)
+{
+    memcpy(params->chromas, chromas, sizeof (params->chromas));
+    video_format_Clean(&params->fmt_dst);
+    video_format_Copy(&params->fmt_dst, fmt_dst);
+    video_format_Clean(&params->fmt_src);
+    video_format_Copy(&params->fmt_src, fmt_src);
+    params->system_now = system_now;
+    params->render_date = render_date;
+    params->ignore_osd = ignore_osd;
+    params->external_scale = external_scale;
+}
+
+static bool SpuRenderParamsMatch(const struct vout_spu_render_params *params,
+                                 const vlc_fourcc_t chromas[VOUT_MAX_SUBPICTURE_CHROMAS + 1],
+                                 const video_format_t *fmt_dst,
+                                 const video_format_t *fmt_src,
+                                 vlc_tick_t render_date, bool ignore_osd,
+                                 bool external_scale)
+{
+    if (params->ignore_osd != ignore_osd ||
+        params->external_scale != external_scale)
+        return false;
+    if (llabs(params->render_date - render_date) > SPU_LOOKAHEAD_DATE_TOLERANCE)
+        return false;
+    if (memcmp(params->chromas, chromas, sizeof (params->chromas)) != 0)
+        return false;
+    return video_format_IsSimilar(&params->fmt_dst, fmt_dst) &&
+           video_format_IsSimilar(&params->fmt_src, fmt_src);
+}
+
+/* Drop the lookahead composition and recompose it: the spu content it was
+ * rendered from changed (new subpicture, cleared channel, changed
+ * sources...). Can be called from any thread. */
+static void SpuLookaheadInvalidate(vout_thread_sys_t *sys)
+{
+    if (!sys->spu_lookahead.started)
+        return;
+
+    vlc_mutex_lock(&sys->spu_lookahead.lock);
+    sys->spu_lookahead.generation++;
+    if (sys->spu_lookahead.result.valid) {
+        if (sys->spu_lookahead.result.subpic != NULL)
+            subpicture_Delete(sys->spu_lookahead.result.subpic);
+        sys->spu_lookahead.result.subpic = NULL;
+        sys->spu_lookahead.result.valid = false;
+    }
+    if (sys->spu_lookahead.request_valid && !sys->spu_lookahead.busy)
+        sys->spu_lookahead.pending = true;
+    vlc_cond_broadcast(&sys->spu_lookahead.wait);
+    vlc_mutex_unlock(&sys->spu_lookahead.lock);
+}
+
+/* SPU lookahead worker: all spu composition of this vout runs here. While
+ * the display thread waits for the deadline of the next frame, the worker
+ * composes its subpictures against the predicted display date, so that
+ * the deadline path only blends precomposed planes. */
+static void *SpuLookaheadThread(void *data)
+{
+    vout_thread_t *vout = data;
     vout_thread_sys_t *sys = vout->p;
+    struct vout_spu_render_params params;
 
-    picture_t *torender = picture_Hold(sys->displayed.current);
+    SpuRenderParamsInit(&params);
+
+    vlc_mutex_lock(&sys->spu_lookahead.lock);
+    while (!sys->spu_lookahead.closing) {
+        if (!sys->spu_lookahead.pending || !sys->spu_lookahead.request_valid) {
+            vlc_cond_wait(&sys->spu_lookahead.wait, &sys->spu_lookahead.lock);
+            continue;
+        }
+
+        sys->spu_lookahead.pending = false;
+        sys->spu_lookahead.busy = true;
+        const unsigned generation = sys->spu_lookahead.generation;
+        SpuRenderParamsCopy(&params, &sys->spu_lookahead.request);
+        vlc_mutex_unlock(&sys->spu_lookahead.lock);
+
+        subpicture_t *subpic =
+            spu_Render(sys->spu,
+                       params.chromas[0] != 0 ? params.chromas : NULL,
+                       &params.fmt_dst, &params.fmt_src,
+                       params.system_now, params.render_date,
+                       params.ignore_osd, params.external_scale);
+
+        vlc_mutex_lock(&sys->spu_lookahead.lock);
+        sys->spu_lookahead.busy = false;
+        if (generation != sys->spu_lookahead.generation) {
+            /* The spu content changed while composing, the result may miss
+             * a subpicture: recompose. */
+            if (subpic != NULL)
+                subpicture_Delete(subpic);
+            if (sys->spu_lookahead.request_valid)
+                sys->spu_lookahead.pending = true;
+        } else {
+            if (sys->spu_lookahead.result.valid &&
+                sys->spu_lookahead.result.subpic != NULL)
+                subpicture_Delete(sys->spu_lookahead.result.subpic);
+            SpuRenderParamsCopy(&sys->spu_lookahead.result.params, &params);
+            sys->spu_lookahead.result.subpic = subpic;
+            sys->spu_lookahead.result.valid = true;
+        }
+        vlc_cond_broadcast(&sys->spu_lookahead.wait);
+    }
+    vlc_mutex_unlock(&sys->spu_lookahead.lock);
+
+    SpuRenderParamsClean(&params);
+    return NULL;
+}
+
+/* Get the composed subpictures for the given render date. Reuses the
+ * lookahead composition when it matches, otherwise hands the request over
+ * to the worker and waits for it, so that spu composition always runs on
+ * a single thread. */
+static subpicture_t *ThreadRenderSPU(vout_thread_sys_t *sys,
+                                     const vlc_fourcc_t *chroma_list,
+                                     const video_format_t *fmt_dst,
+                                     const video_format_t *fmt_src,
+                                     vlc_tick_t system_now,
+                                     vlc_tick_t render_date,
+                                     bool ignore_osd, bool external_scale)
+{
+    if (!sys->spu_lookahead.started)
+        return spu_Render(sys->spu, chroma_list, fmt_dst, fmt_src,
+                          system_now, render_date, ignore_osd, external_scale);
+
+    vlc_fourcc_t chromas[VOUT_MAX_SUBPICTURE_CHROMAS + 1];
+    SpuChromaListCopy(chromas, chroma_list);
+
+    subpicture_t *subpic;
+    vlc_mutex_lock(&sys->spu_lookahead.lock);
+    for (;;) {
+        if (sys->spu_lookahead.result.valid &&
+            SpuRenderParamsMatch(&sys->spu_lookahead.result.params, chromas,
+                                 fmt_dst, fmt_src, render_date, ignore_osd,
+                                 external_scale)) {
+            subpic = sys->spu_lookahead.result.subpic;
+            sys->spu_lookahead.result.subpic = NULL;
+            sys->spu_lookahead.result.valid = false;
+            break;
+        }
+        if (!sys->spu_lookahead.busy && !sys->spu_lookahead.pending) {
+            SpuRenderParamsSet(&sys->spu_lookahead.request, chromas, fmt_dst,
+                               fmt_src, system_now, render_date, ignore_osd,
+                               external_scale);
+            sys->spu_lookahead.request_valid = true;
+            sys->spu_lookahead.pending = true;
+            vlc_cond_broadcast(&sys->spu_lookahead.wait);
+        }
+        vlc_cond_wait(&sys->spu_lookahead.wait, &sys->spu_lookahead.lock);
+    }
+    vlc_mutex_unlock(&sys->spu_lookahead.lock);
+    return subpic;
+}
+
+/* Compute the format and chroma list the subpictures must be composed
+ * with for the current display. Called with the display lock held. */
+static void ThreadGetSpuFormat(vout_thread_sys_t *sys, bool do_snapshot,
+                               video_format_t *fmt_spu,
+                               const vlc_fourcc_t **chromas,
+                               bool *do_dr_spu, bool *do_early_spu)
+{
+    vout_display_t *vd = sys->display;
+
+    *do_dr_spu = !do_snapshot &&
+                 vd->info.subpicture_chromas &&
+                 *vd->info.subpicture_chromas != 0;
+
+    //FIXME: Denying do_early_spu if vd->source.orientation != ORIENT_NORMAL
+    //will have the effect that snapshots miss the subpictures. We do this
+    //because there is currently no way to transform subpictures to match
+    //the source format.
+    *do_early_spu = !*do_dr_spu &&
+                    vd->source.orientation == ORIENT_NORMAL;
+
+    if (*do_dr_spu) {
+        vout_display_place_t place;
+        vout_display_PlacePicture(&place, &vd->source, vd->cfg);
+
+        *fmt_spu = vd->source;
+        if (fmt_spu->i_width * fmt_spu->i_height < place.width * place.height) {
+            fmt_spu->i_sar_num = vd->cfg->display.sar.num;
+            fmt_spu->i_sar_den = vd->cfg->display.sar.den;
+            fmt_spu->i_width          =
+            fmt_spu->i_visible_width  = place.width;
+            fmt_spu->i_height         =
+            fmt_spu->i_visible_height = place.height;
+        }
+        *chromas = vd->info.subpicture_chromas;
+    } else {
+        if (*do_early_spu) {
+            *fmt_spu = vd->source;
+        } else {
+            *fmt_spu = vd->fmt;
+            fmt_spu->i_sar_num = vd->cfg->display.sar.num;
+            fmt_spu->i_sar_den = vd->cfg->display.sar.den;
+        }
+        *chromas = NULL;
+    }
+}
+
+/* Have the lookahead worker compose the subpictures of the next frame
+ * against its predicted display date, while the display thread waits for
+ * the deadline. */
+static void ThreadPrerenderSPU(vout_thread_t *vout, vlc_tick_t system_now,
+                               vlc_tick_t render_date)
+{
+    vout_thread_sys_t *sys = vout->p;
+
+    if (!sys->spu_lookahead.started)
+        return;
+
+    vlc_mutex_lock(&sys->display_lock);
+    if (sys->display == NULL) {
+        vlc_mutex_unlock(&sys->display_lock);
+        return;
+    }
+
+    bool do_dr_spu, do_early_spu;
+    const vlc_fourcc_t *chroma_list;
+    video_format_t fmt_spu;
+    ThreadGetSpuFormat(sys, false, &fmt_spu, &chroma_list,
+                       &do_dr_spu, &do_early_spu);
+
+    video_format_t fmt_spu_rot;
+    video_format_ApplyRotation(&fmt_spu_rot, &fmt_spu);
+
+    vlc_fourcc_t chromas[VOUT_MAX_SUBPICTURE_CHROMAS + 1];
+    SpuChromaListCopy(chromas, chroma_list);
+
+    const video_format_t *fmt_src = &sys->display->source;
+    const bool external_scale = sys->display->info.can_scale_spu;
+
+    vlc_mutex_lock(&sys->spu_lookahead.lock);
+    /* Skip when this composition is already available or underway */
+    bool have =
+        (sys->spu_lookahead.result.valid &&
+         SpuRenderParamsMatch(&sys->spu_lookahead.result.params, chromas,
+                              &fmt_spu_rot, fmt_src, render_date, false,
+                              external_scale)) ||
+        (sys->spu_lookahead.request_valid &&
+         (sys->spu_lookahead.pending || sys->spu_lookahead.busy) &&
+         SpuRenderParamsMatch(&sys->spu_lookahead.request, chromas,
+                              &fmt_spu_rot, fmt_src, render_date, false,
+                              external_scale));
+    if (!have) {
+        SpuRenderParamsSet(&sys->spu_lookahead.request, chromas, &fmt_spu_rot,
+                           fmt_src, system_now, render_date, false,
+                           external_scale);
+        sys->spu_lookahead.request_valid = true;
+        sys->spu_lookahead.pending = true;
+        vlc_cond_broadcast(&sys->spu_lookahead.wait);
+    }
+    vlc_mutex_unlock(&sys->spu_lookahead.lock);
+    vlc_mutex_unlock(&sys->display_lock);
+}
+
+/* Render a picture into a prepared direct buffer (interactive filters,
+ * subpicture blending, conversion and vd->prepare). In pipelined mode
+ * this runs as soon as the next frame is known, otherwise right before
+ * the display deadline. On success sys->prepared holds the direct buffer
+ * until ThreadDisplayPrepared() consumes it. */
+static int ThreadRenderPicture(vout_thread_t *vout, picture_t *picture,
+                               bool is_forced)
+{
+    vout_thread_sys_t *sys = vout->p;
+
+    assert(!sys->prepared.valid);
+
+    picture_t *torender = picture_Hold(picture);
 
     vout_chrono_Start(&sys->render);
 
@@ -1047,7 +1382,7 @@ static int ThreadDisplayRenderPicture(vout_thread_t *vout, bool is_forced)
     if (!filtered)
         return VLC_EGENERIC;
 
-    if (filtered->date != sys->displayed.current->date)
+    if (filtered->date != picture->date)
         msg_Warn(vout, "Unsupported timestamp modifications done by chain_interactive");
 
     vout_display_t *vd = sys->display;
@@ -1081,43 +1416,13 @@ static int ThreadDisplayRenderPicture(vout_thread_t *vout, bool is_forced)
     /*
      * Get the subpicture to be displayed
      */
-    const bool do_dr_spu = !do_snapshot &&
-                           vd->info.subpicture_chromas &&
-                           *vd->info.subpicture_chromas != 0;
-
-    //FIXME: Denying do_early_spu if vd->source.orientation != ORIENT_NORMAL
-    //will have the effect that snapshots miss the subpictures. We do this
-    //because there is currently no way to transform subpictures to match
-    //the source format.
-    const bool do_early_spu = !do_dr_spu &&
-                               vd->source.orientation == ORIENT_NORMAL;
-
+    bool do_dr_spu, do_early_spu;
     const vlc_fourcc_t *subpicture_chromas;
     video_format_t fmt_spu;
-    if (do_dr_spu) {
-        vout_display_place_t place;
-        vout_display_PlacePicture(&place, &vd->source, vd->cfg);
-
-        fmt_spu = vd->source;
-        if (fmt_spu.i_width * fmt_spu.i_height < place.width * place.height) {
-            fmt_spu.i_sar_num = vd->cfg->display.sar.num;
-            fmt_spu.i_sar_den = vd->cfg->display.sar.den;
-            fmt_spu.i_width          =
-            fmt_spu.i_visible_width  = place.width;
-            fmt_spu.i_height         =
-            fmt_spu.i_visible_height = place.height;
-        }
-        subpicture_chromas = vd->info.subpicture_chromas;
-    } else {
-        if (do_early_spu) {
-            fmt_spu = vd->source;
-        } else {
-            fmt_spu = vd->fmt;
-            fmt_spu.i_sar_num = vd->cfg->display.sar.num;
-            fmt_spu.i_sar_den = vd->cfg->display.sar.den;
-        }
-        subpicture_chromas = NULL;
+    ThreadGetSpuFormat(sys, do_snapshot, &fmt_spu, &subpicture_chromas,
+                       &do_dr_spu, &do_early_spu);
 
+    if (!do_dr_spu) {
         if (sys->spu_blend &&
             sys->spu_blend->fmt_out.video.i_chroma != fmt_spu.i_chroma) {
             filter_DeleteBlend(sys->spu_blend);
@@ -1135,11 +1440,11 @@ static int ThreadDisplayRenderPicture(vout_thread_t *vout, bool is_forced)
     video_format_t fmt_spu_rot;
     video_format_ApplyRotation(&fmt_spu_rot, &fmt_spu);
     subpicture_t *subpic = !sys->spu ? NULL :
-                           spu_Render(sys->spu,
-                                      subpicture_chromas, &fmt_spu_rot,
-                                      &vd->source, system_now,
-                                      render_subtitle_date,
-                                      do_snapshot, vd->info.can_scale_spu);
+                           ThreadRenderSPU(sys,
+                                           subpicture_chromas, &fmt_spu_rot,
+                                           &vd->source, system_now,
+                                           render_subtitle_date,
+                                           do_snapshot, vd->info.can_scale_spu);
     /*
      * Perform rendering
      *
@@ -1216,9 +1521,6 @@ static int ThreadDisplayRenderPicture(vout_thread_t *vout, bool is_forced)
         is_forced = true;
     }
 
-    const unsigned frame_rate = todisplay->format.i_frame_rate;
-    const unsigned frame_rate_base = todisplay->format.i_frame_rate_base;
-
     if (vd->prepare != NULL)
         vd->prepare(vd, todisplay, do_dr_spu ? subpic : NULL, system_pts);
 
@@ -1232,13 +1534,80 @@ static int ThreadDisplayRenderPicture(vout_thread_t *vout, bool is_forced)
         }
 #endif
 
-    system_now = vlc_tick_now();
+    vlc_mutex_unlock(&sys->display_lock);
+
+    if (subpic != NULL && !do_dr_spu) {
+        /* Only a direct-rendering subpicture outlives the preparation */
+        subpicture_Delete(subpic);
+        subpic = NULL;
+    }
+
+    sys->prepared.valid = true;
+    sys->prepared.forced = is_forced;
+    sys->prepared.pts = pts;
+    sys->prepared.frame_rate = todisplay->format.i_frame_rate;
+    sys->prepared.frame_rate_base = todisplay->format.i_frame_rate_base;
+    sys->prepared.todisplay = todisplay;
+    sys->prepared.subpic = subpic;
+
+    return VLC_SUCCESS;
+}
+
+/* Release the frame prepared by ThreadRenderPicture() without displaying
+ * it: it became stale (flush, filter or display change, snapshot). */
+static void ThreadDiscardPrepared(vout_thread_t *vout)
+{
+    vout_thread_sys_t *sys = vout->p;
+
+    if (!sys->prepared.valid)
+        return;
+
+    picture_Release(sys->prepared.todisplay);
+    sys->prepared.todisplay = NULL;
+    if (sys->prepared.subpic != NULL) {
+        subpicture_Delete(sys->prepared.subpic);
+        sys->prepared.subpic = NULL;
+    }
+    sys->prepared.valid = false;
+}
+
+/* Wait for the display date of the prepared frame and display it */
+static int ThreadDisplayPrepared(vout_thread_t *vout, bool is_forced)
+{
+    vout_thread_sys_t *sys = vout->p;
+
+    assert(sys->prepared.valid);
+
+    picture_t *todisplay = sys->prepared.todisplay;
+    subpicture_t *subpic = sys->prepared.subpic;
+    const vlc_tick_t pts = sys->prepared.pts;
+    const unsigned frame_rate = sys->prepared.frame_rate;
+    const unsigned frame_rate_base = sys->prepared.frame_rate_base;
+    is_forced |= sys->prepared.forced;
+    sys->prepared.todisplay = NULL;
+    sys->prepared.subpic = NULL;
+    sys->prepared.valid = false;
+
+    vout_display_t *vd = sys->display;
+
+    vlc_mutex_lock(&sys->display_lock);
+
+    vlc_tick_t system_now = vlc_tick_now();
+    vlc_tick_t system_pts = is_forced ? system_now :
+        vlc_clock_ConvertToSystem(sys->clock, system_now, pts, sys->rate);
+    if (unlikely(system_pts == INT64_MAX))
+    {
+        /* The clock is paused, display the picture anyway */
+        system_pts = system_now;
+        is_forced = true;
+    }
+
     if (!is_forced)
     {
         if (unlikely(system_now > system_pts))
         {
-            /* vd->prepare took too much time. Tell the clock that the pts was
-             * rendered late. */
+            /* The rendering took too much time. Tell the clock that the pts
+             * was rendered late. */
             system_pts = system_now;
         }
         else
@@ -1265,6 +1634,11 @@ static int ThreadDisplayRenderPicture(vout_thread_t *vout, bool is_forced)
     vout_display_Display(vd, todisplay);
     vlc_mutex_unlock(&sys->display_lock);
 
+    vlc_tracer_Trace(sys->tracer,
+                     VLC_TRACE("event", "vout_displayed"),
+                     VLC_TRACE_TICK("pts", pts),
+                     VLC_TRACE_TICK("system", sys->displayed.date));
+
     if (subpic)
         subpicture_Delete(subpic);
 
@@ -1273,6 +1647,25 @@ static int ThreadDisplayRenderPicture(vout_thread_t *vout, bool is_forced)
     return VLC_SUCCESS;
 }
 
+static int ThreadDisplayRenderPicture(vout_thread_t *vout, bool is_forced)
+{
+    vout_thread_sys_t *sys = vout->p;
+
+    if (sys->prepared.valid) {
+        /* Reuse the frame prepared ahead of the deadline (pipelined mode),
+         * unless it went stale or a snapshot needs the full render path */
+        if (sys->prepared.pts == sys->displayed.current->date &&
+            !vout_snapshot_IsRequested(sys->snapshot))
+            return ThreadDisplayPrepared(vout, is_forced);
+        ThreadDiscardPrepared(vout);
+    }
+
+    int ret = ThreadRenderPicture(vout, sys->displayed.current, is_forced);
+    if (ret != VLC_SUCCESS)
+        return ret;
+    return ThreadDisplayPrepared(vout, is_forced);
+}
+
 static int ThreadDisplayPicture(vout_thread_t *vout, vlc_tick_t *deadline)
 {
     vout_thread_sys_t *sys = vout->p;
@@ -1311,6 +1704,20 @@ static int ThreadDisplayPicture(vout_thread_t *vout, vlc_tick_t *deadline)
             date_next = next_system_pts - render_delay;
             if (date_next <= system_now)
                 drop_next_frame = true;
+            else if (next_system_pts != INT64_MAX) {
+                /* There is spare time before the deadline: compose the
+                 * subpictures of the next frame ahead of it. */
+                ThreadPrerenderSPU(vout, system_now, next_system_pts);
+                if (sys->pipeline) {
+                    /* Pipelined mode: render and prepare the whole next
+                     * frame now, its deadline path will only display it */
+                    if (sys->prepared.valid &&
+                        sys->prepared.pts != sys->displayed.next->date)
+                        ThreadDiscardPrepared(vout);
+                    if (!sys->prepared.valid)
+                        ThreadRenderPicture(vout, sys->displayed.next, false);
+                }
+            }
         }
     }
 
@@ -1412,6 +1819,11 @@ static void vout_FlushUnlocked(vout_thread_t *vout, bool below,
 
     vlc_clock_Reset(sys->clock);
     vlc_clock_SetDelay(sys->clock, sys->delay);
+
+    /* The lookahead composition and the pipelined frame target a flushed
+     * date */
+    SpuLookaheadInvalidate(sys);
+    ThreadDiscardPrepared(vout);
 }
 
 void vout_Flush(vout_thread_t *vout, vlc_tick_t date)
@@ -1477,6 +1889,7 @@ void vout_ChangeSpuDelay(vout_thread_t *vout, size_t channel_id,
     assert(!vout->p->dummy);
     assert(vout->p->spu);
     spu_SetClockDelay(vout->p->spu, channel_id, delay);
+    SpuLookaheadInvalidate(vout->p);
 }
 
 void vout_ChangeSpuRate(vout_thread_t *vout, size_t channel_id, float rate)
@@ -1484,6 +1897,7 @@ void vout_ChangeSpuRate(vout_thread_t *vout, size_t channel_id, float rate)
     assert(!vout->p->dummy);
     assert(vout->p->spu);
     spu_SetClockRate(vout->p->spu, channel_id, rate);
+    SpuLookaheadInvalidate(vout->p);
 }
 
 static void ThreadProcessMouseState(vout_thread_t *vout,
@@ -1807,10 +2221,24 @@ void vout_Close(vout_thread_t *vout)
         vout_Stop(vout);
 
     vout_IntfDeinit(VLC_OBJECT(vout));
+    vout_SnapshotSaverClose(vout);
     vout_snapshot_End(sys->snapshot);
     vout_control_Dead(&sys->control);
     vout_chrono_Clean(&sys->render);
 
+    if (sys->spu_lookahead.started) {
+        vlc_mutex_lock(&sys->spu_lookahead.lock);
+        sys->spu_lookahead.closing = true;
+        vlc_cond_broadcast(&sys->spu_lookahead.wait);
+        vlc_mutex_unlock(&sys->spu_lookahead.lock);
+        vlc_join(sys->spu_lookahead.thread, NULL);
+        sys->spu_lookahead.started = false;
+    }
+    if (sys->spu_lookahead.result.subpic != NULL)
+        subpicture_Delete(sys->spu_lookahead.result.subpic);
+    SpuRenderParamsClean(&sys->spu_lookahead.result.params);
+    SpuRenderParamsClean(&sys->spu_lookahead.request);
+
     if (sys->spu)
         spu_Destroy(sys->spu);
 
@@ -1862,6 +2290,7 @@ static vout_thread_t *vout_CreateCommon(vlc_object_t *object)
 
     vout_thread_sys_t *sys = (vout_thread_sys_t *)&vout[1];
     vlc_atomic_rc_init(&sys->rc);
+    sys->tracer = vlc_object_get_tracer(object);
 
     vout->p = sys;
     return vout;
@@ -1908,6 +2337,7 @@ vout_thread_t *vout_Create(vlc_object_t *object)
     sys->source.dar.den = 0;
     sys->source.crop.mode = VOUT_CROP_NONE;
     sys->snapshot = vout_snapshot_New();
+    vout_SnapshotSaverInit(vout);
     vout_statistic_Init(&sys->statistic);
 
     /* Initialize subpicture unit */
@@ -1923,6 +2353,10 @@ vout_thread_t *vout_Create(vlc_object_t *object)
     vout_InitInterlacingSupport(vout);
 
     sys->is_late_dropped = var_InheritBool(vout, "drop-late-frames");
+    sys->pipeline = var_InheritBool(vout, "vout-pipeline");
+    sys->prepared.valid = false;
+    sys->prepared.todisplay = NULL;
+    sys->prepared.subpic = NULL;
 
     vlc_mutex_init(&sys->filter.lock);
 
@@ -1948,6 +2382,25 @@ vout_thread_t *vout_Create(vlc_object_t *object)
     /* Arbitrary initial time */
     vout_chrono_Init(&sys->render, 5, VLC_TICK_FROM_MS(10));
 
+    /* SPU lookahead worker */
+    vlc_mutex_init(&sys->spu_lookahead.lock);
+    vlc_cond_init(&sys->spu_lookahead.wait);
+    sys->spu_lookahead.closing = false;
+    sys->spu_lookahead.busy = false;
+    sys->spu_lookahead.pending = false;
+    sys->spu_lookahead.generation = 0;
+    sys->spu_lookahead.request_valid = false;
+    SpuRenderParamsInit(&sys->spu_lookahead.request);
+    sys->spu_lookahead.result.valid = false;
+    sys->spu_lookahead.result.subpic = NULL;
+    SpuRenderParamsInit(&sys->spu_lookahead.result.params);
+    sys->spu_lookahead.started = sys->spu != NULL &&
+        vlc_clone(&sys->spu_lookahead.thread, SpuLookaheadThread, vout,
+                  VLC_THREAD_PRIORITY_VIDEO) == 0;
+    if (sys->spu != NULL && !sys->spu_lookahead.started)
+        /* Not fatal: subpictures will be composed at the deadline */
+        msg_Warn(vout, "Failed to start the SPU lookahead worker");
+
     if (var_InheritBool(vout, "video-wallpaper"))
         vout_window_SetState(sys->display_cfg.window, VOUT_WINDOW_STATE_BELOW);
     else if (var_InheritBool(vout, "video-on-top"))
@@ -60,6 +60,20 @@ enum vout_crop_mode {
     VOUT_CROP_NONE, VOUT_CROP_RATIO, VOUT_CROP_WINDOW, VOUT_CROP_BORDER,
 };
 
+/* Maximum number of entries of a subpicture chroma list (0-terminated) */
+#define VOUT_MAX_SUBPICTURE_CHROMAS 8
+
+/* Parameters of one subpicture composition, see SpuLookaheadThread() */
+struct vout_spu_render_params {
+    vlc_fourcc_t    chromas[VOUT_MAX_SUBPICTURE_CHROMAS + 1];
+    video_format_t  fmt_dst;
+    video_format_t  fmt_src;
+    vlc_tick_t      system_now;
+    vlc_tick_t      render_date;
+    bool            ignore_osd;
+    bool            external_scale;
+};
+
 /* */
 struct vout_thread_sys_t
 {
@@ -72,6 +86,9 @@ struct vout_thread_sys_t
     float           rate;
     vlc_tick_t      delay;
 
+    /* Event tracer of the instance, NULL when tracing is disabled */
+    struct vlc_tracer *tracer;
+
     /* */
     video_format_t  original;   /* Original format ie coming from the decoder */
     struct {
@@ -105,6 +122,18 @@ struct vout_thread_sys_t
     /* Snapshot interface */
     struct vout_snapshot *snapshot;
 
+    /* Asynchronous snapshot saving, see vout_intf.c */
+    struct {
+        vlc_mutex_t     lock;
+        vlc_cond_t      wait;
+        struct vout_snapshot_job *jobs;     /**< FIFO of pending saves */
+        struct vout_snapshot_job **jobs_end;
+        unsigned        depth;              /**< queued jobs */
+        unsigned        threads;            /**< started worker threads */
+        bool            closing;
+        vlc_thread_t    thread[2];
+    } snapshot_saver;
+
     /* Statistics */
     vout_statistic_t statistic;
 
@@ -114,6 +143,27 @@ struct vout_thread_sys_t
     vlc_fourcc_t    spu_blend_chroma;
     vlc_blender_t   *spu_blend;
 
+    /* SPU lookahead: composes the subpictures of the upcoming frame ahead
+     * of the display deadline, so that the deadline path only blends the
+     * precomposed planes (see SpuLookaheadThread in video_output.c) */
+    struct {
+        vlc_mutex_t     lock;
+        vlc_cond_t      wait;
+        vlc_thread_t    thread;
+        bool            started;
+        bool            closing;
+        bool            busy;       /**< the worker is composing a request */
+        bool            pending;    /**< the request needs (re)composing */
+        unsigned        generation; /**< bumped when the spu content changes */
+        bool            request_valid;
+        struct vout_spu_render_params request;
+        struct {
+            bool            valid;
+            struct vout_spu_render_params params;
+            subpicture_t   *subpic;  /**< composed planes, may be NULL */
+        } result;
+    } spu_lookahead;
+
     /* Thread & synchronization */
     vlc_thread_t    thread;
     vout_control_t  control;
@@ -127,6 +177,21 @@ struct vout_thread_sys_t
         picture_t   *next;
     } displayed;
 
+    /* Pipelined rendering (--vout-pipeline): the next frame is rendered
+     * and prepared right after the current one is displayed, so that at
+     * the deadline only vout_display_Display() remains. See
+     * ThreadRenderPicture() in video_output.c */
+    bool pipeline;
+    struct {
+        bool        valid;
+        bool        forced;     /**< the clock was paused while rendering */
+        vlc_tick_t  pts;
+        unsigned    frame_rate;
+        unsigned    frame_rate_base;
+        picture_t   *todisplay; /**< prepared direct buffer */
+        subpicture_t *subpic;   /**< direct-rendering subpicture or NULL */
+    } prepared;
+
     struct {
         vlc_tick_t  last;
         vlc_tick_t  timestamp;
@@ -269,6 +334,10 @@ void vout_ChangeViewpoint( vout_thread_t *, const vlc_viewpoint_t *);
 /* */
 void vout_CreateVars( vout_thread_t * );
 void vout_IntfInit( vout_thread_t * );
+
+/* Asynchronous snapshot saver, in vout_intf.c */
+void vout_SnapshotSaverInit( vout_thread_t * );
+void vout_SnapshotSaverClose( vout_thread_t * );
 void vout_IntfReinit( vout_thread_t * );
 void vout_IntfDeinit(vlc_object_t *);
 
@@ -41,6 +41,7 @@
 #include <vlc_vout_osd.h>
 #include <vlc_strings.h>
 #include <vlc_charset.h>
+#include <vlc_image.h>
 #include <vlc_spu.h>
 #include "vout_internal.h"
 #include "snapshot.h"
@@ -386,26 +387,170 @@ static void VoutOsdSnapshot( vout_thread_t *p_vout, picture_t *p_pic, const char
     }
 }
 
+/* Snapshots are encoded and written out of the requester's thread by a
+ * small worker pool, so a snapshot-every-few-seconds monitoring setup
+ * does not stall video rendering on the PNG/JPEG encode. */
+#define VOUT_SNAPSHOT_SAVER_THREADS 2
+#define VOUT_SNAPSHOT_SAVER_QUEUE_MAX 8
+
+struct vout_snapshot_job {
+    struct vout_snapshot_job *p_next;
+    picture_t *p_picture;
+    char *psz_path;
+    char *psz_format;
+    char *psz_prefix;
+    bool b_sequential;
+    int i_sequence;
+};
+
+static void VoutSnapshotJobDelete( struct vout_snapshot_job *p_job )
+{
+    picture_Release( p_job->p_picture );
+    free( p_job->psz_path );
+    free( p_job->psz_format );
+    free( p_job->psz_prefix );
+    free( p_job );
+}
+
+/**
+ * Encodes and writes one snapshot, on a saver thread
+ */
+static void VoutSnapshotJobRun( vout_thread_t *p_vout,
+                                struct vout_snapshot_job *p_job )
+{
+    vlc_fourcc_t i_codec = VLC_CODEC_PNG;
+    if( p_job->psz_format && image_Type2Fourcc( p_job->psz_format ) )
+        i_codec = image_Type2Fourcc( p_job->psz_format );
+
+    block_t *p_image;
+    if( picture_Export( VLC_OBJECT(p_vout), &p_image, NULL,
+                        p_job->p_picture, i_codec,
+                        var_InheritInteger( p_vout, "snapshot-width" ),
+                        var_InheritInteger( p_vout, "snapshot-height" ),
+                        false ) )
+    {
+        msg_Err( p_vout, "Failed to convert image for snapshot" );
+        return;
+    }
+
+    vout_snapshot_save_cfg_t cfg;
+    memset( &cfg, 0, sizeof(cfg) );
+    cfg.is_sequential = p_job->b_sequential;
+    cfg.sequence = p_job->i_sequence;
+    cfg.path = p_job->psz_path;
+    cfg.format = p_job->psz_format;
+    cfg.prefix_fmt = p_job->psz_prefix;
+
+    char *psz_filename;
+    int  i_sequence;
+    if( vout_snapshot_SaveImage( &psz_filename, &i_sequence,
+                                 p_image, p_vout, &cfg ) == VLC_SUCCESS )
+    {
+        if( cfg.is_sequential )
+            var_SetInteger( p_vout, "snapshot-num", i_sequence + 1 );
+
+        VoutOsdSnapshot( p_vout, p_job->p_picture, psz_filename );
+
+        /* signal creation of a new snapshot file */
+        var_SetString( vlc_object_instance(p_vout), "snapshot-file",
+                       psz_filename );
+
+        free( psz_filename );
+    }
+    block_Release( p_image );
+}
+
+static void *VoutSnapshotSaverThread( void *opaque )
+{
+    vout_thread_t *p_vout = opaque;
+    vout_thread_sys_t *p_sys = p_vout->p;
+
+    vlc_mutex_lock( &p_sys->snapshot_saver.lock );
+    for( ;; )
+    {
+        while( !p_sys->snapshot_saver.jobs && !p_sys->snapshot_saver.closing )
+            vlc_cond_wait( &p_sys->snapshot_saver.wait,
+                           &p_sys->snapshot_saver.lock );
+
+        struct vout_snapshot_job *p_job = p_sys->snapshot_saver.jobs;
+        if( !p_job )
+            break;
+        p_sys->snapshot_saver.jobs = p_job->p_next;
+        if( !p_sys->snapshot_saver.jobs )
+            p_sys->snapshot_saver.jobs_end = &p_sys->snapshot_saver.jobs;
+        p_sys->snapshot_saver.depth--;
+        vlc_mutex_unlock( &p_sys->snapshot_saver.lock );
+
+        int canc = vlc_savecancel();
+        VoutSnapshotJobRun( p_vout, p_job );
+        VoutSnapshotJobDelete( p_job );
+        vlc_restorecancel( canc );
+
+        vlc_mutex_lock( &p_sys->snapshot_saver.lock );
+    }
+    vlc_mutex_unlock( &p_sys->snapshot_saver.lock );
+    return NULL;
+}
+
+void vout_SnapshotSaverInit( vout_thread_t *p_vout )
+{
+    vout_thread_sys_t *p_sys = p_vout->p;
+
+    vlc_mutex_init( &p_sys->snapshot_saver.lock );
+    vlc_cond_init( &p_sys->snapshot_saver.wait );
+    p_sys->snapshot_saver.jobs = NULL;
+    p_sys->snapshot_saver.jobs_end = &p_sys->snapshot_saver.jobs;
+    p_sys->snapshot_saver.depth = 0;
+    p_sys->snapshot_saver.threads = 0;
+    p_sys->snapshot_saver.closing = false;
+}
+
+void vout_SnapshotSaverClose( vout_thread_t *p_vout )
+{
+    vout_thread_sys_t *p_sys = p_vout->p;
+
+    vlc_mutex_lock( &p_sys->snapshot_saver.lock );
+    p_sys->snapshot_saver.closing = true;
+    vlc_cond_broadcast( &p_sys->snapshot_saver.wait );
+    vlc_mutex_unlock( &p_sys->snapshot_saver.lock );
+
+    for( unsigned i = 0; i < p_sys->snapshot_saver.threads; i++ )
+        vlc_join( p_sys->snapshot_saver.thread[i], NULL );
+    p_sys->snapshot_saver.threads = 0;
+
+    /* The workers drain the queue before exiting; just in case they
+     * could not be started, release whatever is left */
+    for( struct vout_snapshot_job *p_job = p_sys->snapshot_saver.jobs;
+         p_job != NULL; )
+    {
+        struct vout_snapshot_job *p_next = p_job->p_next;
+        VoutSnapshotJobDelete( p_job );
+        p_job = p_next;
+    }
+    p_sys->snapshot_saver.jobs = NULL;
+    p_sys->snapshot_saver.jobs_end = &p_sys->snapshot_saver.jobs;
+    p_sys->snapshot_saver.depth = 0;
+}
+
 /**
  * This function will handle a snapshot request
  */
 static void VoutSaveSnapshot( vout_thread_t *p_vout )
 {
+    vout_thread_sys_t *p_sys = p_vout->p;
     char *psz_path = var_InheritString( p_vout, "snapshot-path" );
     char *psz_format = var_InheritString( p_vout, "snapshot-format" );
     char *psz_prefix = var_InheritString( p_vout, "snapshot-prefix" );
 
     /* */
     picture_t *p_picture;
-    block_t *p_image;
 
     /* 500ms timeout
      * XXX it will cause trouble with low fps video (< 2fps) */
-    if( vout_GetSnapshot( p_vout, &p_image, &p_picture, NULL, psz_format, VLC_TICK_FROM_MS(500) ) )
+    if( vout_GetSnapshot( p_vout, NULL, &p_picture, NULL, psz_format, VLC_TICK_FROM_MS(500) ) )
     {
         p_picture = NULL;
-        p_image = NULL;
-        goto exit;
+        goto error;
     }
 
     if( !psz_path )
@@ -414,36 +559,64 @@ static void VoutSaveSnapshot( vout_thread_t *p_vout )
         if( !psz_path )
         {
             msg_Err( p_vout, "no path specified for snapshots" );
-            goto exit;
+            goto error;
         }
     }
 
-    vout_snapshot_save_cfg_t cfg;
-    memset( &cfg, 0, sizeof(cfg) );
-    cfg.is_sequential = var_InheritBool( p_vout, "snapshot-sequential" );
-    cfg.sequence = var_GetInteger( p_vout, "snapshot-num" );
-    cfg.path = psz_path;
-    cfg.format = psz_format;
-    cfg.prefix_fmt = psz_prefix;
+    struct vout_snapshot_job *p_job = malloc( sizeof(*p_job) );
+    if( !p_job )
+        goto error;
+    p_job->p_next = NULL;
+    p_job->p_picture = p_picture;
+    p_job->psz_path = psz_path;
+    p_job->psz_format = psz_format;
+    p_job->psz_prefix = psz_prefix;
+    p_job->b_sequential = var_InheritBool( p_vout, "snapshot-sequential" );
+    p_job->i_sequence = var_GetInteger( p_vout, "snapshot-num" );
+
+    vlc_mutex_lock( &p_sys->snapshot_saver.lock );
+    if( p_sys->snapshot_saver.closing
+     || p_sys->snapshot_saver.depth >= VOUT_SNAPSHOT_SAVER_QUEUE_MAX )
+    {
+        vlc_mutex_unlock( &p_sys->snapshot_saver.lock );
+        msg_Warn( p_vout, "too many pending snapshots, dropping request" );
+        VoutSnapshotJobDelete( p_job );
+        return;
+    }
 
-    char *psz_filename;
-    int  i_sequence;
-    if (vout_snapshot_SaveImage( &psz_filename, &i_sequence,
-                                 p_image, p_vout, &cfg ) )
-        goto exit;
-    if( cfg.is_sequential )
-        var_SetInteger( p_vout, "snapshot-num", i_sequence + 1 );
+    *p_sys->snapshot_saver.jobs_end = p_job;
+    p_sys->snapshot_saver.jobs_end = &p_job->p_next;
+    p_sys->snapshot_saver.depth++;
 
-    VoutOsdSnapshot( p_vout, p_picture, psz_filename );
+    /* Spawn workers lazily, up to the pool size */
+    if( p_sys->snapshot_saver.threads < VOUT_SNAPSHOT_SAVER_THREADS
+     && p_sys->snapshot_saver.depth > p_sys->snapshot_saver.threads )
+    {
+        if( vlc_clone( &p_sys->snapshot_saver.thread[p_sys->snapshot_saver.threads],
+                       VoutSnapshotSaverThread, p_vout,
+                       VLC_THREAD_PRIORITY_LOW ) == 0 )
+            p_sys->snapshot_saver.threads++;
+    }
+
+    if( p_sys->snapshot_saver.threads > 0 )
+    {
+        vlc_cond_signal( &p_sys->snapshot_saver.wait );
+        vlc_mutex_unlock( &p_sys->snapshot_saver.lock );
+        return;
+    }
 
-    /* signal creation of a new snapshot file */
-    var_SetString( vlc_object_instance(p_vout), "snapshot-file", psz_filename );
+    /* No worker could be started: fall back to saving synchronously */
+    *p_sys->snapshot_saver.jobs_end = NULL;
+    p_sys->snapshot_saver.jobs = NULL;
+    p_sys->snapshot_saver.jobs_end = &p_sys->snapshot_saver.jobs;
+    p_sys->snapshot_saver.depth = 0;
+    vlc_mutex_unlock( &p_sys->snapshot_saver.lock );
 
-    free( psz_filename );
+    VoutSnapshotJobRun( p_vout, p_job );
+    VoutSnapshotJobDelete( p_job );
+    return;
 
-exit:
-    if( p_image )
-        block_Release( p_image );
+error:
     if( p_picture )
         picture_Release( p_picture );
     free( psz_prefix );
@@ -75,6 +75,15 @@ typedef struct VLC_VECTOR(struct spu_channel) spu_channel_vector;
 typedef struct VLC_VECTOR(subpicture_t *) spu_prerender_vector;
 #define SPU_CHROMALIST_COUNT 8
 
+/* Identity of one rendered output region, used to detect that an overlay
+ * did not change between two renders (the SPU caches scaled region
+ * pictures, so a static region keeps the same picture pointer). */
+struct spu_composite_sig {
+    const picture_t *picture;
+    int x, y;
+    int alpha;
+};
+
 struct spu_private_t {
     vlc_mutex_t  lock;            /* lock to protect all followings fields */
     input_thread_t *input;
@@ -127,6 +136,14 @@ struct spu_private_t {
         bool            live;
     } prerender;
 
+    /* Cache of the last static multi-region composite, see SpuFoldRegions() */
+    struct {
+        struct spu_composite_sig *sig;  /**< signature of the last render */
+        size_t          sig_count;
+        picture_t      *picture;           /**< pre-blended YUVA composite */
+        int             x, y;
+    } composite;
+
     /* */
     vlc_tick_t          last_sort_date;
     vout_thread_t       *vout;
@@ -1117,6 +1134,213 @@ static void SpuRenderRegion(spu_t *spu,
     }
 }
 
+/*****************************************************************************
+ * Static overlay composite cache
+ *****************************************************************************
+ * Multi-region overlays (multi-line subtitles, OSD) that do not change
+ * between two renders are pre-blended once into a single YUVA region, so
+ * the video output blends one region per frame instead of re-blending
+ * every region. The cache is keyed on the identity of the rendered
+ * regions (picture pointer, position, alpha) and dropped as soon as the
+ * overlay changes.
+ *****************************************************************************/
+
+static inline unsigned spu_div255(unsigned v)
+{
+    return ((v >> 8) + v + 1) >> 8;
+}
+
+static void SpuCompositeReset(spu_private_t *sys)
+{
+    free(sys->composite.sig);
+    sys->composite.sig = NULL;
+    sys->composite.sig_count = 0;
+    if (sys->composite.picture) {
+        picture_Release(sys->composite.picture);
+        sys->composite.picture = NULL;
+    }
+}
+
+static bool SpuCompositeSigMatch(const struct spu_composite_sig *a,
+                                 const struct spu_composite_sig *b,
+                                 size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        if (a[i].picture != b[i].picture ||
+            a[i].x != b[i].x || a[i].y != b[i].y ||
+            a[i].alpha != b[i].alpha)
+            return false;
+    return true;
+}
+
+/**
+ * Source-over blend of one rendered region into the composite picture,
+ * folding the region alpha into the pixel alpha.
+ */
+static void SpuCompositeBlendRegion(picture_t *dst,
+                                    const subpicture_region_t *r,
+                                    int x0, int y0)
+{
+    const picture_t *src = r->p_picture;
+    const unsigned sx = r->fmt.i_x_offset;
+    const unsigned sy = r->fmt.i_y_offset;
+    const unsigned width  = r->fmt.i_visible_width;
+    const unsigned height = r->fmt.i_visible_height;
+    const unsigned dx = r->i_x - x0;
+    const unsigned dy = r->i_y - y0;
+    const unsigned alpha = r->i_alpha;
+
+    for (unsigned y = 0; y < height; y++) {
+        const uint8_t *sY = &src->p[0].p_pixels[(sy + y) * src->p[0].i_pitch + sx];
+        const uint8_t *sU = &src->p[1].p_pixels[(sy + y) * src->p[1].i_pitch + sx];
+        const uint8_t *sV = &src->p[2].p_pixels[(sy + y) * src->p[2].i_pitch + sx];
+        const uint8_t *sA = &src->p[3].p_pixels[(sy + y) * src->p[3].i_pitch + sx];
+        uint8_t *dY = &dst->p[0].p_pixels[(dy + y) * dst->p[0].i_pitch + dx];
+        uint8_t *dU = &dst->p[1].p_pixels[(dy + y) * dst->p[1].i_pitch + dx];
+        uint8_t *dV = &dst->p[2].p_pixels[(dy + y) * dst->p[2].i_pitch + dx];
+        uint8_t *dA = &dst->p[3].p_pixels[(dy + y) * dst->p[3].i_pitch + dx];
+
+        for (unsigned x = 0; x < width; x++) {
+            const unsigned sa = spu_div255(alpha * sA[x]);
+            if (sa == 0)
+                continue;
+            const unsigned da = dA[x];
+            if (da == 0 || sa == 255) {
+                dY[x] = sY[x];
+                dU[x] = sU[x];
+                dV[x] = sV[x];
+                dA[x] = sa + spu_div255(da * (255 - sa));
+            } else {
+                /* db is the weight left to the old pixel */
+                const unsigned db = spu_div255(da * (255 - sa));
+                const unsigned oa = sa + db;
+                dY[x] = (dY[x] * db + sY[x] * sa + oa / 2) / oa;
+                dU[x] = (dU[x] * db + sU[x] * sa + oa / 2) / oa;
+                dV[x] = (dV[x] * db + sV[x] * sa + oa / 2) / oa;
+                dA[x] = oa;
+            }
+        }
+    }
+}
+
+static bool SpuCompositeBuild(spu_t *spu, const subpicture_t *output)
+{
+    spu_private_t *sys = spu->p;
+
+    /* Bounding box of all regions */
+    int x0 = INT_MAX, y0 = INT_MAX, x1 = INT_MIN, y1 = INT_MIN;
+    uint64_t covered = 0;
+    for (const subpicture_region_t *r = output->p_region; r; r = r->p_next) {
+        x0 = __MIN(x0, r->i_x);
+        y0 = __MIN(y0, r->i_y);
+        x1 = __MAX(x1, r->i_x + (int)r->fmt.i_visible_width);
+        y1 = __MAX(y1, r->i_y + (int)r->fmt.i_visible_height);
+        covered += (uint64_t)r->fmt.i_visible_width * r->fmt.i_visible_height;
+    }
+    if (x1 <= x0 || y1 <= y0)
+        return false;
+
+    /* Give up when the regions are far apart: blending the mostly
+     * transparent bounding box every frame would cost more than the
+     * separate blends it replaces. */
+    if ((uint64_t)(x1 - x0) * (y1 - y0) > 2 * covered)
+        return false;
+
+    video_format_t fmt;
+    video_format_Init(&fmt, VLC_CODEC_YUVA);
+    video_format_Setup(&fmt, VLC_CODEC_YUVA, x1 - x0, y1 - y0,
+                       x1 - x0, y1 - y0,
+                       output->p_region->fmt.i_sar_num,
+                       output->p_region->fmt.i_sar_den);
+
+    picture_t *picture = picture_NewFromFormat(&fmt);
+    if (!picture)
+        return false;
+
+    /* Fully transparent background */
+    memset(picture->p[0].p_pixels, 0x00,
+           picture->p[0].i_pitch * picture->p[0].i_lines);
+    memset(picture->p[1].p_pixels, 0x80,
+           picture->p[1].i_pitch * picture->p[1].i_lines);
+    memset(picture->p[2].p_pixels, 0x80,
+           picture->p[2].i_pitch * picture->p[2].i_lines);
+    memset(picture->p[3].p_pixels, 0x00,
+           picture->p[3].i_pitch * picture->p[3].i_lines);
+
+    for (const subpicture_region_t *r = output->p_region; r; r = r->p_next)
+        SpuCompositeBlendRegion(picture, r, x0, y0);
+
+    sys->composite.picture = picture;
+    sys->composite.x = x0;
+    sys->composite.y = y0;
+    return true;
+}
+
+/**
+ * Replaces a static multi-region output by a single pre-blended region.
+ *
+ * The first render of a new overlay goes through unchanged and only
+ * records its signature; the composite is built when the same overlay
+ * comes back on the next render and reused from then on.
+ */
+static void SpuFoldRegions(spu_t *spu, subpicture_t *output)
+{
+    spu_private_t *sys = spu->p;
+
+    size_t count = 0;
+    for (const subpicture_region_t *r = output->p_region; r; r = r->p_next) {
+        if (r->fmt.i_chroma != VLC_CODEC_YUVA || !r->p_picture ||
+            r->i_align != 0 ||
+            r->zoom_h.num != r->zoom_h.den || r->zoom_v.num != r->zoom_v.den) {
+            SpuCompositeReset(sys);
+            return;
+        }
+        count++;
+    }
+    if (count < 2) {
+        SpuCompositeReset(sys);
+        return;
+    }
+
+    struct spu_composite_sig *sig = vlc_alloc(count, sizeof(*sig));
+    if (!sig) {
+        SpuCompositeReset(sys);
+        return;
+    }
+    size_t i = 0;
+    for (const subpicture_region_t *r = output->p_region; r; r = r->p_next, i++) {
+        sig[i].picture = r->p_picture;
+        sig[i].x       = r->i_x;
+        sig[i].y       = r->i_y;
+        sig[i].alpha   = r->i_alpha;
+    }
+
+    if (sys->composite.sig == NULL || count != sys->composite.sig_count ||
+        !SpuCompositeSigMatch(sig, sys->composite.sig, count)) {
+        /* The overlay changed: remember it and blend normally */
+        SpuCompositeReset(sys);
+        sys->composite.sig = sig;
+        sys->composite.sig_count = count;
+        return;
+    }
+    free(sig);
+
+    if (sys->composite.picture == NULL && !SpuCompositeBuild(spu, output))
+        return;
+
+    subpicture_region_t *region =
+        subpicture_region_NewInternal(&sys->composite.picture->format);
+    if (!region)
+        return;
+    region->p_picture = picture_Hold(sys->composite.picture);
+    region->i_x = sys->composite.x;
+    region->i_y = sys->composite.y;
+    region->i_align = 0;
+
+    subpicture_region_ChainDelete(output->p_region);
+    output->p_region = region;
+}
+
 /**
  * This function renders all sub picture units in the list.
  */
@@ -1271,6 +1495,9 @@ static subpicture_t *SpuRenderSubpictures(spu_t *spu,
     if (subtitle_area != subtitle_area_buffer)
         free(subtitle_area);
 
+    /* Substitute a cached pre-blended region for static overlays */
+    SpuFoldRegions(spu, output);
+
     return output;
 }
 
@@ -1595,6 +1822,8 @@ static void spu_Cleanup(spu_t *spu)
     vlc_vector_clear(&sys->prerender.vector);
     video_format_Clean(&sys->prerender.fmtdst);
     video_format_Clean(&sys->prerender.fmtsrc);
+
+    SpuCompositeReset(sys);
 }
 
 /**
@@ -1672,6 +1901,10 @@ spu_t *spu_Create(vlc_object_t *object, vout_thread_t *vout)
     sys->prerender.chroma_list[SPU_CHROMALIST_COUNT] = 0;
     sys->prerender.live = true;
 
+    sys->composite.sig = NULL;
+    sys->composite.sig_count = 0;
+    sys->composite.picture = NULL;
+
     /* Load text and scale module */
     sys->text = SpuRenderCreateAndLoadText(spu);
     vlc_mutex_init(&sys->textlock);
@@ -0,0 +1,253 @@
+/*****************************************************************************
+ * bench.c: end-to-end pipeline benchmark (mock demux to dummy sinks)
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/**
+ * Drives a synthetic mock:// stream through the real input, es_out, decoder
+ * (araw/rawvideo) and dummy audio/video outputs at the fastest rate the core
+ * accepts, then reports throughput, allocation pressure and scheduling
+ * behaviour. Run with no arguments for a quick regression-gate workload, or:
+ *
+ *   bench [length_ms] [video_tracks] [audio_tracks] [fps] [width] [height]
+ */
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <sys/resource.h>
+
+#include <vlc_common.h>
+#include <vlc_input_item.h>
+#include <vlc_player.h>
+
+/* The benchmark rate: the player clamps whatever exceeds its maximum, so
+ * "as fast as the core allows" is simply a very large request. */
+#define BENCH_RATE 31.f
+
+#ifdef __GLIBC__
+/* Count heap allocations made by the whole process (the interposed symbols
+ * take precedence over the libc ones for libvlccore and the plugins too). */
+extern void *__libc_malloc(size_t);
+extern void *__libc_calloc(size_t, size_t);
+extern void *__libc_realloc(void *, size_t);
+
+static _Atomic uint64_t alloc_count;
+
+void *malloc(size_t size)
+{
+    atomic_fetch_add_explicit(&alloc_count, 1, memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+    atomic_fetch_add_explicit(&alloc_count, 1, memory_order_relaxed);
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    atomic_fetch_add_explicit(&alloc_count, 1, memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+static uint64_t bench_alloc_count(void)
+{
+    return atomic_load_explicit(&alloc_count, memory_order_relaxed);
+}
+#else
+static uint64_t bench_alloc_count(void)
+{
+    return 0; /* not available on this platform */
+}
+#endif
+
+struct bench_ctx
+{
+    vlc_sem_t sem_stopped;
+    bool started;
+};
+
+static void
+player_on_state_changed(vlc_player_t *player, enum vlc_player_state state,
+                        void *data)
+{
+    struct bench_ctx *ctx = data;
+
+    switch (state)
+    {
+        case VLC_PLAYER_STATE_STARTED:
+            ctx->started = true;
+            break;
+        case VLC_PLAYER_STATE_STOPPED:
+            if (ctx->started)
+                vlc_sem_post(&ctx->sem_stopped);
+            break;
+        default:
+            break;
+    }
+    (void) player;
+}
+
+static long
+parse_arg(int argc, char *argv[], int index, long defval)
+{
+    if (argc <= index)
+        return defval;
+
+    long val = strtol(argv[index], NULL, 10);
+    assert(val > 0);
+    return val;
+}
+
+int main(int argc, char *argv[])
+{
+    long length_ms = parse_arg(argc, argv, 1, 5000);
+    long video_tracks = parse_arg(argc, argv, 2, 1);
+    long audio_tracks = parse_arg(argc, argv, 3, 1);
+    long fps = parse_arg(argc, argv, 4, 25);
+    long width = parse_arg(argc, argv, 5, 320);
+    long height = parse_arg(argc, argv, 6, 240);
+
+    test_init();
+
+    const char *vlc_argv[] = {
+        "-v",
+        "--ignore-config",
+        "-Idummy",
+        "--no-media-library",
+        "--no-drop-late-frames",
+        "--stats",
+        /* Avoid leaks from various dlopen... */
+        "--codec=araw,rawvideo,none",
+        "--dec-dev=none",
+        "--vout=dummy",
+        "--aout=dummy",
+    };
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(vlc_argv), vlc_argv);
+    assert(vlc);
+
+    /* Force wdummy window */
+    int ret = var_SetString(vlc->p_libvlc_int, "window", "wdummy");
+    assert(ret == VLC_SUCCESS);
+
+    char *url;
+    ret = asprintf(&url,
+                   "mock://length=%"PRId64";video_track_count=%ld;"
+                   "audio_track_count=%ld;video_frame_rate=%ld;"
+                   "video_width=%ld;video_height=%ld",
+                   (int64_t)VLC_TICK_FROM_MS(length_ms), video_tracks,
+                   audio_tracks, fps, width, height);
+    assert(ret != -1);
+
+    input_item_t *media = input_item_New(url, "bench");
+    assert(media);
+    free(url);
+
+    struct bench_ctx ctx = { .started = false };
+    vlc_sem_init(&ctx.sem_stopped, 0);
+
+    static const struct vlc_player_cbs cbs = {
+        .on_state_changed = player_on_state_changed,
+    };
+
+    vlc_player_t *player = vlc_player_New(VLC_OBJECT(vlc->p_libvlc_int),
+                                          VLC_PLAYER_LOCK_NORMAL, NULL, NULL);
+    assert(player);
+
+    vlc_player_Lock(player);
+    vlc_player_listener_id *listener =
+            vlc_player_AddListener(player, &cbs, &ctx);
+    assert(listener);
+
+    ret = vlc_player_SetCurrentMedia(player, media);
+    assert(ret == VLC_SUCCESS);
+    vlc_player_ChangeRate(player, BENCH_RATE);
+
+    struct rusage ru_start;
+    getrusage(RUSAGE_SELF, &ru_start);
+    uint64_t allocs_start = bench_alloc_count();
+    vlc_tick_t start = vlc_tick_now();
+
+    ret = vlc_player_Start(player);
+    assert(ret == VLC_SUCCESS);
+    vlc_player_Unlock(player);
+
+    vlc_sem_wait(&ctx.sem_stopped);
+
+    vlc_tick_t wall = vlc_tick_now() - start;
+    uint64_t allocs = bench_alloc_count() - allocs_start;
+    struct rusage ru_end;
+    getrusage(RUSAGE_SELF, &ru_end);
+
+    vlc_player_Lock(player);
+    vlc_player_RemoveListener(player, listener);
+    vlc_player_Unlock(player);
+    vlc_player_Delete(player);
+
+    /* the accumulated statistics survive on the input item */
+    vlc_mutex_lock(&media->lock);
+    assert(media->p_stats != NULL);
+    struct input_stats_t stats = *media->p_stats;
+    vlc_mutex_unlock(&media->lock);
+
+    input_item_Release(media);
+    libvlc_release(vlc);
+
+    double secs = secf_from_vlc_tick(wall);
+    int64_t frames = stats.i_decoded_video;
+    long nvcsw = ru_end.ru_nvcsw - ru_start.ru_nvcsw;
+    long nivcsw = ru_end.ru_nivcsw - ru_start.ru_nivcsw;
+
+    printf("--- pipeline benchmark ---\n");
+    printf("media: %ld ms, %ld video track(s) @ %ld fps %ldx%ld, "
+           "%ld audio track(s), rate x%.0f\n",
+           length_ms, video_tracks, fps, width, height, audio_tracks,
+           BENCH_RATE);
+    printf("wall time: %.3f s\n", secs);
+    printf("video: %"PRId64" decoded (%.1f/s), %"PRId64" displayed (%.1f/s), "
+           "%"PRId64" lost\n",
+           stats.i_decoded_video, stats.i_decoded_video / secs,
+           stats.i_displayed_pictures, stats.i_displayed_pictures / secs,
+           stats.i_lost_pictures);
+    printf("audio: %"PRId64" decoded, %"PRId64" buffers played, "
+           "%"PRId64" lost\n",
+           stats.i_decoded_audio, stats.i_played_abuffers,
+           stats.i_lost_abuffers);
+    printf("demux: %"PRId64" packets, %"PRId64" bytes\n",
+           stats.i_demux_read_packets, stats.i_demux_read_bytes);
+    if (frames > 0)
+    {
+        if (allocs > 0)
+            printf("allocations: %"PRIu64" total, %.1f per decoded frame\n",
+                   allocs, (double)allocs / frames);
+        printf("context switches: %ld voluntary (%.1f per frame, lock/sleep "
+               "wait proxy), %ld involuntary\n",
+               nvcsw, (double)nvcsw / frames, nivcsw);
+    }
+
+    /* regression gate: the pipeline must actually have flowed end-to-end */
+    assert(video_tracks == 0 || stats.i_decoded_video > 0);
+    assert(audio_tracks == 0 || stats.i_decoded_audio > 0);
+    assert(video_tracks == 0 || stats.i_displayed_pictures > 0);
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+/*****************************************************************************
+ * fifo_mpsc.c: lock-free MPSC block FIFO unit test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vlc_common.h>
+#include <vlc_block.h>
+
+#define PRODUCERS 4
+#define BLOCKS_PER_PRODUCER 4096
+
+static vlc_fifo_mpsc_t *fifo;
+
+static void *producer_thread(void *opaque)
+{
+    uintptr_t id = (uintptr_t)opaque;
+
+    for (unsigned i = 0; i < BLOCKS_PER_PRODUCER; i += 4) {
+        /* Enqueue a small chain to exercise the batched path. */
+        block_t *chain = NULL, **pp = &chain;
+
+        for (unsigned j = 0; j < 4; j++) {
+            block_t *b = block_Alloc(sizeof (uintptr_t));
+
+            assert(b != NULL);
+            memcpy(b->p_buffer, &id, sizeof (id));
+            *pp = b;
+            pp = &b->p_next;
+        }
+
+        vlc_fifo_mpsc_Put(fifo, chain);
+    }
+
+    return NULL;
+}
+
+int main(void)
+{
+    vlc_thread_t threads[PRODUCERS];
+    unsigned counts[PRODUCERS] = { 0 };
+
+    fifo = vlc_fifo_mpsc_New();
+    assert(fifo != NULL);
+
+    /* Single thread, FIFO order */
+    for (uintptr_t i = 0; i < 42; i++) {
+        block_t *b = block_Alloc(sizeof (i));
+
+        assert(b != NULL);
+        memcpy(b->p_buffer, &i, sizeof (i));
+        vlc_fifo_mpsc_Put(fifo, b);
+    }
+
+    assert(vlc_fifo_mpsc_GetCount(fifo) == 42);
+    assert(vlc_fifo_mpsc_GetBytes(fifo) == 42 * sizeof (uintptr_t));
+
+    for (uintptr_t i = 0; i < 42; i++) {
+        block_t *b = vlc_fifo_mpsc_Get(fifo);
+        uintptr_t val;
+
+        assert(b != NULL);
+        memcpy(&val, b->p_buffer, sizeof (val));
+        assert(val == i);
+        block_Release(b);
+    }
+
+    assert(vlc_fifo_mpsc_GetAll(fifo) == NULL);
+    assert(vlc_fifo_mpsc_GetCount(fifo) == 0);
+
+    /* Concurrent producers, blocking consumer */
+    for (uintptr_t i = 0; i < PRODUCERS; i++)
+        assert(vlc_clone(&threads[i], producer_thread, (void *)i,
+                         VLC_THREAD_PRIORITY_LOW) == 0);
+
+    for (unsigned n = 0; n < PRODUCERS * BLOCKS_PER_PRODUCER; n++) {
+        block_t *b = vlc_fifo_mpsc_Get(fifo);
+        uintptr_t id;
+
+        memcpy(&id, b->p_buffer, sizeof (id));
+        assert(id < PRODUCERS);
+        counts[id]++;
+        block_Release(b);
+    }
+
+    for (unsigned i = 0; i < PRODUCERS; i++) {
+        vlc_join(threads[i], NULL);
+        assert(counts[i] == BLOCKS_PER_PRODUCER);
+    }
+
+    assert(vlc_fifo_mpsc_GetCount(fifo) == 0);
+    assert(vlc_fifo_mpsc_GetBytes(fifo) == 0);
+
+    /* Queued blocks are released with the FIFO */
+    vlc_fifo_mpsc_Put(fifo, block_Alloc(7));
+    vlc_fifo_mpsc_Release(fifo);
+    return 0;
+}
@@ -0,0 +1,89 @@
+/*****************************************************************************
+ * sort.c: stable parallel merge sort unit test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+#include <stdlib.h>
+
+#include <vlc_common.h>
+#include <vlc_rand.h>
+#include <vlc_sort.h>
+
+struct entry
+{
+    int key;
+    unsigned sequence; /* insertion order, to check stability */
+};
+
+static char context; /* any unique address */
+
+static int compare_keys(const void *lhs, const void *rhs, void *arg)
+{
+    const struct entry *a = lhs, *b = rhs;
+
+    assert(arg == &context); /* the context must be passed through */
+
+    return (a->key > b->key) - (a->key < b->key);
+}
+
+static void check_sorted(size_t nmemb)
+{
+    struct entry *array = vlc_alloc(nmemb ? nmemb : 1, sizeof (*array));
+    assert(array != NULL);
+
+    for (size_t i = 0; i < nmemb; i++)
+    {
+        /* few distinct keys, so that stability actually gets exercised */
+        array[i].key = vlc_lrand48() % 64;
+        array[i].sequence = i;
+    }
+
+    vlc_mergesort(array, nmemb, sizeof (*array), compare_keys, &context);
+
+    for (size_t i = 1; i < nmemb; i++)
+    {
+        assert(array[i - 1].key <= array[i].key);
+        if (array[i - 1].key == array[i].key)
+            /* equal keys must keep their relative order */
+            assert(array[i - 1].sequence < array[i].sequence);
+    }
+
+    free(array);
+}
+
+int main(void)
+{
+    /* empty and trivial arrays */
+    check_sorted(0);
+    check_sorted(1);
+    check_sorted(2);
+
+    /* serial path */
+    check_sorted(1000);
+
+    /* parallel path (crosses the internal threshold) */
+    check_sorted(100000);
+
+    return 0;
+}